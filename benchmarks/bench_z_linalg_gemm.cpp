@@ -0,0 +1,111 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#include <vector>
+
+#include "z_benchmark.h"
+#include "z_matrix.h"
+#include "z_dynmatrix.h"
+#include "z_gemm.h"
+
+/*
+ * Matrix products: the blocked kernels behind operator* against the plain
+ * row, column and inner product loop the operators used to run, for
+ * square products from a few entries up to well past the caches, and the
+ * unrolled fixed size products against that loop. Each product is
+ * 2 n^3 floating point operations.
+ */
+
+namespace {
+
+    using namespace z_linalg;
+
+    template <typename T>
+    void naiveProduct(int m, int n, int k, const T *a, const T *b, T *c)
+    {
+        for (int row = 0; row < m; ++row) {
+            for (int col = 0; col < n; ++col) {
+                T sum(0.0f);
+                for (int j = 0; j < k; ++j)
+                    sum += a[j*m + row] * b[col*k + j];
+                c[col*m + row] = sum;
+            }
+        }
+    }
+
+    template <typename T>
+    void benchSquare(z_benchmark::Runner &runner, z_benchmark::Lcg &rng, const char *type, int n)
+    {
+        std::vector<T> a(n * n), b(n * n), c(n * n);
+        for (int i = 0; i < n * n; ++i) {
+            a[i] = T(rng.next(-1, 1));
+            b[i] = T(rng.next(-1, 1));
+        }
+        const double flops = 2.0 * n * n * n;
+
+        if (n <= 512) {
+            runner.run(std::string("naive_") + type, n, 1, [&]() {
+                naiveProduct(n, n, n, a.data(), b.data(), c.data());
+                return (long long)c[0];
+            }, flops);
+        }
+
+        runner.run(std::string("gemm_scalar_") + type, n, 1, [&]() {
+            gemm(n, n, n, a.data(), n, b.data(), n, c.data(), n, z_qtshapes::ZQScalarLevel);
+            return (long long)c[0];
+        }, flops);
+
+        runner.run(std::string("gemm_") + type, n, 1, [&]() {
+            gemm(n, n, n, a.data(), n, b.data(), n, c.data(), n);
+            return (long long)c[0];
+        }, flops);
+
+        runner.run(std::string("matrixProduct_") + type, n, 1, [&]() {
+            matrixProduct(n, n, n, a.data(), n, b.data(), n, c.data(), n);
+            return (long long)c[0];
+        }, flops);
+    }
+
+    // A chain of fixed size transforms, composed pairwise.
+    template <int n>
+    void benchFixed(z_benchmark::Runner &runner, z_benchmark::Lcg &rng)
+    {
+        const int count = 1024;
+        std::vector<ZQMatrix<n, n, qreal>> m(count), out(count);
+        for (ZQMatrix<n, n, qreal> &x : m)
+            for (int i = 0; i < n; ++i)
+                for (int j = 0; j < n; ++j)
+                    x(i, j) = rng.next(-1, 1);
+        const double flops = 2.0 * n * n * n;
+
+        runner.run("fixed_naive", n, count, [&]() {
+            for (int i = 0; i < count; ++i)
+                naiveProduct(n, n, n, m[i].constData(), m[(i + 1) % count].constData(), out[i].data());
+            return (long long)out[0](0, 0);
+        }, flops);
+
+        runner.run("fixed_operator", n, count, [&]() {
+            for (int i = 0; i < count; ++i)
+                out[i] = m[i] * m[(i + 1) % count];
+            return (long long)out[0](0, 0);
+        }, flops);
+    }
+
+}
+
+int main(int argc, char **argv)
+{
+    z_benchmark::Runner runner(argc, argv);
+    z_benchmark::Lcg rng;
+
+    benchFixed<2>(runner, rng);
+    benchFixed<3>(runner, rng);
+    benchFixed<4>(runner, rng);
+
+    const int sizes[] = { 8, 16, 32, 64, 128, 256, 512, 1024 };
+    for (int n : sizes)
+        benchSquare<double>(runner, rng, "double", n);
+    for (int n : sizes)
+        benchSquare<float>(runner, rng, "float", n);
+
+    return runner.finish();
+}
@@ -0,0 +1,134 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#include <memory>
+#include <string>
+
+#include "z_benchmark.h"
+#include "z_offsetmatrix.h"
+#include "z_linalg.h"
+
+/*
+ * The dense z_linalg solvers across matrix sizes. Every pass copies the
+ * input matrix, factors it and solves for one right hand side, so the
+ * timings include the copy, as a caller who keeps its matrix would pay.
+ */
+
+namespace {
+
+    using namespace z_linalg;
+
+    template <int n>
+    struct Problem {
+        ZQOffsetMatrix<1, n, 1, n, qreal> general;     // Diagonally dominant
+        ZQOffsetMatrix<1, n, 1, n, qreal> spd;         // Symmetric positive definite
+        ZQOffsetMatrix<1, n, 0, 0, qreal> rhs;
+        ZQOffsetMatrix<1, n, 0, 0, qreal> sub, diag, super;
+
+        explicit Problem(z_benchmark::Lcg &rng)
+        {
+            for (int i = 1; i <= n; ++i) {
+                for (int j = 1; j <= n; ++j)
+                    general(i, j) = rng.next(-1, 1);
+                general(i, i) += n;
+                rhs(i, 0) = rng.next(-1, 1);
+                sub(i, 0) = rng.next(-1, 1);
+                super(i, 0) = rng.next(-1, 1);
+                diag(i, 0) = 4 + rng.next(0, 1);
+            }
+            for (int i = 1; i <= n; ++i) {
+                for (int j = 1; j <= n; ++j) {
+                    qreal sum = 0;
+                    for (int k = 1; k <= n; ++k)
+                        sum += general(i, k) * general(j, k);
+                    spd(i, j) = sum;
+                }
+            }
+        }
+    };
+
+    template <int n>
+    void benchSize(z_benchmark::Runner &runner, z_benchmark::Lcg &rng)
+    {
+        typedef ZQOffsetMatrix<1, n, 1, n, qreal> Matrix;
+        typedef ZQOffsetMatrix<1, n, 0, 0, qreal> Vector;
+
+        // Heap allocated, the larger sizes would not fit comfortably on the stack.
+        std::unique_ptr<Problem<n>> problem(new Problem<n>(rng));
+        std::unique_ptr<Matrix> a(new Matrix), v(new Matrix);
+        std::unique_ptr<ZQOffsetMatrix<1, n, 1, 1, qreal>> b(new ZQOffsetMatrix<1, n, 1, 1, qreal>);
+        Vector x, c, d, w;
+        ZQOffsetMatrix<1, n, 0, 0, int> indx;
+        std::string error;
+
+        // The kind of update an iterative solver makes every step, one
+        // pass over the elements with no temporaries.
+        runner.run("elementwise_chain", n, 1, [&]() {
+            *a = problem->general + problem->spd - problem->general * qreal(2);
+            return (long long)(*a)(1, 1);
+        });
+
+        runner.run("lu_decomp_zq+lu_backsub_zq", n, 1, [&]() {
+            *a = problem->general;
+            qreal sign;
+            lu_decomp_zq(*a, indx, sign, error);
+            lu_backsub_zq(*a, indx, problem->rhs, error);
+            return (long long)sign;
+        });
+
+        runner.run("gauss_jordan_zq", n, 1, [&]() {
+            *a = problem->general;
+            for (int i = 1; i <= n; ++i)
+                (*b)(i, 1) = problem->rhs(i, 0);
+            gauss_jordan_zq(*a, *b, error);
+            return (long long)(*b)(1, 1);
+        });
+
+        runner.run("chol_decomp_zq+chol_solve_zq", n, 1, [&]() {
+            *a = problem->spd;
+            chol_decomp_zq(*a, d, error);
+            Vector rhs = problem->rhs;
+            chol_solve_zq(*a, d, rhs, x, error);
+            return (long long)x(1, 0);
+        });
+
+        runner.run("qr_decomp_zq+qr_solve_zq", n, 1, [&]() {
+            *a = problem->general;
+            int singular;
+            qr_decomp_zq(*a, c, d, singular, error);
+            x = problem->rhs;
+            qr_solve_zq(*a, c, d, x, error);
+            return (long long)singular;
+        });
+
+        runner.run("svd_decomp_zq", n, 1, [&]() {
+            *a = problem->general;
+            svd_decomp_zq(*a, w, *v, error);
+            return (long long)w(1, 0);
+        });
+
+        runner.run("tridiag_solve_zq", n, 1, [&]() {
+            tridiag_solve_zq(problem->sub, problem->diag, problem->super, problem->rhs, x, error);
+            return (long long)x(1, 0);
+        });
+
+        runner.run("eigen_jacobi_sym_zq", n, 1, [&]() {
+            *a = problem->spd;
+            int rotations;
+            eigen_jacobi_sym_zq(*a, w, *v, rotations, error);
+            return (long long)rotations;
+        });
+    }
+
+}
+
+int main(int argc, char **argv)
+{
+    z_benchmark::Runner runner(argc, argv);
+    z_benchmark::Lcg rng;
+
+    benchSize<4>(runner, rng);
+    benchSize<16>(runner, rng);
+    benchSize<64>(runner, rng);
+
+    return runner.finish();
+}
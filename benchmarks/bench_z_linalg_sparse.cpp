@@ -0,0 +1,164 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#include <vector>
+
+#include "z_benchmark.h"
+#include "z_sparsematrix.h"
+#include "z_krylov.h"
+
+/*
+ * Sparse matrices: building the five point Laplacian of an n x n grid from
+ * triplets, and its products with a vector, A x and A' x, in compressed
+ * row and compressed column storage, on the calling thread and on the
+ * global thread pool. Each product is 2 nnz floating point operations.
+ *
+ * Then solving with that matrix, and with a nonsymmetric one that adds a
+ * convection term, to a relative residual of 1e-8 with each Krylov solver
+ * and preconditioner. bicgstab_jacobi is what linear_bcg_zq runs on
+ * its sa/ija arrays. Timings include computing the preconditioner.
+ */
+
+namespace {
+
+    using namespace z_linalg;
+
+    std::vector<ZQTriplet<qreal>> laplacian(int n, qreal convection = 0)
+    {
+        std::vector<ZQTriplet<qreal>> triplets;
+        triplets.reserve(5 * n * n);
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                const int row = i * n + j;
+                triplets.push_back(ZQTriplet<qreal>(row, row, 4));
+                if (i > 0)
+                    triplets.push_back(ZQTriplet<qreal>(row, row - n, -1));
+                if (i < n - 1)
+                    triplets.push_back(ZQTriplet<qreal>(row, row + n, -1));
+                if (j > 0)
+                    triplets.push_back(ZQTriplet<qreal>(row, row - 1, -1 - convection));
+                if (j < n - 1)
+                    triplets.push_back(ZQTriplet<qreal>(row, row + 1, -1 + convection));
+            }
+        }
+        return triplets;
+    }
+
+    void benchGrid(z_benchmark::Runner &runner, z_benchmark::Lcg &rng, int n)
+    {
+        const int size = n * n;
+        const std::vector<ZQTriplet<qreal>> triplets = laplacian(n);
+        std::vector<qreal> x(size), y(size);
+        for (qreal &v : x)
+            v = rng.next(-1, 1);
+
+        ZQSparseMatrix<qreal> csr(size, size);
+        runner.run("from_triplets", size, 1, [&]() {
+            csr.setFromTriplets(triplets.begin(), triplets.end());
+            return (long long)csr.nonZeros();
+        });
+        const ZQSparseMatrix<qreal> csc = csr.converted(ZQSparseMatrix<qreal>::CompressedColumns);
+        const double flops = 2.0 * csr.nonZeros();
+
+        const struct { const char *name; const ZQSparseMatrix<qreal> *matrix; } storages[] = {
+            { "csr", &csr }, { "csc", &csc }
+        };
+        for (const auto &s : storages) {
+            const ZQSparseMatrix<qreal> &A = *s.matrix;
+            runner.run(std::string("spmv_serial_") + s.name, size, 1, [&]() {
+                A.multiply(x.data(), y.data(), nullptr);
+                return (long long)y[0];
+            }, flops);
+            runner.run(std::string("spmv_pool_") + s.name, size, 1, [&]() {
+                A.multiply(x.data(), y.data());
+                return (long long)y[0];
+            }, flops);
+            runner.run(std::string("spmv_transposed_serial_") + s.name, size, 1, [&]() {
+                A.multiplyTransposed(x.data(), y.data(), nullptr);
+                return (long long)y[0];
+            }, flops);
+            runner.run(std::string("spmv_transposed_pool_") + s.name, size, 1, [&]() {
+                A.multiplyTransposed(x.data(), y.data());
+                return (long long)y[0];
+            }, flops);
+        }
+    }
+
+    template <typename Solve>
+    void benchSolve(z_benchmark::Runner &runner, const std::string &name, int size, const std::vector<qreal> &b, Solve solve)
+    {
+        std::vector<qreal> x(size);
+        runner.run(name, size, 1, [&]() {
+            std::fill(x.begin(), x.end(), 0);
+            int iter = 0;
+            qreal err;
+            std::string error;
+            solve(x.data(), iter, err, error);
+            return (long long)iter;
+        });
+    }
+
+    void benchKrylov(z_benchmark::Runner &runner, z_benchmark::Lcg &rng, int n)
+    {
+        const int size = n * n;
+        const qreal tol = 1e-8;
+        std::vector<qreal> b(size);
+        for (qreal &v : b)
+            v = rng.next(-1, 1);
+        const std::vector<ZQTriplet<qreal>> spdTriplets = laplacian(n), generalTriplets = laplacian(n, 0.5);
+        ZQSparseMatrix<qreal> spd(size, size), general(size, size);
+        spd.setFromTriplets(spdTriplets.begin(), spdTriplets.end());
+        general.setFromTriplets(generalTriplets.begin(), generalTriplets.end());
+        const ZQIdentityPreconditioner<qreal> none(size);
+
+        benchSolve(runner, "cg", size, b, [&](qreal *x, int &iter, qreal &err, std::string &error) {
+            linear_cg(spd, none, b.data(), x, tol, 10000, iter, err, error);
+        });
+        benchSolve(runner, "cg_jacobi", size, b, [&](qreal *x, int &iter, qreal &err, std::string &error) {
+            ZQJacobiPreconditioner<qreal> M;
+            M.compute(spd, error);
+            linear_cg(spd, M, b.data(), x, tol, 10000, iter, err, error);
+        });
+        benchSolve(runner, "cg_ic0", size, b, [&](qreal *x, int &iter, qreal &err, std::string &error) {
+            ZQIncompleteCholeskyPreconditioner<qreal> M;
+            M.compute(spd, error);
+            linear_cg(spd, M, b.data(), x, tol, 10000, iter, err, error);
+        });
+        benchSolve(runner, "bicgstab_jacobi", size, b, [&](qreal *x, int &iter, qreal &err, std::string &error) {
+            ZQJacobiPreconditioner<qreal> M;
+            M.compute(general, error);
+            linear_bicgstab(general, M, b.data(), x, tol, 10000, iter, err, error);
+        });
+        benchSolve(runner, "bicgstab_ilu0", size, b, [&](qreal *x, int &iter, qreal &err, std::string &error) {
+            ZQILU0Preconditioner<qreal> M;
+            M.compute(general, error);
+            linear_bicgstab(general, M, b.data(), x, tol, 10000, iter, err, error);
+        });
+        benchSolve(runner, "gmres30_jacobi", size, b, [&](qreal *x, int &iter, qreal &err, std::string &error) {
+            ZQJacobiPreconditioner<qreal> M;
+            M.compute(general, error);
+            linear_gmres(general, M, b.data(), x, tol, 10000, 30, iter, err, error);
+        });
+        benchSolve(runner, "gmres30_ilu0", size, b, [&](qreal *x, int &iter, qreal &err, std::string &error) {
+            ZQILU0Preconditioner<qreal> M;
+            M.compute(general, error);
+            linear_gmres(general, M, b.data(), x, tol, 10000, 30, iter, err, error);
+        });
+    }
+
+}
+
+int main(int argc, char **argv)
+{
+    z_benchmark::Runner runner(argc, argv);
+    z_benchmark::Lcg rng;
+
+    const int grids[] = { 64, 256, 1024 };
+    for (int n : grids)
+        benchGrid(runner, rng, n);
+
+    const int solveGrids[] = { 32, 128 };
+    for (int n : solveGrids)
+        benchKrylov(runner, rng, n);
+
+    return runner.finish();
+}
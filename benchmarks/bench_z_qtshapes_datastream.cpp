@@ -0,0 +1,77 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#include <vector>
+
+#include <QByteArray>
+#include <QDataStream>
+
+#include "z_benchmark.h"
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+
+/*
+ * QDataStream round-trips: every pass writes the whole set of shapes into
+ * a QByteArray and reads it back.
+ */
+
+namespace {
+
+    template <typename Shape>
+    void benchShape(z_benchmark::Runner &runner, const std::string &cls, const std::vector<Shape> &shapes)
+    {
+        const long long n = (long long)shapes.size();
+        std::vector<Shape> copies(shapes.size());
+        QByteArray bytes;
+
+        runner.run(cls + " QDataStream round-trip", n, n, [&]() {
+            bytes.clear();
+            {
+                QDataStream out(&bytes, QIODevice::WriteOnly);
+                for (const Shape &s : shapes)
+                    out << s;
+            }
+            QDataStream in(bytes);
+            for (Shape &s : copies)
+                in >> s;
+            return (long long)bytes.size() + (copies.back() == shapes.back());
+        });
+    }
+
+}
+
+int main(int argc, char **argv)
+{
+    z_benchmark::Runner runner(argc, argv);
+    z_benchmark::Lcg rng;
+
+    for (int size : { 16, 256, 4096 }) {
+        std::vector<z_qtshapes::ZQPointF> points;
+        std::vector<z_qtshapes::ZQRectF> rects;
+        std::vector<z_qtshapes::ZQRect> irects;
+        std::vector<z_qtshapes::ZQTriF> tris;
+        std::vector<z_qtshapes::ZQEllipseF> ellipses;
+        std::vector<z_qtshapes::ZQLineF> lines;
+        for (int i = 0; i < size; ++i) {
+            const qreal px = rng.next(-100, 100), py = rng.next(-100, 100);
+            const qreal w = rng.next(1, 80), h = rng.next(1, 80), a = rng.next(0, 360);
+            points.push_back(z_qtshapes::ZQPointF(px, py));
+            rects.push_back(z_qtshapes::ZQRectF(px, py, w, h, a));
+            irects.push_back(z_qtshapes::ZQRect(int(px), int(py), int(w), int(h), int(a)));
+            ellipses.push_back(z_qtshapes::ZQEllipseF(px, py, w, h, a));
+            tris.push_back(z_qtshapes::ZQTriF(QPointF(px, py), QPointF(px + w, py), QPointF(px, py + h), a));
+            lines.push_back(z_qtshapes::ZQLineF(QPointF(px, py), QPointF(px + w, py + h)));
+        }
+
+        benchShape(runner, "ZQPointF", points);
+        benchShape(runner, "ZQRectF", rects);
+        benchShape(runner, "ZQRect", irects);
+        benchShape(runner, "ZQTriF", tris);
+        benchShape(runner, "ZQEllipseF", ellipses);
+        benchShape(runner, "ZQLineF", lines);
+    }
+
+    return runner.finish();
+}
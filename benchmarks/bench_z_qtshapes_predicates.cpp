@@ -0,0 +1,146 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#include <algorithm>
+#include <vector>
+
+#include "z_benchmark.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+#include "z_qpointkernels.h"
+#include "z_qgjk.h"
+
+/*
+ * contains(point) and intersects(shape) for every floating point shape
+ * class, over growing sets of pseudo-random shapes. contains() tests each
+ * shape against a fixed set of points; intersects() and closestPoints()
+ * test each shape against its successor in the set.
+ */
+
+namespace {
+
+    const int npoints = 64;
+
+    template <typename Shape>
+    void benchShape(z_benchmark::Runner &runner, const std::string &cls, const std::vector<Shape> &shapes,
+                    const std::vector<QPointF> &points)
+    {
+        const long long n = (long long)shapes.size();
+
+        runner.run(cls + "::contains(QPointF)", n, n * npoints, [&]() {
+            long long hits = 0;
+            for (const Shape &s : shapes)
+                for (const QPointF &p : points)
+                    hits += s.contains(p);
+            return hits;
+        });
+
+        runner.run(cls + "::prepared().contains(QPointF)", n, n * npoints, [&]() {
+            long long hits = 0;
+            for (const Shape &s : shapes) {
+                const auto prepared = s.prepared();
+                for (const QPointF &p : points)
+                    hits += prepared.contains(p);
+            }
+            return hits;
+        });
+
+        runner.run(cls + "::intersects(" + cls + ")", n, n, [&]() {
+            long long hits = 0;
+            for (std::size_t i = 0; i < shapes.size(); ++i)
+                hits += shapes[i].intersects(shapes[(i + 1) % shapes.size()]);
+            return hits;
+        });
+
+        runner.run("closestPoints(" + cls + ", " + cls + ")", n, n, [&]() {
+            long long hits = 0;
+            for (std::size_t i = 0; i < shapes.size(); ++i)
+                hits += z_qtshapes::closestPoints(shapes[i], shapes[(i + 1) % shapes.size()]).overlapping();
+            return hits;
+        });
+    }
+
+    template <typename Shape>
+    void benchKernel(z_benchmark::Runner &runner, const std::string &cls, const std::vector<Shape> &shapes,
+                     const std::vector<qreal> &x, const std::vector<qreal> &y)
+    {
+        const long long n = (long long)shapes.size();
+        std::vector<quint8> mask((npoints + 7) / 8);
+
+        runner.run("containsPoints(" + cls + ")", n, n * npoints, [&]() {
+            long long hits = 0;
+            for (const Shape &s : shapes) {
+                z_qtshapes::containsPoints(s, x.data(), y.data(), npoints, mask.data());
+                hits += mask[0];
+            }
+            return hits;
+        });
+
+        std::vector<float> distance(npoints);
+        runner.run("distanceRow(" + cls + ")", n, n * npoints, [&]() {
+            long long hits = 0;
+            for (const Shape &s : shapes) {
+                std::fill(distance.begin(), distance.end(), 1e9f);
+                z_qtshapes::distanceRow(s, QPointF(-150, -20), QPointF(300.0 / npoints, 0.5), distance.data(), npoints);
+                hits += distance[0] < 0;
+            }
+            return hits;
+        });
+    }
+
+}
+
+int main(int argc, char **argv)
+{
+    z_benchmark::Runner runner(argc, argv);
+
+    z_benchmark::Lcg rng;
+    std::vector<QPointF> points;
+    std::vector<qreal> x, y;
+    for (int i = 0; i < npoints; ++i) {
+        points.push_back(QPointF(rng.next(-150, 150), rng.next(-150, 150)));
+        x.push_back(points.back().x());
+        y.push_back(points.back().y());
+    }
+
+    for (int size : { 16, 256, 4096 }) {
+        std::vector<z_qtshapes::ZQRectF> rects;
+        std::vector<z_qtshapes::ZQTriF> tris;
+        std::vector<z_qtshapes::ZQEllipseF> ellipses;
+        std::vector<z_qtshapes::ZQLineF> lines;
+        for (int i = 0; i < size; ++i) {
+            const qreal px = rng.next(-100, 100), py = rng.next(-100, 100);
+            const qreal w = rng.next(1, 80), h = rng.next(1, 80), a = rng.next(0, 360);
+            rects.push_back(z_qtshapes::ZQRectF(px, py, w, h, a));
+            ellipses.push_back(z_qtshapes::ZQEllipseF(px, py, w, h, a));
+            tris.push_back(z_qtshapes::ZQTriF(QPointF(px, py), QPointF(px + w, py), QPointF(px, py + h), a));
+            lines.push_back(z_qtshapes::ZQLineF(QPointF(px, py), QPointF(px + w, py + h)));
+        }
+
+        benchShape(runner, "ZQRectF", rects, points);
+        benchShape(runner, "ZQTriF", tris, points);
+        benchShape(runner, "ZQEllipseF", ellipses, points);
+
+        const long long n = size;
+        runner.run("ZQLineF::contains(QPointF)", n, n * npoints, [&]() {
+            long long hits = 0;
+            for (const z_qtshapes::ZQLineF &l : lines)
+                for (const QPointF &p : points)
+                    hits += l.contains(p, 1e-9);
+            return hits;
+        });
+        runner.run("ZQLineF::intersects(ZQLineF)", n, n, [&]() {
+            long long hits = 0;
+            for (std::size_t i = 0; i < lines.size(); ++i)
+                hits += lines[i].intersects(lines[(i + 1) % lines.size()]);
+            return hits;
+        });
+
+        benchKernel(runner, "ZQRectF", rects, x, y);
+        benchKernel(runner, "ZQTriF", tris, x, y);
+        benchKernel(runner, "ZQEllipseF", ellipses, x, y);
+    }
+
+    return runner.finish();
+}
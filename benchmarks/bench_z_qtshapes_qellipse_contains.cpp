@@ -0,0 +1,70 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#include <vector>
+
+#include "z_benchmark.h"
+#include "z_qellipse.h"
+
+/*
+ * Compares the analytic ZQEllipse(F)::contains(point) against the
+ * QPainterPath based test it replaced. Both variants run over the same
+ * pseudo-random set of ellipses and points so the hit counts must agree
+ * up to the error of the cubic approximation used by toPath().
+ */
+
+namespace {
+
+    const int nshapes = 256;
+    const int npoints = 512;
+
+    template <typename Ellipse, typename Point>
+    void benchEllipses(z_benchmark::Runner &runner, const std::string &cls, const std::vector<Ellipse> &ellipses,
+                       const std::vector<Point> &points)
+    {
+        const long long n = (long long)ellipses.size();
+
+        runner.run(cls + "::contains analytic", n, n * npoints, [&]() {
+            long long hits = 0;
+            for (const Ellipse &e : ellipses)
+                for (const Point &p : points)
+                    hits += e.contains(p);
+            return hits;
+        });
+
+        runner.run(cls + "::contains path", n, n * npoints, [&]() {
+            long long hits = 0;
+            for (const Ellipse &e : ellipses)
+                for (const Point &p : points)
+                    hits += e.normalized().toPath().contains(QPointF(p));
+            return hits;
+        });
+    }
+
+}
+
+int main(int argc, char **argv)
+{
+    z_benchmark::Runner runner(argc, argv);
+    z_benchmark::Lcg rng;
+
+    std::vector<z_qtshapes::ZQEllipseF> ellipsesF;
+    std::vector<z_qtshapes::ZQEllipse> ellipses;
+    for (int i = 0; i < nshapes; ++i) {
+        const qreal x = rng.next(-100, 100), y = rng.next(-100, 100);
+        const qreal w = rng.next(1, 80), h = rng.next(1, 80), a = rng.next(0, 360);
+        ellipsesF.push_back(z_qtshapes::ZQEllipseF(x, y, w, h, a));
+        ellipses.push_back(z_qtshapes::ZQEllipse(int(x), int(y), int(w), int(h), int(a)));
+    }
+
+    std::vector<QPointF> pointsF;
+    std::vector<QPoint> points;
+    for (int i = 0; i < npoints; ++i) {
+        pointsF.push_back(QPointF(rng.next(-150, 150), rng.next(-150, 150)));
+        points.push_back(pointsF.back().toPoint());
+    }
+
+    benchEllipses(runner, "ZQEllipseF", ellipsesF, pointsF);
+    benchEllipses(runner, "ZQEllipse", ellipses, points);
+
+    return runner.finish();
+}
@@ -0,0 +1,163 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#include <vector>
+
+#include "z_benchmark.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+#include "z_qshapearray.h"
+#include "z_qpointkernels.h"
+
+/*
+ * rotate(), translate(), united(), intersected(), boundingRect() and
+ * toPath() for every floating point shape class, the batch transforms of
+ * the structure-of-arrays containers and the projective point transform,
+ * over growing sets of pseudo-random shapes and points.
+ */
+
+namespace {
+
+    template <typename Shape>
+    void benchShape(z_benchmark::Runner &runner, const std::string &cls, std::vector<Shape> shapes)
+    {
+        const long long n = (long long)shapes.size();
+
+        runner.run(cls + "::rotate", n, n, [&]() {
+            for (Shape &s : shapes)
+                s.rotate(1);
+            return (long long)shapes.front().angle();
+        });
+
+        runner.run(cls + "::translate", n, n, [&]() {
+            for (Shape &s : shapes)
+                s.translate(0.25, -0.25);
+            return (long long)shapes.front().center().x();
+        });
+
+        runner.run(cls + "::united", n, n, [&]() {
+            long long empty = 0;
+            for (std::size_t i = 0; i < shapes.size(); ++i)
+                empty += shapes[i].united(shapes[(i + 1) % shapes.size()]).isEmpty();
+            return empty;
+        });
+
+        runner.run(cls + "::intersected", n, n, [&]() {
+            long long empty = 0;
+            for (std::size_t i = 0; i < shapes.size(); ++i)
+                empty += shapes[i].intersected(shapes[(i + 1) % shapes.size()]).isEmpty();
+            return empty;
+        });
+
+        runner.run(cls + "::boundingRect", n, n, [&]() {
+            qreal left = 0;
+            for (const Shape &s : shapes)
+                left += s.boundingRect().left();
+            return (long long)left;
+        });
+
+        runner.run(cls + "::toPath", n, n, [&]() {
+            long long empty = 0;
+            for (const Shape &s : shapes)
+                empty += s.toPath().isEmpty();
+            return empty;
+        });
+
+        QMatrix3x3 mat;
+        mat(0, 0) = 1.5;
+        mat(0, 1) = 0.25;
+        mat(1, 1) = 0.75;
+        mat(2, 0) = 0.001;
+        const QPointF ref(10, 10);
+        runner.run(cls + "::toPath(QMatrix3x3)", n, n, [&]() {
+            long long empty = 0;
+            for (const Shape &s : shapes)
+                empty += s.toPath(mat, ref).isEmpty();
+            return empty;
+        });
+    }
+
+    template <typename Array, typename Shape>
+    void benchArray(z_benchmark::Runner &runner, const std::string &cls, const std::vector<Shape> &shapes)
+    {
+        const long long n = (long long)shapes.size();
+        Array array;
+        for (const Shape &s : shapes)
+            array.append(s);
+
+        runner.run(cls + "::rotate", n, n, [&]() {
+            array.rotate(1);
+            return (long long)array.angleData()[0];
+        });
+
+        runner.run(cls + "::translate", n, n, [&]() {
+            array.translate(0.25, -0.25);
+            return (long long)array.at(0).center().x();
+        });
+    }
+
+    template <typename T>
+    void benchPoints(z_benchmark::Runner &runner, const std::string &type, z_benchmark::Lcg &rng, int size)
+    {
+        std::vector<T> x(size), y(size), outX(size), outY(size);
+        for (int i = 0; i < size; ++i) {
+            x[i] = T(rng.next(-100, 100));
+            y[i] = T(rng.next(-100, 100));
+        }
+
+        QMatrix3x3 mat;
+        mat(0, 0) = 1.5;
+        mat(0, 1) = 0.25;
+        mat(1, 1) = 0.75;
+        mat(2, 0) = 0.001;
+        const z_qtshapes::ZQPointTransform transform(mat, QPointF(10, 10));
+
+        runner.run("transformPoints(" + type + ")", size, size, [&]() {
+            z_qtshapes::transformPoints(transform, x.data(), y.data(), outX.data(), outY.data(), size);
+            return (long long)outX[0];
+        });
+
+        runner.run("transformPoints(" + type + ", scalar)", size, size, [&]() {
+            z_qtshapes::transformPoints(transform, x.data(), y.data(), outX.data(), outY.data(), size,
+                    z_qtshapes::ZQScalarLevel);
+            return (long long)outX[0];
+        });
+    }
+
+}
+
+int main(int argc, char **argv)
+{
+    z_benchmark::Runner runner(argc, argv);
+    z_benchmark::Lcg rng;
+
+    for (int size : { 16, 256, 4096 }) {
+        std::vector<z_qtshapes::ZQRectF> rects;
+        std::vector<z_qtshapes::ZQTriF> tris;
+        std::vector<z_qtshapes::ZQEllipseF> ellipses;
+        std::vector<z_qtshapes::ZQLineF> lines;
+        for (int i = 0; i < size; ++i) {
+            const qreal px = rng.next(-100, 100), py = rng.next(-100, 100);
+            const qreal w = rng.next(1, 80), h = rng.next(1, 80), a = rng.next(0, 360);
+            rects.push_back(z_qtshapes::ZQRectF(px, py, w, h, a));
+            ellipses.push_back(z_qtshapes::ZQEllipseF(px, py, w, h, a));
+            tris.push_back(z_qtshapes::ZQTriF(QPointF(px, py), QPointF(px + w, py), QPointF(px, py + h), a));
+            lines.push_back(z_qtshapes::ZQLineF(QPointF(px, py), QPointF(px + w, py + h)));
+        }
+
+        benchShape(runner, "ZQRectF", rects);
+        benchShape(runner, "ZQTriF", tris);
+        benchShape(runner, "ZQEllipseF", ellipses);
+        benchShape(runner, "ZQLineF", lines);
+
+        benchArray<z_qtshapes::ZQRectFArray>(runner, "ZQRectFArray", rects);
+        benchArray<z_qtshapes::ZQTriFArray>(runner, "ZQTriFArray", tris);
+        benchArray<z_qtshapes::ZQEllipseFArray>(runner, "ZQEllipseFArray", ellipses);
+
+        benchPoints<double>(runner, "double", rng, size * 16);
+        benchPoints<float>(runner, "float", rng, size * 16);
+    }
+
+    return runner.finish();
+}
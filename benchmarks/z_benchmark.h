@@ -0,0 +1,210 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#ifndef Z_BENCHMARK_H
+#define Z_BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include <QtGlobal>
+
+// Set by benchmarks/CMakeLists.txt from the project version.
+#ifndef ZGLSHAPES_VERSION_STRING
+#define ZGLSHAPES_VERSION_STRING "unknown"
+#endif
+
+/*
+ * A self-contained timer harness for the benchmark executables.
+ *
+ * Every benchmark is a callable that runs one pass over its input set and
+ * returns a checksum, which is accumulated so that the compiler cannot
+ * discard the work. A pass is repeated until it has run for at least the
+ * minimum time, and the whole measurement is repeated a few times; the
+ * median and the fastest repetition are reported per operation.
+ *
+ * Results go to stdout as a table and, with --json <file>, to a JSON file
+ * laid out like the one Google Benchmark writes, so that its comparison
+ * tools can diff two releases. Benchmarks that give the floating point
+ * operations they perform also get a GFLOPS column and counter. Other
+ * options:
+ *
+ *   --filter <text>      only run benchmarks whose name contains text
+ *   --min-time <ms>      minimum time per repetition, default 100
+ *   --repetitions <n>    number of repetitions, default 5
+ */
+
+namespace z_benchmark {
+
+    // Small LCG so that every run sees the same input set.
+    struct Lcg {
+        quint32 state = 12345u;
+        qreal next(qreal lo, qreal hi) {
+            state = state * 1664525u + 1013904223u;
+            return lo + (hi - lo) * (state >> 8) / qreal(1u << 24);
+        }
+    };
+
+    class Runner {
+    public:
+        Runner(int argc, char **argv) : minTime(100), repetitions(5), checksum(0)
+        {
+            executable = argc > 0 ? argv[0] : "";
+            for (int i = 1; i + 1 < argc; i += 2) {
+                if (!std::strcmp(argv[i], "--json"))
+                    jsonPath = argv[i + 1];
+                else if (!std::strcmp(argv[i], "--filter"))
+                    filter = argv[i + 1];
+                else if (!std::strcmp(argv[i], "--min-time"))
+                    minTime = std::max(1, std::atoi(argv[i + 1]));
+                else if (!std::strcmp(argv[i], "--repetitions"))
+                    repetitions = std::max(1, std::atoi(argv[i + 1]));
+            }
+            std::printf("%-48s %14s %14s %12s\n", "Benchmark", "Median", "Fastest", "Iterations");
+        }
+
+        /*
+         * Measures body(), which must perform opsPerPass operations and
+         * return a checksum. The name gets "/size" appended. If flopsPerOp
+         * is given, the rate of floating point operations is reported too.
+         */
+        template <typename F>
+        void run(const std::string &name, long long size, long long opsPerPass, F body, double flopsPerOp = 0)
+        {
+            const std::string fullName = name + "/" + std::to_string(size);
+            if (!filter.empty() && fullName.find(filter) == std::string::npos)
+                return;
+
+            typedef std::chrono::steady_clock Clock;
+            const double minNs = minTime * 1e6;
+
+            // Calibrate the number of passes per repetition on a warm cache.
+            long long passes = 1;
+            for (;;) {
+                const auto start = Clock::now();
+                for (long long p = 0; p < passes; ++p)
+                    checksum += body();
+                const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+                if (ns >= minNs / 4 || passes >= (1ll << 40))
+                    break;
+                passes *= ns > 0 ? std::max(2ll, std::min(16ll, (long long)(minNs / 4 / ns) + 1)) : 16;
+            }
+            passes = std::max(1ll, passes * 4);
+
+            std::vector<double> real, cpu;
+            for (int r = 0; r < repetitions; ++r) {
+                const std::clock_t cpuStart = std::clock();
+                const auto start = Clock::now();
+                for (long long p = 0; p < passes; ++p)
+                    checksum += body();
+                const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+                const double cpuNs = 1e9 * double(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+                real.push_back(ns / (passes * opsPerPass));
+                cpu.push_back(cpuNs / (passes * opsPerPass));
+            }
+            std::sort(real.begin(), real.end());
+            std::sort(cpu.begin(), cpu.end());
+
+            Result result;
+            result.name = fullName;
+            result.size = size;
+            result.iterations = passes * opsPerPass;
+            result.median = real[real.size() / 2];
+            result.fastest = real.front();
+            result.cpu = cpu[cpu.size() / 2];
+            result.gflops = flopsPerOp > 0 ? flopsPerOp / result.median : 0;
+            results.push_back(result);
+
+            std::printf("%-48s %11.2f ns %11.2f ns %12lld", fullName.c_str(), result.median,
+                        result.fastest, result.iterations);
+            if (result.gflops > 0)
+                std::printf(" %9.2f GFLOPS", result.gflops);
+            std::printf("\n");
+            std::fflush(stdout);
+        }
+
+        // Writes the JSON report if one was requested. Returns the exit code.
+        int finish()
+        {
+            std::printf("checksum %llu\n", (unsigned long long)checksum);
+            if (jsonPath.empty())
+                return 0;
+
+            FILE *f = std::fopen(jsonPath.c_str(), "w");
+            if (!f) {
+                std::fprintf(stderr, "cannot write %s\n", jsonPath.c_str());
+                return 1;
+            }
+
+            char date[64];
+            const std::time_t now = std::time(nullptr);
+            std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+            std::fprintf(f, "{\n  \"context\": {\n");
+            std::fprintf(f, "    \"date\": \"%s\",\n", date);
+            std::fprintf(f, "    \"executable\": \"%s\",\n", escaped(executable).c_str());
+            std::fprintf(f, "    \"library_version\": \"%s\",\n", ZGLSHAPES_VERSION_STRING);
+            std::fprintf(f, "    \"min_time_ms\": %d,\n", minTime);
+            std::fprintf(f, "    \"repetitions\": %d\n", repetitions);
+            std::fprintf(f, "  },\n  \"benchmarks\": [\n");
+            for (std::size_t i = 0; i < results.size(); ++i) {
+                const Result &r = results[i];
+                std::fprintf(f, "    {\n");
+                std::fprintf(f, "      \"name\": \"%s\",\n", escaped(r.name).c_str());
+                std::fprintf(f, "      \"run_name\": \"%s\",\n", escaped(r.name).c_str());
+                std::fprintf(f, "      \"run_type\": \"aggregate\",\n");
+                std::fprintf(f, "      \"aggregate_name\": \"median\",\n");
+                std::fprintf(f, "      \"size\": %lld,\n", r.size);
+                std::fprintf(f, "      \"iterations\": %lld,\n", r.iterations);
+                std::fprintf(f, "      \"real_time\": %.4f,\n", r.median);
+                std::fprintf(f, "      \"cpu_time\": %.4f,\n", r.cpu);
+                std::fprintf(f, "      \"fastest_time\": %.4f,\n", r.fastest);
+                if (r.gflops > 0)
+                    std::fprintf(f, "      \"GFLOPS\": %.4f,\n", r.gflops);
+                std::fprintf(f, "      \"time_unit\": \"ns\"\n");
+                std::fprintf(f, "    }%s\n", i + 1 < results.size() ? "," : "");
+            }
+            std::fprintf(f, "  ]\n}\n");
+            std::fclose(f);
+            return 0;
+        }
+
+    private:
+        struct Result {
+            std::string name;
+            long long size;
+            long long iterations;
+            double median;
+            double fastest;
+            double cpu;
+            double gflops;
+        };
+
+        static std::string escaped(const std::string &s)
+        {
+            std::string out;
+            for (char c : s) {
+                if (c == '"' || c == '\\')
+                    out += '\\';
+                out += c;
+            }
+            return out;
+        }
+
+        std::string executable;
+        std::string jsonPath;
+        std::string filter;
+        int minTime;
+        int repetitions;
+        unsigned long long checksum;
+        std::vector<Result> results;
+    };
+
+}
+
+#endif
@@ -0,0 +1,114 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#ifndef Z_ALIGNED_H
+#define Z_ALIGNED_H
+
+#include <cstring>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <QtCore>
+
+namespace z_qtshapes {
+
+    /*
+     * A growable array of trivially copyable elements whose storage is
+     * aligned to Alignment bytes, so that SIMD loads and stores over it
+     * never straddle a cache line boundary at the start of the array.
+     * The capacity is always rounded up to a whole number of alignment
+     * blocks, so vector loops may read up to the end of the last block.
+     */
+    template <typename T, std::size_t Alignment = 64>
+    class ZQAlignedBuffer {
+        static_assert(std::is_trivially_copyable<T>::value, "ZQAlignedBuffer needs a trivially copyable type");
+        static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+
+    public:
+        ZQAlignedBuffer() noexcept : p(nullptr), n(0), cap(0) {}
+        explicit ZQAlignedBuffer(int size) : p(nullptr), n(0), cap(0) { resize(size); }
+        ZQAlignedBuffer(const ZQAlignedBuffer &other) : p(nullptr), n(0), cap(0)
+        {
+            reserve(other.n);
+            if (other.n)
+                std::memcpy(p, other.p, other.n * sizeof(T));
+            n = other.n;
+        }
+        ZQAlignedBuffer(ZQAlignedBuffer &&other) noexcept : p(other.p), n(other.n), cap(other.cap)
+        {
+            other.p = nullptr;
+            other.n = other.cap = 0;
+        }
+        ~ZQAlignedBuffer() { qFreeAligned(p); }
+
+        ZQAlignedBuffer &operator=(ZQAlignedBuffer other) noexcept
+        {
+            swap(other);
+            return *this;
+        }
+
+        void swap(ZQAlignedBuffer &other) noexcept
+        {
+            std::swap(p, other.p);
+            std::swap(n, other.n);
+            std::swap(cap, other.cap);
+        }
+
+        inline T *data() noexcept { return p; }
+        inline const T *data() const noexcept { return p; }
+        inline T *begin() noexcept { return p; }
+        inline const T *begin() const noexcept { return p; }
+        inline T *end() noexcept { return p + n; }
+        inline const T *end() const noexcept { return p + n; }
+        inline T &operator[](int i) noexcept { return p[i]; }
+        inline const T &operator[](int i) const noexcept { return p[i]; }
+
+        inline int size() const noexcept { return n; }
+        inline int capacity() const noexcept { return cap; }
+        inline bool isEmpty() const noexcept { return n == 0; }
+
+        void reserve(int size)
+        {
+            if (size <= cap)
+                return;
+            const int block = int(Alignment / sizeof(T)) > 0 ? int(Alignment / sizeof(T)) : 1;
+            const int newCap = (size + block - 1) / block * block;
+            T *q = static_cast<T *>(qMallocAligned(newCap * sizeof(T), Alignment));
+            if (!q)
+                throw std::bad_alloc();
+            if (n)
+                std::memcpy(q, p, n * sizeof(T));
+            std::memset(static_cast<void *>(q + n), 0, (newCap - n) * sizeof(T));
+            qFreeAligned(p);
+            p = q;
+            cap = newCap;
+        }
+
+        // New elements are zero filled.
+        void resize(int size)
+        {
+            if (size > cap)
+                reserve(qMax(size, cap + cap / 2));
+            else if (size > n)
+                std::memset(static_cast<void *>(p + n), 0, (size - n) * sizeof(T));
+            n = size;
+        }
+
+        void append(const T &value)
+        {
+            if (n == cap)
+                reserve(qMax(n + 1, cap + cap / 2));
+            p[n++] = value;
+        }
+
+        inline void clear() noexcept { n = 0; }
+
+    private:
+        T *p;
+        int n;
+        int cap;
+    };
+
+}
+
+#endif
@@ -44,6 +44,7 @@
 #define _USE_MATH_DEFINES
 #include <tgmath.h>
 #include <QtMath>
+#include <QRectF>
 
 /* TODO
  * qFuzzyEquals that always works
@@ -66,6 +67,41 @@ namespace z_qtshapes {
         qreal b = fmod(a, 360.0);
         return (b < 0.0) ? 360.0 + b : b;
     }
+
+    // Cosine and sine of an angle in degrees. Quarter turns are exact, so the
+    // bounding rectangles of shapes rotated by them carry no rounding noise.
+    inline void angleCosSin(qreal a, qreal *c, qreal *s)
+    {
+        const qreal b = normalizedAngle(a);
+        if (b == 0.0 || b == 180.0) {
+            *c = b == 0.0 ? 1.0 : -1.0;
+            *s = 0.0;
+        } else if (b == 90.0 || b == 270.0) {
+            *c = 0.0;
+            *s = b == 90.0 ? 1.0 : -1.0;
+        } else {
+            *c = qCos(M_PI/180 * b);
+            *s = qSin(M_PI/180 * b);
+        }
+    }
+
+    // Axis aligned bounds of n points rotated clockwise about center by the
+    // angle whose cosine and sine are c and s, as toPath() rotates them.
+    inline QRectF rotatedBounds(const QPointF *points, int n, const QPointF &center, qreal c, qreal s)
+    {
+        qreal l = 0, t = 0, r = 0, b = 0;
+        for (int i = 0; i < n; ++i) {
+            const qreal dx = points[i].x() - center.x();
+            const qreal dy = points[i].y() - center.y();
+            const qreal x = center.x() + c*dx + s*dy;
+            const qreal y = center.y() - s*dx + c*dy;
+            l = i ? qMin(l, x) : x;
+            t = i ? qMin(t, y) : y;
+            r = i ? qMax(r, x) : x;
+            b = i ? qMax(b, y) : y;
+        }
+        return QRectF(l, t, r - l, b - t);
+    }
 /*
         while (a < 0)
             a += 360 * MAX_ROTATIONS;
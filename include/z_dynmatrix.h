@@ -0,0 +1,405 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#ifndef Z_DYNMATRIX_H
+#define Z_DYNMATRIX_H
+
+#include <cassert>
+#include <QtWidgets>
+#include <QDataStream>
+#include <QDebug>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include "z_aligned.h"
+#include "z_gemm.h"
+
+namespace z_linalg {
+
+    /*
+     * A dense matrix whose size is chosen at run time. The elements live on
+     * the heap in column-major order like ZQMatrix and ZQOffsetMatrix, with
+     * every column starting on a 64-byte boundary, so a matrix with
+     * thousands of rows and columns neither overflows the stack nor
+     * instantiates new code for each size.
+     *
+     * Like ZQOffsetMatrix the first row and column index can be anything,
+     * which lets the 1-based routines in z_linalg.h work on it directly.
+     * Indices default to starting at zero like ZQMatrix.
+     *
+     * Unlike the fixed size classes a new matrix is zero filled rather than
+     * set to the identity, since most run time sized matrices are vectors
+     * or right hand sides.
+     */
+    template <typename T>
+     class ZQDynMatrix {
+    public:
+        typedef int index_type;
+        typedef T value_type;
+
+        inline ZQDynMatrix();
+        inline ZQDynMatrix(int rows, int columns, int minRow = 0, int minColumn = 0);
+        inline ZQDynMatrix(int rows, int columns, const T *values, int minRow = 0, int minColumn = 0);
+
+        inline void resize(int rows, int columns);
+        inline void setMinimum(int minRow, int minColumn);
+
+        inline const T& operator()(int row, int column) const;
+        inline T& operator()(int row, int column);
+        inline void set(int row, int column, T value);
+
+        inline bool isIdentity() const;
+        inline void setToIdentity();
+
+        inline void fill(T value);
+
+        inline int min_row() const { return minM; }
+        inline int max_row() const { return minM+M-1; }
+        inline int size_row() const { return M; }
+        inline int min_column() const { return minN; }
+        inline int max_column() const { return minN+N-1; }
+        inline int size_column() const { return N; }
+
+        inline int rows() const { return M; }
+        inline int columns() const { return N; }
+        // Distance in elements between the starts of two adjacent columns.
+        inline int stride() const { return ld; }
+
+        inline ZQDynMatrix<T> transposed() const;
+
+        inline ZQDynMatrix<T>& operator+=(const ZQDynMatrix<T>& other);
+        inline ZQDynMatrix<T>& operator-=(const ZQDynMatrix<T>& other);
+        inline ZQDynMatrix<T>& operator*=(T factor);
+        inline ZQDynMatrix<T>& operator/=(T divisor);
+
+        inline bool operator==(const ZQDynMatrix<T>& other) const;
+        inline bool operator!=(const ZQDynMatrix<T>& other) const;
+
+        inline void copyDataTo(T *values) const;
+
+        inline T *data() { return m.data(); }
+        inline const T *data() const { return m.data(); }
+        inline const T *constData() const { return m.data(); }
+        inline T *columnData(int column) { return m.data() + (column-minN)*ld; }
+        inline const T *columnData(int column) const { return m.data() + (column-minN)*ld; }
+
+        QString toString() const;
+
+    private:
+        static inline int paddedStride(int rows)
+        {
+            const int block = 64 % sizeof(T) == 0 ? int(64 / sizeof(T)) : 1;
+            return (rows + block - 1) / block * block;
+        }
+
+        z_qtshapes::ZQAlignedBuffer<T, 64> m;    // Column-major order, ld elements per column.
+        int M;
+        int N;
+        int ld;
+        int minM;
+        int minN;
+    };
+
+    template <typename T>
+     QDebug operator<<(QDebug dbg, const ZQDynMatrix<T> &m);
+    template <typename T>
+     QDataStream& operator<<(QDataStream &stream, const ZQDynMatrix<T> &matrix);
+    template <typename T>
+     QDataStream& operator>>(QDataStream &stream, ZQDynMatrix<T> &matrix);
+
+    template <typename T>
+     inline ZQDynMatrix<T>::ZQDynMatrix()
+        : M(0), N(0), ld(0), minM(0), minN(0)
+    {
+    }
+
+    template <typename T>
+     inline ZQDynMatrix<T>::ZQDynMatrix(int rows, int columns, int minRow, int minColumn)
+        : M(0), N(0), ld(0), minM(minRow), minN(minColumn)
+    {
+        resize(rows, columns);
+    }
+
+    template <typename T>
+     inline ZQDynMatrix<T>::ZQDynMatrix(int rows, int columns, const T *values, int minRow, int minColumn)
+        : M(0), N(0), ld(0), minM(minRow), minN(minColumn)
+    {
+        resize(rows, columns);
+        for (int col = 0; col < N; ++col)
+            for (int row = 0; row < M; ++row)
+                m[col*ld + row] = values[row * N + col];
+    }
+
+    /*
+     * Changes the size of the matrix and sets every element to zero.
+     */
+    template <typename T>
+     inline void ZQDynMatrix<T>::resize(int rows, int columns)
+    {
+        assert(rows >= 0 && columns >= 0 /* "Matrix dimensions must not be negative" */);
+        M = rows;
+        N = columns;
+        ld = paddedStride(rows);
+        m.clear();
+        m.resize(ld * N);
+    }
+
+    /*
+     * Renumbers the rows and columns to start at minRow and minColumn
+     * without touching the elements.
+     */
+    template <typename T>
+     inline void ZQDynMatrix<T>::setMinimum(int minRow, int minColumn)
+    {
+        minM = minRow;
+        minN = minColumn;
+    }
+
+    template <typename T>
+    inline const T& ZQDynMatrix<T>::operator()(int row, int column) const
+    {
+        assert(row >= minM /* "Row index is less than the allowed range" */);
+        assert(row < minM+M /* "Row index is greater than the allowed range" */);
+        assert(column >= minN /* "Column index is less than the allowed range" */);
+        assert(column < minN+N /* "Column index is greater than the allowed range" */);
+        return m[(column-minN)*ld + row-minM];
+    }
+
+    template <typename T>
+    inline T& ZQDynMatrix<T>::operator()(int row, int column)
+    {
+        assert(row >= minM /* "Row index is less than the allowed range" */);
+        assert(row < minM+M /* "Row index is greater than the allowed range" */);
+        assert(column >= minN /* "Column index is less than the allowed range" */);
+        assert(column < minN+N /* "Column index is greater than the allowed range" */);
+        return m[(column-minN)*ld + row-minM];
+    }
+
+    template <typename T>
+    inline void ZQDynMatrix<T>::set(int row, int column, T value)
+    {
+        (*this)(row, column) = value;
+    }
+
+    template <typename T>
+     inline bool ZQDynMatrix<T>::isIdentity() const
+    {
+        for (int col = 0; col < N; ++col) {
+            for (int row = 0; row < M; ++row) {
+                if (m[col*ld + row] != (row == col ? T(1) : T(0)))
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename T>
+     inline void ZQDynMatrix<T>::setToIdentity()
+    {
+        for (int col = 0; col < N; ++col)
+            for (int row = 0; row < M; ++row)
+                m[col*ld + row] = row == col ? T(1) : T(0);
+    }
+
+    template <typename T>
+     inline void ZQDynMatrix<T>::fill(T value)
+    {
+        for (int col = 0; col < N; ++col)
+            for (int row = 0; row < M; ++row)
+                m[col*ld + row] = value;
+    }
+
+    template <typename T>
+     inline ZQDynMatrix<T> ZQDynMatrix<T>::transposed() const
+    {
+        ZQDynMatrix<T> result(N, M, minN, minM);
+        for (int col = 0; col < N; ++col)
+            for (int row = 0; row < M; ++row)
+                result.m[row*result.ld + col] = m[col*ld + row];
+        return result;
+    }
+
+    template <typename T>
+     inline ZQDynMatrix<T> operator+(const ZQDynMatrix<T>& m1, const ZQDynMatrix<T>& m2)
+    {
+        ZQDynMatrix<T> result = m1;
+        result += m2;
+        return result;
+    }
+
+    template <typename T>
+     inline ZQDynMatrix<T> operator-(const ZQDynMatrix<T>& m1, const ZQDynMatrix<T>& m2)
+    {
+        ZQDynMatrix<T> result = m1;
+        result -= m2;
+        return result;
+    }
+
+    /*
+     * The result takes its row numbering from m1 and its column numbering
+     * from m2. Each column of the result is built up from whole columns of
+     * m1, which keeps every inner loop on contiguous memory.
+     *
+     * For float and double from GemmThreshold multiply-adds up the product
+     * runs in z_linalg::gemm() instead, which is compiled into zglshapes2d,
+     * so programs multiplying such matrices must link that library.
+     */
+    template <typename T>
+     inline ZQDynMatrix<T> operator*(const ZQDynMatrix<T>& m1, const ZQDynMatrix<T>& m2)
+    {
+        assert(m1.columns() == m2.rows() /* "Inner matrix dimensions do not agree" */);
+        ZQDynMatrix<T> result(m1.rows(), m2.columns(), m1.min_row(), m2.min_column());
+        matrixProduct(m1.rows(), m2.columns(), m1.columns(), m1.constData(), m1.stride(),
+                      m2.constData(), m2.stride(), result.data(), result.stride());
+        return result;
+    }
+
+    template <typename T>
+     inline ZQDynMatrix<T> operator-(const ZQDynMatrix<T>& matrix)
+    {
+        ZQDynMatrix<T> result = matrix;
+        result *= T(-1);
+        return result;
+    }
+
+    template <typename T>
+     inline ZQDynMatrix<T> operator*(T factor, const ZQDynMatrix<T>& matrix)
+    {
+        ZQDynMatrix<T> result = matrix;
+        result *= factor;
+        return result;
+    }
+
+    template <typename T>
+     inline ZQDynMatrix<T> operator*(const ZQDynMatrix<T>& matrix, T factor)
+    {
+        ZQDynMatrix<T> result = matrix;
+        result *= factor;
+        return result;
+    }
+
+    template <typename T>
+     inline ZQDynMatrix<T> operator/(const ZQDynMatrix<T>& matrix, T divisor)
+    {
+        ZQDynMatrix<T> result = matrix;
+        result /= divisor;
+        return result;
+    }
+
+    template <typename T>
+     inline ZQDynMatrix<T>& ZQDynMatrix<T>::operator+=(const ZQDynMatrix<T>& other)
+    {
+        assert(M == other.M && N == other.N /* "Matrix dimensions do not agree" */);
+        for (int col = 0; col < N; ++col)
+            for (int row = 0; row < M; ++row)
+                m[col*ld + row] += other.m[col*ld + row];
+        return *this;
+    }
+
+    template <typename T>
+     inline ZQDynMatrix<T>& ZQDynMatrix<T>::operator-=(const ZQDynMatrix<T>& other)
+    {
+        assert(M == other.M && N == other.N /* "Matrix dimensions do not agree" */);
+        for (int col = 0; col < N; ++col)
+            for (int row = 0; row < M; ++row)
+                m[col*ld + row] -= other.m[col*ld + row];
+        return *this;
+    }
+
+    template <typename T>
+     inline ZQDynMatrix<T>& ZQDynMatrix<T>::operator*=(T factor)
+    {
+        for (int col = 0; col < N; ++col)
+            for (int row = 0; row < M; ++row)
+                m[col*ld + row] *= factor;
+        return *this;
+    }
+
+    template <typename T>
+     inline ZQDynMatrix<T>& ZQDynMatrix<T>::operator/=(T divisor)
+    {
+        for (int col = 0; col < N; ++col)
+            for (int row = 0; row < M; ++row)
+                m[col*ld + row] /= divisor;
+        return *this;
+    }
+
+    template <typename T>
+     inline void ZQDynMatrix<T>::copyDataTo(T *values) const
+    {
+        for (int row = 0; row < M; ++row)
+            for (int col = 0; col < N; ++col)
+                values[row * N + col] = m[col*ld + row];
+    }
+
+    template <typename T>
+     inline bool ZQDynMatrix<T>::operator==(const ZQDynMatrix<T>& other) const
+    {
+        if (M != other.M || N != other.N)
+            return false;
+        for (int col = 0; col < N; ++col) {
+            for (int row = 0; row < M; ++row) {
+                if (m[col*ld + row] != other.m[col*ld + row])
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename T>
+     inline bool ZQDynMatrix<T>::operator!=(const ZQDynMatrix<T>& other) const
+    {
+        return !(*this == other);
+    }
+
+    template <typename T>
+     QString ZQDynMatrix<T>::toString() const
+    {
+        std::ostringstream o;
+        o << "ZQDynMatrix(" << M << ", " << N << ", " << minM << ", " << minN
+            << ")(" << std::endl << std::setw(10);
+        for (int row = 0; row < M; ++row) {
+            for (int col = 0; col < N; ++col) {
+                o << m[col*ld + row];
+                if (col != N)
+                    o << std::setw(10);
+            }
+            o << std::endl;
+            if (row != M)
+                o << std::setw(10);
+        }
+        o << std::setw(0) << ")";
+        return QString(o.str().c_str());
+    }
+
+    template <typename T>
+    QDebug operator<<(QDebug dbg, const ZQDynMatrix<T> &m)
+    {
+        dbg << m.toString();
+        return dbg;
+    }
+
+    template <typename T>
+    QDataStream& operator<<(QDataStream &stream, const ZQDynMatrix<T> &matrix)
+    {
+        for (int row = matrix.min_row(); row <= matrix.max_row(); ++row)
+            for (int col = matrix.min_column(); col <= matrix.max_column(); ++col)
+                stream << double(matrix(row, col));
+        return stream;
+    }
+
+    template <typename T>
+    QDataStream& operator>>(QDataStream &stream, ZQDynMatrix<T> &matrix)
+    {
+        double x;
+        for (int row = matrix.min_row(); row <= matrix.max_row(); ++row) {
+            for (int col = matrix.min_column(); col <= matrix.max_column(); ++col) {
+                stream >> x;
+                matrix(row, col) = T(x);
+            }
+        }
+        return stream;
+    }
+
+}
+
+#endif
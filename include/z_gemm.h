@@ -0,0 +1,150 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#ifndef Z_GEMM_H
+#define Z_GEMM_H
+
+#include "z_simdlevel.h"
+
+namespace z_linalg {
+
+    /*
+     * C = A * B for column-major matrices, with A m x k, B k x n and C
+     * m x n, and lda, ldb and ldc the distance between the starts of two
+     * columns. C must not overlap A or B. The product is cache-blocked and
+     * runs in register-tiled kernels; see src/z_gemm.cpp.
+     *
+     * gemm() is compiled into zglshapes2d, not defined in this header.
+     * matrixProduct() calls it for float and double products of at least
+     * GemmThreshold multiply-adds, so code that multiplies matrices of
+     * those types must link zglshapes2d even if it includes nothing else.
+     */
+    void gemm(int m, int n, int k, const double *a, int lda, const double *b, int ldb, double *c, int ldc,
+              z_qtshapes::ZQSimdLevel level = z_qtshapes::ZQAVX512Level);
+    void gemm(int m, int n, int k, const float *a, int lda, const float *b, int ldb, float *c, int ldc,
+              z_qtshapes::ZQSimdLevel level = z_qtshapes::ZQAVX512Level);
+
+    /*
+     * The same product one column of C at a time: each column of C is
+     * built up from the columns of A scaled by the matching entries of B,
+     * so the innermost loop runs down contiguous memory. This is the
+     * product for element types other than float and double, and for
+     * products too small to pay for packing the blocked kernels' operands.
+     */
+    template <typename T>
+     inline void columnProduct(int m, int n, int k, const T *a, int lda, const T *b, int ldb, T *c, int ldc)
+    {
+        for (int col = 0; col < n; ++col) {
+            T *r = c + col*ldc;
+            for (int row = 0; row < m; ++row)
+                r[row] = T(0);
+            for (int j = 0; j < k; ++j) {
+                const T factor = b[col*ldb + j];
+                const T *s = a + j*lda;
+                for (int row = 0; row < m; ++row)
+                    r[row] += s[row] * factor;
+            }
+        }
+    }
+
+    // Below this many multiply-adds the column loop beats the blocked kernels.
+    const long long GemmThreshold = 16*16*16;
+
+    template <typename T>
+     inline void matrixProduct(int m, int n, int k, const T *a, int lda, const T *b, int ldb, T *c, int ldc)
+    {
+        columnProduct(m, n, k, a, lda, b, ldb, c, ldc);
+    }
+
+    inline void matrixProduct(int m, int n, int k, const double *a, int lda, const double *b, int ldb, double *c, int ldc)
+    {
+        if ((long long)m * n * k < GemmThreshold)
+            columnProduct(m, n, k, a, lda, b, ldb, c, ldc);
+        else
+            gemm(m, n, k, a, lda, b, ldb, c, ldc);
+    }
+
+    inline void matrixProduct(int m, int n, int k, const float *a, int lda, const float *b, int ldb, float *c, int ldc)
+    {
+        if ((long long)m * n * k < GemmThreshold)
+            columnProduct(m, n, k, a, lda, b, ldb, c, ldc);
+        else
+            gemm(m, n, k, a, lda, b, ldb, c, ldc);
+    }
+
+    /*
+     * Fully unrolled products of square column-major matrices of the
+     * sizes used for 2D and 3D transforms, with no loops or branches left
+     * for the compiler to get wrong.
+     */
+    template <typename T>
+     inline void product2x2(const T *a, const T *b, T *c)
+    {
+        c[0] = a[0]*b[0] + a[2]*b[1];
+        c[1] = a[1]*b[0] + a[3]*b[1];
+        c[2] = a[0]*b[2] + a[2]*b[3];
+        c[3] = a[1]*b[2] + a[3]*b[3];
+    }
+
+    template <typename T>
+     inline void product3x3(const T *a, const T *b, T *c)
+    {
+        c[0] = a[0]*b[0] + a[3]*b[1] + a[6]*b[2];
+        c[1] = a[1]*b[0] + a[4]*b[1] + a[7]*b[2];
+        c[2] = a[2]*b[0] + a[5]*b[1] + a[8]*b[2];
+        c[3] = a[0]*b[3] + a[3]*b[4] + a[6]*b[5];
+        c[4] = a[1]*b[3] + a[4]*b[4] + a[7]*b[5];
+        c[5] = a[2]*b[3] + a[5]*b[4] + a[8]*b[5];
+        c[6] = a[0]*b[6] + a[3]*b[7] + a[6]*b[8];
+        c[7] = a[1]*b[6] + a[4]*b[7] + a[7]*b[8];
+        c[8] = a[2]*b[6] + a[5]*b[7] + a[8]*b[8];
+    }
+
+    template <typename T>
+     inline void product4x4(const T *a, const T *b, T *c)
+    {
+        c[0] = a[0]*b[0] + a[4]*b[1] + a[8]*b[2] + a[12]*b[3];
+        c[1] = a[1]*b[0] + a[5]*b[1] + a[9]*b[2] + a[13]*b[3];
+        c[2] = a[2]*b[0] + a[6]*b[1] + a[10]*b[2] + a[14]*b[3];
+        c[3] = a[3]*b[0] + a[7]*b[1] + a[11]*b[2] + a[15]*b[3];
+        c[4] = a[0]*b[4] + a[4]*b[5] + a[8]*b[6] + a[12]*b[7];
+        c[5] = a[1]*b[4] + a[5]*b[5] + a[9]*b[6] + a[13]*b[7];
+        c[6] = a[2]*b[4] + a[6]*b[5] + a[10]*b[6] + a[14]*b[7];
+        c[7] = a[3]*b[4] + a[7]*b[5] + a[11]*b[6] + a[15]*b[7];
+        c[8] = a[0]*b[8] + a[4]*b[9] + a[8]*b[10] + a[12]*b[11];
+        c[9] = a[1]*b[8] + a[5]*b[9] + a[9]*b[10] + a[13]*b[11];
+        c[10] = a[2]*b[8] + a[6]*b[9] + a[10]*b[10] + a[14]*b[11];
+        c[11] = a[3]*b[8] + a[7]*b[9] + a[11]*b[10] + a[15]*b[11];
+        c[12] = a[0]*b[12] + a[4]*b[13] + a[8]*b[14] + a[12]*b[15];
+        c[13] = a[1]*b[12] + a[5]*b[13] + a[9]*b[14] + a[13]*b[15];
+        c[14] = a[2]*b[12] + a[6]*b[13] + a[10]*b[14] + a[14]*b[15];
+        c[15] = a[3]*b[12] + a[7]*b[13] + a[11]*b[14] + a[15]*b[15];
+    }
+
+    /*
+     * Product of fixed size column-major matrices with contiguous columns,
+     * M x K times K x N, as stored by ZQMatrix and ZQOffsetMatrix. The
+     * square 2, 3 and 4 sizes go to the unrolled products.
+     */
+    template <int M, int N, int K, typename T>
+     struct ZQFixedProduct {
+        static inline void run(const T *a, const T *b, T *c) { matrixProduct(M, N, K, a, M, b, K, c, M); }
+    };
+
+    template <typename T>
+     struct ZQFixedProduct<2, 2, 2, T> {
+        static inline void run(const T *a, const T *b, T *c) { product2x2(a, b, c); }
+    };
+
+    template <typename T>
+     struct ZQFixedProduct<3, 3, 3, T> {
+        static inline void run(const T *a, const T *b, T *c) { product3x3(a, b, c); }
+    };
+
+    template <typename T>
+     struct ZQFixedProduct<4, 4, 4, T> {
+        static inline void run(const T *a, const T *b, T *c) { product4x4(a, b, c); }
+    };
+
+}
+
+#endif
@@ -0,0 +1,707 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#ifndef Z_KRYLOV_H
+#define Z_KRYLOV_H
+
+#include <cmath>
+#include <functional>
+#include <string>
+#include <QtWidgets>
+#include <QVector>
+#include "z_offsetmatrix.h"
+#include "z_sparsematrix.h"
+
+namespace z_linalg {
+
+    /*
+     * Preconditioned Krylov solvers for A x = b: linear_cg() for symmetric
+     * positive definite A, linear_bicgstab() and linear_gmres() for any
+     * nonsingular A.
+     *
+     * A is only used through A.rows() and A.multiply(x, y), which sets
+     * y = A x for arrays of A.rows() elements, so ZQSparseMatrix can be
+     * passed directly and products that are never stored as a matrix can
+     * be wrapped with linearOperator(). The preconditioner M is used
+     * through M.solve(r, z), which sets z to an approximation of A^-1 r;
+     * ZQIdentityPreconditioner, ZQJacobiPreconditioner,
+     * ZQILU0Preconditioner and ZQIncompleteCholeskyPreconditioner are
+     * provided.
+     *
+     * On input x holds the initial guess. The solvers stop when the
+     * residual norm |b - A x| divided by |b| is below tol, and return
+     * false with error set when itmax iterations did not get there or the
+     * method broke down. iter is set to the number of iterations and err
+     * to the last relative residual. If progress is given it is called
+     * after every iteration with the iteration number and the relative
+     * residual; returning false from it stops the solver early with x
+     * holding the current iterate, and the solver then returns true.
+     */
+    template <typename T>
+     struct ZQKrylovProgress {
+        typedef std::function<bool(int iteration, T residual)> type;
+    };
+
+    /*
+     * A matrix-free operator of size n x n: multiply(x, y) calls
+     * product(x, y), which must set y = A x.
+     */
+    template <typename T, typename Product>
+     class ZQLinearOperator {
+    public:
+        typedef T value_type;
+
+        inline ZQLinearOperator(int n, Product product) : size(n), f(product) {}
+
+        inline int rows() const { return size; }
+        inline int columns() const { return size; }
+        inline void multiply(const T *x, T *y) const { f(x, y); }
+
+    private:
+        int size;
+        Product f;
+    };
+
+    template <typename T, typename Product>
+     inline ZQLinearOperator<T, Product> linearOperator(int n, Product product)
+    {
+        return ZQLinearOperator<T, Product>(n, product);
+    }
+
+    // No preconditioning: z = r, for vectors of the given size.
+    template <typename T>
+     class ZQIdentityPreconditioner {
+    public:
+        explicit inline ZQIdentityPreconditioner(int size) : n(size) {}
+        inline void solve(const T *r, T *z) const { std::copy(r, r + n, z); }
+
+    private:
+        int n;
+    };
+
+    // Divides by the diagonal of A.
+    template <typename T>
+     class ZQJacobiPreconditioner {
+    public:
+        bool compute(const ZQSparseMatrix<T> &A, std::string &error);
+        void solve(const T *r, T *z) const;
+
+    private:
+        QVector<T> inverse;
+    };
+
+    /*
+     * Incomplete LU factorization with no fill-in: A ~ L U, where unit
+     * lower triangular L and upper triangular U together have the nonzero
+     * pattern of A. A must have every diagonal element in its pattern.
+     */
+    template <typename T>
+     class ZQILU0Preconditioner {
+    public:
+        bool compute(const ZQSparseMatrix<T> &A, std::string &error);
+        void solve(const T *r, T *z) const;
+
+    private:
+        // L below and U on and above the diagonal, in compressed rows.
+        QVector<int> off, idx, diagonal;
+        QVector<T> val;
+    };
+
+    /*
+     * Incomplete Cholesky factorization with no fill-in: A ~ L L', where L
+     * has the pattern of the lower triangle of A. A must be symmetric
+     * positive definite; only its lower triangle is read.
+     */
+    template <typename T>
+     class ZQIncompleteCholeskyPreconditioner {
+    public:
+        bool compute(const ZQSparseMatrix<T> &A, std::string &error);
+        void solve(const T *r, T *z) const;
+
+    private:
+        // L in compressed rows, each ending with its diagonal element.
+        QVector<int> off, idx;
+        QVector<T> val;
+    };
+
+    namespace krylov_detail {
+
+        template <typename T>
+         inline T dot(int n, const T *x, const T *y)
+        {
+            T sum(0);
+            for (int i = 0; i < n; ++i)
+                sum += x[i] * y[i];
+            return sum;
+        }
+
+        template <typename T>
+         inline T norm(int n, const T *x)
+        {
+            return std::sqrt(dot(n, x, x));
+        }
+
+        // r = b - A x.
+        template <typename Operator, typename T>
+         inline void residual(const Operator &A, const T *b, const T *x, T *r)
+        {
+            A.multiply(x, r);
+            for (int i = 0; i < A.rows(); ++i)
+                r[i] = b[i] - r[i];
+        }
+
+        // Norm of b, with zero handled by making x zero as well.
+        template <typename T>
+         inline bool trivial(int n, const T *b, T *x, T &bnrm, int &iter, T &err)
+        {
+            bnrm = norm(n, b);
+            if (bnrm != T(0))
+                return false;
+            std::fill(x, x + n, T(0));
+            iter = 0;
+            err = 0;
+            return true;
+        }
+
+        template <typename T>
+         inline bool stopped(const typename ZQKrylovProgress<T>::type &progress, int iter, T err)
+        {
+            return progress && !progress(iter, err);
+        }
+
+    }
+
+    /*
+     * Preconditioned conjugate gradients. A and M must both be symmetric
+     * positive definite.
+     */
+    template <typename Operator, typename Preconditioner, typename T>
+     bool linear_cg(const Operator &A, const Preconditioner &M, const T *b, T *x, T tol, int itmax,
+        int &iter, T &err, std::string &error,
+        const typename ZQKrylovProgress<T>::type &progress = typename ZQKrylovProgress<T>::type())
+    {
+        using namespace krylov_detail;
+        const int n = A.rows();
+        T bnrm;
+        if (trivial(n, b, x, bnrm, iter, err))
+            return true;
+
+        QVector<T> work(4 * n);
+        T *r = work.data(), *z = r + n, *p = z + n, *q = p + n;
+        residual(A, b, x, r);
+        err = norm(n, r) / bnrm;
+        iter = 0;
+        if (err < tol)
+            return true;
+        M.solve(r, z);
+        std::copy(z, z + n, p);
+        T rz = dot(n, r, z);
+
+        while (iter < itmax) {
+            ++iter;
+            A.multiply(p, q);
+            const T pq = dot(n, p, q);
+            if (pq <= T(0)) {
+                error = std::string("Matrix is not positive definite in linear_cg");
+                return false;
+            }
+            const T alpha = rz / pq;
+            for (int i = 0; i < n; ++i) {
+                x[i] += alpha * p[i];
+                r[i] -= alpha * q[i];
+            }
+            err = norm(n, r) / bnrm;
+            if (stopped(progress, iter, err) || err < tol)
+                return true;
+
+            M.solve(r, z);
+            const T rzNew = dot(n, r, z);
+            const T beta = rzNew / rz;
+            rz = rzNew;
+            for (int i = 0; i < n; ++i)
+                p[i] = z[i] + beta * p[i];
+        }
+        error = std::string("Too many iterations in linear_cg");
+        return false;
+    }
+
+    /*
+     * Stabilized biconjugate gradients (BiCGSTAB), preconditioned on the
+     * right. Each iteration takes two products with A and two solves
+     * with M, and no products with A'.
+     */
+    template <typename Operator, typename Preconditioner, typename T>
+     bool linear_bicgstab(const Operator &A, const Preconditioner &M, const T *b, T *x, T tol, int itmax,
+        int &iter, T &err, std::string &error,
+        const typename ZQKrylovProgress<T>::type &progress = typename ZQKrylovProgress<T>::type())
+    {
+        using namespace krylov_detail;
+        const int n = A.rows();
+        T bnrm;
+        if (trivial(n, b, x, bnrm, iter, err))
+            return true;
+
+        QVector<T> work(8 * n);
+        T *r = work.data(), *rhat = r + n, *p = rhat + n, *v = p + n;
+        T *phat = v + n, *s = phat + n, *shat = s + n, *t = shat + n;
+        residual(A, b, x, r);
+        err = norm(n, r) / bnrm;
+        iter = 0;
+        if (err < tol)
+            return true;
+        std::copy(r, r + n, rhat);
+        T rho(1), alpha(1), omega(1);
+
+        while (iter < itmax) {
+            ++iter;
+            const T rhoNew = dot(n, rhat, r);
+            if (rhoNew == T(0)) {
+                error = std::string("Breakdown in linear_bicgstab");
+                return false;
+            }
+            const T beta = (rhoNew / rho) * (alpha / omega);
+            rho = rhoNew;
+            for (int i = 0; i < n; ++i)
+                p[i] = r[i] + beta * (p[i] - omega * v[i]);
+            M.solve(p, phat);
+            A.multiply(phat, v);
+            alpha = rho / dot(n, rhat, v);
+            for (int i = 0; i < n; ++i)
+                s[i] = r[i] - alpha * v[i];
+
+            err = norm(n, s) / bnrm;
+            if (err < tol) {
+                for (int i = 0; i < n; ++i)
+                    x[i] += alpha * phat[i];
+                stopped(progress, iter, err);
+                return true;
+            }
+
+            M.solve(s, shat);
+            A.multiply(shat, t);
+            const T tt = dot(n, t, t);
+            omega = tt != T(0) ? dot(n, t, s) / tt : T(0);
+            for (int i = 0; i < n; ++i) {
+                x[i] += alpha * phat[i] + omega * shat[i];
+                r[i] = s[i] - omega * t[i];
+            }
+            err = norm(n, r) / bnrm;
+            if (stopped(progress, iter, err) || err < tol)
+                return true;
+            if (omega == T(0)) {
+                error = std::string("Breakdown in linear_bicgstab");
+                return false;
+            }
+        }
+        error = std::string("Too many iterations in linear_bicgstab");
+        return false;
+    }
+
+    /*
+     * Restarted GMRES(restart), preconditioned on the right. Every cycle
+     * builds an orthonormal basis of up to restart Krylov vectors with
+     * modified Gram-Schmidt and minimizes the residual over it using
+     * Givens rotations, so the residual never grows; memory is
+     * (restart + 1) vectors of size n. Every basis vector counts as one
+     * iteration.
+     */
+    template <typename Operator, typename Preconditioner, typename T>
+     bool linear_gmres(const Operator &A, const Preconditioner &M, const T *b, T *x, T tol, int itmax, int restart,
+        int &iter, T &err, std::string &error,
+        const typename ZQKrylovProgress<T>::type &progress = typename ZQKrylovProgress<T>::type())
+    {
+        using namespace krylov_detail;
+        const int n = A.rows();
+        T bnrm;
+        if (trivial(n, b, x, bnrm, iter, err))
+            return true;
+        if (restart < 1) {
+            error = std::string("restart must be at least 1 in linear_gmres");
+            return false;
+        }
+        const int m = qMin(restart, n);
+
+        QVector<T> V((m + 1) * n), H((m + 1) * m), cs(m), sn(m), g(m + 1), y(m), work(2 * n);
+        T *w = work.data(), *u = w + n;
+        iter = 0;
+        while (true) {
+            T *v0 = V.data();
+            residual(A, b, x, v0);
+            const T beta = norm(n, v0);
+            err = beta / bnrm;
+            if (err < tol)
+                return true;
+            if (iter >= itmax)
+                break;
+            for (int i = 0; i < n; ++i)
+                v0[i] /= beta;
+            std::fill(g.begin(), g.end(), T(0));
+            g[0] = beta;
+
+            int k = 0;
+            bool done = false;
+            while (k < m && iter < itmax) {
+                ++iter;
+                T *h = H.data() + k * (m + 1);
+                T *vk = V.data() + k * n, *vNext = vk + n;
+                M.solve(vk, u);
+                A.multiply(u, w);
+                for (int j = 0; j <= k; ++j) {
+                    const T *vj = V.constData() + j * n;
+                    h[j] = dot(n, w, vj);
+                    for (int i = 0; i < n; ++i)
+                        w[i] -= h[j] * vj[i];
+                }
+                h[k+1] = norm(n, w);
+                if (h[k+1] != T(0))
+                    for (int i = 0; i < n; ++i)
+                        vNext[i] = w[i] / h[k+1];
+
+                for (int j = 0; j < k; ++j) {
+                    const T hj = cs[j] * h[j] + sn[j] * h[j+1];
+                    h[j+1] = -sn[j] * h[j] + cs[j] * h[j+1];
+                    h[j] = hj;
+                }
+                const T rr = std::sqrt(h[k] * h[k] + h[k+1] * h[k+1]);
+                cs[k] = h[k] / rr;
+                sn[k] = h[k+1] / rr;
+                h[k] = rr;
+                h[k+1] = 0;
+                g[k+1] = -sn[k] * g[k];
+                g[k] = cs[k] * g[k];
+                ++k;
+
+                err = qAbs(g[k]) / bnrm;
+                if (stopped(progress, iter, err) || err < tol) {
+                    done = true;
+                    break;
+                }
+            }
+
+            // x += M^-1 V y, with H y = g solved by back substitution.
+            for (int j = k - 1; j >= 0; --j) {
+                T sum = g[j];
+                for (int l = j + 1; l < k; ++l)
+                    sum -= H[l * (m + 1) + j] * y[l];
+                y[j] = sum / H[j * (m + 1) + j];
+            }
+            std::fill(w, w + n, T(0));
+            for (int j = 0; j < k; ++j) {
+                const T *vj = V.constData() + j * n;
+                for (int i = 0; i < n; ++i)
+                    w[i] += y[j] * vj[i];
+            }
+            M.solve(w, u);
+            for (int i = 0; i < n; ++i)
+                x[i] += u[i];
+            if (done)
+                return true;
+        }
+        error = std::string("Too many iterations in linear_gmres");
+        return false;
+    }
+
+    template <typename T>
+     bool ZQJacobiPreconditioner<T>::compute(const ZQSparseMatrix<T> &A, std::string &error)
+    {
+        if (A.rows() != A.columns()) {
+            error = std::string("Matrix is not square in ZQJacobiPreconditioner");
+            return false;
+        }
+        inverse = QVector<T>(A.rows());
+        for (int i = 0; i < A.rows(); ++i) {
+            const T d = A.value(i, i);
+            if (d == T(0)) {
+                error = std::string("Zero diagonal element in ZQJacobiPreconditioner");
+                return false;
+            }
+            inverse[i] = T(1) / d;
+        }
+        return true;
+    }
+
+    template <typename T>
+     void ZQJacobiPreconditioner<T>::solve(const T *r, T *z) const
+    {
+        for (int i = 0; i < inverse.size(); ++i)
+            z[i] = r[i] * inverse[i];
+    }
+
+    /*
+     * Row by row Gaussian elimination restricted to the pattern of A: each
+     * entry left of the diagonal is divided by the pivot of its column,
+     * and that multiple of the pivot's row is subtracted from the entries
+     * of this row that are in the pattern, dropping the rest.
+     */
+    template <typename T>
+     bool ZQILU0Preconditioner<T>::compute(const ZQSparseMatrix<T> &A, std::string &error)
+    {
+        if (A.rows() != A.columns()) {
+            error = std::string("Matrix is not square in ZQILU0Preconditioner");
+            return false;
+        }
+        const ZQSparseMatrix<T> csr = A.converted(ZQSparseMatrix<T>::CompressedRows);
+        const int n = csr.rows();
+        off = csr.offsets();
+        idx = csr.indices();
+        val = csr.values();
+        const int *offs = off.constData(), *cols = idx.constData();
+        T *a = val.data();
+
+        diagonal = QVector<int>(n);
+        for (int i = 0; i < n; ++i) {
+            const int *p = std::lower_bound(cols + offs[i], cols + offs[i+1], i);
+            if (p == cols + offs[i+1] || *p != i) {
+                error = std::string("Missing diagonal element in ZQILU0Preconditioner");
+                return false;
+            }
+            diagonal[i] = int(p - cols);
+        }
+
+        QVector<int> position(n, -1);
+        for (int i = 0; i < n; ++i) {
+            for (int q = offs[i]; q < offs[i+1]; ++q)
+                position[cols[q]] = q;
+            for (int q = offs[i]; q < diagonal[i]; ++q) {
+                const int k = cols[q];
+                a[q] /= a[diagonal[k]];
+                for (int p = diagonal[k] + 1; p < offs[k+1]; ++p) {
+                    const int j = position[cols[p]];
+                    if (j >= 0)
+                        a[j] -= a[q] * a[p];
+                }
+            }
+            for (int q = offs[i]; q < offs[i+1]; ++q)
+                position[cols[q]] = -1;
+            if (a[diagonal[i]] == T(0)) {
+                error = std::string("Zero pivot in ZQILU0Preconditioner");
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename T>
+     void ZQILU0Preconditioner<T>::solve(const T *r, T *z) const
+    {
+        const int n = diagonal.size();
+        const T *a = val.constData();
+        for (int i = 0; i < n; ++i) {
+            T sum = r[i];
+            for (int q = off[i]; q < diagonal[i]; ++q)
+                sum -= a[q] * z[idx[q]];
+            z[i] = sum;
+        }
+        for (int i = n - 1; i >= 0; --i) {
+            T sum = z[i];
+            for (int q = diagonal[i] + 1; q < off[i+1]; ++q)
+                sum -= a[q] * z[idx[q]];
+            z[i] = sum / a[diagonal[i]];
+        }
+    }
+
+    /*
+     * Row i of L comes from row i of A less the products of earlier rows
+     * of L over the columns both have, so each entry is a merge of two
+     * sorted rows. The diagonal is the last entry of every row.
+     */
+    template <typename T>
+     bool ZQIncompleteCholeskyPreconditioner<T>::compute(const ZQSparseMatrix<T> &A, std::string &error)
+    {
+        if (A.rows() != A.columns()) {
+            error = std::string("Matrix is not square in ZQIncompleteCholeskyPreconditioner");
+            return false;
+        }
+        const ZQSparseMatrix<T> csr = A.converted(ZQSparseMatrix<T>::CompressedRows);
+        const int n = csr.rows();
+        off = QVector<int>(n + 1, 0);
+        idx.clear();
+        val.clear();
+        for (int i = 0; i < n; ++i) {
+            for (int q = csr.offsets()[i]; q < csr.offsets()[i+1] && csr.indices()[q] <= i; ++q) {
+                idx.append(csr.indices()[q]);
+                val.append(csr.values()[q]);
+            }
+            off[i+1] = idx.size();
+        }
+
+        const int *offs = off.constData(), *cols = idx.constData();
+        T *l = val.data();
+        for (int i = 0; i < n; ++i) {
+            if (offs[i+1] == offs[i] || cols[offs[i+1] - 1] != i) {
+                error = std::string("Missing diagonal element in ZQIncompleteCholeskyPreconditioner");
+                return false;
+            }
+            for (int q = offs[i]; q < offs[i+1]; ++q) {
+                const int j = cols[q];
+                T sum = l[q];
+                int p = offs[i], s = offs[j];
+                while (p < q && s < offs[j+1] - 1) {
+                    if (cols[p] < cols[s]) {
+                        ++p;
+                    } else if (cols[p] > cols[s]) {
+                        ++s;
+                    } else {
+                        sum -= l[p++] * l[s++];
+                    }
+                }
+                if (j < i) {
+                    l[q] = sum / l[offs[j+1] - 1];
+                } else if (sum <= T(0)) {
+                    error = std::string("Matrix is not positive definite in ZQIncompleteCholeskyPreconditioner");
+                    return false;
+                } else {
+                    l[q] = std::sqrt(sum);
+                }
+            }
+        }
+        return true;
+    }
+
+    template <typename T>
+     void ZQIncompleteCholeskyPreconditioner<T>::solve(const T *r, T *z) const
+    {
+        const int n = off.size() - 1;
+        const T *l = val.constData();
+        for (int i = 0; i < n; ++i) {
+            T sum = r[i];
+            for (int q = off[i]; q < off[i+1] - 1; ++q)
+                sum -= l[q] * z[idx[q]];
+            z[i] = sum / l[off[i+1] - 1];
+        }
+        for (int i = n - 1; i >= 0; --i) {
+            z[i] /= l[off[i+1] - 1];
+            for (int q = off[i]; q < off[i+1] - 1; ++q)
+                z[idx[q]] -= l[q] * z[i];
+        }
+    }
+
+
+    namespace krylov_detail {
+
+        /*
+         * Solves the system held in the row-indexed arrays sa and ija for
+         * linear_bcg_zq() and linear_bcg(), with b and x any column
+         * vectors. itol 1 preconditions on the right with the diagonal D
+         * of A, so the solver stops on |b - A x| / |b|. itol 2 solves
+         * D^-1 A x = D^-1 b instead, which stops on
+         * |D^-1 (b - A x)| / |D^-1 b|. Zero diagonal elements count as 1.
+         */
+        template <typename ValueArray, typename IndexArray, typename VectorType, typename VectorType2, typename T>
+         bool bcg_row_indexed(const ValueArray &sa, const IndexArray &ija, const VectorType &b, VectorType2 &x,
+            int itol, T tol, int itmax, int &iter, T &err, bool minres, std::string &error)
+        {
+            typedef matrix_traits<VectorType> bt;
+            typedef matrix_traits<VectorType2> xt;
+
+            if (itol == 3 || itol == 4) {
+                error = std::string("itol 3 and 4 are not supported in linear_bcg_zq");
+                return false;
+            }
+            if (itol != 1 && itol != 2) {
+                error = std::string("Illegal itol in linear_bcg_zq");
+                return false;
+            }
+            if (minres) {
+                error = std::string("minres is not supported in linear_bcg_zq");
+                return false;
+            }
+            const ZQSparseMatrix<T> A = ZQSparseMatrix<T>::fromRowIndexed(sa, ija);
+            const int n = A.rows();
+            if (bt::size_row(b) != n || xt::size_row(x) != n) {
+                error = std::string("b and x do not match the size of sa and ija");
+                return false;
+            }
+
+            QVector<T> inverse(n), bb(n), xx(n);
+            for (int i = 0; i < n; ++i) {
+                const T d = A.value(i, i);
+                inverse[i] = d != T(0) ? T(1) / d : T(1);
+                bb[i] = bt::element(b, bt::min_row(b) + i, bt::min_column(b));
+                xx[i] = xt::element(x, xt::min_row(x) + i, xt::min_column(x));
+            }
+
+            struct Diagonal {
+                const QVector<T> &inverse;
+                void solve(const T *r, T *z) const
+                {
+                    for (int i = 0; i < inverse.size(); ++i)
+                        z[i] = r[i] * inverse[i];
+                }
+            };
+
+            bool ret;
+            if (itol == 1) {
+                const Diagonal M = {inverse};
+                ret = linear_bicgstab(A, M, bb.constData(), xx.data(), tol, itmax, iter, err, error);
+            }
+            else {
+                const auto scaled = [&A, &inverse, n](const T *v, T *y) {
+                    A.multiply(v, y);
+                    for (int i = 0; i < n; ++i)
+                        y[i] *= inverse[i];
+                };
+                for (int i = 0; i < n; ++i)
+                    bb[i] *= inverse[i];
+                ret = linear_bicgstab(linearOperator<T>(n, scaled), ZQIdentityPreconditioner<T>(n),
+                                      bb.constData(), xx.data(), tol, itmax, iter, err, error);
+            }
+            for (int i = 0; i < n; ++i)
+                xt::element(x, xt::min_row(x) + i, xt::min_column(x)) = xx[i];
+            return ret;
+        }
+
+    }
+
+    /*
+     * Solves A x = b for x[1..n], given b[1..n], where A is held in the
+     * row-indexed arrays sa and ija of sparse_in_zq(). On input x should
+     * be set to an initial guess of the solution (or all zeros); itmax is
+     * the maximum number of iterations and tol the convergence tolerance.
+     * On output x is the improved solution, iter the number of iterations
+     * taken and err the last value of the convergence test.
+     *
+     * itol selects the test: with itol 1 the iteration stops when
+     * |A x - b| / |b| < tol, and with itol 2 when
+     * |D^-1 (A x - b)| / |D^-1 b| < tol, where D is the diagonal of A.
+     * The error estimates of itol 3 and 4 and the minimum residual
+     * variant selected by minres belong to the biconjugate gradient
+     * method this used to run, and are rejected through error. Both
+     * settings run linear_bicgstab() preconditioned by D, which needs no
+     * products with A'. New code should build a ZQSparseMatrix and call
+     * the solvers above directly.
+     */
+    template <int n, int nmax, typename T>
+     inline bool linear_bcg_zq(const ZQOffsetMatrix<1, nmax, 0, 0, T> &sa, const ZQOffsetMatrix<1, nmax, 0, 0, int> &ija,
+        const ZQOffsetMatrix<1, n, 0, 0, T> &b, ZQOffsetMatrix<1, n, 0, 0, T> &x, int itol, T tol, int itmax, int &iter,
+        T &err, bool minres, std::string &error)
+    {
+        return krylov_detail::bcg_row_indexed(sa, ija, b, x, itol, tol, itmax, iter, err, minres, error);
+    }
+
+    // As above, leaving x alone and returning the solution in xx.
+    template <int n, int nmax, typename T>
+     inline bool linear_bcg_zq(const ZQOffsetMatrix<1, nmax, 0, 0, T> &sa, const ZQOffsetMatrix<1, nmax, 0, 0, int> &ija,
+        const ZQOffsetMatrix<1, n, 0, 0, T> &b, const ZQOffsetMatrix<1, n, 0, 0, T> &x, ZQOffsetMatrix<1, n, 0, 0, T> &xx,
+        int itol, T tol, int itmax, int &iter, T &err, bool minres, std::string &error)
+    {
+        xx = x;
+        return linear_bcg_zq(sa, ija, b, xx, itol, tol, itmax, iter, err, minres, error);
+    }
+
+    // linear_bcg_zq() for sa, ija, b and x of any matrix types.
+    template <typename MatrixType, typename MatrixType2, typename MatrixType3, typename T>
+     inline bool linear_bcg(const MatrixType2 &sa, const MatrixType3 &ija,
+        const MatrixType &b, const MatrixType &x, MatrixType &xx,
+        int itol, T tol, int itmax, int &iter, T &err, bool minres, std::string &error)
+    {
+        if (matrix_traits<MatrixType2>::size_row(sa) != matrix_traits<MatrixType3>::size_row(ija)) {
+            error = std::string("sa and ija do not have the same row size");
+            return false;
+        }
+        xx = x;
+        return krylov_detail::bcg_row_indexed(sa, ija, b, xx, itol, tol, itmax, iter, err, minres, error);
+    }
+
+}
+
+#endif
@@ -6,6 +6,7 @@
 
 #define _USE_MATH_DEFINES
 #include <tgmath.h>
+#include <cmath>
 #include <cassert>
 
 #include <string>
@@ -15,6 +16,10 @@
 
 namespace z_linalg {
 
+    // The unqualified abs() calls below must find the floating point
+    // overloads rather than the C library's int version.
+    using std::abs;
+
     template <typename T>
      inline void swap2(T& a, T& b)
     {
@@ -27,7 +32,7 @@ namespace z_linalg {
     // numbers that are close by a difference of exactly eps are considered unequal.
     // Don't set eps to zero.
     template <typename T>
-     inline bool fuzzy_equal(T& a, T& b, T eps = 1e-20)
+     inline bool fuzzy_equal(const T& a, const T& b, T eps = 1e-20)
     {
         if (abs(abs(a)-abs(b)) < eps) {
             return true;
@@ -41,11 +46,12 @@ namespace z_linalg {
      * Indexes an array arr[1..n] i.e. outputs the array indx[1..n] such that arr[indx[j]] is in ascending
      * order for j = 1, 2, ..., N. The input arr is not changed.
      */
-    template <int n, typename T>
-     inline bool index_ascend_zq(const ZQOffsetMatrix<1, n, 0, 0, T> &arr, ZQOffsetMatrix<1, n, 0, 0, int> &indx,
-        std::string &error)
+    template <typename VectorType, typename IndexVector>
+     inline bool index_ascend_zq(const VectorType &arr, IndexVector &indx, std::string &error)
     {
-        int i, indxt, ir=n, itemp, j, k, l=1;
+        typedef typename matrix_traits<VectorType>::value_type T;
+        const int n = matrix_traits<IndexVector>::size_row(indx);
+        int i, indxt, ir=n, j, k, l=1;
         int jstack=0;
         T a;
         const int M=7, NSTACK=50;
@@ -55,17 +61,17 @@ namespace z_linalg {
             indx(j, 0) = j;
         }
         for (;;) {
-            if (ir-1 < M) {
+            if (ir-l < M) {
                 for (j=l+1; j<=ir; j++) {
                     indxt=indx(j,0);
                     a = arr(indxt, 0);
-                    for (i=j-1; i>=1; i--) {
+                    for (i=j-1; i>=l; i--) {
                         if (arr(indx(i,0),0) <= a) {
                             break;
                         }
                         indx(i+1, 0) = indx(i,0);
                     }
-                    indx(i+1) = indxt;
+                    indx(i+1, 0) = indxt;
                 }
                 if (jstack == 0) {
                     break;
@@ -78,35 +84,35 @@ namespace z_linalg {
             else {
                 k = (l+ir) >> 1;
                 swap2(indx(k,0), indx(l+1, 0));
-                if (arr(indx(l, 0)) > arr(indx(ir, 0))) {
-                    swap2(indx(l), indx(ir));
+                if (arr(indx(l, 0), 0) > arr(indx(ir, 0), 0)) {
+                    swap2(indx(l, 0), indx(ir, 0));
                 }
-                if (arr(indx(l+1, 0)) > arr(indx(ir, 0))) {
-                    swap2(indx(l+1, 0), indx(ir));
+                if (arr(indx(l+1, 0), 0) > arr(indx(ir, 0), 0)) {
+                    swap2(indx(l+1, 0), indx(ir, 0));
                 }
-                if (arr(indx(l+1, 0)) > arr(indx(l, 0))) {
-                    swap2(indx(l+1, 0), indx(l));
+                if (arr(indx(l, 0), 0) > arr(indx(l+1, 0), 0)) {
+                    swap2(indx(l, 0), indx(l+1, 0));
                 }
                 i = l+1;
                 j=ir;
                 indxt = indx(l+1, 0);
                 a = arr(indxt, 0);
                 for (;;) {
-                    do i++; while (arr(indx(i,0)) < a);
-                    do j--; while (arr(indx(j,0)) > a);
+                    do i++; while (arr(indx(i,0), 0) < a);
+                    do j--; while (arr(indx(j,0), 0) > a);
                     if (j < i) {
                         break;
                     }
                     swap2(indx(i,0), indx(j,0));
                 }
-                indx(l+1, 0) = indx(j);
-                indx(j) = indxt;
+                indx(l+1, 0) = indx(j, 0);
+                indx(j, 0) = indxt;
                 jstack += 2;
                 if (jstack > NSTACK) {
                     error = std::string("NSTACK too small");
                     return false;
                 }
-                if ((ir-i+1) >= j-1) {
+                if ((ir-i+1) >= j-l) {
                     istack(jstack, 0) = ir;
                     istack(jstack-1, 0) = i;
                     ir = j-1;
@@ -118,6 +124,7 @@ namespace z_linalg {
                 }
             }
         }
+        return true;
     }
 
     /*
@@ -168,13 +175,29 @@ namespace z_linalg {
      * Linear Algebra Routines *
      ***************************/
 
-    template<int n, int m, typename T>
-     inline bool transpose_zq(ZQOffsetMatrix<1, n, 1, m, T> &A, ZQOffsetMatrix<1, m, 1, n, T> &B, std::string &error)
+    /*
+     * The _zq routines index their arguments from 1 like the Numerical Recipes
+     * code they come from: matrices as a[1..n][1..n] and vectors as v[1..n][0..0].
+     * Most take fixed size ZQOffsetMatrix arguments. The LU, Cholesky, QR and
+     * SVD routines take any matrix type with a matrix_traits specialisation and
+     * read the sizes from it at run time, so a ZQDynMatrix numbered from 1 can
+     * be passed straight in when the system is too large for the stack.
+     */
+
+    template<typename MatrixType, typename MatrixType2>
+     inline bool transpose_zq(const MatrixType &A, MatrixType2 &B, std::string &error)
     {
+        const int n = matrix_traits<MatrixType>::size_row(A);
+        const int m = matrix_traits<MatrixType>::size_column(A);
         int i, j;
+
+        if (matrix_traits<MatrixType2>::size_row(B) != m || matrix_traits<MatrixType2>::size_column(B) != n) {
+            error = std::string("B is not the size of A transposed");
+            return false;
+        }
         for (i=1; i<=n; i++) {
-            for (j=1; j<=n; j++) {
-                B(i,j) = A(j,i);
+            for (j=1; j<=m; j++) {
+                B(j,i) = A(i,j);
             }
         }
 
@@ -185,12 +208,15 @@ namespace z_linalg {
     // Given the matrix A, coefficient vector B and the the linear algebra equation A * [X <=> Y] = [B <=> I],
     // Replaces A with A's inverse Y and the coefficient vector B with the solution vector X.
     // This is the recommended function to solve a set of equations because it will always work, at the cost of speed.
-    template<int n, int m, typename T>
-     inline bool gauss_jordan_zq(ZQOffsetMatrix<1, n, 1, n, T> &A, ZQOffsetMatrix<1, n, 1, m, T> &B, std::string &error)
+    template<typename MatrixType, typename MatrixType2>
+     inline bool gauss_jordan_zq(MatrixType &A, MatrixType2 &B, std::string &error)
     {
-        ZQOffsetMatrix<1, n, 0, 0, int> indxc, indxr, ipiv;
-        int i, icol, irow, j, k, l, ll;
-        T big, dum, pivinv, temp;
+        typedef typename matrix_traits<MatrixType>::value_type T;
+        const int n = matrix_traits<MatrixType>::size_row(A);
+        const int m = matrix_traits<MatrixType2>::size_column(B);
+        ZQDynMatrix<int> indxc(n, 1, 1, 0), indxr(n, 1, 1, 0), ipiv(n, 1, 1, 0);
+        int i, icol = 1, irow = 1, j, k, l, ll;
+        T big, dum, pivinv;
 
         for (j = 1; j <= n; j++) {
             ipiv(j,0) = 0;
@@ -214,58 +240,58 @@ namespace z_linalg {
                         }
                     }
                 }
-                ipiv(icol,0) += 1;
+            }
+            ipiv(icol,0) += 1;
 
-                /*
-                 * We now have a pivot element, so we interchange rows, if needed,
-                 * to put the pivot element on the diagonal. The columns are not physically
-                 * interchanged, only relabled: indxc(i), the column of the ith pivot element,
-                 * is the ith column that is reduced, while indxr(i) is the row in which that
-                 * pivot element was originally located. If indxr(i) != indxc(i) there is an implied
-                 * column interchange. With this form of bookkeeping, the solution b's will end up in
-                 * the correct order, and the inverse matrix will be scrambled by columns.
-                 */
-                if (irow != icol) {
-                   for (l = 1; l <= n; l++) {
-                       swap2(A(irow, l), A(icol, l));
-                   }
-                   for (l = 1; l <= m; l++) {
-                       swap2(B(irow, l), B(icol, l));
-                   }
-                }
-                indxr(i, 0) = irow;
-                indxc(i, 0) = icol;
-                
-                /*
-                 * We are now ready to divide the pivot row by the pivot element, located at
-                 * irow and icol.
-                 */
-                if (A(icol, icol) == 0.0) {
-                    error = std::string("Singular Matrix AA(icol, icol) == 0.0");
-                    return false;
-                }
-                pivinv = 1.0/A(icol, icol);
-                A(icol, icol) = 1.0;
-                for (l = 1; l <= n; l++) {
-                    A(icol, l) *= pivinv;
-                }
-                for (l = 1; l <= m; l++) {
-                    B(icol, l) *= pivinv;
-                }
+            /*
+             * We now have a pivot element, so we interchange rows, if needed,
+             * to put the pivot element on the diagonal. The columns are not physically
+             * interchanged, only relabled: indxc(i), the column of the ith pivot element,
+             * is the ith column that is reduced, while indxr(i) is the row in which that
+             * pivot element was originally located. If indxr(i) != indxc(i) there is an implied
+             * column interchange. With this form of bookkeeping, the solution b's will end up in
+             * the correct order, and the inverse matrix will be scrambled by columns.
+             */
+            if (irow != icol) {
+               for (l = 1; l <= n; l++) {
+                   swap2(A(irow, l), A(icol, l));
+               }
+               for (l = 1; l <= m; l++) {
+                   swap2(B(irow, l), B(icol, l));
+               }
+            }
+            indxr(i, 0) = irow;
+            indxc(i, 0) = icol;
+            
+            /*
+             * We are now ready to divide the pivot row by the pivot element, located at
+             * irow and icol.
+             */
+            if (A(icol, icol) == 0.0) {
+                error = std::string("Singular Matrix AA(icol, icol) == 0.0");
+                return false;
+            }
+            pivinv = 1.0/A(icol, icol);
+            A(icol, icol) = 1.0;
+            for (l = 1; l <= n; l++) {
+                A(icol, l) *= pivinv;
+            }
+            for (l = 1; l <= m; l++) {
+                B(icol, l) *= pivinv;
+            }
 
-                /*
-                 * Next, we reduce the rows, except for the pivot one, of course.
-                 */
-                for (ll = 1; ll <= n; ll++) {
-                    if (ll != icol) {
-                        dum = A(l, icol);
-                        A(ll, icol) = 0.0;
-                        for (l = 1; l <= n; l++) {
-                            A(ll,l) -= A(icol, l)*dum;
-                        }
-                        for (l = 1; l <= m; l++) {
-                            B(ll,l) -= B(icol, l)*dum;
-                        }
+            /*
+             * Next, we reduce the rows, except for the pivot one, of course.
+             */
+            for (ll = 1; ll <= n; ll++) {
+                if (ll != icol) {
+                    dum = A(ll, icol);
+                    A(ll, icol) = 0.0;
+                    for (l = 1; l <= n; l++) {
+                        A(ll,l) -= A(icol, l)*dum;
+                    }
+                    for (l = 1; l <= m; l++) {
+                        B(ll,l) -= B(icol, l)*dum;
                     }
                 }
             }
@@ -277,7 +303,7 @@ namespace z_linalg {
          * pairs of columns in the reverse order that the permutation was built up.
          */
         for (l = n; l >= 1; l--) {
-            if (indxr(l, 0 != indxc(l, 0))) {
+            if (indxr(l, 0) != indxc(l, 0)) {
                 for (k = 1; k <= n; k++) {
                     swap2(A(k, indxr(l,0)), A(k, indxc(l,0)));
                 }
@@ -292,15 +318,16 @@ namespace z_linalg {
      * d will be -1 if there were an odd number of interchanges, or 1 if there were
      * an even number of iterations.
      */
-    template<int n, typename T>
-     inline bool lu_decomp_zq(ZQOffsetMatrix<1, n, 1, n, T> &A, ZQOffsetMatrix<1, n, 0, 0, int> &indx, T &d, std::string &error)
+    template<typename MatrixType, typename IndexVector, typename T>
+     inline bool lu_decomp_zq(MatrixType &A, IndexVector &indx, T &d, std::string &error)
     {
         const T TINY = 1.0e-20;
-        int i, imax, j, k;
+        const int n = matrix_traits<MatrixType>::size_row(A);
+        int i, imax = 1, j, k;
         T big, dum, sum, temp;
 
         // vv stores the implicit scaling of each row.
-        ZQOffsetMatrix<1, n, 0, 0, T> vv;
+        ZQDynMatrix<T> vv(n, 1, 1, 0);
         
         // No row interchanges yet.
         d = 1.0;
@@ -309,7 +336,7 @@ namespace z_linalg {
         for (i = 1; i <= n; i++) {
             big = 0.0;
             for (j = 1; j <= n; j++) {
-                temp = abs(A[i][j]);
+                temp = abs(A(i,j));
                 if (temp > big) {
                     big = temp;
                 }
@@ -388,9 +415,11 @@ namespace z_linalg {
      * the same except for the B parameter which will be the result of B from the
      * last call to lu_backsub_zq.
      */
-    template<int n, typename T>
-     inline bool lu_backsub_zq(const ZQOffsetMatrix<1, n, 1, n, T> &A, const ZQOffsetMatrix<1, n, 0, 0, int> &indx, ZQOffsetMatrix<1, n, 0, 0, T> B, std::string &error)
+    template<typename MatrixType, typename IndexVector, typename VectorType>
+     inline bool lu_backsub_zq(const MatrixType &A, const IndexVector &indx, VectorType &B, std::string &error)
     {
+        typedef typename matrix_traits<MatrixType>::value_type T;
+        const int n = matrix_traits<MatrixType>::size_row(A);
         int i, ii = 0, ip, j;
         T sum;
         
@@ -436,14 +465,23 @@ namespace z_linalg {
     /*
      * Returns the inverse of A in Y.
      */
-    template<int n, typename T>
-     inline bool inverse_zq(const ZQOffsetMatrix<1, n, 1, n, T> &A, const ZQOffsetMatrix<1, n, 1, n, T> &Y, std::string &error)
+    template<typename MatrixType, typename MatrixType2>
+     inline bool inverse_zq(const MatrixType &A, MatrixType2 &Y, std::string &error)
     {
-        ZQOffsetMatrix<1, n, 0, 0, T> indx, col;
+        typedef typename matrix_traits<MatrixType>::value_type T;
+        const int n = matrix_traits<MatrixType>::size_row(A);
+        ZQDynMatrix<T> LU(n, n, 1, 1), col(n, 1, 1, 0);
+        ZQDynMatrix<int> indx(n, 1, 1, 0);
         T d;
         int i, j;
+
+        for (j = 1; j <= n; j++) {
+            for (i = 1; i <= n; i++) {
+                LU(i, j) = A(i, j);
+            }
+        }
         
-        bool success = lu_decomp_zq(A, indx, &d, error);
+        bool success = lu_decomp_zq(LU, indx, d, error);
         if (!success) {
             return false;
         }
@@ -453,7 +491,7 @@ namespace z_linalg {
                 col(i, 0) = 0.0;
             }
             col(j, 0) = 1.0;
-            success = lu_backsub_zq(A, indx, col, error);
+            success = lu_backsub_zq(LU, indx, col, error);
             if (!success) {
                 return false;
             }
@@ -465,15 +503,22 @@ namespace z_linalg {
         return true;
     }
 
-    template<int n, typename T>
-     inline bool determinant_zq(const ZQOffsetMatrix<1, n, 1, n, T> &A, T &x, std::string &error)
+    template<typename MatrixType, typename T>
+     inline bool determinant_zq(const MatrixType &A, T &x, std::string &error)
     {
-        ZQOffsetMatrix<1, n, 0, 0, int> indx;
+        const int n = matrix_traits<MatrixType>::size_row(A);
+        ZQDynMatrix<T> B(n, n, 1, 1);
+        ZQDynMatrix<int> indx(n, 1, 1, 0);
         T d;
-        int j;
-        ZQOffsetMatrix<1, n, 1, n, T> B = A;
+        int i, j;
 
-        bool success = lu_decomp_zq(A, B, indx, x, error);
+        for (j = 1; j <= n; j++) {
+            for (i = 1; i <= n; i++) {
+                B(i, j) = A(i, j);
+            }
+        }
+
+        bool success = lu_decomp_zq(B, indx, d, error);
         if (!success) {
             // The determinant of a singular matrix is 0.
             x = 0.0;
@@ -492,14 +537,15 @@ namespace z_linalg {
      * A[1..n], B[1..n] and C[1..n], B being the lead diagonal, A is below it, and C is above it.
      * R[1..n] is the right-hand side.
      */
-    template<int n, typename T>
-     inline bool tridiag_solve_zq(const ZQOffsetMatrix<1, n, 0, 0, T> &A, const ZQOffsetMatrix<1, n, 0, 0, T> &B,
-        const ZQOffsetMatrix<1, n, 0, 0, T> &C, const ZQOffsetMatrix<1, n, 0, 0, T> &R, ZQOffsetMatrix<1, n, 0, 0, T> &U,
-        std::string &error)
+    template<typename VectorType>
+     inline bool tridiag_solve_zq(const VectorType &A, const VectorType &B, const VectorType &C, const VectorType &R,
+        VectorType &U, std::string &error)
     {
+        typedef typename matrix_traits<VectorType>::value_type T;
+        const int n = matrix_traits<VectorType>::size_row(A);
         int j;
         T bet;
-        ZQOffsetMatrix<1, n, 0, 0, T> gam;
+        ZQDynMatrix<T> gam(n, 1, 1, 0);
 
         if (B(1,0) == 0.0) {
             /*
@@ -713,15 +759,17 @@ namespace z_linalg {
      * corresponding U column is not part of the orthonormal basis vectors, and should be deleted from the output. Usually
      * this happens when the columns of A representing a vector space do not actually span N dimensions.
      */
-    template<int n, int m, typename T>
-     inline bool svd_decomp_zq(ZQOffsetMatrix<1, m, 1, n, T> &A, ZQOffsetMatrix<1, n, 0, 0, T> &W,
-        ZQOffsetMatrix<1, n, 1, n, T> &V, std::string &error)
+    template<typename MatrixType, typename VectorType, typename MatrixType2>
+     inline bool svd_decomp_zq(MatrixType &A, VectorType &W, MatrixType2 &V, std::string &error)
     {
-        int flag, i, its, j, jj, k, l, nm;
+        typedef typename matrix_traits<MatrixType>::value_type T;
+        const int m = matrix_traits<MatrixType>::size_row(A);
+        const int n = matrix_traits<MatrixType>::size_column(A);
+        int flag, i, its, j, jj, k, l = 1, nm = 1;
         T anorm, c, f, g, h, s, scale, x, y, z;
-        ZQOffsetMatrix<1, n, 0, 0, T> rv1;
+        ZQDynMatrix<T> rv1(n, 1, 1, 0);
 
-        // Householder reduction to diagonal form.
+        // Householder reduction to bidiagonal form.
         g = scale = anorm = 0.0;
         for (i=1; i<=n; i++) {
             l=i+1;
@@ -734,12 +782,13 @@ namespace z_linalg {
                 if (scale) {
                     for (k=i; k<=m; k++) {
                         A(k,i) /= scale;
-                        s += A(k,i) * A(k,j);
+                        s += A(k,i) * A(k,i);
                     }
-                    f = A(i,j);
+                    f = A(i,i);
                     g = -sign(sqrt(s), f);
                     h = f*g - s;
-                    for (j=1; j<=n; j++) {
+                    A(i,i) = f-g;
+                    for (j=l; j<=n; j++) {
                         for (s=0.0, k=i; k<=m; k++) {
                             s += A(k, i) * A(k, j);
                         }
@@ -769,7 +818,7 @@ namespace z_linalg {
                     h = f*g - s;
                     A(i,l) = f-g;
                     for (k=l; k<=n; k++) {
-                        s += A(j,k) * A(i,k);
+                        rv1(k,0) = A(i,k)/h;
                     }
                     for (j=l; j<=m; j++) {
                         for (s=0.0,k=l; k<=n; k++) {
@@ -784,7 +833,7 @@ namespace z_linalg {
                     }
                 }
             }
-            anorm = max(anorm, abs(W(i,0)) + abs(rv1(i,0)));
+            anorm = max(anorm, T(abs(W(i,0)) + abs(rv1(i,0))));
         }
 
         // Accumulation of right-hand transformations
@@ -800,11 +849,11 @@ namespace z_linalg {
                             s += A(i,k) * V(k,j);
                         }
                         for (k=l; k<=n; k++) {
-                            V(k,j) += s*V(k,j);
+                            V(k,j) += s*V(k,i);
                         }
                     }
                 }
-                for (j=1; j<=n; j++) {
+                for (j=l; j<=n; j++) {
                     V(i,j) = V(j,i) = 0.0;
                 }
             }
@@ -832,7 +881,7 @@ namespace z_linalg {
                     }
                 }
                 for (j=i; j<=m; j++) {
-                    A(j,i) = 0.0;
+                    A(j,i) *= g;
                 }
             }
             else {
@@ -854,11 +903,11 @@ namespace z_linalg {
                 // Test for splitting. Note that rv1[1] is always zero.
                 for (l=k; l>=1; l--) {
                     nm = l-1;
-                    if (abs(rv1(l,0) + anorm) == anorm) {
+                    if (abs(rv1(l,0)) + anorm == anorm) {
                         flag = 0;
                         break;
                     }
-                    if (abs(W(nm,0) + anorm) == anorm) {
+                    if (abs(W(nm,0)) + anorm == anorm) {
                         break;
                     }
                 }
@@ -910,7 +959,7 @@ namespace z_linalg {
                 g = rv1(nm,0);
                 h = rv1(k, 0);
                 f = ((y-z) * (y+z) + (g-h) * (g+h)) / (2.0*h*y);
-                g = hypot(f, 1.0);
+                g = hypot(f, T(1.0));
                 f = ((x-z) * (x+z) + h * ((y/(f + sign(g, f))) - h))/x;
 
                 // Next QR transformation:
@@ -955,7 +1004,7 @@ namespace z_linalg {
                 }
                 rv1(l,0) = 0.0;
                 rv1(k,0) = f;
-                W(k) = x;
+                W(k,0) = x;
             }
         }
         return true;
@@ -970,14 +1019,16 @@ namespace z_linalg {
      * prefered error tolerance. This function will not do it for you. If you don't do this then this function will
      * be completely ineffective.
      */
-    template<int n, int m, typename T>
-     inline bool svd_backsub_zq(const ZQOffsetMatrix<1, m, 1, n, T> &U, const ZQOffsetMatrix<1, n, 0, 0, T> &W,
-        const ZQOffsetMatrix<1, n, 1, n, T> &V, const ZQOffsetMatrix<1, n, 1, n, T> &B,
-        ZQOffsetMatrix<1, n, 1, n, T> &X, std::string &error)
+    template<typename MatrixType, typename VectorType, typename MatrixType2, typename VectorType2, typename VectorType3>
+     inline bool svd_backsub_zq(const MatrixType &U, const VectorType &W, const MatrixType2 &V,
+        const VectorType2 &B, VectorType3 &X, std::string &error)
     {
+        typedef typename matrix_traits<MatrixType>::value_type T;
+        const int m = matrix_traits<MatrixType>::size_row(U);
+        const int n = matrix_traits<MatrixType>::size_column(U);
         int jj, j, i;
         T s;
-        ZQOffsetMatrix<1, n, 0, 0, T> tmp;
+        ZQDynMatrix<T> tmp(n, 1, 1, 0);
 
         // Calculate U′B.
         for (j=1; j<=n; j++) {
@@ -999,10 +1050,11 @@ namespace z_linalg {
         for (j=1; j<=n; j++) {
             s=0.0;
             for (jj=1; jj<=n; jj++) {
-                s += V(j,jj) * tmp(jj);
+                s += V(j,jj) * tmp(jj,0);
             }
             X(j,0) = s;
         }
+        return true;
     }
 
     /*
@@ -1082,6 +1134,10 @@ namespace z_linalg {
      * k   1 2 3 4  5  6   7 8 9 10 11
      * sa  7 8 8 10 11 12  3 2 4 5  4
      * ija 3 4 5 0  5  N/A 1 7 9 2  6
+     *
+     * This needs the whole dense matrix and fixed size arrays. Large sparse matrices should be
+     * built with ZQSparseMatrix::setFromTriplets() instead, and existing sa/ija arrays can be
+     * converted with ZQSparseMatrix::fromRowIndexed() (z_sparsematrix.h).
      */
     template<int n, int nmax, typename T>
      inline bool sparse_in_zq(const ZQOffsetMatrix<1, n, 1, n, T> &A, T thresh,
@@ -1282,6 +1338,7 @@ namespace z_linalg {
         
         if (ija(1,0) != ijb(1,0) || ija(1,0) != ijc(1,0)) {
             error = std::string("Sizes do not match");
+            return false;
         }
         
         // Loop over rows.
@@ -1338,11 +1395,12 @@ namespace z_linalg {
                 if (mn >= ijc(i+1, 0)) {
                     break;
                 }
-                j = ijc(mn);
                 m = mn;
-                m++;
+                j = ijc(m, 0);
+                mn++;
             }
         }
+        return true;
     }
 
     /*
@@ -1434,191 +1492,10 @@ namespace z_linalg {
         }
     }
 
-    /* The following three functions are internal routines. */
-    template<int n, int nmax, typename T>
-     inline bool atimes(const ZQOffsetMatrix<1, nmax, 0, 0, T> &sa, const ZQOffsetMatrix<1, nmax, 0, 0, int> &ija,
-        ZQOffsetMatrix<1, n, 0, 0, T> &X, ZQOffsetMatrix<1, n, 0, 0, T> &R, int transpose)
-    {
-        std::string error;
-        if (transpose) {
-            sparse_mmul_transp_zq(sa, ija, X, R, error);
-        }
-        else {
-            sparse_mmul_zq(sa, ija, X, R, error);
-        }
-        return true;
-    }
-
-    template<int n, int nmax, typename T>
-     inline bool asolve(const ZQOffsetMatrix<1, nmax, 0, 0, T> &sa, const ZQOffsetMatrix<1, nmax, 0, 0, int> &ija,
-        ZQOffsetMatrix<1, n, 0, 0, T> &B, ZQOffsetMatrix<1, n, 0, 0, T> &X, int transpose)
-    {
-        std::string error;
-        for (int i = 1; i <= n; i++) {
-            if (sa(i,0) != 0.0) {
-                X(i, 0) = B(i,0)/sa(i,0);
-            }
-            else {
-                X(i, 0) = B(i,0);
-            }
-        }
-        return true;
-    }
-
-    // TODO factor these out in separate functions. I don't want to separate them
-    // right now lest I break the function that calls it.
-    template<int n, typename T>
-     inline T snrm(const ZQOffsetMatrix<1, n, 0, 0, T> &SX, int itol)
-    {
-        int i, isamax;
-        T ans;
-        
-        if (itol <= 3) {
-            /* Vector magnitude (L2) norm */
-            ans = 0.0;
-            for (i=1; i<n; i++) {
-                ans += SX(i,0)*SX(i,0);
-            }
-            return sqrt(ans);
-        }
-        else {
-            /* Largest component (L∞) norm */
-            isamax=1;
-            for (i=1; i<=n; i++) {
-                if (abs(SX(i,0)) > abs(SX(isamax,0))) {
-                    isamax=i;
-                }
-            }
-            return abs(SX(isamax,0));
-        }
-    }
-
-    /* Solves A·x=b for x[1..n], given b[1..n], by the iterative biconjugate gradient method. On input x[1..n] should be set to an
-     * initial guess of the solution (or all zeros); itol is 1,2,3,or 4, specifying which convergence test is applied (see below);
-     * itmax is the maximum number of allowed iterations; and tol is the desired convergence tolerance. On output, x[1..n] is reset
-     * to the improved solution, iter is the number of iterations actually taken, minres is a boolean indicating whether to use the
-     * minimum residual version of the algorithm, and err is the estimated error. The matrix A is referenced only through the
-     * user-supplied routines atimes, which computes the product of either A or its transpose on a vector; and asolve, which solves
-     * ̃A·x=b or ̃AT·x=b for some preconditioner matrix ̃A (possibly the trivial diagonal part of A).
-     * What constitutes “good” convergence is rather application dependent. The routine linear_bcg_zq therefore provides for four
-     * possibilities, selected by setting the flag itol on input. If itol=1, iteration stops when the quantity |A·x−b|/|b| is less
-     * than the input quantity tol. If itol=2, the required criterion is | ̃A−1·(A·x−b)|/| ̃A−1·b| < tol
-     * If itol=3, the routine uses its own estimate of the error in x, and requires its magnitude, divided by the magnitude of x,
-     * to be less thantol. The setting itol=4 is the same as itol=3, except that the largest (in absolute value) component of the
-     * error and largest component of x are used instead of the vector magnitude (that is, the L∞ norm instead of the L2 norm).
-     * You may need to experiment to find which of these convergence criteria is best for your problem.
+    /*
+     * linear_bcg_zq(), which solves A·x=b for A held in the row-indexed arrays sa and ija, is in z_krylov.h
+     * with the other iterative solvers.
      */
-    template<int n, int nmax, typename T>
-     inline bool linear_bcg_zq(const ZQOffsetMatrix<1, nmax, 0, 0, T> &sa, const ZQOffsetMatrix<1, nmax, 0, 0, int> &ija,
-        const ZQOffsetMatrix<1, n, 0, 0, T> &b, ZQOffsetMatrix<1, n, 0, 0, T> &x, int itol, T tol, int itmax, int &iter,
-        T &err, bool minres, std::string &error)
-    {
-        int j;
-        T eps = 1.0e-14;
-        T ak, akden, bk, bkden, bknum, bnrm, dxnrm, xnrm, zm1nrm, znrm;
-        ZQOffsetMatrix<1, n, 0, 0, T> p, pp, r, rr, z, zz;
-
-        /* Calculate initial residual. */
-        iter = 0;
-        atimes(sa, ija, x, r, 0);
-        for (j=1; j<=n; j++) {
-            r(j,0) = b(j,0) - r(j,0);
-            rr(j,0) = r(j);
-        }
-        if (minres) {
-            atimes(sa, ija, r, rr, 0);
-        }
-        if (itol == 1) {
-            bnrm = snrm(b, itol);
-            asolve(sa, ija, r, zz, 0);
-        }
-        else if (itol == 2) {
-            asolve(sa, ija, b, z, 0);
-            bnrm = snrm(z, itol);
-            asolve(sa, ija, r, z, 0);
-        }
-        else if (itol == 3 || itol == 4) {
-            asolve(sa, ija, b, z, 0);
-            bnrm = snrm(z, itol);
-            asolve (sa, ija, r, z, 0);
-            znrm = snrm(z, itol);
-        }
-        else {
-            error = std::string("Illegal itol in linear_bcg_zq");
-            return false;
-        }
-        
-        while (iter <= itmax) {
-            ++iter;
-            asolve(sa, ija, rr, zz, 1);
-            for (bknum = 0.0, j=1; j<=n; j++) {
-                bknum += z(j,0)*rr(j,0);
-            }
-
-            /* Calculate coefficient bk and direction vectors p and pp. */
-            if (iter == 1) {
-                for (j = 1; j<=n; j++) {
-                    p(j,0) = z(j,0);
-                    pp(j,0) = zz(j,0);
-                }
-            }
-            else {
-                bk = bknum/bkden;
-                for (j=1; j<=n; j++) {
-                    p(j,0) = bk*p(j,0) + z(j,0);
-                    pp(j,0) = bk*pp(j,0) + zz(j,0);
-                }
-            }
-            /* Calculate coefficient ak, new iterate x, and new residuals r and rr. */
-            bkden = bknum;
-            atimes(sa, ija, p, z, 0);
-            for (akden=0.0, j=1; j<=n; j++) {
-                akden += z(j,0) * pp(j,0);
-            }
-            ak = bknum/akden;
-            atimes(sa, ija, pp, zz, 1);
-            for (j=1; j<=n; j++) {
-                x(j,0) += ak*p(j,0);
-                r(j,0) -= ak*z(j,0);
-                rr(j,0) -= ak-zz(j,0);
-            }
-
-            /* Solve ̃A·z=r and check stopping criterion. */
-            asolve(sa, ija, r, z, 0);
-            if (itol == 1) {
-                err=snrm(r, itol)/bnrm;
-            }
-            else if (itol == 2) {
-                err=snrm(z, itol)/bnrm;
-            }
-            else if (itol == 3 || itol == 4) {
-                zm1nrm = znrm;
-                znrm = snrm(z, itol);
-                if (abs(zm1nrm-znrm) > eps*znrm) {
-                    dxnrm = abs(zm1nrm-znrm)*dxnrm;
-                }
-                else {
-                    // Error may not be accurate, so loop again.
-                    err = znrm/bnrm;
-                    continue;
-                }
-                xnrm = snrm(x, itol);
-                if (err < 0.5*xnrm) {
-                    err/=xnrm;
-                }
-                else {
-                    // Error may not be accurate, so loop again.
-                    err = znrm/bnrm;
-                    continue;
-                }
-            }
-            //TODO collect error and tol data into an array
-            if (err < tol) {
-                break;
-            }
-        }
-        return true;
-    }
 
     /*
      * Solves the Vandermonde linear system ∑N_i = 1x^k−1_i w_i = q_k (k=1,...,N). Input consists of the vectors
@@ -1748,9 +1625,11 @@ namespace z_linalg {
      * lower triangle of a, except for its diagonal elements which are returned in p[1..n].
      * It can be used to test whether a matrix is positive definite by indicating failure of Cholesky decomposition.
      */
-    template<int n, typename T>
-     inline bool chol_decomp_zq(ZQOffsetMatrix<1, n, 1, n, T> &a, ZQOffsetMatrix<1, n, 0, 0, T> &p, std::string &error)
+    template<typename MatrixType, typename VectorType>
+     inline bool chol_decomp_zq(MatrixType &a, VectorType &p, std::string &error)
     {
+        typedef typename matrix_traits<MatrixType>::value_type T;
+        const int n = matrix_traits<MatrixType>::size_row(a);
         int i, j, k;
         T sum;
 
@@ -1782,10 +1661,12 @@ namespace z_linalg {
      * returned in x[1..n]. a, n, and p are not modified and can be left in place for successive calls with
      * different right-hand sides b. bis not modified unless you identify b and x in the calling sequence, which is allowed.
      */
-    template<int n, typename T>
-     inline bool chol_solve_zq(const ZQOffsetMatrix<1, n, 1, n, T> &a, const ZQOffsetMatrix<1, n, 0, 0, T> &p,
-        ZQOffsetMatrix<1, n, 0, 0, T> &b, ZQOffsetMatrix<1, n, 0, 0, T> &x, std::string &error)
+    template<typename MatrixType, typename VectorType, typename VectorType2>
+     inline bool chol_solve_zq(const MatrixType &a, const VectorType &p,
+        const VectorType2 &b, VectorType2 &x, std::string &error)
     {
+        typedef typename matrix_traits<MatrixType>::value_type T;
+        const int n = matrix_traits<MatrixType>::size_row(a);
         int i, k;
         T sum;
 
@@ -1812,9 +1693,11 @@ namespace z_linalg {
      * returned from chol_decomp.  a[1..n][1..n] and p[1..n] are input as the output of the routine chol_decomp.
      * The result is stored in the lower triangular part of a.
      */
-    template<int n, typename T>
-     inline bool chol_invert_zq(ZQOffsetMatrix<1, n, 1, n, T> &a, ZQOffsetMatrix<1, n, 0, 0, T> &p, std::string &error)
+    template<typename MatrixType, typename VectorType>
+     inline bool chol_invert_zq(MatrixType &a, const VectorType &p, std::string &error)
     {
+        typedef typename matrix_traits<MatrixType>::value_type T;
+        const int n = matrix_traits<MatrixType>::size_row(a);
         int i, j, k;
         T sum;
 
@@ -1839,10 +1722,12 @@ namespace z_linalg {
      * returns as true (1) if singularity is encountered during the decomposition, but the decomposition is still completed in
      * this case; otherwise it returns false (0).
      */
-    template<int n, typename T>
-     inline bool qr_decomp_zq(ZQOffsetMatrix<1, n, 1, n, T> &a, ZQOffsetMatrix<1, n, 0, 0, T> &c, ZQOffsetMatrix<1, n, 0, 0, T> &d,
+    template<typename MatrixType, typename VectorType>
+     inline bool qr_decomp_zq(MatrixType &a, VectorType &c, VectorType &d,
         int &sing, std::string &error)
     {
+        typedef typename matrix_traits<MatrixType>::value_type T;
+        const int n = matrix_traits<MatrixType>::size_row(a);
         int i, j, k;
         T scale, sigma, sum, tau;
 
@@ -1894,10 +1779,12 @@ namespace z_linalg {
      * d[1..n] are input as the output of the routine qr_decomp_zq and are not modified. b[1..n] is input as the right-hand side
      * vector, and is overwritten with the solution vector on output.
      */
-    template<int n, typename T>
-     inline bool r_solve_zq(const ZQOffsetMatrix<1, n, 1, n, T> &a, const ZQOffsetMatrix<1, n, 0, 0, T> &d,
-        ZQOffsetMatrix<1, n, 0, 0, T> &b, std::string &error)
+    template<typename MatrixType, typename VectorType, typename VectorType2>
+     inline bool r_solve_zq(const MatrixType &a, const VectorType &d,
+        VectorType2 &b, std::string &error)
     {
+        typedef typename matrix_traits<MatrixType>::value_type T;
+        const int n = matrix_traits<MatrixType>::size_row(a);
         int i, j;
         T sum;
 
@@ -1916,10 +1803,12 @@ namespace z_linalg {
      * routine qr_decomp_zq and are not modified. b[1..n] is input as the right-hand side vector, and is overwritten
      * with the solution vector on output.
      */
-    template<int n, typename T>
-     inline bool qr_solve_zq(const ZQOffsetMatrix<1, n, 1, n, T> &a, const ZQOffsetMatrix<1, n, 0, 0, T> &c,
-        const ZQOffsetMatrix<1, n, 0, 0, T> &d, ZQOffsetMatrix<1, n, 0, 0, T> &b, std::string &error)
+    template<typename MatrixType, typename VectorType, typename VectorType2>
+     inline bool qr_solve_zq(const MatrixType &a, const VectorType &c,
+        const VectorType &d, VectorType2 &b, std::string &error)
     {
+        typedef typename matrix_traits<MatrixType>::value_type T;
+        const int n = matrix_traits<MatrixType>::size_row(a);
         int i, j;
         T sum, tau;
         
@@ -1937,15 +1826,13 @@ namespace z_linalg {
     }
 
     /*
-     * Carry out a Jacobi rotation on rows i and i+1 of a matrix r[1..n][1..n].
-     * a and b are the parameters of the rotation: cosθ=a/√(a2+b2),sinθ=b/√(a2+b2)
+     * Computes c=cosθ and s=sinθ of the Jacobi rotation with parameters a and b:
+     * cosθ=a/√(a2+b2),sinθ=b/√(a2+b2)
      */
-    template<int n, typename T>
-     inline bool jacobi_rotate_zq(ZQOffsetMatrix<1, n, 1, n, T> &r,
-        int i, T a, T b, std::string &error)
+    template<typename T>
+     inline void jacobi_rotation_zq(T a, T b, T &c, T &s)
     {
-        int j;
-        T c, fact, s, w, y;
+        T fact;
 
         if (a == 0.0) {
             // Avoid unnecessary overflow or underflow.
@@ -1962,7 +1849,21 @@ namespace z_linalg {
             s = sign(1.0/sqrt(1.0+fact*fact), b);
             c = fact*s;
         }
+    }
 
+    /*
+     * Carry out a Jacobi rotation on rows i and i+1 of a matrix r[1..n][1..n].
+     * a and b are the parameters of the rotation: cosθ=a/√(a2+b2),sinθ=b/√(a2+b2)
+     * Only columns i..n are rotated, as the rows of an upper Hessenberg r are zero before column i.
+     */
+    template<int n, typename T>
+     inline bool jacobi_rotate_zq(ZQOffsetMatrix<1, n, 1, n, T> &r,
+        int i, T a, T b, std::string &error)
+    {
+        int j;
+        T c, s, w, y;
+
+        jacobi_rotation_zq(a, b, c, s);
         for (j=i; j<=n; j++) {
             // Premultiply r by Jacobi rotation.
             y = r(i,j);
@@ -1981,12 +1882,12 @@ namespace z_linalg {
         int p, int q, std::string &error)
     {
         int i;
-        T c, s, theta, x;
+        T c, s, theta, x, fact;
         T app = a(p,p);
         T aqq = a(q,q);
         T apq = a(p,q);
         T aqp = a(q,p);
-        ZQOffsetMatrix<1, q-p+1, 0, 0, T> vp, vq;
+        ZQDynMatrix<T> vp(q-p+1, 1, 1, 0), vq(q-p+1, 1, 1, 0);
 
         x = ((aqq - app)/(apq*aqp))/2;
         if (x == 0.0) {
@@ -2020,12 +1921,12 @@ namespace z_linalg {
         int p, int q, std::string &error)
     {
         int i;
-        T c, s, theta, x;
+        T c, s, theta, x, fact;
         T app = a(p,p);
         T aqq = a(q,q);
         T apq = a(p,q);
         T aqp = a(q,p);
-        ZQOffsetMatrix<1, q-p+1, 0, 0, T> vt, vb, vl2, vr2;
+        ZQDynMatrix<T> vt(q-p+1, 1, 1, 0), vb(q-p+1, 1, 1, 0), vl2(q-p+1, 1, 1, 0), vr2(q-p+1, 1, 1, 0);
 
         x = ((aqq - app)/(apq*aqp))/2;
         if (x == 0.0) {
@@ -2060,7 +1961,21 @@ namespace z_linalg {
      inline bool jacobi_rotate_2(ZQOffsetMatrix<1, n, 1, n, T> &r, ZQOffsetMatrix<1, n, 1, n, T> &qt,
         int i, T a, T b, std::string &error)
     {
-        return jacobi_rotate_zq(r, i, a, b, error) && jabobi_rotate_zq(qt, i, a, b, error);
+        int j;
+        T c, s, w, y;
+
+        if (!jacobi_rotate_zq(r, i, a, b, error)) {
+            return false;
+        }
+        // Every column of qt is rotated.
+        jacobi_rotation_zq(a, b, c, s);
+        for (j=1; j<=n; j++) {
+            y = qt(i,j);
+            w = qt(i+1, j);
+            qt(i,j) = c*y - s*w;
+            qt(i+1,j) = s*y + c*w;
+        }
+        return true;
     }
 
     template<int n, typename T>
@@ -2084,7 +1999,9 @@ namespace z_linalg {
 
         // Transform R+u⊗v to upper Hessenberg.
         for (i = k-1; i>=1; i--) {
-            jacobi_rotate_2(r, qt, i, u(i,0), -u(i+1, 0), error);
+            if (!jacobi_rotate_2(r, qt, i, u(i,0), -u(i+1, 0), error)) {
+                return false;
+            }
             if (u(i,0) == 0.0) {
                 u(i,0) = abs(u(i+1, 0));
             }
@@ -2096,12 +2013,15 @@ namespace z_linalg {
             }
         }
         for (j=1; j<=n; j++) {
-            r(1,j) += u(1,0) * v(1,j);
+            r(1,j) += u(1,0) * v(j,0);
         }
         for (i=1; i<k; i++) {
             // Transform upper Hessenberg matrix to upper triangular.
-            jacobi_rotate_2(r, qt, i, r(i,i), -r(i+1, i));
+            if (!jacobi_rotate_2(r, qt, i, r(i,i), -r(i+1, i), error)) {
+                return false;
+            }
         }
+        return true;
     }
 
     /*
@@ -2156,12 +2076,12 @@ namespace z_linalg {
                     g = 100.0*abs(a(ip,iq));
                     // After four sweeps, skip the rotation if the off-diagonal element is small.
                     if (i > 4 && fuzzy_equal(abs(d(ip,0) + g), abs(d(ip, 0))) &&
-                     fuzzy_equal(abs(d(iq,0) + g), abs(d(iq, 0))) {
+                     fuzzy_equal(abs(d(iq,0) + g), abs(d(iq, 0)))) {
                         a(ip, iq) = 0.0;
                     }
                     else if (abs(a(ip,iq)) > thresh) {
                         h = d(iq,0) - d(ip,0);
-                        if fuzzy_equal((abs(h) + g, abs(h))) {
+                        if (fuzzy_equal(abs(h) + g, abs(h))) {
                             t = a(ip,iq)/h;     // t=1/(2θ)
                         }
                         else {
@@ -2264,6 +2184,7 @@ namespace z_linalg {
         int i;
         for (i = 1; i <= n; i++) {
             x += abs(w(i,0));
+        }
         norm = x;
         return true;
     }
@@ -2487,7 +2408,7 @@ namespace z_linalg {
      */
     template<int n, typename T>
      inline bool tri_ql_implicit_zq(ZQOffsetMatrix<1, n, 0, 0, T> &d,
-        ZQOffsetMatrix<1, n, 0, 0, T> &e, std::string &error
+        ZQOffsetMatrix<1, n, 0, 0, T> &e, std::string &error)
     {
         int m, l, iter, i, k;
         T s, r, p, g, f, dd, c, b;
@@ -2767,7 +2688,7 @@ namespace z_linalg {
         ZQOffsetMatrix<1, n, 0, 0, T> &wr, ZQOffsetMatrix<1, n, 0, 0, T> &wi, std::string &error)
     {
         int nn, m, l, k, j, its, i, mmin;
-        T z, y, x, w, u, t, s, r, q, p, anorm;
+        T z, y, x, w, v, u, t, s, r, q, p, anorm;
 
         // Compute matrix norm for possible use in locating single small subdiagonal element.
         anorm = 0.0;
@@ -2910,7 +2831,7 @@ namespace z_linalg {
                                 r /= p;
                                 for (j=k; j<=nn; j++) {
                                     // Row modification.
-                                    p = a(k,j) + q*a(k+1,j)
+                                    p = a(k,j) + q*a(k+1,j);
                                     if (k != nn-1) {
                                         p += r*a(k+2,j);
                                         a(k+2,j) -= p*z;
@@ -2942,26 +2863,25 @@ namespace z_linalg {
     // Methods which don't overwrite the matrix parameters
     //
 
-    template<int n, int m, typename T>
-     inline bool gauss_jordan_zq(const ZQOffsetMatrix<1, n, 1, n, T> &A, const ZQOffsetMatrix<1, n, 1, m, T> &B,
-        ZQOffsetMatrix<1, n, 1, n, T> &Y, ZQOffsetMatrix<1, n, 1, m, T> &X, std::string &error)
+    template<typename MatrixType, typename MatrixType2>
+     inline bool gauss_jordan_zq(const MatrixType &A, const MatrixType2 &B, MatrixType &Y, MatrixType2 &X,
+        std::string &error)
     {
         Y = A;
         X = B;
         return gauss_jordan_zq(Y, X, error);
     }
 
-    template<int n, int m, typename T>
-     inline bool lu_decomp_zq(const ZQOffsetMatrix<1, n, 1, n, T> &A, ZQOffsetMatrix<1, n, 1, m, T> &B,
-        ZQOffsetMatrix<1, n, 0, 0, int> &indx, T &d, std::string &error)
+    template<typename MatrixType, typename IndexVector, typename T>
+     inline bool lu_decomp_zq(const MatrixType &A, MatrixType &B, IndexVector &indx, T &d, std::string &error)
     {
         B = A;
         return lu_decomp_zq(B, indx, d, error);
     }
 
-    template<int n, int m, typename T>
-     inline bool lu_backsub_zq(const ZQOffsetMatrix<1, n, 1, n, T> &A, const ZQOffsetMatrix<1, n, 0, 0, int> &indx,
-        const ZQOffsetMatrix<1, n, 1, m, T> &B, ZQOffsetMatrix<1, n, 1, m, T> &X, std::string &error)
+    template<typename MatrixType, typename IndexVector, typename VectorType>
+     inline bool lu_backsub_zq(const MatrixType &A, const IndexVector &indx,
+        const VectorType &B, VectorType &X, std::string &error)
     {
         X = B;
         return lu_backsub_zq(A, indx, X, error);
@@ -2993,9 +2913,9 @@ namespace z_linalg {
         return iter_solve_zq(A, ALUD, indx, B, XX, error);
     }
 
-    template<int n, int m, typename T>
-     inline bool svd_decomp_zq(const ZQOffsetMatrix<1, m, 1, n, T> &A, ZQOffsetMatrix<1, m, 1, n, T> &U,
-        ZQOffsetMatrix<1, n, 0, 0, T> &W, ZQOffsetMatrix<1, n, 1, n, T> &V, std::string &error)
+    template<typename MatrixType, typename VectorType, typename MatrixType2>
+     inline bool svd_decomp_zq(const MatrixType &A, MatrixType &U,
+        VectorType &W, MatrixType2 &V, std::string &error)
     {
         U = A;
         return svd_decomp_zq(U, W, V, error);
@@ -3006,14 +2926,17 @@ namespace z_linalg {
      * The correct usage of the tol parameter is to make a variable of your default tolerance in your own code.
      * 1.0e-6 is a common choice.
      */
-    template<int n, int m, typename T>
-     inline bool svd_backsub_zq(const ZQOffsetMatrix<1, m, 1, n, T> &U, const ZQOffsetMatrix<1, n, 0, 0, T> &W,
-        const ZQOffsetMatrix<1, n, 1, n, T> &V, const ZQOffsetMatrix<1, n, 1, n, T> &B,
-        ZQOffsetMatrix<1, n, 1, n, T> &X, T tol, std::string &error)
+    template<typename MatrixType, typename VectorType, typename MatrixType2, typename VectorType2, typename VectorType3, typename T>
+     inline bool svd_backsub_zq(const MatrixType &U, const VectorType &W, const MatrixType2 &V,
+        const VectorType2 &B, VectorType3 &X, T tol, std::string &error)
     {
+        const int n = matrix_traits<MatrixType>::size_column(U);
         int j;
         T wmax, wmin;
-        ZQOffsetMatrix<1, n, 0, 0, T> WW = W;
+        ZQDynMatrix<T> WW(n, 1, 1, 0);
+        for (j=1; j<=n; j++) {
+            WW(j,0) = W(j,0);
+        }
         
         // This will be the maximum singular value obtained from svd_backsub_zq.
         wmax = 0.0;
@@ -3031,34 +2954,25 @@ namespace z_linalg {
         return svd_backsub_zq(U, WW, V, B, X, error);
     }
 
-    template<int n, int nmax, typename T>
-     inline bool linear_bcg_zq(const ZQOffsetMatrix<1, nmax, 0, 0, T> &sa, const ZQOffsetMatrix<1, nmax, 0, 0, int> &ija,
-        const ZQOffsetMatrix<1, n, 0, 0, T> &b, const ZQOffsetMatrix<1, n, 0, 0, T> &x, ZQOffsetMatrix<1, n, 0, 0, T> &xx,
-        int itol, T tol, int itmax, int &iter, T &err, bool minres, std::string &error)
-    {
-        xx = x;
-        return linear_bcg_zq(sa, ija, b, xx, itol, tol, itmax, err, minres, error);
-    }
-
-    template<int n, typename T>
-     inline bool qr_decomp_zq(const ZQOffsetMatrix<1, n, 1, n, T> &a, ZQOffsetMatrix<1, n, 1, n, T> &aa, ZQOffsetMatrix<1, n, 0, 0, T> &c, ZQOffsetMatrix<1, n, 0, 0, T> &d,
+    template<typename MatrixType, typename VectorType>
+     inline bool qr_decomp_zq(const MatrixType &a, MatrixType &aa, VectorType &c, VectorType &d,
         int &sing, std::string &error)
     {
         aa = a;
         return qr_decomp_zq(aa, c, d, sing, error);
     }
 
-    template<int n, typename T>
-     inline bool r_solve_zq(const ZQOffsetMatrix<1, n, 1, n, T> &a, const ZQOffsetMatrix<1, n, 0, 0, T> &d,
-        const ZQOffsetMatrix<1, n, 0, 0, T> &b, ZQOffsetMatrix<1, n, 0, 0, T> &bb, std::string &error)
+    template<typename MatrixType, typename VectorType, typename VectorType2>
+     inline bool r_solve_zq(const MatrixType &a, const VectorType &d,
+        const VectorType2 &b, VectorType2 &bb, std::string &error)
     {
         bb = b;
         return r_solve_zq(a, d, bb, error);
     }
 
-    template<int n, typename T>
-     inline bool qr_solve_zq(const ZQOffsetMatrix<1, n, 1, n, T> &a, const ZQOffsetMatrix<1, n, 0, 0, T> &c,
-        const ZQOffsetMatrix<1, n, 0, 0, T> &d, const ZQOffsetMatrix<1, n, 0, 0, T> &b, ZQOffsetMatrix<1, n, 0, 0, T> &bb,
+    template<typename MatrixType, typename VectorType, typename VectorType2>
+     inline bool qr_solve_zq(const MatrixType &a, const VectorType &c,
+        const VectorType &d, const VectorType2 &b, VectorType2 &bb,
         std::string &error)
     {
         bb = b;
@@ -3087,30 +3001,69 @@ namespace z_linalg {
     // Wrapper methods using general MatrixType templates.
     // T and all value types should be the same. Different types for these
     // is not supported and will result in undefined compilation errors.
+    // The wrappers work on 1-based ZQDynMatrix copies of their arguments, so
+    // any matrix type with a matrix_traits specialisation can be passed in,
+    // whatever its size and index range.
+
+    /*
+     * Copies A into a ZQDynMatrix whose rows are numbered from 1 and whose
+     * columns are numbered from firstColumn. Vectors are copied with
+     * firstColumn = 0 to get the [1..n][0..0] form used by the _zq routines.
+     */
+    template<typename MatrixType>
+     inline ZQDynMatrix<typename matrix_traits<MatrixType>::value_type> to1N(const MatrixType &A, int firstColumn = 1)
+    {
+        typedef matrix_traits<MatrixType> mt;
+        ZQDynMatrix<typename mt::value_type> B(mt::size_row(A), mt::size_column(A), 1, firstColumn);
+        for (int col = 0; col < mt::size_column(A); ++col)
+            for (int row = 0; row < mt::size_row(A); ++row)
+                B(row+1, col+firstColumn) = mt::element(A, mt::min_row(A)+row, mt::min_column(A)+col);
+        return B;
+    }
+
+    /*
+     * Copies the result of a _zq routine back into A, which must already
+     * have the same number of rows and columns. A ZQDynMatrix of the wrong
+     * size is resized first, so outputs can be passed in empty.
+     */
+    template<typename MatrixType, typename T>
+     inline void from1N(const ZQDynMatrix<T> &B, MatrixType &A)
+    {
+        typedef matrix_traits<MatrixType> mt;
+        assert(mt::size_row(A) == B.size_row() /* "Row size of the result does not match" */);
+        assert(mt::size_column(A) == B.size_column() /* "Column size of the result does not match" */);
+        for (int col = 0; col < B.size_column(); ++col)
+            for (int row = 0; row < B.size_row(); ++row)
+                mt::element(A, mt::min_row(A)+row, mt::min_column(A)+col) = B(B.min_row()+row, B.min_column()+col);
+    }
+
+    template<typename T>
+     inline void from1N(const ZQDynMatrix<T> &B, ZQDynMatrix<T> &A)
+    {
+        if (A.size_row() != B.size_row() || A.size_column() != B.size_column())
+            A.resize(B.size_row(), B.size_column());
+        for (int col = 0; col < B.size_column(); ++col)
+            for (int row = 0; row < B.size_row(); ++row)
+                A(A.min_row()+row, A.min_column()+col) = B(B.min_row()+row, B.min_column()+col);
+    }
 
     template<typename MatrixType, typename MatrixType2>
      inline bool index_ascend(const MatrixType &arr, MatrixType2 &indx, std::string &error)
     {
         matrix_traits<MatrixType> mt;
         matrix_traits<MatrixType2> mt2;
-        // assert index_type == index_type2
-        // assert value_type == value_type2
-        typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
 
-        if (mt.max_row(arr) != mt2.max_row(indx)) {
+        if (mt.size_row(arr) != mt2.size_row(indx)) {
             error = std::string("arr row size is not equal to indx row size");
             return false;
         }
 
-        index_type n = mt.size_row(arr);
+        auto arr2 = to1N(arr, 0);
+        auto indx2 = to1N(indx, 0);
 
-        auto arr2 = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(arr);
-        auto indx2 = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(indx);
+        bool ret = index_ascend_zq(arr2, indx2, error);
 
-        bool ret = index_ascend_zq(arr, indx, error);
-
-        indx = ZQOffsetMatrix<1, n, 0, 0, value_type>::from1N(indx2);
+        from1N(indx2, indx);
         return ret;
     }
 
@@ -3120,29 +3073,22 @@ namespace z_linalg {
     {
         matrix_traits<MatrixType> mt;
         matrix_traits<MatrixType2> mt2;
-        // assert index_type == index_type2
-        // assert value_type == value_type2
-        typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
 
-        if (mt.max_row(A) != mt2.max_column(B)) {
+        if (mt.size_row(A) != mt2.size_column(B)) {
             error = std::string("A row size is not equal to B column size");
             return false;
         }
-        if (mt2.max_row(B) != mt.max_column(A)) {
+        if (mt2.size_row(B) != mt.size_column(A)) {
             error = std::string("B row size is not equal to A column size");
             return false;
         }
 
-        index_type n = mt.size_row(A);
-        index_type m = mt2.size_column(A);
-
-        auto AA = ZQOffsetMatrix<1, n, 1, m, value_type>::to1N(A);
-        auto BB = ZQOffsetMatrix<1, m, 1, n, value_type>::to1N(B);
+        auto AA = to1N(A);
+        auto BB = to1N(B);
 
         bool ret = transpose_zq(AA, BB, error);
 
-        B = ZQOffsetMatrix<1, m, 1, n, value_type>::from1N(BB);
+        from1N(BB, B);
         return ret;
     }
 
@@ -3153,27 +3099,23 @@ namespace z_linalg {
     {
         matrix_traits<MatrixType> mt;
         matrix_traits<MatrixType2> mt2;
-        // assert index_type == index_type2
-        // assert value_type == value_type2
-        typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
 
-        if (mt.max_row(A) != mt.max_column(A)) {
+        if (mt.size_row(A) != mt.size_column(A)) {
             error = std::string("A is not square");
             return false;
         }
-        index_type n = mt.size_row(A);
-        index_type m = mt2.size_column(B);
+        if (mt.size_row(A) != mt2.size_row(B)) {
+            error = std::string("A and B do not have the same row size");
+            return false;
+        }
 
-        auto AA = ZQOffsetMatrix<1, n, 1, n, value_type>::to1N(A);
-        auto BB = ZQOffsetMatrix<1, n, 1, m, value_type>::to1N(B);
-        auto YY = AA;
-        auto XX = BB;
+        auto YY = to1N(A);
+        auto XX = to1N(B);
 
-        bool ret = gauss_jordan_zq(AA, BB, YY, XX, error);
+        bool ret = gauss_jordan_zq(YY, XX, error);
 
-        Y = ZQOffsetMatrix<1, n, 1, n, value_type>::from1N(YY);
-        X = ZQOffsetMatrix<1, n, 1, m, value_type>::from1N(XX);
+        from1N(YY, Y);
+        from1N(XX, X);
         return ret;
     }
 
@@ -3183,54 +3125,50 @@ namespace z_linalg {
     {
         matrix_traits<MatrixType> mt;
         matrix_traits<MatrixType2> mt2;
-        // assert index_type == index_type2
-        // assert value_type == value_type2
-        typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
 
-        if (mt.max_row(A) != mt.max_column(A)) {
+        if (mt.size_row(A) != mt.size_column(A)) {
             error = std::string("A is not square");
             return false;
         }
-        index_type n = mt.size_row(A);
+        if (mt.size_row(A) != mt2.size_row(indx)) {
+            error = std::string("A and indx do not have the same row size");
+            return false;
+        }
 
-        auto AA = ZQOffsetMatrix<1, n, 1, n, value_type>::to1N(A);
-        auto BB = ZQOffsetMatrix<1, n, 1, n, value_type>::to1N(B);
-        auto iindx = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(indx);
+        auto AA = to1N(A);
+        auto iindx = to1N(indx, 0);
 
-        bool ret = lu_decomp_zq(AA, BB, iindx, d, error);
+        bool ret = lu_decomp_zq(AA, iindx, d, error);
 
-        B = ZQOffsetMatrix<1, n, 1, n, value_type>::from1N(AA);
-        indx = ZQOffsetMatrix<1, n, 0, 0, value_type>::from1N(iindx);
+        from1N(AA, B);
+        from1N(iindx, indx);
         return ret;
     }
 
-    template<typename MatrixType, typename MatrixType2>
+    template<typename MatrixType, typename MatrixType2, typename MatrixType3>
      inline bool lu_backsub(const MatrixType& A, const MatrixType2 &indx,
-        const MatrixType& B, MatrixType& X, std::string &error)
+        const MatrixType3& B, MatrixType3& X, std::string &error)
     {
         matrix_traits<MatrixType> mt;
         matrix_traits<MatrixType2> mt2;
-        // assert index_type == index_type2
-        // assert value_type == value_type2
-        typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
+        matrix_traits<MatrixType3> mt3;
 
-        if (mt.max_row(A) != mt.max_column(A)) {
+        if (mt.size_row(A) != mt.size_column(A)) {
             error = std::string("A is not square");
             return false;
         }
-        index_type n = mt.size_row(A);
+        if (mt.size_row(A) != mt2.size_row(indx) || mt.size_row(A) != mt3.size_row(B)) {
+            error = std::string("A, indx and B do not have the same row size");
+            return false;
+        }
 
-        auto AA = ZQOffsetMatrix<1, n, 1, n, value_type>::to1N(A);
-        auto iindx = ZQOffsetMatrix<1, n, 0, 0, int>::to1N(indx);
-        auto BB = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(B);
-        auto XX = BB;
+        auto AA = to1N(A);
+        auto iindx = to1N(indx, 0);
+        auto XX = to1N(B, 0);
 
-        bool ret = lu_backsub_zq(AA, iindx, BB, XX, error);
+        bool ret = lu_backsub_zq(AA, iindx, XX, error);
 
-        X = ZQOffsetMatrix<1, n, 0, 0, value_type>::from1N(XX);
-        indx = ZQOffsetMatrix<1, n, 0, 0, int>::from1N(iindx);
+        from1N(XX, X);
         return ret;
     }
 
@@ -3238,23 +3176,18 @@ namespace z_linalg {
      inline bool inverse(const MatrixType& A, MatrixType& Y, std::string &error)
     {
         matrix_traits<MatrixType> mt;
-        // assert index_type == index_type2
-        // assert value_type == value_type2
-        typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
 
-        if (mt.max_row(A) != mt.max_column(A)) {
+        if (mt.size_row(A) != mt.size_column(A)) {
             error = std::string("A is not square");
             return false;
         }
-        index_type n = mt.size_row(A);
 
-        auto AA = ZQOffsetMatrix<1, n, 1, n, value_type>::to1N(A);
+        auto AA = to1N(A);
         auto YY = AA;
 
         bool ret = inverse_zq(AA, YY, error);
 
-        Y = ZQOffsetMatrix<1, n, 1, n, value_type>::from1N(YY);
+        from1N(YY, Y);
         return ret;
     }
 
@@ -3262,18 +3195,13 @@ namespace z_linalg {
      inline bool determinant(const MatrixType& A, T &x, std::string &error)
     {
         matrix_traits<MatrixType> mt;
-        // assert index_type == index_type2
-        // assert value_type == value_type2
-        typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
 
-        if (mt.max_row(A) != mt.max_column(A)) {
+        if (mt.size_row(A) != mt.size_column(A)) {
             error = std::string("A is not square");
             return false;
         }
-        index_type n = mt.size_row(A);
 
-        auto AA = ZQOffsetMatrix<1, n, 1, n, value_type>::to1N(A);
+        auto AA = to1N(A);
 
         bool ret = determinant_zq(AA, x, error);
 
@@ -3283,14 +3211,14 @@ namespace z_linalg {
     template<typename MatrixType>
      inline bool is_symmetric(const MatrixType& A) {
         MatrixType AA = A;
-        std::string errror;
+        std::string error;
         transpose(A, AA, error);
         return A == AA;
     }
 
     template<typename MatrixType>
      inline bool is_orthogonal(const MatrixType& A) {
-        std::string errror;
+        std::string error;
         typedef typename matrix_traits<MatrixType>::value_type value_type;
 
         value_type x;
@@ -3303,22 +3231,22 @@ namespace z_linalg {
         const MatrixType& R, MatrixType& U, std::string &error)
     {
         matrix_traits<MatrixType> mt;
-        // assert index_type == index_type2
-        // assert value_type == value_type2
-        typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
 
-        index_type n = mt.size_row(A);
+        if (mt.size_row(B) != mt.size_row(A) || mt.size_row(C) != mt.size_row(A)
+            || mt.size_row(R) != mt.size_row(A)) {
+            error = std::string("A, B, C and R do not have the same row size");
+            return false;
+        }
 
-        auto AA = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(A);
-        auto BB = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(B);
-        auto CC = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(C);
-        auto RR = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(R);
-        auto UU = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(U);
+        auto AA = to1N(A, 0);
+        auto BB = to1N(B, 0);
+        auto CC = to1N(C, 0);
+        auto RR = to1N(R, 0);
+        auto UU = RR;
 
         bool ret = tridiag_solve_zq(AA, BB, CC, RR, UU, error);
 
-        U = ZQOffsetMatrix<1, n, 0, 0, value_type>::from1N(UU);
+        from1N(UU, U);
 
         return ret;
     }
@@ -3331,7 +3259,6 @@ namespace z_linalg {
         // assert index_type == index_type2
         // assert value_type == value_type2
         typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
 
         index_type n = mt.size_row(A);
         index_type m = mt.size_column(A);
@@ -3340,12 +3267,12 @@ namespace z_linalg {
             error = std::string("Conflicting column dimensions for A");
             return false;
         }
-        auto AA = ZQOffsetMatrix<1, n, 1, m, value_type>::to1N(A);
-        auto XX = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(X);
+        auto AA = to1N(A);
+        auto XX = to1N(X, 0);
         auto BB = XX;
         bool ret = determinant_zq(AA, XX, BB, error);
 
-        B = ZQOffsetMatrix<1, n, 0, 0, value_type>::from1N(BB);
+        from1N(BB, B);
 
         return ret;
     }
@@ -3359,21 +3286,20 @@ namespace z_linalg {
         // assert index_type == index_type2
         // assert value_type == value_type2
         typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
 
         index_type n = mt.size_row(A);
         index_type m1 = mt2.size_column(AL);
         index_type m2 = mt.size_column(A) - m1 - 1;
 
-        auto A2 = ZQOffsetMatrix<1, n, 1, m1+m2+1, value_type>::to1N(A);
+        auto A2 = to1N(A);
         auto A3 = A2;
-        auto AL2 = ZQOffsetMatrix<1, n, 1, m1, value_type>::to1N(AL);
-        auto iindx = ZQOffsetMatrix<1, n, 0, 0, int>::to1N(indx);
+        auto AL2 = to1N(AL);
+        auto iindx = to1N(indx, 0);
         bool ret = banded_decomp_zq(A2, A3, AL2, iindx, d, error);
 
-        AA = ZQOffsetMatrix<1, n, 1, m1+m2+1, value_type>::from1N(A3);
-        AL = ZQOffsetMatrix<1, n, 1, m1, value_type>::from1N(AL2);
-        indx = ZQOffsetMatrix<1, n, 0, 0, int>::from1N(iindx);
+        from1N(A3, AA);
+        from1N(AL2, AL);
+        from1N(iindx, indx);
 
         return ret;
     }
@@ -3388,20 +3314,19 @@ namespace z_linalg {
         // assert index_type == index_type2
         // assert value_type == value_type2
         typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
 
         index_type n = mt.size_row(A);
         index_type m1 = mt2.size_column(AL);
         index_type m2 = mt.size_column(A) - m1 - 1;
 
-        auto A2 = ZQOffsetMatrix<1, n, 1, m1+m2+1, value_type>::to1N(A);
-        auto AL2 = ZQOffsetMatrix<1, n, 1, m1, value_type>::to1N(AL);
-        auto iindx = ZQOffsetMatrix<1, n, 0, 0, int>::to1N(indx);
-        auto B2 = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(B);
+        auto A2 = to1N(A);
+        auto AL2 = to1N(AL);
+        auto iindx = to1N(indx, 0);
+        auto B2 = to1N(B, 0);
         auto B3 = B2;
         bool ret = banded_decomp_zq(A2, AL2, iindx, B2, B3, error);
 
-        BB = ZQOffsetMatrix<1, n, 0, 0, value_type>::from1N(B3);
+        from1N(B3, BB);
 
         return ret;
     }
@@ -3416,7 +3341,6 @@ namespace z_linalg {
         // assert index_type == index_type2
         // assert value_type == value_type2
         typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
 
         if (mt.max_row(A) != mt.max_column(A)) {
             error = std::string("A is not square");
@@ -3428,15 +3352,15 @@ namespace z_linalg {
         }
         index_type n = mt.size_row(A);
         
-        auto A2 = ZQOffsetMatrix<1, n, 1, n, value_type>::to1N(A);
-        auto ALUD2 = ZQOffsetMatrix<1, n, 1, n, value_type>::to1N(ALUD);
-        auto iindx = ZQOffsetMatrix<1, n, 0, 0, int>::to1N(indx);
-        auto B2 = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(B);
-        auto X2 = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(X);
+        auto A2 = to1N(A);
+        auto ALUD2 = to1N(ALUD);
+        auto iindx = to1N(indx, 0);
+        auto B2 = to1N(B, 0);
+        auto X2 = to1N(X, 0);
         auto X3 = XX;
         bool ret = iter_solve_zq(A2, ALUD2, iindx, B2, X2, X3, error);
 
-        XX = ZQOffsetMatrix<1, n, 0, 0, value_type>::from1N(X3);
+        from1N(X3, XX);
 
         return ret;
     }
@@ -3446,78 +3370,53 @@ namespace z_linalg {
         MatrixType3 &V, std::string &error)
     {
         matrix_traits<MatrixType> mt;
-        matrix_traits<MatrixType2> mt2;
-        matrix_traits<MatrixType3> mt3;
-        // assert index_type == index_type2
-        // assert value_type == value_type2
-        typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
 
-        if (mt3.max_row(V) != mt3.max_column(V)) {
-            error = std::string("V is not square");
-            return false;
-        }
-        if (mt.max_row(A) != mt2.max_row(W)) {
-            error = std::string("A and W do not have the same row size");
-            return false;
-        }
-        if (mt.max_row(A) != mt3.max_row(V)) {
-            error = std::string("A and V do not have the same row size");
-            return false;
-        }
-
-        index_type m = mt.size_row(A);
-        index_type n = mt.size_column(A);        
-
-        auto AA = ZQOffsetMatrix<1, m, 1, n, value_type>::to1N(A);
-        auto UU = AA;
-        auto WW = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(W);
-        auto VV = ZQOffsetMatrix<1, n, 1, n, value_type>::to1N(V);
-        bool ret = svd_decomp_zq(AA, UU, WW, VV, error);
+        auto UU = to1N(A);
+        ZQDynMatrix<typename matrix_traits<MatrixType>::value_type> WW(mt.size_column(A), 1, 1, 0),
+            VV(mt.size_column(A), mt.size_column(A), 1, 1);
+        bool ret = svd_decomp_zq(UU, WW, VV, error);
 
-        U = ZQOffsetMatrix<1, m, 1, n, value_type>::from1N(UU);
-        W = ZQOffsetMatrix<1, n, 0, 0, value_type>::from1N(WW);
-        V = ZQOffsetMatrix<1, n, 1, n, value_type>::from1N(VV);
+        from1N(UU, U);
+        from1N(WW, W);
+        from1N(VV, V);
 
         return ret;
     }
 
-    template<typename MatrixType, typename MatrixType2, typename MatrixType3, typename T>
+    template<typename MatrixType, typename MatrixType2, typename MatrixType3, typename MatrixType4, typename T>
      inline bool svd_backsub(const MatrixType &U, const MatrixType2 &W, const MatrixType3 &V,
-        const MatrixType2 &B, MatrixType2 &X, T tol, std::string &error)
+        const MatrixType4 &B, MatrixType4 &X, T tol, std::string &error)
     {
         matrix_traits<MatrixType> mt;
         matrix_traits<MatrixType2> mt2;
         matrix_traits<MatrixType3> mt3;
-        // assert index_type == index_type2
-        // assert value_type == value_type2
-        typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
+        matrix_traits<MatrixType4> mt4;
 
-        if (mt3.max_row(V) != mt3.max_column(V)) {
+        if (mt3.size_row(V) != mt3.size_column(V)) {
             error = std::string("V is not square");
             return false;
         }
-        if (mt.max_row(U) != mt2.max_row(W)) {
-            error = std::string("A and W do not have the same row size");
+        if (mt.size_column(U) != mt2.size_row(W)) {
+            error = std::string("U column size and W row size are not the same");
             return false;
         }
-        if (mt.max_row(U) != mt3.max_row(V)) {
-            error = std::string("A and V do not have the same row size");
+        if (mt.size_column(U) != mt3.size_row(V)) {
+            error = std::string("U column size and V row size are not the same");
+            return false;
+        }
+        if (mt.size_row(U) != mt4.size_row(B)) {
+            error = std::string("U and B do not have the same row size");
             return false;
         }
 
-        index_type m = mt.size_row(U);
-        index_type n = mt.size_column(U);        
-
-        auto UU = ZQOffsetMatrix<1, m, 1, n, value_type>::to1N(U);
-        auto WW = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(W);
-        auto VV = ZQOffsetMatrix<1, n, 1, n, value_type>::to1N(V);
-        auto BB = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(B);
-        auto XX = BB;
-        bool ret = svd_backsub_zq(UU, WW, VV, tol, error);
+        auto UU = to1N(U);
+        auto WW = to1N(W, 0);
+        auto VV = to1N(V);
+        auto BB = to1N(B, 0);
+        ZQDynMatrix<typename matrix_traits<MatrixType>::value_type> XX(mt.size_column(U), 1, 1, 0);
+        bool ret = svd_backsub_zq(UU, WW, VV, BB, XX, tol, error);
 
-        X = ZQOffsetMatrix<1, n, 0, 0, value_type>::from1N(XX);
+        from1N(XX, X);
 
         return ret;
     }
@@ -3530,7 +3429,6 @@ namespace z_linalg {
         // assert index_type == index_type2
         // assert value_type == value_type2
         typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
 
         if (A.max_row() != B.max_row() || A.max_row() != C.max_row() ||
             A.max_row() != R.max_row() || A.max_row() != X.max_row()) {
@@ -3539,15 +3437,15 @@ namespace z_linalg {
         }
         index_type n = mt.size_row(A);
 
-        auto AA = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(A);
-        auto BB = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(B);
-        auto CC = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(C);
-        auto RR = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(R);
-        auto XX = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(X);
+        auto AA = to1N(A, 0);
+        auto BB = to1N(B, 0);
+        auto CC = to1N(C, 0);
+        auto RR = to1N(R, 0);
+        auto XX = to1N(X, 0);
 
         bool ret = tridiag_solve_zq(AA, BB, CC, alpha, beta, RR, XX, error);
 
-        X = ZQOffsetMatrix<1, n, 0, 0, value_type>::from1N(XX);
+        from1N(XX, X);
 
         return ret;
     }
@@ -3561,7 +3459,6 @@ namespace z_linalg {
         // assert index_type == index_type2
         // assert value_type == value_type2
         typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
 
         if (mt.max_row(A) != mt.max_column(A)) {
             error = std::string("A is not square");
@@ -3574,14 +3471,14 @@ namespace z_linalg {
         index_type n = mt.size_row(A);
         index_type nmax = mt2.size_row(sa);
 
-        auto AA = ZQOffsetMatrix<1, n, 1, n, value_type>::to1N(A);
-        auto sa2 = ZQOffsetMatrix<1, nmax, 0, 0, value_type>::to1N(sa);
-        auto ija2 = ZQOffsetMatrix<1, nmax, 0, 0, int>::to1N(ija);
+        auto AA = to1N(A);
+        auto sa2 = to1N(sa, 0);
+        auto ija2 = to1N(ija, 0);
 
         bool ret = sparse_in_zq(AA, sa, ija, error);
 
-        sa = ZQOffsetMatrix<1, nmax, 0, 0, value_type>::from1N(sa2);
-        ija = ZQOffsetMatrix<1, nmax, 0, 0, int>::from1N(ija2);
+        from1N(sa2, sa);
+        from1N(ija2, ija);
 
         return ret;
     }
@@ -3596,7 +3493,6 @@ namespace z_linalg {
         // assert index_type == index_type2
         // assert value_type == value_type2
         typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
 
         if (mt2.max_row(sa) != mt3.max_row(ija)) {
             error = std::string("sa and ija do not have the same row size");
@@ -3605,15 +3501,15 @@ namespace z_linalg {
         index_type n = mt.size_row(X);
         index_type nmax = mt2.size_row(sa);
 
-        auto sa2 = ZQOffsetMatrix<1, nmax, 0, 0, value_type>::to1N(sa);
-        auto ija2 = ZQOffsetMatrix<1, nmax, 0, 0, int>::to1N(ija);
-        auto XX = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(X);
-        auto BB = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(B);
+        auto sa2 = to1N(sa, 0);
+        auto ija2 = to1N(ija, 0);
+        auto XX = to1N(X, 0);
+        auto BB = to1N(B, 0);
 
 
         bool ret = sparse_mmul_zq(sa, ija, XX, BB, error);
 
-        B = ZQOffsetMatrix<1, n, 0, 0, value_type>::from1N(BB);
+        from1N(BB, B);
 
         return ret;
     }
@@ -3629,7 +3525,6 @@ namespace z_linalg {
         // assert index_type == index_type2
         // assert value_type == value_type2
         typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
 
         if (mt2.max_row(sa) != mt3.max_row(ija)) {
             error = std::string("sa and ija do not have the same row size");
@@ -3638,15 +3533,15 @@ namespace z_linalg {
         index_type n = mt.size_row(X);
         index_type nmax = mt2.size_row(sa);
 
-        auto sa2 = ZQOffsetMatrix<1, nmax, 0, 0, value_type>::to1N(sa);
-        auto ija2 = ZQOffsetMatrix<1, nmax, 0, 0, int>::to1N(ija);
-        auto XX = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(X);
-        auto BB = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(B);
+        auto sa2 = to1N(sa, 0);
+        auto ija2 = to1N(ija, 0);
+        auto XX = to1N(X, 0);
+        auto BB = to1N(B, 0);
 
 
         bool ret = sparse_transp_mmul_zq(sa, ija, XX, BB, error);
 
-        B = ZQOffsetMatrix<1, n, 0, 0, value_type>::from1N(BB);
+        from1N(BB, B);
 
         return ret;
     }
@@ -3660,7 +3555,6 @@ namespace z_linalg {
         // assert index_type == index_type2
         // assert value_type == value_type2
         typedef typename matrix_traits<MatrixType2>::index_type index_type;
-        typedef typename matrix_traits<MatrixType2>::value_type value_type;
 
         if (mt2.max_row(sa) != mt3.max_row(ija)) {
             error = std::string("sa and ija do not have the same row size");
@@ -3672,16 +3566,16 @@ namespace z_linalg {
         }
         index_type nmax = mt2.size_row(sa);
 
-        auto sa2 = ZQOffsetMatrix<1, nmax, 0, 0, value_type>::to1N(sa);
-        auto ija2 = ZQOffsetMatrix<1, nmax, 0, 0, int>::to1N(ija);
-        auto sb2 = ZQOffsetMatrix<1, nmax, 0, 0, value_type>::to1N(sb);
-        auto ijb2 = ZQOffsetMatrix<1, nmax, 0, 0, int>::to1N(ijb);
+        auto sa2 = to1N(sa, 0);
+        auto ija2 = to1N(ija, 0);
+        auto sb2 = to1N(sb, 0);
+        auto ijb2 = to1N(ijb, 0);
 
 
         bool ret = sparse_transp_zq(sa, ija, sb, ijb, error);
 
-        sb = ZQOffsetMatrix<1, nmax, 0, 0, value_type>::from1N(sb2);
-        ijb = ZQOffsetMatrix<1, nmax, 0, 0, value_type>::from1N(ijb2);
+        from1N(sb2, sb);
+        from1N(ijb2, ijb);
 
         return ret;
     }
@@ -3696,7 +3590,6 @@ namespace z_linalg {
         // assert index_type == index_type2
         // assert value_type == value_type2
         typedef typename matrix_traits<MatrixType2>::index_type index_type;
-        typedef typename matrix_traits<MatrixType2>::value_type value_type;
 
         if (mt2.max_row(sa) != mt3.max_row(ija)) {
             error = std::string("sa and ija do not have the same row size");
@@ -3712,17 +3605,17 @@ namespace z_linalg {
         }
         index_type nmax = mt2.size_row(sa);
 
-        auto sa2 = ZQOffsetMatrix<1, nmax, 0, 0, value_type>::to1N(sa);
-        auto ija2 = ZQOffsetMatrix<1, nmax, 0, 0, int>::to1N(ija);
-        auto sb2 = ZQOffsetMatrix<1, nmax, 0, 0, value_type>::to1N(sb);
-        auto ijb2 = ZQOffsetMatrix<1, nmax, 0, 0, int>::to1N(ijb);
-        auto sc2 = ZQOffsetMatrix<1, nmax, 0, 0, value_type>::to1N(sc);
-        auto ijc2 = ZQOffsetMatrix<1, nmax, 0, 0, int>::to1N(ijc);
+        auto sa2 = to1N(sa, 0);
+        auto ija2 = to1N(ija, 0);
+        auto sb2 = to1N(sb, 0);
+        auto ijb2 = to1N(ijb, 0);
+        auto sc2 = to1N(sc, 0);
+        auto ijc2 = to1N(ijc, 0);
 
         bool ret = sparse_patmul_zq(sa, ija, sb, ijb, sc, ijc, error);
 
-        sc = ZQOffsetMatrix<1, nmax, 0, 0, value_type>::from1N(sc2);
-        ijc = ZQOffsetMatrix<1, nmax, 0, 0, value_type>::from1N(ijc2);
+        from1N(sc2, sc);
+        from1N(ijc2, ijc);
 
         return ret;
     }
@@ -3737,7 +3630,6 @@ namespace z_linalg {
         // assert index_type == index_type2
         // assert value_type == value_type2
         typedef typename matrix_traits<MatrixType2>::index_type index_type;
-        typedef typename matrix_traits<MatrixType2>::value_type value_type;
 
         if (mt2.max_row(sa) != mt3.max_row(ija)) {
             error = std::string("sa and ija do not have the same row size");
@@ -3746,51 +3638,17 @@ namespace z_linalg {
 
         index_type nmax = mt2.size_row(sa);
 
-        auto sa2 = ZQOffsetMatrix<1, nmax, 0, 0, value_type>::to1N(sa);
-        auto ija2 = ZQOffsetMatrix<1, nmax, 0, 0, int>::to1N(ija);
-        auto sb2 = ZQOffsetMatrix<1, nmax, 0, 0, value_type>::to1N(sb);
-        auto ijb2 = ZQOffsetMatrix<1, nmax, 0, 0, int>::to1N(ijb);
-        auto sc2 = ZQOffsetMatrix<1, nmax, 0, 0, value_type>::to1N(sc);
-        auto ijc2 = ZQOffsetMatrix<1, nmax, 0, 0, int>::to1N(ijc);
+        auto sa2 = to1N(sa, 0);
+        auto ija2 = to1N(ija, 0);
+        auto sb2 = to1N(sb, 0);
+        auto ijb2 = to1N(ijb, 0);
+        auto sc2 = to1N(sc, 0);
+        auto ijc2 = to1N(ijc, 0);
 
         bool ret = sparse_thresmul_zq(sa, ija, sb, ijb, thresh, nmax__, sc, ijc, error);
 
-        sc = ZQOffsetMatrix<1, nmax, 0, 0, value_type>::from1N(sc2);
-        ijc = ZQOffsetMatrix<1, nmax, 0, 0, value_type>::from1N(ijc2);
-
-        return ret;
-    }
-
-    template<typename MatrixType, typename MatrixType2, typename MatrixType3, typename T>
-     inline bool linear_bcg(const MatrixType2 &sa, const MatrixType3 &ija,
-        const MatrixType &b, const MatrixType &x, MatrixType &xx,
-        int itol, T tol, int itmax, int &iter, T &err, bool minres, std::string &error)
-    {
-        matrix_traits<MatrixType> mt;
-        matrix_traits<MatrixType2> mt2;
-        matrix_traits<MatrixType3> mt3;
-        // assert index_type == index_type2
-        // assert value_type == value_type2
-        typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
-
-        if (mt2.max_row(sa) != mt3.max_row(ija)) {
-            error = std::string("sa and ija do not have the same row size");
-            return false;
-        }
-        index_type n = mt.size_row(b);
-        index_type nmax = mt2.size_row(sa);
-
-        auto sa2 = ZQOffsetMatrix<1, nmax, 0, 0, value_type>::to1N(sa);
-        auto ija2 = ZQOffsetMatrix<1, nmax, 0, 0, int>::to1N(ija);
-        auto b2 = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(b);
-        auto x2 = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(x);
-        auto xx2 = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(xx);
-
-
-        bool ret = sparse_transp_mmul_zq(sa2, ija2, b2, x2, xx2, itol, tol, itmax, iter, err, minres, error);
-
-        xx = ZQOffsetMatrix<1, n, 0, 0, value_type>::from1N(xx2);
+        from1N(sc2, sc);
+        from1N(ijc2, ijc);
 
         return ret;
     }
@@ -3803,18 +3661,17 @@ namespace z_linalg {
         // assert index_type == index_type2
         // assert value_type == value_type2
         typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
 
         index_type n = mt.size_row(x);
 
-        auto xx = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(x);
-        auto qq = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(q);
-        auto ww = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(w);
+        auto xx = to1N(x, 0);
+        auto qq = to1N(q, 0);
+        auto ww = to1N(w, 0);
 
 
         bool ret = vandermonde_solve_zq(xx, qq, ww, error);
 
-        w = ZQOffsetMatrix<1, n, 0, 0, value_type>::from1N(ww);
+        from1N(ww, w);
 
         return ret;
     }
@@ -3828,18 +3685,17 @@ namespace z_linalg {
         // assert index_type == index_type2
         // assert value_type == value_type2
         typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
 
         index_type n = mt.size_row(y);
 
-        auto rr = ZQOffsetMatrix<1, 2*n-1, 0, 0, value_type>::to1N(r);
-        auto yy = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(y);
-        auto xx = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(x);
+        auto rr = to1N(r, 0);
+        auto yy = to1N(y, 0);
+        auto xx = to1N(x, 0);
 
 
         bool ret = toeplitz_solve_zq(rr, yy, xx, error);
 
-        x = ZQOffsetMatrix<1, n, 0, 0, value_type>::from1N(xx);
+        from1N(xx, x);
 
         return ret;
     }
@@ -3849,65 +3705,50 @@ namespace z_linalg {
     {
         matrix_traits<MatrixType> mt;
         matrix_traits<MatrixType2> mt2;
-        // assert index_type == index_type2
-        // assert value_type == value_type2
 
-        if (mt.max_row(a) != mt.max_column(a)) {
+        if (mt.size_row(a) != mt.size_column(a)) {
             error = std::string("A is not square");
             return false;
         }
-        if (mt.max_row(a) != mt2.max_row(p)) {
+        if (mt.size_row(a) != mt2.size_row(p)) {
             error = std::string("A and p do not have the same row size");
             return false;
         }
-        typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
-
-        index_type n = mt.size_row(a);
-
-        auto aa = ZQOffsetMatrix<1, n, 1, n, value_type>::to1N(a);
-        auto pp = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(p);
 
+        auto aa = to1N(a);
+        auto pp = to1N(p, 0);
 
         bool ret = chol_decomp_zq(aa, pp, error);
 
-        a = ZQOffsetMatrix<1, n, 1, n, value_type>::from1N(aa);
-        p = ZQOffsetMatrix<1, n, 0, 0, value_type>::from1N(pp);
+        from1N(aa, a);
+        from1N(pp, p);
 
         return ret;
     }
 
     template<typename MatrixType, typename MatrixType2>
      inline bool chol_solve(const MatrixType &a, const MatrixType2 &p,
-        MatrixType2 &b, MatrixType2 &x, std::string &error)
+        const MatrixType2 &b, MatrixType2 &x, std::string &error)
     {
         matrix_traits<MatrixType> mt;
         matrix_traits<MatrixType2> mt2;
-        // assert index_type == index_type2
-        // assert value_type == value_type2
 
-        if (mt.max_row(a) != mt.max_column(a)) {
+        if (mt.size_row(a) != mt.size_column(a)) {
             error = std::string("A is not square");
             return false;
         }
-        if (mt.max_row(a) != mt2.max_row(p)) {
-            error = std::string("A and p do not have the same row size");
+        if (mt.size_row(a) != mt2.size_row(p) || mt.size_row(a) != mt2.size_row(b)) {
+            error = std::string("A, p and b do not have the same row size");
             return false;
         }
-        typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
-
-        index_type n = mt.size_row(a);
 
-        auto aa = ZQOffsetMatrix<1, n, 1, n, value_type>::to1N(a);
-        auto pp = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(p);
-        auto bb = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(b);
-        auto xx = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(x);
+        auto aa = to1N(a);
+        auto pp = to1N(p, 0);
+        auto xx = to1N(b, 0);
 
+        bool ret = chol_solve_zq(aa, pp, xx, xx, error);
 
-        bool ret = chol_solve_zq(aa, pp, error);
-
-        xx = ZQOffsetMatrix<1, n, 0, 0, value_type>::from1N(xx);
+        from1N(xx, x);
 
         return ret;
     }
@@ -3917,30 +3758,22 @@ namespace z_linalg {
     {
         matrix_traits<MatrixType> mt;
         matrix_traits<MatrixType2> mt2;
-        // assert index_type == index_type2
-        // assert value_type == value_type2
 
-        if (mt.max_row(a) != mt.max_column(a)) {
+        if (mt.size_row(a) != mt.size_column(a)) {
             error = std::string("A is not square");
             return false;
         }
-        if (mt.max_row(a) != mt2.max_row(p)) {
+        if (mt.size_row(a) != mt2.size_row(p)) {
             error = std::string("A and p do not have the same row size");
             return false;
         }
-        typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
-
-        index_type n = mt.size_row(a);
-
-        auto aa = ZQOffsetMatrix<1, n, 1, n, value_type>::to1N(a);
-        auto pp = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(p);
 
+        auto aa = to1N(a);
+        auto pp = to1N(p, 0);
 
         bool ret = chol_invert_zq(aa, pp, error);
 
-        a = ZQOffsetMatrix<1, n, 1, n, value_type>::from1N(aa);
-        p = ZQOffsetMatrix<1, n, 0, 0, value_type>::from1N(pp);
+        from1N(aa, a);
 
         return ret;
     }
@@ -3951,32 +3784,25 @@ namespace z_linalg {
     {
         matrix_traits<MatrixType> mt;
         matrix_traits<MatrixType2> mt2;
-        // assert index_type == index_type2
-        // assert value_type == value_type2
 
-        if (mt.max_row(a) != mt.max_column(a)) {
+        if (mt.size_row(a) != mt.size_column(a)) {
             error = std::string("A is not square");
             return false;
         }
-        if (mt.max_row(a) != mt2.max_row(c)) {
-            error = std::string("A and c do not have the same row size");
+        if (mt.size_row(a) != mt2.size_row(c) || mt.size_row(a) != mt2.size_row(d)) {
+            error = std::string("A, c and d do not have the same row size");
             return false;
         }
-        typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
 
-        index_type n = mt.size_row(a);
+        auto aa2 = to1N(a);
+        auto c2 = to1N(c, 0);
+        auto d2 = to1N(d, 0);
 
-        auto a2 = ZQOffsetMatrix<1, n, 1, n, value_type>::to1N(a);
-        auto aa2 = ZQOffsetMatrix<1, n, 1, n, value_type>::to1N(aa);
-        auto c2 = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(c);
-        auto d2 = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(d);
+        bool ret = qr_decomp_zq(aa2, c2, d2, sing, error);
 
-        bool ret = qr_decomp_zq(a2, aa2, c2, d2, sing, error);
-
-        aa = ZQOffsetMatrix<1, n, 1, n, value_type>::from1N(aa2);
-        c = ZQOffsetMatrix<1, n, 0, 0, value_type>::from1N(c2);
-        d = ZQOffsetMatrix<1, n, 0, 0, value_type>::from1N(d2);
+        from1N(aa2, aa);
+        from1N(c2, c);
+        from1N(d2, d);
 
         return ret;
     }
@@ -3987,30 +3813,23 @@ namespace z_linalg {
     {
         matrix_traits<MatrixType> mt;
         matrix_traits<MatrixType2> mt2;
-        // assert index_type == index_type2
-        // assert value_type == value_type2
 
-        if (mt.max_row(a) != mt.max_column(a)) {
+        if (mt.size_row(a) != mt.size_column(a)) {
             error = std::string("A is not square");
             return false;
         }
-        if (mt.max_row(a) != mt2.max_row(d)) {
-            error = std::string("A and d do not have the same row size");
+        if (mt.size_row(a) != mt2.size_row(d) || mt.size_row(a) != mt2.size_row(b)) {
+            error = std::string("A, d and b do not have the same row size");
             return false;
         }
-        typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
 
-        index_type n = mt.size_row(a);
+        auto a2 = to1N(a);
+        auto d2 = to1N(d, 0);
+        auto bb2 = to1N(b, 0);
 
-        auto a2 = ZQOffsetMatrix<1, n, 1, n, value_type>::to1N(a);
-        auto d2 = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(d);
-        auto b2 = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(b);
-        auto bb2 = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(bb);
+        bool ret = r_solve_zq(a2, d2, bb2, error);
 
-        bool ret = r_solve_zq(a2, d2, b2, bb2, error);
-
-        bb = ZQOffsetMatrix<1, n, 0, 0, value_type>::from1N(bb2);
+        from1N(bb2, bb);
 
         return ret;
     }
@@ -4021,30 +3840,25 @@ namespace z_linalg {
     {
         matrix_traits<MatrixType> mt;
         matrix_traits<MatrixType2> mt2;
-        // assert index_type == index_type2
-        // assert value_type == value_type2
 
-        if (mt.max_row(a) != mt.max_column(a)) {
+        if (mt.size_row(a) != mt.size_column(a)) {
             error = std::string("A is not square");
             return false;
         }
-        if (mt.max_row(a) != mt2.max_row(c)) {
-            error = std::string("A and c do not have the same row size");
+        if (mt.size_row(a) != mt2.size_row(c) || mt.size_row(a) != mt2.size_row(d)
+            || mt.size_row(a) != mt2.size_row(b)) {
+            error = std::string("A, c, d and b do not have the same row size");
             return false;
         }
-        typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
-
-        index_type n = mt.size_row(a);
 
-        auto a2 = ZQOffsetMatrix<1, n, 1, n, value_type>::to1N(a);
-        auto d2 = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(d);
-        auto b2 = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(b);
-        auto bb2 = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(bb);
+        auto a2 = to1N(a);
+        auto c2 = to1N(c, 0);
+        auto d2 = to1N(d, 0);
+        auto bb2 = to1N(b, 0);
 
-        bool ret = r_solve_zq(a2, d2, b2, bb2, error);
+        bool ret = qr_solve_zq(a2, c2, d2, bb2, error);
 
-        bb = ZQOffsetMatrix<1, n, 0, 0, value_type>::from1N(bb2);
+        from1N(bb2, bb);
 
         return ret;
     }
@@ -4062,16 +3876,15 @@ namespace z_linalg {
             return false;
         }
         typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
 
         index_type n = mt.size_row(r);
 
-        auto r2 = ZQOffsetMatrix<1, n, 1, n, value_type>::to1N(r);
-        auto rr2 = ZQOffsetMatrix<1, n, 1, n, value_type>::to1N(rr);
+        auto r2 = to1N(r);
+        auto rr2 = to1N(rr);
 
         bool ret = jacobi_rotate_zq(r2, rr2, i, a, b, error);
 
-        rr = ZQOffsetMatrix<1, n, 1, n, value_type>::from1N(rr2);
+        from1N(rr2, rr);
 
         return ret;
     }
@@ -4095,22 +3908,21 @@ namespace z_linalg {
             return false;
         }
         typedef typename matrix_traits<MatrixType>::index_type index_type;
-        typedef typename matrix_traits<MatrixType>::value_type value_type;
 
         index_type n = mt.size_row(r);
 
-        auto r2 = ZQOffsetMatrix<1, n, 1, n, value_type>::to1N(r);
-        auto qt2 = ZQOffsetMatrix<1, n, 1, n, value_type>::to1N(qt);
-        auto u2 = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(u);
-        auto rr2 = ZQOffsetMatrix<1, n, 1, n, value_type>::to1N(rr);
-        auto qtt2 = ZQOffsetMatrix<1, n, 1, n, value_type>::to1N(qtt);
-        auto uu2 = ZQOffsetMatrix<1, n, 0, 0, value_type>::to1N(uu);
+        auto r2 = to1N(r);
+        auto qt2 = to1N(qt);
+        auto u2 = to1N(u, 0);
+        auto rr2 = to1N(rr);
+        auto qtt2 = to1N(qtt);
+        auto uu2 = to1N(uu, 0);
 
         bool ret = qr_update_zq(r2, qt2, u2, rr2, qtt2, uu2, error);
 
-        rr = ZQOffsetMatrix<1, n, 1, n, value_type>::from1N(rr2);
-        qtt = ZQOffsetMatrix<1, n, 1, n, value_type>::from1N(qtt2);
-        uu = ZQOffsetMatrix<1, n, 0, 0, value_type>::from1N(uu2);
+        from1N(rr2, rr);
+        from1N(qtt2, qtt);
+        from1N(uu2, uu);
 
         return ret;
     }
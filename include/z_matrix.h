@@ -9,22 +9,38 @@
 #include <sstream>
 #include <iomanip>
 #include "z_offsetmatrix.h"
+#include "z_matrixexpr.h"
 
 namespace z_linalg {
 
+    template <int M, int N, typename T>
+     class ZQMatrix;
+
+    template <int M, int N, typename T>
+     struct ZQMatrixExprTraits<ZQMatrix<M, N, T> > {
+        typedef T value_type;
+        enum { size = M * N };
+        static inline int index(int row, int column) { return column * M + row; }
+    };
+
     /*
-     * Note: C++ doesn't know when it needs to upcast a primitive type in a template,
-     * therefore you must always cast your scaling factors to T when using the operator* and operator/ functions.
-     * In particular, a ZQMatrix<... qreal> can't be mutiplied or divided by an int and the int needs to be
-     * casted into qreal first.
+     * The element-wise operators +, - and scaling by a factor build lazy
+     * expressions, see z_matrixexpr.h, which are evaluated in one pass
+     * when they are assigned to a ZQMatrix. Scaling factors are converted
+     * to T, so a ZQMatrix<... qreal> can be multiplied or divided by an int.
      */
     template <int M, int N, typename T>
-     class ZQMatrix {
+     class ZQMatrix : public ZQMatrixExpr<ZQMatrix<M, N, T>, ZQMatrix<M, N, T> > {
     public:
 
         inline ZQMatrix();
         inline ZQMatrix(const ZQMatrix<M, N, T>& other);
         explicit inline ZQMatrix(const T *values);
+        template <typename E>
+         inline ZQMatrix(const ZQMatrixExpr<ZQMatrix<M, N, T>, E>& expr);
+
+        template <typename E>
+         inline ZQMatrix<M, N, T>& operator=(const ZQMatrixExpr<ZQMatrix<M, N, T>, E>& expr);
 
         static inline ZQOffsetMatrix<1, M, 1, N, T> to1Based(const ZQMatrix<M, N, T> &A);
         static inline ZQMatrix<M, N, T> from1Based(const ZQOffsetMatrix<1, M, 1, N, T> &A);
@@ -49,6 +65,10 @@ namespace z_linalg {
 
         inline ZQMatrix<M, N, T>& operator+=(const ZQMatrix<M, N, T>& other);
         inline ZQMatrix<M, N, T>& operator-=(const ZQMatrix<M, N, T>& other);
+        template <typename E>
+         inline ZQMatrix<M, N, T>& operator+=(const ZQMatrixExpr<ZQMatrix<M, N, T>, E>& expr);
+        template <typename E>
+         inline ZQMatrix<M, N, T>& operator-=(const ZQMatrixExpr<ZQMatrix<M, N, T>, E>& expr);
         inline ZQMatrix<M, N, T>& operator*=(T factor);
         inline ZQMatrix<M, N, T>& operator/=(T divisor);
 
@@ -60,6 +80,7 @@ namespace z_linalg {
         inline T *data() { return *m; }
         inline const T *data() const { return *m; }
         inline const T *constData() const { return *m; }
+        inline T coeff(int index) const { return constData()[index]; }
 
         template<int M_, int N_>
          friend inline ZQMatrix<M_, N_, T> submatrix(ZQMatrix<M, N, T> m1, int row1, int row2, int col1, int col2) {
@@ -82,7 +103,7 @@ namespace z_linalg {
          friend inline ZQMatrix<M_, N_, T> concat(ZQMatrix<M, N, T> m1, ZQMatrix<M_-M, N_-N, T> m2, T fillval=0.0) {
             assert(M_ > M /* "concatenated row size is less than original row size" */);
             assert(N_ > N /* "concatenated column size is less than original column size" */);
-            ZQMatrix<M_, N_> A;
+            ZQMatrix<M_, N_, T> A;
             A.fill(fillval);
             for (int row = 0; row < M; ++row) {
                 for (int col = 0; col < N; ++col)
@@ -102,24 +123,8 @@ namespace z_linalg {
 
         QString toString() const;
 
-        template<int M_, int N_, typename T_>
-         friend inline ZQMatrix<M_, N_, T_> operator+(const ZQMatrix<M_, N_, T_>& m1, const ZQMatrix<M_, N_, T_>& m2);
-        template<int M_, int N_, typename T_>
-         friend inline ZQMatrix<M_, N_, T_> operator-(const ZQMatrix<M_, N_, T_>& m1, const ZQMatrix<M_, N_, T_>& m2);
         template<int N_, int M1_, int M2_, typename T_>
          friend inline ZQMatrix<M2_, M1_, T_> operator*(const ZQMatrix<M2_, N_, T_>& m1, const ZQMatrix<N_, M1_, T_>& m2);
-        template<int M_, int N_, typename T_>
-         friend inline ZQMatrix<M_, N_, T_> operator-(const ZQMatrix<M_, N_, T_>& matrix);
-        template<int M_, int N_, typename T_>
-         friend inline ZQMatrix<M_, N_, T_> operator*(T_ factor, const ZQMatrix<M_, N_, T_>& matrix);
-        template<int M_, int N_, typename T_>
-         friend inline ZQMatrix<M_, N_, T_> operator*(const ZQMatrix<M_, N_, T_>& matrix, T_ factor);
-        template<int M_, int N_, typename T_>
-         friend inline ZQMatrix<M_, N_, T_> operator/(const ZQMatrix<M_, N_, T_>& matrix, T_ divisor);
-
-
-        template<int M_, int N_, typename T_>
-         friend inline ZQMatrix<M_, N_, T_> operator/(const ZQMatrix<M_, N_, T_>& matrix, T_ divisor);
 
     };
 
@@ -154,6 +159,23 @@ namespace z_linalg {
                 m[col][row] = values[row * (N) + col];
     }
 
+    template <int M, int N, typename T>
+    template <typename E>
+     inline ZQMatrix<M, N, T>::ZQMatrix(const ZQMatrixExpr<ZQMatrix<M, N, T>, E>& expr)
+    {
+        for (int i = 0; i < M * N; ++i)
+            data()[i] = expr.derived().coeff(i);
+    }
+
+    template <int M, int N, typename T>
+    template <typename E>
+     inline ZQMatrix<M, N, T>& ZQMatrix<M, N, T>::operator=(const ZQMatrixExpr<ZQMatrix<M, N, T>, E>& expr)
+    {
+        for (int i = 0; i < M * N; ++i)
+            data()[i] = expr.derived().coeff(i);
+        return *this;
+    }
+
     template <int M, int N, typename T>
      inline ZQOffsetMatrix<1, M, 1, N, T> ZQMatrix<M, N, T>::to1Based(const ZQMatrix<M, N, T> &A)
     {
@@ -252,98 +274,58 @@ namespace z_linalg {
         return result;
     }
 
-    template <int M, int N, typename T>
-     inline ZQMatrix<M, N, T> operator+(const ZQMatrix<M, N, T>& m1, const ZQMatrix<M, N, T>& m2)
-    {
-        ZQMatrix<M, N, T> result(1);
-        for (int row = 0; row < M; ++row)
-            for (int col = 0; col < N; ++col)
-                result.m[col][row] = m1.m[col][row] + m2.m[col][row];
-        return result;
-    }
-
-    template <int M, int N, typename T>
-     inline ZQMatrix<M, N, T> operator-(const ZQMatrix<M, N, T>& m1, const ZQMatrix<M, N, T>& m2)
-    {
-        ZQMatrix<M, N, T> result(1);
-        for (int row = 0; row < M; ++row)
-            for (int col = 0; col < N; ++col)
-                result.m[col][row] = m1.m[col][row] - m2.m[col][row];
-        return result;
-    }
-
     // Just your friendly reminder that the order of templates specified below does NOT reflect on the order used in variable names.  
+    // Float and double products of GemmThreshold multiply-adds or more go to
+    // z_linalg::gemm(), which lives in zglshapes2d; link it when using them.
     template <int N, int M1, int M2, typename T>
      inline ZQMatrix<M2, M1, T> operator*(const ZQMatrix<M2, N, T>& m1, const ZQMatrix<N, M1, T>& m2)
     {
         ZQMatrix<M2, M1, T> result(1);
-        for (int row = 0; row < M2; ++row) {
-            for (int col = 0; col < M1; ++col) {
-                T sum(0.0f);
-                for (int j = 0; j < N; ++j)
-                    sum += m1.m[j][row] * m2.m[col][j];
-                result.m[col][row] = sum;
-            }
-        }
+        ZQFixedProduct<M2, M1, N, T>::run(*m1.m, *m2.m, *result.m);
         return result;
     }
 
-    template <int M, int N, typename T>
-     inline ZQMatrix<M, N, T> operator-(const ZQMatrix<M, N, T>& matrix)
+    // Products with an element-wise expression on either side evaluate it first.
+    template <int N, int M1, int M2, typename T, typename L, typename R>
+     inline ZQMatrix<M2, M1, T> operator*(const ZQMatrixExpr<ZQMatrix<M2, N, T>, L>& m1, const ZQMatrixExpr<ZQMatrix<N, M1, T>, R>& m2)
     {
-        ZQMatrix<M, N, T> result(1);
-        for (int row = 0; row < M; ++row)
-            for (int col = 0; col < N; ++col)
-                result.m[col][row] = -matrix.m[col][row];
-        return result;
+        return evaluated(m1) * evaluated(m2);
     }
 
-    template <int M, int N, typename T>
-     inline ZQMatrix<M, N, T> operator*(T factor, const ZQMatrix<M, N, T>& matrix)
-    {
-        ZQMatrix<M, N, T> result(1);
-        for (int row = 0; row < M; ++row)
-            for (int col = 0; col < N; ++col)
-                result.m[col][row] = matrix.m[col][row] * factor;
-        return result;
-    }
 
     template <int M, int N, typename T>
-     inline ZQMatrix<M, N, T> operator*(const ZQMatrix<M, N, T>& matrix, T factor)
+     inline ZQMatrix<M, N, T>& ZQMatrix<M, N, T>::operator+=(const ZQMatrix<M, N, T>& other)
     {
-        ZQMatrix<M, N, T> result(1);
         for (int row = 0; row < M; ++row)
             for (int col = 0; col < N; ++col)
-                result.m[col][row] = matrix.m[col][row] * factor;
-        return result;
+                m[col][row] += other.m[col][row];
+        return *this;
     }
 
     template <int M, int N, typename T>
-     inline ZQMatrix<M, N, T>operator/(const ZQMatrix<M, N, T>& matrix, T divisor)
+     inline ZQMatrix<M, N, T>& ZQMatrix<M, N, T>::operator-=(const ZQMatrix<M, N, T>& other)
     {
-        ZQMatrix<M, N, T> result(1);
         for (int row = 0; row < M; ++row)
             for (int col = 0; col < N; ++col)
-                result.m[col][row] = matrix.m[col][row] / divisor;
-        return result;
+                m[col][row] -= other.m[col][row];
+        return *this;
     }
-    
 
     template <int M, int N, typename T>
-     inline ZQMatrix<M, N, T>& ZQMatrix<M, N, T>::operator+=(const ZQMatrix<M, N, T>& other)
+    template <typename E>
+     inline ZQMatrix<M, N, T>& ZQMatrix<M, N, T>::operator+=(const ZQMatrixExpr<ZQMatrix<M, N, T>, E>& expr)
     {
-        for (int row = 0; row < M; ++row)
-            for (int col = 0; col < N; ++col)
-                m[col][row] += other.m[col][row];
+        for (int i = 0; i < M * N; ++i)
+            data()[i] += expr.derived().coeff(i);
         return *this;
     }
 
     template <int M, int N, typename T>
-     inline ZQMatrix<M, N, T>& ZQMatrix<M, N, T>::operator-=(const ZQMatrix<M, N, T>& other)
+    template <typename E>
+     inline ZQMatrix<M, N, T>& ZQMatrix<M, N, T>::operator-=(const ZQMatrixExpr<ZQMatrix<M, N, T>, E>& expr)
     {
-        for (int row = 0; row < M; ++row)
-            for (int col = 0; col < N; ++col)
-                m[col][row] -= other.m[col][row];
+        for (int i = 0; i < M * N; ++i)
+            data()[i] -= expr.derived().coeff(i);
         return *this;
     }
 
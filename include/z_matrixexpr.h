@@ -0,0 +1,217 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#ifndef Z_MATRIXEXPR_H
+#define Z_MATRIXEXPR_H
+
+#include <QDataStream>
+#include <QDebug>
+
+namespace z_linalg {
+
+    /*
+     * Element-wise arithmetic on the fixed size matrices is lazy: a + b,
+     * a - b, -a, a * s, s * a and a / s return small expression objects
+     * that only remember their operands. A chain such as A*x + b - c*2.0
+     * is computed in a single loop over the elements when it is assigned
+     * to, or used to construct, a matrix, with no temporary matrix for
+     * each operator.
+     *
+     * Every matrix type Matrix is itself a ZQMatrixExpr<Matrix, Matrix>,
+     * and ZQMatrixExprTraits<Matrix> gives its element type, its number
+     * of elements and where row and column are in its storage, which is
+     * column-major and contiguous for all of them. Both operands of a sum
+     * or difference must have the same Matrix type, so mismatched shapes
+     * still fail to compile. Scaling factors are converted to the element
+     * type.
+     *
+     * The read-only members of the matrices that look at the whole matrix,
+     * transposed(), isIdentity() and copyDataTo(), are also available on
+     * an expression, which is evaluated into a temporary matrix for them.
+     *
+     * An expression refers to its matrix operands, so it must be used
+     * while they still exist: assign it to a matrix or call eval() rather
+     * than keeping it in an auto variable past the end of the statement
+     * when one of the operands is a temporary, such as a matrix product.
+     */
+    template <typename Matrix> struct ZQMatrixExprTraits;
+
+    template <typename Matrix, typename E>
+     class ZQMatrixExpr {
+    public:
+        typedef typename ZQMatrixExprTraits<Matrix>::value_type value_type;
+
+        inline const E &derived() const { return static_cast<const E &>(*this); }
+
+        inline value_type operator()(int row, int column) const
+        {
+            return derived().coeff(ZQMatrixExprTraits<Matrix>::index(row, column));
+        }
+
+        inline Matrix eval() const { return Matrix(*this); }
+
+        inline Matrix transposed() const { return eval().transposed(); }
+        inline bool isIdentity() const { return eval().isIdentity(); }
+        inline void copyDataTo(value_type *values) const { eval().copyDataTo(values); }
+    };
+
+    // Matrices are held by reference and expressions by value, so that a
+    // chain can be built up from temporaries within one statement.
+    template <typename Matrix, typename E>
+     struct ZQMatrixExprOperand {
+        typedef const E type;
+    };
+
+    template <typename Matrix>
+     struct ZQMatrixExprOperand<Matrix, Matrix> {
+        typedef const Matrix &type;
+    };
+
+    template <typename Matrix, typename L, typename R>
+     class ZQMatrixSum : public ZQMatrixExpr<Matrix, ZQMatrixSum<Matrix, L, R> > {
+    public:
+        typedef typename ZQMatrixExprTraits<Matrix>::value_type value_type;
+
+        inline ZQMatrixSum(const L &l, const R &r) : lhs(l), rhs(r) {}
+        inline value_type coeff(int index) const { return lhs.coeff(index) + rhs.coeff(index); }
+
+    private:
+        typename ZQMatrixExprOperand<Matrix, L>::type lhs;
+        typename ZQMatrixExprOperand<Matrix, R>::type rhs;
+    };
+
+    template <typename Matrix, typename L, typename R>
+     class ZQMatrixDifference : public ZQMatrixExpr<Matrix, ZQMatrixDifference<Matrix, L, R> > {
+    public:
+        typedef typename ZQMatrixExprTraits<Matrix>::value_type value_type;
+
+        inline ZQMatrixDifference(const L &l, const R &r) : lhs(l), rhs(r) {}
+        inline value_type coeff(int index) const { return lhs.coeff(index) - rhs.coeff(index); }
+
+    private:
+        typename ZQMatrixExprOperand<Matrix, L>::type lhs;
+        typename ZQMatrixExprOperand<Matrix, R>::type rhs;
+    };
+
+    template <typename Matrix, typename E>
+     class ZQMatrixNegation : public ZQMatrixExpr<Matrix, ZQMatrixNegation<Matrix, E> > {
+    public:
+        typedef typename ZQMatrixExprTraits<Matrix>::value_type value_type;
+
+        explicit inline ZQMatrixNegation(const E &e) : operand(e) {}
+        inline value_type coeff(int index) const { return -operand.coeff(index); }
+
+    private:
+        typename ZQMatrixExprOperand<Matrix, E>::type operand;
+    };
+
+    template <typename Matrix, typename E>
+     class ZQMatrixScaled : public ZQMatrixExpr<Matrix, ZQMatrixScaled<Matrix, E> > {
+    public:
+        typedef typename ZQMatrixExprTraits<Matrix>::value_type value_type;
+
+        inline ZQMatrixScaled(const E &e, value_type f) : operand(e), factor(f) {}
+        inline value_type coeff(int index) const { return operand.coeff(index) * factor; }
+
+    private:
+        typename ZQMatrixExprOperand<Matrix, E>::type operand;
+        value_type factor;
+    };
+
+    template <typename Matrix, typename E>
+     class ZQMatrixQuotient : public ZQMatrixExpr<Matrix, ZQMatrixQuotient<Matrix, E> > {
+    public:
+        typedef typename ZQMatrixExprTraits<Matrix>::value_type value_type;
+
+        inline ZQMatrixQuotient(const E &e, value_type d) : operand(e), divisor(d) {}
+        inline value_type coeff(int index) const { return operand.coeff(index) / divisor; }
+
+    private:
+        typename ZQMatrixExprOperand<Matrix, E>::type operand;
+        value_type divisor;
+    };
+
+    template <typename Matrix, typename L, typename R>
+     inline ZQMatrixSum<Matrix, L, R> operator+(const ZQMatrixExpr<Matrix, L>& m1, const ZQMatrixExpr<Matrix, R>& m2)
+    {
+        return ZQMatrixSum<Matrix, L, R>(m1.derived(), m2.derived());
+    }
+
+    template <typename Matrix, typename L, typename R>
+     inline ZQMatrixDifference<Matrix, L, R> operator-(const ZQMatrixExpr<Matrix, L>& m1, const ZQMatrixExpr<Matrix, R>& m2)
+    {
+        return ZQMatrixDifference<Matrix, L, R>(m1.derived(), m2.derived());
+    }
+
+    template <typename Matrix, typename E>
+     inline ZQMatrixNegation<Matrix, E> operator-(const ZQMatrixExpr<Matrix, E>& matrix)
+    {
+        return ZQMatrixNegation<Matrix, E>(matrix.derived());
+    }
+
+    template <typename Matrix, typename E>
+     inline ZQMatrixScaled<Matrix, E> operator*(typename ZQMatrixExprTraits<Matrix>::value_type factor, const ZQMatrixExpr<Matrix, E>& matrix)
+    {
+        return ZQMatrixScaled<Matrix, E>(matrix.derived(), factor);
+    }
+
+    template <typename Matrix, typename E>
+     inline ZQMatrixScaled<Matrix, E> operator*(const ZQMatrixExpr<Matrix, E>& matrix, typename ZQMatrixExprTraits<Matrix>::value_type factor)
+    {
+        return ZQMatrixScaled<Matrix, E>(matrix.derived(), factor);
+    }
+
+    template <typename Matrix, typename E>
+     inline ZQMatrixQuotient<Matrix, E> operator/(const ZQMatrixExpr<Matrix, E>& matrix, typename ZQMatrixExprTraits<Matrix>::value_type divisor)
+    {
+        return ZQMatrixQuotient<Matrix, E>(matrix.derived(), divisor);
+    }
+
+    // Comparisons where at least one side is an expression; two matrices
+    // use the members of the matrix classes.
+    template <typename Matrix, typename L, typename R>
+     inline bool operator==(const ZQMatrixExpr<Matrix, L>& m1, const ZQMatrixExpr<Matrix, R>& m2)
+    {
+        for (int i = 0; i < ZQMatrixExprTraits<Matrix>::size; ++i)
+            if (m1.derived().coeff(i) != m2.derived().coeff(i))
+                return false;
+        return true;
+    }
+
+    template <typename Matrix, typename L, typename R>
+     inline bool operator!=(const ZQMatrixExpr<Matrix, L>& m1, const ZQMatrixExpr<Matrix, R>& m2)
+    {
+        return !(m1 == m2);
+    }
+
+    /*
+     * The matrix an expression stands for: a matrix itself, or a new one
+     * holding the evaluated expression. Used where a whole matrix is
+     * needed, such as the operands of a matrix product.
+     */
+    template <typename Matrix>
+     inline const Matrix &evaluated(const ZQMatrixExpr<Matrix, Matrix>& matrix)
+    {
+        return matrix.derived();
+    }
+
+    template <typename Matrix, typename E>
+     inline Matrix evaluated(const ZQMatrixExpr<Matrix, E>& expr)
+    {
+        return Matrix(expr);
+    }
+
+    template <typename Matrix, typename E>
+     QDebug operator<<(QDebug dbg, const ZQMatrixExpr<Matrix, E> &expr)
+    {
+        return dbg << evaluated(expr);
+    }
+
+    template <typename Matrix, typename E>
+     QDataStream& operator<<(QDataStream &stream, const ZQMatrixExpr<Matrix, E> &expr)
+    {
+        return stream << evaluated(expr);
+    }
+
+}
+
+#endif
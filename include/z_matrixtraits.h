@@ -4,6 +4,7 @@
 #include <cassert>
 #include "z_matrix.h"
 #include "z_offsetmatrix.h"
+#include "z_dynmatrix.h"
 
 namespace z_linalg {
 
@@ -31,10 +32,10 @@ namespace z_linalg {
     //     min_column() <= k <= max_column()
     // * value_type operator()(index_type i, index_type k) const
     //   - returns the value of element i,k
-    // * ZQOffsetMatrix<1, max_row()+1, 1, max_column()+1, value_type> to1N(MatrixType const& A)
-    //   - converts to a matrix class with 1-based indices. Not supported for built-in arrays.
-    // * MatrixType from1N(ZQOffsetMatrix<1, max_row()+1, 1, max_column()+1, value_type> const& A)
-    //   - converts a matrix class with 1-based indices to the original class. Not supported for built-in arrays.
+    //
+    // The generic routines in z_linalg.h copy their arguments into 1-based
+    // ZQDynMatrix working copies with to1N() and back with from1N(), which
+    // only use the functions above.
     //
     // Note that the functions are all inline and simple, so the compiler
     // should completely optimize them away.
@@ -120,6 +121,35 @@ namespace z_linalg {
       { A.set(i, k, x); }
     };
 
+
+    template <typename T>
+    struct matrix_traits<ZQDynMatrix<T>>
+    {
+      typedef int index_type;
+      typedef T value_type;
+      static index_type min_row(const ZQDynMatrix<T> &A)
+      { return A.min_row(); }
+      static index_type max_row(const ZQDynMatrix<T> &A)
+      { return A.max_row(); }
+      static index_type size_row(const ZQDynMatrix<T> &A)
+      { return A.size_row(); }
+      static index_type min_column(const ZQDynMatrix<T> &A)
+      { return A.min_column(); }
+      static index_type max_column(const ZQDynMatrix<T> &A)
+      { return A.max_column(); }
+      static index_type size_column(const ZQDynMatrix<T> &A)
+      { return A.size_column(); }
+      static value_type& element(ZQDynMatrix<T> &A,
+                                 index_type i, index_type k)
+      { return A(i, k); }
+      static value_type element(const ZQDynMatrix<T> &A,
+                                index_type i, index_type k)
+      { return A(i, k); }
+      static void set_element(ZQDynMatrix<T> &A,
+                                index_type i, index_type k, value_type x)
+      { A.set(i, k, x); }
+    };
+
 }
 
 #endif
@@ -8,22 +8,40 @@
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include "z_gemm.h"
+#include "z_matrixexpr.h"
 
 namespace z_linalg {
 
+    template <int minM, int maxM, int minN, int maxN, typename T>
+     class ZQOffsetMatrix;
+
+    template <int minM, int maxM, int minN, int maxN, typename T>
+     struct ZQMatrixExprTraits<ZQOffsetMatrix<minM, maxM, minN, maxN, T> > {
+        typedef T value_type;
+        enum { size = (maxM-minM+1) * (maxN-minN+1) };
+        static inline int index(int row, int column) { return (column-minN) * (maxM-minM+1) + row-minM; }
+    };
+
     /*
-     * Note: C++ doesn't know when it needs to upcast a primitive type in a template,
-     * therefore you must always cast your scaling factors to T when using the operator* and operator/ functions.
-     * In particular, a ZQOffsetMatrix<... qreal> can't be mutiplied or divided by an int and the int needs to be
-     * casted into qreal first.
+     * The element-wise operators +, - and scaling by a factor build lazy
+     * expressions, see z_matrixexpr.h, which are evaluated in one pass
+     * when they are assigned to a ZQOffsetMatrix. Scaling factors are
+     * converted to T, so a ZQOffsetMatrix<... qreal> can be multiplied or
+     * divided by an int.
      */
     template <int minM, int maxM, int minN, int maxN, typename T>
-     class ZQOffsetMatrix {
+     class ZQOffsetMatrix : public ZQMatrixExpr<ZQOffsetMatrix<minM, maxM, minN, maxN, T>, ZQOffsetMatrix<minM, maxM, minN, maxN, T> > {
     public:
 
         inline ZQOffsetMatrix();
         inline ZQOffsetMatrix(const ZQOffsetMatrix<minM, maxM, minN, maxN, T>& other);
         explicit inline ZQOffsetMatrix(const T *values);
+        template <typename E>
+         inline ZQOffsetMatrix(const ZQMatrixExpr<ZQOffsetMatrix<minM, maxM, minN, maxN, T>, E>& expr);
+
+        template <typename E>
+         inline ZQOffsetMatrix<minM, maxM, minN, maxN, T>& operator=(const ZQMatrixExpr<ZQOffsetMatrix<minM, maxM, minN, maxN, T>, E>& expr);
 
         static inline ZQOffsetMatrix<1, maxM-minM+1, 1, maxN-minN+1, T> to1Based(const ZQOffsetMatrix<minM, maxM, minN, maxN, T> &A);
         static inline ZQOffsetMatrix<minM, maxM, minN, maxN, T> from1Based(const ZQOffsetMatrix<1, maxM-minM+1, 1, maxN-minN+1, T> &A);
@@ -48,6 +66,10 @@ namespace z_linalg {
 
         inline ZQOffsetMatrix<minM, maxM, minN, maxN, T>& operator+=(const ZQOffsetMatrix<minM, maxM, minN, maxN, T>& other);
         inline ZQOffsetMatrix<minM, maxM, minN, maxN, T>& operator-=(const ZQOffsetMatrix<minM, maxM, minN, maxN, T>& other);
+        template <typename E>
+         inline ZQOffsetMatrix<minM, maxM, minN, maxN, T>& operator+=(const ZQMatrixExpr<ZQOffsetMatrix<minM, maxM, minN, maxN, T>, E>& expr);
+        template <typename E>
+         inline ZQOffsetMatrix<minM, maxM, minN, maxN, T>& operator-=(const ZQMatrixExpr<ZQOffsetMatrix<minM, maxM, minN, maxN, T>, E>& expr);
         inline ZQOffsetMatrix<minM, maxM, minN, maxN, T>& operator*=(T factor);
         inline ZQOffsetMatrix<minM, maxM, minN, maxN, T>& operator/=(T divisor);
 
@@ -59,6 +81,7 @@ namespace z_linalg {
         inline T *data() { return *m; }
         inline const T *data() const { return *m; }
         inline const T *constData() const { return *m; }
+        inline T coeff(int index) const { return constData()[index]; }
 
         template <int minM_, int maxM_, int minN_, int maxN_>
          friend inline ZQOffsetMatrix<minM_, maxM_, minN_, maxN_, T> submatrix(const ZQOffsetMatrix<minM, maxM, minN, maxN, T>& m1, int row1, int row2, int col1, int col2) {
@@ -79,11 +102,11 @@ namespace z_linalg {
             return A;
         }
 
-       template<maxM_, maxN_>
+        template <int maxM_, int maxN_>
          friend inline ZQOffsetMatrix<minM, maxM_, minN, maxN_, T> concat(ZQOffsetMatrix<minM, maxM, minN, maxN, T> m1, ZQOffsetMatrix<minM, maxM_-maxM, minN, maxN_-maxN, T> m2,
             T fillval=0.0) {
-            assert(M_ > M /* "concatenated row size is less than original row size" */);
-            assert(N_ > N /* "concatenated column size is less than original column size" */);
+            assert(maxM_ > maxM /* "concatenated row size is less than original row size" */);
+            assert(maxN_ > maxN /* "concatenated column size is less than original column size" */);
             ZQOffsetMatrix<minM, maxM_, minN, maxN_, T> A;
             A.fill(fillval);
             for (int row = 0; row <= maxM-minM; ++row) {
@@ -92,7 +115,7 @@ namespace z_linalg {
             }
             for (int row = 0; row <= maxM_-maxM; ++row) {
                 for (int col = 0; col <= maxN_-maxN; ++col)
-                    A.m[col+N][row+M] = m2.m[col][row];
+                    A.m[col+maxN-minN+1][row+maxM-minM+1] = m2.m[col][row];
             }
             return A;
         }
@@ -104,20 +127,8 @@ namespace z_linalg {
 
         QString toString() const;
 
-        template<int minM_, int maxM_, int minN_, int maxN_, typename T_>
-         friend inline ZQOffsetMatrix<minM_, maxM_, minN_, maxN_, T_> operator+(const ZQOffsetMatrix<minM_, maxM_, minN_, maxN_, T_>& m1, const ZQOffsetMatrix<minM_, maxM_, minN_, maxN_, T_>& m2);
-        template<int minM_, int maxM_, int minN_, int maxN_, typename T_>
-         friend inline ZQOffsetMatrix<minM_, maxM_, minN_, maxN_, T_> operator-(const ZQOffsetMatrix<minM_, maxM_, minN_, maxN_, T_>& m1, const ZQOffsetMatrix<minM_, maxM_, minN_, maxN_, T_>& m2);
         template<int minN_, int maxN_, int minM1_, int maxM1_, int minM2_, int maxM2_, typename T_>
          friend inline ZQOffsetMatrix<minM2_, maxM2_, minM1_, maxM1_, T_> operator*(const ZQOffsetMatrix<minM2_, maxM2_, minN_, maxN_, T_>& m1, const ZQOffsetMatrix<minN_, maxN_, minM1_, maxM1_, T_>& m2);
-        template<int minM_, int maxM_, int minN_, int maxN_, typename T_>
-         friend inline ZQOffsetMatrix<minM_, maxM_, minN_, maxN_, T_> operator-(const ZQOffsetMatrix<minM_, maxM_, minN_, maxN_, T_>& matrix);
-        template<int minM_, int maxM_, int minN_, int maxN_, typename T_>
-         friend inline ZQOffsetMatrix<minM_, maxM_, minN_, maxN_, T_> operator*(T_ factor, const ZQOffsetMatrix<minM_, maxM_, minN_, maxN_, T_>& matrix);
-        template<int minM_, int maxM_, int minN_, int maxN_, typename T_>
-         friend inline ZQOffsetMatrix<minM_, maxM_, minN_, maxN_, T_> operator*(const ZQOffsetMatrix<minM_, maxM_, minN_, maxN_, T_>& matrix, T_ factor);
-        template<int minM_, int maxM_, int minN_, int maxN_, typename T_>
-         friend inline ZQOffsetMatrix<minM_, maxM_, minN_, maxN_, T_> operator/(const ZQOffsetMatrix<minM_, maxM_, minN_, maxN_, T_>& matrix, T_ divisor);
 
     };
 
@@ -152,6 +163,23 @@ namespace z_linalg {
                 m[col][row] = values[row * (maxN-minN+1) + col];
     }
 
+    template <int minM, int maxM, int minN, int maxN, typename T>
+    template <typename E>
+     inline ZQOffsetMatrix<minM, maxM, minN, maxN, T>::ZQOffsetMatrix(const ZQMatrixExpr<ZQOffsetMatrix<minM, maxM, minN, maxN, T>, E>& expr)
+    {
+        for (int i = 0; i < (maxM-minM+1) * (maxN-minN+1); ++i)
+            data()[i] = expr.derived().coeff(i);
+    }
+
+    template <int minM, int maxM, int minN, int maxN, typename T>
+    template <typename E>
+     inline ZQOffsetMatrix<minM, maxM, minN, maxN, T>& ZQOffsetMatrix<minM, maxM, minN, maxN, T>::operator=(const ZQMatrixExpr<ZQOffsetMatrix<minM, maxM, minN, maxN, T>, E>& expr)
+    {
+        for (int i = 0; i < (maxM-minM+1) * (maxN-minN+1); ++i)
+            data()[i] = expr.derived().coeff(i);
+        return *this;
+    }
+
     template <int minM, int maxM, int minN, int maxN, typename T>
      inline ZQOffsetMatrix<1, maxM-minM+1, 1, maxN-minN+1, T> ZQOffsetMatrix<minM, maxM, minN, maxN, T>::to1Based(const ZQOffsetMatrix<minM, maxM, minN, maxN, T> &A)
     {
@@ -252,97 +280,57 @@ namespace z_linalg {
         return result;
     }
 
-    template <int minM, int maxM, int minN, int maxN, typename T>
-     inline ZQOffsetMatrix<minM, maxM, minN, maxN, T> operator+(const ZQOffsetMatrix<minM, maxM, minN, maxN, T>& m1, const ZQOffsetMatrix<minM, maxM, minN, maxN, T>& m2)
-    {
-        ZQOffsetMatrix<minM, maxM, minN, maxN, T> result(1);
-        for (int row = 0; row <= maxM-minM; ++row)
-            for (int col = 0; col <= maxN-minN; ++col)
-                result.m[col][row] = m1.m[col][row] + m2.m[col][row];
-        return result;
-    }
-
-    template <int minM, int maxM, int minN, int maxN, typename T>
-     inline ZQOffsetMatrix<minM, maxM, minN, maxN, T> operator-(const ZQOffsetMatrix<minM, maxM, minN, maxN, T>& m1, const ZQOffsetMatrix<minM, maxM, minN, maxN, T>& m2)
-    {
-        ZQOffsetMatrix<minM, maxM, minN, maxN, T> result(1);
-        for (int row = 0; row <= maxM-minM; ++row)
-            for (int col = 0; col <= maxN-minN; ++col)
-                result.m[col][row] = m1.m[col][row] - m2.m[col][row];
-        return result;
-    }
-
+    // A float or double product of GemmThreshold multiply-adds or more calls
+    // z_linalg::gemm() from zglshapes2d, so callers must link that library.
     template <int minN, int maxN, int minM1, int maxM1, int minM2, int maxM2, typename T>
      inline ZQOffsetMatrix<minM2, maxM2, minM1, maxM1, T> operator*(const ZQOffsetMatrix<minM2, maxM2, minN, maxN, T>& m1, const ZQOffsetMatrix<minN, maxN, minM1, maxM1, T>& m2)
     {
         ZQOffsetMatrix<minM2, maxM2, minM1, maxM1, T> result(1);
-        for (int row = 0; row <= maxM2-minM2; ++row) {
-            for (int col = 0; col <= maxM1-minM1; ++col) {
-                T sum(0.0f);
-                for (int j = 0; j <= maxN-minN; ++j)
-                    sum += m1.m[j][row] * m2.m[col][j];
-                result.m[col][row] = sum;
-            }
-        }
+        ZQFixedProduct<maxM2-minM2+1, maxM1-minM1+1, maxN-minN+1, T>::run(*m1.m, *m2.m, *result.m);
         return result;
     }
 
-    template <int minM, int maxM, int minN, int maxN, typename T>
-     inline ZQOffsetMatrix<minM, maxM, minN, maxN, T> operator-(const ZQOffsetMatrix<minM, maxM, minN, maxN, T>& matrix)
+    // Products with an element-wise expression on either side evaluate it first.
+    template <int minN, int maxN, int minM1, int maxM1, int minM2, int maxM2, typename T, typename L, typename R>
+     inline ZQOffsetMatrix<minM2, maxM2, minM1, maxM1, T> operator*(const ZQMatrixExpr<ZQOffsetMatrix<minM2, maxM2, minN, maxN, T>, L>& m1, const ZQMatrixExpr<ZQOffsetMatrix<minN, maxN, minM1, maxM1, T>, R>& m2)
     {
-        ZQOffsetMatrix<minM, maxM, minN, maxN, T> result(1);
-        for (int row = 0; row <= maxM-minM; ++row)
-            for (int col = 0; col <= maxN-minN; ++col)
-                result.m[col][row] = -matrix.m[col][row];
-        return result;
+        return evaluated(m1) * evaluated(m2);
     }
 
-    template <int minM, int maxM, int minN, int maxN, typename T>
-     inline ZQOffsetMatrix<minM, maxM, minN, maxN, T> operator*(T factor, const ZQOffsetMatrix<minM, maxM, minN, maxN, T>& matrix)
-    {
-        ZQOffsetMatrix<minM, maxM, minN, maxN, T> result(1);
-        for (int row = 0; row <= maxM-minM; ++row)
-            for (int col = 0; col <= maxN-minN; ++col)
-                result.m[col][row] = matrix.m[col][row] * factor;
-        return result;
-    }
 
     template <int minM, int maxM, int minN, int maxN, typename T>
-     inline ZQOffsetMatrix<minM, maxM, minN, maxN, T> operator*(const ZQOffsetMatrix<minM, maxM, minN, maxN, T>& matrix, T factor)
+     inline ZQOffsetMatrix<minM, maxM, minN, maxN, T>& ZQOffsetMatrix<minM, maxM, minN, maxN, T>::operator+=(const ZQOffsetMatrix<minM, maxM, minN, maxN, T>& other)
     {
-        ZQOffsetMatrix<minM, maxM, minN, maxN, T> result(1);
         for (int row = 0; row <= maxM-minM; ++row)
             for (int col = 0; col <= maxN-minN; ++col)
-                result.m[col][row] = matrix.m[col][row] * factor;
-        return result;
+                m[col][row] += other.m[col][row];
+        return *this;
     }
 
     template <int minM, int maxM, int minN, int maxN, typename T>
-     inline ZQOffsetMatrix<minM, maxM, minN, maxN, T>operator/(const ZQOffsetMatrix<minM, maxM, minN, maxN, T>& matrix, T divisor)
+     inline ZQOffsetMatrix<minM, maxM, minN, maxN, T>& ZQOffsetMatrix<minM, maxM, minN, maxN, T>::operator-=(const ZQOffsetMatrix<minM, maxM, minN, maxN, T>& other)
     {
-        ZQOffsetMatrix<minM, maxM, minN, maxN, T> result(1);
         for (int row = 0; row <= maxM-minM; ++row)
             for (int col = 0; col <= maxN-minN; ++col)
-                result.m[col][row] = matrix.m[col][row] / divisor;
-        return result;
+                m[col][row] -= other.m[col][row];
+        return *this;
     }
-    
 
     template <int minM, int maxM, int minN, int maxN, typename T>
-     inline ZQOffsetMatrix<minM, maxM, minN, maxN, T>& ZQOffsetMatrix<minM, maxM, minN, maxN, T>::operator+=(const ZQOffsetMatrix<minM, maxM, minN, maxN, T>& other)
+    template <typename E>
+     inline ZQOffsetMatrix<minM, maxM, minN, maxN, T>& ZQOffsetMatrix<minM, maxM, minN, maxN, T>::operator+=(const ZQMatrixExpr<ZQOffsetMatrix<minM, maxM, minN, maxN, T>, E>& expr)
     {
-        for (int row = 0; row <= maxM-minM; ++row)
-            for (int col = 0; col <= maxN-minN; ++col)
-                m[col][row] += other.m[col][row];
+        for (int i = 0; i < (maxM-minM+1) * (maxN-minN+1); ++i)
+            data()[i] += expr.derived().coeff(i);
         return *this;
     }
 
     template <int minM, int maxM, int minN, int maxN, typename T>
-     inline ZQOffsetMatrix<minM, maxM, minN, maxN, T>& ZQOffsetMatrix<minM, maxM, minN, maxN, T>::operator-=(const ZQOffsetMatrix<minM, maxM, minN, maxN, T>& other)
+    template <typename E>
+     inline ZQOffsetMatrix<minM, maxM, minN, maxN, T>& ZQOffsetMatrix<minM, maxM, minN, maxN, T>::operator-=(const ZQMatrixExpr<ZQOffsetMatrix<minM, maxM, minN, maxN, T>, E>& expr)
     {
-        for (int row = 0; row <= maxM-minM; ++row)
-            for (int col = 0; col <= maxN-minN; ++col)
-                m[col][row] -= other.m[col][row];
+        for (int i = 0; i < (maxM-minM+1) * (maxN-minN+1); ++i)
+            data()[i] -= expr.derived().coeff(i);
         return *this;
     }
 
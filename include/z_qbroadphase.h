@@ -0,0 +1,64 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#ifndef Z_QBROADPHASE_H
+#define Z_QBROADPHASE_H
+
+#include <memory>
+
+#include <QtWidgets>
+#include <QVector>
+#include <QPair>
+#include "z_qpreparedshape.h"
+
+namespace z_qtshapes {
+
+    class ZQBroadPhase {
+    public:
+        typedef int Id;
+        typedef QPair<Id, Id> Pair;
+
+        ZQBroadPhase();
+        ~ZQBroadPhase();
+        ZQBroadPhase(ZQBroadPhase &&other);
+        ZQBroadPhase &operator=(ZQBroadPhase &&other) noexcept;
+
+        Id insert(const ZQPreparedShape &shape);
+        bool update(Id id, const ZQPreparedShape &shape);
+        bool remove(Id id);
+        void clear();
+
+        bool contains(Id id) const noexcept;
+        const ZQPreparedShape &shape(Id id) const noexcept;
+        int size() const noexcept;
+        inline bool isEmpty() const noexcept { return size() == 0; }
+
+        QVector<Pair> candidatePairs();
+        QVector<Pair> intersectingPairs();
+
+        template <typename InputIterator>
+        static QVector<Pair> intersectingPairs(InputIterator first, InputIterator last);
+
+    private:
+        Q_DISABLE_COPY(ZQBroadPhase)
+
+        class Private;
+        std::unique_ptr<Private> d;
+    };
+
+
+    /*****************************************************************************
+      ZQBroadPhase template members
+     *****************************************************************************/
+
+    template <typename InputIterator>
+    QVector<ZQBroadPhase::Pair> ZQBroadPhase::intersectingPairs(InputIterator first, InputIterator last)
+    {
+        ZQBroadPhase broadPhase;
+        for (; first != last; ++first)
+            broadPhase.insert(*first);
+        return broadPhase.intersectingPairs();
+    }
+
+}
+
+#endif
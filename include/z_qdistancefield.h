@@ -0,0 +1,38 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#ifndef Z_QDISTANCEFIELD_H
+#define Z_QDISTANCEFIELD_H
+
+#include <QtWidgets>
+#include <QThreadPool>
+#include "z_qpreparedshape.h"
+#include "z_qpointkernels.h"
+
+namespace z_qtshapes {
+
+    class ZQDistanceField {
+    public:
+        ZQDistanceField() noexcept;
+
+        void setTransform(const QMatrix3x3 &gridToShape) noexcept;
+        QMatrix3x3 transform() const noexcept;
+        static QMatrix3x3 gridTransform(const QRectF &area, int width, int height) noexcept;
+
+        inline void setThreadPool(QThreadPool *pool) noexcept { tp = pool; }
+        inline QThreadPool *threadPool() const noexcept { return tp; }
+        inline void setSimdLevel(ZQSimdLevel level) noexcept { simd = level; }
+        inline ZQSimdLevel simdLevel() const noexcept { return simd; }
+
+        void generate(const ZQPreparedShape &shape, float *field, int width, int height, int floatsPerLine) const;
+        void generate(const ZQPreparedShape *shapes, int count, float *field, int width, int height,
+                int floatsPerLine) const;
+
+    private:
+        qreal m[2][3];
+        QThreadPool *tp;
+        ZQSimdLevel simd;
+    };
+
+}
+
+#endif
@@ -51,6 +51,8 @@
 
 namespace z_qtshapes {
 
+    class ZQPreparedEllipseF;
+
     /*
      * It has been found that an ellipse can be made from the same dimension parameters
      * as rectangles. They can be fully described by coordinates of a rectangle.
@@ -179,17 +181,24 @@ namespace z_qtshapes {
         QPainterPath operator&(const ZQEllipse &r) const noexcept;
 
         bool contains(const ZQEllipse &r, bool proper=false) const noexcept;
+        bool contains(const ZQPreparedEllipseF &r, bool proper=false) const noexcept;
         bool contains(const QPoint &p) const noexcept;
         inline bool contains(int x, int y) const noexcept;
         inline QPainterPath united(const ZQEllipse &other) const noexcept;
         inline QPainterPath intersected(const ZQEllipse &other) const noexcept;
         bool intersects(const ZQEllipse &r) const noexcept;
+        bool intersects(const ZQPreparedEllipseF &r) const noexcept;
+        QVector<QPointF> intersectionPoints(const ZQEllipse &r) const noexcept;
 
         inline ZQEllipse marginsAdded(const QMargins &margins) const noexcept;
         inline ZQEllipse marginsRemoved(const QMargins &margins) const noexcept;
         inline ZQEllipse &operator+=(const QMargins &margins) noexcept;
         inline ZQEllipse &operator-=(const QMargins &margins) noexcept;
 
+        ZQPreparedEllipseF prepared() const noexcept;
+        QRect boundingRect() const noexcept;
+        QRectF boundingRectF() const noexcept;
+
         QPainterPath toPath() const noexcept;
         QPainterPath toPath(const QMatrix3x3 &mat, const QPointF &ref) const noexcept;
         QString toString() const noexcept;
@@ -837,11 +846,14 @@ namespace z_qtshapes {
         QPainterPath operator&(const ZQEllipseF &r) const noexcept;
 
         bool contains(const ZQEllipseF &r, bool proper=false) const noexcept;
+        bool contains(const ZQPreparedEllipseF &r, bool proper=false) const noexcept;
         bool contains(const QPointF &p) const noexcept;
         inline bool contains(qreal x, qreal y) const noexcept;
         inline QPainterPath united(const ZQEllipseF &other) const noexcept;
         inline QPainterPath intersected(const ZQEllipseF &other) const noexcept;
         bool intersects(const ZQEllipseF &r) const noexcept;
+        bool intersects(const ZQPreparedEllipseF &r) const noexcept;
+        QVector<QPointF> intersectionPoints(const ZQEllipseF &r) const noexcept;
 
         inline ZQEllipseF marginsAdded(const QMarginsF &margins) const noexcept;
         inline ZQEllipseF marginsRemoved(const QMarginsF &margins) const noexcept;
@@ -851,6 +863,13 @@ namespace z_qtshapes {
         inline ZQEllipse toEllipse() const noexcept;
         ZQEllipse toAlignedEllipse() const noexcept;
 
+        ZQPreparedEllipseF prepared() const noexcept;
+        QRectF boundingRect() const noexcept;
+        int segmentCount(qreal tolerance) const noexcept;
+        inline int tessellationVertexCount(qreal tolerance) const noexcept { return segmentCount(tolerance) + 1; }
+        inline int tessellationIndexCount(qreal tolerance) const noexcept { return 3 * segmentCount(tolerance); }
+        void tessellate(qreal tolerance, float *vertices, quint32 *indices, quint32 baseVertex = 0) const noexcept;
+
         QPainterPath toPath() const noexcept;
         QPainterPath toPath(const QMatrix3x3 &mat, const QPointF &ref) const noexcept;
         QString toString() const noexcept;
@@ -1298,6 +1317,53 @@ namespace z_qtshapes {
     QDebug operator<<(QDebug, const ZQEllipseF &);
     #endif
 
+    /*****************************************************************************
+      ZQPreparedEllipseF
+     *****************************************************************************/
+
+    class ZQPreparedEllipseF {
+    public:
+        constexpr ZQPreparedEllipseF() noexcept : cx(0.), cy(0.), rx(0.), ry(0.), ca(1.), sa(0.), a(0.),
+            bx1(0.), by1(0.), bx2(0.), by2(0.) {}
+        ZQPreparedEllipseF(const QPointF &center, qreal radiusX, qreal radiusY, qreal angle) noexcept;
+        ZQPreparedEllipseF(const QPointF &center, qreal radiusX, qreal radiusY, qreal angle,
+                qreal cosAngle, qreal sinAngle) noexcept;
+
+        constexpr inline QPointF center() const noexcept { return QPointF(cx, cy); }
+        constexpr inline qreal radiusX() const noexcept { return rx; }
+        constexpr inline qreal radiusY() const noexcept { return ry; }
+        constexpr inline qreal angle() const noexcept { return a; }
+        constexpr inline qreal cosAngle() const noexcept { return ca; }
+        constexpr inline qreal sinAngle() const noexcept { return sa; }
+        constexpr inline QRectF boundingRect() const noexcept { return QRectF(bx1, by1, bx2 - bx1, by2 - by1); }
+
+        bool contains(const QPointF &p) const noexcept;
+        bool contains(const ZQPreparedEllipseF &r, bool proper=false) const noexcept;
+        bool intersects(const ZQPreparedEllipseF &r) const noexcept;
+        int intersectionPoints(const ZQPreparedEllipseF &r, QPointF *points) const noexcept;
+
+        QPainterPath toPath() const noexcept;
+        QPainterPath toPath(const QMatrix3x3 &mat, const QPointF &ref) const noexcept;
+
+        int segmentCount(qreal tolerance) const noexcept;
+        inline int tessellationVertexCount(qreal tolerance) const noexcept { return segmentCount(tolerance) + 1; }
+        inline int tessellationIndexCount(qreal tolerance) const noexcept { return 3 * segmentCount(tolerance); }
+        void tessellate(qreal tolerance, float *vertices, quint32 *indices, quint32 baseVertex = 0) const noexcept;
+
+    private:
+        qreal cx;
+        qreal cy;
+        qreal rx;
+        qreal ry;
+        qreal ca;
+        qreal sa;
+        qreal a;
+        qreal bx1;
+        qreal by1;
+        qreal bx2;
+        qreal by2;
+    };
+
 }
 
 #endif
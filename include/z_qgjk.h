@@ -0,0 +1,516 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#ifndef Z_QGJK_H
+#define Z_QGJK_H
+
+#include <QtWidgets>
+#include <limits>
+#include "z_qpreparedshape.h"
+
+namespace z_qtshapes {
+
+    /*
+     * Support mappings: the point of a convex shape farthest along dir.
+     * Ties may return any of the farthest points. They are all a convex
+     * distance query needs to know about a shape, so points, segments and
+     * the prepared shapes can be mixed freely below.
+     */
+    inline QPointF supportPoint(const QPointF &p, const QPointF &) noexcept
+    {
+        return p;
+    }
+
+    inline QPointF supportPoint(const QLineF &l, const QPointF &dir) noexcept
+    {
+        return QPointF::dotProduct(l.p2() - l.p1(), dir) > 0 ? l.p2() : l.p1();
+    }
+
+    inline QPointF supportPoint(const ZQPreparedRectF &r, const QPointF &dir) noexcept
+    {
+        const QPointF u = r.xAxis() * r.halfWidth();
+        const QPointF v = r.yAxis() * r.halfHeight();
+        return r.center() + (QPointF::dotProduct(u, dir) >= 0 ? u : -u) + (QPointF::dotProduct(v, dir) >= 0 ? v : -v);
+    }
+
+    inline QPointF supportPoint(const ZQPreparedTriF &t, const QPointF &dir) noexcept
+    {
+        const qreal d1 = QPointF::dotProduct(t.first(), dir);
+        const qreal d2 = QPointF::dotProduct(t.second(), dir);
+        const qreal d3 = QPointF::dotProduct(t.third(), dir);
+        if (d1 >= d2)
+            return d1 >= d3 ? t.first() : t.third();
+        return d2 >= d3 ? t.second() : t.third();
+    }
+
+    inline QPointF supportPoint(const ZQPreparedEllipseF &e, const QPointF &dir) noexcept
+    {
+        // dir in the ellipse's own frame, where the farthest point of the
+        // ellipse is (rx^2 u, ry^2 v) normalised back onto the outline.
+        const qreal c = e.cosAngle(), s = e.sinAngle();
+        const qreal u = e.radiusX() * (c * dir.x() - s * dir.y());
+        const qreal v = e.radiusY() * (s * dir.x() + c * dir.y());
+        const qreal k = qSqrt(u * u + v * v);
+        if (k == 0)
+            return e.center();
+        const qreal lx = e.radiusX() * u / k, ly = e.radiusY() * v / k;
+        return QPointF(e.center().x() + c * lx + s * ly, e.center().y() - s * lx + c * ly);
+    }
+
+    inline QPointF supportPoint(const ZQPreparedShape &shape, const QPointF &dir) noexcept
+    {
+        switch (shape.type()) {
+        case ZQPreparedShape::RectShape:
+            return supportPoint(shape.rect(), dir);
+        case ZQPreparedShape::TriShape:
+            return supportPoint(shape.tri(), dir);
+        case ZQPreparedShape::EllipseShape:
+            return supportPoint(shape.ellipse(), dir);
+        case ZQPreparedShape::LineShape:
+            return supportPoint(shape.line(), dir);
+        default:
+            return QPointF();
+        }
+    }
+
+    /*
+     * Maps a shape class to the type its support mapping works on. Shapes
+     * with an angle are prepared once per query, so the sines and cosines
+     * are not recomputed at every support call; integer shapes go through
+     * their floating point counterparts.
+     */
+    template <typename Shape>
+    struct ZQConvexTraits {
+        typedef Shape Prepared;
+        static inline const Shape &prepare(const Shape &shape) noexcept { return shape; }
+    };
+
+    template <>
+    struct ZQConvexTraits<QPoint> {
+        typedef QPointF Prepared;
+        static inline Prepared prepare(const QPoint &p) noexcept { return QPointF(p); }
+    };
+
+    template <>
+    struct ZQConvexTraits<ZQRectF> {
+        typedef ZQPreparedRectF Prepared;
+        static inline Prepared prepare(const ZQRectF &r) noexcept { return r.prepared(); }
+    };
+
+    template <>
+    struct ZQConvexTraits<ZQRect> {
+        typedef ZQPreparedRectF Prepared;
+        static inline Prepared prepare(const ZQRect &r) noexcept { return r.prepared(); }
+    };
+
+    template <>
+    struct ZQConvexTraits<ZQTriF> {
+        typedef ZQPreparedTriF Prepared;
+        static inline Prepared prepare(const ZQTriF &t) noexcept { return t.prepared(); }
+    };
+
+    template <>
+    struct ZQConvexTraits<ZQTri> {
+        typedef ZQPreparedTriF Prepared;
+        static inline Prepared prepare(const ZQTri &t) noexcept { return t.prepared(); }
+    };
+
+    template <>
+    struct ZQConvexTraits<ZQEllipseF> {
+        typedef ZQPreparedEllipseF Prepared;
+        static inline Prepared prepare(const ZQEllipseF &e) noexcept { return e.prepared(); }
+    };
+
+    template <>
+    struct ZQConvexTraits<ZQEllipse> {
+        typedef ZQPreparedEllipseF Prepared;
+        static inline Prepared prepare(const ZQEllipse &e) noexcept { return e.prepared(); }
+    };
+
+    template <>
+    struct ZQConvexTraits<ZQLineF> {
+        typedef QLineF Prepared;
+        static inline Prepared prepare(const ZQLineF &l) noexcept { return ZQPreparedShape(l).line(); }
+    };
+
+    template <>
+    struct ZQConvexTraits<ZQLine> {
+        typedef QLineF Prepared;
+        static inline Prepared prepare(const ZQLine &l) noexcept { return ZQPreparedShape(l).line(); }
+    };
+
+    /*
+     * Result of closestPoints(). When the shapes overlap, distance is zero
+     * and pointA and pointB are both a point common to the two shapes.
+     */
+    struct ZQClosestPoints {
+        qreal distance;
+        QPointF pointA;
+        QPointF pointB;
+        int iterations;
+
+        inline bool overlapping() const noexcept { return distance == 0; }
+    };
+
+    /*
+     * Result of penetration(). Moving the second shape by depth * normal
+     * makes the shapes touch: for overlapping shapes depth is the smallest
+     * such translation, for separate ones it is minus their distance. The
+     * normal points from the first shape towards the second, and pointA
+     * and pointB are the witness points on each shape, with
+     * pointA - pointB == depth * normal.
+     */
+    struct ZQPenetration {
+        bool overlapping;
+        qreal depth;
+        QPointF normal;
+        QPointF pointA;
+        QPointF pointB;
+    };
+
+    namespace gjk_detail {
+
+        // A point of the Minkowski difference A - B with the support points
+        // of A and B it came from.
+        struct Vertex {
+            QPointF w;
+            QPointF a;
+            QPointF b;
+        };
+
+        struct Simplex {
+            Vertex v[3];
+            qreal l[3];
+            int n;
+        };
+
+        template <typename A, typename B>
+        inline Vertex supportVertex(const A &a, const B &b, const QPointF &dir) noexcept
+        {
+            Vertex v;
+            v.a = supportPoint(a, dir);
+            v.b = supportPoint(b, -dir);
+            v.w = v.a - v.b;
+            return v;
+        }
+
+        inline qreal cross(const QPointF &a, const QPointF &b) noexcept
+        {
+            return a.x() * b.y() - a.y() * b.x();
+        }
+
+        inline void keep(Simplex &s, int i) noexcept
+        {
+            s.v[0] = s.v[i];
+            s.l[0] = 1;
+            s.n = 1;
+        }
+
+        inline void keep(Simplex &s, int i, int j, qreal t) noexcept
+        {
+            const Vertex vi = s.v[i], vj = s.v[j];
+            s.v[0] = vi;
+            s.v[1] = vj;
+            s.l[0] = 1 - t;
+            s.l[1] = t;
+            s.n = 2;
+        }
+
+        // Closest point of segment s.v[i] s.v[j] to the origin, reducing s to
+        // the vertices that span it.
+        inline void closestOnSegment(Simplex &s, int i, int j) noexcept
+        {
+            const QPointF ab = s.v[j].w - s.v[i].w;
+            const qreal len2 = QPointF::dotProduct(ab, ab);
+            const qreal t = len2 > 0 ? -QPointF::dotProduct(s.v[i].w, ab) / len2 : 0;
+            if (t <= 0)
+                keep(s, i);
+            else if (t >= 1)
+                keep(s, j);
+            else
+                keep(s, i, j, t);
+        }
+
+        /*
+         * Reduces s to the smallest face holding the point of its convex
+         * hull closest to the origin and sets its barycentric weights.
+         * Returns true when the origin lies inside a triangle, in which case
+         * all three vertices are kept. The triangle case follows the Voronoi
+         * region tests of Ericson's closest point on triangle.
+         */
+        inline bool reduce(Simplex &s) noexcept
+        {
+            if (s.n == 1) {
+                s.l[0] = 1;
+                return false;
+            }
+            if (s.n == 2) {
+                closestOnSegment(s, 0, 1);
+                return false;
+            }
+
+            const QPointF a = s.v[0].w, b = s.v[1].w, c = s.v[2].w;
+            const QPointF ab = b - a, ac = c - a;
+            const qreal d1 = -QPointF::dotProduct(ab, a), d2 = -QPointF::dotProduct(ac, a);
+            if (d1 <= 0 && d2 <= 0) {
+                keep(s, 0);
+                return false;
+            }
+            const qreal d3 = -QPointF::dotProduct(ab, b), d4 = -QPointF::dotProduct(ac, b);
+            if (d3 >= 0 && d4 <= d3) {
+                keep(s, 1);
+                return false;
+            }
+            const qreal vc = d1 * d4 - d3 * d2;
+            if (vc <= 0 && d1 >= 0 && d3 <= 0) {
+                keep(s, 0, 1, d1 / (d1 - d3));
+                return false;
+            }
+            const qreal d5 = -QPointF::dotProduct(ab, c), d6 = -QPointF::dotProduct(ac, c);
+            if (d6 >= 0 && d5 <= d6) {
+                keep(s, 2);
+                return false;
+            }
+            const qreal vb = d5 * d2 - d1 * d6;
+            if (vb <= 0 && d2 >= 0 && d6 <= 0) {
+                keep(s, 0, 2, d2 / (d2 - d6));
+                return false;
+            }
+            const qreal va = d3 * d6 - d5 * d4;
+            if (va <= 0 && d4 - d3 >= 0 && d5 - d6 >= 0) {
+                keep(s, 1, 2, (d4 - d3) / ((d4 - d3) + (d5 - d6)));
+                return false;
+            }
+
+            const qreal sum = va + vb + vc;
+            if (sum <= 0) {
+                // A flat triangle around the origin: its longest edge spans it.
+                const qreal lab = QPointF::dotProduct(ab, ab), lac = QPointF::dotProduct(ac, ac);
+                const QPointF bc = c - b;
+                const qreal lbc = QPointF::dotProduct(bc, bc);
+                if (lab >= lac && lab >= lbc)
+                    closestOnSegment(s, 0, 1);
+                else if (lac >= lbc)
+                    closestOnSegment(s, 0, 2);
+                else
+                    closestOnSegment(s, 1, 2);
+                return false;
+            }
+            s.l[0] = va / sum;
+            s.l[1] = vb / sum;
+            s.l[2] = vc / sum;
+            return true;
+        }
+
+        inline QPointF combine(const Simplex &s, QPointF Vertex::*p) noexcept
+        {
+            QPointF r;
+            for (int i = 0; i < s.n; ++i)
+                r += s.v[i].*p * s.l[i];
+            return r;
+        }
+
+        /*
+         * GJK distance: walks a simplex of at most three points of A - B
+         * towards the origin, stopping once the distance to the current
+         * point and the lower bound from the last support point agree to
+         * within tolerance. The final simplex is left in s for EPA.
+         */
+        template <typename A, typename B>
+        ZQClosestPoints gjk(const A &a, const B &b, Simplex &s, qreal tolerance, int maxIterations) noexcept
+        {
+            s.v[0] = supportVertex(a, b, QPointF(1, 0));
+            s.l[0] = 1;
+            s.n = 1;
+            QPointF v = s.v[0].w;
+            bool enclosed = false;
+            int it = 0;
+            while (it < maxIterations) {
+                const qreal vv = QPointF::dotProduct(v, v);
+                if (vv <= tolerance * tolerance)
+                    break;
+                ++it;
+                const Vertex w = supportVertex(a, b, -v);
+                if (vv - QPointF::dotProduct(v, w.w) <= tolerance * qSqrt(vv))
+                    break;
+                bool seen = false;
+                for (int i = 0; i < s.n; ++i)
+                    seen = seen || s.v[i].w == w.w;
+                if (seen)
+                    break;
+
+                s.v[s.n++] = w;
+                enclosed = reduce(s);
+                const QPointF next = combine(s, &Vertex::w);
+                if (enclosed || QPointF::dotProduct(next, next) >= vv) {
+                    v = next;
+                    break;
+                }
+                v = next;
+            }
+
+            ZQClosestPoints r;
+            r.iterations = it;
+            r.pointA = combine(s, &Vertex::a);
+            if (enclosed || QPointF::dotProduct(v, v) <= tolerance * tolerance) {
+                r.distance = 0;
+                r.pointB = r.pointA;
+            } else {
+                r.distance = qSqrt(QPointF::dotProduct(v, v));
+                r.pointB = combine(s, &Vertex::b);
+            }
+            return r;
+        }
+
+        /*
+         * EPA: grows a counterclockwise polygon inside A - B, which holds
+         * the origin, by pushing out its edge nearest the origin until the
+         * support point along that edge's normal adds less than tolerance.
+         * The polygon lives on the stack and stops growing when full.
+         */
+        template <typename A, typename B>
+        ZQPenetration epa(const A &a, const B &b, const Simplex &s, qreal tolerance, int maxIterations) noexcept
+        {
+            const int capacity = 64;
+            Vertex poly[capacity];
+            int n = s.n;
+            for (int i = 0; i < n; ++i)
+                poly[i] = s.v[i];
+
+            // Touching shapes leave a point or a segment; open it into a
+            // triangle with support points across it.
+            static const QPointF axes[4] = { QPointF(1, 0), QPointF(-1, 0), QPointF(0, 1), QPointF(0, -1) };
+            for (int i = 0; n == 1 && i < 4; ++i) {
+                poly[1] = supportVertex(a, b, axes[i]);
+                const QPointF d = poly[1].w - poly[0].w;
+                if (QPointF::dotProduct(d, d) > tolerance * tolerance)
+                    n = 2;
+            }
+            if (n == 2) {
+                const QPointF e = poly[1].w - poly[0].w;
+                const QPointF perp(-e.y(), e.x());
+                poly[2] = supportVertex(a, b, perp);
+                if (qAbs(cross(e, poly[2].w - poly[0].w)) <= tolerance * qSqrt(QPointF::dotProduct(e, e)))
+                    poly[2] = supportVertex(a, b, -perp);
+                n = 3;
+            }
+
+            ZQPenetration r;
+            r.overlapping = true;
+            r.depth = 0;
+            r.pointA = r.pointB = combine(s, &Vertex::a);
+            if (n < 3) {
+                r.normal = QPointF(1, 0);
+                return r;
+            }
+            const qreal area = cross(poly[1].w - poly[0].w, poly[2].w - poly[0].w);
+            if (qAbs(area) <= tolerance * tolerance) {
+                // A - B is flat, so the shapes only touch along a line.
+                const QPointF e = poly[1].w - poly[0].w;
+                const qreal len = qSqrt(QPointF::dotProduct(e, e));
+                r.normal = len > 0 ? QPointF(e.y() / len, -e.x() / len) : QPointF(1, 0);
+                return r;
+            }
+            if (area < 0)
+                std::swap(poly[1], poly[2]);
+
+            int best = 0;
+            qreal dist = 0;
+            QPointF normal;
+            for (int it = 0; it < maxIterations; ++it) {
+                best = -1;
+                dist = std::numeric_limits<qreal>::infinity();
+                for (int i = 0; i < n; ++i) {
+                    const QPointF e = poly[(i + 1) % n].w - poly[i].w;
+                    const qreal len = qSqrt(QPointF::dotProduct(e, e));
+                    if (len <= 0)
+                        continue;
+                    const QPointF nrm(e.y() / len, -e.x() / len);
+                    const qreal d = QPointF::dotProduct(nrm, poly[i].w);
+                    if (d < dist) {
+                        dist = d;
+                        best = i;
+                        normal = nrm;
+                    }
+                }
+                if (best < 0)
+                    break;
+                const Vertex p = supportVertex(a, b, normal);
+                if (QPointF::dotProduct(normal, p.w) - dist <= tolerance || n == capacity)
+                    break;
+                for (int i = n; i > best + 1; --i)
+                    poly[i] = poly[i - 1];
+                poly[best + 1] = p;
+                ++n;
+            }
+            if (best < 0) {
+                r.normal = QPointF(1, 0);
+                return r;
+            }
+
+            const Vertex &p = poly[best], &q = poly[(best + 1) % n];
+            const QPointF e = q.w - p.w;
+            const qreal len2 = QPointF::dotProduct(e, e);
+            const qreal t = qBound(qreal(0), len2 > 0 ? -QPointF::dotProduct(p.w, e) / len2 : 0, qreal(1));
+            r.depth = qMax(dist, qreal(0));
+            r.normal = normal;
+            r.pointA = p.a + (q.a - p.a) * t;
+            r.pointB = p.b + (q.b - p.b) * t;
+            return r;
+        }
+
+    }
+
+    /*
+     * Closest points between two convex shapes by GJK. Either shape may
+     * be any ZQ shape class, a prepared shape, a QLineF or a point; the
+     * support mappings are inlined for each pair of types and nothing is
+     * allocated. Ellipses are approached from outside, so tolerance bounds
+     * how far the returned distance may exceed the true one.
+     */
+    template <typename A, typename B>
+    ZQClosestPoints closestPoints(const A &a, const B &b, qreal tolerance = 1e-9, int maxIterations = 64) noexcept
+    {
+        const typename ZQConvexTraits<A>::Prepared &pa = ZQConvexTraits<A>::prepare(a);
+        const typename ZQConvexTraits<B>::Prepared &pb = ZQConvexTraits<B>::prepare(b);
+        gjk_detail::Simplex s;
+        return gjk_detail::gjk(pa, pb, s, tolerance, maxIterations);
+    }
+
+    /*
+     * Euclidean distance between two convex shapes, zero when they
+     * overlap or touch.
+     */
+    template <typename A, typename B>
+    inline qreal distance(const A &a, const B &b, qreal tolerance = 1e-9) noexcept
+    {
+        return closestPoints(a, b, tolerance).distance;
+    }
+
+    /*
+     * Penetration depth and direction of two convex shapes: GJK first, and
+     * for overlapping shapes EPA on the simplex it ends with. Separate
+     * shapes report their distance as a negative depth, so the result
+     * always says how far the second shape is from just touching the first.
+     */
+    template <typename A, typename B>
+    ZQPenetration penetration(const A &a, const B &b, qreal tolerance = 1e-9, int maxIterations = 64) noexcept
+    {
+        const typename ZQConvexTraits<A>::Prepared &pa = ZQConvexTraits<A>::prepare(a);
+        const typename ZQConvexTraits<B>::Prepared &pb = ZQConvexTraits<B>::prepare(b);
+        gjk_detail::Simplex s;
+        const ZQClosestPoints c = gjk_detail::gjk(pa, pb, s, tolerance, maxIterations);
+        if (c.overlapping())
+            return gjk_detail::epa(pa, pb, s, tolerance, maxIterations);
+
+        ZQPenetration r;
+        r.overlapping = false;
+        r.depth = -c.distance;
+        r.normal = (c.pointB - c.pointA) / c.distance;
+        r.pointA = c.pointA;
+        r.pointB = c.pointB;
+        return r;
+    }
+
+}
+
+#endif
@@ -59,6 +59,8 @@ namespace z_qtshapes {
     class ZQLine
     {
     public:
+        enum IntersectionType { NoIntersection, BoundedIntersection, UnboundedIntersection };
+
         constexpr inline ZQLine() noexcept;
         constexpr inline ZQLine(const QPoint &pt1, const QPoint &pt2) noexcept;
         inline ZQLine(const QPoint &pt1, const QPoint &pt2, int angle) noexcept;
@@ -138,18 +140,21 @@ namespace z_qtshapes {
         inline void getCoordsRadians(int *x1, int *y1, int *x2, int *y2, qreal *angle) const;
 
         QString toString() const noexcept;
+        QRect boundingRect() const noexcept;
+        QRectF boundingRectF() const noexcept;
         QPainterPath toPath() const noexcept;
         QPainterPath toPath(const QMatrix3x3 &mat, const QPointF &ref) const noexcept;
 
         QPainterPath operator|(const ZQLine &r) const noexcept;
         QPainterPath operator&(const ZQLine &r) const noexcept;
 
-        bool contains(const ZQLine &r) const noexcept;
-        bool contains(const QPoint &p) const noexcept;
+        bool contains(const ZQLine &r, qreal epsilon = 0) const noexcept;
+        bool contains(const QPoint &p, qreal epsilon = 0) const noexcept;
         inline bool contains(qreal x, qreal y) const noexcept;
         inline QPainterPath united(const ZQLine &other) const noexcept;
         inline QPainterPath intersected(const ZQLine &other) const noexcept;
-        bool intersects(const ZQLine &r) const noexcept;
+        bool intersects(const ZQLine &r, qreal epsilon = 0) const noexcept;
+        IntersectionType intersectionPoint(const ZQLine &r, qreal *t, qreal *u, qreal epsilon = 0) const noexcept;
 
         constexpr inline bool operator==(const ZQLine &d) const noexcept;
         constexpr inline bool operator!=(const ZQLine &d) const noexcept { return !(*this == d); }
@@ -505,6 +510,8 @@ namespace z_qtshapes {
     class ZQLineF {
     public:
 
+        enum IntersectionType { NoIntersection, BoundedIntersection, UnboundedIntersection };
+
         constexpr inline ZQLineF() noexcept;
         constexpr inline ZQLineF(const QPointF &pt1, const QPointF &pt2) noexcept;
         inline ZQLineF(const QPointF &pt1, const QPointF &pt2, qreal a_) noexcept;
@@ -592,12 +599,13 @@ namespace z_qtshapes {
         QPainterPath operator|(const ZQLineF &r) const noexcept;
         QPainterPath operator&(const ZQLineF &r) const noexcept;
 
-        bool contains(const ZQLineF &r) const noexcept;
-        bool contains(const QPointF &p) const noexcept;
+        bool contains(const ZQLineF &r, qreal epsilon = 0) const noexcept;
+        bool contains(const QPointF &p, qreal epsilon = 0) const noexcept;
         inline bool contains(qreal x, qreal y) const noexcept;
         inline QPainterPath united(const ZQLineF &other) const noexcept;
         inline QPainterPath intersected(const ZQLineF &other) const noexcept;
-        bool intersects(const ZQLineF &r) const noexcept;
+        bool intersects(const ZQLineF &r, qreal epsilon = 0) const noexcept;
+        IntersectionType intersectionPoint(const ZQLineF &r, qreal *t, qreal *u, qreal epsilon = 0) const noexcept;
 
 
         constexpr inline bool operator==(const ZQLineF &d) const noexcept;
@@ -606,9 +614,14 @@ namespace z_qtshapes {
         constexpr ZQLine toLine() const noexcept;
 
         QString toString() const noexcept;
+        QRectF boundingRect() const noexcept;
         QPainterPath toPath() const noexcept;
         QPainterPath toPath(const QMatrix3x3 &mat, const QPointF &ref) const noexcept;
 
+        constexpr inline int strokeVertexCount() const noexcept { return 4; }
+        constexpr inline int strokeIndexCount() const noexcept { return 6; }
+        void tessellateStroke(qreal width, float *vertices, quint32 *indices, quint32 baseVertex = 0) const noexcept;
+
     private:
         QPointF pt1, pt2;
         qreal a;
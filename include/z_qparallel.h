@@ -0,0 +1,54 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#ifndef Z_QPARALLEL_H
+#define Z_QPARALLEL_H
+
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
+
+namespace z_qtshapes {
+
+    template <typename F>
+    class ZQPoolTask : public QRunnable {
+    public:
+        ZQPoolTask(F &function, QSemaphore &done) : f(function), d(done) {}
+        void run() override
+        {
+            f();
+            d.release();
+        }
+
+    private:
+        F &f;
+        QSemaphore &d;
+    };
+
+    /*
+     * Runs f on the calling thread and on as many idle threads of pool as
+     * are free, up to workers calls in all, and returns once every call has
+     * finished. f is expected to pull its work items from a shared counter,
+     * so the result must not depend on how many threads start. tryStart()
+     * never queues, which keeps a call made from inside the pool from
+     * waiting on itself. A null pool runs f once on the calling thread.
+     */
+    template <typename F>
+    void runOnPool(QThreadPool *pool, int workers, F &f)
+    {
+        QSemaphore done;
+        int started = 0;
+        for (int i = 1; pool && i < workers; ++i) {
+            ZQPoolTask<F> *task = new ZQPoolTask<F>(f, done);
+            if (!pool->tryStart(task)) {
+                delete task;
+                break;
+            }
+            ++started;
+        }
+        f();
+        done.acquire(started);
+    }
+
+}
+
+#endif
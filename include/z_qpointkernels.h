@@ -0,0 +1,64 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#ifndef Z_QPOINTKERNELS_H
+#define Z_QPOINTKERNELS_H
+
+#include <QtWidgets>
+#include "z_qrect.h"
+#include "z_qtri.h"
+#include "z_qellipse.h"
+#include "z_qpreparedshape.h"
+#include "z_simdlevel.h"
+
+namespace z_qtshapes {
+
+    // A 3x3 matrix applied to points about a reference point, with the
+    // homogeneous divide. Any matrix type with operator()(row, column)
+    // converts to one, so QMatrix3x3 and ZQMatrix<3, 3, T> both work.
+    struct ZQPointTransform {
+        template <typename Matrix>
+        explicit ZQPointTransform(const Matrix &mat, const QPointF &reference = QPointF()) noexcept
+            : ref(reference)
+        {
+            for (int i = 0; i < 3; ++i)
+                for (int j = 0; j < 3; ++j)
+                    m[i][j] = qreal(mat(i, j));
+        }
+
+        bool isAffine() const noexcept { return m[2][0] == 0 && m[2][1] == 0 && m[2][2] == 1; }
+        QPointF map(const QPointF &point) const noexcept;
+
+        qreal m[3][3];
+        QPointF ref;
+    };
+
+    void transformPoints(const ZQPointTransform &transform, const double *x, const double *y, double *outX, double *outY,
+            int n, ZQSimdLevel level = ZQAVX512Level) noexcept;
+    void transformPoints(const ZQPointTransform &transform, const float *x, const float *y, float *outX, float *outY,
+            int n, ZQSimdLevel level = ZQAVX512Level) noexcept;
+
+    void containsPoints(const ZQPreparedRectF &rect, const qreal *x, const qreal *y, int n, quint8 *mask,
+            ZQSimdLevel level = ZQAVX512Level) noexcept;
+    void containsPoints(const ZQPreparedEllipseF &ellipse, const qreal *x, const qreal *y, int n, quint8 *mask,
+            ZQSimdLevel level = ZQAVX512Level) noexcept;
+    void containsPoints(const ZQPreparedTriF &triangle, const qreal *x, const qreal *y, int n, quint8 *mask,
+            ZQSimdLevel level = ZQAVX512Level) noexcept;
+
+    inline void containsPoints(const ZQRectF &rect, const qreal *x, const qreal *y, int n, quint8 *mask,
+            ZQSimdLevel level = ZQAVX512Level) noexcept
+    { containsPoints(rect.prepared(), x, y, n, mask, level); }
+
+    inline void containsPoints(const ZQEllipseF &ellipse, const qreal *x, const qreal *y, int n, quint8 *mask,
+            ZQSimdLevel level = ZQAVX512Level) noexcept
+    { containsPoints(ellipse.prepared(), x, y, n, mask, level); }
+
+    inline void containsPoints(const ZQTriF &triangle, const qreal *x, const qreal *y, int n, quint8 *mask,
+            ZQSimdLevel level = ZQAVX512Level) noexcept
+    { containsPoints(triangle.prepared(), x, y, n, mask, level); }
+
+    void distanceRow(const ZQPreparedShape &shape, const QPointF &origin, const QPointF &step, float *distance, int n,
+            ZQSimdLevel level = ZQAVX512Level) noexcept;
+
+}
+
+#endif
@@ -0,0 +1,52 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#ifndef Z_QPOLYGON_H
+#define Z_QPOLYGON_H
+
+#include <QtWidgets>
+#include <QVarLengthArray>
+
+namespace z_qtshapes {
+
+    class ZQPolygonF {
+    public:
+        ZQPolygonF() noexcept {}
+        explicit ZQPolygonF(const QPolygonF &polygon);
+        ZQPolygonF(const QPointF *points, int count);
+
+        inline bool isEmpty() const noexcept { return pts.isEmpty(); }
+        inline int pointCount() const noexcept { return pts.size(); }
+        inline const QPointF *points() const noexcept { return pts.constData(); }
+
+        inline int contourCount() const noexcept { return ends.size(); }
+        inline int contourStart(int i) const noexcept { return i > 0 ? ends[i - 1] : 0; }
+        inline int contourSize(int i) const noexcept { return ends[i] - contourStart(i); }
+        QPolygonF contour(int i) const;
+
+        void addContour(const QPointF *points, int count);
+        void clear() noexcept;
+
+        qreal area() const noexcept;
+        QRectF boundingRect() const noexcept;
+        bool isConvex() const noexcept;
+        bool contains(const QPointF &p) const noexcept;
+
+        ZQPolygonF convexIntersected(const ZQPolygonF &other) const noexcept;
+        ZQPolygonF convexUnited(const ZQPolygonF &other) const noexcept;
+
+        QPainterPath toPath() const noexcept;
+
+        friend bool operator==(const ZQPolygonF &p1, const ZQPolygonF &p2) noexcept;
+        friend bool operator!=(const ZQPolygonF &p1, const ZQPolygonF &p2) noexcept;
+
+    private:
+        // The points of all contours, one after another, and the end index
+        // of each contour. Two convex quadrilaterals never need more than
+        // the preallocated room, so the boolean operations do not allocate.
+        QVarLengthArray<QPointF, 16> pts;
+        QVarLengthArray<int, 2> ends;
+    };
+
+}
+
+#endif
@@ -0,0 +1,76 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#ifndef Z_QPREPAREDSHAPE_H
+#define Z_QPREPAREDSHAPE_H
+
+#include <QtWidgets>
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+
+namespace z_qtshapes {
+
+    /*
+     * Contact rule: every shape is a closed set, its outline included, and
+     * two shapes intersect when they share at least one point. Shapes that
+     * only touch along an edge or at a single point intersect, for every
+     * pair of types. A line has no interior, so it intersects whatever it
+     * touches. Degenerate ellipses with a zero radius intersect nothing.
+     */
+    class ZQPreparedShape {
+    public:
+        enum ShapeType {
+            NoShape,
+            RectShape,
+            TriShape,
+            EllipseShape,
+            LineShape
+        };
+
+        ZQPreparedShape() noexcept : ty(NoShape), r() {}
+        ZQPreparedShape(const ZQPreparedRectF &rect) noexcept : ty(RectShape), r(rect) {}
+        ZQPreparedShape(const ZQPreparedTriF &tri) noexcept : ty(TriShape), t(tri) {}
+        ZQPreparedShape(const ZQPreparedEllipseF &ellipse) noexcept : ty(EllipseShape), e(ellipse) {}
+        ZQPreparedShape(const ZQRect &rect) noexcept : ZQPreparedShape(rect.prepared()) {}
+        ZQPreparedShape(const ZQRectF &rect) noexcept : ZQPreparedShape(rect.prepared()) {}
+        ZQPreparedShape(const ZQTri &tri) noexcept : ZQPreparedShape(tri.prepared()) {}
+        ZQPreparedShape(const ZQTriF &tri) noexcept : ZQPreparedShape(tri.prepared()) {}
+        ZQPreparedShape(const ZQEllipse &ellipse) noexcept : ZQPreparedShape(ellipse.prepared()) {}
+        ZQPreparedShape(const ZQEllipseF &ellipse) noexcept : ZQPreparedShape(ellipse.prepared()) {}
+        ZQPreparedShape(const ZQRectF &rect, qreal cosAngle, qreal sinAngle) noexcept;
+        ZQPreparedShape(const ZQTriF &tri, qreal cosAngle, qreal sinAngle) noexcept;
+        ZQPreparedShape(const ZQEllipseF &ellipse, qreal cosAngle, qreal sinAngle) noexcept;
+        ZQPreparedShape(const ZQLine &line) noexcept;
+        ZQPreparedShape(const ZQLineF &line) noexcept;
+
+        inline ShapeType type() const noexcept { return ty; }
+        inline bool isNull() const noexcept { return ty == NoShape; }
+
+        inline const ZQPreparedRectF &rect() const noexcept { return r; }
+        inline const ZQPreparedTriF &tri() const noexcept { return t; }
+        inline const ZQPreparedEllipseF &ellipse() const noexcept { return e; }
+        inline const QLineF &line() const noexcept { return l; }
+
+        QRectF boundingRect() const noexcept;
+        bool contains(const QPointF &p) const noexcept;
+        bool intersects(const QRectF &r) const noexcept;
+        bool intersects(const ZQPreparedShape &s) const noexcept;
+        qreal distance(const QPointF &p) const noexcept;
+        qreal distance(const ZQPreparedShape &s) const noexcept;
+
+        QPainterPath toPath() const noexcept;
+
+    private:
+        ShapeType ty;
+        union {
+            ZQPreparedRectF r;
+            ZQPreparedTriF t;
+            ZQPreparedEllipseF e;
+            QLineF l;
+        };
+    };
+
+}
+
+#endif
@@ -0,0 +1,42 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#ifndef Z_QRASTERIZER_H
+#define Z_QRASTERIZER_H
+
+#include <QtWidgets>
+#include <QImage>
+#include <QThreadPool>
+#include <QVector>
+#include "z_qpreparedshape.h"
+
+namespace z_qtshapes {
+
+    class ZQRasterizer {
+    public:
+        ZQRasterizer() noexcept;
+
+        void setTileSize(int size) noexcept;
+        inline int tileSize() const noexcept { return tile; }
+        void setSamples(int samples) noexcept;
+        inline int samples() const noexcept { return ss; }
+        void setLineWidth(qreal width) noexcept;
+        inline qreal lineWidth() const noexcept { return lw; }
+        inline void setThreadPool(QThreadPool *pool) noexcept { tp = pool; }
+        inline QThreadPool *threadPool() const noexcept { return tp; }
+
+        void rasterizeCoverage(const ZQPreparedShape *shapes, int count,
+                quint8 *coverage, int width, int height, int bytesPerLine) const;
+        void rasterizeIds(const ZQPreparedShape *shapes, int count,
+                quint32 *ids, int width, int height, int bytesPerLine) const;
+        bool rasterize(const QVector<ZQPreparedShape> &shapes, QImage &image) const;
+
+    private:
+        int tile;
+        int ss;
+        qreal lw;
+        QThreadPool *tp;
+    };
+
+}
+
+#endif
@@ -46,9 +46,11 @@
 #include <QDataStream>
 #include <QDebug>
 #include "z_base.h"
+#include "z_qpolygon.h"
 
 namespace z_qtshapes {
 
+    class ZQPreparedRectF;
 
     class ZQRect {
     public:
@@ -170,22 +172,29 @@ namespace z_qtshapes {
         inline void setHeight(int h) noexcept;
         inline void setSize(const QSize &s) noexcept;
 
-        QPainterPath operator|(const ZQRect &r) const noexcept;
-        QPainterPath operator&(const ZQRect &r) const noexcept;
+        ZQPolygonF operator|(const ZQRect &r) const noexcept;
+        ZQPolygonF operator&(const ZQRect &r) const noexcept;
 
         bool contains(const ZQRect &r, bool proper=false) const noexcept;
+        bool contains(const ZQPreparedRectF &r, bool proper=false) const noexcept;
         bool contains(const QPoint &p) const noexcept;
         inline bool contains(int x, int y) const noexcept;
-        inline QPainterPath united(const ZQRect &other) const noexcept;
-        inline QPainterPath intersected(const ZQRect &other) const noexcept;
+        inline ZQPolygonF united(const ZQRect &other) const noexcept;
+        inline ZQPolygonF intersected(const ZQRect &other) const noexcept;
         bool intersects(const ZQRect &r) const noexcept;
+        bool intersects(const ZQPreparedRectF &r) const noexcept;
 
         inline ZQRect marginsAdded(const QMargins &margins) const noexcept;
         inline ZQRect marginsRemoved(const QMargins &margins) const noexcept;
         inline ZQRect &operator+=(const QMargins &margins) noexcept;
         inline ZQRect &operator-=(const QMargins &margins) noexcept;
 
+        ZQPreparedRectF prepared() const noexcept;
+        QRect boundingRect() const noexcept;
+        QRectF boundingRectF() const noexcept;
+
         QPainterPath toPath() const noexcept;
+        ZQPolygonF toPolygon() const noexcept;
         QPainterPath toPath(const QMatrix3x3 &mat, const QPointF &ref) const noexcept;
         QString toString() const noexcept;
 
@@ -640,12 +649,12 @@ namespace z_qtshapes {
         return contains(QPoint(ax, ay));
     }
 
-    inline QPainterPath ZQRect::intersected(const ZQRect &other) const noexcept
+    inline ZQPolygonF ZQRect::intersected(const ZQRect &other) const noexcept
     {
         return *this & other;
     }
 
-    inline QPainterPath ZQRect::united(const ZQRect &r) const noexcept
+    inline ZQPolygonF ZQRect::united(const ZQRect &r) const noexcept
     {
         return *this | r;
     }
@@ -825,15 +834,17 @@ namespace z_qtshapes {
         inline void setHeight(qreal h) noexcept;
         inline void setSize(const QSizeF &s) noexcept;
 
-        QPainterPath operator|(const ZQRectF &r) const noexcept;
-        QPainterPath operator&(const ZQRectF &r) const noexcept;
+        ZQPolygonF operator|(const ZQRectF &r) const noexcept;
+        ZQPolygonF operator&(const ZQRectF &r) const noexcept;
 
         bool contains(const ZQRectF &r, bool proper=false) const noexcept;
+        bool contains(const ZQPreparedRectF &r, bool proper=false) const noexcept;
         bool contains(const QPointF &p) const noexcept;
         inline bool contains(qreal x, qreal y) const noexcept;
-        inline QPainterPath united(const ZQRectF &other) const noexcept;
-        inline QPainterPath intersected(const ZQRectF &other) const noexcept;
+        inline ZQPolygonF united(const ZQRectF &other) const noexcept;
+        inline ZQPolygonF intersected(const ZQRectF &other) const noexcept;
         bool intersects(const ZQRectF &r) const noexcept;
+        bool intersects(const ZQPreparedRectF &r) const noexcept;
 
         inline ZQRectF marginsAdded(const QMarginsF &margins) const noexcept;
         inline ZQRectF marginsRemoved(const QMarginsF &margins) const noexcept;
@@ -843,7 +854,14 @@ namespace z_qtshapes {
         inline ZQRect toRect() const noexcept;
         ZQRect toAlignedRect() const noexcept;
 
+        ZQPreparedRectF prepared() const noexcept;
+        QRectF boundingRect() const noexcept;
+        constexpr inline int tessellationVertexCount(qreal = 0) const noexcept { return 4; }
+        constexpr inline int tessellationIndexCount(qreal = 0) const noexcept { return 6; }
+        void tessellate(qreal tolerance, float *vertices, quint32 *indices, quint32 baseVertex = 0) const noexcept;
+
         QPainterPath toPath() const noexcept;
+        ZQPolygonF toPolygon() const noexcept;
         QPainterPath toPath(const QMatrix3x3 &mat, const QPointF &ref) const noexcept;
         QString toString() const noexcept;
 
@@ -1218,12 +1236,12 @@ namespace z_qtshapes {
         return contains(QPointF(ax, ay));
     }
 
-    inline QPainterPath ZQRectF::intersected(const ZQRectF &r) const noexcept
+    inline ZQPolygonF ZQRectF::intersected(const ZQRectF &r) const noexcept
     {
         return *this & r;
     }
 
-    inline QPainterPath ZQRectF::united(const ZQRectF &r) const noexcept
+    inline ZQPolygonF ZQRectF::united(const ZQRectF &r) const noexcept
     {
         return *this | r;
     }
@@ -1288,6 +1306,59 @@ namespace z_qtshapes {
     QDebug operator<<(QDebug, const ZQRectF &);
     #endif
 
+    /*****************************************************************************
+      ZQPreparedRectF
+     *****************************************************************************/
+
+    class ZQPreparedRectF {
+    public:
+        constexpr ZQPreparedRectF() noexcept : cx(0.), cy(0.), ca(1.), sa(0.), hw(0.), hh(0.), a(0.),
+            corners{}, bx1(0.), by1(0.), bx2(0.), by2(0.) {}
+        ZQPreparedRectF(qreal left, qreal top, qreal right, qreal bottom, const QPointF &rotationCenter, qreal angle) noexcept;
+        ZQPreparedRectF(qreal left, qreal top, qreal right, qreal bottom, const QPointF &rotationCenter, qreal angle,
+                qreal cosAngle, qreal sinAngle) noexcept;
+
+        constexpr inline QPointF center() const noexcept { return QPointF(cx, cy); }
+        constexpr inline qreal angle() const noexcept { return a; }
+        constexpr inline qreal cosAngle() const noexcept { return ca; }
+        constexpr inline qreal sinAngle() const noexcept { return sa; }
+        constexpr inline qreal halfWidth() const noexcept { return hw; }
+        constexpr inline qreal halfHeight() const noexcept { return hh; }
+        constexpr inline QPointF xAxis() const noexcept { return QPointF(ca, -sa); }
+        constexpr inline QPointF yAxis() const noexcept { return QPointF(sa, ca); }
+        constexpr inline QPointF topRight() const noexcept { return corners[0]; }
+        constexpr inline QPointF bottomRight() const noexcept { return corners[1]; }
+        constexpr inline QPointF bottomLeft() const noexcept { return corners[2]; }
+        constexpr inline QPointF topLeft() const noexcept { return corners[3]; }
+        constexpr inline QRectF boundingRect() const noexcept { return QRectF(bx1, by1, bx2 - bx1, by2 - by1); }
+
+        bool contains(const QPointF &p) const noexcept;
+        bool contains(const ZQPreparedRectF &r, bool proper=false) const noexcept;
+        bool intersects(const ZQPreparedRectF &r) const noexcept;
+
+        QPainterPath toPath() const noexcept;
+        ZQPolygonF toPolygon() const noexcept;
+        QPainterPath toPath(const QMatrix3x3 &mat, const QPointF &ref) const noexcept;
+
+        constexpr inline int tessellationVertexCount(qreal = 0) const noexcept { return 4; }
+        constexpr inline int tessellationIndexCount(qreal = 0) const noexcept { return 6; }
+        void tessellate(qreal tolerance, float *vertices, quint32 *indices, quint32 baseVertex = 0) const noexcept;
+
+    private:
+        qreal cx;
+        qreal cy;
+        qreal ca;
+        qreal sa;
+        qreal hw;
+        qreal hh;
+        qreal a;
+        QPointF corners[4];
+        qreal bx1;
+        qreal by1;
+        qreal bx2;
+        qreal by2;
+    };
+
 }
 
 #endif
@@ -0,0 +1,138 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#ifndef Z_QSHAPEARRAY_H
+#define Z_QSHAPEARRAY_H
+
+#include <QtWidgets>
+#include <QVector>
+#include "z_aligned.h"
+#include "z_qrect.h"
+#include "z_qtri.h"
+#include "z_qellipse.h"
+#include "z_qpreparedshape.h"
+
+namespace z_qtshapes {
+
+    typedef ZQAlignedBuffer<qreal> ZQRealBuffer;
+
+    class ZQRectFArray {
+    public:
+        ZQRectFArray() noexcept {}
+        explicit ZQRectFArray(const QVector<ZQRectF> &rects);
+
+        inline int size() const noexcept { return xs.size(); }
+        inline bool isEmpty() const noexcept { return xs.isEmpty(); }
+        void reserve(int size);
+        void clear() noexcept;
+
+        void append(const ZQRectF &rect);
+        void replace(int i, const ZQRectF &rect) noexcept;
+        ZQRectF at(int i) const noexcept;
+        QVector<ZQRectF> toVector() const;
+
+        inline const qreal *xData() const noexcept { return xs.data(); }
+        inline const qreal *yData() const noexcept { return ys.data(); }
+        inline const qreal *widthData() const noexcept { return ws.data(); }
+        inline const qreal *heightData() const noexcept { return hs.data(); }
+        inline const qreal *angleData() const noexcept { return as.data(); }
+        inline const qreal *cosData() const noexcept { return cs.data(); }
+        inline const qreal *sinData() const noexcept { return ss.data(); }
+
+        void translate(qreal dx, qreal dy) noexcept;
+        inline void translate(const QPointF &p) noexcept { translate(p.x(), p.y()); }
+        void rotate(qreal da) noexcept;
+        inline void rotateRadians(qreal da) noexcept { rotate(180/M_PI * da); }
+
+        void contains(const QPointF &p, bool *result) const noexcept;
+        void intersects(const ZQPreparedShape &shape, bool *result) const noexcept;
+
+        void boundingRects(qreal *left, qreal *top, qreal *right, qreal *bottom) const noexcept;
+        QRectF boundingRect() const noexcept;
+
+    private:
+        ZQRealBuffer xs, ys, ws, hs, as, cs, ss;
+    };
+
+
+    class ZQEllipseFArray {
+    public:
+        ZQEllipseFArray() noexcept {}
+        explicit ZQEllipseFArray(const QVector<ZQEllipseF> &ellipses);
+
+        inline int size() const noexcept { return xs.size(); }
+        inline bool isEmpty() const noexcept { return xs.isEmpty(); }
+        void reserve(int size);
+        void clear() noexcept;
+
+        void append(const ZQEllipseF &ellipse);
+        void replace(int i, const ZQEllipseF &ellipse) noexcept;
+        ZQEllipseF at(int i) const noexcept;
+        QVector<ZQEllipseF> toVector() const;
+
+        inline const qreal *xData() const noexcept { return xs.data(); }
+        inline const qreal *yData() const noexcept { return ys.data(); }
+        inline const qreal *widthData() const noexcept { return ws.data(); }
+        inline const qreal *heightData() const noexcept { return hs.data(); }
+        inline const qreal *angleData() const noexcept { return as.data(); }
+        inline const qreal *cosData() const noexcept { return cs.data(); }
+        inline const qreal *sinData() const noexcept { return ss.data(); }
+
+        void translate(qreal dx, qreal dy) noexcept;
+        inline void translate(const QPointF &p) noexcept { translate(p.x(), p.y()); }
+        void rotate(qreal da) noexcept;
+        inline void rotateRadians(qreal da) noexcept { rotate(180/M_PI * da); }
+
+        void contains(const QPointF &p, bool *result) const noexcept;
+        void intersects(const ZQPreparedShape &shape, bool *result) const noexcept;
+
+        void boundingRects(qreal *left, qreal *top, qreal *right, qreal *bottom) const noexcept;
+        QRectF boundingRect() const noexcept;
+
+    private:
+        ZQRealBuffer xs, ys, ws, hs, as, cs, ss;
+    };
+
+
+    class ZQTriFArray {
+    public:
+        ZQTriFArray() noexcept {}
+        explicit ZQTriFArray(const QVector<ZQTriF> &triangles);
+
+        inline int size() const noexcept { return x1s.size(); }
+        inline bool isEmpty() const noexcept { return x1s.isEmpty(); }
+        void reserve(int size);
+        void clear() noexcept;
+
+        void append(const ZQTriF &triangle);
+        void replace(int i, const ZQTriF &triangle) noexcept;
+        ZQTriF at(int i) const noexcept;
+        QVector<ZQTriF> toVector() const;
+
+        inline const qreal *x1Data() const noexcept { return x1s.data(); }
+        inline const qreal *y1Data() const noexcept { return y1s.data(); }
+        inline const qreal *x2Data() const noexcept { return x2s.data(); }
+        inline const qreal *y2Data() const noexcept { return y2s.data(); }
+        inline const qreal *x3Data() const noexcept { return x3s.data(); }
+        inline const qreal *y3Data() const noexcept { return y3s.data(); }
+        inline const qreal *angleData() const noexcept { return as.data(); }
+        inline const qreal *cosData() const noexcept { return cs.data(); }
+        inline const qreal *sinData() const noexcept { return ss.data(); }
+
+        void translate(qreal dx, qreal dy) noexcept;
+        inline void translate(const QPointF &p) noexcept { translate(p.x(), p.y()); }
+        void rotate(qreal da) noexcept;
+        inline void rotateRadians(qreal da) noexcept { rotate(180/M_PI * da); }
+
+        void contains(const QPointF &p, bool *result) const noexcept;
+        void intersects(const ZQPreparedShape &shape, bool *result) const noexcept;
+
+        void boundingRects(qreal *left, qreal *top, qreal *right, qreal *bottom) const noexcept;
+        QRectF boundingRect() const noexcept;
+
+    private:
+        ZQRealBuffer x1s, y1s, x2s, y2s, x3s, y3s, as, cs, ss;
+    };
+
+}
+
+#endif
@@ -0,0 +1,76 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#ifndef Z_QSPATIALINDEX_H
+#define Z_QSPATIALINDEX_H
+
+#include <memory>
+
+#include <QtWidgets>
+#include <QVector>
+#include "z_qpreparedshape.h"
+
+namespace z_qtshapes {
+
+    class ZQSpatialIndex {
+    public:
+        typedef int Id;
+
+        ZQSpatialIndex();
+        ~ZQSpatialIndex();
+        ZQSpatialIndex(ZQSpatialIndex &&other);
+        ZQSpatialIndex &operator=(ZQSpatialIndex &&other) noexcept;
+
+        Id insert(const ZQPreparedShape &shape);
+
+        template <typename InputIterator>
+        void bulkLoad(InputIterator first, InputIterator last, QVector<Id> *ids = nullptr);
+
+        bool update(Id id, const ZQPreparedShape &shape);
+
+        bool remove(Id id);
+        void clear();
+        void rebuild();
+
+        bool contains(Id id) const noexcept;
+        const ZQPreparedShape &shape(Id id) const noexcept;
+        ZQPreparedShape::ShapeType shapeType(Id id) const noexcept;
+        QRectF boundingRect(Id id) const noexcept;
+        QRectF boundingRect() const noexcept;
+        int size() const noexcept;
+        inline bool isEmpty() const noexcept { return size() == 0; }
+
+        QVector<Id> intersecting(const QRectF &region) const;
+        void intersecting(const QRectF &region, QVector<Id> &result) const;
+        QVector<Id> within(const QRectF &region) const;
+        QVector<Id> containing(const QPointF &point) const;
+        QVector<Id> nearest(const QPointF &point, int k) const;
+        qreal distance(Id id, const QPointF &point) const noexcept;
+
+    private:
+        Q_DISABLE_COPY(ZQSpatialIndex)
+
+        Id stage(const ZQPreparedShape &shape);
+
+        class Private;
+        std::unique_ptr<Private> d;
+    };
+
+
+    /*****************************************************************************
+      ZQSpatialIndex template members
+     *****************************************************************************/
+
+    template <typename InputIterator>
+    void ZQSpatialIndex::bulkLoad(InputIterator first, InputIterator last, QVector<Id> *ids)
+    {
+        for (; first != last; ++first) {
+            const Id id = stage(*first);
+            if (ids)
+                ids->append(id);
+        }
+        rebuild();
+    }
+
+}
+
+#endif
@@ -0,0 +1,229 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#ifndef Z_QSWEEP_H
+#define Z_QSWEEP_H
+
+#include <QtWidgets>
+#include <QThreadPool>
+#include "z_qgjk.h"
+#include "z_qspatialindex.h"
+
+namespace z_qtshapes {
+
+    /*
+     * The change of pose of a shape over one step: a translation and a
+     * rotation in degrees about the shape's center, in the same sense as
+     * translate() and rotate(). Both are applied at a constant rate, so at
+     * time t in [0, 1] the shape has moved by t * translation and turned by
+     * t * angle.
+     */
+    struct ZQMotion {
+        QPointF translation;
+        qreal angle;
+
+        ZQMotion(const QPointF &translation_ = QPointF(), qreal angle_ = 0) noexcept
+            : translation(translation_), angle(angle_) {}
+    };
+
+    /*
+     * Result of timeOfImpact(). Up to time the shapes do not touch; when
+     * hit is set they are within tolerance of each other at time, with
+     * pointA and pointB the closest points and normal pointing from the
+     * first shape to the second. Without a hit time is the end of the
+     * step, or as far as the iteration limit let the search get.
+     */
+    struct ZQTimeOfImpact {
+        bool hit;
+        qreal time;
+        QPointF pointA;
+        QPointF pointB;
+        QPointF normal;
+        int iterations;
+    };
+
+    /*
+     * The center a shape turns about, which all of the prepared forms
+     * keep in place when they are rotated.
+     */
+    inline QPointF rotationCenter(const QPointF &p) noexcept { return p; }
+    inline QPointF rotationCenter(const QLineF &l) noexcept { return (l.p1() + l.p2()) / 2; }
+    inline QPointF rotationCenter(const ZQPreparedRectF &r) noexcept { return r.center(); }
+    inline QPointF rotationCenter(const ZQPreparedEllipseF &e) noexcept { return e.center(); }
+    inline QPointF rotationCenter(const ZQPreparedTriF &t) noexcept
+    {
+        return (t.first() + t.second() + t.third()) / 3;
+    }
+
+    inline QPointF rotationCenter(const ZQPreparedShape &shape) noexcept
+    {
+        switch (shape.type()) {
+        case ZQPreparedShape::RectShape:
+            return rotationCenter(shape.rect());
+        case ZQPreparedShape::TriShape:
+            return rotationCenter(shape.tri());
+        case ZQPreparedShape::EllipseShape:
+            return rotationCenter(shape.ellipse());
+        case ZQPreparedShape::LineShape:
+            return rotationCenter(shape.line());
+        default:
+            return QPointF();
+        }
+    }
+
+    /*
+     * The largest distance from pivot to a point of the shape, which
+     * bounds how far any point moves when the shape turns about pivot.
+     */
+    inline qreal boundingRadius(const QPointF &p, const QPointF &pivot) noexcept
+    {
+        return qSqrt(QPointF::dotProduct(p - pivot, p - pivot));
+    }
+
+    inline qreal boundingRadius(const QLineF &l, const QPointF &pivot) noexcept
+    {
+        return qMax(boundingRadius(l.p1(), pivot), boundingRadius(l.p2(), pivot));
+    }
+
+    inline qreal boundingRadius(const ZQPreparedRectF &r, const QPointF &pivot) noexcept
+    {
+        return qMax(qMax(boundingRadius(r.topLeft(), pivot), boundingRadius(r.topRight(), pivot)),
+                    qMax(boundingRadius(r.bottomLeft(), pivot), boundingRadius(r.bottomRight(), pivot)));
+    }
+
+    inline qreal boundingRadius(const ZQPreparedTriF &t, const QPointF &pivot) noexcept
+    {
+        return qMax(boundingRadius(t.first(), pivot), qMax(boundingRadius(t.second(), pivot),
+                                                           boundingRadius(t.third(), pivot)));
+    }
+
+    inline qreal boundingRadius(const ZQPreparedEllipseF &e, const QPointF &pivot) noexcept
+    {
+        return boundingRadius(e.center(), pivot) + qMax(e.radiusX(), e.radiusY());
+    }
+
+    inline qreal boundingRadius(const ZQPreparedShape &shape, const QPointF &pivot) noexcept
+    {
+        switch (shape.type()) {
+        case ZQPreparedShape::RectShape:
+            return boundingRadius(shape.rect(), pivot);
+        case ZQPreparedShape::TriShape:
+            return boundingRadius(shape.tri(), pivot);
+        case ZQPreparedShape::EllipseShape:
+            return boundingRadius(shape.ellipse(), pivot);
+        case ZQPreparedShape::LineShape:
+            return boundingRadius(shape.line(), pivot);
+        default:
+            return 0;
+        }
+    }
+
+    /*
+     * A shape at time t of a motion, seen through its support mapping:
+     * the direction is turned back into the shape's starting pose and the
+     * support point turned and moved forward again, so nothing about the
+     * shape itself is recomputed.
+     */
+    template <typename Shape>
+    struct ZQMovingShape {
+        const Shape &shape;
+        QPointF pivot;
+        QPointF offset;
+        qreal c;
+        qreal s;
+
+        ZQMovingShape(const Shape &shape_, const QPointF &pivot_, const ZQMotion &motion, qreal t) noexcept
+            : shape(shape_), pivot(pivot_), offset(motion.translation * t)
+        {
+            const qreal rad = M_PI/180 * motion.angle * t;
+            c = qCos(rad);
+            s = qSin(rad);
+        }
+    };
+
+    template <typename Shape>
+    inline QPointF supportPoint(const ZQMovingShape<Shape> &m, const QPointF &dir) noexcept
+    {
+        const QPointF p = supportPoint(m.shape, QPointF(m.c * dir.x() - m.s * dir.y(), m.s * dir.x() + m.c * dir.y())) - m.pivot;
+        return m.pivot + m.offset + QPointF(m.c * p.x() + m.s * p.y(), -m.s * p.x() + m.c * p.y());
+    }
+
+    namespace sweep_detail {
+
+        /*
+         * Conservative advancement. While the shapes are apart, the
+         * separating line through their closest points keeps them apart
+         * until the relative translation along its normal plus the fastest
+         * a turning point can move have covered the gap, so the time can be
+         * advanced by the gap over that speed without passing the contact.
+         * The gap is taken from GJK's lower bound, so curved shapes that
+         * GJK only approaches from outside do not overshoot either.
+         */
+        template <typename A, typename B>
+        ZQTimeOfImpact advance(const A &a, const ZQMotion &ma, const B &b, const ZQMotion &mb, qreal end,
+                               qreal tolerance, int maxIterations) noexcept
+        {
+            const QPointF ca = rotationCenter(a), cb = rotationCenter(b);
+            const qreal spin = M_PI/180 * (qAbs(ma.angle) * boundingRadius(a, ca) + qAbs(mb.angle) * boundingRadius(b, cb));
+            const QPointF rel = ma.translation - mb.translation;
+            const qreal gap = tolerance / 16;
+
+            ZQTimeOfImpact r;
+            r.hit = false;
+            r.time = 0;
+            r.iterations = 0;
+            while (r.iterations < maxIterations) {
+                ++r.iterations;
+                const ZQMovingShape<A> at(a, ca, ma, r.time);
+                const ZQMovingShape<B> bt(b, cb, mb, r.time);
+                gjk_detail::Simplex s;
+                const ZQClosestPoints c = gjk_detail::gjk(at, bt, s, gap, 64);
+                r.pointA = c.pointA;
+                r.pointB = c.pointB;
+                if (c.distance <= tolerance) {
+                    r.hit = true;
+                    if (c.overlapping())
+                        r.normal = gjk_detail::epa(at, bt, s, gap, 64).normal;
+                    else
+                        r.normal = (c.pointB - c.pointA) / c.distance;
+                    return r;
+                }
+
+                r.normal = (c.pointB - c.pointA) / c.distance;
+                const qreal speed = QPointF::dotProduct(r.normal, rel) + spin;
+                if (speed <= 0)
+                    break;
+                const qreal next = r.time + (c.distance - gap) / speed;
+                if (next >= end)
+                    break;
+                r.time = next;
+                if (r.iterations == maxIterations)
+                    return r;
+            }
+            r.time = end;
+            return r;
+        }
+
+    }
+
+    /*
+     * Time of impact of two convex shapes moving over one step, a by ma
+     * and b by mb, found by conservative advancement on GJK distances.
+     * Either shape may be of any type closestPoints() accepts. Shapes that
+     * already overlap at the start hit at time zero.
+     */
+    template <typename A, typename B>
+    ZQTimeOfImpact timeOfImpact(const A &a, const ZQMotion &ma, const B &b, const ZQMotion &mb = ZQMotion(),
+                                qreal tolerance = 1e-6, int maxIterations = 64) noexcept
+    {
+        const typename ZQConvexTraits<A>::Prepared &pa = ZQConvexTraits<A>::prepare(a);
+        const typename ZQConvexTraits<B>::Prepared &pb = ZQConvexTraits<B>::prepare(b);
+        return sweep_detail::advance(pa, ma, pb, mb, 1, tolerance, maxIterations);
+    }
+
+    void timesOfImpact(const ZQPreparedShape *movers, const ZQMotion *motions, int count,
+                       const ZQSpatialIndex &obstacles, ZQTimeOfImpact *results, ZQSpatialIndex::Id *hits = nullptr,
+                       QThreadPool *pool = QThreadPool::globalInstance(), qreal tolerance = 1e-6);
+
+}
+
+#endif
@@ -48,10 +48,13 @@
 #include <QDataStream>
 #include <QDebug>
 #include "z_base.h"
+#include "z_qpolygon.h"
 #include "z_geometry_util.h"
 
 namespace z_qtshapes {
 
+    class ZQPreparedTriF;
+
     class ZQTri {
     public:
         constexpr inline ZQTri() noexcept : x1p(0), y1p(0), x2p(0), y2p(0), x3p(0), y3p(0), a(0) {}
@@ -162,15 +165,17 @@ namespace z_qtshapes {
         inline ZQTri adjusted(int dx1, int dy1, int dx2, int dy2, int dx3, int dy3, int a_) const noexcept;
         inline ZQTri adjustedRadians(int dx1, int dy1, int dx2, int dy2, int dx3, int dy3, qreal a_) const noexcept;
 
-        QPainterPath operator|(const ZQTri &r) const noexcept;
-        QPainterPath operator&(const ZQTri &r) const noexcept;
+        ZQPolygonF operator|(const ZQTri &r) const noexcept;
+        ZQPolygonF operator&(const ZQTri &r) const noexcept;
 
         bool contains(const ZQTri &r, bool proper = false) const noexcept;
+        bool contains(const ZQPreparedTriF &r, bool proper = false) const noexcept;
         bool contains(const QPoint &p) const noexcept;
         inline bool contains(int x, int y) const noexcept;
-        inline QPainterPath united(const ZQTri &other) const noexcept;
-        inline QPainterPath intersected(const ZQTri &other) const noexcept;
+        inline ZQPolygonF united(const ZQTri &other) const noexcept;
+        inline ZQPolygonF intersected(const ZQTri &other) const noexcept;
         bool intersects(const ZQTri &r) const noexcept;
+        bool intersects(const ZQPreparedTriF &r) const noexcept;
 
         inline bool isAcute() const noexcept;
         inline bool isRight() const noexcept;
@@ -179,7 +184,12 @@ namespace z_qtshapes {
         inline bool isEquilateral() const noexcept;
         inline bool isScalene() const noexcept { return !isIso(); }
 
+        ZQPreparedTriF prepared() const noexcept;
+        QRect boundingRect() const noexcept;
+        QRectF boundingRectF() const noexcept;
+
         QPainterPath toPath() const noexcept;
+        ZQPolygonF toPolygon() const noexcept;
         QPainterPath toPath(const QMatrix3x3 &mat, const QPointF &ref) const noexcept;
         QString toString() const noexcept;
 
@@ -780,12 +790,12 @@ namespace z_qtshapes {
     }
 
 
-    inline QPainterPath ZQTri::intersected(const ZQTri &other) const noexcept
+    inline ZQPolygonF ZQTri::intersected(const ZQTri &other) const noexcept
     {
         return *this & other;
     }
 
-    inline QPainterPath ZQTri::united(const ZQTri &r) const noexcept
+    inline ZQPolygonF ZQTri::united(const ZQTri &r) const noexcept
     {
         return *this | r;
     }
@@ -983,15 +993,17 @@ namespace z_qtshapes {
         inline ZQTriF adjusted(qreal dx1, qreal dy1, qreal dx2, qreal dy2, qreal dx3, qreal dy3, qreal angle) const noexcept;
         inline ZQTriF adjustedRadians(qreal dx1, qreal dy1, qreal dx2, qreal dy2, qreal dx3, qreal dy3, qreal angle) const noexcept;
 
-        QPainterPath operator|(const ZQTriF &r) const noexcept;
-        QPainterPath operator&(const ZQTriF &r) const noexcept;
+        ZQPolygonF operator|(const ZQTriF &r) const noexcept;
+        ZQPolygonF operator&(const ZQTriF &r) const noexcept;
 
         bool contains(const ZQTriF &r, bool proper = false) const noexcept;
+        bool contains(const ZQPreparedTriF &r, bool proper = false) const noexcept;
         bool contains(const QPointF &p) const noexcept;
         inline bool contains(qreal x, qreal y) const noexcept;
-        inline QPainterPath united(const ZQTriF &other) const noexcept;
-        inline QPainterPath intersected(const ZQTriF &other) const noexcept;
+        inline ZQPolygonF united(const ZQTriF &other) const noexcept;
+        inline ZQPolygonF intersected(const ZQTriF &other) const noexcept;
         bool intersects(const ZQTriF &r) const noexcept;
+        bool intersects(const ZQPreparedTriF &r) const noexcept;
 
         bool isAcute() const noexcept;
         bool isRight() const noexcept;
@@ -1000,7 +1012,14 @@ namespace z_qtshapes {
         bool isEquilateral() const noexcept;
         bool isScalene() const noexcept { return !isIso(); }
 
+        ZQPreparedTriF prepared() const noexcept;
+        QRectF boundingRect() const noexcept;
+        constexpr inline int tessellationVertexCount(qreal = 0) const noexcept { return 3; }
+        constexpr inline int tessellationIndexCount(qreal = 0) const noexcept { return 3; }
+        void tessellate(qreal tolerance, float *vertices, quint32 *indices, quint32 baseVertex = 0) const noexcept;
+
         QPainterPath toPath() const noexcept;
+        ZQPolygonF toPolygon() const noexcept;
         QPainterPath toPath(const QMatrix3x3 &mat, const QPointF &ref) const noexcept;
         QString toString() const noexcept;
 
@@ -1099,7 +1118,7 @@ namespace z_qtshapes {
     { return M_PI/180 * a; }
 
     constexpr inline QPointF ZQTriF::first() const noexcept
-    { return QPoint(x1p, y1p); }
+    { return QPointF(x1p, y1p); }
 
     constexpr inline QPointF ZQTriF::second() const noexcept
     { return QPointF(x2p, y2p); }
@@ -1108,7 +1127,7 @@ namespace z_qtshapes {
     { return QPointF(x3p, y3p); }
 
     constexpr inline QPointF ZQTriF::center() const noexcept
-    { return QPointF((y1p + y2p + y3p)/3, (y1p + y2p + y3p)/3); }
+    { return QPointF((x1p + x2p + x3p)/3, (y1p + y2p + y3p)/3); }
 
     inline qreal ZQTriF::length12() const noexcept
     {
@@ -1598,12 +1617,12 @@ namespace z_qtshapes {
         return contains(QPointF(ax, ay));
     }
 
-    inline QPainterPath ZQTriF::intersected(const ZQTriF &r) const noexcept
+    inline ZQPolygonF ZQTriF::intersected(const ZQTriF &r) const noexcept
     {
         return *this & r;
     }
 
-    inline QPainterPath ZQTriF::united(const ZQTriF &r) const noexcept
+    inline ZQPolygonF ZQTriF::united(const ZQTriF &r) const noexcept
     {
         return *this | r;
     }
@@ -1694,6 +1713,49 @@ namespace z_qtshapes {
     QDebug operator<<(QDebug, const ZQTriF &);
     #endif
 
+    /*****************************************************************************
+      ZQPreparedTriF
+     *****************************************************************************/
+
+    class ZQPreparedTriF {
+    public:
+        constexpr ZQPreparedTriF() noexcept : v{}, ca(1.), sa(0.), a(0.), bx1(0.), by1(0.), bx2(0.), by2(0.) {}
+        ZQPreparedTriF(const QPointF &first, const QPointF &second, const QPointF &third,
+                const QPointF &rotationCenter, qreal angle) noexcept;
+        ZQPreparedTriF(const QPointF &first, const QPointF &second, const QPointF &third,
+                const QPointF &rotationCenter, qreal angle, qreal cosAngle, qreal sinAngle) noexcept;
+
+        constexpr inline QPointF first() const noexcept { return v[0]; }
+        constexpr inline QPointF second() const noexcept { return v[1]; }
+        constexpr inline QPointF third() const noexcept { return v[2]; }
+        constexpr inline qreal angle() const noexcept { return a; }
+        constexpr inline qreal cosAngle() const noexcept { return ca; }
+        constexpr inline qreal sinAngle() const noexcept { return sa; }
+        constexpr inline QRectF boundingRect() const noexcept { return QRectF(bx1, by1, bx2 - bx1, by2 - by1); }
+
+        bool contains(const QPointF &p, bool proper=false) const noexcept;
+        bool contains(const ZQPreparedTriF &r, bool proper=false) const noexcept;
+        bool intersects(const ZQPreparedTriF &r) const noexcept;
+
+        QPainterPath toPath() const noexcept;
+        ZQPolygonF toPolygon() const noexcept;
+        QPainterPath toPath(const QMatrix3x3 &mat, const QPointF &ref) const noexcept;
+
+        constexpr inline int tessellationVertexCount(qreal = 0) const noexcept { return 3; }
+        constexpr inline int tessellationIndexCount(qreal = 0) const noexcept { return 3; }
+        void tessellate(qreal tolerance, float *vertices, quint32 *indices, quint32 baseVertex = 0) const noexcept;
+
+    private:
+        QPointF v[3];
+        qreal ca;
+        qreal sa;
+        qreal a;
+        qreal bx1;
+        qreal by1;
+        qreal bx2;
+        qreal by2;
+    };
+
 }
 
 #endif
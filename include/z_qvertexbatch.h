@@ -0,0 +1,78 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#ifndef Z_QVERTEXBATCH_H
+#define Z_QVERTEXBATCH_H
+
+#include <memory>
+
+#include <QtWidgets>
+#include <QVector>
+#include "z_qpreparedshape.h"
+
+namespace z_qtshapes {
+
+    class ZQVertexBatch {
+    public:
+        typedef int Id;
+
+        // One interleaved vertex: the position in view coordinates and the
+        // Id of the shape it belongs to.
+        struct Vertex {
+            float x;
+            float y;
+            quint32 id;
+        };
+
+        // A run of count elements starting at first.
+        struct Range {
+            int first;
+            int count;
+        };
+
+        enum BuildResult {
+            Unchanged,
+            Updated,
+            Rebuilt
+        };
+
+        ZQVertexBatch();
+        ~ZQVertexBatch();
+        ZQVertexBatch(ZQVertexBatch &&other);
+        ZQVertexBatch &operator=(ZQVertexBatch &&other) noexcept;
+
+        Id insert(const ZQPreparedShape &shape);
+        bool update(Id id, const ZQPreparedShape &shape);
+        bool remove(Id id);
+        void clear();
+
+        bool contains(Id id) const noexcept;
+        const ZQPreparedShape &shape(Id id) const noexcept;
+        int size() const noexcept;
+        inline bool isEmpty() const noexcept { return size() == 0; }
+
+        void setViewMatrix(const QMatrix3x3 &view);
+        QMatrix3x3 viewMatrix() const noexcept;
+        void setTolerance(qreal tolerance);
+        qreal tolerance() const noexcept;
+        void setLineWidth(qreal width);
+        qreal lineWidth() const noexcept;
+
+        BuildResult build();
+
+        const Vertex *vertexData() const noexcept;
+        int vertexCount() const noexcept;
+        const quint32 *indexData() const noexcept;
+        int indexCount() const noexcept;
+        const QVector<Range> &updatedVertices() const noexcept;
+        const QVector<Range> &updatedIndices() const noexcept;
+
+    private:
+        Q_DISABLE_COPY(ZQVertexBatch)
+
+        class Private;
+        std::unique_ptr<Private> d;
+    };
+
+}
+
+#endif
@@ -0,0 +1,24 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#ifndef Z_SIMDLEVEL_H
+#define Z_SIMDLEVEL_H
+
+namespace z_qtshapes {
+
+    /*
+     * The instruction sets the vector kernels are written for. Every
+     * batched routine takes the highest level it may use and runs at the
+     * lower of that and supportedSimdLevel().
+     */
+    enum ZQSimdLevel {
+        ZQScalarLevel,
+        ZQSSE2Level,
+        ZQAVX2Level,
+        ZQAVX512Level
+    };
+
+    ZQSimdLevel supportedSimdLevel() noexcept;
+
+}
+
+#endif
@@ -0,0 +1,420 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#ifndef Z_SPARSEMATRIX_H
+#define Z_SPARSEMATRIX_H
+
+#include <algorithm>
+#include <cassert>
+#include <QtWidgets>
+#include <QAtomicInt>
+#include <QDebug>
+#include <QThreadPool>
+#include <QVector>
+#include "z_aligned.h"
+#include "z_qparallel.h"
+#include "z_dynmatrix.h"
+#include "z_matrixtraits.h"
+
+namespace z_linalg {
+
+    /*
+     * One nonzero of a sparse matrix, as handed to
+     * ZQSparseMatrix::setFromTriplets(). Indices start at zero.
+     */
+    template <typename T>
+     struct ZQTriplet {
+        int row;
+        int column;
+        T value;
+
+        ZQTriplet() : row(0), column(0), value(0) {}
+        ZQTriplet(int row_, int column_, T value_) : row(row_), column(column_), value(value_) {}
+    };
+
+    /*
+     * A sparse matrix in compressed row (CSR) or compressed column (CSC)
+     * storage, numbered from zero like ZQMatrix. For CSR the entries of
+     * row i are at offsets()[i] up to offsets()[i+1] in indices(), which
+     * holds their columns in ascending order, and in values(); CSC is the
+     * same with rows and columns exchanged. The arrays are implicitly
+     * shared, so copies and transposed() are cheap.
+     *
+     * The matrix is built from a list of triplets in time linear in their
+     * number, without ever forming the dense matrix, which is what the
+     * row-indexed sa/ija routines in z_linalg.h need. fromRowIndexed()
+     * converts from that format.
+     *
+     * multiply() and multiplyTransposed() spread large products over a
+     * thread pool. The product with the compressed direction (A x for
+     * CSR, A' x for CSC) gives each thread whole output entries. The
+     * other one scatters into the output, so the entries are split into a
+     * number of blocks that depends only on the matrix, each summed into
+     * its own copy of the output and the copies added up in a fixed
+     * order; either way the result does not depend on how many threads
+     * ran.
+     */
+    template <typename T>
+     class ZQSparseMatrix {
+    public:
+        typedef int index_type;
+        typedef T value_type;
+
+        enum Storage {
+            CompressedRows,
+            CompressedColumns
+        };
+
+        inline ZQSparseMatrix();
+        inline ZQSparseMatrix(int rows, int columns, Storage storage = CompressedRows);
+
+        template <typename InputIterator>
+         void setFromTriplets(InputIterator first, InputIterator last);
+
+        template <typename ValueArray, typename IndexArray>
+         static ZQSparseMatrix<T> fromRowIndexed(const ValueArray &sa, const IndexArray &ija,
+                                                 Storage storage = CompressedRows);
+
+        inline int rows() const { return M; }
+        inline int columns() const { return N; }
+        inline int nonZeros() const { return idx.size(); }
+        inline Storage storage() const { return store; }
+
+        inline const QVector<int> &offsets() const { return off; }
+        inline const QVector<int> &indices() const { return idx; }
+        inline const QVector<T> &values() const { return val; }
+
+        inline T value(int row, int column) const;
+        inline ZQSparseMatrix<T> transposed() const;
+        ZQSparseMatrix<T> converted(Storage storage) const;
+        ZQDynMatrix<T> toDense() const;
+
+        void multiply(const T *x, T *y, QThreadPool *pool = QThreadPool::globalInstance()) const;
+        void multiplyTransposed(const T *x, T *y, QThreadPool *pool = QThreadPool::globalInstance()) const;
+
+        // Products with fewer nonzeros than this run on the calling thread.
+        enum { ParallelThreshold = 1 << 15 };
+
+    private:
+        inline int outerSize() const { return store == CompressedRows ? M : N; }
+        inline int innerSize() const { return store == CompressedRows ? N : M; }
+
+        void gather(const T *x, T *y, QThreadPool *pool) const;
+        void scatter(const T *x, T *y, QThreadPool *pool) const;
+
+        int M, N;
+        Storage store;
+        QVector<int> off;
+        QVector<int> idx;
+        QVector<T> val;
+    };
+
+    template <typename T>
+     QDebug operator<<(QDebug dbg, const ZQSparseMatrix<T> &m);
+
+    template <typename T>
+     inline ZQSparseMatrix<T>::ZQSparseMatrix()
+        : M(0), N(0), store(CompressedRows), off(1, 0)
+    {
+    }
+
+    template <typename T>
+     inline ZQSparseMatrix<T>::ZQSparseMatrix(int rows, int columns, Storage storage)
+        : M(rows), N(columns), store(storage), off((storage == CompressedRows ? rows : columns) + 1, 0)
+    {
+        assert(rows >= 0 && columns >= 0 /* "Negative matrix size" */);
+    }
+
+    /*
+     * Replaces the contents by the triplets in [first, last), which must
+     * lie within the matrix and may come in any order. Values given more
+     * than once for the same position are added up. The triplets are
+     * bucketed by inner index and then by outer index, which leaves every
+     * row (or column) sorted without comparing anything.
+     */
+    template <typename T>
+    template <typename InputIterator>
+     void ZQSparseMatrix<T>::setFromTriplets(InputIterator first, InputIterator last)
+    {
+        const bool rowMajor = store == CompressedRows;
+        const int outer = outerSize(), inner = innerSize();
+
+        QVector<int> start(inner + 1, 0);
+        int count = 0;
+        for (InputIterator it = first; it != last; ++it) {
+            assert(it->row >= 0 && it->row < M /* "Row index is out of range" */);
+            assert(it->column >= 0 && it->column < N /* "Column index is out of range" */);
+            ++start[(rowMajor ? it->column : it->row) + 1];
+            ++count;
+        }
+        for (int j = 0; j < inner; ++j)
+            start[j+1] += start[j];
+
+        QVector<int> byInnerOuter(count);
+        QVector<T> byInnerValue(count);
+        QVector<int> next = start;
+        for (InputIterator it = first; it != last; ++it) {
+            const int p = next[rowMajor ? it->column : it->row]++;
+            byInnerOuter[p] = rowMajor ? it->row : it->column;
+            byInnerValue[p] = it->value;
+        }
+
+        off = QVector<int>(outer + 1, 0);
+        for (int p = 0; p < count; ++p)
+            ++off[byInnerOuter[p] + 1];
+        for (int o = 0; o < outer; ++o)
+            off[o+1] += off[o];
+
+        idx = QVector<int>(count);
+        val = QVector<T>(count);
+        next = off;
+        for (int j = 0; j < inner; ++j) {
+            for (int p = start[j]; p < start[j+1]; ++p) {
+                const int q = next[byInnerOuter[p]]++;
+                idx[q] = j;
+                val[q] = byInnerValue[p];
+            }
+        }
+
+        // Add up duplicates, which are now next to each other.
+        int w = 0, begin = 0;
+        for (int o = 0; o < outer; ++o) {
+            const int end = off[o+1];
+            const int rowStart = w;
+            for (int q = begin; q < end; ++q) {
+                if (w > rowStart && idx[w-1] == idx[q]) {
+                    val[w-1] += val[q];
+                } else {
+                    idx[w] = idx[q];
+                    val[w] = val[q];
+                    ++w;
+                }
+            }
+            off[o+1] = w;
+            begin = end;
+        }
+        idx.resize(w);
+        val.resize(w);
+    }
+
+    /*
+     * Builds the matrix held in the row-indexed arrays sa[1..nmax] and
+     * ija[1..nmax] of sparse_in_zq(), numbering it from zero. Diagonal
+     * elements that are zero are left out. sa and ija may be any matrix
+     * types with a single column, such as ZQOffsetMatrix<1, nmax, 0, 0, T>
+     * and ZQOffsetMatrix<1, nmax, 0, 0, int>. Their first rows are read as
+     * element 1 however they are numbered; the positions held in ija are
+     * 1-based either way.
+     */
+    template <typename T>
+    template <typename ValueArray, typename IndexArray>
+     ZQSparseMatrix<T> ZQSparseMatrix<T>::fromRowIndexed(const ValueArray &sa, const IndexArray &ija, Storage storage)
+    {
+        typedef matrix_traits<ValueArray> vt;
+        typedef matrix_traits<IndexArray> it;
+        const int sr = vt::min_row(sa) - 1, sc = vt::min_column(sa);
+        const int ir = it::min_row(ija) - 1, ic = it::min_column(ija);
+        const int n = it::element(ija, ir+1, ic) - 2;
+        assert(n >= 0 /* "ija does not hold row-indexed storage" */);
+
+        QVector<ZQTriplet<T>> triplets;
+        triplets.reserve(n + it::element(ija, ir+n+1, ic) - it::element(ija, ir+1, ic));
+        for (int i = 1; i <= n; ++i) {
+            const T d = vt::element(sa, sr+i, sc);
+            if (d != T(0))
+                triplets.append(ZQTriplet<T>(i-1, i-1, d));
+            for (int k = it::element(ija, ir+i, ic); k < it::element(ija, ir+i+1, ic); ++k)
+                triplets.append(ZQTriplet<T>(i-1, it::element(ija, ir+k, ic)-1, vt::element(sa, sr+k, sc)));
+        }
+
+        ZQSparseMatrix<T> result(n, n, storage);
+        result.setFromTriplets(triplets.cbegin(), triplets.cend());
+        return result;
+    }
+
+    template <typename T>
+     inline T ZQSparseMatrix<T>::value(int row, int column) const
+    {
+        assert(row >= 0 && row < M /* "Row index is out of range" */);
+        assert(column >= 0 && column < N /* "Column index is out of range" */);
+        const int o = store == CompressedRows ? row : column;
+        const int i = store == CompressedRows ? column : row;
+        const int *begin = idx.constData() + off[o], *end = idx.constData() + off[o+1];
+        const int *p = std::lower_bound(begin, end, i);
+        return p != end && *p == i ? val[int(p - idx.constData())] : T(0);
+    }
+
+    // The transpose shares the arrays, stored the other way round.
+    template <typename T>
+     inline ZQSparseMatrix<T> ZQSparseMatrix<T>::transposed() const
+    {
+        ZQSparseMatrix<T> result(*this);
+        result.M = N;
+        result.N = M;
+        result.store = store == CompressedRows ? CompressedColumns : CompressedRows;
+        return result;
+    }
+
+    // The same matrix in the given storage.
+    template <typename T>
+     ZQSparseMatrix<T> ZQSparseMatrix<T>::converted(Storage storage) const
+    {
+        if (storage == store)
+            return *this;
+        const int outer = outerSize(), inner = innerSize();
+        ZQSparseMatrix<T> result(M, N, storage);
+        QVector<int> &roff = result.off;
+        for (int q = 0; q < idx.size(); ++q)
+            ++roff[idx[q] + 1];
+        for (int j = 0; j < inner; ++j)
+            roff[j+1] += roff[j];
+        result.idx = QVector<int>(idx.size());
+        result.val = QVector<T>(idx.size());
+        QVector<int> next = roff;
+        for (int o = 0; o < outer; ++o) {
+            for (int q = off[o]; q < off[o+1]; ++q) {
+                const int p = next[idx[q]]++;
+                result.idx[p] = o;
+                result.val[p] = val[q];
+            }
+        }
+        return result;
+    }
+
+    template <typename T>
+     ZQDynMatrix<T> ZQSparseMatrix<T>::toDense() const
+    {
+        ZQDynMatrix<T> result(M, N);
+        for (int o = 0; o < outerSize(); ++o)
+            for (int q = off[o]; q < off[o+1]; ++q) {
+                if (store == CompressedRows)
+                    result(o, idx[q]) = val[q];
+                else
+                    result(idx[q], o) = val[q];
+            }
+        return result;
+    }
+
+    /*
+     * y = A x, with x of size columns() and y of size rows(). y must not
+     * overlap x.
+     */
+    template <typename T>
+     void ZQSparseMatrix<T>::multiply(const T *x, T *y, QThreadPool *pool) const
+    {
+        if (store == CompressedRows)
+            gather(x, y, pool);
+        else
+            scatter(x, y, pool);
+    }
+
+    /*
+     * y = A' x, with x of size rows() and y of size columns(), without
+     * forming the transpose. y must not overlap x.
+     */
+    template <typename T>
+     void ZQSparseMatrix<T>::multiplyTransposed(const T *x, T *y, QThreadPool *pool) const
+    {
+        if (store == CompressedRows)
+            scatter(x, y, pool);
+        else
+            gather(x, y, pool);
+    }
+
+    // y[o] is the dot product of the o-th compressed row (or column) with x.
+    template <typename T>
+     void ZQSparseMatrix<T>::gather(const T *x, T *y, QThreadPool *pool) const
+    {
+        const int outer = outerSize();
+        const int *o_ = off.constData();
+        const int *i_ = idx.constData();
+        const T *v_ = val.constData();
+        const int chunk = 256;
+        QAtomicInt next(0);
+        auto work = [&]() {
+            int first;
+            while ((first = next.fetchAndAddRelaxed(chunk)) < outer) {
+                const int last = qMin(first + chunk, outer);
+                for (int o = first; o < last; ++o) {
+                    T sum(0);
+                    for (int q = o_[o]; q < o_[o+1]; ++q)
+                        sum += v_[q] * x[i_[q]];
+                    y[o] = sum;
+                }
+            }
+        };
+        if (nonZeros() < ParallelThreshold)
+            pool = nullptr;
+        z_qtshapes::runOnPool(pool, pool ? qMin((outer + chunk - 1) / chunk, pool->maxThreadCount()) : 1, work);
+    }
+
+    // y[inner] += v * x[o] over all entries: every block of entries,
+    // balanced by count, adds into its own copy of y.
+    template <typename T>
+     void ZQSparseMatrix<T>::scatter(const T *x, T *y, QThreadPool *pool) const
+    {
+        const int outer = outerSize(), inner = innerSize();
+        const int *o_ = off.constData();
+        const int *i_ = idx.constData();
+        const T *v_ = val.constData();
+        const int blocks = qBound(1, qMin(nonZeros() / int(ParallelThreshold), nonZeros() / qMax(1, 2 * inner)), 16);
+
+        std::fill(y, y + inner, T(0));
+        z_qtshapes::ZQAlignedBuffer<T> partial((blocks - 1) * inner);
+        QAtomicInt nextBlock(0);
+        auto work = [&]() {
+            int b;
+            while ((b = nextBlock.fetchAndAddRelaxed(1)) < blocks) {
+                T *out = b == 0 ? y : partial.data() + (b - 1) * inner;
+                const int begin = int(std::lower_bound(o_, o_ + outer, int(qint64(nonZeros()) * b / blocks)) - o_);
+                const int end = int(std::lower_bound(o_, o_ + outer, int(qint64(nonZeros()) * (b + 1) / blocks)) - o_);
+                for (int o = begin; o < end; ++o) {
+                    const T xo = x[o];
+                    for (int q = o_[o]; q < o_[o+1]; ++q)
+                        out[i_[q]] += v_[q] * xo;
+                }
+            }
+        };
+        if (blocks == 1)
+            pool = nullptr;
+        z_qtshapes::runOnPool(pool, pool ? qMin(blocks, pool->maxThreadCount()) : 1, work);
+
+        if (blocks == 1)
+            return;
+        const int chunk = 4096;
+        QAtomicInt next(0);
+        auto reduce = [&]() {
+            int first;
+            while ((first = next.fetchAndAddRelaxed(chunk)) < inner) {
+                const int last = qMin(first + chunk, inner);
+                for (int b = 1; b < blocks; ++b) {
+                    const T *in = partial.data() + (b - 1) * inner;
+                    for (int j = first; j < last; ++j)
+                        y[j] += in[j];
+                }
+            }
+        };
+        z_qtshapes::runOnPool(pool, pool ? qMin((inner + chunk - 1) / chunk, pool->maxThreadCount()) : 1, reduce);
+    }
+
+    // Every column of X multiplied by A.
+    template <typename T>
+     ZQDynMatrix<T> operator*(const ZQSparseMatrix<T> &A, const ZQDynMatrix<T> &X)
+    {
+        assert(A.columns() == X.rows() /* "Inner matrix dimensions do not agree" */);
+        ZQDynMatrix<T> result(A.rows(), X.columns(), 0, X.min_column());
+        for (int col = X.min_column(); col <= X.max_column(); ++col)
+            A.multiply(X.columnData(col), result.columnData(col));
+        return result;
+    }
+
+    template <typename T>
+     QDebug operator<<(QDebug dbg, const ZQSparseMatrix<T> &m)
+    {
+        dbg.nospace() << "ZQSparseMatrix(" << m.rows() << ", " << m.columns() << ", "
+                      << m.nonZeros() << (m.storage() == ZQSparseMatrix<T>::CompressedRows ? ", CSR)" : ", CSC)");
+        return dbg.space();
+    }
+
+}
+
+#endif
@@ -0,0 +1,337 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#include "z_gemm.h"
+#include "z_aligned.h"
+#include <algorithm>
+
+/*
+ * The product follows the usual layout of an optimised GEMM. B is cut
+ * into blocks of KC rows and NC columns and packed so that every group of
+ * NR columns is contiguous; A is cut into blocks of MC rows and KC
+ * columns and packed into groups of MR rows. A micro-kernel then
+ * multiplies one MR-row group by one NR-column group, keeping the whole
+ * MR x NR tile of C in registers for the full KC steps. The packed A
+ * block stays in L2 and each packed B group in L1 while they are used.
+ *
+ * Each vector kernel carries its own target attribute, so this file
+ * needs no special compiler flags and the kernels only run once CPUID
+ * says they can. ZQAVX2Level does not imply FMA, so the FMA kernels check
+ * for it here.
+ */
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define Z_SIMD_X86
+#  include <immintrin.h>
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#  else
+#    include <cpuid.h>
+#  endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#  define Z_SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+#  define Z_SIMD_TARGET(isa)
+#endif
+
+
+namespace z_linalg {
+
+    namespace {
+
+        template <typename T> struct Blocking;
+
+        // 12 of the 16 YMM registers hold the tile of C; two hold a column
+        // of the A group and one a broadcast entry of B.
+        template <> struct Blocking<double> {
+            enum { MR = 8, NR = 6, MC = 96, KC = 256, NC = 3072 };
+        };
+
+        template <> struct Blocking<float> {
+            enum { MR = 16, NR = 6, MC = 96, KC = 256, NC = 3072 };
+        };
+
+        // Multiplies a packed MR-row group of A by a packed NR-column group
+        // of B over kc steps and stores the MR x NR tile, column-major, in ab.
+        template <typename T>
+         using Kernel = void (*)(int kc, const T *a, const T *b, T *ab);
+
+        template <typename T>
+         void kernelScalar(int kc, const T *a, const T *b, T *ab) noexcept
+        {
+            const int MR = Blocking<T>::MR, NR = Blocking<T>::NR;
+            T acc[MR * NR] = {};
+            for (int p = 0; p < kc; ++p) {
+                for (int j = 0; j < NR; ++j) {
+                    const T bj = b[j];
+                    for (int i = 0; i < MR; ++i)
+                        acc[j*MR + i] += a[i] * bj;
+                }
+                a += MR;
+                b += NR;
+            }
+            std::copy(acc, acc + MR * NR, ab);
+        }
+
+    #ifdef Z_SIMD_X86
+
+        Z_SIMD_TARGET("avx2,fma") void kernelAVX2(int kc, const double *a, const double *b, double *ab) noexcept
+        {
+            __m256d c00 = _mm256_setzero_pd(), c10 = _mm256_setzero_pd();
+            __m256d c01 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+            __m256d c02 = _mm256_setzero_pd(), c12 = _mm256_setzero_pd();
+            __m256d c03 = _mm256_setzero_pd(), c13 = _mm256_setzero_pd();
+            __m256d c04 = _mm256_setzero_pd(), c14 = _mm256_setzero_pd();
+            __m256d c05 = _mm256_setzero_pd(), c15 = _mm256_setzero_pd();
+            for (int p = 0; p < kc; ++p) {
+                const __m256d a0 = _mm256_load_pd(a);
+                const __m256d a1 = _mm256_load_pd(a + 4);
+                __m256d bj = _mm256_broadcast_sd(b);
+                c00 = _mm256_fmadd_pd(a0, bj, c00);
+                c10 = _mm256_fmadd_pd(a1, bj, c10);
+                bj = _mm256_broadcast_sd(b + 1);
+                c01 = _mm256_fmadd_pd(a0, bj, c01);
+                c11 = _mm256_fmadd_pd(a1, bj, c11);
+                bj = _mm256_broadcast_sd(b + 2);
+                c02 = _mm256_fmadd_pd(a0, bj, c02);
+                c12 = _mm256_fmadd_pd(a1, bj, c12);
+                bj = _mm256_broadcast_sd(b + 3);
+                c03 = _mm256_fmadd_pd(a0, bj, c03);
+                c13 = _mm256_fmadd_pd(a1, bj, c13);
+                bj = _mm256_broadcast_sd(b + 4);
+                c04 = _mm256_fmadd_pd(a0, bj, c04);
+                c14 = _mm256_fmadd_pd(a1, bj, c14);
+                bj = _mm256_broadcast_sd(b + 5);
+                c05 = _mm256_fmadd_pd(a0, bj, c05);
+                c15 = _mm256_fmadd_pd(a1, bj, c15);
+                a += 8;
+                b += 6;
+            }
+            _mm256_store_pd(ab, c00);
+            _mm256_store_pd(ab + 4, c10);
+            _mm256_store_pd(ab + 8, c01);
+            _mm256_store_pd(ab + 12, c11);
+            _mm256_store_pd(ab + 16, c02);
+            _mm256_store_pd(ab + 20, c12);
+            _mm256_store_pd(ab + 24, c03);
+            _mm256_store_pd(ab + 28, c13);
+            _mm256_store_pd(ab + 32, c04);
+            _mm256_store_pd(ab + 36, c14);
+            _mm256_store_pd(ab + 40, c05);
+            _mm256_store_pd(ab + 44, c15);
+        }
+
+        Z_SIMD_TARGET("avx2,fma") void kernelAVX2(int kc, const float *a, const float *b, float *ab) noexcept
+        {
+            __m256 c00 = _mm256_setzero_ps(), c10 = _mm256_setzero_ps();
+            __m256 c01 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+            __m256 c02 = _mm256_setzero_ps(), c12 = _mm256_setzero_ps();
+            __m256 c03 = _mm256_setzero_ps(), c13 = _mm256_setzero_ps();
+            __m256 c04 = _mm256_setzero_ps(), c14 = _mm256_setzero_ps();
+            __m256 c05 = _mm256_setzero_ps(), c15 = _mm256_setzero_ps();
+            for (int p = 0; p < kc; ++p) {
+                const __m256 a0 = _mm256_load_ps(a);
+                const __m256 a1 = _mm256_load_ps(a + 8);
+                __m256 bj = _mm256_broadcast_ss(b);
+                c00 = _mm256_fmadd_ps(a0, bj, c00);
+                c10 = _mm256_fmadd_ps(a1, bj, c10);
+                bj = _mm256_broadcast_ss(b + 1);
+                c01 = _mm256_fmadd_ps(a0, bj, c01);
+                c11 = _mm256_fmadd_ps(a1, bj, c11);
+                bj = _mm256_broadcast_ss(b + 2);
+                c02 = _mm256_fmadd_ps(a0, bj, c02);
+                c12 = _mm256_fmadd_ps(a1, bj, c12);
+                bj = _mm256_broadcast_ss(b + 3);
+                c03 = _mm256_fmadd_ps(a0, bj, c03);
+                c13 = _mm256_fmadd_ps(a1, bj, c13);
+                bj = _mm256_broadcast_ss(b + 4);
+                c04 = _mm256_fmadd_ps(a0, bj, c04);
+                c14 = _mm256_fmadd_ps(a1, bj, c14);
+                bj = _mm256_broadcast_ss(b + 5);
+                c05 = _mm256_fmadd_ps(a0, bj, c05);
+                c15 = _mm256_fmadd_ps(a1, bj, c15);
+                a += 16;
+                b += 6;
+            }
+            _mm256_store_ps(ab, c00);
+            _mm256_store_ps(ab + 8, c10);
+            _mm256_store_ps(ab + 16, c01);
+            _mm256_store_ps(ab + 24, c11);
+            _mm256_store_ps(ab + 32, c02);
+            _mm256_store_ps(ab + 40, c12);
+            _mm256_store_ps(ab + 48, c03);
+            _mm256_store_ps(ab + 56, c13);
+            _mm256_store_ps(ab + 64, c04);
+            _mm256_store_ps(ab + 72, c14);
+            _mm256_store_ps(ab + 80, c05);
+            _mm256_store_ps(ab + 88, c15);
+        }
+
+    #endif
+
+        // Rows [i0, i0 + mc) and columns [p0, p0 + kc) of A, as groups of MR
+        // rows with each group's columns one after the other. The last
+        // group is padded with zeros.
+        template <typename T>
+         void packA(int mc, int kc, const T *a, int lda, T *pa) noexcept
+        {
+            const int MR = Blocking<T>::MR;
+            for (int ir = 0; ir < mc; ir += MR) {
+                const int mr = std::min(MR, mc - ir);
+                for (int p = 0; p < kc; ++p) {
+                    const T *s = a + p*lda + ir;
+                    for (int i = 0; i < mr; ++i)
+                        pa[i] = s[i];
+                    for (int i = mr; i < MR; ++i)
+                        pa[i] = T(0);
+                    pa += MR;
+                }
+            }
+        }
+
+        // Rows [p0, p0 + kc) and columns [j0, j0 + nc) of B, as groups of NR
+        // columns with each group's rows one after the other.
+        template <typename T>
+         void packB(int kc, int nc, const T *b, int ldb, T *pb) noexcept
+        {
+            const int NR = Blocking<T>::NR;
+            for (int jr = 0; jr < nc; jr += NR) {
+                const int nr = std::min(NR, nc - jr);
+                for (int p = 0; p < kc; ++p) {
+                    for (int j = 0; j < nr; ++j)
+                        pb[j] = b[(jr + j)*ldb + p];
+                    for (int j = nr; j < NR; ++j)
+                        pb[j] = T(0);
+                    pb += NR;
+                }
+            }
+        }
+
+        template <typename T>
+         void gemmBlocked(int m, int n, int k, const T *a, int lda, const T *b, int ldb, T *c, int ldc, Kernel<T> kernel)
+        {
+            const int MR = Blocking<T>::MR, NR = Blocking<T>::NR;
+            const int MC = Blocking<T>::MC, KC = Blocking<T>::KC, NC = Blocking<T>::NC;
+            if (m <= 0 || n <= 0)
+                return;
+            if (k <= 0) {
+                for (int col = 0; col < n; ++col)
+                    std::fill(c + col*ldc, c + col*ldc + m, T(0));
+                return;
+            }
+
+            const int kb = std::min(k, int(KC));
+            z_qtshapes::ZQAlignedBuffer<T> pa((std::min(m, int(MC)) + MR - 1) / MR * MR * kb);
+            z_qtshapes::ZQAlignedBuffer<T> pb((std::min(n, int(NC)) + NR - 1) / NR * NR * kb);
+            alignas(64) T ab[Blocking<T>::MR * Blocking<T>::NR];
+
+            for (int jc = 0; jc < n; jc += NC) {
+                const int nc = std::min(int(NC), n - jc);
+                for (int pc = 0; pc < k; pc += KC) {
+                    const int kc = std::min(int(KC), k - pc);
+                    const bool first = pc == 0;
+                    packB(kc, nc, b + jc*ldb + pc, ldb, pb.data());
+                    for (int ic = 0; ic < m; ic += MC) {
+                        const int mc = std::min(int(MC), m - ic);
+                        packA(mc, kc, a + pc*lda + ic, lda, pa.data());
+                        for (int jr = 0; jr < nc; jr += NR) {
+                            const int nr = std::min(NR, nc - jr);
+                            for (int ir = 0; ir < mc; ir += MR) {
+                                const int mr = std::min(MR, mc - ir);
+                                kernel(kc, pa.data() + ir*kc, pb.data() + jr*kc, ab);
+                                T *t = c + (jc + jr)*ldc + ic + ir;
+                                for (int j = 0; j < nr; ++j, t += ldc) {
+                                    const T *s = ab + j*MR;
+                                    if (first)
+                                        for (int i = 0; i < mr; ++i)
+                                            t[i] = s[i];
+                                    else
+                                        for (int i = 0; i < mr; ++i)
+                                            t[i] += s[i];
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+    #ifdef Z_SIMD_X86
+        // CPUID leaf 1, ECX bit 12. The YMM state the FMA kernels also need
+        // is already checked by supportedSimdLevel().
+        bool detectFma() noexcept
+        {
+        #if defined(_MSC_VER)
+            int r[4];
+            __cpuid(r, 1);
+            return unsigned(r[2]) & (1u << 12);
+        #else
+            unsigned a, b, c, d;
+            if (!__get_cpuid(1, &a, &b, &c, &d))
+                return false;
+            return c & (1u << 12);
+        #endif
+        }
+
+        bool supportsFma() noexcept
+        {
+            static const bool fma = detectFma();
+            return fma;
+        }
+    #endif
+
+        template <typename T>
+         Kernel<T> selectKernel(z_qtshapes::ZQSimdLevel level) noexcept
+        {
+        #ifdef Z_SIMD_X86
+            if (qMin(level, z_qtshapes::supportedSimdLevel()) >= z_qtshapes::ZQAVX2Level && supportsFma())
+                return static_cast<Kernel<T>>(kernelAVX2);
+        #else
+            Q_UNUSED(level);
+        #endif
+            return kernelScalar<T>;
+        }
+
+    }
+
+    /*!
+        \fn void gemm(int m, int n, int k, const double *a, int lda, const double *b, int ldb, double *c, int ldc, ZQSimdLevel level)
+        \relates ZQDynMatrix
+
+        Computes C = A B, where A is the \a m by \a k matrix at \a a, B the
+        \a k by \a n matrix at \a b and C the \a m by \a n matrix at \a c,
+        all stored by columns with \a lda, \a ldb and \a ldc elements
+        between the starts of consecutive columns. C is overwritten, and
+        set to zero when \a k is zero. C must not overlap A or B.
+
+        The operands are packed block by block into aligned buffers and
+        multiplied in 8 by 6 tiles held in registers, with AVX2 and FMA
+        when \a level is at least ZQAVX2Level and the processor has both,
+        and portable code otherwise. The ZQAVX512Level uses the AVX2
+        kernel. The sums are formed in a different order from the plain
+        triple loop, so the results may differ from it in the last bits.
+
+        \sa matrixProduct(), supportedSimdLevel()
+    */
+
+    void gemm(int m, int n, int k, const double *a, int lda, const double *b, int ldb, double *c, int ldc,
+              z_qtshapes::ZQSimdLevel level)
+    {
+        gemmBlocked(m, n, k, a, lda, b, ldb, c, ldc, selectKernel<double>(level));
+    }
+
+    /*!
+        \fn void gemm(int m, int n, int k, const float *a, int lda, const float *b, int ldb, float *c, int ldc, ZQSimdLevel level)
+        \relates ZQDynMatrix
+        \overload
+
+        The single precision product, multiplied in 16 by 6 tiles.
+    */
+
+    void gemm(int m, int n, int k, const float *a, int lda, const float *b, int ldb, float *c, int ldc,
+              z_qtshapes::ZQSimdLevel level)
+    {
+        gemmBlocked(m, n, k, a, lda, b, ldb, c, ldc, selectKernel<float>(level));
+    }
+
+}
@@ -0,0 +1,307 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#include "z_qbroadphase.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+
+namespace z_qtshapes {
+
+    namespace {
+
+        // One entry of the sweep list: the bounding rectangle of a shape.
+        // Removed shapes leave an entry with an id of -1 behind until the
+        // next sweep compacts the list.
+        struct Proxy {
+            qreal minX;
+            qreal maxX;
+            qreal minY;
+            qreal maxY;
+            ZQBroadPhase::Id id;
+        };
+
+        inline Proxy makeProxy(const ZQPreparedShape &s, ZQBroadPhase::Id id) noexcept
+        {
+            const QRectF b = s.boundingRect();
+            return Proxy{ b.left(), b.right(), b.top(), b.bottom(), id };
+        }
+
+        const ZQPreparedShape nullShape;
+
+    }
+
+    class ZQBroadPhase::Private {
+    public:
+        Private() : count(0), appended(0) {}
+
+        bool valid(Id id) const noexcept
+        {
+            return id >= 0 && id < Id(shapes.size()) && !shapes[id].isNull();
+        }
+
+        /*
+         * Brings the sweep list back into order of minX. Between frames the
+         * shapes only move a little, so an insertion sort finishes in close
+         * to linear time; a large batch of new shapes is sorted from
+         * scratch instead.
+         */
+        void sort()
+        {
+            sweep.erase(std::remove_if(sweep.begin(), sweep.end(),
+                    [](const Proxy &p) { return p.id < 0; }), sweep.end());
+
+            const std::size_t n = sweep.size();
+            if (appended > 64 && appended * 8 > n) {
+                std::sort(sweep.begin(), sweep.end(),
+                        [](const Proxy &a, const Proxy &b) { return a.minX < b.minX; });
+            } else {
+                for (std::size_t i = 1; i < n; ++i) {
+                    const Proxy p = sweep[i];
+                    std::size_t j = i;
+                    while (j > 0 && sweep[j - 1].minX > p.minX) {
+                        sweep[j] = sweep[j - 1];
+                        --j;
+                    }
+                    sweep[j] = p;
+                }
+            }
+            for (std::size_t i = 0; i < n; ++i)
+                position[sweep[i].id] = Id(i);
+            appended = 0;
+        }
+
+        template <typename Predicate>
+        QVector<Pair> pairs(Predicate exact)
+        {
+            sort();
+
+            QVector<Pair> result;
+            const std::size_t n = sweep.size();
+            for (std::size_t i = 0; i < n; ++i) {
+                const Proxy &a = sweep[i];
+                for (std::size_t j = i + 1; j < n && sweep[j].minX <= a.maxX; ++j) {
+                    const Proxy &b = sweep[j];
+                    if (b.maxY < a.minY || b.minY > a.maxY)
+                        continue;
+                    if (exact(a.id, b.id))
+                        result.append(a.id < b.id ? Pair(a.id, b.id) : Pair(b.id, a.id));
+                }
+            }
+            std::sort(result.begin(), result.end());
+            return result;
+        }
+
+        std::vector<ZQPreparedShape> shapes;
+        std::vector<Id> position;
+        std::vector<Id> freeIds;
+        std::vector<Proxy> sweep;
+        int count;
+        std::size_t appended;
+    };
+
+
+    /*!
+        \class ZQBroadPhase
+        \inmodule Zgeometry
+        \ingroup painting
+
+        \brief The ZQBroadPhase class finds all intersecting pairs in a
+        collection of mixed shapes.
+
+        The bounding rectangles of the shapes are kept in a list sorted on
+        their left edge. intersectingPairs() sweeps the list once, pairs up
+        every two shapes whose bounding rectangles overlap, and runs
+        ZQPreparedShape::intersects() on those candidates only.
+
+        The list is kept between calls. When shapes move a little from one
+        frame to the next, update() them after calling translate() or
+        rotate() on the originals, and the next sweep re-sorts the list
+        with an insertion sort that only moves the shapes that crossed
+        their neighbours.
+    */
+
+    /*!
+        \fn ZQBroadPhase::ZQBroadPhase()
+
+        Constructs an empty broad phase.
+    */
+
+    ZQBroadPhase::ZQBroadPhase() : d(new Private)
+    {
+    }
+
+    ZQBroadPhase::~ZQBroadPhase() = default;
+
+    /*!
+        \fn ZQBroadPhase::ZQBroadPhase(ZQBroadPhase &&other)
+
+        Move-constructs a broad phase from \a other, taking over its shapes
+        and its sweep list. \a other is left as if newly constructed, ready
+        for shapes to be inserted for the next frame. That new sweep state
+        is allocated, so this constructor may throw std::bad_alloc.
+    */
+
+    ZQBroadPhase::ZQBroadPhase(ZQBroadPhase &&other) : d(std::move(other.d))
+    {
+        other.d.reset(new Private);
+    }
+
+    ZQBroadPhase &ZQBroadPhase::operator=(ZQBroadPhase &&other) noexcept
+    {
+        std::swap(d, other.d);
+        return *this;
+    }
+
+    /*!
+        \fn ZQBroadPhase::Id ZQBroadPhase::insert(const ZQPreparedShape &shape)
+
+        Adds the \a shape and returns its Id. Any ZQ shape converts to a
+        ZQPreparedShape implicitly. Ids of removed shapes are reused. A null
+        shape is not added and -1 is returned.
+    */
+
+    ZQBroadPhase::Id ZQBroadPhase::insert(const ZQPreparedShape &shape)
+    {
+        if (shape.isNull())
+            return -1;
+
+        Id id;
+        if (!d->freeIds.empty()) {
+            id = d->freeIds.back();
+            d->freeIds.pop_back();
+            d->shapes[id] = shape;
+        } else {
+            id = Id(d->shapes.size());
+            d->shapes.push_back(shape);
+            d->position.push_back(-1);
+        }
+        d->position[id] = Id(d->sweep.size());
+        d->sweep.push_back(makeProxy(shape, id));
+        ++d->appended;
+        ++d->count;
+        return id;
+    }
+
+    /*!
+        \fn bool ZQBroadPhase::update(Id id, const ZQPreparedShape &shape)
+
+        Replaces the shape stored under \a id with \a shape. The sweep list
+        is re-sorted lazily by the next query. Updating to a null shape
+        removes the shape, as remove() does. Returns \c false if \a id
+        does not refer to a stored shape.
+    */
+
+    bool ZQBroadPhase::update(Id id, const ZQPreparedShape &shape)
+    {
+        if (shape.isNull())
+            return remove(id);
+        if (!d->valid(id))
+            return false;
+
+        d->shapes[id] = shape;
+        d->sweep[d->position[id]] = makeProxy(shape, id);
+        return true;
+    }
+
+    /*!
+        \fn bool ZQBroadPhase::remove(Id id)
+
+        Removes the shape stored under \a id. Returns \c false if \a id
+        does not refer to a stored shape.
+    */
+
+    bool ZQBroadPhase::remove(Id id)
+    {
+        if (!d->valid(id))
+            return false;
+
+        d->sweep[d->position[id]].id = -1;
+        d->position[id] = -1;
+        d->shapes[id] = ZQPreparedShape();
+        d->freeIds.push_back(id);
+        --d->count;
+        return true;
+    }
+
+    /*!
+        \fn void ZQBroadPhase::clear()
+
+        Removes all shapes. Ids start from zero again.
+    */
+
+    void ZQBroadPhase::clear()
+    {
+        d.reset(new Private);
+    }
+
+    /*!
+        \fn bool ZQBroadPhase::contains(Id id) const
+
+        Returns \c true if \a id refers to a stored shape.
+    */
+
+    bool ZQBroadPhase::contains(Id id) const noexcept
+    {
+        return d->valid(id);
+    }
+
+    /*!
+        \fn const ZQPreparedShape &ZQBroadPhase::shape(Id id) const
+
+        Returns the shape stored under \a id, or a null shape.
+    */
+
+    const ZQPreparedShape &ZQBroadPhase::shape(Id id) const noexcept
+    {
+        return d->valid(id) ? d->shapes[id] : nullShape;
+    }
+
+    /*!
+        \fn int ZQBroadPhase::size() const
+
+        Returns the number of stored shapes.
+    */
+
+    int ZQBroadPhase::size() const noexcept
+    {
+        return d->count;
+    }
+
+    /*!
+        \fn QVector<ZQBroadPhase::Pair> ZQBroadPhase::candidatePairs()
+
+        Returns every pair of shapes whose bounding rectangles touch or
+        overlap, without running the exact test. Each pair holds the
+        smaller Id first and the pairs are sorted.
+    */
+
+    QVector<ZQBroadPhase::Pair> ZQBroadPhase::candidatePairs()
+    {
+        return d->pairs([](Id, Id) { return true; });
+    }
+
+    /*!
+        \fn QVector<ZQBroadPhase::Pair> ZQBroadPhase::intersectingPairs()
+
+        Returns every pair of shapes that intersect according to
+        ZQPreparedShape::intersects(). Each pair holds the smaller Id first
+        and the pairs are sorted.
+    */
+
+    QVector<ZQBroadPhase::Pair> ZQBroadPhase::intersectingPairs()
+    {
+        const std::vector<ZQPreparedShape> &shapes = d->shapes;
+        return d->pairs([&shapes](Id a, Id b) { return shapes[a].intersects(shapes[b]); });
+    }
+
+    /*!
+        \fn QVector<ZQBroadPhase::Pair> ZQBroadPhase::intersectingPairs(InputIterator first, InputIterator last)
+        \overload
+
+        Returns every intersecting pair among the shapes in the range
+        [\a first, \a last). The Ids in the pairs are the positions of the
+        shapes in the range.
+    */
+
+}
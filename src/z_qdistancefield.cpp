@@ -0,0 +1,216 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#include "z_qdistancefield.h"
+#include "z_qparallel.h"
+#include <QAtomicInt>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+
+namespace z_qtshapes {
+
+    namespace {
+
+        // Gap between two axis aligned boxes given by their edges, zero if
+        // they overlap. No point of one box is closer than this to the other.
+        qreal boxGap(qreal l1, qreal t1, qreal r1, qreal b1, const QRectF &box) noexcept
+        {
+            const qreal dx = qMax(qMax(box.left() - r1, l1 - box.right()), qreal(0));
+            const qreal dy = qMax(qMax(box.top() - b1, t1 - box.bottom()), qreal(0));
+            return qSqrt(dx * dx + dy * dy);
+        }
+
+    }
+
+
+    /*!
+        \class ZQDistanceField
+        \inmodule Zgeometry
+        \ingroup painting
+
+        \brief The ZQDistanceField class samples the signed distance to a
+        shape, or to the union of a collection of shapes, on a grid.
+
+        Cell (i, j) of the grid is sampled at its center (i + 0.5, j + 0.5),
+        mapped into shape coordinates by transform(). The value written is
+        the distance in shape coordinates: negative inside rectangles,
+        triangles and ellipses, positive outside, and for a collection the
+        smallest over its shapes. Lines are segments without an inside.
+
+        A grid row maps to evenly spaced points along a line, so each row is
+        handed to distanceRow() once per shape and the distances are
+        computed several points per instruction. Rows are spread over
+        threadPool(). For a collection, the shapes of each row are visited
+        from the nearest bounding rectangle outwards, and a row stops as soon
+        as the next bounding rectangle is farther away than every distance
+        found so far; shapes far from a row cost only that comparison.
+    */
+
+    /*!
+        \fn ZQDistanceField::ZQDistanceField()
+
+        Constructs a distance field generator with the identity transform,
+        so that cell (i, j) is sampled at (i + 0.5, j + 0.5), running on the
+        global thread pool with the best instruction set available.
+    */
+
+    ZQDistanceField::ZQDistanceField() noexcept : m{ { 1, 0, 0 }, { 0, 1, 0 } },
+        tp(QThreadPool::globalInstance()), simd(ZQAVX512Level)
+    {
+    }
+
+    /*!
+        \fn void ZQDistanceField::setTransform(const QMatrix3x3 &gridToShape)
+
+        Sets the matrix that maps grid coordinates to shape coordinates to
+        \a gridToShape. It is applied to column vectors (x, y, 1); only the
+        top two rows are used, so the transform is affine.
+
+        \sa transform(), gridTransform()
+    */
+
+    void ZQDistanceField::setTransform(const QMatrix3x3 &gridToShape) noexcept
+    {
+        for (int i = 0; i < 2; ++i)
+            for (int j = 0; j < 3; ++j)
+                m[i][j] = gridToShape(i, j);
+    }
+
+    /*!
+        \fn QMatrix3x3 ZQDistanceField::transform() const
+
+        Returns the matrix that maps grid coordinates to shape coordinates.
+
+        \sa setTransform()
+    */
+
+    QMatrix3x3 ZQDistanceField::transform() const noexcept
+    {
+        QMatrix3x3 mat;
+        for (int i = 0; i < 2; ++i)
+            for (int j = 0; j < 3; ++j)
+                mat(i, j) = float(m[i][j]);
+        return mat;
+    }
+
+    /*!
+        \fn QMatrix3x3 ZQDistanceField::gridTransform(const QRectF &area, int width, int height)
+
+        Returns the transform that stretches a \a width by \a height grid
+        over \a area, so that the outer edges of the border cells lie on
+        the edges of \a area.
+    */
+
+    QMatrix3x3 ZQDistanceField::gridTransform(const QRectF &area, int width, int height) noexcept
+    {
+        QMatrix3x3 mat;
+        mat(0, 0) = width > 0 ? float(area.width() / width) : 0.f;
+        mat(0, 2) = float(area.left());
+        mat(1, 1) = height > 0 ? float(area.height() / height) : 0.f;
+        mat(1, 2) = float(area.top());
+        return mat;
+    }
+
+    /*!
+        \fn void ZQDistanceField::setThreadPool(QThreadPool *pool)
+
+        Sets the thread pool the rows are computed on to \a pool. With a
+        null \a pool everything runs on the calling thread.
+
+        \sa threadPool()
+    */
+
+    /*!
+        \fn QThreadPool *ZQDistanceField::threadPool() const
+
+        Returns the thread pool the rows are computed on.
+
+        \sa setThreadPool()
+    */
+
+    /*!
+        \fn void ZQDistanceField::setSimdLevel(ZQSimdLevel level)
+
+        Limits the instruction set passed on to distanceRow() to \a level.
+        Every level produces the same field.
+
+        \sa simdLevel()
+    */
+
+    /*!
+        \fn ZQSimdLevel ZQDistanceField::simdLevel() const
+
+        Returns the highest instruction set the rows may use.
+
+        \sa setSimdLevel()
+    */
+
+    /*!
+        \fn void ZQDistanceField::generate(const ZQPreparedShape &shape, float *field, int width, int height, int floatsPerLine) const
+
+        Writes the signed distance to \a shape into \a field, a \a width by
+        \a height grid whose rows are \a floatsPerLine floats apart. A null
+        \a shape gives infinity everywhere.
+    */
+
+    void ZQDistanceField::generate(const ZQPreparedShape &shape, float *field, int width, int height,
+            int floatsPerLine) const
+    {
+        generate(&shape, 1, field, width, height, floatsPerLine);
+    }
+
+    /*!
+        \fn void ZQDistanceField::generate(const ZQPreparedShape *shapes, int count, float *field, int width, int height, int floatsPerLine) const
+        \overload
+
+        Writes the signed distance to the union of the \a count \a shapes,
+        the smallest distance to any of them.
+    */
+
+    void ZQDistanceField::generate(const ZQPreparedShape *shapes, int count, float *field, int width, int height,
+            int floatsPerLine) const
+    {
+        if (width <= 0 || height <= 0)
+            return;
+
+        std::vector<QRectF> boxes(count);
+        for (int i = 0; i < count; ++i)
+            boxes[i] = shapes[i].boundingRect();
+
+        const QPointF step(m[0][0], m[1][0]);
+        QAtomicInt next(0);
+        auto work = [&]() {
+            std::vector<std::pair<qreal, int>> order(count);
+            int y;
+            while ((y = next.fetchAndAddRelaxed(1)) < height) {
+                float *row = field + qptrdiff(y) * floatsPerLine;
+                std::fill(row, row + width, std::numeric_limits<float>::infinity());
+
+                // The row's sample points span a segment; its bounding box
+                // gives a lower bound on the distance to each shape.
+                const qreal gy = y + qreal(0.5);
+                const QPointF origin(m[0][0] * qreal(0.5) + m[0][1] * gy + m[0][2],
+                                     m[1][0] * qreal(0.5) + m[1][1] * gy + m[1][2]);
+                const QPointF end = origin + step * (width - 1);
+                const qreal l = qMin(origin.x(), end.x()), r = qMax(origin.x(), end.x());
+                const qreal t = qMin(origin.y(), end.y()), b = qMax(origin.y(), end.y());
+
+                int n = 0;
+                for (int i = 0; i < count; ++i) {
+                    if (!shapes[i].isNull())
+                        order[n++] = std::make_pair(boxGap(l, t, r, b, boxes[i]), i);
+                }
+                std::sort(order.begin(), order.begin() + n);
+
+                float farthest = std::numeric_limits<float>::infinity();
+                for (int k = 0; k < n && order[k].first < farthest; ++k) {
+                    distanceRow(shapes[order[k].second], origin, step, row, width, simd);
+                    farthest = *std::max_element(row, row + width);
+                }
+            }
+        };
+        runOnPool(tp, tp ? qMin(height, tp->maxThreadCount()) : 1, work);
+    }
+
+}
@@ -39,6 +39,7 @@
 ****************************************************************************/
 
 #include "z_qellipse.h"
+#include "z_qpointkernels.h"
 #include <boost/geometry.hpp>
 #include <boost/geometry/geometries/register/point.hpp>
 #include <boost/geometry/geometries/register/segment.hpp>
@@ -49,6 +50,180 @@ BOOST_GEOMETRY_REGISTER_SEGMENT(QLineF, QPointF, p1, p2);
 
 namespace z_qtshapes {
 
+    namespace {
+
+        // Rim segments for an ellipse whose larger radius is r, see
+        // ZQPreparedEllipseF::segmentCount().
+        int ellipseSegmentCount(qreal r, qreal tolerance) noexcept
+        {
+            const int maxSegments = 4096;
+            if (!(r > 0) || tolerance >= r)
+                return 4;
+            if (!(tolerance > 0))
+                return maxSegments;
+
+            const qreal n = M_PI / qAcos(1 - tolerance / r);
+            if (!(n < maxSegments))
+                return maxSegments;
+            return qMax(4, (qCeil(n) + 3) & ~3);
+        }
+
+        // Evaluates c[0] + c[1] x + ... + c[degree] x^degree, and in *bound
+        // the same sum of absolute values, which scales its rounding error.
+        qreal polynomial(const qreal *c, int degree, qreal x, qreal *bound = nullptr) noexcept
+        {
+            qreal y = c[degree], b = qAbs(c[degree]);
+            for (int i = degree - 1; i >= 0; --i) {
+                y = y * x + c[i];
+                b = b * qAbs(x) + qAbs(c[i]);
+            }
+            if (bound)
+                *bound = b;
+            return y;
+        }
+
+        /*
+         * Writes the real roots of the polynomial with the coefficients c,
+         * lowest first, to roots in increasing order and returns how many
+         * there are. The roots of the derivative split the line into
+         * intervals on which the polynomial is monotonic; each interval
+         * whose ends differ in sign holds one root, found by bisection
+         * down to adjacent doubles. A root of the derivative at which the
+         * polynomial vanishes to rounding error is a multiple root, which
+         * is how tangent outlines show up.
+         */
+        int realRoots(const qreal *c, int degree, qreal *roots) noexcept
+        {
+            qreal scale = 0;
+            for (int i = 0; i <= degree; ++i)
+                scale = qMax(scale, qAbs(c[i]));
+            if (!(scale > 0))
+                return 0;
+            while (degree > 0 && qAbs(c[degree]) <= 1e-14 * scale)
+                --degree;
+            if (degree == 0)
+                return 0;
+            if (degree == 1) {
+                roots[0] = -c[0] / c[1];
+                return 1;
+            }
+
+            // Cauchy's bound: every root lies strictly inside (-b, b).
+            qreal b = 0;
+            for (int i = 0; i < degree; ++i)
+                b = qMax(b, qAbs(c[i] / c[degree]));
+            b += 1;
+
+            qreal derivative[4], critical[3];
+            for (int i = 1; i <= degree; ++i)
+                derivative[i - 1] = i * c[i];
+            const int nc = realRoots(derivative, degree - 1, critical);
+
+            qreal edges[5];
+            bool isRoot[5];
+            int ne = 0;
+            edges[ne] = -b;
+            isRoot[ne++] = false;
+            for (int i = 0; i < nc; ++i) {
+                if (!(critical[i] > edges[ne - 1] && critical[i] < b))
+                    continue;
+                qreal bound;
+                const qreal y = polynomial(c, degree, critical[i], &bound);
+                edges[ne] = critical[i];
+                isRoot[ne++] = qAbs(y) <= 1e-12 * bound;
+            }
+            edges[ne] = b;
+            isRoot[ne++] = false;
+
+            int n = 0;
+            for (int i = 0; i < ne; ++i) {
+                if (isRoot[i]) {
+                    roots[n++] = edges[i];
+                    continue;
+                }
+                if (i + 1 == ne || isRoot[i + 1])
+                    continue;
+
+                qreal lo = edges[i], hi = edges[i + 1];
+                const bool rising = polynomial(c, degree, lo) < 0;
+                if (rising == (polynomial(c, degree, hi) < 0))
+                    continue;
+                for (;;) {
+                    const qreal mid = lo + (hi - lo) / 2;
+                    if (!(mid > lo && mid < hi))
+                        break;
+                    if ((polynomial(c, degree, mid) < 0) == rising)
+                        lo = mid;
+                    else
+                        hi = mid;
+                }
+                roots[n++] = lo + (hi - lo) / 2;
+            }
+            return n;
+        }
+
+        /*
+         * The outline of a is a(theta) = center + R(rx cos theta, ry sin theta),
+         * with R the clockwise rotation used by toPath(). Substituting
+         * theta = phi + 2 atan(t) into the implicit function of b,
+         * |scaled, unrotated offset from b's center|^2 - 1, and multiplying
+         * by (1 + t^2)^2 gives a quartic in t. It is negative where the
+         * outline of a runs inside b and its roots are the points where the
+         * outlines meet. The quarter turn phi is picked so that the point at
+         * t = infinity, theta = phi + pi, is as far from b's outline as
+         * possible, which keeps the leading coefficient away from zero.
+         */
+        void outlineQuartic(const ZQPreparedEllipseF &a, const ZQPreparedEllipseF &b, qreal *c, qreal *phi) noexcept
+        {
+            const qreal ca = a.cosAngle(), sa = a.sinAngle();
+            const qreal cb = b.cosAngle(), sb = b.sinAngle();
+            const qreal ox = a.center().x() - b.center().x(), oy = a.center().y() - b.center().y();
+
+            // The offset from b's center is (ox, oy) + (px, py) cos + (qx, qy) sin.
+            const qreal px = ca * a.radiusX(), py = -sa * a.radiusX();
+            const qreal qx = sa * a.radiusY(), qy = ca * a.radiusY();
+
+            // ... and in b's scaled frame alpha cos + beta sin + gamma.
+            qreal alpha[2] = { (cb * px - sb * py) / b.radiusX(), (sb * px + cb * py) / b.radiusY() };
+            qreal beta[2] = { (cb * qx - sb * qy) / b.radiusX(), (sb * qx + cb * qy) / b.radiusY() };
+            const qreal gamma[2] = { (cb * ox - sb * oy) / b.radiusX(), (sb * ox + cb * oy) / b.radiusY() };
+
+            static const int quarterCos[4] = { 1, 0, -1, 0 };
+            static const int quarterSin[4] = { 0, 1, 0, -1 };
+            int best = 0;
+            qreal bestValue = -1;
+            for (int k = 0; k < 4; ++k) {
+                const qreal u = gamma[0] - alpha[0] * quarterCos[k] - beta[0] * quarterSin[k];
+                const qreal v = gamma[1] - alpha[1] * quarterCos[k] - beta[1] * quarterSin[k];
+                const qreal value = qAbs(u * u + v * v - 1);
+                if (value > bestValue) {
+                    best = k;
+                    bestValue = value;
+                }
+            }
+            *phi = best * M_PI / 2;
+
+            // With cos = (1 - t^2) / (1 + t^2) and sin = 2t / (1 + t^2), each
+            // coordinate times (1 + t^2) is the quadratic p0 + p1 t + p2 t^2.
+            for (int i = 0; i < 5; ++i)
+                c[i] = 0;
+            for (int i = 0; i < 2; ++i) {
+                const qreal al = alpha[i] * quarterCos[best] + beta[i] * quarterSin[best];
+                const qreal be = beta[i] * quarterCos[best] - alpha[i] * quarterSin[best];
+                const qreal p0 = gamma[i] + al, p1 = 2 * be, p2 = gamma[i] - al;
+                c[0] += p0 * p0;
+                c[1] += 2 * p0 * p1;
+                c[2] += p1 * p1 + 2 * p0 * p2;
+                c[3] += 2 * p1 * p2;
+                c[4] += p2 * p2;
+            }
+            c[0] -= 1;
+            c[2] -= 2;
+            c[4] -= 1;
+        }
+
+    }
+
     /*!
         \class ZQEllipse
         \inmodule Zgeometry
@@ -1068,6 +1243,9 @@ namespace z_qtshapes {
         function only returns \c true if the given \a point is \e inside the
         ellipse (i.e., not on the edge).
 
+        The test is evaluated analytically on the rotated ellipse equation
+        and does not construct a QPainterPath.
+
         \sa intersects()
     */
 
@@ -1076,11 +1254,7 @@ namespace z_qtshapes {
         if (isNull())
             return false;
 
-        const ZQEllipse first = normalized();
-        const QPainterPath path1 = first.toPath();
-
-        return path1.contains(p);
-
+        return prepared().contains(QPointF(p));
     }
 
 
@@ -1117,16 +1291,27 @@ namespace z_qtshapes {
         if (isNull() || r.isNull())
             return false;
 
-        const ZQEllipse first = normalized();
-        const ZQEllipse second = r.normalized();
+        return prepared().contains(r.prepared(), proper);
+    }
 
-        const QPainterPath path1 = first.toPath();
-        const QPainterPath path2 = second.toPath();
+    /*!
+        \fn bool ZQEllipse::contains(const ZQPreparedEllipseF &ellipse, bool proper) const
+        \overload
 
-        if (proper && path1 == path2) {
+        Returns \c true if the given prepared \an ellipse is inside this
+        ellipse, otherwise returns \c false. If \a proper is true, this
+        function only returns \c true if the \an ellipse is entirely inside
+        this ellipse (not on the edge).
+
+        \sa prepared()
+    */
+
+    bool ZQEllipse::contains(const ZQPreparedEllipseF &r, bool proper) const noexcept
+    {
+        if (isNull())
             return false;
-        }
-        return path1.contains(path2);
+
+        return prepared().contains(r, proper);
     }
 
     /*!
@@ -1206,7 +1391,8 @@ namespace z_qtshapes {
 
         Returns \c true if this ellipse intersects with the given \a
         ellipse (i.e., there is at least one pixel that is within both
-        ellipses), otherwise returns \c false.
+        ellipses), otherwise returns \c false. Ellipses whose outlines
+        only touch intersect.
 
         The intersection ellipse can be retrieved using the intersected()
         function.
@@ -1216,13 +1402,41 @@ namespace z_qtshapes {
 
     bool ZQEllipse::intersects(const ZQEllipse &r) const noexcept
     {
-        const ZQEllipse first = normalized();
-        const ZQEllipse second = r.normalized();
+        return prepared().intersects(r.prepared());
+    }
 
-        const QPainterPath path1 = first.toPath();
-        const QPainterPath path2 = second.toPath();
+    /*!
+        \fn bool ZQEllipse::intersects(const ZQPreparedEllipseF &ellipse) const
+        \overload
+
+        Returns \c true if this ellipse intersects with the given prepared
+        \an ellipse, otherwise returns \c false.
 
-        return path1.intersects(path2);
+        \sa prepared()
+    */
+
+    bool ZQEllipse::intersects(const ZQPreparedEllipseF &r) const noexcept
+    {
+        return prepared().intersects(r);
+    }
+
+    /*!
+        \fn QVector<QPointF> ZQEllipse::intersectionPoints(const ZQEllipse &ellipse) const
+
+        Returns the points where the outlines of this ellipse and the
+        given \a ellipse meet, at most four.
+
+        \sa ZQPreparedEllipseF::intersectionPoints(), intersects()
+    */
+
+    QVector<QPointF> ZQEllipse::intersectionPoints(const ZQEllipse &r) const noexcept
+    {
+        QPointF points[4];
+        const int n = prepared().intersectionPoints(r.prepared(), points);
+        QVector<QPointF> result;
+        for (int i = 0; i < n; ++i)
+            result.append(points[i]);
+        return result;
     }
 
     /*!
@@ -1339,85 +1553,68 @@ namespace z_qtshapes {
 
     QPainterPath ZQEllipse::toPath() const noexcept
     {
+        return prepared().toPath();
+    }
 
-        QPainterPath path;
-        QPointF c1 = QPointF(center().x(), top());
-        QPointF c2 = QPointF(center().x() + (right()-center().x())*4/3, top());
-        QPointF c3 = QPointF(center().x() + (right()-center().x())*4/3, bottom());
-        QPointF c4 = QPointF(center().x(), bottom());
-        QPointF c5 = QPointF(center().x() - (center().x()-left())*4/3, bottom());
-        QPointF c6 = QPointF(center().x() - (center().x()-left())*4/3, top());
-        QPointF cn = center();
-
-        QPointF c1a, c2a, c3a, c4a, c5a, c6a;
-        boost::geometry::strategy::transform::rotate_transformer<boost::geometry::degree, qreal, 2, 2> rotate(angle());
-        boost::geometry::transform(c1 - cn, c1a, rotate);
-        boost::geometry::transform(c2 - cn, c2a, rotate);
-        boost::geometry::transform(c3 - cn, c3a, rotate);
-        boost::geometry::transform(c4 - cn, c4a, rotate);
-        boost::geometry::transform(c5 - cn, c5a, rotate);
-        boost::geometry::transform(c6 - cn, c6a, rotate);
-        c1a += cn;
-        c2a += cn;
-        c3a += cn;
-        c4a += cn;
-        c5a += cn;
-        c6a += cn;
-
-        path.moveTo(c1a);
-        path.cubicTo(c2a, c3a, c4a);
-        path.cubicTo(c5a, c6a, c1a);
-        path.closeSubpath();
+    QPainterPath ZQEllipse::toPath(const QMatrix3x3 &mat, const QPointF& ref) const noexcept
+    {
+        return prepared().toPath(mat, ref);
+    }
 
-        return path;
+    /*!
+        \fn ZQPreparedEllipseF ZQEllipse::prepared() const
+
+        Returns a prepared form of this ellipse with its center, radii, the
+        sine and cosine of its angle and its axis aligned bounding rectangle
+        computed once. Keep the result around when the same ellipse is
+        queried many times between modifications.
+
+        \sa ZQPreparedEllipseF
+    */
+
+    ZQPreparedEllipseF ZQEllipse::prepared() const noexcept
+    {
+        return ZQPreparedEllipseF(QPointF((x1 + x2) / 2, (y1 + y2) / 2), (x2 - x1) / 2, (y2 - y1) / 2, a);
     }
 
-    QPainterPath ZQEllipse::toPath(const QMatrix3x3 &mat, const QPointF& ref) const noexcept
+    /*!
+        \fn QRectF ZQEllipse::boundingRectF() const
+
+        Returns the tight axis aligned bounding rectangle of the rotated
+        ellipse. With the radii rx and ry and the angle a, its half extents
+        are sqrt(rx*rx*cos(a)*cos(a) + ry*ry*sin(a)*sin(a)) and
+        sqrt(rx*rx*sin(a)*sin(a) + ry*ry*cos(a)*cos(a)), unlike
+        toPath().boundingRect() which returns the looser hull of the Bezier
+        control points.
+
+        \sa boundingRect()
+    */
+
+    QRectF ZQEllipse::boundingRectF() const noexcept
     {
-        QPainterPath path;
-        QPointF c1 = QPointF(center().x(), top());
-        QPointF c2 = QPointF(center().x() + (right()-center().x())*4/3, top());
-        QPointF c3 = QPointF(center().x() + (right()-center().x())*4/3, bottom());
-        QPointF c4 = QPointF(center().x(), bottom());
-        QPointF c5 = QPointF(center().x() - (center().x()-left())*4/3, bottom());
-        QPointF c6 = QPointF(center().x() - (center().x()-left())*4/3, top());
-        QPointF cn = center();
-
-        QPointF c1a, c2a, c3a, c4a, c5a, c6a;
-        boost::geometry::strategy::transform::rotate_transformer<boost::geometry::degree, qreal, 2, 2> rotate(angle());
-        boost::geometry::transform(c1 - cn, c1a, rotate);
-        boost::geometry::transform(c2 - cn, c2a, rotate);
-        boost::geometry::transform(c3 - cn, c3a, rotate);
-        boost::geometry::transform(c4 - cn, c4a, rotate);
-        boost::geometry::transform(c5 - cn, c5a, rotate);
-        boost::geometry::transform(c6 - cn, c6a, rotate);
-        c1a += cn;
-        c2a += cn;
-        c3a += cn;
-        c4a += cn;
-        c5a += cn;
-        c6a += cn;
-
-        QPointF c1r, c2r, c3r, c4r, c5r, c6r;
-        boost::geometry::strategy::transform::matrix_transformer<float, 2, 2>project2D(mat(0,0), mat(0,1), mat(0,2), mat(1,0), mat(1,1), mat(1,2), mat(2,0), mat(2,1), mat(2,2));
-        boost::geometry::transform(c1a - ref, c1r, project2D);
-        boost::geometry::transform(c2a - ref, c2r, project2D);
-        boost::geometry::transform(c3a - ref, c3r, project2D);
-        boost::geometry::transform(c4a - ref, c4r, project2D);
-        boost::geometry::transform(c5a - ref, c5r, project2D);
-        boost::geometry::transform(c6a - ref, c6r, project2D);
-        c1r += ref;
-        c2r += ref;
-        c3r += ref;
-        c4r += ref;
-        c5r += ref;
-        c6r += ref;
-
-        path.moveTo(c1r);
-        path.cubicTo(c2r, c3r, c4r);
-        path.cubicTo(c5r, c6r, c1r);
-        path.closeSubpath();
-        return path;
+        qreal c, s;
+        angleCosSin(a, &c, &s);
+        const qreal rx = qAbs(qreal(x2) - x1) / 2;
+        const qreal ry = qAbs(qreal(y2) - y1) / 2;
+        const qreal ex = qSqrt(rx*rx*c*c + ry*ry*s*s);
+        const qreal ey = qSqrt(rx*rx*s*s + ry*ry*c*c);
+        const qreal cx = (qreal(x1) + x2) / 2;
+        const qreal cy = (qreal(y1) + y2) / 2;
+        return QRectF(cx - ex, cy - ey, 2*ex, 2*ey);
+    }
+
+    /*!
+        \fn QRect ZQEllipse::boundingRect() const
+
+        Returns the smallest integer rectangle that contains
+        boundingRectF().
+
+        \sa boundingRectF()
+    */
+
+    QRect ZQEllipse::boundingRect() const noexcept
+    {
+        return boundingRectF().toAlignedRect();
     }
 
 
@@ -2276,6 +2473,9 @@ namespace z_qtshapes {
         Returns \c true if the given \a point is inside or on the edge of the
         ellipse; otherwise returns \c false.
 
+        The test is evaluated analytically on the rotated ellipse equation
+        and does not construct a QPainterPath.
+
         \sa intersects()
     */
 
@@ -2284,11 +2484,7 @@ namespace z_qtshapes {
         if (isNull())
             return false;
 
-        const ZQEllipseF first = normalized();
-        const QPainterPath path1 = first.toPath();
-
-        return path1.contains(p);
-
+        return prepared().contains(p);
     }
 
 
@@ -2310,15 +2506,30 @@ namespace z_qtshapes {
 
     bool ZQEllipseF::contains(const ZQEllipseF &r, bool proper) const noexcept
     {
-        const ZQEllipseF first = normalized();
-        const ZQEllipseF second = r.normalized();
-        const QPainterPath path1 = first.toPath();
-        const QPainterPath path2 = second.toPath();
+        if (isNull() || r.isNull())
+            return false;
 
-        if (proper && path1 == path2) {
+        return prepared().contains(r.prepared(), proper);
+    }
+
+    /*!
+        \fn bool ZQEllipseF::contains(const ZQPreparedEllipseF &ellipse, bool proper) const
+        \overload
+
+        Returns \c true if the given prepared \an ellipse is inside this
+        ellipse, otherwise returns \c false. If \a proper is true, this
+        function only returns \c true if the \an ellipse is entirely inside
+        this ellipse (not on the edge).
+
+        \sa prepared()
+    */
+
+    bool ZQEllipseF::contains(const ZQPreparedEllipseF &r, bool proper) const noexcept
+    {
+        if (isNull())
             return false;
-        }
-        return path1.contains(path2);
+
+        return prepared().contains(r, proper);
     }
 
     /*!
@@ -2468,8 +2679,9 @@ namespace z_qtshapes {
         \fn bool ZQEllipseF::intersects(const ZQEllipseF &ellipse) const
 
         Returns \c true if this ellipse intersects with the given \a
-        ellipse (i.e. there is a non-empty area of overlap between
-        them), otherwise returns \c false.
+        ellipse (i.e. they share at least one point, their outlines
+        included), otherwise returns \c false. Ellipses that only touch
+        intersect.
 
         The intersection ellipse can be retrieved using the intersected()
         function.
@@ -2479,13 +2691,41 @@ namespace z_qtshapes {
 
     bool ZQEllipseF::intersects(const ZQEllipseF &r) const noexcept
     {
-        const ZQEllipseF first = normalized();
-        const ZQEllipseF second = r.normalized();
+        return prepared().intersects(r.prepared());
+    }
 
-        const QPainterPath path1 = first.toPath();
-        const QPainterPath path2 = second.toPath();
+    /*!
+        \fn bool ZQEllipseF::intersects(const ZQPreparedEllipseF &ellipse) const
+        \overload
+
+        Returns \c true if this ellipse intersects with the given prepared
+        \an ellipse, otherwise returns \c false.
 
-        return path1.intersects(path2);
+        \sa prepared()
+    */
+
+    bool ZQEllipseF::intersects(const ZQPreparedEllipseF &r) const noexcept
+    {
+        return prepared().intersects(r);
+    }
+
+    /*!
+        \fn QVector<QPointF> ZQEllipseF::intersectionPoints(const ZQEllipseF &ellipse) const
+
+        Returns the points where the outlines of this ellipse and the
+        given \a ellipse meet, at most four.
+
+        \sa ZQPreparedEllipseF::intersectionPoints(), intersects()
+    */
+
+    QVector<QPointF> ZQEllipseF::intersectionPoints(const ZQEllipseF &r) const noexcept
+    {
+        QPointF points[4];
+        const int n = prepared().intersectionPoints(r.prepared(), points);
+        QVector<QPointF> result;
+        for (int i = 0; i < n; ++i)
+            result.append(points[i]);
+        return result;
     }
 
     /*!
@@ -2634,85 +2874,94 @@ namespace z_qtshapes {
 
     QPainterPath ZQEllipseF::toPath() const noexcept
     {
+        return prepared().toPath();
+    }
 
-        QPainterPath path;
-        QPointF c1 = QPointF(center().x(), top());
-        QPointF c2 = QPointF(center().x() + (right()-center().x())*4/3, top());
-        QPointF c3 = QPointF(center().x() + (right()-center().x())*4/3, bottom());
-        QPointF c4 = QPointF(center().x(), bottom());
-        QPointF c5 = QPointF(center().x() - (center().x()-left())*4/3, bottom());
-        QPointF c6 = QPointF(center().x() - (center().x()-left())*4/3, top());
-        QPointF cn = center();
-
-        QPointF c1a, c2a, c3a, c4a, c5a, c6a;
-        boost::geometry::strategy::transform::rotate_transformer<boost::geometry::degree, int, 2, 2> rotate(angle());
-        boost::geometry::transform(c1 - cn, c1a, rotate);
-        boost::geometry::transform(c2 - cn, c2a, rotate);
-        boost::geometry::transform(c3 - cn, c3a, rotate);
-        boost::geometry::transform(c4 - cn, c4a, rotate);
-        boost::geometry::transform(c5 - cn, c5a, rotate);
-        boost::geometry::transform(c6 - cn, c6a, rotate);
-        c1a += cn;
-        c2a += cn;
-        c3a += cn;
-        c4a += cn;
-        c5a += cn;
-        c6a += cn;
-
-        path.moveTo(c1a);
-        path.cubicTo(c2a, c3a, c4a);
-        path.cubicTo(c5a, c6a, c1a);
-        path.closeSubpath();
+    QPainterPath ZQEllipseF::toPath(const QMatrix3x3 &mat, const QPointF& ref) const noexcept
+    {
+        return prepared().toPath(mat, ref);
+    }
 
-        return path;
+    /*!
+        \fn ZQPreparedEllipseF ZQEllipseF::prepared() const
+
+        Returns a prepared form of this ellipse with its center, radii, the
+        sine and cosine of its angle and its axis aligned bounding rectangle
+        computed once. Keep the result around when the same ellipse is
+        queried many times between modifications.
+
+        \sa ZQPreparedEllipseF
+    */
+
+    ZQPreparedEllipseF ZQEllipseF::prepared() const noexcept
+    {
+        return ZQPreparedEllipseF(center(), w / 2, h / 2, a);
     }
 
-    QPainterPath ZQEllipseF::toPath(const QMatrix3x3 &mat, const QPointF& ref) const noexcept
+    /*!
+        \fn QRectF ZQEllipseF::boundingRect() const
+
+        Returns the tight axis aligned bounding rectangle of the rotated
+        ellipse. With the radii rx and ry and the angle a, its half extents
+        are sqrt(rx*rx*cos(a)*cos(a) + ry*ry*sin(a)*sin(a)) and
+        sqrt(rx*rx*sin(a)*sin(a) + ry*ry*cos(a)*cos(a)), unlike
+        toPath().boundingRect() which returns the looser hull of the Bezier
+        control points.
+
+        \sa prepared()
+    */
+
+    QRectF ZQEllipseF::boundingRect() const noexcept
     {
-        QPainterPath path;
-        QPointF c1 = QPointF(center().x(), top());
-        QPointF c2 = QPointF(center().x() + (right()-center().x())*4/3, top());
-        QPointF c3 = QPointF(center().x() + (right()-center().x())*4/3, bottom());
-        QPointF c4 = QPointF(center().x(), bottom());
-        QPointF c5 = QPointF(center().x() - (center().x()-left())*4/3, bottom());
-        QPointF c6 = QPointF(center().x() - (center().x()-left())*4/3, top());
-        QPointF cn = center();
-
-        QPointF c1a, c2a, c3a, c4a, c5a, c6a;
-        boost::geometry::strategy::transform::rotate_transformer<boost::geometry::degree, qreal, 2, 2> rotate(angle());
-        boost::geometry::transform(c1 - cn, c1a, rotate);
-        boost::geometry::transform(c2 - cn, c2a, rotate);
-        boost::geometry::transform(c3 - cn, c3a, rotate);
-        boost::geometry::transform(c4 - cn, c4a, rotate);
-        boost::geometry::transform(c5 - cn, c5a, rotate);
-        boost::geometry::transform(c6 - cn, c6a, rotate);
-        c1a += cn;
-        c2a += cn;
-        c3a += cn;
-        c4a += cn;
-        c5a += cn;
-        c6a += cn;
-
-        QPointF c1r, c2r, c3r, c4r, c5r, c6r;
-        boost::geometry::strategy::transform::matrix_transformer<float, 2, 2>project2D(mat(0,0), mat(0,1), mat(0,2), mat(1,0), mat(1,1), mat(1,2), mat(2,0), mat(2,1), mat(2,2));
-        boost::geometry::transform(c1a - ref, c1r, project2D);
-        boost::geometry::transform(c2a - ref, c2r, project2D);
-        boost::geometry::transform(c3a - ref, c3r, project2D);
-        boost::geometry::transform(c4a - ref, c4r, project2D);
-        boost::geometry::transform(c5a - ref, c5r, project2D);
-        boost::geometry::transform(c6a - ref, c6r, project2D);
-        c1r += ref;
-        c2r += ref;
-        c3r += ref;
-        c4r += ref;
-        c5r += ref;
-        c6r += ref;
-
-        path.moveTo(c1r);
-        path.cubicTo(c2r, c3r, c4r);
-        path.cubicTo(c5r, c6r, c1r);
-        path.closeSubpath();
-        return path;
+        qreal c, s;
+        angleCosSin(a, &c, &s);
+        const QPointF cn = center();
+        const qreal rx = qAbs(w) / 2;
+        const qreal ry = qAbs(h) / 2;
+        const qreal ex = qSqrt(rx*rx*c*c + ry*ry*s*s);
+        const qreal ey = qSqrt(rx*rx*s*s + ry*ry*c*c);
+        return QRectF(cn.x() - ex, cn.y() - ey, 2*ex, 2*ey);
+    }
+
+    /*!
+        \fn int ZQEllipseF::segmentCount(qreal tolerance) const
+
+        Returns the number of rim segments tessellate() uses for
+        \a tolerance, without preparing the ellipse.
+
+        \sa ZQPreparedEllipseF::segmentCount()
+    */
+
+    int ZQEllipseF::segmentCount(qreal tolerance) const noexcept
+    {
+        return ellipseSegmentCount(qMax(qAbs(w), qAbs(h)) / 2, tolerance);
+    }
+
+    /*!
+        \fn int ZQEllipseF::tessellationVertexCount(qreal tolerance) const
+
+        Returns the number of vertices tessellate() writes for \a tolerance.
+    */
+
+    /*!
+        \fn int ZQEllipseF::tessellationIndexCount(qreal tolerance) const
+
+        Returns the number of indices tessellate() writes for \a tolerance.
+    */
+
+    /*!
+        \fn void ZQEllipseF::tessellate(qreal tolerance, float *vertices, quint32 *indices, quint32 baseVertex) const
+
+        Writes the rotated ellipse as an indexed triangle fan into
+        \a vertices and \a indices, with no point of the polygon further
+        than \a tolerance from the ellipse.
+
+        \sa ZQPreparedEllipseF::tessellate()
+    */
+
+    void ZQEllipseF::tessellate(qreal tolerance, float *vertices, quint32 *indices, quint32 baseVertex) const noexcept
+    {
+        prepared().tessellate(tolerance, vertices, indices, baseVertex);
     }
 
     /*****************************************************************************
@@ -2772,4 +3021,341 @@ namespace z_qtshapes {
     }
     #endif
 
+
+    /*!
+        \class ZQPreparedEllipseF
+        \inmodule Zgeometry
+        \ingroup painting
+        \reentrant
+
+        \brief The ZQPreparedEllipseF class holds a rotated ellipse in a form
+        that is ready for repeated queries.
+
+        A ZQPreparedEllipseF is created with ZQEllipse::prepared() or
+        ZQEllipseF::prepared(). It stores the center, the radii, the sine and
+        cosine of the angle and the axis aligned bounding rectangle, so that
+        contains(), intersects() and toPath() do not evaluate any
+        trigonometric functions. The object is immutable; prepare the
+        ellipse again after modifying it.
+
+        The half extents of the bounding rectangle are
+        sqrt(rx*rx*cos*cos + ry*ry*sin*sin) and
+        sqrt(rx*rx*sin*sin + ry*ry*cos*cos).
+    */
+
+    /*!
+        \fn ZQPreparedEllipseF::ZQPreparedEllipseF(const QPointF &center, qreal radiusX, qreal radiusY, qreal angle)
+
+        Constructs the prepared form of the ellipse centered at \a center
+        with the radii \a radiusX and \a radiusY, rotated by \a angle degrees
+        about its center.
+    */
+
+    ZQPreparedEllipseF::ZQPreparedEllipseF(const QPointF &center, qreal radiusX, qreal radiusY, qreal angle) noexcept
+    {
+        qreal c, s;
+        angleCosSin(angle, &c, &s);
+        *this = ZQPreparedEllipseF(center, radiusX, radiusY, angle, c, s);
+    }
+
+    /*!
+        \fn ZQPreparedEllipseF::ZQPreparedEllipseF(const QPointF &center, qreal radiusX, qreal radiusY, qreal angle, qreal cosAngle, qreal sinAngle)
+        \overload
+
+        Constructs the prepared ellipse with \a cosAngle and \a sinAngle as
+        the cosine and sine of \a angle, for callers that keep them cached
+        already. They are used as given.
+    */
+
+    ZQPreparedEllipseF::ZQPreparedEllipseF(const QPointF &center, qreal radiusX, qreal radiusY, qreal angle,
+            qreal cosAngle, qreal sinAngle) noexcept
+        : cx(center.x()), cy(center.y()), rx(qAbs(radiusX)), ry(qAbs(radiusY)), ca(cosAngle), sa(sinAngle), a(angle)
+    {
+        const qreal ex = qSqrt(rx*rx*ca*ca + ry*ry*sa*sa);
+        const qreal ey = qSqrt(rx*rx*sa*sa + ry*ry*ca*ca);
+        bx1 = cx - ex;
+        by1 = cy - ey;
+        bx2 = cx + ex;
+        by2 = cy + ey;
+    }
+
+    /*!
+        \fn bool ZQPreparedEllipseF::contains(const QPointF &point) const
+
+        Returns \c true if the given \a point is inside or on the edge of
+        the ellipse, otherwise returns \c false. A degenerate ellipse with a
+        zero radius contains no points.
+    */
+
+    bool ZQPreparedEllipseF::contains(const QPointF &p) const noexcept
+    {
+        if (rx <= 0 || ry <= 0)
+            return false;
+        if (p.x() < bx1 || p.x() > bx2 || p.y() < by1 || p.y() > by2)
+            return false;
+
+        // Undo the clockwise rotation used by toPath() and test the point
+        // against the canonical ellipse equation.
+        const qreal dx = p.x() - cx;
+        const qreal dy = p.y() - cy;
+        const qreal lx = (ca * dx - sa * dy) / rx;
+        const qreal ly = (sa * dx + ca * dy) / ry;
+
+        return lx * lx + ly * ly <= 1;
+    }
+
+    /*!
+        \fn bool ZQPreparedEllipseF::contains(const ZQPreparedEllipseF &ellipse, bool proper) const
+
+        Returns \c true if the given \an ellipse is inside this ellipse,
+        otherwise returns \c false. If \a proper is true, an ellipse equal to
+        this one is not contained.
+
+        Ellipses whose bounding rectangle is not inside the bounding
+        rectangle of this ellipse are rejected without building a
+        QPainterPath.
+    */
+
+    bool ZQPreparedEllipseF::contains(const ZQPreparedEllipseF &r, bool proper) const noexcept
+    {
+        if (r.bx1 < bx1 || r.bx2 > bx2 || r.by1 < by1 || r.by2 > by2)
+            return false;
+
+        const QPainterPath path1 = toPath();
+        const QPainterPath path2 = r.toPath();
+
+        if (proper && path1 == path2) {
+            return false;
+        }
+        return path1.contains(path2);
+    }
+
+    /*!
+        \fn bool ZQPreparedEllipseF::intersects(const ZQPreparedEllipseF &ellipse) const
+
+        Returns \c true if this ellipse and the given \an ellipse touch or
+        overlap, otherwise returns \c false. Like every shape predicate
+        the ellipses are closed, so outlines that meet in a single point
+        are enough. A degenerate ellipse with a zero radius intersects
+        nothing.
+
+        Disjoint bounding rectangles and circumscribed circles reject, and
+        overlapping inscribed circles or a center inside the other ellipse
+        accept, without further work. Otherwise the ellipses overlap
+        exactly when the outline of this ellipse runs inside \a ellipse
+        somewhere. That is decided from the minimum of the quartic in
+        tan(theta / 2) that describes the outline in the other ellipse's
+        frame, which lies at one of the roots of its cubic derivative.
+        Failing that, the ellipses touch when the quartic has a real root,
+        as in intersectionPoints().
+
+        \sa intersectionPoints()
+    */
+
+    bool ZQPreparedEllipseF::intersects(const ZQPreparedEllipseF &r) const noexcept
+    {
+        if (r.bx1 > bx2 || r.bx2 < bx1 || r.by1 > by2 || r.by2 < by1)
+            return false;
+        if (rx <= 0 || ry <= 0 || r.rx <= 0 || r.ry <= 0)
+            return false;
+
+        const qreal dx = r.cx - cx, dy = r.cy - cy;
+        const qreal d2 = dx * dx + dy * dy;
+        const qreal outer = qMax(rx, ry) + qMax(r.rx, r.ry);
+        if (d2 > outer * outer)
+            return false;
+        const qreal inner = qMin(rx, ry) + qMin(r.rx, r.ry);
+        if (d2 < inner * inner)
+            return true;
+        if (contains(r.center()) || r.contains(center()))
+            return true;
+
+        qreal c[5], phi;
+        outlineQuartic(*this, r, c, &phi);
+        if (c[4] < 0)
+            return true;
+
+        const qreal derivative[4] = { c[1], 2 * c[2], 3 * c[3], 4 * c[4] };
+        qreal critical[3];
+        const int n = realRoots(derivative, 3, critical);
+        for (int i = 0; i < n; ++i)
+            if (polynomial(c, 4, critical[i]) < 0)
+                return true;
+        qreal t[4];
+        return realRoots(c, 4, t) > 0;
+    }
+
+    /*!
+        \fn int ZQPreparedEllipseF::intersectionPoints(const ZQPreparedEllipseF &ellipse, QPointF *points) const
+
+        Writes the points where the outlines of this ellipse and the given
+        \an ellipse meet to \a points, which must have room for four, and
+        returns how many there are. A point where the outlines touch is
+        reported once. Coincident outlines and degenerate ellipses give no
+        points.
+
+        The points are the real roots of a quartic in tan(theta / 2), where
+        theta is the parameter of this ellipse's outline, found by
+        isolating them between the roots of its derivatives. The
+        rejections of intersects() are applied first.
+
+        \sa intersects()
+    */
+
+    int ZQPreparedEllipseF::intersectionPoints(const ZQPreparedEllipseF &r, QPointF *points) const noexcept
+    {
+        if (r.bx1 > bx2 || r.bx2 < bx1 || r.by1 > by2 || r.by2 < by1)
+            return 0;
+        if (rx <= 0 || ry <= 0 || r.rx <= 0 || r.ry <= 0)
+            return 0;
+
+        const qreal dx = r.cx - cx, dy = r.cy - cy;
+        const qreal outer = qMax(rx, ry) + qMax(r.rx, r.ry);
+        if (dx * dx + dy * dy > outer * outer)
+            return 0;
+
+        qreal c[5], phi, t[4];
+        outlineQuartic(*this, r, c, &phi);
+        const int n = realRoots(c, 4, t);
+        for (int i = 0; i < n; ++i) {
+            const qreal theta = phi + 2 * qAtan(t[i]);
+            const qreal u = rx * qCos(theta), v = ry * qSin(theta);
+            points[i] = QPointF(cx + ca * u + sa * v, cy - sa * u + ca * v);
+        }
+        return n;
+    }
+
+    /*!
+        \fn QPainterPath ZQPreparedEllipseF::toPath() const
+
+        Converts the ellipse into a QPainterPath made of two cubic curves,
+        rotating the control points with the cached sine and cosine.
+    */
+
+    QPainterPath ZQPreparedEllipseF::toPath() const noexcept
+    {
+        const qreal kx = rx * 4 / 3;
+        const qreal u[6] = { 0, kx, kx, 0, -kx, -kx };
+        const qreal v[6] = { -ry, -ry, ry, ry, ry, -ry };
+        QPointF c[6];
+        for (int i = 0; i < 6; ++i)
+            c[i] = QPointF(cx + ca * u[i] + sa * v[i], cy - sa * u[i] + ca * v[i]);
+
+        QPainterPath path;
+        path.moveTo(c[0]);
+        path.cubicTo(c[1], c[2], c[3]);
+        path.cubicTo(c[4], c[5], c[0]);
+        path.closeSubpath();
+        return path;
+    }
+
+    /*!
+        \fn QPainterPath ZQPreparedEllipseF::toPath(const QMatrix3x3 &mat, const QPointF &ref) const
+
+        Transforms the ellipse about the point \a ref using the
+        transformation matrix \a mat and then converts it into a
+        QPainterPath.
+    */
+
+    QPainterPath ZQPreparedEllipseF::toPath(const QMatrix3x3 &mat, const QPointF& ref) const noexcept
+    {
+        const qreal kx = rx * 4 / 3;
+        const qreal u[6] = { 0, kx, kx, 0, -kx, -kx };
+        const qreal v[6] = { -ry, -ry, ry, ry, ry, -ry };
+        qreal x[6], y[6];
+        for (int i = 0; i < 6; ++i) {
+            x[i] = cx + ca * u[i] + sa * v[i];
+            y[i] = cy - sa * u[i] + ca * v[i];
+        }
+        transformPoints(ZQPointTransform(mat, ref), x, y, x, y, 6);
+        QPointF c[6];
+        for (int i = 0; i < 6; ++i)
+            c[i] = QPointF(x[i], y[i]);
+
+        QPainterPath path;
+        path.moveTo(c[0]);
+        path.cubicTo(c[1], c[2], c[3]);
+        path.cubicTo(c[4], c[5], c[0]);
+        path.closeSubpath();
+        return path;
+    }
+
+    /*!
+        \fn int ZQPreparedEllipseF::segmentCount(qreal tolerance) const
+
+        Returns the number of rim segments tessellate() uses so that no
+        point of the polygon is further than \a tolerance from the ellipse.
+        The tolerance is in the units of the ellipse's coordinates, so pass
+        the screen-space tolerance divided by the drawing scale to adapt the
+        count to the size the ellipse is drawn at.
+
+        A segment of n around the larger radius r deviates from the outline
+        by at most r * (1 - cos(pi / n)). The count is rounded up to a
+        multiple of four so that the polygon is symmetric about both axes of
+        the ellipse, and is clamped to [4, 4096].
+    */
+
+    int ZQPreparedEllipseF::segmentCount(qreal tolerance) const noexcept
+    {
+        return ellipseSegmentCount(qMax(rx, ry), tolerance);
+    }
+
+    /*!
+        \fn int ZQPreparedEllipseF::tessellationVertexCount(qreal tolerance) const
+
+        Returns the number of vertices tessellate() writes for \a tolerance.
+    */
+
+    /*!
+        \fn int ZQPreparedEllipseF::tessellationIndexCount(qreal tolerance) const
+
+        Returns the number of indices tessellate() writes for \a tolerance.
+    */
+
+    /*!
+        \fn void ZQPreparedEllipseF::tessellate(qreal tolerance, float *vertices, quint32 *indices, quint32 baseVertex) const
+
+        Writes the ellipse as a triangle fan around its center into
+        \a vertices, as interleaved x and y coordinates, and the fan's
+        triangles into \a indices as a triangle list, so that many shapes
+        can share one buffer and one draw call. \a baseVertex is added to
+        every index; pass the number of vertices already in the buffer.
+
+        The arrays must have room for tessellationVertexCount() pairs of
+        floats and tessellationIndexCount() indices. All triangles have a
+        positive signed area in the ellipse's coordinate system, which is
+        clockwise on a y-down screen.
+
+        \sa segmentCount()
+    */
+
+    void ZQPreparedEllipseF::tessellate(qreal tolerance, float *vertices, quint32 *indices,
+            quint32 baseVertex) const noexcept
+    {
+        const int n = segmentCount(tolerance);
+        const qreal cs = qCos(2*M_PI / n);
+        const qreal ss = qSin(2*M_PI / n);
+
+        vertices[0] = float(cx);
+        vertices[1] = float(cy);
+
+        // Step the unit vector (cos t, sin t) by rotation instead of
+        // evaluating the trigonometric functions per vertex.
+        qreal u = 1, v = 0;
+        for (int i = 0; i < n; ++i) {
+            const qreal px = rx * u;
+            const qreal py = ry * v;
+            vertices[2 + 2*i] = float(cx + ca * px + sa * py);
+            vertices[3 + 2*i] = float(cy - sa * px + ca * py);
+
+            const qreal nu = u * cs - v * ss;
+            v = u * ss + v * cs;
+            u = nu;
+
+            indices[3*i] = baseVertex;
+            indices[3*i + 1] = baseVertex + 1 + i;
+            indices[3*i + 2] = baseVertex + 1 + (i + 1 == n ? 0 : i + 1);
+        }
+    }
+
 }
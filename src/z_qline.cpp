@@ -39,6 +39,7 @@
 ****************************************************************************/
 
 #include "z_qline.h"
+#include "z_qpointkernels.h"
 #include <boost/geometry.hpp>
 #include <boost/geometry/geometries/register/point.hpp>
 //#include <boost/geometry/geometries/register/segment.hpp>
@@ -49,6 +50,114 @@ BOOST_GEOMETRY_REGISTER_POINT_2D_GET_SET(QPointF, qreal, boost::geometry::cs::ca
 
 namespace z_qtshapes {
 
+    namespace {
+
+        inline qreal cross(const QPointF &a, const QPointF &b) noexcept
+        {
+            return a.x() * b.y() - a.y() * b.x();
+        }
+
+        // Rotates the end points by angle degrees about cn, using the same
+        // clockwise convention as the rotate_transformer in toPath().
+        inline void rotatedEndPoints(const QPointF &p1, const QPointF &p2, const QPointF &cn,
+                qreal angle, QPointF &r1, QPointF &r2) noexcept
+        {
+            if (angle == 0) {
+                r1 = p1;
+                r2 = p2;
+                return;
+            }
+            const qreal rad = M_PI/180 * angle;
+            const qreal c = qCos(rad);
+            const qreal s = qSin(rad);
+            const QPointF d1 = p1 - cn;
+            const QPointF d2 = p2 - cn;
+            r1 = QPointF(cn.x() + c*d1.x() + s*d1.y(), cn.y() - s*d1.x() + c*d1.y());
+            r2 = QPointF(cn.x() + c*d2.x() + s*d2.y(), cn.y() - s*d2.x() + c*d2.y());
+        }
+
+        // Returns true if p lies within epsilon of the segment p1-p2.
+        inline bool pointOnSegment(const QPointF &p1, const QPointF &p2, const QPointF &p, qreal epsilon) noexcept
+        {
+            const QPointF r = p2 - p1;
+            const QPointF q = p - p1;
+            const qreal rr = QPointF::dotProduct(r, r);
+            if (rr == 0)
+                return QPointF::dotProduct(q, q) <= epsilon * epsilon;
+
+            const qreal c = cross(r, q);
+            if (c * c > epsilon * epsilon * rr)
+                return false;
+
+            const qreal d = QPointF::dotProduct(q, r);
+            const qreal tol = epsilon * qSqrt(rr);
+            return d >= -tol && d <= rr + tol;
+        }
+
+        /*
+         * Orientation based intersection of the segments p1-p2 and q1-q2.
+         * Returns 0 if the segments are parallel (or colinear and disjoint),
+         * 1 if they intersect within both segments and 2 if only their
+         * supporting lines intersect. t and u receive the parameters of the
+         * intersection along each segment; for colinear overlaps they locate
+         * the start of the overlap. epsilon is a distance tolerance.
+         */
+        inline int segmentIntersection(const QPointF &p1, const QPointF &p2, const QPointF &q1, const QPointF &q2,
+                qreal epsilon, qreal &t, qreal &u) noexcept
+        {
+            const QPointF r = p2 - p1;
+            const QPointF s = q2 - q1;
+            const QPointF qp = q1 - p1;
+            const qreal rr = QPointF::dotProduct(r, r);
+            const qreal ss = QPointF::dotProduct(s, s);
+
+            if (rr == 0 || ss == 0) {
+                if (rr == 0 && ss == 0) {
+                    t = u = 0;
+                    return QPointF::dotProduct(qp, qp) <= epsilon * epsilon ? 1 : 0;
+                }
+                if (rr == 0) {
+                    t = 0;
+                    u = ss == 0 ? 0 : QPointF::dotProduct(-qp, s) / ss;
+                    return pointOnSegment(q1, q2, p1, epsilon) ? 1 : 0;
+                }
+                u = 0;
+                t = QPointF::dotProduct(qp, r) / rr;
+                return pointOnSegment(p1, p2, q1, epsilon) ? 1 : 0;
+            }
+
+            const qreal eps2 = epsilon * epsilon * rr;
+            const qreal c1 = cross(r, qp);
+            const qreal c2 = cross(r, q2 - p1);
+            if (c1 * c1 <= eps2 && c2 * c2 <= eps2) {
+                // Colinear: project the other segment onto this one and
+                // intersect the parameter intervals.
+                const qreal t0 = QPointF::dotProduct(qp, r) / rr;
+                const qreal t1 = QPointF::dotProduct(q2 - p1, r) / rr;
+                const qreal lo = qMax(qreal(0), qMin(t0, t1));
+                const qreal hi = qMin(qreal(1), qMax(t0, t1));
+                if (lo > hi + epsilon / qSqrt(rr))
+                    return 0;
+                t = qMin(lo, hi);
+                u = QPointF::dotProduct(p1 + r * t - q1, s) / ss;
+                return 1;
+            }
+
+            const qreal denom = cross(r, s);
+            if (denom == 0)
+                return 0;
+
+            t = cross(qp, s) / denom;
+            u = cross(qp, r) / denom;
+            const qreal tolT = epsilon / qSqrt(rr);
+            const qreal tolU = epsilon / qSqrt(ss);
+            if (t >= -tolT && t <= 1 + tolT && u >= -tolU && u <= 1 + tolU)
+                return 1;
+            return 2;
+        }
+
+    }
+
     /*!
         \class ZQLine
         \inmodule QtCore
@@ -122,6 +231,37 @@ namespace z_qtshapes {
              QString::number(pt1.y()), QString::number(pt2.x()), QString::number(pt2.y()), QString::number(a));
     }
 
+    /*!
+        \fn QRectF ZQLine::boundingRectF() const
+
+        Returns the axis aligned bounding rectangle of the line with its end
+        points rotated about center(), without building a path.
+
+        \sa boundingRect()
+    */
+
+    QRectF ZQLine::boundingRectF() const noexcept
+    {
+        qreal c, s;
+        angleCosSin(a, &c, &s);
+        const QPointF points[2] = { QPointF(pt1), QPointF(pt2) };
+        return rotatedBounds(points, 2, QPointF(center()), c, s);
+    }
+
+    /*!
+        \fn QRect ZQLine::boundingRect() const
+
+        Returns the smallest integer rectangle that contains
+        boundingRectF().
+
+        \sa boundingRectF()
+    */
+
+    QRect ZQLine::boundingRect() const noexcept
+    {
+        return boundingRectF().toAlignedRect();
+    }
+
     /*!
         \fn QPainterPath ZQLine::toPath()
 
@@ -171,15 +311,12 @@ namespace z_qtshapes {
         c1a += cn;
         c2a += cn;
 
-        QPointF c1r, c2r;
-        boost::geometry::strategy::transform::matrix_transformer<float, 2, 2>project2D(mat(0,0), mat(0,1), mat(0,2), mat(1,0), mat(1,1), mat(1,2), mat(2,0), mat(2,1), mat(2,2));
-        boost::geometry::transform(c1a - ref, c1r, project2D);
-        boost::geometry::transform(c2a - ref, c2r, project2D);
-        c1r += ref;
-        c2r += ref;
+        qreal x[2] = { c1a.x(), c2a.x() };
+        qreal y[2] = { c1a.y(), c2a.y() };
+        transformPoints(ZQPointTransform(mat, ref), x, y, x, y, 2);
 
-        path.moveTo(c1r);
-        path.lineTo(c2r);
+        path.moveTo(x[0], y[0]);
+        path.lineTo(x[1], y[1]);
         path.closeSubpath();
         return path;
     }
@@ -477,23 +614,23 @@ namespace z_qtshapes {
 
 
     /*!
-        \fn bool ZQLine::contains(const QPoint &point) const
+        \fn bool ZQLine::contains(const QPoint &point, qreal epsilon) const
 
-        Returns \c true if the given \a point is on
+        Returns \c true if the given \a point lies within \a epsilon of
         the line, otherwise returns \c false.
 
         \sa intersects()
     */
 
-    bool ZQLine::contains(const QPoint &p) const noexcept
+    bool ZQLine::contains(const QPoint &p, qreal epsilon) const noexcept
     {
         if (isNull() || p.isNull())
             return false;
 
-        const QPainterPath path1 = toPath();
-
-        return path1.contains(p);
+        QPointF a1, a2;
+        rotatedEndPoints(QPointF(pt1), QPointF(pt2), QPointF(center()), a, a1, a2);
 
+        return pointOnSegment(a1, a2, QPointF(p), epsilon);
     }
 
     /*!
@@ -505,23 +642,25 @@ namespace z_qtshapes {
     */
 
     /*!
-        \fn bool ZQLine::contains(const ZQLine &line) const
+        \fn bool ZQLine::contains(const ZQLine &line, qreal epsilon) const
         \overload
 
         Returns \c true if the given \a line is on this line.
-        otherwise returns \c false.
+        otherwise returns \c false. The lines must be colinear and both end
+        points of \a line must lie within \a epsilon of this line.
     */
 
-    bool ZQLine::contains(const ZQLine &r) const noexcept
+    bool ZQLine::contains(const ZQLine &r, qreal epsilon) const noexcept
     {
         if (isNull() || r.isNull())
             return false;
 
-        const QPainterPath path1 = toPath();
-        const QPainterPath path2 = r.toPath();
+        QPointF a1, a2;
+        rotatedEndPoints(QPointF(pt1), QPointF(pt2), QPointF(center()), a, a1, a2);
+        QPointF b1, b2;
+        rotatedEndPoints(QPointF(r.pt1), QPointF(r.pt2), QPointF(r.center()), r.a, b1, b2);
 
-        return path1.contains(path2);
-   
+        return pointOnSegment(a1, a2, b1, epsilon) && pointOnSegment(a1, a2, b2, epsilon);
     }
 
     /*!
@@ -598,24 +737,66 @@ namespace z_qtshapes {
     */
 
     /*!
-        \fn bool ZQLine::intersects(const ZQLine &line) const
+        \fn bool ZQLine::intersects(const ZQLine &line, qreal epsilon) const
 
         Returns \c true if this line intersects with the given \a
         line (i.e., there is at least one pixel that is within both
-        lines), otherwise returns \c false.
+        lines), otherwise returns \c false. Touching end points and
+        colinear overlaps count as intersections, and points within
+        \a epsilon of a line are considered to be on it.
 
         The intersection line can be retrieved using the intersected()
-        function.
+        function, and the intersection parameters using
+        intersectionPoint().
 
         \sa contains()
     */
 
-    bool ZQLine::intersects(const ZQLine &r) const noexcept
+    bool ZQLine::intersects(const ZQLine &r, qreal epsilon) const noexcept
     {
-        const QPainterPath path1 = toPath();
-        const QPainterPath path2 = r.toPath();
+        QPointF a1, a2;
+        rotatedEndPoints(QPointF(pt1), QPointF(pt2), QPointF(center()), a, a1, a2);
+        QPointF b1, b2;
+        rotatedEndPoints(QPointF(r.pt1), QPointF(r.pt2), QPointF(r.center()), r.a, b1, b2);
 
-        return path1.intersects(path2);
+        qreal t, u;
+        return segmentIntersection(a1, a2, b1, b2, epsilon, t, u) == 1;
+    }
+
+
+    /*!
+        \fn ZQLine::IntersectionType ZQLine::intersectionPoint(const ZQLine &line, qreal *t, qreal *u, qreal epsilon) const
+
+        Computes where this line and the given \a line meet, without
+        constructing a QPainterPath. Both lines are first rotated about
+        their centers.
+
+        Returns NoIntersection if the lines are parallel or colinear without
+        overlap, BoundedIntersection if the intersection lies on both
+        segments and UnboundedIntersection if only the infinite lines meet.
+        Unless they are null, \a t and \a u receive the parameters of the
+        intersection along this line and along \a line respectively, where
+        0 is the start point and 1 the end point. For colinear overlapping
+        lines they locate the start of the overlap. Points within \a epsilon
+        of a line are considered to be on it.
+
+        \sa intersects(), pointAt()
+    */
+
+    ZQLine::IntersectionType ZQLine::intersectionPoint(const ZQLine &r, qreal *t, qreal *u, qreal epsilon) const noexcept
+    {
+        QPointF a1, a2;
+        rotatedEndPoints(QPointF(pt1), QPointF(pt2), QPointF(center()), a, a1, a2);
+        QPointF b1, b2;
+        rotatedEndPoints(QPointF(r.pt1), QPointF(r.pt2), QPointF(r.center()), r.a, b1, b2);
+
+        qreal pt = 0, pu = 0;
+        const int type = segmentIntersection(a1, a2, b1, b2, epsilon, pt, pu);
+        if (t)
+            *t = pt;
+        if (u)
+            *u = pu;
+        return type == 1 ? BoundedIntersection : type == 2 ? UnboundedIntersection : NoIntersection;
     }
 
 
@@ -786,7 +967,7 @@ namespace z_qtshapes {
         only one of the lines.
         \value BoundedIntersection The two lines intersect with each other
         within the start and end points of each line.
-        \sa intersect()
+        \sa intersectionPoint()
     */
 
     /*!
@@ -842,6 +1023,70 @@ namespace z_qtshapes {
             QString::number(pt1.y()), QString::number(pt2.x()), QString::number(pt2.y()), QString::number(a));
     }
 
+    /*!
+        \fn QRectF ZQLineF::boundingRect() const
+
+        Returns the axis aligned bounding rectangle of the line with its end
+        points rotated about center(), without building a path.
+    */
+
+    QRectF ZQLineF::boundingRect() const noexcept
+    {
+        qreal c, s;
+        angleCosSin(a, &c, &s);
+        const QPointF points[2] = { pt1, pt2 };
+        return rotatedBounds(points, 2, center(), c, s);
+    }
+
+    /*!
+        \fn int ZQLineF::strokeVertexCount() const
+
+        Returns the number of vertices tessellateStroke() writes, which is
+        always 4.
+    */
+
+    /*!
+        \fn int ZQLineF::strokeIndexCount() const
+
+        Returns the number of indices tessellateStroke() writes, which is
+        always 6.
+    */
+
+    /*!
+        \fn void ZQLineF::tessellateStroke(qreal width, float *vertices, quint32 *indices, quint32 baseVertex) const
+
+        Writes the outline of the rotated line stroked with a pen of
+        \a width and flat caps into \a vertices, as interleaved x and y
+        coordinates, and two triangles into \a indices as a triangle list.
+        \a baseVertex is added to every index; pass the number of vertices
+        already in the buffer.
+
+        The arrays must have room for strokeVertexCount() pairs of floats
+        and strokeIndexCount() indices. The triangles wind the same way as
+        the ones tessellate() writes for the other shapes. A line of zero
+        length gives a quad of zero area.
+    */
+
+    void ZQLineF::tessellateStroke(qreal width, float *vertices, quint32 *indices, quint32 baseVertex) const noexcept
+    {
+        QPointF r1, r2;
+        rotatedEndPoints(pt1, pt2, center(), a, r1, r2);
+
+        const QPointF d = r2 - r1;
+        const qreal length = qSqrt(d.x() * d.x() + d.y() * d.y());
+        const QPointF n = length > 0 ? QPointF(-d.y(), d.x()) * (qAbs(width) / 2 / length) : QPointF();
+
+        const QPointF quad[4] = { r1 - n, r2 - n, r2 + n, r1 + n };
+        for (int i = 0; i < 4; ++i) {
+            vertices[2*i] = float(quad[i].x());
+            vertices[2*i + 1] = float(quad[i].y());
+        }
+
+        const quint32 fan[6] = { 0, 1, 2, 0, 2, 3 };
+        for (int i = 0; i < 6; ++i)
+            indices[i] = baseVertex + fan[i];
+    }
+
     /*!
         \fn QPainterPath ZQLineF::toPath()
 
@@ -891,15 +1136,12 @@ namespace z_qtshapes {
         c1a += cn;
         c2a += cn;
 
-        QPointF c1r, c2r;
-        boost::geometry::strategy::transform::matrix_transformer<float, 2, 2>project2D(mat(0,0), mat(0,1), mat(0,2), mat(1,0), mat(1,1), mat(1,2), mat(2,0), mat(2,1), mat(2,2));
-        boost::geometry::transform(c1a - ref, c1r, project2D);
-        boost::geometry::transform(c2a - ref, c2r, project2D);
-        c1r += ref;
-        c2r += ref;
+        qreal x[2] = { c1a.x(), c2a.x() };
+        qreal y[2] = { c1a.y(), c2a.y() };
+        transformPoints(ZQPointTransform(mat, ref), x, y, x, y, 2);
 
-        path.moveTo(c1r);
-        path.lineTo(c2r);
+        path.moveTo(x[0], y[0]);
+        path.lineTo(x[1], y[1]);
         path.closeSubpath();
         return path;
     }
@@ -1253,23 +1495,23 @@ namespace z_qtshapes {
 
 
     /*!
-        \fn bool ZQLineF::contains(const QPoint &point) const
+        \fn bool ZQLineF::contains(const QPointF &point, qreal epsilon) const
 
-        Returns \c true if the given \a point is on
+        Returns \c true if the given \a point lies within \a epsilon of
         the line, otherwise returns \c false.
 
         \sa intersects()
     */
 
-    bool ZQLineF::contains(const QPointF &p) const noexcept
+    bool ZQLineF::contains(const QPointF &p, qreal epsilon) const noexcept
     {
         if (isNull() || p.isNull())
             return false;
 
-        const QPainterPath path1 = toPath();
-
-        return path1.contains(p);
+        QPointF a1, a2;
+        rotatedEndPoints(pt1, pt2, center(), a, a1, a2);
 
+        return pointOnSegment(a1, a2, p, epsilon);
     }
 
 
@@ -1282,23 +1524,25 @@ namespace z_qtshapes {
     */
 
     /*!
-        \fn bool ZQLineF::contains(const ZQLine &line) const
+        \fn bool ZQLineF::contains(const ZQLineF &line, qreal epsilon) const
         \overload
 
         Returns \c true if the given \a line is on this line.
-        otherwise returns \c false.
+        otherwise returns \c false. The lines must be colinear and both end
+        points of \a line must lie within \a epsilon of this line.
     */
 
-    bool ZQLineF::contains(const ZQLineF &r) const noexcept
+    bool ZQLineF::contains(const ZQLineF &r, qreal epsilon) const noexcept
     {
         if (isNull() || r.isNull())
             return false;
 
-        const QPainterPath path1 = toPath();
-        const QPainterPath path2 = r.toPath();
+        QPointF a1, a2;
+        rotatedEndPoints(pt1, pt2, center(), a, a1, a2);
+        QPointF b1, b2;
+        rotatedEndPoints(r.pt1, r.pt2, r.center(), r.a, b1, b2);
 
-        return path1.contains(path2);
-   
+        return pointOnSegment(a1, a2, b1, epsilon) && pointOnSegment(a1, a2, b2, epsilon);
     }
 
     /*!
@@ -1375,24 +1619,66 @@ namespace z_qtshapes {
     */
 
     /*!
-        \fn bool ZQLineF::intersects(const ZQLineF &line) const
+        \fn bool ZQLineF::intersects(const ZQLineF &line, qreal epsilon) const
 
         Returns \c true if this line intersects with the given \a
         line (i.e., there is at least one pixel that is within both
-        lines), otherwise returns \c false.
+        lines), otherwise returns \c false. Touching end points and
+        colinear overlaps count as intersections, and points within
+        \a epsilon of a line are considered to be on it.
 
         The intersection line can be retrieved using the intersected()
-        function.
+        function, and the intersection parameters using
+        intersectionPoint().
 
         \sa contains()
     */
 
-    bool ZQLineF::intersects(const ZQLineF &r) const noexcept
+    bool ZQLineF::intersects(const ZQLineF &r, qreal epsilon) const noexcept
     {
-        const QPainterPath path1 = toPath();
-        const QPainterPath path2 = r.toPath();
+        QPointF a1, a2;
+        rotatedEndPoints(pt1, pt2, center(), a, a1, a2);
+        QPointF b1, b2;
+        rotatedEndPoints(r.pt1, r.pt2, r.center(), r.a, b1, b2);
 
-        return path1.intersects(path2);
+        qreal t, u;
+        return segmentIntersection(a1, a2, b1, b2, epsilon, t, u) == 1;
+    }
+
+
+    /*!
+        \fn ZQLineF::IntersectionType ZQLineF::intersectionPoint(const ZQLineF &line, qreal *t, qreal *u, qreal epsilon) const
+
+        Computes where this line and the given \a line meet, without
+        constructing a QPainterPath. Both lines are first rotated about
+        their centers.
+
+        Returns NoIntersection if the lines are parallel or colinear without
+        overlap, BoundedIntersection if the intersection lies on both
+        segments and UnboundedIntersection if only the infinite lines meet.
+        Unless they are null, \a t and \a u receive the parameters of the
+        intersection along this line and along \a line respectively, where
+        0 is the start point and 1 the end point. For colinear overlapping
+        lines they locate the start of the overlap. Points within \a epsilon
+        of a line are considered to be on it.
+
+        \sa intersects(), pointAt()
+    */
+
+    ZQLineF::IntersectionType ZQLineF::intersectionPoint(const ZQLineF &r, qreal *t, qreal *u, qreal epsilon) const noexcept
+    {
+        QPointF a1, a2;
+        rotatedEndPoints(pt1, pt2, center(), a, a1, a2);
+        QPointF b1, b2;
+        rotatedEndPoints(r.pt1, r.pt2, r.center(), r.a, b1, b2);
+
+        qreal pt = 0, pu = 0;
+        const int type = segmentIntersection(a1, a2, b1, b2, epsilon, pt, pu);
+        if (t)
+            *t = pt;
+        if (u)
+            *u = pu;
+        return type == 1 ? BoundedIntersection : type == 2 ? UnboundedIntersection : NoIntersection;
     }
 
 
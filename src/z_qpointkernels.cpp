@@ -0,0 +1,1431 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#include "z_qpointkernels.h"
+#include <cmath>
+#include <cstring>
+
+/*
+ * The vector kernels are only built for x86 with qreal being double. Each
+ * one carries its own target attribute, so this file needs no special
+ * compiler flags and the kernels are only entered once CPUID says they
+ * can run. Contraction into fused multiply-adds is turned off for every
+ * kernel, including the scalar one, so that all of them round each
+ * product and sum the same way and produce identical results.
+ */
+#if (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)) && !defined(QT_COORD_TYPE)
+#  define Z_SIMD_X86
+#  include <immintrin.h>
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#  else
+#    include <cpuid.h>
+#  endif
+#endif
+
+#if defined(__clang__)
+#  define Z_NO_CONTRACT
+#  define Z_SIMD_TARGET(isa) __attribute__((target(isa)))
+#  pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#  define Z_NO_CONTRACT __attribute__((optimize("fp-contract=off")))
+#  define Z_SIMD_TARGET(isa) __attribute__((target(isa), optimize("fp-contract=off")))
+#else
+#  define Z_NO_CONTRACT
+#  define Z_SIMD_TARGET(isa)
+#endif
+
+
+namespace z_qtshapes {
+
+    namespace {
+
+        // Shape constants shared by the scalar and the vector kernels.
+        struct RectParams {
+            qreal cx, cy, c, s, hw, hh;
+        };
+
+        struct EllipseParams {
+            qreal cx, cy, c, s, rx, ry;
+        };
+
+        // The first vertex and the edge vectors of the rotated triangle.
+        struct TriParams {
+            qreal x0, y0, x1, y1, x2, y2;
+            qreal e0x, e0y, e1x, e1y, e2x, e2y;
+        };
+
+        Z_NO_CONTRACT inline bool rectContains(const RectParams &k, qreal x, qreal y) noexcept
+        {
+            const qreal dx = x - k.cx;
+            const qreal dy = y - k.cy;
+            const qreal u = dx * k.c - dy * k.s;
+            const qreal v = dx * k.s + dy * k.c;
+            return std::fabs(u) <= k.hw && std::fabs(v) <= k.hh;
+        }
+
+        Z_NO_CONTRACT inline bool ellipseContains(const EllipseParams &k, qreal x, qreal y) noexcept
+        {
+            const qreal dx = x - k.cx;
+            const qreal dy = y - k.cy;
+            const qreal lx = (k.c * dx - k.s * dy) / k.rx;
+            const qreal ly = (k.s * dx + k.c * dy) / k.ry;
+            return lx * lx + ly * ly <= 1;
+        }
+
+        Z_NO_CONTRACT inline bool triContains(const TriParams &k, qreal x, qreal y) noexcept
+        {
+            const qreal o0 = k.e0x * (y - k.y0) - k.e0y * (x - k.x0);
+            const qreal o1 = k.e1x * (y - k.y1) - k.e1y * (x - k.x1);
+            const qreal o2 = k.e2x * (y - k.y2) - k.e2y * (x - k.x2);
+            const bool neg = o0 < 0 || o1 < 0 || o2 < 0;
+            const bool pos = o0 > 0 || o1 > 0 || o2 > 0;
+            return !(neg && pos);
+        }
+
+        // The transform matrix and reference point in the kernel's precision.
+        // The divide is skipped when the bottom row is (0, 0, 1).
+        template <typename T>
+        struct TransformParams {
+            T m00, m01, m02, m10, m11, m12, m20, m21, m22;
+            T rx, ry;
+            bool affine;
+        };
+
+        // A point whose w is zero lies at infinity; it is left undivided
+        // rather than turned into infinities.
+        template <typename T>
+        Z_NO_CONTRACT inline void transformPoint(const TransformParams<T> &k, T x, T y, T *outX, T *outY) noexcept
+        {
+            const T dx = x - k.rx;
+            const T dy = y - k.ry;
+            T tx = k.m00 * dx + k.m01 * dy + k.m02;
+            T ty = k.m10 * dx + k.m11 * dy + k.m12;
+            if (!k.affine) {
+                const T w = k.m20 * dx + k.m21 * dy + k.m22;
+                if (w != 0) {
+                    tx = tx / w;
+                    ty = ty / w;
+                }
+            }
+            *outX = tx + k.rx;
+            *outY = ty + k.ry;
+        }
+
+        template <typename T>
+        Z_NO_CONTRACT void scalarTransform(const TransformParams<T> &k, const T *x, const T *y, T *outX, T *outY,
+                int from, int n) noexcept
+        {
+            for (int i = from; i < n; ++i)
+                transformPoint(k, x[i], y[i], outX + i, outY + i);
+        }
+
+        // Fills the mask from point index "from", which is a multiple of 8,
+        // up to n. Bits past n in the last byte are cleared.
+        template <typename Params>
+        Z_NO_CONTRACT void scalarKernel(bool (*contains)(const Params &, qreal, qreal), const Params &k,
+                const qreal *x, const qreal *y, int from, int n, quint8 *mask) noexcept
+        {
+            for (int b = from / 8; b * 8 < n; ++b) {
+                const int end = qMin(n, b * 8 + 8);
+                int bits = 0;
+                for (int i = b * 8; i < end; ++i)
+                    bits |= int(contains(k, x[i], y[i])) << (i - b * 8);
+                mask[b] = quint8(bits);
+            }
+        }
+
+        // A row of points origin + i * step, given relative to the shape's
+        // reference point so that float keeps its precision near the shape.
+        struct RowParams {
+            float ox, oy, sx, sy;
+        };
+
+        // Distance constants in float; every shape is taken about its own
+        // reference point, the center or the first vertex.
+        struct RectDistanceParams {
+            float c, s, hw, hh;
+        };
+
+        // The segment from the origin to (ex, ey); il is one over its
+        // squared length, or zero for a point.
+        struct SegmentDistanceParams {
+            float ex, ey, il;
+        };
+
+        // The triangle (0, 0), (bx, by), (cx, cy), the inverse squared
+        // lengths of its edges and the sign of its winding.
+        struct TriDistanceParams {
+            float bx, by, cx, cy, i0, i1, i2, s;
+        };
+
+        // ka and kb are (a*a - b*b) / a and (b*b - a*a) / b, the offsets of
+        // the centers of curvature used by the iteration.
+        struct EllipseDistanceParams {
+            float c, s, a, b, ia, ib, ka, kb;
+        };
+
+        const int ellipseIterations = 4;
+
+        Z_NO_CONTRACT inline float rectDistance(const RectDistanceParams &k, float x, float y) noexcept
+        {
+            const float u = std::fabs(x * k.c - y * k.s) - k.hw;
+            const float v = std::fabs(x * k.s + y * k.c) - k.hh;
+            const float mu = qMax(u, 0.f), mv = qMax(v, 0.f);
+            return std::sqrt(mu * mu + mv * mv) + qMin(qMax(u, v), 0.f);
+        }
+
+        Z_NO_CONTRACT inline float segmentDistance(const SegmentDistanceParams &k, float x, float y) noexcept
+        {
+            const float t = qMin(qMax((x * k.ex + y * k.ey) * k.il, 0.f), 1.f);
+            const float dx = x - k.ex * t, dy = y - k.ey * t;
+            return std::sqrt(dx * dx + dy * dy);
+        }
+
+        /*
+         * The squared distance to the nearest edge, and the smallest of the
+         * signed edge functions, which is positive only inside.
+         */
+        Z_NO_CONTRACT inline float triDistance(const TriDistanceParams &k, float x, float y) noexcept
+        {
+            const float w1x = x - k.bx, w1y = y - k.by;
+            const float w2x = x - k.cx, w2y = y - k.cy;
+            const float e1x = k.cx - k.bx, e1y = k.cy - k.by;
+            const float t0 = qMin(qMax((x * k.bx + y * k.by) * k.i0, 0.f), 1.f);
+            const float t1 = qMin(qMax((w1x * e1x + w1y * e1y) * k.i1, 0.f), 1.f);
+            const float t2 = qMin(qMax((w2x * -k.cx + w2y * -k.cy) * k.i2, 0.f), 1.f);
+            const float p0x = x - k.bx * t0, p0y = y - k.by * t0;
+            const float p1x = w1x - e1x * t1, p1y = w1y - e1y * t1;
+            const float p2x = w2x + k.cx * t2, p2y = w2y + k.cy * t2;
+            const float d = qMin(qMin(p0x * p0x + p0y * p0y, p1x * p1x + p1y * p1y), p2x * p2x + p2y * p2y);
+            const float o = qMin(qMin(k.s * (x * k.by - y * k.bx), k.s * (w1x * e1y - w1y * e1x)),
+                                 k.s * (w2x * -k.cy - w2y * -k.cx));
+            const float dist = std::sqrt(d);
+            return o > 0 ? -dist : dist;
+        }
+
+        /*
+         * Closest point on the ellipse by moving a point (a*tx, b*ty) on the
+         * quarter arc along the circle of curvature at it, which converges
+         * in a few steps from anywhere in the quadrant without branching.
+         */
+        Z_NO_CONTRACT inline float ellipseDistance(const EllipseDistanceParams &k, float x, float y) noexcept
+        {
+            const float px = std::fabs(x * k.c - y * k.s);
+            const float py = std::fabs(x * k.s + y * k.c);
+            float tx = 0.70710677f, ty = 0.70710677f;
+            for (int i = 0; i < ellipseIterations; ++i) {
+                const float ex = k.ka * (tx * tx * tx), ey = k.kb * (ty * ty * ty);
+                const float rx = k.a * tx - ex, ry = k.b * ty - ey;
+                const float qx = px - ex, qy = py - ey;
+                const float r = std::sqrt(rx * rx + ry * ry);
+                const float q = qMax(std::sqrt(qx * qx + qy * qy), 1e-30f);
+                tx = qMin(qMax((qx * r / q + ex) * k.ia, 0.f), 1.f);
+                ty = qMin(qMax((qy * r / q + ey) * k.ib, 0.f), 1.f);
+                const float t = qMax(std::sqrt(tx * tx + ty * ty), 1e-30f);
+                tx = tx / t;
+                ty = ty / t;
+            }
+            const float dx = px - k.a * tx, dy = py - k.b * ty;
+            const float dist = std::sqrt(dx * dx + dy * dy);
+            const float ux = px * k.ia, uy = py * k.ib;
+            return ux * ux + uy * uy < 1 ? -dist : dist;
+        }
+
+        // Lowers out[i] to the distance of point i, from index "from" to n.
+        template <typename Params>
+        Z_NO_CONTRACT void scalarDistance(float (*distance)(const Params &, float, float), const Params &k,
+                const RowParams &row, int from, int n, float *out) noexcept
+        {
+            for (int i = from; i < n; ++i) {
+                const float x = row.ox + float(i) * row.sx;
+                const float y = row.oy + float(i) * row.sy;
+                out[i] = qMin(out[i], distance(k, x, y));
+            }
+        }
+
+    #ifdef Z_SIMD_X86
+
+        void cpuid(unsigned leaf, unsigned regs[4]) noexcept
+        {
+        #if defined(_MSC_VER)
+            int r[4];
+            __cpuidex(r, int(leaf), 0);
+            for (int i = 0; i < 4; ++i)
+                regs[i] = unsigned(r[i]);
+        #else
+            __cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+        #endif
+        }
+
+        quint64 xgetbv0() noexcept
+        {
+        #if defined(_MSC_VER)
+            return _xgetbv(0);
+        #else
+            unsigned lo, hi;
+            __asm__ volatile(".byte 0x0f, 0x01, 0xd0" : "=a"(lo), "=d"(hi) : "c"(0));
+            return (quint64(hi) << 32) | lo;
+        #endif
+        }
+
+        /*
+         * AVX needs the OS to save the YMM registers (XCR0 bits 1 and 2),
+         * AVX-512 additionally the opmask and ZMM state (bits 5 to 7).
+         */
+        ZQSimdLevel detectSimdLevel() noexcept
+        {
+            unsigned r[4];
+            cpuid(0, r);
+            const unsigned maxLeaf = r[0];
+
+            cpuid(1, r);
+            if (!(r[3] & (1u << 26)))
+                return ZQScalarLevel;
+            const bool osxsave = r[2] & (1u << 27);
+            const bool avx = r[2] & (1u << 28);
+            if (!osxsave || !avx || maxLeaf < 7)
+                return ZQSSE2Level;
+
+            const quint64 xcr0 = xgetbv0();
+            if ((xcr0 & 0x6) != 0x6)
+                return ZQSSE2Level;
+
+            cpuid(7, r);
+            if (!(r[1] & (1u << 5)))
+                return ZQSSE2Level;
+            if ((r[1] & (1u << 16)) && (xcr0 & 0xe6) == 0xe6)
+                return ZQAVX512Level;
+            return ZQAVX2Level;
+        }
+
+        /*
+         * The vector kernels handle whole bytes of the mask, 8 points at a
+         * time, and return the number of points done; the scalar kernel
+         * finishes the rest. Absolute values clear the sign bit, which is
+         * what fabs() does, and the ordered comparisons are false for NaN
+         * like the scalar ones.
+         */
+
+        Z_SIMD_TARGET("sse2") int rectSSE2(const RectParams &k, const qreal *x, const qreal *y, int n, quint8 *mask) noexcept
+        {
+            const __m128d cx = _mm_set1_pd(k.cx), cy = _mm_set1_pd(k.cy);
+            const __m128d c = _mm_set1_pd(k.c), s = _mm_set1_pd(k.s);
+            const __m128d hw = _mm_set1_pd(k.hw), hh = _mm_set1_pd(k.hh);
+            const __m128d sign = _mm_set1_pd(-0.0);
+            const int blocks = n / 8;
+            for (int b = 0; b < blocks; ++b) {
+                int bits = 0;
+                for (int j = 0; j < 8; j += 2) {
+                    const __m128d dx = _mm_sub_pd(_mm_loadu_pd(x + b * 8 + j), cx);
+                    const __m128d dy = _mm_sub_pd(_mm_loadu_pd(y + b * 8 + j), cy);
+                    const __m128d u = _mm_andnot_pd(sign, _mm_sub_pd(_mm_mul_pd(dx, c), _mm_mul_pd(dy, s)));
+                    const __m128d v = _mm_andnot_pd(sign, _mm_add_pd(_mm_mul_pd(dx, s), _mm_mul_pd(dy, c)));
+                    const __m128d in = _mm_and_pd(_mm_cmple_pd(u, hw), _mm_cmple_pd(v, hh));
+                    bits |= _mm_movemask_pd(in) << j;
+                }
+                mask[b] = quint8(bits);
+            }
+            return blocks * 8;
+        }
+
+        Z_SIMD_TARGET("avx2") int rectAVX2(const RectParams &k, const qreal *x, const qreal *y, int n, quint8 *mask) noexcept
+        {
+            const __m256d cx = _mm256_set1_pd(k.cx), cy = _mm256_set1_pd(k.cy);
+            const __m256d c = _mm256_set1_pd(k.c), s = _mm256_set1_pd(k.s);
+            const __m256d hw = _mm256_set1_pd(k.hw), hh = _mm256_set1_pd(k.hh);
+            const __m256d sign = _mm256_set1_pd(-0.0);
+            const int blocks = n / 8;
+            for (int b = 0; b < blocks; ++b) {
+                int bits = 0;
+                for (int j = 0; j < 8; j += 4) {
+                    const __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + b * 8 + j), cx);
+                    const __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + b * 8 + j), cy);
+                    const __m256d u = _mm256_andnot_pd(sign, _mm256_sub_pd(_mm256_mul_pd(dx, c), _mm256_mul_pd(dy, s)));
+                    const __m256d v = _mm256_andnot_pd(sign, _mm256_add_pd(_mm256_mul_pd(dx, s), _mm256_mul_pd(dy, c)));
+                    const __m256d in = _mm256_and_pd(_mm256_cmp_pd(u, hw, _CMP_LE_OQ), _mm256_cmp_pd(v, hh, _CMP_LE_OQ));
+                    bits |= _mm256_movemask_pd(in) << j;
+                }
+                mask[b] = quint8(bits);
+            }
+            return blocks * 8;
+        }
+
+        Z_SIMD_TARGET("avx512f") int rectAVX512(const RectParams &k, const qreal *x, const qreal *y, int n, quint8 *mask) noexcept
+        {
+            const __m512d cx = _mm512_set1_pd(k.cx), cy = _mm512_set1_pd(k.cy);
+            const __m512d c = _mm512_set1_pd(k.c), s = _mm512_set1_pd(k.s);
+            const __m512d hw = _mm512_set1_pd(k.hw), hh = _mm512_set1_pd(k.hh);
+            const int blocks = n / 8;
+            for (int b = 0; b < blocks; ++b) {
+                const __m512d dx = _mm512_sub_pd(_mm512_loadu_pd(x + b * 8), cx);
+                const __m512d dy = _mm512_sub_pd(_mm512_loadu_pd(y + b * 8), cy);
+                const __m512d u = _mm512_abs_pd(_mm512_sub_pd(_mm512_mul_pd(dx, c), _mm512_mul_pd(dy, s)));
+                const __m512d v = _mm512_abs_pd(_mm512_add_pd(_mm512_mul_pd(dx, s), _mm512_mul_pd(dy, c)));
+                mask[b] = quint8(_mm512_cmp_pd_mask(u, hw, _CMP_LE_OQ) & _mm512_cmp_pd_mask(v, hh, _CMP_LE_OQ));
+            }
+            return blocks * 8;
+        }
+
+        Z_SIMD_TARGET("sse2") int ellipseSSE2(const EllipseParams &k, const qreal *x, const qreal *y, int n, quint8 *mask) noexcept
+        {
+            const __m128d cx = _mm_set1_pd(k.cx), cy = _mm_set1_pd(k.cy);
+            const __m128d c = _mm_set1_pd(k.c), s = _mm_set1_pd(k.s);
+            const __m128d rx = _mm_set1_pd(k.rx), ry = _mm_set1_pd(k.ry);
+            const __m128d one = _mm_set1_pd(1);
+            const int blocks = n / 8;
+            for (int b = 0; b < blocks; ++b) {
+                int bits = 0;
+                for (int j = 0; j < 8; j += 2) {
+                    const __m128d dx = _mm_sub_pd(_mm_loadu_pd(x + b * 8 + j), cx);
+                    const __m128d dy = _mm_sub_pd(_mm_loadu_pd(y + b * 8 + j), cy);
+                    const __m128d lx = _mm_div_pd(_mm_sub_pd(_mm_mul_pd(c, dx), _mm_mul_pd(s, dy)), rx);
+                    const __m128d ly = _mm_div_pd(_mm_add_pd(_mm_mul_pd(s, dx), _mm_mul_pd(c, dy)), ry);
+                    const __m128d r = _mm_add_pd(_mm_mul_pd(lx, lx), _mm_mul_pd(ly, ly));
+                    bits |= _mm_movemask_pd(_mm_cmple_pd(r, one)) << j;
+                }
+                mask[b] = quint8(bits);
+            }
+            return blocks * 8;
+        }
+
+        Z_SIMD_TARGET("avx2") int ellipseAVX2(const EllipseParams &k, const qreal *x, const qreal *y, int n, quint8 *mask) noexcept
+        {
+            const __m256d cx = _mm256_set1_pd(k.cx), cy = _mm256_set1_pd(k.cy);
+            const __m256d c = _mm256_set1_pd(k.c), s = _mm256_set1_pd(k.s);
+            const __m256d rx = _mm256_set1_pd(k.rx), ry = _mm256_set1_pd(k.ry);
+            const __m256d one = _mm256_set1_pd(1);
+            const int blocks = n / 8;
+            for (int b = 0; b < blocks; ++b) {
+                int bits = 0;
+                for (int j = 0; j < 8; j += 4) {
+                    const __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + b * 8 + j), cx);
+                    const __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + b * 8 + j), cy);
+                    const __m256d lx = _mm256_div_pd(_mm256_sub_pd(_mm256_mul_pd(c, dx), _mm256_mul_pd(s, dy)), rx);
+                    const __m256d ly = _mm256_div_pd(_mm256_add_pd(_mm256_mul_pd(s, dx), _mm256_mul_pd(c, dy)), ry);
+                    const __m256d r = _mm256_add_pd(_mm256_mul_pd(lx, lx), _mm256_mul_pd(ly, ly));
+                    bits |= _mm256_movemask_pd(_mm256_cmp_pd(r, one, _CMP_LE_OQ)) << j;
+                }
+                mask[b] = quint8(bits);
+            }
+            return blocks * 8;
+        }
+
+        Z_SIMD_TARGET("avx512f") int ellipseAVX512(const EllipseParams &k, const qreal *x, const qreal *y, int n, quint8 *mask) noexcept
+        {
+            const __m512d cx = _mm512_set1_pd(k.cx), cy = _mm512_set1_pd(k.cy);
+            const __m512d c = _mm512_set1_pd(k.c), s = _mm512_set1_pd(k.s);
+            const __m512d rx = _mm512_set1_pd(k.rx), ry = _mm512_set1_pd(k.ry);
+            const __m512d one = _mm512_set1_pd(1);
+            const int blocks = n / 8;
+            for (int b = 0; b < blocks; ++b) {
+                const __m512d dx = _mm512_sub_pd(_mm512_loadu_pd(x + b * 8), cx);
+                const __m512d dy = _mm512_sub_pd(_mm512_loadu_pd(y + b * 8), cy);
+                const __m512d lx = _mm512_div_pd(_mm512_sub_pd(_mm512_mul_pd(c, dx), _mm512_mul_pd(s, dy)), rx);
+                const __m512d ly = _mm512_div_pd(_mm512_add_pd(_mm512_mul_pd(s, dx), _mm512_mul_pd(c, dy)), ry);
+                const __m512d r = _mm512_add_pd(_mm512_mul_pd(lx, lx), _mm512_mul_pd(ly, ly));
+                mask[b] = quint8(_mm512_cmp_pd_mask(r, one, _CMP_LE_OQ));
+            }
+            return blocks * 8;
+        }
+
+        Z_SIMD_TARGET("sse2") int triSSE2(const TriParams &k, const qreal *x, const qreal *y, int n, quint8 *mask) noexcept
+        {
+            const __m128d x0 = _mm_set1_pd(k.x0), y0 = _mm_set1_pd(k.y0);
+            const __m128d x1 = _mm_set1_pd(k.x1), y1 = _mm_set1_pd(k.y1);
+            const __m128d x2 = _mm_set1_pd(k.x2), y2 = _mm_set1_pd(k.y2);
+            const __m128d e0x = _mm_set1_pd(k.e0x), e0y = _mm_set1_pd(k.e0y);
+            const __m128d e1x = _mm_set1_pd(k.e1x), e1y = _mm_set1_pd(k.e1y);
+            const __m128d e2x = _mm_set1_pd(k.e2x), e2y = _mm_set1_pd(k.e2y);
+            const __m128d zero = _mm_setzero_pd();
+            const int blocks = n / 8;
+            for (int b = 0; b < blocks; ++b) {
+                int bits = 0;
+                for (int j = 0; j < 8; j += 2) {
+                    const __m128d px = _mm_loadu_pd(x + b * 8 + j);
+                    const __m128d py = _mm_loadu_pd(y + b * 8 + j);
+                    const __m128d o0 = _mm_sub_pd(_mm_mul_pd(e0x, _mm_sub_pd(py, y0)), _mm_mul_pd(e0y, _mm_sub_pd(px, x0)));
+                    const __m128d o1 = _mm_sub_pd(_mm_mul_pd(e1x, _mm_sub_pd(py, y1)), _mm_mul_pd(e1y, _mm_sub_pd(px, x1)));
+                    const __m128d o2 = _mm_sub_pd(_mm_mul_pd(e2x, _mm_sub_pd(py, y2)), _mm_mul_pd(e2y, _mm_sub_pd(px, x2)));
+                    const int neg = _mm_movemask_pd(_mm_or_pd(_mm_or_pd(_mm_cmplt_pd(o0, zero), _mm_cmplt_pd(o1, zero)), _mm_cmplt_pd(o2, zero)));
+                    const int pos = _mm_movemask_pd(_mm_or_pd(_mm_or_pd(_mm_cmpgt_pd(o0, zero), _mm_cmpgt_pd(o1, zero)), _mm_cmpgt_pd(o2, zero)));
+                    bits |= (~(neg & pos) & 0x3) << j;
+                }
+                mask[b] = quint8(bits);
+            }
+            return blocks * 8;
+        }
+
+        Z_SIMD_TARGET("avx2") int triAVX2(const TriParams &k, const qreal *x, const qreal *y, int n, quint8 *mask) noexcept
+        {
+            const __m256d x0 = _mm256_set1_pd(k.x0), y0 = _mm256_set1_pd(k.y0);
+            const __m256d x1 = _mm256_set1_pd(k.x1), y1 = _mm256_set1_pd(k.y1);
+            const __m256d x2 = _mm256_set1_pd(k.x2), y2 = _mm256_set1_pd(k.y2);
+            const __m256d e0x = _mm256_set1_pd(k.e0x), e0y = _mm256_set1_pd(k.e0y);
+            const __m256d e1x = _mm256_set1_pd(k.e1x), e1y = _mm256_set1_pd(k.e1y);
+            const __m256d e2x = _mm256_set1_pd(k.e2x), e2y = _mm256_set1_pd(k.e2y);
+            const __m256d zero = _mm256_setzero_pd();
+            const int blocks = n / 8;
+            for (int b = 0; b < blocks; ++b) {
+                int bits = 0;
+                for (int j = 0; j < 8; j += 4) {
+                    const __m256d px = _mm256_loadu_pd(x + b * 8 + j);
+                    const __m256d py = _mm256_loadu_pd(y + b * 8 + j);
+                    const __m256d o0 = _mm256_sub_pd(_mm256_mul_pd(e0x, _mm256_sub_pd(py, y0)), _mm256_mul_pd(e0y, _mm256_sub_pd(px, x0)));
+                    const __m256d o1 = _mm256_sub_pd(_mm256_mul_pd(e1x, _mm256_sub_pd(py, y1)), _mm256_mul_pd(e1y, _mm256_sub_pd(px, x1)));
+                    const __m256d o2 = _mm256_sub_pd(_mm256_mul_pd(e2x, _mm256_sub_pd(py, y2)), _mm256_mul_pd(e2y, _mm256_sub_pd(px, x2)));
+                    const int neg = _mm256_movemask_pd(_mm256_or_pd(_mm256_or_pd(_mm256_cmp_pd(o0, zero, _CMP_LT_OQ),
+                            _mm256_cmp_pd(o1, zero, _CMP_LT_OQ)), _mm256_cmp_pd(o2, zero, _CMP_LT_OQ)));
+                    const int pos = _mm256_movemask_pd(_mm256_or_pd(_mm256_or_pd(_mm256_cmp_pd(o0, zero, _CMP_GT_OQ),
+                            _mm256_cmp_pd(o1, zero, _CMP_GT_OQ)), _mm256_cmp_pd(o2, zero, _CMP_GT_OQ)));
+                    bits |= (~(neg & pos) & 0xf) << j;
+                }
+                mask[b] = quint8(bits);
+            }
+            return blocks * 8;
+        }
+
+        Z_SIMD_TARGET("avx512f") int triAVX512(const TriParams &k, const qreal *x, const qreal *y, int n, quint8 *mask) noexcept
+        {
+            const __m512d x0 = _mm512_set1_pd(k.x0), y0 = _mm512_set1_pd(k.y0);
+            const __m512d x1 = _mm512_set1_pd(k.x1), y1 = _mm512_set1_pd(k.y1);
+            const __m512d x2 = _mm512_set1_pd(k.x2), y2 = _mm512_set1_pd(k.y2);
+            const __m512d e0x = _mm512_set1_pd(k.e0x), e0y = _mm512_set1_pd(k.e0y);
+            const __m512d e1x = _mm512_set1_pd(k.e1x), e1y = _mm512_set1_pd(k.e1y);
+            const __m512d e2x = _mm512_set1_pd(k.e2x), e2y = _mm512_set1_pd(k.e2y);
+            const __m512d zero = _mm512_setzero_pd();
+            const int blocks = n / 8;
+            for (int b = 0; b < blocks; ++b) {
+                const __m512d px = _mm512_loadu_pd(x + b * 8);
+                const __m512d py = _mm512_loadu_pd(y + b * 8);
+                const __m512d o0 = _mm512_sub_pd(_mm512_mul_pd(e0x, _mm512_sub_pd(py, y0)), _mm512_mul_pd(e0y, _mm512_sub_pd(px, x0)));
+                const __m512d o1 = _mm512_sub_pd(_mm512_mul_pd(e1x, _mm512_sub_pd(py, y1)), _mm512_mul_pd(e1y, _mm512_sub_pd(px, x1)));
+                const __m512d o2 = _mm512_sub_pd(_mm512_mul_pd(e2x, _mm512_sub_pd(py, y2)), _mm512_mul_pd(e2y, _mm512_sub_pd(px, x2)));
+                const __mmask8 neg = _mm512_cmp_pd_mask(o0, zero, _CMP_LT_OQ) | _mm512_cmp_pd_mask(o1, zero, _CMP_LT_OQ)
+                        | _mm512_cmp_pd_mask(o2, zero, _CMP_LT_OQ);
+                const __mmask8 pos = _mm512_cmp_pd_mask(o0, zero, _CMP_GT_OQ) | _mm512_cmp_pd_mask(o1, zero, _CMP_GT_OQ)
+                        | _mm512_cmp_pd_mask(o2, zero, _CMP_GT_OQ);
+                mask[b] = quint8(~(neg & pos));
+            }
+            return blocks * 8;
+        }
+
+        /*
+         * The transform kernels load both coordinates of a point before
+         * storing either, so the output arrays may alias the input ones.
+         * Each returns the number of points done.
+         */
+
+        Z_SIMD_TARGET("sse2") int transformSSE2(const TransformParams<double> &k, const double *x, const double *y,
+                double *outX, double *outY, int n) noexcept
+        {
+            const __m128d m00 = _mm_set1_pd(k.m00), m01 = _mm_set1_pd(k.m01), m02 = _mm_set1_pd(k.m02);
+            const __m128d m10 = _mm_set1_pd(k.m10), m11 = _mm_set1_pd(k.m11), m12 = _mm_set1_pd(k.m12);
+            const __m128d m20 = _mm_set1_pd(k.m20), m21 = _mm_set1_pd(k.m21), m22 = _mm_set1_pd(k.m22);
+            const __m128d rx = _mm_set1_pd(k.rx), ry = _mm_set1_pd(k.ry);
+            const __m128d zero = _mm_setzero_pd(), one = _mm_set1_pd(1);
+            const int done = n & ~1;
+            for (int i = 0; i < done; i += 2) {
+                const __m128d dx = _mm_sub_pd(_mm_loadu_pd(x + i), rx);
+                const __m128d dy = _mm_sub_pd(_mm_loadu_pd(y + i), ry);
+                __m128d tx = _mm_add_pd(_mm_add_pd(_mm_mul_pd(m00, dx), _mm_mul_pd(m01, dy)), m02);
+                __m128d ty = _mm_add_pd(_mm_add_pd(_mm_mul_pd(m10, dx), _mm_mul_pd(m11, dy)), m12);
+                if (!k.affine) {
+                    __m128d w = _mm_add_pd(_mm_add_pd(_mm_mul_pd(m20, dx), _mm_mul_pd(m21, dy)), m22);
+                    const __m128d atInfinity = _mm_cmpeq_pd(w, zero);
+                    w = _mm_or_pd(_mm_and_pd(atInfinity, one), _mm_andnot_pd(atInfinity, w));
+                    tx = _mm_div_pd(tx, w);
+                    ty = _mm_div_pd(ty, w);
+                }
+                _mm_storeu_pd(outX + i, _mm_add_pd(tx, rx));
+                _mm_storeu_pd(outY + i, _mm_add_pd(ty, ry));
+            }
+            return done;
+        }
+
+        Z_SIMD_TARGET("avx2") int transformAVX2(const TransformParams<double> &k, const double *x, const double *y,
+                double *outX, double *outY, int n) noexcept
+        {
+            const __m256d m00 = _mm256_set1_pd(k.m00), m01 = _mm256_set1_pd(k.m01), m02 = _mm256_set1_pd(k.m02);
+            const __m256d m10 = _mm256_set1_pd(k.m10), m11 = _mm256_set1_pd(k.m11), m12 = _mm256_set1_pd(k.m12);
+            const __m256d m20 = _mm256_set1_pd(k.m20), m21 = _mm256_set1_pd(k.m21), m22 = _mm256_set1_pd(k.m22);
+            const __m256d rx = _mm256_set1_pd(k.rx), ry = _mm256_set1_pd(k.ry);
+            const __m256d zero = _mm256_setzero_pd(), one = _mm256_set1_pd(1);
+            const int done = n & ~3;
+            for (int i = 0; i < done; i += 4) {
+                const __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + i), rx);
+                const __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + i), ry);
+                __m256d tx = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(m00, dx), _mm256_mul_pd(m01, dy)), m02);
+                __m256d ty = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(m10, dx), _mm256_mul_pd(m11, dy)), m12);
+                if (!k.affine) {
+                    __m256d w = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(m20, dx), _mm256_mul_pd(m21, dy)), m22);
+                    w = _mm256_blendv_pd(w, one, _mm256_cmp_pd(w, zero, _CMP_EQ_OQ));
+                    tx = _mm256_div_pd(tx, w);
+                    ty = _mm256_div_pd(ty, w);
+                }
+                _mm256_storeu_pd(outX + i, _mm256_add_pd(tx, rx));
+                _mm256_storeu_pd(outY + i, _mm256_add_pd(ty, ry));
+            }
+            return done;
+        }
+
+        Z_SIMD_TARGET("avx512f") int transformAVX512(const TransformParams<double> &k, const double *x, const double *y,
+                double *outX, double *outY, int n) noexcept
+        {
+            const __m512d m00 = _mm512_set1_pd(k.m00), m01 = _mm512_set1_pd(k.m01), m02 = _mm512_set1_pd(k.m02);
+            const __m512d m10 = _mm512_set1_pd(k.m10), m11 = _mm512_set1_pd(k.m11), m12 = _mm512_set1_pd(k.m12);
+            const __m512d m20 = _mm512_set1_pd(k.m20), m21 = _mm512_set1_pd(k.m21), m22 = _mm512_set1_pd(k.m22);
+            const __m512d rx = _mm512_set1_pd(k.rx), ry = _mm512_set1_pd(k.ry);
+            const __m512d zero = _mm512_setzero_pd(), one = _mm512_set1_pd(1);
+            const int done = n & ~7;
+            for (int i = 0; i < done; i += 8) {
+                const __m512d dx = _mm512_sub_pd(_mm512_loadu_pd(x + i), rx);
+                const __m512d dy = _mm512_sub_pd(_mm512_loadu_pd(y + i), ry);
+                __m512d tx = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(m00, dx), _mm512_mul_pd(m01, dy)), m02);
+                __m512d ty = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(m10, dx), _mm512_mul_pd(m11, dy)), m12);
+                if (!k.affine) {
+                    __m512d w = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(m20, dx), _mm512_mul_pd(m21, dy)), m22);
+                    w = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(w, zero, _CMP_EQ_OQ), w, one);
+                    tx = _mm512_div_pd(tx, w);
+                    ty = _mm512_div_pd(ty, w);
+                }
+                _mm512_storeu_pd(outX + i, _mm512_add_pd(tx, rx));
+                _mm512_storeu_pd(outY + i, _mm512_add_pd(ty, ry));
+            }
+            return done;
+        }
+
+        Z_SIMD_TARGET("sse2") int transformSSE2(const TransformParams<float> &k, const float *x, const float *y,
+                float *outX, float *outY, int n) noexcept
+        {
+            const __m128 m00 = _mm_set1_ps(k.m00), m01 = _mm_set1_ps(k.m01), m02 = _mm_set1_ps(k.m02);
+            const __m128 m10 = _mm_set1_ps(k.m10), m11 = _mm_set1_ps(k.m11), m12 = _mm_set1_ps(k.m12);
+            const __m128 m20 = _mm_set1_ps(k.m20), m21 = _mm_set1_ps(k.m21), m22 = _mm_set1_ps(k.m22);
+            const __m128 rx = _mm_set1_ps(k.rx), ry = _mm_set1_ps(k.ry);
+            const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1);
+            const int done = n & ~3;
+            for (int i = 0; i < done; i += 4) {
+                const __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), rx);
+                const __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), ry);
+                __m128 tx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, dx), _mm_mul_ps(m01, dy)), m02);
+                __m128 ty = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m10, dx), _mm_mul_ps(m11, dy)), m12);
+                if (!k.affine) {
+                    __m128 w = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m20, dx), _mm_mul_ps(m21, dy)), m22);
+                    const __m128 atInfinity = _mm_cmpeq_ps(w, zero);
+                    w = _mm_or_ps(_mm_and_ps(atInfinity, one), _mm_andnot_ps(atInfinity, w));
+                    tx = _mm_div_ps(tx, w);
+                    ty = _mm_div_ps(ty, w);
+                }
+                _mm_storeu_ps(outX + i, _mm_add_ps(tx, rx));
+                _mm_storeu_ps(outY + i, _mm_add_ps(ty, ry));
+            }
+            return done;
+        }
+
+        Z_SIMD_TARGET("avx2") int transformAVX2(const TransformParams<float> &k, const float *x, const float *y,
+                float *outX, float *outY, int n) noexcept
+        {
+            const __m256 m00 = _mm256_set1_ps(k.m00), m01 = _mm256_set1_ps(k.m01), m02 = _mm256_set1_ps(k.m02);
+            const __m256 m10 = _mm256_set1_ps(k.m10), m11 = _mm256_set1_ps(k.m11), m12 = _mm256_set1_ps(k.m12);
+            const __m256 m20 = _mm256_set1_ps(k.m20), m21 = _mm256_set1_ps(k.m21), m22 = _mm256_set1_ps(k.m22);
+            const __m256 rx = _mm256_set1_ps(k.rx), ry = _mm256_set1_ps(k.ry);
+            const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1);
+            const int done = n & ~7;
+            for (int i = 0; i < done; i += 8) {
+                const __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + i), rx);
+                const __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + i), ry);
+                __m256 tx = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m00, dx), _mm256_mul_ps(m01, dy)), m02);
+                __m256 ty = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m10, dx), _mm256_mul_ps(m11, dy)), m12);
+                if (!k.affine) {
+                    __m256 w = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m20, dx), _mm256_mul_ps(m21, dy)), m22);
+                    w = _mm256_blendv_ps(w, one, _mm256_cmp_ps(w, zero, _CMP_EQ_OQ));
+                    tx = _mm256_div_ps(tx, w);
+                    ty = _mm256_div_ps(ty, w);
+                }
+                _mm256_storeu_ps(outX + i, _mm256_add_ps(tx, rx));
+                _mm256_storeu_ps(outY + i, _mm256_add_ps(ty, ry));
+            }
+            return done;
+        }
+
+        Z_SIMD_TARGET("avx512f") int transformAVX512(const TransformParams<float> &k, const float *x, const float *y,
+                float *outX, float *outY, int n) noexcept
+        {
+            const __m512 m00 = _mm512_set1_ps(k.m00), m01 = _mm512_set1_ps(k.m01), m02 = _mm512_set1_ps(k.m02);
+            const __m512 m10 = _mm512_set1_ps(k.m10), m11 = _mm512_set1_ps(k.m11), m12 = _mm512_set1_ps(k.m12);
+            const __m512 m20 = _mm512_set1_ps(k.m20), m21 = _mm512_set1_ps(k.m21), m22 = _mm512_set1_ps(k.m22);
+            const __m512 rx = _mm512_set1_ps(k.rx), ry = _mm512_set1_ps(k.ry);
+            const __m512 zero = _mm512_setzero_ps(), one = _mm512_set1_ps(1);
+            const int done = n & ~15;
+            for (int i = 0; i < done; i += 16) {
+                const __m512 dx = _mm512_sub_ps(_mm512_loadu_ps(x + i), rx);
+                const __m512 dy = _mm512_sub_ps(_mm512_loadu_ps(y + i), ry);
+                __m512 tx = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(m00, dx), _mm512_mul_ps(m01, dy)), m02);
+                __m512 ty = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(m10, dx), _mm512_mul_ps(m11, dy)), m12);
+                if (!k.affine) {
+                    __m512 w = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(m20, dx), _mm512_mul_ps(m21, dy)), m22);
+                    w = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(w, zero, _CMP_EQ_OQ), w, one);
+                    tx = _mm512_div_ps(tx, w);
+                    ty = _mm512_div_ps(ty, w);
+                }
+                _mm512_storeu_ps(outX + i, _mm512_add_ps(tx, rx));
+                _mm512_storeu_ps(outY + i, _mm512_add_ps(ty, ry));
+            }
+            return done;
+        }
+
+        Z_SIMD_TARGET("sse2") int rectDistanceSSE2(const RectDistanceParams &k, const RowParams &row, float *out, int n) noexcept
+        {
+            const __m128 c = _mm_set1_ps(k.c), s = _mm_set1_ps(k.s);
+            const __m128 hw = _mm_set1_ps(k.hw), hh = _mm_set1_ps(k.hh);
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 sign = _mm_set1_ps(-0.f);
+            const __m128 ox = _mm_set1_ps(row.ox), oy = _mm_set1_ps(row.oy);
+            const __m128 sx = _mm_set1_ps(row.sx), sy = _mm_set1_ps(row.sy);
+            const __m128 lane = _mm_setr_ps(0, 1, 2, 3);
+            const int done = n & ~3;
+            for (int i = 0; i < done; i += 4) {
+                const __m128 fi = _mm_add_ps(_mm_set1_ps(float(i)), lane);
+                const __m128 x = _mm_add_ps(ox, _mm_mul_ps(fi, sx));
+                const __m128 y = _mm_add_ps(oy, _mm_mul_ps(fi, sy));
+                const __m128 u = _mm_sub_ps(_mm_andnot_ps(sign, _mm_sub_ps(_mm_mul_ps(x, c), _mm_mul_ps(y, s))), hw);
+                const __m128 v = _mm_sub_ps(_mm_andnot_ps(sign, _mm_add_ps(_mm_mul_ps(x, s), _mm_mul_ps(y, c))), hh);
+                const __m128 mu = _mm_max_ps(zero, u), mv = _mm_max_ps(zero, v);
+                const __m128 d = _mm_add_ps(_mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(mu, mu), _mm_mul_ps(mv, mv))),
+                                          _mm_min_ps(_mm_max_ps(v, u), zero));
+                _mm_storeu_ps(out + i, _mm_min_ps(_mm_loadu_ps(out + i), d));
+            }
+            return done;
+        }
+
+        Z_SIMD_TARGET("sse2") int segmentDistanceSSE2(const SegmentDistanceParams &k, const RowParams &row, float *out, int n) noexcept
+        {
+            const __m128 ex = _mm_set1_ps(k.ex), ey = _mm_set1_ps(k.ey), il = _mm_set1_ps(k.il);
+            const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1);
+            const __m128 ox = _mm_set1_ps(row.ox), oy = _mm_set1_ps(row.oy);
+            const __m128 sx = _mm_set1_ps(row.sx), sy = _mm_set1_ps(row.sy);
+            const __m128 lane = _mm_setr_ps(0, 1, 2, 3);
+            const int done = n & ~3;
+            for (int i = 0; i < done; i += 4) {
+                const __m128 fi = _mm_add_ps(_mm_set1_ps(float(i)), lane);
+                const __m128 x = _mm_add_ps(ox, _mm_mul_ps(fi, sx));
+                const __m128 y = _mm_add_ps(oy, _mm_mul_ps(fi, sy));
+                const __m128 t = _mm_min_ps(_mm_max_ps(zero, _mm_mul_ps(_mm_add_ps(_mm_mul_ps(x, ex), _mm_mul_ps(y, ey)), il)), one);
+                const __m128 dx = _mm_sub_ps(x, _mm_mul_ps(ex, t)), dy = _mm_sub_ps(y, _mm_mul_ps(ey, t));
+                const __m128 d = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+                _mm_storeu_ps(out + i, _mm_min_ps(_mm_loadu_ps(out + i), d));
+            }
+            return done;
+        }
+
+        Z_SIMD_TARGET("sse2") int triDistanceSSE2(const TriDistanceParams &k, const RowParams &row, float *out, int n) noexcept
+        {
+            const __m128 bx = _mm_set1_ps(k.bx), by = _mm_set1_ps(k.by), cx = _mm_set1_ps(k.cx), cy = _mm_set1_ps(k.cy);
+            const __m128 ncx = _mm_set1_ps(-k.cx), ncy = _mm_set1_ps(-k.cy);
+            const __m128 e1x = _mm_set1_ps(k.cx - k.bx), e1y = _mm_set1_ps(k.cy - k.by);
+            const __m128 i0 = _mm_set1_ps(k.i0), i1 = _mm_set1_ps(k.i1), i2 = _mm_set1_ps(k.i2), s = _mm_set1_ps(k.s);
+            const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1);
+            const __m128 sign = _mm_set1_ps(-0.f);
+            const __m128 ox = _mm_set1_ps(row.ox), oy = _mm_set1_ps(row.oy);
+            const __m128 sx = _mm_set1_ps(row.sx), sy = _mm_set1_ps(row.sy);
+            const __m128 lane = _mm_setr_ps(0, 1, 2, 3);
+            const int done = n & ~3;
+            for (int i = 0; i < done; i += 4) {
+                const __m128 fi = _mm_add_ps(_mm_set1_ps(float(i)), lane);
+                const __m128 x = _mm_add_ps(ox, _mm_mul_ps(fi, sx));
+                const __m128 y = _mm_add_ps(oy, _mm_mul_ps(fi, sy));
+                const __m128 w1x = _mm_sub_ps(x, bx), w1y = _mm_sub_ps(y, by);
+                const __m128 w2x = _mm_sub_ps(x, cx), w2y = _mm_sub_ps(y, cy);
+                const __m128 t0 = _mm_min_ps(_mm_max_ps(zero, _mm_mul_ps(_mm_add_ps(_mm_mul_ps(x, bx), _mm_mul_ps(y, by)), i0)), one);
+                const __m128 t1 = _mm_min_ps(_mm_max_ps(zero, _mm_mul_ps(_mm_add_ps(_mm_mul_ps(w1x, e1x), _mm_mul_ps(w1y, e1y)), i1)), one);
+                const __m128 t2 = _mm_min_ps(_mm_max_ps(zero, _mm_mul_ps(_mm_add_ps(_mm_mul_ps(w2x, ncx), _mm_mul_ps(w2y, ncy)), i2)), one);
+                const __m128 p0x = _mm_sub_ps(x, _mm_mul_ps(bx, t0)), p0y = _mm_sub_ps(y, _mm_mul_ps(by, t0));
+                const __m128 p1x = _mm_sub_ps(w1x, _mm_mul_ps(e1x, t1)), p1y = _mm_sub_ps(w1y, _mm_mul_ps(e1y, t1));
+                const __m128 p2x = _mm_add_ps(w2x, _mm_mul_ps(cx, t2)), p2y = _mm_add_ps(w2y, _mm_mul_ps(cy, t2));
+                const __m128 d2 = _mm_min_ps(_mm_min_ps(_mm_add_ps(_mm_mul_ps(p0x, p0x), _mm_mul_ps(p0y, p0y)), _mm_add_ps(_mm_mul_ps(p1x, p1x), _mm_mul_ps(p1y, p1y))),
+                                            _mm_add_ps(_mm_mul_ps(p2x, p2x), _mm_mul_ps(p2y, p2y)));
+                const __m128 o = _mm_min_ps(_mm_min_ps(_mm_mul_ps(s, _mm_sub_ps(_mm_mul_ps(x, by), _mm_mul_ps(y, bx))), _mm_mul_ps(s, _mm_sub_ps(_mm_mul_ps(w1x, e1y), _mm_mul_ps(w1y, e1x)))),
+                                           _mm_mul_ps(s, _mm_sub_ps(_mm_mul_ps(w2x, ncy), _mm_mul_ps(w2y, ncx))));
+                const __m128 d = _mm_xor_ps(_mm_sqrt_ps(d2), _mm_and_ps(_mm_cmpgt_ps(o, zero), sign));
+                _mm_storeu_ps(out + i, _mm_min_ps(_mm_loadu_ps(out + i), d));
+            }
+            return done;
+        }
+
+        Z_SIMD_TARGET("sse2") int ellipseDistanceSSE2(const EllipseDistanceParams &k, const RowParams &row, float *out, int n) noexcept
+        {
+            const __m128 c = _mm_set1_ps(k.c), s = _mm_set1_ps(k.s), a = _mm_set1_ps(k.a), b = _mm_set1_ps(k.b);
+            const __m128 ia = _mm_set1_ps(k.ia), ib = _mm_set1_ps(k.ib), ka = _mm_set1_ps(k.ka), kb = _mm_set1_ps(k.kb);
+            const __m128 tiny = _mm_set1_ps(1e-30f), start = _mm_set1_ps(0.70710677f);
+            const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1);
+            const __m128 sign = _mm_set1_ps(-0.f);
+            const __m128 ox = _mm_set1_ps(row.ox), oy = _mm_set1_ps(row.oy);
+            const __m128 sx = _mm_set1_ps(row.sx), sy = _mm_set1_ps(row.sy);
+            const __m128 lane = _mm_setr_ps(0, 1, 2, 3);
+            const int done = n & ~3;
+            for (int i = 0; i < done; i += 4) {
+                const __m128 fi = _mm_add_ps(_mm_set1_ps(float(i)), lane);
+                const __m128 x = _mm_add_ps(ox, _mm_mul_ps(fi, sx));
+                const __m128 y = _mm_add_ps(oy, _mm_mul_ps(fi, sy));
+                const __m128 px = _mm_andnot_ps(sign, _mm_sub_ps(_mm_mul_ps(x, c), _mm_mul_ps(y, s)));
+                const __m128 py = _mm_andnot_ps(sign, _mm_add_ps(_mm_mul_ps(x, s), _mm_mul_ps(y, c)));
+                __m128 tx = start, ty = start;
+                for (int j = 0; j < ellipseIterations; ++j) {
+                    const __m128 ex = _mm_mul_ps(ka, _mm_mul_ps(_mm_mul_ps(tx, tx), tx));
+                    const __m128 ey = _mm_mul_ps(kb, _mm_mul_ps(_mm_mul_ps(ty, ty), ty));
+                    const __m128 rx = _mm_sub_ps(_mm_mul_ps(a, tx), ex), ry = _mm_sub_ps(_mm_mul_ps(b, ty), ey);
+                    const __m128 qx = _mm_sub_ps(px, ex), qy = _mm_sub_ps(py, ey);
+                    const __m128 r = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)));
+                    const __m128 q = _mm_max_ps(tiny, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(qx, qx), _mm_mul_ps(qy, qy))));
+                    tx = _mm_min_ps(_mm_max_ps(zero, _mm_mul_ps(_mm_add_ps(_mm_div_ps(_mm_mul_ps(qx, r), q), ex), ia)), one);
+                    ty = _mm_min_ps(_mm_max_ps(zero, _mm_mul_ps(_mm_add_ps(_mm_div_ps(_mm_mul_ps(qy, r), q), ey), ib)), one);
+                    const __m128 t = _mm_max_ps(tiny, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(tx, tx), _mm_mul_ps(ty, ty))));
+                    tx = _mm_div_ps(tx, t);
+                    ty = _mm_div_ps(ty, t);
+                }
+                const __m128 dx = _mm_sub_ps(px, _mm_mul_ps(a, tx)), dy = _mm_sub_ps(py, _mm_mul_ps(b, ty));
+                const __m128 ux = _mm_mul_ps(px, ia), uy = _mm_mul_ps(py, ib);
+                const __m128 d = _mm_xor_ps(_mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy))), _mm_and_ps(_mm_cmplt_ps(_mm_add_ps(_mm_mul_ps(ux, ux), _mm_mul_ps(uy, uy)), one), sign));
+                _mm_storeu_ps(out + i, _mm_min_ps(_mm_loadu_ps(out + i), d));
+            }
+            return done;
+        }
+
+        Z_SIMD_TARGET("avx2") int rectDistanceAVX2(const RectDistanceParams &k, const RowParams &row, float *out, int n) noexcept
+        {
+            const __m256 c = _mm256_set1_ps(k.c), s = _mm256_set1_ps(k.s);
+            const __m256 hw = _mm256_set1_ps(k.hw), hh = _mm256_set1_ps(k.hh);
+            const __m256 zero = _mm256_setzero_ps();
+            const __m256 sign = _mm256_set1_ps(-0.f);
+            const __m256 ox = _mm256_set1_ps(row.ox), oy = _mm256_set1_ps(row.oy);
+            const __m256 sx = _mm256_set1_ps(row.sx), sy = _mm256_set1_ps(row.sy);
+            const __m256 lane = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7);
+            const int done = n & ~7;
+            for (int i = 0; i < done; i += 8) {
+                const __m256 fi = _mm256_add_ps(_mm256_set1_ps(float(i)), lane);
+                const __m256 x = _mm256_add_ps(ox, _mm256_mul_ps(fi, sx));
+                const __m256 y = _mm256_add_ps(oy, _mm256_mul_ps(fi, sy));
+                const __m256 u = _mm256_sub_ps(_mm256_andnot_ps(sign, _mm256_sub_ps(_mm256_mul_ps(x, c), _mm256_mul_ps(y, s))), hw);
+                const __m256 v = _mm256_sub_ps(_mm256_andnot_ps(sign, _mm256_add_ps(_mm256_mul_ps(x, s), _mm256_mul_ps(y, c))), hh);
+                const __m256 mu = _mm256_max_ps(zero, u), mv = _mm256_max_ps(zero, v);
+                const __m256 d = _mm256_add_ps(_mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(mu, mu), _mm256_mul_ps(mv, mv))),
+                                          _mm256_min_ps(_mm256_max_ps(v, u), zero));
+                _mm256_storeu_ps(out + i, _mm256_min_ps(_mm256_loadu_ps(out + i), d));
+            }
+            return done;
+        }
+
+        Z_SIMD_TARGET("avx2") int segmentDistanceAVX2(const SegmentDistanceParams &k, const RowParams &row, float *out, int n) noexcept
+        {
+            const __m256 ex = _mm256_set1_ps(k.ex), ey = _mm256_set1_ps(k.ey), il = _mm256_set1_ps(k.il);
+            const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1);
+            const __m256 ox = _mm256_set1_ps(row.ox), oy = _mm256_set1_ps(row.oy);
+            const __m256 sx = _mm256_set1_ps(row.sx), sy = _mm256_set1_ps(row.sy);
+            const __m256 lane = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7);
+            const int done = n & ~7;
+            for (int i = 0; i < done; i += 8) {
+                const __m256 fi = _mm256_add_ps(_mm256_set1_ps(float(i)), lane);
+                const __m256 x = _mm256_add_ps(ox, _mm256_mul_ps(fi, sx));
+                const __m256 y = _mm256_add_ps(oy, _mm256_mul_ps(fi, sy));
+                const __m256 t = _mm256_min_ps(_mm256_max_ps(zero, _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(x, ex), _mm256_mul_ps(y, ey)), il)), one);
+                const __m256 dx = _mm256_sub_ps(x, _mm256_mul_ps(ex, t)), dy = _mm256_sub_ps(y, _mm256_mul_ps(ey, t));
+                const __m256 d = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+                _mm256_storeu_ps(out + i, _mm256_min_ps(_mm256_loadu_ps(out + i), d));
+            }
+            return done;
+        }
+
+        Z_SIMD_TARGET("avx2") int triDistanceAVX2(const TriDistanceParams &k, const RowParams &row, float *out, int n) noexcept
+        {
+            const __m256 bx = _mm256_set1_ps(k.bx), by = _mm256_set1_ps(k.by), cx = _mm256_set1_ps(k.cx), cy = _mm256_set1_ps(k.cy);
+            const __m256 ncx = _mm256_set1_ps(-k.cx), ncy = _mm256_set1_ps(-k.cy);
+            const __m256 e1x = _mm256_set1_ps(k.cx - k.bx), e1y = _mm256_set1_ps(k.cy - k.by);
+            const __m256 i0 = _mm256_set1_ps(k.i0), i1 = _mm256_set1_ps(k.i1), i2 = _mm256_set1_ps(k.i2), s = _mm256_set1_ps(k.s);
+            const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1);
+            const __m256 sign = _mm256_set1_ps(-0.f);
+            const __m256 ox = _mm256_set1_ps(row.ox), oy = _mm256_set1_ps(row.oy);
+            const __m256 sx = _mm256_set1_ps(row.sx), sy = _mm256_set1_ps(row.sy);
+            const __m256 lane = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7);
+            const int done = n & ~7;
+            for (int i = 0; i < done; i += 8) {
+                const __m256 fi = _mm256_add_ps(_mm256_set1_ps(float(i)), lane);
+                const __m256 x = _mm256_add_ps(ox, _mm256_mul_ps(fi, sx));
+                const __m256 y = _mm256_add_ps(oy, _mm256_mul_ps(fi, sy));
+                const __m256 w1x = _mm256_sub_ps(x, bx), w1y = _mm256_sub_ps(y, by);
+                const __m256 w2x = _mm256_sub_ps(x, cx), w2y = _mm256_sub_ps(y, cy);
+                const __m256 t0 = _mm256_min_ps(_mm256_max_ps(zero, _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(x, bx), _mm256_mul_ps(y, by)), i0)), one);
+                const __m256 t1 = _mm256_min_ps(_mm256_max_ps(zero, _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(w1x, e1x), _mm256_mul_ps(w1y, e1y)), i1)), one);
+                const __m256 t2 = _mm256_min_ps(_mm256_max_ps(zero, _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(w2x, ncx), _mm256_mul_ps(w2y, ncy)), i2)), one);
+                const __m256 p0x = _mm256_sub_ps(x, _mm256_mul_ps(bx, t0)), p0y = _mm256_sub_ps(y, _mm256_mul_ps(by, t0));
+                const __m256 p1x = _mm256_sub_ps(w1x, _mm256_mul_ps(e1x, t1)), p1y = _mm256_sub_ps(w1y, _mm256_mul_ps(e1y, t1));
+                const __m256 p2x = _mm256_add_ps(w2x, _mm256_mul_ps(cx, t2)), p2y = _mm256_add_ps(w2y, _mm256_mul_ps(cy, t2));
+                const __m256 d2 = _mm256_min_ps(_mm256_min_ps(_mm256_add_ps(_mm256_mul_ps(p0x, p0x), _mm256_mul_ps(p0y, p0y)), _mm256_add_ps(_mm256_mul_ps(p1x, p1x), _mm256_mul_ps(p1y, p1y))),
+                                            _mm256_add_ps(_mm256_mul_ps(p2x, p2x), _mm256_mul_ps(p2y, p2y)));
+                const __m256 o = _mm256_min_ps(_mm256_min_ps(_mm256_mul_ps(s, _mm256_sub_ps(_mm256_mul_ps(x, by), _mm256_mul_ps(y, bx))), _mm256_mul_ps(s, _mm256_sub_ps(_mm256_mul_ps(w1x, e1y), _mm256_mul_ps(w1y, e1x)))),
+                                           _mm256_mul_ps(s, _mm256_sub_ps(_mm256_mul_ps(w2x, ncy), _mm256_mul_ps(w2y, ncx))));
+                const __m256 d = _mm256_xor_ps(_mm256_sqrt_ps(d2), _mm256_and_ps(_mm256_cmp_ps(o, zero, _CMP_GT_OQ), sign));
+                _mm256_storeu_ps(out + i, _mm256_min_ps(_mm256_loadu_ps(out + i), d));
+            }
+            return done;
+        }
+
+        Z_SIMD_TARGET("avx2") int ellipseDistanceAVX2(const EllipseDistanceParams &k, const RowParams &row, float *out, int n) noexcept
+        {
+            const __m256 c = _mm256_set1_ps(k.c), s = _mm256_set1_ps(k.s), a = _mm256_set1_ps(k.a), b = _mm256_set1_ps(k.b);
+            const __m256 ia = _mm256_set1_ps(k.ia), ib = _mm256_set1_ps(k.ib), ka = _mm256_set1_ps(k.ka), kb = _mm256_set1_ps(k.kb);
+            const __m256 tiny = _mm256_set1_ps(1e-30f), start = _mm256_set1_ps(0.70710677f);
+            const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1);
+            const __m256 sign = _mm256_set1_ps(-0.f);
+            const __m256 ox = _mm256_set1_ps(row.ox), oy = _mm256_set1_ps(row.oy);
+            const __m256 sx = _mm256_set1_ps(row.sx), sy = _mm256_set1_ps(row.sy);
+            const __m256 lane = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7);
+            const int done = n & ~7;
+            for (int i = 0; i < done; i += 8) {
+                const __m256 fi = _mm256_add_ps(_mm256_set1_ps(float(i)), lane);
+                const __m256 x = _mm256_add_ps(ox, _mm256_mul_ps(fi, sx));
+                const __m256 y = _mm256_add_ps(oy, _mm256_mul_ps(fi, sy));
+                const __m256 px = _mm256_andnot_ps(sign, _mm256_sub_ps(_mm256_mul_ps(x, c), _mm256_mul_ps(y, s)));
+                const __m256 py = _mm256_andnot_ps(sign, _mm256_add_ps(_mm256_mul_ps(x, s), _mm256_mul_ps(y, c)));
+                __m256 tx = start, ty = start;
+                for (int j = 0; j < ellipseIterations; ++j) {
+                    const __m256 ex = _mm256_mul_ps(ka, _mm256_mul_ps(_mm256_mul_ps(tx, tx), tx));
+                    const __m256 ey = _mm256_mul_ps(kb, _mm256_mul_ps(_mm256_mul_ps(ty, ty), ty));
+                    const __m256 rx = _mm256_sub_ps(_mm256_mul_ps(a, tx), ex), ry = _mm256_sub_ps(_mm256_mul_ps(b, ty), ey);
+                    const __m256 qx = _mm256_sub_ps(px, ex), qy = _mm256_sub_ps(py, ey);
+                    const __m256 r = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(rx, rx), _mm256_mul_ps(ry, ry)));
+                    const __m256 q = _mm256_max_ps(tiny, _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(qx, qx), _mm256_mul_ps(qy, qy))));
+                    tx = _mm256_min_ps(_mm256_max_ps(zero, _mm256_mul_ps(_mm256_add_ps(_mm256_div_ps(_mm256_mul_ps(qx, r), q), ex), ia)), one);
+                    ty = _mm256_min_ps(_mm256_max_ps(zero, _mm256_mul_ps(_mm256_add_ps(_mm256_div_ps(_mm256_mul_ps(qy, r), q), ey), ib)), one);
+                    const __m256 t = _mm256_max_ps(tiny, _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(tx, tx), _mm256_mul_ps(ty, ty))));
+                    tx = _mm256_div_ps(tx, t);
+                    ty = _mm256_div_ps(ty, t);
+                }
+                const __m256 dx = _mm256_sub_ps(px, _mm256_mul_ps(a, tx)), dy = _mm256_sub_ps(py, _mm256_mul_ps(b, ty));
+                const __m256 ux = _mm256_mul_ps(px, ia), uy = _mm256_mul_ps(py, ib);
+                const __m256 d = _mm256_xor_ps(_mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy))), _mm256_and_ps(_mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(ux, ux), _mm256_mul_ps(uy, uy)), one, _CMP_LT_OQ), sign));
+                _mm256_storeu_ps(out + i, _mm256_min_ps(_mm256_loadu_ps(out + i), d));
+            }
+            return done;
+        }
+
+        Z_SIMD_TARGET("avx512f") int rectDistanceAVX512(const RectDistanceParams &k, const RowParams &row, float *out, int n) noexcept
+        {
+            const __m512 c = _mm512_set1_ps(k.c), s = _mm512_set1_ps(k.s);
+            const __m512 hw = _mm512_set1_ps(k.hw), hh = _mm512_set1_ps(k.hh);
+            const __m512 zero = _mm512_setzero_ps();
+            const __m512 ox = _mm512_set1_ps(row.ox), oy = _mm512_set1_ps(row.oy);
+            const __m512 sx = _mm512_set1_ps(row.sx), sy = _mm512_set1_ps(row.sy);
+            const __m512 lane = _mm512_setr_ps(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+            const int done = n & ~15;
+            for (int i = 0; i < done; i += 16) {
+                const __m512 fi = _mm512_add_ps(_mm512_set1_ps(float(i)), lane);
+                const __m512 x = _mm512_add_ps(ox, _mm512_mul_ps(fi, sx));
+                const __m512 y = _mm512_add_ps(oy, _mm512_mul_ps(fi, sy));
+                const __m512 u = _mm512_sub_ps(_mm512_abs_ps(_mm512_sub_ps(_mm512_mul_ps(x, c), _mm512_mul_ps(y, s))), hw);
+                const __m512 v = _mm512_sub_ps(_mm512_abs_ps(_mm512_add_ps(_mm512_mul_ps(x, s), _mm512_mul_ps(y, c))), hh);
+                const __m512 mu = _mm512_max_ps(zero, u), mv = _mm512_max_ps(zero, v);
+                const __m512 d = _mm512_add_ps(_mm512_sqrt_ps(_mm512_add_ps(_mm512_mul_ps(mu, mu), _mm512_mul_ps(mv, mv))),
+                                          _mm512_min_ps(_mm512_max_ps(v, u), zero));
+                _mm512_storeu_ps(out + i, _mm512_min_ps(_mm512_loadu_ps(out + i), d));
+            }
+            return done;
+        }
+
+        Z_SIMD_TARGET("avx512f") int segmentDistanceAVX512(const SegmentDistanceParams &k, const RowParams &row, float *out, int n) noexcept
+        {
+            const __m512 ex = _mm512_set1_ps(k.ex), ey = _mm512_set1_ps(k.ey), il = _mm512_set1_ps(k.il);
+            const __m512 zero = _mm512_setzero_ps(), one = _mm512_set1_ps(1);
+            const __m512 ox = _mm512_set1_ps(row.ox), oy = _mm512_set1_ps(row.oy);
+            const __m512 sx = _mm512_set1_ps(row.sx), sy = _mm512_set1_ps(row.sy);
+            const __m512 lane = _mm512_setr_ps(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+            const int done = n & ~15;
+            for (int i = 0; i < done; i += 16) {
+                const __m512 fi = _mm512_add_ps(_mm512_set1_ps(float(i)), lane);
+                const __m512 x = _mm512_add_ps(ox, _mm512_mul_ps(fi, sx));
+                const __m512 y = _mm512_add_ps(oy, _mm512_mul_ps(fi, sy));
+                const __m512 t = _mm512_min_ps(_mm512_max_ps(zero, _mm512_mul_ps(_mm512_add_ps(_mm512_mul_ps(x, ex), _mm512_mul_ps(y, ey)), il)), one);
+                const __m512 dx = _mm512_sub_ps(x, _mm512_mul_ps(ex, t)), dy = _mm512_sub_ps(y, _mm512_mul_ps(ey, t));
+                const __m512 d = _mm512_sqrt_ps(_mm512_add_ps(_mm512_mul_ps(dx, dx), _mm512_mul_ps(dy, dy)));
+                _mm512_storeu_ps(out + i, _mm512_min_ps(_mm512_loadu_ps(out + i), d));
+            }
+            return done;
+        }
+
+        Z_SIMD_TARGET("avx512f") int triDistanceAVX512(const TriDistanceParams &k, const RowParams &row, float *out, int n) noexcept
+        {
+            const __m512 bx = _mm512_set1_ps(k.bx), by = _mm512_set1_ps(k.by), cx = _mm512_set1_ps(k.cx), cy = _mm512_set1_ps(k.cy);
+            const __m512 ncx = _mm512_set1_ps(-k.cx), ncy = _mm512_set1_ps(-k.cy);
+            const __m512 e1x = _mm512_set1_ps(k.cx - k.bx), e1y = _mm512_set1_ps(k.cy - k.by);
+            const __m512 i0 = _mm512_set1_ps(k.i0), i1 = _mm512_set1_ps(k.i1), i2 = _mm512_set1_ps(k.i2), s = _mm512_set1_ps(k.s);
+            const __m512 zero = _mm512_setzero_ps(), one = _mm512_set1_ps(1);
+            const __m512 ox = _mm512_set1_ps(row.ox), oy = _mm512_set1_ps(row.oy);
+            const __m512 sx = _mm512_set1_ps(row.sx), sy = _mm512_set1_ps(row.sy);
+            const __m512 lane = _mm512_setr_ps(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+            const int done = n & ~15;
+            for (int i = 0; i < done; i += 16) {
+                const __m512 fi = _mm512_add_ps(_mm512_set1_ps(float(i)), lane);
+                const __m512 x = _mm512_add_ps(ox, _mm512_mul_ps(fi, sx));
+                const __m512 y = _mm512_add_ps(oy, _mm512_mul_ps(fi, sy));
+                const __m512 w1x = _mm512_sub_ps(x, bx), w1y = _mm512_sub_ps(y, by);
+                const __m512 w2x = _mm512_sub_ps(x, cx), w2y = _mm512_sub_ps(y, cy);
+                const __m512 t0 = _mm512_min_ps(_mm512_max_ps(zero, _mm512_mul_ps(_mm512_add_ps(_mm512_mul_ps(x, bx), _mm512_mul_ps(y, by)), i0)), one);
+                const __m512 t1 = _mm512_min_ps(_mm512_max_ps(zero, _mm512_mul_ps(_mm512_add_ps(_mm512_mul_ps(w1x, e1x), _mm512_mul_ps(w1y, e1y)), i1)), one);
+                const __m512 t2 = _mm512_min_ps(_mm512_max_ps(zero, _mm512_mul_ps(_mm512_add_ps(_mm512_mul_ps(w2x, ncx), _mm512_mul_ps(w2y, ncy)), i2)), one);
+                const __m512 p0x = _mm512_sub_ps(x, _mm512_mul_ps(bx, t0)), p0y = _mm512_sub_ps(y, _mm512_mul_ps(by, t0));
+                const __m512 p1x = _mm512_sub_ps(w1x, _mm512_mul_ps(e1x, t1)), p1y = _mm512_sub_ps(w1y, _mm512_mul_ps(e1y, t1));
+                const __m512 p2x = _mm512_add_ps(w2x, _mm512_mul_ps(cx, t2)), p2y = _mm512_add_ps(w2y, _mm512_mul_ps(cy, t2));
+                const __m512 d2 = _mm512_min_ps(_mm512_min_ps(_mm512_add_ps(_mm512_mul_ps(p0x, p0x), _mm512_mul_ps(p0y, p0y)), _mm512_add_ps(_mm512_mul_ps(p1x, p1x), _mm512_mul_ps(p1y, p1y))),
+                                            _mm512_add_ps(_mm512_mul_ps(p2x, p2x), _mm512_mul_ps(p2y, p2y)));
+                const __m512 o = _mm512_min_ps(_mm512_min_ps(_mm512_mul_ps(s, _mm512_sub_ps(_mm512_mul_ps(x, by), _mm512_mul_ps(y, bx))), _mm512_mul_ps(s, _mm512_sub_ps(_mm512_mul_ps(w1x, e1y), _mm512_mul_ps(w1y, e1x)))),
+                                           _mm512_mul_ps(s, _mm512_sub_ps(_mm512_mul_ps(w2x, ncy), _mm512_mul_ps(w2y, ncx))));
+                const __m512 d = _mm512_mask_sub_ps(_mm512_sqrt_ps(d2), _mm512_cmp_ps_mask(o, zero, _CMP_GT_OQ), zero, _mm512_sqrt_ps(d2));
+                _mm512_storeu_ps(out + i, _mm512_min_ps(_mm512_loadu_ps(out + i), d));
+            }
+            return done;
+        }
+
+        Z_SIMD_TARGET("avx512f") int ellipseDistanceAVX512(const EllipseDistanceParams &k, const RowParams &row, float *out, int n) noexcept
+        {
+            const __m512 c = _mm512_set1_ps(k.c), s = _mm512_set1_ps(k.s), a = _mm512_set1_ps(k.a), b = _mm512_set1_ps(k.b);
+            const __m512 ia = _mm512_set1_ps(k.ia), ib = _mm512_set1_ps(k.ib), ka = _mm512_set1_ps(k.ka), kb = _mm512_set1_ps(k.kb);
+            const __m512 tiny = _mm512_set1_ps(1e-30f), start = _mm512_set1_ps(0.70710677f);
+            const __m512 zero = _mm512_setzero_ps(), one = _mm512_set1_ps(1);
+            const __m512 ox = _mm512_set1_ps(row.ox), oy = _mm512_set1_ps(row.oy);
+            const __m512 sx = _mm512_set1_ps(row.sx), sy = _mm512_set1_ps(row.sy);
+            const __m512 lane = _mm512_setr_ps(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+            const int done = n & ~15;
+            for (int i = 0; i < done; i += 16) {
+                const __m512 fi = _mm512_add_ps(_mm512_set1_ps(float(i)), lane);
+                const __m512 x = _mm512_add_ps(ox, _mm512_mul_ps(fi, sx));
+                const __m512 y = _mm512_add_ps(oy, _mm512_mul_ps(fi, sy));
+                const __m512 px = _mm512_abs_ps(_mm512_sub_ps(_mm512_mul_ps(x, c), _mm512_mul_ps(y, s)));
+                const __m512 py = _mm512_abs_ps(_mm512_add_ps(_mm512_mul_ps(x, s), _mm512_mul_ps(y, c)));
+                __m512 tx = start, ty = start;
+                for (int j = 0; j < ellipseIterations; ++j) {
+                    const __m512 ex = _mm512_mul_ps(ka, _mm512_mul_ps(_mm512_mul_ps(tx, tx), tx));
+                    const __m512 ey = _mm512_mul_ps(kb, _mm512_mul_ps(_mm512_mul_ps(ty, ty), ty));
+                    const __m512 rx = _mm512_sub_ps(_mm512_mul_ps(a, tx), ex), ry = _mm512_sub_ps(_mm512_mul_ps(b, ty), ey);
+                    const __m512 qx = _mm512_sub_ps(px, ex), qy = _mm512_sub_ps(py, ey);
+                    const __m512 r = _mm512_sqrt_ps(_mm512_add_ps(_mm512_mul_ps(rx, rx), _mm512_mul_ps(ry, ry)));
+                    const __m512 q = _mm512_max_ps(tiny, _mm512_sqrt_ps(_mm512_add_ps(_mm512_mul_ps(qx, qx), _mm512_mul_ps(qy, qy))));
+                    tx = _mm512_min_ps(_mm512_max_ps(zero, _mm512_mul_ps(_mm512_add_ps(_mm512_div_ps(_mm512_mul_ps(qx, r), q), ex), ia)), one);
+                    ty = _mm512_min_ps(_mm512_max_ps(zero, _mm512_mul_ps(_mm512_add_ps(_mm512_div_ps(_mm512_mul_ps(qy, r), q), ey), ib)), one);
+                    const __m512 t = _mm512_max_ps(tiny, _mm512_sqrt_ps(_mm512_add_ps(_mm512_mul_ps(tx, tx), _mm512_mul_ps(ty, ty))));
+                    tx = _mm512_div_ps(tx, t);
+                    ty = _mm512_div_ps(ty, t);
+                }
+                const __m512 dx = _mm512_sub_ps(px, _mm512_mul_ps(a, tx)), dy = _mm512_sub_ps(py, _mm512_mul_ps(b, ty));
+                const __m512 ux = _mm512_mul_ps(px, ia), uy = _mm512_mul_ps(py, ib);
+                const __m512 d = _mm512_mask_sub_ps(_mm512_sqrt_ps(_mm512_add_ps(_mm512_mul_ps(dx, dx), _mm512_mul_ps(dy, dy))), _mm512_cmp_ps_mask(_mm512_add_ps(_mm512_mul_ps(ux, ux), _mm512_mul_ps(uy, uy)), one, _CMP_LT_OQ), zero, _mm512_sqrt_ps(_mm512_add_ps(_mm512_mul_ps(dx, dx), _mm512_mul_ps(dy, dy))));
+                _mm512_storeu_ps(out + i, _mm512_min_ps(_mm512_loadu_ps(out + i), d));
+            }
+            return done;
+        }
+
+    #endif
+
+        template <typename Params>
+        struct Kernels {
+            bool (*scalar)(const Params &, qreal, qreal);
+            int (*sse2)(const Params &, const qreal *, const qreal *, int, quint8 *);
+            int (*avx2)(const Params &, const qreal *, const qreal *, int, quint8 *);
+            int (*avx512)(const Params &, const qreal *, const qreal *, int, quint8 *);
+        };
+
+        template <typename Params>
+        void run(const Kernels<Params> &kernels, const Params &k, const qreal *x, const qreal *y, int n,
+                quint8 *mask, ZQSimdLevel level) noexcept
+        {
+            int done = 0;
+            switch (qMin(level, supportedSimdLevel())) {
+            case ZQAVX512Level:
+                done = kernels.avx512 ? kernels.avx512(k, x, y, n, mask) : 0;
+                break;
+            case ZQAVX2Level:
+                done = kernels.avx2 ? kernels.avx2(k, x, y, n, mask) : 0;
+                break;
+            case ZQSSE2Level:
+                done = kernels.sse2 ? kernels.sse2(k, x, y, n, mask) : 0;
+                break;
+            default:
+                break;
+            }
+            scalarKernel(kernels.scalar, k, x, y, done, n, mask);
+        }
+
+    #ifdef Z_SIMD_X86
+        const Kernels<RectParams> rectKernels = { rectContains, rectSSE2, rectAVX2, rectAVX512 };
+        const Kernels<EllipseParams> ellipseKernels = { ellipseContains, ellipseSSE2, ellipseAVX2, ellipseAVX512 };
+        const Kernels<TriParams> triKernels = { triContains, triSSE2, triAVX2, triAVX512 };
+    #else
+        const Kernels<RectParams> rectKernels = { rectContains, nullptr, nullptr, nullptr };
+        const Kernels<EllipseParams> ellipseKernels = { ellipseContains, nullptr, nullptr, nullptr };
+        const Kernels<TriParams> triKernels = { triContains, nullptr, nullptr, nullptr };
+    #endif
+
+        template <typename T>
+        struct TransformKernels {
+            int (*sse2)(const TransformParams<T> &, const T *, const T *, T *, T *, int);
+            int (*avx2)(const TransformParams<T> &, const T *, const T *, T *, T *, int);
+            int (*avx512)(const TransformParams<T> &, const T *, const T *, T *, T *, int);
+        };
+
+        template <typename T>
+        void runTransform(const TransformKernels<T> &kernels, const ZQPointTransform &t, const T *x, const T *y,
+                T *outX, T *outY, int n, ZQSimdLevel level) noexcept
+        {
+            const TransformParams<T> k = { T(t.m[0][0]), T(t.m[0][1]), T(t.m[0][2]),
+                                           T(t.m[1][0]), T(t.m[1][1]), T(t.m[1][2]),
+                                           T(t.m[2][0]), T(t.m[2][1]), T(t.m[2][2]),
+                                           T(t.ref.x()), T(t.ref.y()), t.isAffine() };
+            int done = 0;
+            switch (qMin(level, supportedSimdLevel())) {
+            case ZQAVX512Level:
+                done = kernels.avx512 ? kernels.avx512(k, x, y, outX, outY, n) : 0;
+                break;
+            case ZQAVX2Level:
+                done = kernels.avx2 ? kernels.avx2(k, x, y, outX, outY, n) : 0;
+                break;
+            case ZQSSE2Level:
+                done = kernels.sse2 ? kernels.sse2(k, x, y, outX, outY, n) : 0;
+                break;
+            default:
+                break;
+            }
+            scalarTransform(k, x, y, outX, outY, done, n);
+        }
+
+    #ifdef Z_SIMD_X86
+        const TransformKernels<double> doubleTransformKernels = { transformSSE2, transformAVX2, transformAVX512 };
+        const TransformKernels<float> floatTransformKernels = { transformSSE2, transformAVX2, transformAVX512 };
+    #else
+        const TransformKernels<double> doubleTransformKernels = { nullptr, nullptr, nullptr };
+        const TransformKernels<float> floatTransformKernels = { nullptr, nullptr, nullptr };
+    #endif
+
+        template <typename Params>
+        struct DistanceKernels {
+            float (*scalar)(const Params &, float, float);
+            int (*sse2)(const Params &, const RowParams &, float *, int);
+            int (*avx2)(const Params &, const RowParams &, float *, int);
+            int (*avx512)(const Params &, const RowParams &, float *, int);
+        };
+
+        template <typename Params>
+        void runDistance(const DistanceKernels<Params> &kernels, const Params &k, const RowParams &row, float *out,
+                int n, ZQSimdLevel level) noexcept
+        {
+            int done = 0;
+            switch (qMin(level, supportedSimdLevel())) {
+            case ZQAVX512Level:
+                done = kernels.avx512 ? kernels.avx512(k, row, out, n) : 0;
+                break;
+            case ZQAVX2Level:
+                done = kernels.avx2 ? kernels.avx2(k, row, out, n) : 0;
+                break;
+            case ZQSSE2Level:
+                done = kernels.sse2 ? kernels.sse2(k, row, out, n) : 0;
+                break;
+            default:
+                break;
+            }
+            scalarDistance(kernels.scalar, k, row, done, n, out);
+        }
+
+    #ifdef Z_SIMD_X86
+        const DistanceKernels<RectDistanceParams> rectDistanceKernels =
+            { rectDistance, rectDistanceSSE2, rectDistanceAVX2, rectDistanceAVX512 };
+        const DistanceKernels<SegmentDistanceParams> segmentDistanceKernels =
+            { segmentDistance, segmentDistanceSSE2, segmentDistanceAVX2, segmentDistanceAVX512 };
+        const DistanceKernels<TriDistanceParams> triDistanceKernels =
+            { triDistance, triDistanceSSE2, triDistanceAVX2, triDistanceAVX512 };
+        const DistanceKernels<EllipseDistanceParams> ellipseDistanceKernels =
+            { ellipseDistance, ellipseDistanceSSE2, ellipseDistanceAVX2, ellipseDistanceAVX512 };
+    #else
+        const DistanceKernels<RectDistanceParams> rectDistanceKernels = { rectDistance, nullptr, nullptr, nullptr };
+        const DistanceKernels<SegmentDistanceParams> segmentDistanceKernels = { segmentDistance, nullptr, nullptr, nullptr };
+        const DistanceKernels<TriDistanceParams> triDistanceKernels = { triDistance, nullptr, nullptr, nullptr };
+        const DistanceKernels<EllipseDistanceParams> ellipseDistanceKernels = { ellipseDistance, nullptr, nullptr, nullptr };
+    #endif
+
+        // The row relative to reference, rounded to float.
+        RowParams rowParams(const QPointF &origin, const QPointF &step, const QPointF &reference) noexcept
+        {
+            const RowParams row = { float(origin.x() - reference.x()), float(origin.y() - reference.y()),
+                                    float(step.x()), float(step.y()) };
+            return row;
+        }
+
+        void segmentRow(const QPointF &p1, const QPointF &p2, const QPointF &origin, const QPointF &step,
+                float *distance, int n, ZQSimdLevel level) noexcept
+        {
+            const qreal ex = p2.x() - p1.x(), ey = p2.y() - p1.y();
+            const qreal length2 = ex * ex + ey * ey;
+            const SegmentDistanceParams k = { float(ex), float(ey), length2 > 0 ? float(1 / length2) : 0.f };
+            runDistance(segmentDistanceKernels, k, rowParams(origin, step, p1), distance, n, level);
+        }
+
+    }
+
+
+    /*!
+        \enum ZQSimdLevel
+        \inmodule Zgeometry
+
+        This enum names the instruction sets used by the batched
+        point-in-shape and point transform kernels and by the matrix
+        product kernels. The point counts are for double; the float
+        transform handles twice as many.
+
+        \value ZQScalarLevel Portable scalar code.
+        \value ZQSSE2Level SSE2, two points per instruction.
+        \value ZQAVX2Level AVX2, four points per instruction.
+        \value ZQAVX512Level AVX-512F, eight points per instruction.
+
+        \sa supportedSimdLevel(), containsPoints(), transformPoints(), z_linalg::gemm()
+    */
+
+    /*!
+        \fn ZQSimdLevel supportedSimdLevel()
+        \relates ZQPreparedRectF
+
+        Returns the highest instruction set that both the processor, as
+        reported by CPUID, and the operating system support. The result
+        is computed once. Builds for other processors always return
+        ZQScalarLevel.
+    */
+
+    ZQSimdLevel supportedSimdLevel() noexcept
+    {
+    #ifdef Z_SIMD_X86
+        static const ZQSimdLevel level = detectSimdLevel();
+        return level;
+    #else
+        return ZQScalarLevel;
+    #endif
+    }
+
+    /*!
+        \fn void containsPoints(const ZQPreparedRectF &rect, const qreal *x, const qreal *y, int n, quint8 *mask, ZQSimdLevel level)
+        \relates ZQPreparedRectF
+
+        Tests the \a n points (\c{x[i]}, \c{y[i]}) against the rotated
+        \a rect and writes the results as a bit mask: bit \c{i % 8} of
+        \c{mask[i / 8]} is set if the rectangle contains point \c i, with
+        points on the edge inside. \a mask must have room for
+        \c{(n + 7) / 8} bytes; the unused bits of the last byte are cleared.
+
+        The highest instruction set up to \a level that supportedSimdLevel()
+        allows is used. Every level produces exactly the same mask.
+
+        There are overloads for ZQRectF, ZQEllipseF, ZQTriF and their
+        prepared forms. The overloads for the value classes prepare the
+        shape first.
+    */
+
+    void containsPoints(const ZQPreparedRectF &rect, const qreal *x, const qreal *y, int n, quint8 *mask,
+            ZQSimdLevel level) noexcept
+    {
+        const RectParams k = { rect.center().x(), rect.center().y(), rect.cosAngle(), rect.sinAngle(),
+                               rect.halfWidth(), rect.halfHeight() };
+        run(rectKernels, k, x, y, n, mask, level);
+    }
+
+    /*!
+        \fn void containsPoints(const ZQPreparedEllipseF &ellipse, const qreal *x, const qreal *y, int n, quint8 *mask, ZQSimdLevel level)
+        \relates ZQPreparedEllipseF
+        \overload
+
+        A degenerate \a ellipse with a zero radius contains no points.
+    */
+
+    void containsPoints(const ZQPreparedEllipseF &ellipse, const qreal *x, const qreal *y, int n, quint8 *mask,
+            ZQSimdLevel level) noexcept
+    {
+        if (ellipse.radiusX() <= 0 || ellipse.radiusY() <= 0) {
+            if (n > 0)
+                std::memset(mask, 0, (n + 7) / 8);
+            return;
+        }
+
+        const EllipseParams k = { ellipse.center().x(), ellipse.center().y(), ellipse.cosAngle(), ellipse.sinAngle(),
+                                  ellipse.radiusX(), ellipse.radiusY() };
+        run(ellipseKernels, k, x, y, n, mask, level);
+    }
+
+    /*!
+        \fn void containsPoints(const ZQPreparedTriF &triangle, const qreal *x, const qreal *y, int n, quint8 *mask, ZQSimdLevel level)
+        \relates ZQPreparedTriF
+        \overload
+    */
+
+    void containsPoints(const ZQPreparedTriF &triangle, const qreal *x, const qreal *y, int n, quint8 *mask,
+            ZQSimdLevel level) noexcept
+    {
+        const QPointF v0 = triangle.first(), v1 = triangle.second(), v2 = triangle.third();
+        const TriParams k = { v0.x(), v0.y(), v1.x(), v1.y(), v2.x(), v2.y(),
+                              v1.x() - v0.x(), v1.y() - v0.y(),
+                              v2.x() - v1.x(), v2.y() - v1.y(),
+                              v0.x() - v2.x(), v0.y() - v2.y() };
+        run(triKernels, k, x, y, n, mask, level);
+    }
+
+
+    /*!
+        \class ZQPointTransform
+        \inmodule Zgeometry
+        \ingroup painting
+
+        \brief The ZQPointTransform class applies a 3x3 transformation
+        matrix to points about a reference point.
+
+        A point p is mapped by taking (x, y, w) = m * (p - ref, 1) and
+        returning (x / w, y / w) + ref, so projective matrices work as well
+        as affine ones. The divide is skipped for matrices whose bottom row
+        is (0, 0, 1). A point for which w is zero lies at infinity and is
+        returned undivided.
+
+        This is the transform that the toPath() overloads taking a
+        QMatrix3x3 apply. transformPoints() applies it to whole arrays.
+
+        \sa transformPoints()
+    */
+
+    /*!
+        \fn template <typename Matrix> ZQPointTransform::ZQPointTransform(const Matrix &mat, const QPointF &reference)
+
+        Constructs a transform that applies \a mat about \a reference.
+        \a mat can be any 3x3 matrix type indexed by
+        \c{operator()(row, column)}, such as QMatrix3x3 or
+        \c{ZQMatrix<3, 3, T>}. Its elements are stored as qreal.
+    */
+
+    /*!
+        \fn bool ZQPointTransform::isAffine() const
+
+        Returns true if the bottom row of the matrix is (0, 0, 1), in which
+        case no divide is needed.
+    */
+
+    /*!
+        \fn QPointF ZQPointTransform::map(const QPointF &point) const
+
+        Returns \a point transformed. This gives exactly the same result as
+        transformPoints() does for the point.
+    */
+
+    QPointF ZQPointTransform::map(const QPointF &point) const noexcept
+    {
+        const TransformParams<qreal> k = { m[0][0], m[0][1], m[0][2], m[1][0], m[1][1], m[1][2],
+                                           m[2][0], m[2][1], m[2][2], ref.x(), ref.y(), isAffine() };
+        qreal x, y;
+        transformPoint(k, point.x(), point.y(), &x, &y);
+        return QPointF(x, y);
+    }
+
+    /*!
+        \fn void transformPoints(const ZQPointTransform &transform, const double *x, const double *y, double *outX, double *outY, int n, ZQSimdLevel level)
+        \relates ZQPointTransform
+
+        Applies \a transform to the \a n points (\c{x[i]}, \c{y[i]}) and
+        writes the results to \c{outX[i]} and \c{outY[i]}. The output arrays
+        may be the input arrays, to transform the points in place.
+
+        The highest instruction set up to \a level that supportedSimdLevel()
+        allows is used. Every level produces exactly the same results.
+
+        \sa ZQPointTransform::map()
+    */
+
+    void transformPoints(const ZQPointTransform &transform, const double *x, const double *y, double *outX, double *outY,
+            int n, ZQSimdLevel level) noexcept
+    {
+        runTransform(doubleTransformKernels, transform, x, y, outX, outY, n, level);
+    }
+
+    /*!
+        \fn void transformPoints(const ZQPointTransform &transform, const float *x, const float *y, float *outX, float *outY, int n, ZQSimdLevel level)
+        \relates ZQPointTransform
+        \overload
+
+        The matrix and the reference point are rounded to float and the
+        arithmetic is done in float, which handles twice as many points
+        per instruction.
+    */
+
+    void transformPoints(const ZQPointTransform &transform, const float *x, const float *y, float *outX, float *outY,
+            int n, ZQSimdLevel level) noexcept
+    {
+        runTransform(floatTransformKernels, transform, x, y, outX, outY, n, level);
+    }
+
+    /*!
+        \fn void distanceRow(const ZQPreparedShape &shape, const QPointF &origin, const QPointF &step, float *distance, int n, ZQSimdLevel level)
+        \relates ZQPreparedShape
+
+        Lowers \c{distance[i]} to the signed distance from the point
+        \a origin + i * \a step to \a shape, for each of the \a n points of
+        the row. Distances are negative inside rectangles, triangles and
+        ellipses and positive outside; a line is a segment without an
+        inside. Seed \a distance with infinity to get the distance to one
+        shape, or run several shapes over the same row to get the distance
+        to their union. A null shape leaves \a distance unchanged.
+
+        Rectangles, triangles and segments use their exact distance. The
+        closest point on an ellipse is found by four steps along the circle
+        of curvature, which is accurate to a small fraction of a percent of
+        the radii even for eccentric ellipses. An ellipse with a zero radius
+        is measured as the segment it collapses to.
+
+        The arithmetic is done in float about the shape's center or first
+        vertex. The highest instruction set up to \a level that
+        supportedSimdLevel() allows is used, with four, eight or sixteen
+        points per instruction. Every level produces exactly the same
+        results.
+    */
+
+    void distanceRow(const ZQPreparedShape &shape, const QPointF &origin, const QPointF &step, float *distance, int n,
+            ZQSimdLevel level) noexcept
+    {
+        switch (shape.type()) {
+        case ZQPreparedShape::RectShape: {
+            const ZQPreparedRectF &r = shape.rect();
+            const RectDistanceParams k = { float(r.cosAngle()), float(r.sinAngle()),
+                                           float(r.halfWidth()), float(r.halfHeight()) };
+            runDistance(rectDistanceKernels, k, rowParams(origin, step, r.center()), distance, n, level);
+            break;
+        }
+        case ZQPreparedShape::TriShape: {
+            const ZQPreparedTriF &t = shape.tri();
+            const QPointF b = t.second() - t.first(), c = t.third() - t.first(), e = c - b;
+            const qreal l0 = QPointF::dotProduct(b, b), l1 = QPointF::dotProduct(e, e), l2 = QPointF::dotProduct(c, c);
+            const TriDistanceParams k = { float(b.x()), float(b.y()), float(c.x()), float(c.y()),
+                                          l0 > 0 ? float(1 / l0) : 0.f, l1 > 0 ? float(1 / l1) : 0.f,
+                                          l2 > 0 ? float(1 / l2) : 0.f,
+                                          b.x() * c.y() - b.y() * c.x() > 0 ? -1.f : 1.f };
+            runDistance(triDistanceKernels, k, rowParams(origin, step, t.first()), distance, n, level);
+            break;
+        }
+        case ZQPreparedShape::EllipseShape: {
+            const ZQPreparedEllipseF &e = shape.ellipse();
+            const qreal a = e.radiusX(), b = e.radiusY();
+            if (a <= 0 || b <= 0) {
+                const QPointF axis = a > 0 ? QPointF(e.cosAngle(), -e.sinAngle()) * a
+                                           : QPointF(e.sinAngle(), e.cosAngle()) * qMax(b, qreal(0));
+                segmentRow(e.center() - axis, e.center() + axis, origin, step, distance, n, level);
+                break;
+            }
+            const EllipseDistanceParams k = { float(e.cosAngle()), float(e.sinAngle()), float(a), float(b),
+                                              float(1 / a), float(1 / b), float((a * a - b * b) / a),
+                                              float((b * b - a * a) / b) };
+            runDistance(ellipseDistanceKernels, k, rowParams(origin, step, e.center()), distance, n, level);
+            break;
+        }
+        case ZQPreparedShape::LineShape:
+            segmentRow(shape.line().p1(), shape.line().p2(), origin, step, distance, n, level);
+            break;
+        default:
+            break;
+        }
+    }
+
+}
@@ -0,0 +1,491 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#include "z_qpolygon.h"
+#include <algorithm>
+#include <cmath>
+
+
+namespace z_qtshapes {
+
+    namespace {
+
+        typedef QVarLengthArray<QPointF, 16> Points;
+
+        inline qreal cross(const QPointF &a, const QPointF &b) noexcept
+        {
+            return a.x() * b.y() - a.y() * b.x();
+        }
+
+        // Twice the signed area, positive for the orientation that
+        // clipping and union expect.
+        qreal signedArea2(const QPointF *p, int n) noexcept
+        {
+            qreal sum = 0;
+            for (int i = 0, j = n - 1; i < n; j = i++)
+                sum += cross(p[j], p[i]);
+            return sum;
+        }
+
+        // Copies a contour, reversed if needed so that its area is positive.
+        // Returns false for contours without area.
+        bool orientedCopy(const QPointF *p, int n, Points &out)
+        {
+            out.clear();
+            if (n < 3)
+                return false;
+            const qreal a = signedArea2(p, n);
+            if (!(a > 0) && !(a < 0))
+                return false;
+            for (int i = 0; i < n; ++i)
+                out.append(a > 0 ? p[i] : p[n - 1 - i]);
+            return true;
+        }
+
+        // Returns the side of the directed edge (p, q) that x lies on:
+        // positive inside a positively oriented convex contour.
+        inline qreal side(const QPointF &p, const QPointF &q, const QPointF &x) noexcept
+        {
+            return cross(q - p, x - p);
+        }
+
+        bool strictlyInside(const Points &poly, const QPointF &x) noexcept
+        {
+            const int n = poly.size();
+            for (int i = 0, j = n - 1; i < n; j = i++)
+                if (!(side(poly[j], poly[i], x) > 0))
+                    return false;
+            return true;
+        }
+
+        bool insideOrOn(const Points &poly, const QPointF &x) noexcept
+        {
+            const int n = poly.size();
+            for (int i = 0, j = n - 1; i < n; j = i++)
+                if (side(poly[j], poly[i], x) < 0)
+                    return false;
+            return true;
+        }
+
+        QRectF bounds(const Points &poly) noexcept
+        {
+            qreal l = poly[0].x(), t = poly[0].y(), r = l, b = t;
+            for (int i = 1; i < poly.size(); ++i) {
+                l = qMin(l, poly[i].x());
+                r = qMax(r, poly[i].x());
+                t = qMin(t, poly[i].y());
+                b = qMax(b, poly[i].y());
+            }
+            return QRectF(l, t, r - l, b - t);
+        }
+
+        inline bool boundsOverlap(const QRectF &a, const QRectF &b) noexcept
+        {
+            return a.left() <= b.right() && b.left() <= a.right() && a.top() <= b.bottom() && b.top() <= a.bottom();
+        }
+
+        // Drops consecutive points closer than eps, including the last one
+        // when it repeats the first.
+        void removeDuplicates(Points &poly, qreal eps)
+        {
+            int k = 0;
+            for (int i = 0; i < poly.size(); ++i) {
+                if (k > 0 && qAbs(poly[i].x() - poly[k - 1].x()) <= eps && qAbs(poly[i].y() - poly[k - 1].y()) <= eps)
+                    continue;
+                poly[k++] = poly[i];
+            }
+            while (k > 1 && qAbs(poly[k - 1].x() - poly[0].x()) <= eps && qAbs(poly[k - 1].y() - poly[0].y()) <= eps)
+                --k;
+            poly.resize(k);
+        }
+
+        qreal tolerance(const QRectF &a, const QRectF &b) noexcept
+        {
+            const qreal extent = qMax(qMax(qAbs(a.left()), qAbs(a.right())), qMax(qAbs(a.top()), qAbs(a.bottom())));
+            const qreal other = qMax(qMax(qAbs(b.left()), qAbs(b.right())), qMax(qAbs(b.top()), qAbs(b.bottom())));
+            return 1e-12 * (1 + qMax(extent, other));
+        }
+
+        /*
+         * Sutherland-Hodgman: clips the subject by the half-plane on the
+         * inside of every edge of the convex clip contour in turn. Both
+         * contours are positively oriented, and so is the result.
+         */
+        void clipConvex(const Points &subject, const Points &clip, Points &out)
+        {
+            Points input;
+            out = subject;
+            const int m = clip.size();
+            for (int e = 0, f = m - 1; e < m && !out.isEmpty(); f = e++) {
+                const QPointF p = clip[f], q = clip[e];
+                input = out;
+                out.clear();
+                const int n = input.size();
+                for (int i = 0, j = n - 1; i < n; j = i++) {
+                    const QPointF &a = input[j], &b = input[i];
+                    const qreal sa = side(p, q, a), sb = side(p, q, b);
+                    if (sb >= 0) {
+                        if (sa < 0)
+                            out.append(a + (b - a) * (sa / (sa - sb)));
+                        out.append(b);
+                    } else if (sa > 0) {
+                        out.append(a + (b - a) * (sa / (sa - sb)));
+                    }
+                }
+            }
+        }
+
+        // Appends the points where the edges of a and b cross.
+        void appendCrossings(const Points &a, const Points &b, Points &out)
+        {
+            const int n = a.size(), m = b.size();
+            for (int i = 0, j = n - 1; i < n; j = i++) {
+                const QPointF p = a[j], r = a[i] - a[j];
+                for (int k = 0, l = m - 1; k < m; l = k++) {
+                    const QPointF q = b[l], s = b[k] - b[l];
+                    const qreal d = cross(r, s);
+                    if (d == 0)
+                        continue;
+                    const qreal t = cross(q - p, s) / d;
+                    const qreal u = cross(q - p, r) / d;
+                    if (t >= 0 && t <= 1 && u >= 0 && u <= 1)
+                        out.append(p + r * t);
+                }
+            }
+        }
+
+    }
+
+
+    /*!
+        \class ZQPolygonF
+        \inmodule Zgeometry
+        \ingroup painting
+
+        \brief The ZQPolygonF class holds one or more closed polygonal
+        contours using floating point precision.
+
+        It is the result of the boolean operations of the rectangle and
+        triangle classes, such as ZQRectF::intersected() and
+        ZQTriF::united(). The contours never overlap and have no holes, so
+        the area of the polygon is the sum of the areas of its contours.
+
+        The intersection of two convex contours is computed by clipping
+        one against each edge of the other in turn (Sutherland-Hodgman),
+        which for a rectangle or triangle is a handful of passes over a
+        few points. Their union is one contour when they overlap and two when
+        they are disjoint, and is the larger contour when one contains the
+        other. Both contours of convexIntersected() and convexUnited() are
+        assumed to be convex; contours without area are ignored.
+
+        A QPainterPath is only built when toPath() is called.
+    */
+
+    /*!
+        \fn ZQPolygonF::ZQPolygonF()
+
+        Constructs an empty polygon.
+    */
+
+    /*!
+        \fn ZQPolygonF::ZQPolygonF(const QPolygonF &polygon)
+
+        Constructs a polygon with one contour holding the points of \a
+        polygon. A closing point that repeats the first one is dropped.
+    */
+
+    ZQPolygonF::ZQPolygonF(const QPolygonF &polygon)
+    {
+        int n = int(polygon.size());
+        if (n > 1 && polygon[0] == polygon[n - 1])
+            --n;
+        addContour(polygon.data(), n);
+    }
+
+    /*!
+        \fn ZQPolygonF::ZQPolygonF(const QPointF *points, int count)
+
+        Constructs a polygon with one contour holding the \a count \a points.
+    */
+
+    ZQPolygonF::ZQPolygonF(const QPointF *points, int count)
+    {
+        addContour(points, count);
+    }
+
+    /*!
+        \fn QPolygonF ZQPolygonF::contour(int i) const
+
+        Returns the points of contour \a i as a QPolygonF. The polygon is
+        not closed, so its last point is not the first one.
+    */
+
+    QPolygonF ZQPolygonF::contour(int i) const
+    {
+        QPolygonF polygon;
+        for (int k = contourStart(i); k < ends[i]; ++k)
+            polygon.append(pts[k]);
+        return polygon;
+    }
+
+    /*!
+        \fn void ZQPolygonF::addContour(const QPointF *points, int count)
+
+        Appends a contour holding the \a count \a points. Nothing is
+        appended if \a count is 0.
+    */
+
+    void ZQPolygonF::addContour(const QPointF *points, int count)
+    {
+        if (count <= 0)
+            return;
+        for (int i = 0; i < count; ++i)
+            pts.append(points[i]);
+        ends.append(pts.size());
+    }
+
+    /*!
+        \fn void ZQPolygonF::clear()
+
+        Removes all contours.
+    */
+
+    void ZQPolygonF::clear() noexcept
+    {
+        pts.clear();
+        ends.clear();
+    }
+
+    /*!
+        \fn qreal ZQPolygonF::area() const
+
+        Returns the area of the polygon, the sum of the unsigned areas of
+        its contours.
+    */
+
+    qreal ZQPolygonF::area() const noexcept
+    {
+        qreal sum = 0;
+        for (int i = 0; i < contourCount(); ++i)
+            sum += qAbs(signedArea2(pts.constData() + contourStart(i), contourSize(i)));
+        return sum / 2;
+    }
+
+    /*!
+        \fn QRectF ZQPolygonF::boundingRect() const
+
+        Returns the bounding rectangle of all contours, or a null rectangle
+        if the polygon is empty.
+    */
+
+    QRectF ZQPolygonF::boundingRect() const noexcept
+    {
+        if (isEmpty())
+            return QRectF();
+        return bounds(pts);
+    }
+
+    /*!
+        \fn bool ZQPolygonF::isConvex() const
+
+        Returns \c true if the polygon is a single contour that turns the
+        same way at every vertex. Collinear vertices are allowed.
+    */
+
+    bool ZQPolygonF::isConvex() const noexcept
+    {
+        if (contourCount() != 1 || pts.size() < 3)
+            return false;
+        const int n = pts.size();
+        bool pos = false, neg = false;
+        for (int i = 0; i < n; ++i) {
+            const qreal c = side(pts[i], pts[(i + 1) % n], pts[(i + 2) % n]);
+            pos = pos || c > 0;
+            neg = neg || c < 0;
+        }
+        return !(pos && neg);
+    }
+
+    /*!
+        \fn bool ZQPolygonF::contains(const QPointF &p) const
+
+        Returns \c true if the point \a p is inside one of the contours,
+        using the odd-even rule.
+    */
+
+    bool ZQPolygonF::contains(const QPointF &p) const noexcept
+    {
+        bool inside = false;
+        for (int c = 0; c < contourCount(); ++c) {
+            const int first = contourStart(c), last = ends[c];
+            for (int i = first, j = last - 1; i < last; j = i++) {
+                const QPointF &a = pts[i], &b = pts[j];
+                if ((a.y() > p.y()) != (b.y() > p.y())
+                        && p.x() < (b.x() - a.x()) * (p.y() - a.y()) / (b.y() - a.y()) + a.x())
+                    inside = !inside;
+            }
+        }
+        return inside;
+    }
+
+    /*!
+        \fn ZQPolygonF ZQPolygonF::convexIntersected(const ZQPolygonF &other) const
+
+        Returns the intersection of the first contour of this polygon and
+        the first contour of \a other, which must both be convex. The
+        result is empty or a single convex contour with positive signed
+        area.
+
+        \sa convexUnited()
+    */
+
+    ZQPolygonF ZQPolygonF::convexIntersected(const ZQPolygonF &other) const noexcept
+    {
+        Points a, b, out;
+        if (isEmpty() || other.isEmpty() || !orientedCopy(pts.constData(), contourSize(0), a)
+                || !orientedCopy(other.pts.constData(), other.contourSize(0), b))
+            return ZQPolygonF();
+
+        const QRectF ba = bounds(a), bb = bounds(b);
+        if (!boundsOverlap(ba, bb))
+            return ZQPolygonF();
+
+        clipConvex(a, b, out);
+        removeDuplicates(out, tolerance(ba, bb));
+        if (out.size() < 3 || !(signedArea2(out.constData(), out.size()) > 0))
+            return ZQPolygonF();
+
+        ZQPolygonF result;
+        result.addContour(out.constData(), out.size());
+        return result;
+    }
+
+    /*!
+        \fn ZQPolygonF ZQPolygonF::convexUnited(const ZQPolygonF &other) const
+
+        Returns the union of the first contour of this polygon and the
+        first contour of \a other, which must both be convex. Disjoint
+        contours, and contours that only touch, are returned as two
+        contours; otherwise the union is one contour. Every returned
+        contour has positive signed area.
+
+        Two overlapping convex contours have a union that is star-shaped
+        about any point inside their intersection, so its outline is the
+        set of vertices of either contour outside the other plus the edge
+        crossings, ordered by angle about such a point.
+
+        \sa convexIntersected()
+    */
+
+    ZQPolygonF ZQPolygonF::convexUnited(const ZQPolygonF &other) const noexcept
+    {
+        Points a, b;
+        const bool hasA = !isEmpty() && orientedCopy(pts.constData(), contourSize(0), a);
+        const bool hasB = !other.isEmpty() && orientedCopy(other.pts.constData(), other.contourSize(0), b);
+
+        ZQPolygonF result;
+        if (!hasA || !hasB) {
+            if (hasA)
+                result.addContour(a.constData(), a.size());
+            if (hasB)
+                result.addContour(b.constData(), b.size());
+            return result;
+        }
+
+        const QRectF ba = bounds(a), bb = bounds(b);
+        Points common;
+        if (boundsOverlap(ba, bb)) {
+            clipConvex(a, b, common);
+            removeDuplicates(common, tolerance(ba, bb));
+        }
+        if (common.size() < 3 || !(signedArea2(common.constData(), common.size()) > 0)) {
+            result.addContour(a.constData(), a.size());
+            result.addContour(b.constData(), b.size());
+            return result;
+        }
+
+        bool aInB = true, bInA = true;
+        for (const QPointF &p : a)
+            aInB = aInB && insideOrOn(b, p);
+        for (const QPointF &p : b)
+            bInA = bInA && insideOrOn(a, p);
+        if (bInA || aInB) {
+            const Points &outer = bInA ? a : b;
+            result.addContour(outer.constData(), outer.size());
+            return result;
+        }
+
+        // The vertex average of the convex intersection lies inside it.
+        QPointF c(0, 0);
+        for (const QPointF &p : common)
+            c += p;
+        c /= common.size();
+
+        Points outline;
+        for (const QPointF &p : a)
+            if (!strictlyInside(b, p))
+                outline.append(p);
+        for (const QPointF &p : b)
+            if (!strictlyInside(a, p))
+                outline.append(p);
+        appendCrossings(a, b, outline);
+
+        std::sort(outline.begin(), outline.end(), [&c](const QPointF &p, const QPointF &q) {
+            return std::atan2(p.y() - c.y(), p.x() - c.x()) < std::atan2(q.y() - c.y(), q.x() - c.x());
+        });
+        removeDuplicates(outline, tolerance(ba, bb));
+        result.addContour(outline.constData(), outline.size());
+        return result;
+    }
+
+    /*!
+        \fn QPainterPath ZQPolygonF::toPath() const
+
+        Returns a QPainterPath with one closed subpath per contour.
+    */
+
+    QPainterPath ZQPolygonF::toPath() const noexcept
+    {
+        QPainterPath path;
+        for (int c = 0; c < contourCount(); ++c) {
+            path.moveTo(pts[contourStart(c)]);
+            for (int i = contourStart(c) + 1; i < ends[c]; ++i)
+                path.lineTo(pts[i]);
+            path.closeSubpath();
+        }
+        return path;
+    }
+
+    /*!
+        \fn bool operator==(const ZQPolygonF &p1, const ZQPolygonF &p2)
+        \relates ZQPolygonF
+
+        Returns \c true if both polygons have the same contours with the
+        same points in the same order, otherwise returns \c false.
+    */
+
+    bool operator==(const ZQPolygonF &p1, const ZQPolygonF &p2) noexcept
+    {
+        if (p1.pts.size() != p2.pts.size() || p1.ends.size() != p2.ends.size())
+            return false;
+        for (int i = 0; i < p1.ends.size(); ++i)
+            if (p1.ends[i] != p2.ends[i])
+                return false;
+        for (int i = 0; i < p1.pts.size(); ++i)
+            if (p1.pts[i] != p2.pts[i])
+                return false;
+        return true;
+    }
+
+    /*!
+        \fn bool operator!=(const ZQPolygonF &p1, const ZQPolygonF &p2)
+        \relates ZQPolygonF
+
+        Returns \c true if the polygons differ, otherwise returns \c false.
+    */
+
+    bool operator!=(const ZQPolygonF &p1, const ZQPolygonF &p2) noexcept
+    {
+        return !(p1 == p2);
+    }
+
+}
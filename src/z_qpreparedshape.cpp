@@ -0,0 +1,554 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#include "z_qpreparedshape.h"
+#include "z_qgjk.h"
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+
+namespace z_qtshapes {
+
+    namespace {
+
+        // Same clockwise rotation about cn as ZQLine::toPath().
+        inline QLineF rotatedLine(const QPointF &p1, const QPointF &p2, const QPointF &cn, qreal angle) noexcept
+        {
+            if (angle == 0)
+                return QLineF(p1, p2);
+            const qreal rad = M_PI/180 * angle;
+            const qreal c = qCos(rad);
+            const qreal s = qSin(rad);
+            const QPointF d1 = p1 - cn;
+            const QPointF d2 = p2 - cn;
+            return QLineF(QPointF(cn.x() + c*d1.x() + s*d1.y(), cn.y() - s*d1.x() + c*d1.y()),
+                          QPointF(cn.x() + c*d2.x() + s*d2.y(), cn.y() - s*d2.x() + c*d2.y()));
+        }
+
+        inline qreal cross(const QPointF &a, const QPointF &b) noexcept
+        {
+            return a.x() * b.y() - a.y() * b.x();
+        }
+
+        inline qreal orientation(const QPointF &a, const QPointF &b, const QPointF &c) noexcept
+        {
+            return cross(b - a, c - a);
+        }
+
+        inline qreal pointSegmentDistance(const QPointF &p, const QPointF &a, const QPointF &b) noexcept
+        {
+            const QPointF ab = b - a;
+            const QPointF ap = p - a;
+            const qreal len2 = QPointF::dotProduct(ab, ab);
+            qreal t = len2 > 0 ? QPointF::dotProduct(ap, ab) / len2 : 0;
+            t = qMax(qreal(0), qMin(qreal(1), t));
+            const QPointF d = ap - ab * t;
+            return qSqrt(QPointF::dotProduct(d, d));
+        }
+
+        // Closed segment test; touching end points and colinear overlaps count.
+        bool segmentsIntersect(const QPointF &p1, const QPointF &p2, const QPointF &q1, const QPointF &q2) noexcept
+        {
+            const qreal d1 = orientation(q1, q2, p1);
+            const qreal d2 = orientation(q1, q2, p2);
+            const qreal d3 = orientation(p1, p2, q1);
+            const qreal d4 = orientation(p1, p2, q2);
+            if (((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0)))
+                return true;
+
+            auto onSegment = [](const QPointF &a, const QPointF &b, const QPointF &c) {
+                return qMin(a.x(), b.x()) <= c.x() && c.x() <= qMax(a.x(), b.x())
+                        && qMin(a.y(), b.y()) <= c.y() && c.y() <= qMax(a.y(), b.y());
+            };
+            return (d1 == 0 && onSegment(q1, q2, p1)) || (d2 == 0 && onSegment(q1, q2, p2))
+                    || (d3 == 0 && onSegment(p1, p2, q1)) || (d4 == 0 && onSegment(p1, p2, q2));
+        }
+
+        // Orientation test against every edge of a convex polygon of either
+        // winding. Points on the edge are inside. A polygon collapsed to a
+        // segment or a point only contains the points it covers.
+        bool convexContainsPoint(const QPointF *v, int n, const QPointF &p) noexcept
+        {
+            bool pos = false, neg = false;
+            for (int i = 0; i < n; ++i) {
+                const qreal o = orientation(v[i], v[(i + 1) % n], p);
+                pos = pos || o > 0;
+                neg = neg || o < 0;
+            }
+            if (pos || neg)
+                return !(pos && neg);
+
+            qreal x1 = v[0].x(), y1 = v[0].y(), x2 = x1, y2 = y1;
+            for (int i = 1; i < n; ++i) {
+                x1 = qMin(x1, v[i].x());
+                y1 = qMin(y1, v[i].y());
+                x2 = qMax(x2, v[i].x());
+                y2 = qMax(y2, v[i].y());
+            }
+            return x1 <= p.x() && p.x() <= x2 && y1 <= p.y() && p.y() <= y2;
+        }
+
+        /*
+         * Separating axis test between two closed convex polygons, using the
+         * edge normals of both as candidate axes. Touching counts as
+         * intersecting.
+         */
+        bool convexIntersectsConvex(const QPointF *a, int na, const QPointF *b, int nb) noexcept
+        {
+            for (int pass = 0; pass < 2; ++pass) {
+                const QPointF *v = pass ? b : a;
+                const int n = pass ? nb : na;
+                for (int i = 0; i < n; ++i) {
+                    const QPointF edge = v[(i + 1) % n] - v[i];
+                    const QPointF axis(-edge.y(), edge.x());
+                    qreal aMin = QPointF::dotProduct(a[0], axis), aMax = aMin;
+                    for (int j = 1; j < na; ++j) {
+                        const qreal d = QPointF::dotProduct(a[j], axis);
+                        aMin = qMin(aMin, d);
+                        aMax = qMax(aMax, d);
+                    }
+                    qreal bMin = QPointF::dotProduct(b[0], axis), bMax = bMin;
+                    for (int j = 1; j < nb; ++j) {
+                        const qreal d = QPointF::dotProduct(b[j], axis);
+                        bMin = qMin(bMin, d);
+                        bMax = qMax(bMax, d);
+                    }
+                    if (aMax < bMin || bMax < aMin)
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        bool segmentIntersectsConvex(const QLineF &s, const QPointF *v, int n) noexcept
+        {
+            if (convexContainsPoint(v, n, s.p1()))
+                return true;
+            for (int i = 0; i < n; ++i)
+                if (segmentsIntersect(s.p1(), s.p2(), v[i], v[(i + 1) % n]))
+                    return true;
+            return false;
+        }
+
+        // Maps p into the frame in which the ellipse is the unit circle.
+        inline QPointF toUnitFrame(const ZQPreparedEllipseF &e, const QPointF &p) noexcept
+        {
+            const qreal dx = p.x() - e.center().x();
+            const qreal dy = p.y() - e.center().y();
+            return QPointF((e.cosAngle() * dx - e.sinAngle() * dy) / e.radiusX(),
+                           (e.sinAngle() * dx + e.cosAngle() * dy) / e.radiusY());
+        }
+
+        /*
+         * The map to the unit frame is affine, so the polygon stays convex
+         * and the test reduces to a unit circle against a convex polygon.
+         */
+        bool ellipseIntersectsConvex(const ZQPreparedEllipseF &e, const QPointF *v, int n) noexcept
+        {
+            if (e.radiusX() <= 0 || e.radiusY() <= 0)
+                return false;
+
+            QPointF q[4];
+            for (int i = 0; i < n; ++i)
+                q[i] = toUnitFrame(e, v[i]);
+            for (int i = 0; i < n; ++i)
+                if (pointSegmentDistance(QPointF(0, 0), q[i], q[(i + 1) % n]) <= 1)
+                    return true;
+            return convexContainsPoint(q, n, QPointF(0, 0));
+        }
+
+        bool ellipseIntersectsSegment(const ZQPreparedEllipseF &e, const QLineF &s) noexcept
+        {
+            if (e.radiusX() <= 0 || e.radiusY() <= 0)
+                return false;
+            return pointSegmentDistance(QPointF(0, 0), toUnitFrame(e, s.p1()), toUnitFrame(e, s.p2())) <= 1;
+        }
+
+        // Root of the secular equation used by distancePointEllipse().
+        qreal ellipseRoot(qreal r0, qreal z0, qreal z1, qreal g) noexcept
+        {
+            const qreal n0 = r0 * z0;
+            qreal s0 = z1 - 1;
+            qreal s1 = g < 0 ? 0 : qSqrt(n0 * n0 + z1 * z1) - 1;
+            qreal s = 0;
+            for (int i = 0; i < 160; ++i) {
+                s = (s0 + s1) / 2;
+                if (s == s0 || s == s1)
+                    break;
+                const qreal ratio0 = n0 / (s + r0);
+                const qreal ratio1 = z1 / (s + 1);
+                g = ratio0 * ratio0 + ratio1 * ratio1 - 1;
+                if (g > 0)
+                    s0 = s;
+                else if (g < 0)
+                    s1 = s;
+                else
+                    break;
+            }
+            return s;
+        }
+
+        /*
+         * Distance from (y0, y1) in the first quadrant to the axis aligned
+         * ellipse with semi-axes e0 >= e1 > 0, found by bisection on the
+         * secular equation of the closest point.
+         */
+        qreal distancePointEllipse(qreal e0, qreal e1, qreal y0, qreal y1) noexcept
+        {
+            if (y1 > 0) {
+                if (y0 > 0) {
+                    const qreal z0 = y0 / e0;
+                    const qreal z1 = y1 / e1;
+                    const qreal g = z0 * z0 + z1 * z1 - 1;
+                    if (g == 0)
+                        return 0;
+                    const qreal r0 = (e0 / e1) * (e0 / e1);
+                    const qreal sbar = ellipseRoot(r0, z0, z1, g);
+                    const qreal x0 = r0 * y0 / (sbar + r0);
+                    const qreal x1 = y1 / (sbar + 1);
+                    return qSqrt((x0 - y0) * (x0 - y0) + (x1 - y1) * (x1 - y1));
+                }
+                return qAbs(y1 - e1);
+            }
+
+            const qreal numer0 = e0 * y0;
+            const qreal denom0 = e0 * e0 - e1 * e1;
+            if (numer0 < denom0) {
+                const qreal xde0 = numer0 / denom0;
+                const qreal x0 = e0 * xde0;
+                const qreal x1 = e1 * qSqrt(1 - xde0 * xde0);
+                return qSqrt((x0 - y0) * (x0 - y0) + x1 * x1);
+            }
+            return qAbs(y0 - e0);
+        }
+
+        // Writes the vertices of a rectangle or triangle to v and returns
+        // their count, or 0 for any other shape.
+        inline int polygon(const ZQPreparedShape &s, QPointF v[4]) noexcept
+        {
+            if (s.type() == ZQPreparedShape::RectShape) {
+                v[0] = s.rect().topRight();
+                v[1] = s.rect().bottomRight();
+                v[2] = s.rect().bottomLeft();
+                v[3] = s.rect().topLeft();
+                return 4;
+            }
+            if (s.type() == ZQPreparedShape::TriShape) {
+                v[0] = s.tri().first();
+                v[1] = s.tri().second();
+                v[2] = s.tri().third();
+                return 3;
+            }
+            return 0;
+        }
+
+    }
+
+    /*!
+        \class ZQPreparedShape
+        \inmodule Zgeometry
+        \ingroup painting
+        \reentrant
+
+        \brief The ZQPreparedShape class holds any prepared ZQ shape behind
+        a single type.
+
+        A ZQPreparedShape wraps a ZQPreparedRectF, ZQPreparedTriF,
+        ZQPreparedEllipseF or a rotated line segment, and can be
+        constructed implicitly from any of the ZQ shape classes. It is the
+        element type of the spatial containers, which store shapes of
+        different types side by side.
+
+        intersects() dispatches to the prepared predicate of the shape
+        class when both shapes have the same type, and to an exact test
+        for the mixed pair otherwise.
+    */
+
+    /*!
+        \enum ZQPreparedShape::ShapeType
+
+        This enum describes the kind of the wrapped shape.
+
+        \value NoShape      No shape; a default constructed object.
+        \value RectShape    A ZQRect or ZQRectF, see rect().
+        \value TriShape     A ZQTri or ZQTriF, see tri().
+        \value EllipseShape A ZQEllipse or ZQEllipseF, see ellipse().
+        \value LineShape    A ZQLine or ZQLineF, see line().
+    */
+
+    /*!
+        \fn ZQPreparedShape::ZQPreparedShape(const ZQRectF &rect, qreal cosAngle, qreal sinAngle)
+
+        Constructs a prepared shape from \a rect, taking \a cosAngle and
+        \a sinAngle as the cosine and sine of its angle instead of
+        evaluating them. The shape arrays use this with their cached
+        columns.
+    */
+
+    ZQPreparedShape::ZQPreparedShape(const ZQRectF &rect, qreal cosAngle, qreal sinAngle) noexcept
+        : ty(RectShape), r(rect.x(), rect.y(), rect.x() + rect.width(), rect.y() + rect.height(),
+                           rect.center(), rect.angle(), cosAngle, sinAngle)
+    {
+    }
+
+    /*!
+        \fn ZQPreparedShape::ZQPreparedShape(const ZQTriF &tri, qreal cosAngle, qreal sinAngle)
+
+        Constructs a prepared shape from \a tri with the cached \a cosAngle
+        and \a sinAngle of its angle.
+    */
+
+    ZQPreparedShape::ZQPreparedShape(const ZQTriF &tri, qreal cosAngle, qreal sinAngle) noexcept
+        : ty(TriShape), t(tri.first(), tri.second(), tri.third(), tri.center(), tri.angle(), cosAngle, sinAngle)
+    {
+    }
+
+    /*!
+        \fn ZQPreparedShape::ZQPreparedShape(const ZQEllipseF &ellipse, qreal cosAngle, qreal sinAngle)
+
+        Constructs a prepared shape from \a ellipse with the cached
+        \a cosAngle and \a sinAngle of its angle.
+    */
+
+    ZQPreparedShape::ZQPreparedShape(const ZQEllipseF &ellipse, qreal cosAngle, qreal sinAngle) noexcept
+        : ty(EllipseShape), e(ellipse.center(), ellipse.width() / 2, ellipse.height() / 2, ellipse.angle(),
+                              cosAngle, sinAngle)
+    {
+    }
+
+    /*!
+        \fn ZQPreparedShape::ZQPreparedShape(const ZQLineF &line)
+
+        Constructs a prepared shape from \a line, rotated about its center
+        by its angle.
+    */
+
+    ZQPreparedShape::ZQPreparedShape(const ZQLine &line) noexcept
+        : ty(LineShape), l(rotatedLine(QPointF(line.p1()), QPointF(line.p2()), QPointF(line.center()), line.angle()))
+    {
+    }
+
+    ZQPreparedShape::ZQPreparedShape(const ZQLineF &line) noexcept
+        : ty(LineShape), l(rotatedLine(line.p1(), line.p2(), line.center(), line.angle()))
+    {
+    }
+
+    /*!
+        \fn QRectF ZQPreparedShape::boundingRect() const
+
+        Returns the axis aligned bounding rectangle of the rotated shape.
+    */
+
+    QRectF ZQPreparedShape::boundingRect() const noexcept
+    {
+        switch (ty) {
+        case RectShape:
+            return r.boundingRect();
+        case TriShape:
+            return t.boundingRect();
+        case EllipseShape:
+            return e.boundingRect();
+        case LineShape:
+            return QRectF(QPointF(qMin(l.x1(), l.x2()), qMin(l.y1(), l.y2())),
+                          QPointF(qMax(l.x1(), l.x2()), qMax(l.y1(), l.y2())));
+        default:
+            return QRectF();
+        }
+    }
+
+    /*!
+        \fn bool ZQPreparedShape::contains(const QPointF &point) const
+
+        Returns \c true if the given \a point is inside or on the edge of
+        the shape, otherwise returns \c false. A line contains only the
+        points that lie exactly on it.
+    */
+
+    bool ZQPreparedShape::contains(const QPointF &p) const noexcept
+    {
+        switch (ty) {
+        case RectShape:
+            return r.contains(p);
+        case TriShape:
+            return t.contains(p);
+        case EllipseShape:
+            return e.contains(p);
+        case LineShape:
+            return orientation(l.p1(), l.p2(), p) == 0
+                    && p.x() >= qMin(l.x1(), l.x2()) && p.x() <= qMax(l.x1(), l.x2())
+                    && p.y() >= qMin(l.y1(), l.y2()) && p.y() <= qMax(l.y1(), l.y2());
+        default:
+            return false;
+        }
+    }
+
+    /*!
+        \fn bool ZQPreparedShape::intersects(const QRectF &rectangle) const
+
+        Returns \c true if the shape touches or overlaps the axis aligned
+        \a rectangle, otherwise returns \c false.
+    */
+
+    bool ZQPreparedShape::intersects(const QRectF &rect) const noexcept
+    {
+        const qreal x1 = qMin(rect.left(), rect.right()), x2 = qMax(rect.left(), rect.right());
+        const qreal y1 = qMin(rect.top(), rect.bottom()), y2 = qMax(rect.top(), rect.bottom());
+        const QPointF box[4] = { QPointF(x1, y1), QPointF(x2, y1), QPointF(x2, y2), QPointF(x1, y2) };
+
+        QPointF v[4];
+        switch (ty) {
+        case RectShape:
+        case TriShape:
+            return convexIntersectsConvex(v, polygon(*this, v), box, 4);
+        case EllipseShape:
+            return ellipseIntersectsConvex(e, box, 4);
+        case LineShape:
+            return segmentIntersectsConvex(l, box, 4);
+        default:
+            return false;
+        }
+    }
+
+    /*!
+        \fn bool ZQPreparedShape::intersects(const ZQPreparedShape &shape) const
+
+        Returns \c true if this shape and the given \a shape intersect,
+        otherwise returns \c false. Shapes that touch intersect, whatever
+        their types, as set out by the contact rule in z_qpreparedshape.h.
+
+        Rectangles and triangles are tested with a separating axis test,
+        ellipses by mapping the other shape into the frame in which the
+        ellipse is the unit circle, and lines by clipping against the edges
+        of the other shape. Two shapes of the same type use that type's own
+        intersects(), which follows the same rule.
+    */
+
+    bool ZQPreparedShape::intersects(const ZQPreparedShape &s) const noexcept
+    {
+        if (ty == NoShape || s.ty == NoShape)
+            return false;
+
+        if (ty == s.ty) {
+            switch (ty) {
+            case RectShape:
+                return r.intersects(s.r);
+            case TriShape:
+                return t.intersects(s.t);
+            case EllipseShape:
+                return e.intersects(s.e);
+            default:
+                return segmentsIntersect(l.p1(), l.p2(), s.l.p1(), s.l.p2());
+            }
+        }
+
+        // Order the pair so that ellipses come first, then lines.
+        if (s.ty == EllipseShape || (s.ty == LineShape && ty != EllipseShape))
+            return s.intersects(*this);
+
+        QPointF v[4];
+        const int n = polygon(s, v);
+        switch (ty) {
+        case EllipseShape:
+            return s.ty == LineShape ? ellipseIntersectsSegment(e, s.l) : ellipseIntersectsConvex(e, v, n);
+        case LineShape:
+            return segmentIntersectsConvex(l, v, n);
+        default: {
+            QPointF w[4];
+            return convexIntersectsConvex(w, polygon(*this, w), v, n);
+        }
+        }
+    }
+
+    /*!
+        \fn qreal ZQPreparedShape::distance(const QPointF &point) const
+
+        Returns the Euclidean distance from \a point to the shape, or zero
+        if the point is inside it. Returns infinity for a null shape.
+    */
+
+    qreal ZQPreparedShape::distance(const QPointF &p) const noexcept
+    {
+        switch (ty) {
+        case RectShape: {
+            const qreal dx = p.x() - r.center().x();
+            const qreal dy = p.y() - r.center().y();
+            const qreal u = qMax(qAbs(dx * r.cosAngle() - dy * r.sinAngle()) - r.halfWidth(), qreal(0));
+            const qreal v = qMax(qAbs(dx * r.sinAngle() + dy * r.cosAngle()) - r.halfHeight(), qreal(0));
+            return qSqrt(u * u + v * v);
+        }
+        case TriShape:
+            if (t.contains(p))
+                return 0;
+            return qMin(pointSegmentDistance(p, t.first(), t.second()),
+                        qMin(pointSegmentDistance(p, t.second(), t.third()),
+                             pointSegmentDistance(p, t.third(), t.first())));
+        case EllipseShape: {
+            const qreal dx = p.x() - e.center().x();
+            const qreal dy = p.y() - e.center().y();
+            qreal lx = qAbs(e.cosAngle() * dx - e.sinAngle() * dy);
+            qreal ly = qAbs(e.sinAngle() * dx + e.cosAngle() * dy);
+            qreal e0 = e.radiusX();
+            qreal e1 = e.radiusY();
+            if (e0 < e1) {
+                std::swap(e0, e1);
+                std::swap(lx, ly);
+            }
+            if (e1 <= 0)
+                return pointSegmentDistance(QPointF(lx, ly), QPointF(-e0, 0), QPointF(e0, 0));
+            if ((lx / e0) * (lx / e0) + (ly / e1) * (ly / e1) <= 1)
+                return 0;
+            return distancePointEllipse(e0, e1, lx, ly);
+        }
+        case LineShape:
+            return pointSegmentDistance(p, l.p1(), l.p2());
+        default:
+            return std::numeric_limits<qreal>::infinity();
+        }
+    }
+
+    /*!
+        \fn qreal ZQPreparedShape::distance(const ZQPreparedShape &shape) const
+        \overload
+
+        Returns the Euclidean distance between this shape and \a shape, or
+        zero if they overlap or touch. Returns infinity if either shape is
+        null.
+
+        \sa closestPoints()
+    */
+
+    qreal ZQPreparedShape::distance(const ZQPreparedShape &s) const noexcept
+    {
+        if (isNull() || s.isNull())
+            return std::numeric_limits<qreal>::infinity();
+        return closestPoints(*this, s).distance;
+    }
+
+    /*!
+        \fn QPainterPath ZQPreparedShape::toPath() const
+
+        Converts the shape into a QPainterPath. A null shape gives an empty
+        path.
+    */
+
+    QPainterPath ZQPreparedShape::toPath() const noexcept
+    {
+        switch (ty) {
+        case RectShape:
+            return r.toPath();
+        case TriShape:
+            return t.toPath();
+        case EllipseShape:
+            return e.toPath();
+        case LineShape: {
+            QPainterPath path;
+            path.moveTo(l.p1());
+            path.lineTo(l.p2());
+            return path;
+        }
+        default:
+            return QPainterPath();
+        }
+    }
+
+}
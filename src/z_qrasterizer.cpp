@@ -0,0 +1,608 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#include "z_qrasterizer.h"
+#include "z_qparallel.h"
+#include <QAtomicInt>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+
+namespace z_qtshapes {
+
+    namespace {
+
+        // A shape reduced to what the scanline fill needs. A polygon is the
+        // intersection of half planes, solved for x ahead of time: on the
+        // line through y the shape lies right of every lk*y + lm, left of
+        // every rk*y + rm, and needs fb*y + fc >= 0 for its horizontal
+        // edges. An ellipse is qa*dx*dx + qb*dx*dy + qc*dy*dy <= 1 about its
+        // center. Pixels outside [x1, x2) x [y1, y2) are never covered.
+        struct RasterShape {
+            bool ellipse;
+            int leftCount, rightCount, flatCount;
+            qreal lk[4], lm[4], rk[4], rm[4], fb[4], fc[4];
+            qreal cx, cy, qa, qb, qc;
+            int x1, y1, x2, y2;
+        };
+
+        void setEmpty(RasterShape &s) noexcept
+        {
+            s.x1 = s.y1 = s.x2 = s.y2 = 0;
+        }
+
+        void setBounds(RasterShape &s, qreal l, qreal t, qreal r, qreal b, int width, int height) noexcept
+        {
+            s.x1 = int(qBound(qreal(0), std::floor(l), qreal(width)));
+            s.y1 = int(qBound(qreal(0), std::floor(t), qreal(height)));
+            s.x2 = int(qBound(qreal(0), std::ceil(r), qreal(width)));
+            s.y2 = int(qBound(qreal(0), std::ceil(b), qreal(height)));
+        }
+
+        void setPolygon(RasterShape &s, const QPointF *p, int n, int width, int height) noexcept
+        {
+            qreal area = 0;
+            qreal l = p[0].x(), t = p[0].y(), r = l, b = t;
+            for (int i = 0; i < n; ++i) {
+                const QPointF &q = p[(i + 1) % n];
+                area += p[i].x() * q.y() - q.x() * p[i].y();
+                l = qMin(l, q.x());
+                t = qMin(t, q.y());
+                r = qMax(r, q.x());
+                b = qMax(b, q.y());
+            }
+            if (area == 0 || qIsNaN(area)) {
+                setEmpty(s);
+                return;
+            }
+
+            // Orient every edge so that the interior is on the positive side
+            // of a*x + b*y + c, then sort it by the sign of a.
+            const qreal sg = area > 0 ? 1 : -1;
+            s.ellipse = false;
+            s.leftCount = s.rightCount = s.flatCount = 0;
+            for (int i = 0; i < n; ++i) {
+                const QPointF &q = p[(i + 1) % n];
+                const qreal ex = q.x() - p[i].x(), ey = q.y() - p[i].y();
+                const qreal a = -sg * ey, b = sg * ex, c = sg * (ey * p[i].x() - ex * p[i].y());
+                if (a > 0) {
+                    s.lk[s.leftCount] = -b / a;
+                    s.lm[s.leftCount++] = -c / a;
+                } else if (a < 0) {
+                    s.rk[s.rightCount] = -b / a;
+                    s.rm[s.rightCount++] = -c / a;
+                } else {
+                    s.fb[s.flatCount] = b;
+                    s.fc[s.flatCount++] = c;
+                }
+            }
+            setBounds(s, l, t, r, b, width, height);
+        }
+
+        void setEllipse(RasterShape &s, const ZQPreparedEllipseF &e, int width, int height) noexcept
+        {
+            if (e.radiusX() <= 0 || e.radiusY() <= 0) {
+                setEmpty(s);
+                return;
+            }
+
+            // The inverse of the clockwise rotation used by toPath(), written
+            // out as a quadratic form in the offset from the center.
+            const qreal c = e.cosAngle(), sn = e.sinAngle();
+            const qreal irx = 1 / (e.radiusX() * e.radiusX()), iry = 1 / (e.radiusY() * e.radiusY());
+            s.ellipse = true;
+            s.cx = e.center().x();
+            s.cy = e.center().y();
+            s.qa = c*c*irx + sn*sn*iry;
+            s.qb = 2*c*sn*(iry - irx);
+            s.qc = sn*sn*irx + c*c*iry;
+            const QRectF box = e.boundingRect();
+            setBounds(s, box.left(), box.top(), box.right(), box.bottom(), width, height);
+        }
+
+        void setShape(RasterShape &s, const ZQPreparedShape &shape, qreal lineWidth, int width, int height) noexcept
+        {
+            switch (shape.type()) {
+            case ZQPreparedShape::RectShape: {
+                const ZQPreparedRectF &r = shape.rect();
+                const QPointF p[4] = { r.topRight(), r.bottomRight(), r.bottomLeft(), r.topLeft() };
+                setPolygon(s, p, 4, width, height);
+                break;
+            }
+            case ZQPreparedShape::TriShape: {
+                const ZQPreparedTriF &t = shape.tri();
+                const QPointF p[3] = { t.first(), t.second(), t.third() };
+                setPolygon(s, p, 3, width, height);
+                break;
+            }
+            case ZQPreparedShape::EllipseShape:
+                setEllipse(s, shape.ellipse(), width, height);
+                break;
+            case ZQPreparedShape::LineShape: {
+                // The stroke with flat caps, as ZQLineF::tessellateStroke()
+                // builds it.
+                const QLineF &l = shape.line();
+                const QPointF d = l.p2() - l.p1();
+                const qreal length = qSqrt(d.x() * d.x() + d.y() * d.y());
+                if (length == 0 || lineWidth == 0) {
+                    setEmpty(s);
+                    break;
+                }
+                const QPointF n = QPointF(-d.y(), d.x()) * (lineWidth / 2 / length);
+                const QPointF p[4] = { l.p1() - n, l.p2() - n, l.p2() + n, l.p1() + n };
+                setPolygon(s, p, 4, width, height);
+                break;
+            }
+            default:
+                setEmpty(s);
+                break;
+            }
+        }
+
+        // The interval [*left, *right] of x covered by the shape on the
+        // horizontal line through y. Returns false if the line misses it.
+        bool span(const RasterShape &s, qreal y, qreal *left, qreal *right) noexcept
+        {
+            if (s.ellipse) {
+                const qreal dy = y - s.cy;
+                const qreal b = s.qb * dy;
+                const qreal disc = b*b - 4*s.qa*(s.qc*dy*dy - 1);
+                if (disc < 0)
+                    return false;
+                const qreal root = qSqrt(disc);
+                *left = s.cx + (-b - root) / (2*s.qa);
+                *right = s.cx + (-b + root) / (2*s.qa);
+                return true;
+            }
+
+            for (int i = 0; i < s.flatCount; ++i) {
+                if (s.fb[i] * y + s.fc[i] < 0)
+                    return false;
+            }
+            // A polygon of nonzero area always has edges on both sides.
+            qreal lo = s.lk[0] * y + s.lm[0];
+            for (int i = 1; i < s.leftCount; ++i)
+                lo = qMax(lo, s.lk[i] * y + s.lm[i]);
+            qreal hi = s.rk[0] * y + s.rm[0];
+            for (int i = 1; i < s.rightCount; ++i)
+                hi = qMin(hi, s.rk[i] * y + s.rm[i]);
+            *left = lo;
+            *right = hi;
+            return lo <= hi;
+        }
+
+        // The half open range [*first, *last) of sample columns whose centers
+        // (j + 0.5) / samples lie in [left, right], clamped to [lo, hi).
+        bool sampleRange(qreal left, qreal right, int samples, int lo, int hi, int *first, int *last) noexcept
+        {
+            const qreal f = std::ceil(qMax(left * samples - qreal(0.5), qreal(lo)));
+            const qreal l = std::floor(qMin(right * samples - qreal(0.5), qreal(hi - 1))) + 1;
+            if (!(f < l))
+                return false;
+            *first = int(f);
+            *last = int(l);
+            return true;
+        }
+
+        // Sets the bits of sample row r for sample columns [first, last) in
+        // the masks of a row of pixels with samples x samples samples each.
+        void setSamples(quint16 *mask, int samples, int r, int first, int last) noexcept
+        {
+            if (first >= last)
+                return;
+            const int shift = r * samples;
+            const int pf = first / samples, pl = (last - 1) / samples;
+            const quint16 full = quint16(((1 << samples) - 1) << shift);
+            if (pf == pl) {
+                mask[pf] |= quint16(((1 << (last - first)) - 1) << (shift + first % samples));
+                return;
+            }
+            mask[pf] |= quint16((full << (first % samples)) & full);
+            for (int px = pf + 1; px < pl; ++px)
+                mask[px] |= full;
+            mask[pl] |= quint16(((1 << ((last - 1) % samples + 1)) - 1) << shift);
+        }
+
+        const int setupChunk = 1024;
+
+        // The shapes prepared for filling and binned into tiles: the shapes
+        // overlapping tile t are bins[binStart[t]] to bins[binStart[t + 1]],
+        // in drawing order.
+        struct Frame {
+            std::vector<RasterShape> shapes;
+            std::vector<int> binStart;
+            std::vector<int> bins;
+            int tilesX;
+            int tilesY;
+        };
+
+        bool overlapsTile(const ZQPreparedShape &shape, const RasterShape &s, int tx, int ty, int tile) noexcept
+        {
+            // Only worth testing when the shape spans several tiles both
+            // ways; a line's stroke is wider than the segment intersects()
+            // sees, so it is binned by its bounds.
+            if (shape.type() == ZQPreparedShape::LineShape
+                    || s.x1 / tile == (s.x2 - 1) / tile || s.y1 / tile == (s.y2 - 1) / tile)
+                return true;
+            return shape.intersects(QRectF(tx * tile, ty * tile, tile, tile));
+        }
+
+        void buildFrame(Frame &frame, const ZQPreparedShape *shapes, int count, qreal lineWidth,
+                int width, int height, int tile, QThreadPool *pool)
+        {
+            frame.shapes.resize(count);
+            QAtomicInt next(0);
+            auto setup = [&]() {
+                int chunk;
+                while ((chunk = next.fetchAndAddRelaxed(1)) * setupChunk < count) {
+                    const int end = qMin(count, (chunk + 1) * setupChunk);
+                    for (int i = chunk * setupChunk; i < end; ++i)
+                        setShape(frame.shapes[i], shapes[i], lineWidth, width, height);
+                }
+            };
+            runOnPool(pool, (count + setupChunk - 1) / setupChunk, setup);
+
+            frame.tilesX = (width + tile - 1) / tile;
+            frame.tilesY = (height + tile - 1) / tile;
+            frame.binStart.assign(frame.tilesX * frame.tilesY + 1, 0);
+
+            // Count the shapes per tile, turn the counts into offsets, then
+            // fill the bins in shape order so that later shapes stay on top.
+            for (int pass = 0; pass < 2; ++pass) {
+                for (int i = 0; i < count; ++i) {
+                    const RasterShape &s = frame.shapes[i];
+                    if (s.x1 >= s.x2 || s.y1 >= s.y2)
+                        continue;
+                    for (int ty = s.y1 / tile; ty <= (s.y2 - 1) / tile; ++ty) {
+                        for (int tx = s.x1 / tile; tx <= (s.x2 - 1) / tile; ++tx) {
+                            if (!overlapsTile(shapes[i], s, tx, ty, tile))
+                                continue;
+                            const int t = ty * frame.tilesX + tx;
+                            if (pass == 0)
+                                ++frame.binStart[t + 1];
+                            else
+                                frame.bins[frame.binStart[t]++] = i;
+                        }
+                    }
+                }
+                if (pass == 0) {
+                    for (int t = 0; t < frame.tilesX * frame.tilesY; ++t)
+                        frame.binStart[t + 1] += frame.binStart[t];
+                    frame.bins.resize(frame.binStart.back());
+                } else {
+                    // The fill advanced every start to the next tile's start.
+                    for (int t = frame.tilesX * frame.tilesY; t > 0; --t)
+                        frame.binStart[t] = frame.binStart[t - 1];
+                    frame.binStart[0] = 0;
+                }
+            }
+        }
+
+        template <typename FillTile>
+        void fillTiles(const Frame &frame, QThreadPool *pool, FillTile &fillTile)
+        {
+            const int tiles = frame.tilesX * frame.tilesY;
+            QAtomicInt next(0);
+            auto work = [&]() {
+                typename FillTile::Scratch scratch;
+                int t;
+                while ((t = next.fetchAndAddRelaxed(1)) < tiles)
+                    fillTile(t % frame.tilesX, t / frame.tilesX,
+                             frame.bins.data() + frame.binStart[t], frame.binStart[t + 1] - frame.binStart[t], scratch);
+            };
+            runOnPool(pool, pool ? qMin(tiles, pool->maxThreadCount()) : 1, work);
+        }
+
+        /*
+         * Coverage of the union of the shapes with samples x samples points
+         * per pixel. Each pixel keeps one bit per sample in a tile sized mask,
+         * so overlapping shapes are not counted twice.
+         */
+        struct CoverageFill {
+            struct Scratch {
+                std::vector<quint16> mask;
+            };
+
+            const Frame &frame;
+            quint8 *coverage;
+            int width, height, bytesPerLine, tile, samples;
+
+            void operator()(int tx, int ty, const int *bin, int n, Scratch &scratch) const
+            {
+                const int x0 = tx * tile, y0 = ty * tile;
+                const int w = qMin(tile, width - x0), h = qMin(tile, height - y0);
+                const int S = samples;
+                scratch.mask.assign(w * h, 0);
+
+                for (int k = 0; k < n; ++k) {
+                    const RasterShape &s = frame.shapes[bin[k]];
+                    const int ya = qMax(s.y1, y0), yb = qMin(s.y2, y0 + h);
+                    const int xa = qMax(s.x1, x0), xb = qMin(s.x2, x0 + w);
+                    for (int py = ya; py < yb; ++py) {
+                        quint16 *m = scratch.mask.data() + (py - y0) * w;
+                        int first[4], last[4];
+                        int fullFirst = xa, fullLast = xb;
+                        for (int r = 0; r < S; ++r) {
+                            qreal left, right;
+                            if (!span(s, py + (r + qreal(0.5)) / S, &left, &right)
+                                    || !sampleRange(left, right, S, xa * S, xb * S, &first[r], &last[r])) {
+                                first[r] = last[r] = 0;
+                                fullLast = fullFirst;
+                                continue;
+                            }
+                            fullFirst = qMax(fullFirst, (first[r] + S - 1) / S);
+                            fullLast = qMin(fullLast, last[r] / S);
+                        }
+
+                        // Pixels covered by every sample row get all their
+                        // bits at once; only the ends are set row by row.
+                        if (fullFirst < fullLast) {
+                            const quint16 all = quint16((1 << (S * S)) - 1);
+                            for (int px = fullFirst; px < fullLast; ++px)
+                                m[px - x0] = all;
+                        } else {
+                            fullFirst = fullLast = xb;
+                        }
+                        for (int r = 0; r < S; ++r) {
+                            setSamples(m, S, r, first[r] - x0 * S, qMin(last[r], fullFirst * S) - x0 * S);
+                            setSamples(m, S, r, qMax(first[r], fullLast * S) - x0 * S, last[r] - x0 * S);
+                        }
+                    }
+                }
+
+                quint8 level[17];
+                const int total = S * S;
+                for (int i = 0; i <= total; ++i)
+                    level[i] = quint8((i * 255 + total / 2) / total);
+                for (int y = 0; y < h; ++y) {
+                    quint8 *out = coverage + qptrdiff(y0 + y) * bytesPerLine + x0;
+                    const quint16 *m = scratch.mask.data() + y * w;
+                    for (int x = 0; x < w; ++x)
+                        out[x] = level[qPopulationCount(m[x])];
+                }
+            }
+        };
+
+        /*
+         * Id of the last shape whose interior holds the pixel center, written
+         * straight into the output; tiles never share pixels.
+         */
+        struct IdFill {
+            struct Scratch {};
+
+            const Frame &frame;
+            quint32 *ids;
+            int width, height, bytesPerLine, tile;
+
+            void operator()(int tx, int ty, const int *bin, int n, Scratch &) const
+            {
+                const int x0 = tx * tile, y0 = ty * tile;
+                const int w = qMin(tile, width - x0), h = qMin(tile, height - y0);
+                for (int y = y0; y < y0 + h; ++y)
+                    std::memset(row(y) + x0, 0, w * sizeof(quint32));
+
+                for (int k = 0; k < n; ++k) {
+                    const RasterShape &s = frame.shapes[bin[k]];
+                    const quint32 id = quint32(bin[k]) + 1;
+                    const int ya = qMax(s.y1, y0), yb = qMin(s.y2, y0 + h);
+                    const int xa = qMax(s.x1, x0), xb = qMin(s.x2, x0 + w);
+                    for (int py = ya; py < yb; ++py) {
+                        qreal left, right;
+                        int first, last;
+                        if (!span(s, py + qreal(0.5), &left, &right)
+                                || !sampleRange(left, right, 1, xa, xb, &first, &last))
+                            continue;
+                        quint32 *out = row(py);
+                        for (int px = first; px < last; ++px)
+                            out[px] = id;
+                    }
+                }
+            }
+
+            quint32 *row(int y) const noexcept
+            {
+                return reinterpret_cast<quint32 *>(reinterpret_cast<uchar *>(ids) + qptrdiff(y) * bytesPerLine);
+            }
+        };
+
+    }
+
+
+    /*!
+        \class ZQRasterizer
+        \inmodule Zgeometry
+        \ingroup painting
+
+        \brief The ZQRasterizer class fills a collection of mixed shapes
+        into an 8-bit coverage buffer or a 32-bit id buffer without a GPU
+        or QPainter.
+
+        Shapes are given in pixel coordinates, with pixel (x, y) covering
+        the square from (x, y) to (x + 1, y + 1). Every shape is reduced to
+        its edge functions, or for an ellipse to the implicit equation of
+        its rotated outline, and binned into square tiles of tileSize()
+        pixels by its bounding rectangle; shapes that span several tiles
+        are only binned into the tiles their outline overlaps. The tiles
+        are then filled in parallel on threadPool(), one horizontal span per
+        shape and sample row, so each output pixel is written by exactly
+        one thread.
+
+        Lines are stroked with lineWidth() and flat caps, as ZQVertexBatch
+        strokes them.
+
+        The caller's thread always takes part in the fill, and further
+        threads are only taken from the pool if they are idle, so it is safe
+        to rasterize from inside a task running on the same pool.
+    */
+
+    /*!
+        \fn ZQRasterizer::ZQRasterizer()
+
+        Constructs a rasterizer with 64 pixel tiles, 4 x 4 samples per
+        pixel, a line width of 1 and the global thread pool.
+    */
+
+    ZQRasterizer::ZQRasterizer() noexcept : tile(64), ss(4), lw(1), tp(QThreadPool::globalInstance())
+    {
+    }
+
+    /*!
+        \fn void ZQRasterizer::setTileSize(int size)
+
+        Sets the width and height of a tile in pixels to \a size, which is
+        at least 1.
+
+        \sa tileSize()
+    */
+
+    void ZQRasterizer::setTileSize(int size) noexcept
+    {
+        tile = qMax(1, size);
+    }
+
+    /*!
+        \fn int ZQRasterizer::tileSize() const
+
+        Returns the width and height of a tile in pixels.
+
+        \sa setTileSize()
+    */
+
+    /*!
+        \fn void ZQRasterizer::setSamples(int samples)
+
+        Sets the number of samples per pixel along each axis used by
+        rasterizeCoverage() to \a samples, clamped to between 1 and 4. One
+        sample gives aliased coverage of 0 or 255.
+
+        \sa samples()
+    */
+
+    void ZQRasterizer::setSamples(int samples) noexcept
+    {
+        ss = qBound(1, samples, 4);
+    }
+
+    /*!
+        \fn int ZQRasterizer::samples() const
+
+        Returns the number of coverage samples per pixel along each axis.
+
+        \sa setSamples()
+    */
+
+    /*!
+        \fn void ZQRasterizer::setLineWidth(qreal width)
+
+        Sets the width of the stroke used for lines to \a width.
+
+        \sa lineWidth()
+    */
+
+    void ZQRasterizer::setLineWidth(qreal width) noexcept
+    {
+        lw = qAbs(width);
+    }
+
+    /*!
+        \fn qreal ZQRasterizer::lineWidth() const
+
+        Returns the width of the stroke used for lines.
+
+        \sa setLineWidth()
+    */
+
+    /*!
+        \fn void ZQRasterizer::setThreadPool(QThreadPool *pool)
+
+        Sets the thread pool the tiles are filled on to \a pool. With a
+        null \a pool everything runs on the calling thread.
+
+        \sa threadPool()
+    */
+
+    /*!
+        \fn QThreadPool *ZQRasterizer::threadPool() const
+
+        Returns the thread pool the tiles are filled on.
+
+        \sa setThreadPool()
+    */
+
+    /*!
+        \fn void ZQRasterizer::rasterizeCoverage(const ZQPreparedShape *shapes, int count, quint8 *coverage, int width, int height, int bytesPerLine) const
+
+        Writes the coverage of the union of the \a count \a shapes into
+        \a coverage, a \a width by \a height buffer of one byte per pixel
+        whose rows are \a bytesPerLine bytes apart. Each byte is the
+        fraction of the pixel's samples() x samples() sample points inside
+        some shape, scaled to 0 to 255. Every pixel of the buffer is
+        written.
+    */
+
+    void ZQRasterizer::rasterizeCoverage(const ZQPreparedShape *shapes, int count,
+            quint8 *coverage, int width, int height, int bytesPerLine) const
+    {
+        if (width <= 0 || height <= 0)
+            return;
+        Frame frame;
+        buildFrame(frame, shapes, count, lw, width, height, tile, tp);
+        CoverageFill fill{ frame, coverage, width, height, bytesPerLine, tile, ss };
+        fillTiles(frame, tp, fill);
+    }
+
+    /*!
+        \fn void ZQRasterizer::rasterizeIds(const ZQPreparedShape *shapes, int count, quint32 *ids, int width, int height, int bytesPerLine) const
+
+        Writes the id of the topmost of the \a count \a shapes at the center
+        of each pixel into \a ids, a \a width by \a height buffer of 32-bit
+        values whose rows are \a bytesPerLine bytes apart. The id of
+        shapes[i] is i + 1, and later shapes are on top of earlier ones.
+        Pixels whose center is in no shape are set to 0.
+    */
+
+    void ZQRasterizer::rasterizeIds(const ZQPreparedShape *shapes, int count,
+            quint32 *ids, int width, int height, int bytesPerLine) const
+    {
+        if (width <= 0 || height <= 0)
+            return;
+        Frame frame;
+        buildFrame(frame, shapes, count, lw, width, height, tile, tp);
+        IdFill fill{ frame, ids, width, height, bytesPerLine, tile };
+        fillTiles(frame, tp, fill);
+    }
+
+    /*!
+        \fn bool ZQRasterizer::rasterize(const QVector<ZQPreparedShape> &shapes, QImage &image) const
+
+        Rasterizes \a shapes into \a image, choosing the output by its
+        format: QImage::Format_Grayscale8 and QImage::Format_Alpha8 receive
+        coverage as rasterizeCoverage() writes it, while
+        QImage::Format_RGB32, QImage::Format_ARGB32 and
+        QImage::Format_ARGB32_Premultiplied receive ids as rasterizeIds()
+        writes them. Returns \c false, leaving \a image untouched, for a
+        null image or any other format.
+    */
+
+    bool ZQRasterizer::rasterize(const QVector<ZQPreparedShape> &shapes, QImage &image) const
+    {
+        if (image.isNull())
+            return false;
+        switch (image.format()) {
+        case QImage::Format_Grayscale8:
+        case QImage::Format_Alpha8:
+            rasterizeCoverage(shapes.constData(), shapes.size(), image.bits(),
+                    image.width(), image.height(), image.bytesPerLine());
+            return true;
+        case QImage::Format_RGB32:
+        case QImage::Format_ARGB32:
+        case QImage::Format_ARGB32_Premultiplied:
+            rasterizeIds(shapes.constData(), shapes.size(), reinterpret_cast<quint32 *>(image.bits()),
+                    image.width(), image.height(), image.bytesPerLine());
+            return true;
+        default:
+            return false;
+        }
+    }
+
+}
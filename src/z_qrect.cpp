@@ -39,6 +39,7 @@
 ****************************************************************************/
 
 #include "z_qrect.h"
+#include "z_qpointkernels.h"
 #include <boost/geometry.hpp>
 #include <boost/geometry/geometries/register/point.hpp>
 BOOST_GEOMETRY_REGISTER_POINT_2D_GET_SET(QPointF, qreal, boost::geometry::cs::cartesian, x, y, setX, setY);
@@ -1075,12 +1076,7 @@ namespace z_qtshapes {
         if (isNull() || p.isNull())
             return false;
 
-        const ZQRect first = normalized();
-
-        const QPainterPath path1 = first.toPath();
-
-        return path1.contains(p);
-
+        return prepared().contains(QPointF(p));
     }
 
 
@@ -1110,6 +1106,9 @@ namespace z_qtshapes {
         otherwise returns \c false. If \a proper is true, this function only
         returns \c true if the \a rectangle is entirely inside this
         rectangle (not on the edge).
+
+        Both rectangles are treated as oriented boxes, so their angles are
+        honoured without constructing a QPainterPath.
     */
 
     bool ZQRect::contains(const ZQRect &r, bool proper) const noexcept
@@ -1117,53 +1116,58 @@ namespace z_qtshapes {
         if (isNull() || r.isNull())
             return false;
 
-        const ZQRect first = normalized();
-        const ZQRect second = r.normalized();
+        return prepared().contains(r.prepared(), proper);
+    }
+
+    /*!
+        \fn bool ZQRect::contains(const ZQPreparedRectF &rectangle, bool proper) const
+        \overload
+
+        Returns \c true if the given prepared \a rectangle is inside this
+        rectangle, otherwise returns \c false. If \a proper is true, this
+        function only returns \c true if the \a rectangle is entirely inside
+        this rectangle (not on the edge).
 
-        const QPainterPath path1 = first.toPath();
-        const QPainterPath path2 = second.toPath();
+        \sa prepared()
+    */
 
-        if (proper && path1 == path2) {
+    bool ZQRect::contains(const ZQPreparedRectF &r, bool proper) const noexcept
+    {
+        if (isNull())
             return false;
-        }
-        return path1.contains(path2);
 
-   
+        return prepared().contains(r, proper);
     }
 
     /*!
-        \fn ZQRect ZQRect::operator|(const ZQRect &rectangle) const
+        \fn ZQPolygonF ZQRect::operator|(const ZQRect &rectangle) const
 
-        Returns the bounding rectangle of this rectangle and the given \a
-        rectangle. The result will always have an angle of 0 degrees.
+        Returns the union of this rectangle and the given \a rectangle as a
+        ZQPolygonF. Overlapping rectangles give one contour, disjoint ones
+        two. Both are rotated by their own angles; no QPainterPath is
+        built, call ZQPolygonF::toPath() for one.
 
-        \sa united()
+        \sa united(), ZQPolygonF::convexUnited()
     */
 
-    QPainterPath ZQRect::operator|(const ZQRect &r) const noexcept
+    ZQPolygonF ZQRect::operator|(const ZQRect &r) const noexcept
     {
         if (isNull())
-            return r.toPath();
+            return r.toPolygon();
         if (r.isNull())
-            return toPath();
-
-        const ZQRect first = normalized();
-        const ZQRect second = r.normalized();
+            return toPolygon();
 
-        const QPainterPath path1 = first.toPath();
-        const QPainterPath path2 = second.toPath();
-
-        return path1.united(path2);
+        return toPolygon().convexUnited(r.toPolygon());
 
     }
 
 
     /*!
-        \fn ZQRect ZQRect::united(const ZQRect &rectangle) const
+        \fn ZQPolygonF ZQRect::united(const ZQRect &rectangle) const
         \since 4.2
 
-        Returns the bounding rectangle of this rectangle and the given \a rectangle.
-        The result will always have an angle of 0 degrees.
+        Returns the union of this rectangle and the given \a rectangle.
+        Note that \c{r.united(s)} is equivalent to \c{r | s}.
 
         \image qrect-unite.png
 
@@ -1172,34 +1176,29 @@ namespace z_qtshapes {
 
 
     /*!
-        \fn ZQRect ZQRect::operator&(const ZQRect &rectangle) const
+        \fn ZQPolygonF ZQRect::operator&(const ZQRect &rectangle) const
 
-        Returns the intersection of this rectangle and the given \a
-        rectangle. Returns an empty rectangle if there is no intersection.
-        The angle of the intersected rectangle will always be 0 degrees.
+        Returns the intersection of this rectangle and the given \a rectangle
+        as a ZQPolygonF holding a single convex contour, or an empty
+        polygon if they do not overlap. The intersection is computed by
+        convex polygon clipping; no QPainterPath is built.
 
-        \sa intersected()
+        \sa intersected(), ZQPolygonF::convexIntersected()
     */
 
-    QPainterPath ZQRect::operator&(const ZQRect &r) const noexcept
+    ZQPolygonF ZQRect::operator&(const ZQRect &r) const noexcept
     {
         if (isNull())
-            return r.toPath();
+            return r.toPolygon();
         if (r.isNull())
-            return toPath();
-
-        const ZQRect first = normalized();
-        const ZQRect second = r.normalized();
+            return toPolygon();
 
-        const QPainterPath path1 = first.toPath();
-        const QPainterPath path2 = second.toPath();
-
-        return path1.intersected(path2);
+        return toPolygon().convexIntersected(r.toPolygon());
     }
 
 
     /*!
-        \fn ZQRect ZQRect::intersected(const ZQRect &rectangle) const
+        \fn ZQPolygonF ZQRect::intersected(const ZQRect &rectangle) const
         \since 4.2
 
         Returns the intersection of this rectangle and the given \a
@@ -1214,24 +1213,38 @@ namespace z_qtshapes {
         \fn bool ZQRect::intersects(const ZQRect &rectangle) const
 
         Returns \c true if this rectangle intersects with the given \a
-        rectangle (i.e., there is at least one pixel that is within both
-        rectangles), otherwise returns \c false.
+        rectangle (i.e., they share at least one point, their edges
+        included), otherwise returns \c false.
 
         The intersectio rectangle can be retrieved using the intersected()
         function.
 
+        The test is a separating axis test on the face normals of both
+        rotated rectangles. The rectangle spans right() and bottom(), so
+        ZQRect(0, 0, 10, 10) touches ZQRect(10, 0, 10, 10) along an edge
+        and intersects it, as touching shapes do everywhere.
+
         \sa contains()
     */
 
     bool ZQRect::intersects(const ZQRect &r) const noexcept
     {
-        const ZQRect first = normalized();
-        const ZQRect second = r.normalized();
+        return prepared().intersects(r.prepared());
+    }
+
+    /*!
+        \fn bool ZQRect::intersects(const ZQPreparedRectF &rectangle) const
+        \overload
 
-        const QPainterPath path1 = first.toPath();
-        const QPainterPath path2 = second.toPath();
+        Returns \c true if this rectangle intersects with the given prepared
+        \a rectangle, otherwise returns \c false.
 
-        return path1.intersects(path2);
+        \sa prepared()
+    */
+
+    bool ZQRect::intersects(const ZQPreparedRectF &r) const noexcept
+    {
+        return prepared().intersects(r);
     }
 
     /*!
@@ -1348,71 +1361,84 @@ namespace z_qtshapes {
 
     QPainterPath ZQRect::toPath() const noexcept
     {
-        QPainterPath path;
-        QPointF c1 = QPointF(topRight());
-        QPointF c2 = QPointF(bottomRight());
-        QPointF c3 = QPointF(bottomLeft());
-        QPointF c4 = QPointF(topLeft());
-        QPointF cn = QPointF(center());
-
-        QPointF c1a, c2a, c3a, c4a;
-        boost::geometry::strategy::transform::rotate_transformer<boost::geometry::degree, qreal, 2, 2> rotate(angle());
-        boost::geometry::transform(c1 - cn, c1a, rotate);
-        boost::geometry::transform(c2 - cn, c2a, rotate);
-        boost::geometry::transform(c3 - cn, c3a, rotate);
-        boost::geometry::transform(c4 - cn, c4a, rotate);
-        c1a += cn;
-        c2a += cn;
-        c3a += cn;
-        c4a += cn;
-
-        path.moveTo(c1a);
-        path.lineTo(c2a);
-        path.lineTo(c3a);
-        path.lineTo(c4a);
-        path.lineTo(c1a);
-        path.closeSubpath();
-        return path;
+        return prepared().toPath();
     }
 
     QPainterPath ZQRect::toPath(const QMatrix3x3 &mat, const QPointF& ref) const noexcept
     {
-        QPainterPath path;
-        QPointF c1 = QPointF(topRight());
-        QPointF c2 = QPointF(bottomRight());
-        QPointF c3 = QPointF(bottomLeft());
-        QPointF c4 = QPointF(topLeft());
-        QPointF cn = QPointF(center());
-
-        QPointF c1a, c2a, c3a, c4a;
-        boost::geometry::strategy::transform::rotate_transformer<boost::geometry::degree, qreal, 2, 2> rotate(angle());
-        boost::geometry::transform(c1 - cn, c1a, rotate);
-        boost::geometry::transform(c2 - cn, c2a, rotate);
-        boost::geometry::transform(c3 - cn, c3a, rotate);
-        boost::geometry::transform(c4 - cn, c4a, rotate);
-        c1a += cn;
-        c2a += cn;
-        c3a += cn;
-        c4a += cn;
-
-        QPointF c1r, c2r, c3r, c4r;
-        boost::geometry::strategy::transform::matrix_transformer<float, 2, 2>project2D(mat(0,0), mat(0,1), mat(0,2), mat(1,0), mat(1,1), mat(1,2), mat(2,0), mat(2,1), mat(2,2));
-        boost::geometry::transform(c1a - ref, c1r, project2D);
-        boost::geometry::transform(c2a - ref, c2r, project2D);
-        boost::geometry::transform(c3a - ref, c3r, project2D);
-        boost::geometry::transform(c4a - ref, c4r, project2D);
-        c1r += ref;
-        c2r += ref;
-        c3r += ref;
-        c4r += ref;
-
-        path.moveTo(c1r);
-        path.lineTo(c2r);
-        path.lineTo(c3r);
-        path.lineTo(c4r);
-        path.lineTo(c1r);
-        path.closeSubpath();
-        return path;
+        return prepared().toPath(mat, ref);
+    }
+
+    /*!
+        \fn ZQPolygonF ZQRect::toPolygon() const
+
+        Returns the rotated outline as a ZQPolygonF with one contour.
+
+        \sa toPath()
+    */
+
+    ZQPolygonF ZQRect::toPolygon() const noexcept
+    {
+        return prepared().toPolygon();
+    }
+
+
+    /*!
+        \fn ZQPreparedRectF ZQRect::prepared() const
+
+        Returns a prepared form of this rectangle with the sine and cosine
+        of its angle, its rotated corners and its axis aligned bounding
+        rectangle computed once. Keep the result around when the same
+        rectangle is queried many times between modifications.
+
+        \sa ZQPreparedRectF
+    */
+
+    ZQPreparedRectF ZQRect::prepared() const noexcept
+    {
+        return ZQPreparedRectF(x1, y1, x2, y2, QPointF(center()), a);
+    }
+
+    /*!
+        \fn QRectF ZQRect::boundingRectF() const
+
+        Returns the axis aligned bounding rectangle of the rotated
+        rectangle. It is computed in closed form from the half extents and
+        the angle, without building a path, and is the same rectangle as
+        prepared().boundingRect().
+
+        \sa boundingRect()
+    */
+
+    QRectF ZQRect::boundingRectF() const noexcept
+    {
+        qreal c, s;
+        angleCosSin(a, &c, &s);
+        const QPointF rc(center());
+        const qreal dx = (qreal(x1) + x2) / 2 - rc.x();
+        const qreal dy = (qreal(y1) + y2) / 2 - rc.y();
+        const qreal cx = rc.x() + c*dx + s*dy;
+        const qreal cy = rc.y() - s*dx + c*dy;
+        const qreal hw = qAbs(qreal(x2) - x1) / 2;
+        const qreal hh = qAbs(qreal(y2) - y1) / 2;
+        const qreal ex = hw*qAbs(c) + hh*qAbs(s);
+        const qreal ey = hw*qAbs(s) + hh*qAbs(c);
+        const qreal l = cx - ex, t = cy - ey;
+        return QRectF(l, t, (cx + ex) - l, (cy + ey) - t);
+    }
+
+    /*!
+        \fn QRect ZQRect::boundingRect() const
+
+        Returns the smallest integer rectangle that contains
+        boundingRectF().
+
+        \sa boundingRectF()
+    */
+
+    QRect ZQRect::boundingRect() const noexcept
+    {
+        return boundingRectF().toAlignedRect();
     }
 
     /*****************************************************************************
@@ -2321,10 +2347,7 @@ namespace z_qtshapes {
         if (isNull() || p.isNull())
             return false;
 
-        const ZQRectF first = normalized();
-        const QPainterPath path1 = first.toPath();
-
-        return path1.contains(p);
+        return prepared().contains(p);
     }
 
 
@@ -2337,25 +2360,44 @@ namespace z_qtshapes {
     */
 
     /*!
-        \fn bool ZQRectF::contains(const ZQRectF &rectangle) const
+        \fn bool ZQRectF::contains(const ZQRectF &rectangle, bool proper) const
         \overload
 
         Returns \c true if the given \a rectangle is inside this rectangle;
-        otherwise returns \c false.
+        otherwise returns \c false. If \a proper is true, this function only
+        returns \c true if the \a rectangle is entirely inside this
+        rectangle (not on the edge).
+
+        Both rectangles are treated as oriented boxes, so their angles are
+        honoured without constructing a QPainterPath.
     */
 
     bool ZQRectF::contains(const ZQRectF &r, bool proper) const noexcept
     {
-        const ZQRectF first = normalized();
-        const ZQRectF second = r.normalized();
+        if (isNull() || r.isNull())
+            return false;
+
+        return prepared().contains(r.prepared(), proper);
+    }
+
+    /*!
+        \fn bool ZQRectF::contains(const ZQPreparedRectF &rectangle, bool proper) const
+        \overload
 
-        const QPainterPath path1 = first.toPath();
-        const QPainterPath path2 = second.toPath();
+        Returns \c true if the given prepared \a rectangle is inside this
+        rectangle, otherwise returns \c false. If \a proper is true, this
+        function only returns \c true if the \a rectangle is entirely inside
+        this rectangle (not on the edge).
 
-        if (proper && path1 == path2) {
+        \sa prepared()
+    */
+
+    bool ZQRectF::contains(const ZQPreparedRectF &r, bool proper) const noexcept
+    {
+        if (isNull())
             return false;
-        }
-        return path1.contains(path2);
+
+        return prepared().contains(r, proper);
     }
 
     /*!
@@ -2426,37 +2468,33 @@ namespace z_qtshapes {
 
 
     /*!
-        \fn ZQRectF ZQRectF::operator|(const ZQRectF &rectangle) const
+        \fn ZQPolygonF ZQRectF::operator|(const ZQRectF &rectangle) const
 
-        Returns the bounding rectangle of this rectangle and the given \a rectangle.
-        The result will always have an angle of 0 degrees.
+        Returns the union of this rectangle and the given \a rectangle as a
+        ZQPolygonF. Overlapping rectangles give one contour, disjoint ones
+        two. Both are rotated by their own angles; no QPainterPath is
+        built, call ZQPolygonF::toPath() for one.
 
-        \sa united()
+        \sa united(), ZQPolygonF::convexUnited()
     */
 
-    QPainterPath ZQRectF::operator|(const ZQRectF &r) const noexcept
+    ZQPolygonF ZQRectF::operator|(const ZQRectF &r) const noexcept
     {
         if (isNull())
-            return r.toPath();
+            return r.toPolygon();
         if (r.isNull())
-            return toPath();
-
-        const ZQRectF first = normalized();
-        const ZQRectF second = r.normalized();
-
-        const QPainterPath path1 = first.toPath();
-        const QPainterPath path2 = second.toPath();
+            return toPolygon();
 
-        return path1.united(path2);
+        return toPolygon().convexUnited(r.toPolygon());
     }
 
 
     /*!
-        \fn ZQRectF ZQRectF::united(const ZQRectF &rectangle) const
+        \fn ZQPolygonF ZQRectF::united(const ZQRectF &rectangle) const
         \since 4.2
 
-        Returns the bounding rectangle of this rectangle and the given \a
-        rectangle. The result will always have an angle of 0 degrees.
+        Returns the union of this rectangle and the given \a rectangle.
+        Note that \c{r.united(s)} is equivalent to \c{r | s}.
 
         \image qrect-unite.png
 
@@ -2465,39 +2503,33 @@ namespace z_qtshapes {
 
 
     /*!
-        \fn ZQRectF ZQRectF::operator&(const ZQRectF &rectangle) const
+        \fn ZQPolygonF ZQRectF::operator&(const ZQRectF &rectangle) const
 
-        Returns the intersection of this rectangle and the given \a
-        rectangle. Returns an empty rectangle if there is no intersection.
-        The angle of the intersected rectangle will always be 0 degrees.
+        Returns the intersection of this rectangle and the given \a rectangle
+        as a ZQPolygonF holding a single convex contour, or an empty
+        polygon if they do not overlap. The intersection is computed by
+        convex polygon clipping; no QPainterPath is built.
 
-        \sa intersected()
+        \sa intersected(), ZQPolygonF::convexIntersected()
     */
 
-    QPainterPath ZQRectF::operator&(const ZQRectF &r) const noexcept
+    ZQPolygonF ZQRectF::operator&(const ZQRectF &r) const noexcept
     {
         if (isNull())
-            return r.toPath();
+            return r.toPolygon();
         if (r.isNull())
-            return toPath();
-
-        const ZQRectF first = normalized();
-        const ZQRectF second = r.normalized();
-
-        const QPainterPath path1 = first.toPath();
-        const QPainterPath path2 = second.toPath();
+            return toPolygon();
 
-        return path1.intersected(path2);
+        return toPolygon().convexIntersected(r.toPolygon());
     }
 
 
     /*!
-        \fn QPainterPath ZQRectF::intersected(const ZQRectF &rectangle) const
+        \fn ZQPolygonF ZQRectF::intersected(const ZQRectF &rectangle) const
         \since 4.2
 
         Returns the intersection of this rectangle and the given \a
-        rectangle. Note that \c {r.intersected(s)} is equivalent to \c
-        {r & s}.
+        rectangle. Note that \c{r.intersected(s)} is equivalent to \c{r & s}.
 
         \image qrect-intersect.png
 
@@ -2508,25 +2540,38 @@ namespace z_qtshapes {
         \fn bool ZQRectF::intersects(const ZQRectF &rectangle) const
 
         Returns \c true if this rectangle intersects with the given \a
-        rectangle (i.e. there is a non-empty area of overlap between
-        them), otherwise returns \c false.
+        rectangle (i.e. they share at least one point, their edges
+        included), otherwise returns \c false.
 
         The intersectio rectangle can be retrieved using the intersected()
         function.
 
+        The test is a separating axis test on the face normals of both
+        rotated rectangles. Both rectangles are closed, as for every shape
+        predicate, so rectangles that only touch along an edge or at a
+        corner intersect.
+
         \sa contains()
     */
 
     bool ZQRectF::intersects(const ZQRectF &r) const noexcept
     {
+        return prepared().intersects(r.prepared());
+    }
 
-        const ZQRectF first = normalized();
-        const ZQRectF second = r.normalized();
+    /*!
+        \fn bool ZQRectF::intersects(const ZQPreparedRectF &rectangle) const
+        \overload
 
-        const QPainterPath path1 = first.toPath();
-        const QPainterPath path2 = second.toPath();
+        Returns \c true if this rectangle intersects with the given prepared
+        \a rectangle, otherwise returns \c false.
+
+        \sa prepared()
+    */
 
-        return path1.intersects(path2);
+    bool ZQRectF::intersects(const ZQPreparedRectF &r) const noexcept
+    {
+        return prepared().intersects(r);
     }
 
     /*!
@@ -2675,71 +2720,91 @@ namespace z_qtshapes {
 
     QPainterPath ZQRectF::toPath() const noexcept
     {
-        QPainterPath path;
-        QPointF c1 = topRight();
-        QPointF c2 = bottomRight();
-        QPointF c3 = bottomLeft();
-        QPointF c4 = topLeft();
-        QPointF cn = center();
-
-        QPointF c1a, c2a, c3a, c4a;
-        boost::geometry::strategy::transform::rotate_transformer<boost::geometry::degree, qreal, 2, 2> rotate(angle());
-        boost::geometry::transform(c1 - cn, c1a, rotate);
-        boost::geometry::transform(c2 - cn, c2a, rotate);
-        boost::geometry::transform(c3 - cn, c3a, rotate);
-        boost::geometry::transform(c4 - cn, c4a, rotate);
-        c1a += cn;
-        c2a += cn;
-        c3a += cn;
-        c4a += cn;
-
-        path.moveTo(c1a);
-        path.lineTo(c2a);
-        path.lineTo(c3a);
-        path.lineTo(c4a);
-        path.lineTo(c1a);
-        path.closeSubpath();
-        return path;
+        return prepared().toPath();
     }
 
     QPainterPath ZQRectF::toPath(const QMatrix3x3 &mat, const QPointF& ref) const noexcept
     {
-        QPainterPath path;
-        QPointF c1 = topRight();
-        QPointF c2 = bottomRight();
-        QPointF c3 = bottomLeft();
-        QPointF c4 = topLeft();
-        QPointF cn = center();
-
-        QPointF c1a, c2a, c3a, c4a;
-        boost::geometry::strategy::transform::rotate_transformer<boost::geometry::degree, qreal, 2, 2> rotate(angle());
-        boost::geometry::transform(c1 - cn, c1a, rotate);
-        boost::geometry::transform(c2 - cn, c2a, rotate);
-        boost::geometry::transform(c3 - cn, c3a, rotate);
-        boost::geometry::transform(c4 - cn, c4a, rotate);
-        c1a += cn;
-        c2a += cn;
-        c3a += cn;
-        c4a += cn;
-
-        QPointF c1r, c2r, c3r, c4r;
-        boost::geometry::strategy::transform::matrix_transformer<float, 2, 2>project2D(mat(0,0), mat(0,1), mat(0,2), mat(1,0), mat(1,1), mat(1,2), mat(2,0), mat(2,1), mat(2,2));
-        boost::geometry::transform(c1a - ref, c1r, project2D);
-        boost::geometry::transform(c2a - ref, c2r, project2D);
-        boost::geometry::transform(c3a - ref, c3r, project2D);
-        boost::geometry::transform(c4a - ref, c4r, project2D);
-        c1r += ref;
-        c2r += ref;
-        c3r += ref;
-        c4r += ref;
-
-        path.moveTo(c1r);
-        path.lineTo(c2r);
-        path.lineTo(c3r);
-        path.lineTo(c4r);
-        path.lineTo(c1r);
-        path.closeSubpath();
-        return path;
+        return prepared().toPath(mat, ref);
+    }
+
+    /*!
+        \fn ZQPolygonF ZQRectF::toPolygon() const
+
+        Returns the rotated outline as a ZQPolygonF with one contour.
+
+        \sa toPath()
+    */
+
+    ZQPolygonF ZQRectF::toPolygon() const noexcept
+    {
+        return prepared().toPolygon();
+    }
+
+
+    /*!
+        \fn ZQPreparedRectF ZQRectF::prepared() const
+
+        Returns a prepared form of this rectangle with the sine and cosine
+        of its angle, its rotated corners and its axis aligned bounding
+        rectangle computed once. Keep the result around when the same
+        rectangle is queried many times between modifications.
+
+        \sa ZQPreparedRectF
+    */
+
+    ZQPreparedRectF ZQRectF::prepared() const noexcept
+    {
+        return ZQPreparedRectF(xp, yp, xp + w, yp + h, center(), a);
+    }
+
+    /*!
+        \fn QRectF ZQRectF::boundingRect() const
+
+        Returns the axis aligned bounding rectangle of the rotated
+        rectangle. It is computed in closed form from the half extents and
+        the angle, without building a path, which makes it cheap enough to
+        be the first stage of culling and indexing.
+
+        \sa prepared()
+    */
+
+    QRectF ZQRectF::boundingRect() const noexcept
+    {
+        qreal c, s;
+        angleCosSin(a, &c, &s);
+        const QPointF cn = center();
+        const qreal ex = qAbs(w)/2*qAbs(c) + qAbs(h)/2*qAbs(s);
+        const qreal ey = qAbs(w)/2*qAbs(s) + qAbs(h)/2*qAbs(c);
+        return QRectF(cn.x() - ex, cn.y() - ey, 2*ex, 2*ey);
+    }
+
+    /*!
+        \fn int ZQRectF::tessellationVertexCount(qreal tolerance) const
+
+        Returns the number of vertices tessellate() writes, which is always
+        4.
+    */
+
+    /*!
+        \fn int ZQRectF::tessellationIndexCount(qreal tolerance) const
+
+        Returns the number of indices tessellate() writes, which is always
+        6.
+    */
+
+    /*!
+        \fn void ZQRectF::tessellate(qreal tolerance, float *vertices, quint32 *indices, quint32 baseVertex) const
+
+        Writes the rotated rectangle as two indexed triangles into
+        \a vertices and \a indices.
+
+        \sa ZQPreparedRectF::tessellate()
+    */
+
+    void ZQRectF::tessellate(qreal tolerance, float *vertices, quint32 *indices, quint32 baseVertex) const noexcept
+    {
+        prepared().tessellate(tolerance, vertices, indices, baseVertex);
     }
 
     /*****************************************************************************
@@ -2798,4 +2863,249 @@ namespace z_qtshapes {
     }
     #endif
 
+
+    /*!
+        \class ZQPreparedRectF
+        \inmodule Zgeometry
+        \ingroup painting
+        \reentrant
+
+        \brief The ZQPreparedRectF class holds a rotated rectangle in a form
+        that is ready for repeated queries.
+
+        A ZQPreparedRectF is created with ZQRect::prepared() or
+        ZQRectF::prepared(). It stores the sine and cosine of the angle, the
+        rotated corners and the axis aligned bounding rectangle, so that
+        contains(), intersects() and toPath() do not evaluate any
+        trigonometric functions. The object is immutable; prepare the
+        rectangle again after modifying it.
+
+        The rotation follows the same clockwise convention as toPath() of
+        the rectangle classes, so the local x axis maps to (cos, -sin) and
+        the local y axis maps to (sin, cos).
+    */
+
+    /*!
+        \fn ZQPreparedRectF::ZQPreparedRectF(qreal left, qreal top, qreal right, qreal bottom, const QPointF &rotationCenter, qreal angle)
+
+        Constructs the prepared form of the axis aligned rectangle spanned by
+        \a left, \a top, \a right and \a bottom, rotated by \a angle degrees
+        about \a rotationCenter.
+    */
+
+    ZQPreparedRectF::ZQPreparedRectF(qreal left, qreal top, qreal right, qreal bottom,
+            const QPointF &rotationCenter, qreal angle) noexcept
+    {
+        qreal c, s;
+        angleCosSin(angle, &c, &s);
+        *this = ZQPreparedRectF(left, top, right, bottom, rotationCenter, angle, c, s);
+    }
+
+    /*!
+        \fn ZQPreparedRectF::ZQPreparedRectF(qreal left, qreal top, qreal right, qreal bottom, const QPointF &rotationCenter, qreal angle, qreal cosAngle, qreal sinAngle)
+        \overload
+
+        Constructs the prepared rectangle with \a cosAngle and \a sinAngle
+        as the cosine and sine of \a angle, for callers that keep them
+        cached already. They are used as given.
+    */
+
+    ZQPreparedRectF::ZQPreparedRectF(qreal left, qreal top, qreal right, qreal bottom,
+            const QPointF &rotationCenter, qreal angle, qreal cosAngle, qreal sinAngle) noexcept
+        : ca(cosAngle), sa(sinAngle), a(angle)
+    {
+        hw = qAbs(right - left) / 2;
+        hh = qAbs(bottom - top) / 2;
+
+        const qreal dx = (left + right) / 2 - rotationCenter.x();
+        const qreal dy = (top + bottom) / 2 - rotationCenter.y();
+        cx = rotationCenter.x() + ca * dx + sa * dy;
+        cy = rotationCenter.y() - sa * dx + ca * dy;
+
+        const qreal su[4] = { hw, hw, -hw, -hw };
+        const qreal sv[4] = { -hh, hh, hh, -hh };
+        for (int i = 0; i < 4; ++i)
+            corners[i] = QPointF(cx + su[i] * ca + sv[i] * sa, cy - su[i] * sa + sv[i] * ca);
+
+        const qreal ex = hw * qAbs(ca) + hh * qAbs(sa);
+        const qreal ey = hw * qAbs(sa) + hh * qAbs(ca);
+        bx1 = cx - ex;
+        by1 = cy - ey;
+        bx2 = cx + ex;
+        by2 = cy + ey;
+    }
+
+    /*!
+        \fn bool ZQPreparedRectF::contains(const QPointF &point) const
+
+        Returns \c true if the given \a point is inside or on the edge of
+        the rectangle, otherwise returns \c false.
+    */
+
+    bool ZQPreparedRectF::contains(const QPointF &p) const noexcept
+    {
+        if (p.x() < bx1 || p.x() > bx2 || p.y() < by1 || p.y() > by2)
+            return false;
+
+        const qreal dx = p.x() - cx;
+        const qreal dy = p.y() - cy;
+        return qAbs(dx * ca - dy * sa) <= hw && qAbs(dx * sa + dy * ca) <= hh;
+    }
+
+    /*!
+        \fn bool ZQPreparedRectF::contains(const ZQPreparedRectF &rectangle, bool proper) const
+
+        Returns \c true if every corner of the given \a rectangle lies
+        inside this rectangle, otherwise returns \c false. If \a proper is
+        true, the corners must not lie on the edge of this rectangle.
+    */
+
+    bool ZQPreparedRectF::contains(const ZQPreparedRectF &r, bool proper) const noexcept
+    {
+        if (r.bx1 < bx1 || r.bx2 > bx2 || r.by1 < by1 || r.by2 > by2)
+            return false;
+
+        for (int i = 0; i < 4; ++i) {
+            const qreal dx = r.corners[i].x() - cx;
+            const qreal dy = r.corners[i].y() - cy;
+            const qreal pu = qAbs(dx * ca - dy * sa);
+            const qreal pv = qAbs(dx * sa + dy * ca);
+            if (proper ? (pu >= hw || pv >= hh) : (pu > hw || pv > hh))
+                return false;
+        }
+        return true;
+    }
+
+    /*!
+        \fn bool ZQPreparedRectF::intersects(const ZQPreparedRectF &rectangle) const
+
+        Returns \c true if this rectangle and the given \a rectangle touch
+        or overlap, otherwise returns \c false. Like every shape predicate
+        the rectangles are closed, so sharing an edge or a corner is
+        enough.
+
+        The bounding rectangles are compared first; overlapping candidates
+        are then checked with a separating axis test on the face normals of
+        both rectangles.
+    */
+
+    bool ZQPreparedRectF::intersects(const ZQPreparedRectF &r) const noexcept
+    {
+        if (r.bx1 > bx2 || r.bx2 < bx1 || r.by1 > by2 || r.by2 < by1)
+            return false;
+
+        const qreal tx = r.cx - cx;
+        const qreal ty = r.cy - cy;
+        const qreal axes[4][2] = {
+            { ca, -sa }, { sa, ca }, { r.ca, -r.sa }, { r.sa, r.ca }
+        };
+        for (int i = 0; i < 4; ++i) {
+            const qreal lx = axes[i][0];
+            const qreal ly = axes[i][1];
+            const qreal ra = hw * qAbs(ca*lx - sa*ly) + hh * qAbs(sa*lx + ca*ly);
+            const qreal rb = r.hw * qAbs(r.ca*lx - r.sa*ly) + r.hh * qAbs(r.sa*lx + r.ca*ly);
+            if (qAbs(tx*lx + ty*ly) > ra + rb)
+                return false;
+        }
+        return true;
+    }
+
+    /*!
+        \fn QPainterPath ZQPreparedRectF::toPath() const
+
+        Converts the rectangle into a QPainterPath using the cached corners.
+    */
+
+    QPainterPath ZQPreparedRectF::toPath() const noexcept
+    {
+        QPainterPath path;
+        path.moveTo(corners[0]);
+        path.lineTo(corners[1]);
+        path.lineTo(corners[2]);
+        path.lineTo(corners[3]);
+        path.lineTo(corners[0]);
+        path.closeSubpath();
+        return path;
+    }
+
+    /*!
+        \fn ZQPolygonF ZQPreparedRectF::toPolygon() const
+
+        Returns the cached corners as a ZQPolygonF with one contour.
+    */
+
+    ZQPolygonF ZQPreparedRectF::toPolygon() const noexcept
+    {
+        return ZQPolygonF(corners, 4);
+    }
+
+    /*!
+        \fn QPainterPath ZQPreparedRectF::toPath(const QMatrix3x3 &mat, const QPointF &ref) const
+
+        Transforms the rectangle about the point \a ref using the
+        transformation matrix \a mat and then converts it into a
+        QPainterPath.
+    */
+
+    QPainterPath ZQPreparedRectF::toPath(const QMatrix3x3 &mat, const QPointF& ref) const noexcept
+    {
+        QPainterPath path;
+        qreal x[4], y[4];
+        for (int i = 0; i < 4; ++i) {
+            x[i] = corners[i].x();
+            y[i] = corners[i].y();
+        }
+        transformPoints(ZQPointTransform(mat, ref), x, y, x, y, 4);
+
+        path.moveTo(x[0], y[0]);
+        path.lineTo(x[1], y[1]);
+        path.lineTo(x[2], y[2]);
+        path.lineTo(x[3], y[3]);
+        path.lineTo(x[0], y[0]);
+        path.closeSubpath();
+        return path;
+    }
+
+    /*!
+        \fn int ZQPreparedRectF::tessellationVertexCount(qreal tolerance) const
+
+        Returns the number of vertices tessellate() writes, which is always
+        4. \a tolerance is accepted so that every shape has the same
+        interface.
+    */
+
+    /*!
+        \fn int ZQPreparedRectF::tessellationIndexCount(qreal tolerance) const
+
+        Returns the number of indices tessellate() writes, which is always
+        6.
+    */
+
+    /*!
+        \fn void ZQPreparedRectF::tessellate(qreal tolerance, float *vertices, quint32 *indices, quint32 baseVertex) const
+
+        Writes the rotated corners into \a vertices, as interleaved x and y
+        coordinates, and two triangles into \a indices as a triangle list.
+        \a baseVertex is added to every index; pass the number of vertices
+        already in the buffer. \a tolerance is unused, as the rectangle is
+        represented exactly.
+
+        Both triangles have a positive signed area in the rectangle's
+        coordinate system, the same winding the other shapes use.
+    */
+
+    void ZQPreparedRectF::tessellate(qreal tolerance, float *vertices, quint32 *indices,
+            quint32 baseVertex) const noexcept
+    {
+        Q_UNUSED(tolerance);
+        for (int i = 0; i < 4; ++i) {
+            vertices[2*i] = float(corners[i].x());
+            vertices[2*i + 1] = float(corners[i].y());
+        }
+
+        const quint32 fan[6] = { 0, 1, 2, 0, 2, 3 };
+        for (int i = 0; i < 6; ++i)
+            indices[i] = baseVertex + fan[i];
+    }
+
 }
@@ -0,0 +1,827 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#include "z_qshapearray.h"
+#include <limits>
+
+
+namespace z_qtshapes {
+
+    namespace {
+
+        inline void offset(qreal *v, int n, qreal d) noexcept
+        {
+            for (int i = 0; i < n; ++i)
+                v[i] += d;
+        }
+
+        // Angles are kept in [0, 360) like the value class constructors
+        // do, and the cached sine and cosine follow every change.
+        inline void rotateAngles(qreal *a, qreal *c, qreal *s, int n, qreal da) noexcept
+        {
+            for (int i = 0; i < n; ++i) {
+                a[i] = normalizedAngle(a[i] + da);
+                angleCosSin(a[i], &c[i], &s[i]);
+            }
+        }
+
+        inline void cacheAngle(qreal a, qreal &c, qreal &s) noexcept
+        {
+            angleCosSin(a, &c, &s);
+        }
+
+        template <typename Array>
+        QRectF unitedBounds(const Array &array) noexcept
+        {
+            const int n = array.size();
+            if (n == 0)
+                return QRectF();
+
+            qreal x1 = std::numeric_limits<qreal>::max();
+            qreal y1 = x1;
+            qreal x2 = -x1;
+            qreal y2 = -x1;
+            qreal l, t, r, b;
+            for (int i = 0; i < n; ++i) {
+                array.bounds(i, l, t, r, b);
+                x1 = qMin(x1, l);
+                y1 = qMin(y1, t);
+                x2 = qMax(x2, r);
+                y2 = qMax(y2, b);
+            }
+            return QRectF(QPointF(x1, y1), QPointF(x2, y2));
+        }
+
+        /*
+         * Shared body of the intersects() batch: the bounding rectangle of
+         * every element is computed from the cached sine and cosine and
+         * compared with the one of the query, and only the overlapping
+         * elements are prepared for the exact test, from the same cached
+         * values. The query rectangle is widened by a few ulps so that
+         * rounding differences between the two bounding rectangle
+         * computations never reject a touching pair.
+         */
+        template <typename Array>
+        void intersectsBatch(const Array &array, const ZQPreparedShape &shape, bool *result) noexcept
+        {
+            const int n = array.size();
+            if (shape.isNull()) {
+                for (int i = 0; i < n; ++i)
+                    result[i] = false;
+                return;
+            }
+
+            const QRectF q = shape.boundingRect();
+            const qreal eps = 1e-12 * (1 + qMax(qMax(qAbs(q.left()), qAbs(q.right())),
+                                                qMax(qAbs(q.top()), qAbs(q.bottom()))));
+            const qreal qx1 = q.left() - eps;
+            const qreal qy1 = q.top() - eps;
+            const qreal qx2 = q.right() + eps;
+            const qreal qy2 = q.bottom() + eps;
+
+            qreal l, t, r, b;
+            for (int i = 0; i < n; ++i) {
+                array.bounds(i, l, t, r, b);
+                if (r < qx1 || l > qx2 || b < qy1 || t > qy2)
+                    result[i] = false;
+                else
+                    result[i] = array.prepared(i).intersects(shape);
+            }
+        }
+
+        template <typename Array>
+        void boundsBatch(const Array &array, qreal *left, qreal *top, qreal *right, qreal *bottom) noexcept
+        {
+            const int n = array.size();
+            for (int i = 0; i < n; ++i)
+                array.bounds(i, left[i], top[i], right[i], bottom[i]);
+        }
+
+        // Read only views used by the shared templates above.
+        struct RectView {
+            const ZQRectFArray &a;
+            inline int size() const noexcept { return a.size(); }
+            inline ZQRectF at(int i) const noexcept { return a.at(i); }
+            inline ZQPreparedShape prepared(int i) const noexcept
+            {
+                return ZQPreparedShape(a.at(i), a.cosData()[i], a.sinData()[i]);
+            }
+            inline void bounds(int i, qreal &l, qreal &t, qreal &r, qreal &b) const noexcept
+            {
+                const qreal w = a.widthData()[i];
+                const qreal h = a.heightData()[i];
+                const qreal c = qAbs(a.cosData()[i]);
+                const qreal s = qAbs(a.sinData()[i]);
+                const qreal cx = a.xData()[i] + w/2;
+                const qreal cy = a.yData()[i] + h/2;
+                const qreal hw = qAbs(w) / 2;
+                const qreal hh = qAbs(h) / 2;
+                const qreal ex = hw * c + hh * s;
+                const qreal ey = hw * s + hh * c;
+                l = cx - ex;
+                t = cy - ey;
+                r = cx + ex;
+                b = cy + ey;
+            }
+        };
+
+        struct EllipseView {
+            const ZQEllipseFArray &a;
+            inline int size() const noexcept { return a.size(); }
+            inline ZQEllipseF at(int i) const noexcept { return a.at(i); }
+            inline ZQPreparedShape prepared(int i) const noexcept
+            {
+                return ZQPreparedShape(a.at(i), a.cosData()[i], a.sinData()[i]);
+            }
+            inline void bounds(int i, qreal &l, qreal &t, qreal &r, qreal &b) const noexcept
+            {
+                const qreal w = a.widthData()[i];
+                const qreal h = a.heightData()[i];
+                const qreal c = a.cosData()[i];
+                const qreal s = a.sinData()[i];
+                const qreal cx = a.xData()[i] + w/2;
+                const qreal cy = a.yData()[i] + h/2;
+                const qreal rx = qAbs(w / 2);
+                const qreal ry = qAbs(h / 2);
+                const qreal ex = qSqrt(rx*rx*c*c + ry*ry*s*s);
+                const qreal ey = qSqrt(rx*rx*s*s + ry*ry*c*c);
+                l = cx - ex;
+                t = cy - ey;
+                r = cx + ex;
+                b = cy + ey;
+            }
+        };
+
+        struct TriView {
+            const ZQTriFArray &a;
+            inline int size() const noexcept { return a.size(); }
+            inline ZQTriF at(int i) const noexcept { return a.at(i); }
+            inline ZQPreparedShape prepared(int i) const noexcept
+            {
+                return ZQPreparedShape(a.at(i), a.cosData()[i], a.sinData()[i]);
+            }
+            inline void vertices(int i, qreal vx[3], qreal vy[3]) const noexcept
+            {
+                const qreal x[3] = { a.x1Data()[i], a.x2Data()[i], a.x3Data()[i] };
+                const qreal y[3] = { a.y1Data()[i], a.y2Data()[i], a.y3Data()[i] };
+                const qreal c = a.cosData()[i];
+                const qreal s = a.sinData()[i];
+                const qreal cx = (x[0] + x[1] + x[2]) / 3;
+                const qreal cy = (y[0] + y[1] + y[2]) / 3;
+                for (int k = 0; k < 3; ++k) {
+                    const qreal dx = x[k] - cx;
+                    const qreal dy = y[k] - cy;
+                    vx[k] = cx + c*dx + s*dy;
+                    vy[k] = cy - s*dx + c*dy;
+                }
+            }
+            inline void bounds(int i, qreal &l, qreal &t, qreal &r, qreal &b) const noexcept
+            {
+                qreal vx[3], vy[3];
+                vertices(i, vx, vy);
+                l = qMin(vx[0], qMin(vx[1], vx[2]));
+                t = qMin(vy[0], qMin(vy[1], vy[2]));
+                r = qMax(vx[0], qMax(vx[1], vx[2]));
+                b = qMax(vy[0], qMax(vy[1], vy[2]));
+            }
+        };
+
+    }
+
+
+    /*!
+        \class ZQRectFArray
+        \inmodule Zgeometry
+        \ingroup painting
+
+        \brief The ZQRectFArray class stores rectangles as a structure of
+        arrays for batch processing.
+
+        The left edges, top edges, widths, heights and angles of the
+        rectangles are kept in separate contiguous arrays aligned to 64
+        bytes, together with the sine and cosine of every angle. The batch
+        functions run one tight loop over these arrays, which the compiler
+        can vectorize, instead of touching one ZQRectF at a time.
+
+        Angles are kept normalized to [0, 360), as the ZQRectF constructors
+        do, so at() returns a rectangle equal to the one appended after the
+        same sequence of rotations built with rotated().
+
+        \sa ZQEllipseFArray, ZQTriFArray
+    */
+
+    /*!
+        \fn ZQRectFArray::ZQRectFArray(const QVector<ZQRectF> &rects)
+
+        Constructs an array holding copies of the \a rects.
+    */
+
+    ZQRectFArray::ZQRectFArray(const QVector<ZQRectF> &rects)
+    {
+        reserve(rects.size());
+        for (const ZQRectF &r : rects)
+            append(r);
+    }
+
+    /*!
+        \fn void ZQRectFArray::reserve(int size)
+
+        Allocates room for at least \a size rectangles.
+    */
+
+    void ZQRectFArray::reserve(int size)
+    {
+        for (ZQRealBuffer *b : { &xs, &ys, &ws, &hs, &as, &cs, &ss })
+            b->reserve(size);
+    }
+
+    /*!
+        \fn void ZQRectFArray::clear()
+
+        Removes all rectangles, keeping the allocated memory.
+    */
+
+    void ZQRectFArray::clear() noexcept
+    {
+        for (ZQRealBuffer *b : { &xs, &ys, &ws, &hs, &as, &cs, &ss })
+            b->clear();
+    }
+
+    /*!
+        \fn void ZQRectFArray::append(const ZQRectF &rect)
+
+        Appends the \a rect to the array.
+    */
+
+    void ZQRectFArray::append(const ZQRectF &r)
+    {
+        xs.append(r.x());
+        ys.append(r.y());
+        ws.append(r.width());
+        hs.append(r.height());
+        as.append(normalizedAngle(r.angle()));
+        cs.append(0);
+        ss.append(0);
+        cacheAngle(as[size() - 1], cs[size() - 1], ss[size() - 1]);
+    }
+
+    /*!
+        \fn void ZQRectFArray::replace(int i, const ZQRectF &rect)
+
+        Replaces the rectangle at index \a i with \a rect. \a i must be a
+        valid index.
+    */
+
+    void ZQRectFArray::replace(int i, const ZQRectF &r) noexcept
+    {
+        xs[i] = r.x();
+        ys[i] = r.y();
+        ws[i] = r.width();
+        hs[i] = r.height();
+        as[i] = normalizedAngle(r.angle());
+        cacheAngle(as[i], cs[i], ss[i]);
+    }
+
+    /*!
+        \fn ZQRectF ZQRectFArray::at(int i) const
+
+        Returns the rectangle at index \a i. \a i must be a valid index.
+    */
+
+    ZQRectF ZQRectFArray::at(int i) const noexcept
+    {
+        return ZQRectF(xs[i], ys[i], ws[i], hs[i], as[i]);
+    }
+
+    /*!
+        \fn QVector<ZQRectF> ZQRectFArray::toVector() const
+
+        Returns the rectangles as a vector of ZQRectF.
+    */
+
+    QVector<ZQRectF> ZQRectFArray::toVector() const
+    {
+        QVector<ZQRectF> result;
+        result.reserve(size());
+        for (int i = 0; i < size(); ++i)
+            result.append(at(i));
+        return result;
+    }
+
+    /*!
+        \fn void ZQRectFArray::translate(qreal dx, qreal dy)
+
+        Moves every rectangle \a dx along the x axis and \a dy along the y
+        axis.
+    */
+
+    void ZQRectFArray::translate(qreal dx, qreal dy) noexcept
+    {
+        offset(xs.data(), size(), dx);
+        offset(ys.data(), size(), dy);
+    }
+
+    /*!
+        \fn void ZQRectFArray::rotate(qreal da)
+
+        Rotates every rectangle by \a da degrees about its center.
+    */
+
+    void ZQRectFArray::rotate(qreal da) noexcept
+    {
+        rotateAngles(as.data(), cs.data(), ss.data(), size(), da);
+    }
+
+    /*!
+        \fn void ZQRectFArray::contains(const QPointF &point, bool *result) const
+
+        Writes to \c{result[i]} whether the rectangle at index \c i
+        contains the \a point, with the same answers as
+        ZQRectF::contains(). \a result must have room for size() values.
+    */
+
+    void ZQRectFArray::contains(const QPointF &p, bool *result) const noexcept
+    {
+        const int n = size();
+        const qreal *x = xs.data(), *y = ys.data(), *w = ws.data(), *h = hs.data();
+        const qreal *c = cs.data(), *s = ss.data();
+        const bool pointNull = p.isNull();
+
+        // Bitwise & keeps the loop free of branches.
+        for (int i = 0; i < n; ++i) {
+            const qreal dx = p.x() - (x[i] + w[i]/2);
+            const qreal dy = p.y() - (y[i] + h[i]/2);
+            const bool inside = (qAbs(dx * c[i] - dy * s[i]) <= qAbs(w[i]) / 2)
+                    & (qAbs(dx * s[i] + dy * c[i]) <= qAbs(h[i]) / 2);
+            result[i] = inside & !pointNull & ((w[i] != 0) | (h[i] != 0));
+        }
+    }
+
+    /*!
+        \fn void ZQRectFArray::intersects(const ZQPreparedShape &shape, bool *result) const
+
+        Writes to \c{result[i]} whether the rectangle at index \c i
+        intersects the \a shape, as ZQPreparedShape::intersects() decides.
+        Rectangles whose bounding rectangle misses the one of the \a shape
+        are rejected without preparing them. \a result must have room for
+        size() values.
+    */
+
+    void ZQRectFArray::intersects(const ZQPreparedShape &shape, bool *result) const noexcept
+    {
+        intersectsBatch(RectView{*this}, shape, result);
+    }
+
+    /*!
+        \fn void ZQRectFArray::boundingRects(qreal *left, qreal *top, qreal *right, qreal *bottom) const
+
+        Writes the axis aligned bounding rectangle of every rotated
+        rectangle to the \a left, \a top, \a right and \a bottom arrays,
+        each of which must have room for size() values.
+    */
+
+    void ZQRectFArray::boundingRects(qreal *left, qreal *top, qreal *right, qreal *bottom) const noexcept
+    {
+        boundsBatch(RectView{*this}, left, top, right, bottom);
+    }
+
+    /*!
+        \fn QRectF ZQRectFArray::boundingRect() const
+
+        Returns the axis aligned rectangle that bounds all rotated
+        rectangles, or a null rectangle if the array is empty.
+    */
+
+    QRectF ZQRectFArray::boundingRect() const noexcept
+    {
+        return unitedBounds(RectView{*this});
+    }
+
+
+    /*!
+        \class ZQEllipseFArray
+        \inmodule Zgeometry
+        \ingroup painting
+
+        \brief The ZQEllipseFArray class stores ellipses as a structure of
+        arrays for batch processing.
+
+        The layout and the batch functions are those of ZQRectFArray,
+        applied to the bounding rectangles and angles of ellipses.
+
+        \sa ZQRectFArray, ZQTriFArray
+    */
+
+    /*!
+        \fn ZQEllipseFArray::ZQEllipseFArray(const QVector<ZQEllipseF> &ellipses)
+
+        Constructs an array holding copies of the \a ellipses.
+    */
+
+    ZQEllipseFArray::ZQEllipseFArray(const QVector<ZQEllipseF> &ellipses)
+    {
+        reserve(ellipses.size());
+        for (const ZQEllipseF &e : ellipses)
+            append(e);
+    }
+
+    /*!
+        \fn void ZQEllipseFArray::reserve(int size)
+
+        Allocates room for at least \a size ellipses.
+    */
+
+    void ZQEllipseFArray::reserve(int size)
+    {
+        for (ZQRealBuffer *b : { &xs, &ys, &ws, &hs, &as, &cs, &ss })
+            b->reserve(size);
+    }
+
+    /*!
+        \fn void ZQEllipseFArray::clear()
+
+        Removes all ellipses, keeping the allocated memory.
+    */
+
+    void ZQEllipseFArray::clear() noexcept
+    {
+        for (ZQRealBuffer *b : { &xs, &ys, &ws, &hs, &as, &cs, &ss })
+            b->clear();
+    }
+
+    /*!
+        \fn void ZQEllipseFArray::append(const ZQEllipseF &ellipse)
+
+        Appends the \a ellipse to the array.
+    */
+
+    void ZQEllipseFArray::append(const ZQEllipseF &e)
+    {
+        xs.append(e.x());
+        ys.append(e.y());
+        ws.append(e.width());
+        hs.append(e.height());
+        as.append(normalizedAngle(e.angle()));
+        cs.append(0);
+        ss.append(0);
+        cacheAngle(as[size() - 1], cs[size() - 1], ss[size() - 1]);
+    }
+
+    /*!
+        \fn void ZQEllipseFArray::replace(int i, const ZQEllipseF &ellipse)
+
+        Replaces the ellipse at index \a i with \a ellipse. \a i must be a
+        valid index.
+    */
+
+    void ZQEllipseFArray::replace(int i, const ZQEllipseF &e) noexcept
+    {
+        xs[i] = e.x();
+        ys[i] = e.y();
+        ws[i] = e.width();
+        hs[i] = e.height();
+        as[i] = normalizedAngle(e.angle());
+        cacheAngle(as[i], cs[i], ss[i]);
+    }
+
+    /*!
+        \fn ZQEllipseF ZQEllipseFArray::at(int i) const
+
+        Returns the ellipse at index \a i. \a i must be a valid index.
+    */
+
+    ZQEllipseF ZQEllipseFArray::at(int i) const noexcept
+    {
+        return ZQEllipseF(xs[i], ys[i], ws[i], hs[i], as[i]);
+    }
+
+    /*!
+        \fn QVector<ZQEllipseF> ZQEllipseFArray::toVector() const
+
+        Returns the ellipses as a vector of ZQEllipseF.
+    */
+
+    QVector<ZQEllipseF> ZQEllipseFArray::toVector() const
+    {
+        QVector<ZQEllipseF> result;
+        result.reserve(size());
+        for (int i = 0; i < size(); ++i)
+            result.append(at(i));
+        return result;
+    }
+
+    /*!
+        \fn void ZQEllipseFArray::translate(qreal dx, qreal dy)
+
+        Moves every ellipse \a dx along the x axis and \a dy along the y
+        axis.
+    */
+
+    void ZQEllipseFArray::translate(qreal dx, qreal dy) noexcept
+    {
+        offset(xs.data(), size(), dx);
+        offset(ys.data(), size(), dy);
+    }
+
+    /*!
+        \fn void ZQEllipseFArray::rotate(qreal da)
+
+        Rotates every ellipse by \a da degrees about its center.
+    */
+
+    void ZQEllipseFArray::rotate(qreal da) noexcept
+    {
+        rotateAngles(as.data(), cs.data(), ss.data(), size(), da);
+    }
+
+    /*!
+        \fn void ZQEllipseFArray::contains(const QPointF &point, bool *result) const
+
+        Writes to \c{result[i]} whether the ellipse at index \c i contains
+        the \a point, with the same answers as ZQEllipseF::contains().
+        \a result must have room for size() values.
+    */
+
+    void ZQEllipseFArray::contains(const QPointF &p, bool *result) const noexcept
+    {
+        const int n = size();
+        const qreal *x = xs.data(), *y = ys.data(), *w = ws.data(), *h = hs.data();
+        const qreal *c = cs.data(), *s = ss.data();
+
+        // A zero radius divides by zero below; the radius test masks the
+        // resulting infinity or NaN out without a branch.
+        for (int i = 0; i < n; ++i) {
+            const qreal rx = qAbs(w[i] / 2);
+            const qreal ry = qAbs(h[i] / 2);
+            const qreal dx = p.x() - (x[i] + w[i]/2);
+            const qreal dy = p.y() - (y[i] + h[i]/2);
+            const qreal lx = (c[i] * dx - s[i] * dy) / rx;
+            const qreal ly = (s[i] * dx + c[i] * dy) / ry;
+            result[i] = (lx * lx + ly * ly <= 1) & (rx > 0) & (ry > 0);
+        }
+    }
+
+    /*!
+        \fn void ZQEllipseFArray::intersects(const ZQPreparedShape &shape, bool *result) const
+
+        Writes to \c{result[i]} whether the ellipse at index \c i
+        intersects the \a shape, as ZQPreparedShape::intersects() decides.
+        Ellipses whose bounding rectangle misses the one of the \a shape
+        are rejected without preparing them. \a result must have room for
+        size() values.
+    */
+
+    void ZQEllipseFArray::intersects(const ZQPreparedShape &shape, bool *result) const noexcept
+    {
+        intersectsBatch(EllipseView{*this}, shape, result);
+    }
+
+    /*!
+        \fn void ZQEllipseFArray::boundingRects(qreal *left, qreal *top, qreal *right, qreal *bottom) const
+
+        Writes the axis aligned bounding rectangle of every rotated ellipse
+        to the \a left, \a top, \a right and \a bottom arrays, each of which
+        must have room for size() values.
+    */
+
+    void ZQEllipseFArray::boundingRects(qreal *left, qreal *top, qreal *right, qreal *bottom) const noexcept
+    {
+        boundsBatch(EllipseView{*this}, left, top, right, bottom);
+    }
+
+    /*!
+        \fn QRectF ZQEllipseFArray::boundingRect() const
+
+        Returns the axis aligned rectangle that bounds all rotated
+        ellipses, or a null rectangle if the array is empty.
+    */
+
+    QRectF ZQEllipseFArray::boundingRect() const noexcept
+    {
+        return unitedBounds(EllipseView{*this});
+    }
+
+
+    /*!
+        \class ZQTriFArray
+        \inmodule Zgeometry
+        \ingroup painting
+
+        \brief The ZQTriFArray class stores triangles as a structure of
+        arrays for batch processing.
+
+        The six vertex coordinates and the angle of every triangle are kept
+        in separate contiguous arrays aligned to 64 bytes, together with the
+        sine and cosine of every angle. The rotated vertices are computed on
+        the fly by the batch functions.
+
+        \sa ZQRectFArray, ZQEllipseFArray
+    */
+
+    /*!
+        \fn ZQTriFArray::ZQTriFArray(const QVector<ZQTriF> &triangles)
+
+        Constructs an array holding copies of the \a triangles.
+    */
+
+    ZQTriFArray::ZQTriFArray(const QVector<ZQTriF> &triangles)
+    {
+        reserve(triangles.size());
+        for (const ZQTriF &t : triangles)
+            append(t);
+    }
+
+    /*!
+        \fn void ZQTriFArray::reserve(int size)
+
+        Allocates room for at least \a size triangles.
+    */
+
+    void ZQTriFArray::reserve(int size)
+    {
+        for (ZQRealBuffer *b : { &x1s, &y1s, &x2s, &y2s, &x3s, &y3s, &as, &cs, &ss })
+            b->reserve(size);
+    }
+
+    /*!
+        \fn void ZQTriFArray::clear()
+
+        Removes all triangles, keeping the allocated memory.
+    */
+
+    void ZQTriFArray::clear() noexcept
+    {
+        for (ZQRealBuffer *b : { &x1s, &y1s, &x2s, &y2s, &x3s, &y3s, &as, &cs, &ss })
+            b->clear();
+    }
+
+    /*!
+        \fn void ZQTriFArray::append(const ZQTriF &triangle)
+
+        Appends the \a triangle to the array.
+    */
+
+    void ZQTriFArray::append(const ZQTriF &t)
+    {
+        x1s.append(t.x1());
+        y1s.append(t.y1());
+        x2s.append(t.x2());
+        y2s.append(t.y2());
+        x3s.append(t.x3());
+        y3s.append(t.y3());
+        as.append(normalizedAngle(t.angle()));
+        cs.append(0);
+        ss.append(0);
+        cacheAngle(as[size() - 1], cs[size() - 1], ss[size() - 1]);
+    }
+
+    /*!
+        \fn void ZQTriFArray::replace(int i, const ZQTriF &triangle)
+
+        Replaces the triangle at index \a i with \a triangle. \a i must be a
+        valid index.
+    */
+
+    void ZQTriFArray::replace(int i, const ZQTriF &t) noexcept
+    {
+        x1s[i] = t.x1();
+        y1s[i] = t.y1();
+        x2s[i] = t.x2();
+        y2s[i] = t.y2();
+        x3s[i] = t.x3();
+        y3s[i] = t.y3();
+        as[i] = normalizedAngle(t.angle());
+        cacheAngle(as[i], cs[i], ss[i]);
+    }
+
+    /*!
+        \fn ZQTriF ZQTriFArray::at(int i) const
+
+        Returns the triangle at index \a i. \a i must be a valid index.
+    */
+
+    ZQTriF ZQTriFArray::at(int i) const noexcept
+    {
+        return ZQTriF(x1s[i], y1s[i], x2s[i], y2s[i], x3s[i], y3s[i], as[i]);
+    }
+
+    /*!
+        \fn QVector<ZQTriF> ZQTriFArray::toVector() const
+
+        Returns the triangles as a vector of ZQTriF.
+    */
+
+    QVector<ZQTriF> ZQTriFArray::toVector() const
+    {
+        QVector<ZQTriF> result;
+        result.reserve(size());
+        for (int i = 0; i < size(); ++i)
+            result.append(at(i));
+        return result;
+    }
+
+    /*!
+        \fn void ZQTriFArray::translate(qreal dx, qreal dy)
+
+        Moves every triangle \a dx along the x axis and \a dy along the y
+        axis.
+    */
+
+    void ZQTriFArray::translate(qreal dx, qreal dy) noexcept
+    {
+        const int n = size();
+        offset(x1s.data(), n, dx);
+        offset(y1s.data(), n, dy);
+        offset(x2s.data(), n, dx);
+        offset(y2s.data(), n, dy);
+        offset(x3s.data(), n, dx);
+        offset(y3s.data(), n, dy);
+    }
+
+    /*!
+        \fn void ZQTriFArray::rotate(qreal da)
+
+        Rotates every triangle by \a da degrees about its center.
+    */
+
+    void ZQTriFArray::rotate(qreal da) noexcept
+    {
+        rotateAngles(as.data(), cs.data(), ss.data(), size(), da);
+    }
+
+    /*!
+        \fn void ZQTriFArray::contains(const QPointF &point, bool *result) const
+
+        Writes to \c{result[i]} whether the triangle at index \c i contains
+        the \a point, with the same answers as ZQTriF::contains(). \a result
+        must have room for size() values.
+    */
+
+    void ZQTriFArray::contains(const QPointF &p, bool *result) const noexcept
+    {
+        const int n = size();
+        const qreal *x1 = x1s.data(), *y1 = y1s.data(), *x2 = x2s.data(), *y2 = y2s.data();
+        const qreal *x3 = x3s.data(), *y3 = y3s.data(), *a = as.data(), *c = cs.data(), *s = ss.data();
+        const bool pointNull = p.isNull();
+
+        for (int i = 0; i < n; ++i) {
+            const qreal cx = (x1[i] + x2[i] + x3[i]) / 3;
+            const qreal cy = (y1[i] + y2[i] + y3[i]) / 3;
+            const qreal d1x = x1[i] - cx, d1y = y1[i] - cy;
+            const qreal d2x = x2[i] - cx, d2y = y2[i] - cy;
+            const qreal d3x = x3[i] - cx, d3y = y3[i] - cy;
+            const qreal v1x = cx + c[i]*d1x + s[i]*d1y, v1y = cy - s[i]*d1x + c[i]*d1y;
+            const qreal v2x = cx + c[i]*d2x + s[i]*d2y, v2y = cy - s[i]*d2x + c[i]*d2y;
+            const qreal v3x = cx + c[i]*d3x + s[i]*d3y, v3y = cy - s[i]*d3x + c[i]*d3y;
+
+            const qreal o1 = (v2x - v1x) * (p.y() - v1y) - (v2y - v1y) * (p.x() - v1x);
+            const qreal o2 = (v3x - v2x) * (p.y() - v2y) - (v3y - v2y) * (p.x() - v2x);
+            const qreal o3 = (v1x - v3x) * (p.y() - v3y) - (v1y - v3y) * (p.x() - v3x);
+            const bool neg = (o1 < 0) | (o2 < 0) | (o3 < 0);
+            const bool pos = (o1 > 0) | (o2 > 0) | (o3 > 0);
+            const bool null = (x1[i] == 0) & (x2[i] == 0) & (x3[i] == 0) & (y1[i] == 0)
+                    & (y2[i] == 0) & (y3[i] == 0) & (a[i] == 0);
+            result[i] = !(neg & pos) & !pointNull & !null;
+        }
+    }
+
+    /*!
+        \fn void ZQTriFArray::intersects(const ZQPreparedShape &shape, bool *result) const
+
+        Writes to \c{result[i]} whether the triangle at index \c i
+        intersects the \a shape, as ZQPreparedShape::intersects() decides.
+        Triangles whose bounding rectangle misses the one of the \a shape
+        are rejected without preparing them. \a result must have room for
+        size() values.
+    */
+
+    void ZQTriFArray::intersects(const ZQPreparedShape &shape, bool *result) const noexcept
+    {
+        intersectsBatch(TriView{*this}, shape, result);
+    }
+
+    /*!
+        \fn void ZQTriFArray::boundingRects(qreal *left, qreal *top, qreal *right, qreal *bottom) const
+
+        Writes the axis aligned bounding rectangle of every rotated
+        triangle to the \a left, \a top, \a right and \a bottom arrays,
+        each of which must have room for size() values.
+    */
+
+    void ZQTriFArray::boundingRects(qreal *left, qreal *top, qreal *right, qreal *bottom) const noexcept
+    {
+        boundsBatch(TriView{*this}, left, top, right, bottom);
+    }
+
+    /*!
+        \fn QRectF ZQTriFArray::boundingRect() const
+
+        Returns the axis aligned rectangle that bounds all rotated
+        triangles, or a null rectangle if the array is empty.
+    */
+
+    QRectF ZQTriFArray::boundingRect() const noexcept
+    {
+        return unitedBounds(TriView{*this});
+    }
+
+}
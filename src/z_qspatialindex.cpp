@@ -0,0 +1,455 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#include "z_qspatialindex.h"
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
+#include <boost/geometry.hpp>
+#include <boost/geometry/geometries/box.hpp>
+#include <boost/geometry/geometries/point.hpp>
+#include <boost/geometry/index/rtree.hpp>
+#include <boost/iterator/function_output_iterator.hpp>
+
+
+namespace z_qtshapes {
+
+    namespace {
+
+        namespace bg = boost::geometry;
+        namespace bgi = boost::geometry::index;
+
+        typedef bg::model::point<qreal, 2, bg::cs::cartesian> IndexPoint;
+        typedef bg::model::box<IndexPoint> IndexBox;
+        typedef std::pair<IndexBox, ZQSpatialIndex::Id> IndexValue;
+        typedef bgi::rtree<IndexValue, bgi::rstar<16> > IndexTree;
+
+        struct Entry {
+            ZQPreparedShape shape;
+            IndexBox box;
+        };
+
+        inline IndexBox toBox(const QRectF &r) noexcept
+        {
+            return IndexBox(IndexPoint(qMin(r.left(), r.right()), qMin(r.top(), r.bottom())),
+                            IndexPoint(qMax(r.left(), r.right()), qMax(r.top(), r.bottom())));
+        }
+
+        inline QRectF toRect(const IndexBox &b) noexcept
+        {
+            return QRectF(b.min_corner().get<0>(), b.min_corner().get<1>(),
+                          b.max_corner().get<0>() - b.min_corner().get<0>(),
+                          b.max_corner().get<1>() - b.min_corner().get<1>());
+        }
+
+        inline Entry makeEntry(const ZQPreparedShape &s) noexcept
+        {
+            return Entry{ s, toBox(s.boundingRect()) };
+        }
+
+        inline qreal boxDistance(const IndexBox &b, const QPointF &p) noexcept
+        {
+            const qreal dx = qMax(qMax(b.min_corner().get<0>() - p.x(), p.x() - b.max_corner().get<0>()), qreal(0));
+            const qreal dy = qMax(qMax(b.min_corner().get<1>() - p.y(), p.y() - b.max_corner().get<1>()), qreal(0));
+            return qSqrt(dx * dx + dy * dy);
+        }
+
+        const ZQPreparedShape nullShape;
+
+    }
+
+    class ZQSpatialIndex::Private {
+    public:
+        Private() : count(0) {}
+
+        Id allocate(const Entry &e)
+        {
+            Id id;
+            if (!freeIds.empty()) {
+                id = freeIds.back();
+                freeIds.pop_back();
+                entries[id] = e;
+            } else {
+                id = Id(entries.size());
+                entries.push_back(e);
+            }
+            ++count;
+            return id;
+        }
+
+        Id insert(const ZQPreparedShape &s)
+        {
+            const Entry e = makeEntry(s);
+            const Id id = allocate(e);
+            tree.insert(IndexValue(e.box, id));
+            return id;
+        }
+
+        bool update(Id id, const ZQPreparedShape &s)
+        {
+            if (!valid(id))
+                return false;
+            tree.remove(IndexValue(entries[id].box, id));
+            entries[id] = makeEntry(s);
+            tree.insert(IndexValue(entries[id].box, id));
+            return true;
+        }
+
+        bool valid(Id id) const noexcept
+        {
+            return id >= 0 && id < Id(entries.size()) && !entries[id].shape.isNull();
+        }
+
+        std::vector<Entry> entries;
+        std::vector<Id> freeIds;
+        int count;
+        IndexTree tree;
+    };
+
+
+    /*!
+        \class ZQSpatialIndex
+        \inmodule Zgeometry
+        \ingroup painting
+
+        \brief The ZQSpatialIndex class answers region, point and nearest
+        neighbour queries over a mixed set of shapes.
+
+        Shapes of every ZQ type are stored as a ZQPreparedShape and keyed
+        by their rotated, axis aligned bounding rectangles in an R-tree.
+        Queries walk the tree to collect candidates and then run the exact
+        predicate on the candidates only, so the result matches a linear
+        scan over the shapes.
+
+        Static scenes should be loaded with bulkLoad(), which packs the
+        tree in one pass. Dynamic scenes use insert(), update() and
+        remove(); call rebuild() after many changes to repack the tree.
+
+        Each stored shape is identified by the Id returned when it is
+        added. Ids of removed shapes are reused by later insertions.
+    */
+
+    /*!
+        \fn ZQSpatialIndex::ZQSpatialIndex()
+
+        Constructs an empty spatial index.
+    */
+
+    ZQSpatialIndex::ZQSpatialIndex() : d(new Private)
+    {
+    }
+
+    ZQSpatialIndex::~ZQSpatialIndex() = default;
+
+    /*!
+        \fn ZQSpatialIndex::ZQSpatialIndex(ZQSpatialIndex &&other)
+
+        Move-constructs a spatial index from \a other, taking over its
+        shapes, their ids and any staged changes. \a other is left with no
+        shapes, and the ids it hands out start from zero again. Its fresh
+        tree is allocated, so this constructor may throw std::bad_alloc.
+    */
+
+    ZQSpatialIndex::ZQSpatialIndex(ZQSpatialIndex &&other) : d(std::move(other.d))
+    {
+        other.d.reset(new Private);
+    }
+
+    ZQSpatialIndex &ZQSpatialIndex::operator=(ZQSpatialIndex &&other) noexcept
+    {
+        std::swap(d, other.d);
+        return *this;
+    }
+
+    /*!
+        \fn ZQSpatialIndex::Id ZQSpatialIndex::insert(const ZQPreparedShape &shape)
+
+        Adds the \a shape to the index and returns its Id. Any ZQ shape
+        converts to a ZQPreparedShape implicitly. The shape is copied; later
+        changes to it are not seen by the index until update() is called.
+        A null shape is not added and -1 is returned.
+    */
+
+    ZQSpatialIndex::Id ZQSpatialIndex::insert(const ZQPreparedShape &shape)
+    {
+        if (shape.isNull())
+            return -1;
+        return d->insert(shape);
+    }
+
+    /*!
+        \fn void ZQSpatialIndex::bulkLoad(InputIterator first, InputIterator last, QVector<Id> *ids)
+
+        Adds every shape in the range [\a first, \a last) and then packs
+        the whole tree with rebuild(). This is much faster than inserting
+        the shapes one by one. If \a ids is not null, the Id of each shape
+        is appended to it in order, with -1 for null shapes, which are
+        skipped as by insert().
+
+        Mixed scenes can call bulkLoad() once per shape type; each call
+        repacks all shapes stored so far.
+    */
+
+    ZQSpatialIndex::Id ZQSpatialIndex::stage(const ZQPreparedShape &shape)
+    {
+        if (shape.isNull())
+            return -1;
+        return d->allocate(makeEntry(shape));
+    }
+
+    /*!
+        \fn bool ZQSpatialIndex::update(Id id, const ZQPreparedShape &shape)
+
+        Replaces the shape stored under \a id with \a shape and moves
+        it in the tree. The shape type may change. Updating to a null shape
+        takes the old one out of the tree and frees \a id, as remove()
+        does. Returns \c false if \a id does not refer to a stored shape.
+    */
+
+    bool ZQSpatialIndex::update(Id id, const ZQPreparedShape &shape)
+    {
+        if (shape.isNull())
+            return remove(id);
+        return d->update(id, shape);
+    }
+
+    /*!
+        \fn bool ZQSpatialIndex::remove(Id id)
+
+        Removes the shape stored under \a id. Returns \c false if \a id
+        does not refer to a stored shape.
+    */
+
+    bool ZQSpatialIndex::remove(Id id)
+    {
+        if (!d->valid(id))
+            return false;
+
+        d->tree.remove(IndexValue(d->entries[id].box, id));
+        d->entries[id].shape = ZQPreparedShape();
+        d->freeIds.push_back(id);
+        --d->count;
+        return true;
+    }
+
+    /*!
+        \fn void ZQSpatialIndex::clear()
+
+        Removes all shapes from the index. Ids start from zero again.
+    */
+
+    void ZQSpatialIndex::clear()
+    {
+        d.reset(new Private);
+    }
+
+    /*!
+        \fn void ZQSpatialIndex::rebuild()
+
+        Packs the tree again from all stored shapes using the bulk loading
+        algorithm of the R-tree, which sorts the rectangles into tiles in
+        the manner of Sort-Tile-Recursive packing. Ids are preserved.
+    */
+
+    void ZQSpatialIndex::rebuild()
+    {
+        std::vector<IndexValue> values;
+        values.reserve(d->count);
+        for (std::size_t i = 0; i < d->entries.size(); ++i) {
+            if (!d->entries[i].shape.isNull())
+                values.push_back(IndexValue(d->entries[i].box, Id(i)));
+        }
+        IndexTree packed(values.begin(), values.end());
+        d->tree.swap(packed);
+    }
+
+    /*!
+        \fn bool ZQSpatialIndex::contains(Id id) const
+
+        Returns \c true if \a id refers to a stored shape.
+    */
+
+    bool ZQSpatialIndex::contains(Id id) const noexcept
+    {
+        return d->valid(id);
+    }
+
+    /*!
+        \fn const ZQPreparedShape &ZQSpatialIndex::shape(Id id) const
+
+        Returns the prepared shape stored under \a id, or a null shape.
+    */
+
+    const ZQPreparedShape &ZQSpatialIndex::shape(Id id) const noexcept
+    {
+        return d->valid(id) ? d->entries[id].shape : nullShape;
+    }
+
+    /*!
+        \fn ZQPreparedShape::ShapeType ZQSpatialIndex::shapeType(Id id) const
+
+        Returns the type of the shape stored under \a id, or
+        ZQPreparedShape::NoShape.
+    */
+
+    ZQPreparedShape::ShapeType ZQSpatialIndex::shapeType(Id id) const noexcept
+    {
+        return shape(id).type();
+    }
+
+    /*!
+        \fn QRectF ZQSpatialIndex::boundingRect(Id id) const
+
+        Returns the axis aligned bounding rectangle of the rotated shape
+        stored under \a id, or a null rectangle if there is none.
+    */
+
+    QRectF ZQSpatialIndex::boundingRect(Id id) const noexcept
+    {
+        return d->valid(id) ? toRect(d->entries[id].box) : QRectF();
+    }
+
+    /*!
+        \fn QRectF ZQSpatialIndex::boundingRect() const
+        \overload
+
+        Returns the bounding rectangle of all stored shapes.
+    */
+
+    QRectF ZQSpatialIndex::boundingRect() const noexcept
+    {
+        return d->tree.empty() ? QRectF() : toRect(d->tree.bounds());
+    }
+
+    /*!
+        \fn int ZQSpatialIndex::size() const
+
+        Returns the number of stored shapes.
+    */
+
+    int ZQSpatialIndex::size() const noexcept
+    {
+        return d->count;
+    }
+
+    /*!
+        \fn QVector<ZQSpatialIndex::Id> ZQSpatialIndex::intersecting(const QRectF &region) const
+
+        Returns the Ids of all shapes that touch or overlap \a region. The
+        exact shape is tested, not only its bounding rectangle.
+    */
+
+    QVector<ZQSpatialIndex::Id> ZQSpatialIndex::intersecting(const QRectF &region) const
+    {
+        QVector<Id> result;
+        intersecting(region, result);
+        return result;
+    }
+
+    /*!
+        \fn void ZQSpatialIndex::intersecting(const QRectF &region, QVector<Id> &result) const
+        \overload
+
+        Replaces the contents of \a result with the Ids of all shapes that
+        touch or overlap \a region. The capacity of \a result is kept, so a
+        caller that runs many queries can reuse one vector for all of them
+        instead of allocating a new one per query.
+    */
+
+    void ZQSpatialIndex::intersecting(const QRectF &region, QVector<Id> &result) const
+    {
+        result.resize(0);
+        d->tree.query(bgi::intersects(toBox(region)) && bgi::satisfies([&](const IndexValue &v) {
+            return d->entries[v.second].shape.intersects(region);
+        }), boost::make_function_output_iterator([&](const IndexValue &v) { result.append(v.second); }));
+    }
+
+    /*!
+        \fn QVector<ZQSpatialIndex::Id> ZQSpatialIndex::within(const QRectF &region) const
+
+        Returns the Ids of all shapes that lie entirely inside \a region.
+        The stored bounding rectangles are tight, so no exact test is
+        needed.
+    */
+
+    QVector<ZQSpatialIndex::Id> ZQSpatialIndex::within(const QRectF &region) const
+    {
+        QVector<Id> result;
+        d->tree.query(bgi::covered_by(toBox(region)),
+                boost::make_function_output_iterator([&](const IndexValue &v) { result.append(v.second); }));
+        return result;
+    }
+
+    /*!
+        \fn QVector<ZQSpatialIndex::Id> ZQSpatialIndex::containing(const QPointF &point) const
+
+        Returns the Ids of all shapes that contain \a point, including
+        shapes that have it on their edge.
+    */
+
+    QVector<ZQSpatialIndex::Id> ZQSpatialIndex::containing(const QPointF &point) const
+    {
+        QVector<Id> result;
+        d->tree.query(bgi::intersects(IndexPoint(point.x(), point.y())) && bgi::satisfies([&](const IndexValue &v) {
+            return d->entries[v.second].shape.contains(point);
+        }), boost::make_function_output_iterator([&](const IndexValue &v) { result.append(v.second); }));
+        return result;
+    }
+
+    /*!
+        \fn QVector<ZQSpatialIndex::Id> ZQSpatialIndex::nearest(const QPointF &point, int k) const
+
+        Returns the Ids of the \a k shapes closest to \a point, ordered by
+        increasing distance(). Shapes containing the point have a distance
+        of zero.
+
+        Candidates are visited in order of the distance to their bounding
+        rectangle, which never exceeds the exact distance, so the search
+        stops as soon as no remaining candidate can improve the result.
+    */
+
+    QVector<ZQSpatialIndex::Id> ZQSpatialIndex::nearest(const QPointF &point, int k) const
+    {
+        QVector<Id> result;
+        if (k <= 0 || d->tree.empty())
+            return result;
+
+        typedef std::pair<qreal, Id> Candidate;
+        std::vector<Candidate> best;
+        best.reserve(k + 1);
+        const IndexPoint p(point.x(), point.y());
+        for (IndexTree::const_query_iterator it = d->tree.qbegin(bgi::nearest(p, unsigned(d->tree.size())));
+                it != d->tree.qend(); ++it) {
+            if (int(best.size()) == k && boxDistance(it->first, point) > best.front().first)
+                break;
+            best.push_back(Candidate(d->entries[it->second].shape.distance(point), it->second));
+            std::push_heap(best.begin(), best.end());
+            if (int(best.size()) > k) {
+                std::pop_heap(best.begin(), best.end());
+                best.pop_back();
+            }
+        }
+
+        std::sort_heap(best.begin(), best.end());
+        result.reserve(int(best.size()));
+        for (const Candidate &c : best)
+            result.append(c.second);
+        return result;
+    }
+
+    /*!
+        \fn qreal ZQSpatialIndex::distance(Id id, const QPointF &point) const
+
+        Returns the Euclidean distance from \a point to the shape stored
+        under \a id, or zero if the point is inside the shape. Returns
+        infinity if \a id does not refer to a stored shape.
+    */
+
+    qreal ZQSpatialIndex::distance(Id id, const QPointF &point) const noexcept
+    {
+        return shape(id).distance(point);
+    }
+
+}
@@ -0,0 +1,82 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#include "z_qsweep.h"
+#include "z_qparallel.h"
+#include <QAtomicInt>
+
+
+namespace z_qtshapes {
+
+    namespace {
+
+        // Everything the shape covers during the motion: it stays within
+        // its bounding radius of a center moving on a straight line.
+        QRectF sweptRect(const ZQPreparedShape &shape, const ZQMotion &motion) noexcept
+        {
+            const QPointF c = rotationCenter(shape);
+            if (motion.angle == 0)
+                return shape.boundingRect() | shape.boundingRect().translated(motion.translation);
+            const qreal r = boundingRadius(shape, c);
+            const QRectF start(c.x() - r, c.y() - r, 2 * r, 2 * r);
+            return start | start.translated(motion.translation);
+        }
+
+    }
+
+    /*!
+        \fn void timesOfImpact(const ZQPreparedShape *movers, const ZQMotion *motions, int count, const ZQSpatialIndex &obstacles, ZQTimeOfImpact *results, ZQSpatialIndex::Id *hits, QThreadPool *pool, qreal tolerance)
+        \relates ZQSpatialIndex
+
+        Sweeps each of the \a count shapes in \a movers along the matching
+        entry of \a motions through the static shapes in \a obstacles, and
+        stores the earliest time of impact with any of them in \a results.
+        If \a hits is not null, it receives the Id of the obstacle that is
+        hit first, or -1 when the mover gets through the step untouched.
+
+        Only the obstacles that touch the rectangle a mover sweeps over are
+        tested, and each test stops as soon as it is past the earliest
+        impact found so far for that mover. Movers are spread over \a pool;
+        with a null \a pool everything runs on the calling thread. A null
+        mover never hits anything.
+
+        \sa timeOfImpact()
+    */
+
+    void timesOfImpact(const ZQPreparedShape *movers, const ZQMotion *motions, int count,
+                       const ZQSpatialIndex &obstacles, ZQTimeOfImpact *results, ZQSpatialIndex::Id *hits,
+                       QThreadPool *pool, qreal tolerance)
+    {
+        const int chunk = 16;
+        QAtomicInt next(0);
+        auto work = [&]() {
+            // One candidate buffer per thread, reused for all its movers.
+            QVector<ZQSpatialIndex::Id> candidates;
+            int first;
+            while ((first = next.fetchAndAddRelaxed(chunk)) < count) {
+                const int last = qMin(first + chunk, count);
+                for (int i = first; i < last; ++i) {
+                    ZQTimeOfImpact &best = results[i];
+                    best.hit = false;
+                    best.time = 1;
+                    best.iterations = 0;
+                    ZQSpatialIndex::Id hit = -1;
+                    if (!movers[i].isNull()) {
+                        obstacles.intersecting(sweptRect(movers[i], motions[i]), candidates);
+                        for (ZQSpatialIndex::Id id : candidates) {
+                            const ZQTimeOfImpact r = sweep_detail::advance(movers[i], motions[i], obstacles.shape(id),
+                                                                           ZQMotion(), best.time, tolerance, 64);
+                            if (r.hit && (!best.hit || r.time < best.time)) {
+                                best = r;
+                                hit = id;
+                            }
+                        }
+                    }
+                    if (hits)
+                        hits[i] = hit;
+                }
+            }
+        };
+        runOnPool(pool, pool ? qMin((count + chunk - 1) / chunk, pool->maxThreadCount()) : 1, work);
+    }
+
+}
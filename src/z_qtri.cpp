@@ -39,6 +39,7 @@
 ****************************************************************************/
 
 #include "z_qtri.h"
+#include "z_qpointkernels.h"
 #include <boost/geometry.hpp>
 #include <boost/geometry/geometries/register/point.hpp>
 BOOST_GEOMETRY_REGISTER_POINT_2D_GET_SET(QPointF, qreal, boost::geometry::cs::cartesian, x, y, setX, setY);
@@ -46,6 +47,77 @@ BOOST_GEOMETRY_REGISTER_POINT_2D_GET_SET(QPointF, qreal, boost::geometry::cs::ca
 
 namespace z_qtshapes {
 
+    namespace {
+
+        // Twice the signed area of the triangle (a, b, c). Positive when the
+        // points turn counter-clockwise in a y-up coordinate system.
+        inline qreal orientation(const QPointF &a, const QPointF &b, const QPointF &c) noexcept
+        {
+            return (b.x() - a.x()) * (c.y() - a.y()) - (b.y() - a.y()) * (c.x() - a.x());
+        }
+
+        // Orientation test against all three edges; works for either winding.
+        // If proper is true, points on an edge are not inside. A triangle
+        // with collinear vertices is the segment between the outer two, so
+        // a point on its supporting line is only inside within that span.
+        inline bool triangleContainsPoint(const QPointF v[3], const QPointF &p, bool proper) noexcept
+        {
+            const qreal d1 = orientation(v[0], v[1], p);
+            const qreal d2 = orientation(v[1], v[2], p);
+            const qreal d3 = orientation(v[2], v[0], p);
+            if (proper)
+                return (d1 > 0 && d2 > 0 && d3 > 0) || (d1 < 0 && d2 < 0 && d3 < 0);
+            if (d1 == 0 && d2 == 0 && d3 == 0) {
+                const qreal x1 = qMin(v[0].x(), qMin(v[1].x(), v[2].x()));
+                const qreal x2 = qMax(v[0].x(), qMax(v[1].x(), v[2].x()));
+                const qreal y1 = qMin(v[0].y(), qMin(v[1].y(), v[2].y()));
+                const qreal y2 = qMax(v[0].y(), qMax(v[1].y(), v[2].y()));
+                return x1 <= p.x() && p.x() <= x2 && y1 <= p.y() && p.y() <= y2;
+            }
+            const bool neg = d1 < 0 || d2 < 0 || d3 < 0;
+            const bool pos = d1 > 0 || d2 > 0 || d3 > 0;
+            return !(neg && pos);
+        }
+
+        // Closed segment test; touching end points and colinear overlaps count.
+        inline bool segmentsIntersect(const QPointF &p1, const QPointF &p2, const QPointF &q1, const QPointF &q2) noexcept
+        {
+            const qreal d1 = orientation(q1, q2, p1);
+            const qreal d2 = orientation(q1, q2, p2);
+            const qreal d3 = orientation(p1, p2, q1);
+            const qreal d4 = orientation(p1, p2, q2);
+            if (((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0)))
+                return true;
+
+            auto onSegment = [](const QPointF &a, const QPointF &b, const QPointF &c) {
+                return qMin(a.x(), b.x()) <= c.x() && c.x() <= qMax(a.x(), b.x())
+                        && qMin(a.y(), b.y()) <= c.y() && c.y() <= qMax(a.y(), b.y());
+            };
+            return (d1 == 0 && onSegment(q1, q2, p1)) || (d2 == 0 && onSegment(q1, q2, p2))
+                    || (d3 == 0 && onSegment(p1, p2, q1)) || (d4 == 0 && onSegment(p1, p2, q2));
+        }
+
+        // Two triangles intersect if any pair of edges crosses or if one
+        // triangle lies entirely within the other.
+        inline bool trianglesIntersect(const QPointF a[3], const QPointF b[3]) noexcept
+        {
+            for (int i = 0; i < 3; ++i)
+                for (int j = 0; j < 3; ++j)
+                    if (segmentsIntersect(a[i], a[(i+1)%3], b[j], b[(j+1)%3]))
+                        return true;
+            return triangleContainsPoint(a, b[0], false) || triangleContainsPoint(b, a[0], false);
+        }
+
+        // A triangle is convex, so it contains another one exactly when it
+        // contains all three of its vertices.
+        inline bool triangleContainsTriangle(const QPointF a[3], const QPointF b[3], bool proper) noexcept
+        {
+            return triangleContainsPoint(a, b[0], proper) && triangleContainsPoint(a, b[1], proper)
+                    && triangleContainsPoint(a, b[2], proper);
+        }
+
+    }
+
     /*!
         \class ZQTri
         \inmodule Zgeometry
@@ -905,10 +977,7 @@ namespace z_qtshapes {
         if (isNull() || p.isNull())
             return false;
 
-        const QPainterPath path1 = toPath();
-
-        return path1.contains(p);
-
+        return prepared().contains(QPointF(p));
     }
 
 
@@ -945,43 +1014,56 @@ namespace z_qtshapes {
         if (isNull() || r.isNull())
             return false;
 
-        const QPainterPath path1 = toPath();
-        const QPainterPath path2 = r.toPath();
+        return prepared().contains(r.prepared(), proper);
+    }
 
-        if (proper && path1 == path2) {
+    /*!
+        \fn bool ZQTri::contains(const ZQPreparedTriF &triangle, bool proper) const
+        \overload
+
+        Returns \c true if the given prepared \a triangle is inside this
+        triangle, otherwise returns \c false. If \a proper is true, this
+        function only returns \c true if the \a triangle is entirely inside
+        this triangle (not on the edge).
+
+        \sa prepared()
+    */
+
+    bool ZQTri::contains(const ZQPreparedTriF &r, bool proper) const noexcept
+    {
+        if (isNull())
             return false;
-        }
-        return path1.contains(path2);
+
+        return prepared().contains(r, proper);
     }
 
     /*!
-        \fn QPainterPath ZQTri::operator|(const ZQTri &triangle) const
+        \fn ZQPolygonF ZQTri::operator|(const ZQTri &triangle) const
 
-        Returns the bounding triangle of this triangle and the given \a
-        triangle. The result will always have an angle of 0 degrees.
+        Returns the union of this triangle and the given \a triangle as a
+        ZQPolygonF. Overlapping triangles give one contour, disjoint ones
+        two. Both are rotated by their own angles; no QPainterPath is
+        built, call ZQPolygonF::toPath() for one.
 
-        \sa united()
+        \sa united(), ZQPolygonF::convexUnited()
     */
 
-    QPainterPath ZQTri::operator|(const ZQTri &r) const noexcept
+    ZQPolygonF ZQTri::operator|(const ZQTri &r) const noexcept
     {
         if (isNull())
-            return r.toPath();
+            return r.toPolygon();
         if (r.isNull())
-            return toPath();
+            return toPolygon();
 
-        const QPainterPath path1 = toPath();
-        const QPainterPath path2 = r.toPath();
-
-        return path1.united(path2);
+        return toPolygon().convexUnited(r.toPolygon());
     }
 
     /*!
-        \fn QPainterPath ZQTri::united(const ZQTri &triangle) const
+        \fn ZQPolygonF ZQTri::united(const ZQTri &triangle) const
         \since 4.2
 
-        Returns the bounding triangle of this triangle and the given \a triangle.
-        The result will always have an angle of 0 degrees.
+        Returns the union of this triangle and the given \a triangle.
+        Note that \c{r.united(s)} is equivalent to \c{r | s}.
 
         \image qtri-unite.png
 
@@ -990,32 +1072,30 @@ namespace z_qtshapes {
 
 
     /*!
-        \fn QPainterPath ZQTri::operator&(const ZQTri &triangle) const
+        \fn ZQPolygonF ZQTri::operator&(const ZQTri &triangle) const
 
-        Returns the intersection of this triangle and the given \a
-        triangle. Returns an empty triangle if there is no intersection.
-        The angle of the intersected triangle will always be 0 degrees.
+        Returns the intersection of this triangle and the given \a triangle
+        as a ZQPolygonF holding a single convex contour, or an empty
+        polygon if they do not overlap. The intersection is computed by
+        convex polygon clipping; no QPainterPath is built.
 
-        \sa intersected()
+        \sa intersected(), ZQPolygonF::convexIntersected()
     */
 
-    QPainterPath ZQTri::operator&(const ZQTri &r) const noexcept
+    ZQPolygonF ZQTri::operator&(const ZQTri &r) const noexcept
     {
         if (isNull())
-            return r.toPath();
+            return r.toPolygon();
         if (r.isNull())
-            return toPath();
-
-        const QPainterPath path1 = toPath();
-        const QPainterPath path2 = r.toPath();
+            return toPolygon();
 
-        return path1.intersected(path2);
+        return toPolygon().convexIntersected(r.toPolygon());
 
     }
 
 
     /*!
-        \fn QPainterPath ZQTri::intersected(const ZQTri &triangle) const
+        \fn ZQPolygonF ZQTri::intersected(const ZQTri &triangle) const
         \since 4.2
 
         Returns the intersection of this triangle and the given \a
@@ -1023,7 +1103,7 @@ namespace z_qtshapes {
 
         \image qtri-intersect.png
 
-        \sa intersects(), united()()
+        \sa intersects(), united()
     */
 
     /*!
@@ -1036,15 +1116,33 @@ namespace z_qtshapes {
         The intersectio triangle can be retrieved using the intersected()
         function.
 
+        Both triangles are rotated about their centers and tested edge
+        against edge, followed by a vertex-in-triangle test to catch the
+        case where one triangle lies entirely within the other. Both
+        triangles are closed, as for every shape predicate, so triangles
+        that only touch along an edge or at a vertex intersect.
+
         \sa contains()
     */
 
     bool ZQTri::intersects(const ZQTri &r) const noexcept
     {
-        const QPainterPath path1 = toPath();
-        const QPainterPath path2 = r.toPath();
+        return prepared().intersects(r.prepared());
+    }
+
+    /*!
+        \fn bool ZQTri::intersects(const ZQPreparedTriF &triangle) const
+        \overload
 
-        return path1.intersects(path2);
+        Returns \c true if this triangle intersects with the given prepared
+        \a triangle, otherwise returns \c false.
+
+        \sa prepared()
+    */
+
+    bool ZQTri::intersects(const ZQPreparedTriF &r) const noexcept
+    {
+        return prepared().intersects(r);
     }
 
     /*!
@@ -1094,58 +1192,72 @@ namespace z_qtshapes {
 
     QPainterPath ZQTri::toPath() const noexcept
     {
-        QPainterPath path;
-        QPointF c1 = QPointF(first());
-        QPointF c2 = QPointF(second());
-        QPointF c3 = QPointF(third());
-        QPointF cn = QPointF(center());
-
-        QPointF c1a, c2a, c3a;
-        boost::geometry::strategy::transform::rotate_transformer<boost::geometry::degree, qreal, 2, 2> rotate(angle());
-        boost::geometry::transform(c1 - cn, c1a, rotate);
-        boost::geometry::transform(c2 - cn, c2a, rotate);
-        boost::geometry::transform(c3 - cn, c3a, rotate);
-        c1a += cn;
-        c2a += cn;
-        c3a += cn;
-
-        path.moveTo(c1);
-        path.lineTo(c2);
-        path.lineTo(c3);
-        path.lineTo(c1);
-        path.closeSubpath();
-        return path;
+        return prepared().toPath();
     }
 
     QPainterPath ZQTri::toPath(const QMatrix3x3 &mat, const QPointF& ref) const noexcept
     {
-        QPainterPath path;
-        QPointF c1 = QPointF(first());
-        QPointF c2 = QPointF(second());
-        QPointF c3 = QPointF(third());
-        QPointF cn = QPointF(center());
-
-        QPointF c1a, c2a, c3a;
-        boost::geometry::strategy::transform::rotate_transformer<boost::geometry::degree, qreal, 2, 2> rotate(angle());
-        boost::geometry::transform(c1 - cn, c1a, rotate);
-        boost::geometry::transform(c2 - cn, c2a, rotate);
-        boost::geometry::transform(c3 - cn, c3a, rotate);
-        c1a += cn;
-        c2a += cn;
-        c3a += cn;
-
-        QPointF c1r, c2r, c3r;
-        boost::geometry::strategy::transform::matrix_transformer<float, 2, 2>project2D(mat(0,0), mat(0,1), mat(0,2), mat(1,0), mat(1,1), mat(1,2), mat(2,0), mat(2,1), mat(2,2));
-        boost::geometry::transform(c1a - ref, c1r, project2D);
-        boost::geometry::transform(c2a - ref, c2r, project2D);
-        boost::geometry::transform(c3a - ref, c3r, project2D);
-
-        path.moveTo(c1 + ref);
-        path.lineTo(c2 + ref);
-        path.lineTo(c3 + ref);
-        path.lineTo(c1 + ref);
-        path.closeSubpath();
-        return path;
+        return prepared().toPath(mat, ref);
+    }
+
+    /*!
+        \fn ZQPolygonF ZQTri::toPolygon() const
+
+        Returns the rotated outline as a ZQPolygonF with one contour.
+
+        \sa toPath()
+    */
+
+    ZQPolygonF ZQTri::toPolygon() const noexcept
+    {
+        return prepared().toPolygon();
+    }
+
+    /*!
+        \fn ZQPreparedTriF ZQTri::prepared() const
+
+        Returns a prepared form of this triangle with its vertices rotated
+        about center() and its axis aligned bounding rectangle computed
+        once. Keep the result around when the same triangle is queried many
+        times between modifications.
+
+        \sa ZQPreparedTriF
+    */
+
+    ZQPreparedTriF ZQTri::prepared() const noexcept
+    {
+        return ZQPreparedTriF(QPointF(first()), QPointF(second()), QPointF(third()), QPointF(center()), angle());
+    }
+
+    /*!
+        \fn QRectF ZQTri::boundingRectF() const
+
+        Returns the axis aligned bounding rectangle of the triangle with its
+        vertices rotated about center(), without building a path.
+
+        \sa boundingRect()
+    */
+
+    QRectF ZQTri::boundingRectF() const noexcept
+    {
+        qreal c, s;
+        angleCosSin(angle(), &c, &s);
+        const QPointF points[3] = { QPointF(first()), QPointF(second()), QPointF(third()) };
+        return rotatedBounds(points, 3, QPointF(center()), c, s);
+    }
+
+    /*!
+        \fn QRect ZQTri::boundingRect() const
+
+        Returns the smallest integer rectangle that contains
+        boundingRectF().
+
+        \sa boundingRectF()
+    */
+
+    QRect ZQTri::boundingRect() const noexcept
+    {
+        return boundingRectF().toAlignedRect();
     }
 
     /*****************************************************************************
@@ -2049,10 +2161,7 @@ namespace z_qtshapes {
         if (isNull() || p.isNull())
             return false;
 
-        const QPainterPath path1 = toPath();
-
-        return path1.contains(p);
-
+        return prepared().contains(p);
     }
 
 
@@ -2089,43 +2198,56 @@ namespace z_qtshapes {
         if (isNull() || r.isNull())
             return false;
 
-        const QPainterPath path1 = toPath();
-        const QPainterPath path2 = r.toPath();
+        return prepared().contains(r.prepared(), proper);
+    }
+
+    /*!
+        \fn bool ZQTriF::contains(const ZQPreparedTriF &triangle, bool proper) const
+        \overload
+
+        Returns \c true if the given prepared \a triangle is inside this
+        triangle, otherwise returns \c false. If \a proper is true, this
+        function only returns \c true if the \a triangle is entirely inside
+        this triangle (not on the edge).
+
+        \sa prepared()
+    */
 
-        if (proper && path1 == path2) {
+    bool ZQTriF::contains(const ZQPreparedTriF &r, bool proper) const noexcept
+    {
+        if (isNull())
             return false;
-        }
-        return path1.contains(path2);
+
+        return prepared().contains(r, proper);
     }
 
     /*!
-        \fn QPainterPath ZQTriF::operator|(const ZQTriF &triangle) const
+        \fn ZQPolygonF ZQTriF::operator|(const ZQTriF &triangle) const
 
-        Returns the bounding triangle of this triangle and the given \a
-        triangle. The result will always have an angle of 0 degrees.
+        Returns the union of this triangle and the given \a triangle as a
+        ZQPolygonF. Overlapping triangles give one contour, disjoint ones
+        two. Both are rotated by their own angles; no QPainterPath is
+        built, call ZQPolygonF::toPath() for one.
 
-        \sa united()
+        \sa united(), ZQPolygonF::convexUnited()
     */
 
-    QPainterPath ZQTriF::operator|(const ZQTriF &r) const noexcept
+    ZQPolygonF ZQTriF::operator|(const ZQTriF &r) const noexcept
     {
         if (isNull())
-            return r.toPath();
+            return r.toPolygon();
         if (r.isNull())
-            return toPath();
+            return toPolygon();
 
-        const QPainterPath path1 = toPath();
-        const QPainterPath path2 = r.toPath();
-
-        return path1.united(path2);
+        return toPolygon().convexUnited(r.toPolygon());
     }
 
     /*!
-        \fn QPainterPath ZQTriF::united(const ZQTriF &triangle) const
+        \fn ZQPolygonF ZQTriF::united(const ZQTriF &triangle) const
         \since 4.2
 
-        Returns the bounding triangle of this triangle and the given \a triangle.
-        The result will always have an angle of 0 degrees.
+        Returns the union of this triangle and the given \a triangle.
+        Note that \c{r.united(s)} is equivalent to \c{r | s}.
 
         \image qtri-unite.png
 
@@ -2134,32 +2256,30 @@ namespace z_qtshapes {
 
 
     /*!
-        \fn ZQTri ZQTri::operator&(const ZQTri &triangle) const
+        \fn ZQPolygonF ZQTriF::operator&(const ZQTriF &triangle) const
 
-        Returns the intersection of this triangle and the given \a
-        triangle. Returns an empty triangle if there is no intersection.
-        The angle of the intersected triangle will always be 0 degrees.
+        Returns the intersection of this triangle and the given \a triangle
+        as a ZQPolygonF holding a single convex contour, or an empty
+        polygon if they do not overlap. The intersection is computed by
+        convex polygon clipping; no QPainterPath is built.
 
-        \sa intersected()
+        \sa intersected(), ZQPolygonF::convexIntersected()
     */
 
-    QPainterPath ZQTriF::operator&(const ZQTriF &r) const noexcept
+    ZQPolygonF ZQTriF::operator&(const ZQTriF &r) const noexcept
     {
         if (isNull())
-            return r.toPath();
+            return r.toPolygon();
         if (r.isNull())
-            return toPath();
+            return toPolygon();
 
-        const QPainterPath path1 = toPath();
-        const QPainterPath path2 = r.toPath();
-
-        return path1.intersected(path2);
+        return toPolygon().convexIntersected(r.toPolygon());
 
     }
 
 
     /*!
-        \fn QPainterPath ZQTriF::intersected(const ZQTriF &triangle) const
+        \fn ZQPolygonF ZQTriF::intersected(const ZQTriF &triangle) const
         \since 4.2
 
         Returns the intersection of this triangle and the given \a
@@ -2167,7 +2287,7 @@ namespace z_qtshapes {
 
         \image qtri-intersect.png
 
-        \sa intersects(), united()()
+        \sa intersects(), united()
     */
 
     /*!
@@ -2180,15 +2300,33 @@ namespace z_qtshapes {
         The intersectio triangle can be retrieved using the intersected()
         function.
 
+        Both triangles are rotated about their centers and tested edge
+        against edge, followed by a vertex-in-triangle test to catch the
+        case where one triangle lies entirely within the other. Both
+        triangles are closed, as for every shape predicate, so triangles
+        that only touch along an edge or at a vertex intersect.
+
         \sa contains()
     */
 
     bool ZQTriF::intersects(const ZQTriF &r) const noexcept
     {
-        const QPainterPath path1 = toPath();
-        const QPainterPath path2 = r.toPath();
+        return prepared().intersects(r.prepared());
+    }
+
+    /*!
+        \fn bool ZQTriF::intersects(const ZQPreparedTriF &triangle) const
+        \overload
+
+        Returns \c true if this triangle intersects with the given prepared
+        \a triangle, otherwise returns \c false.
+
+        \sa prepared()
+    */
 
-        return path1.intersects(path2);
+    bool ZQTriF::intersects(const ZQPreparedTriF &r) const noexcept
+    {
+        return prepared().intersects(r);
     }
 
     /*!
@@ -2240,58 +2378,86 @@ namespace z_qtshapes {
 
     QPainterPath ZQTriF::toPath() const noexcept
     {
-        QPainterPath path;
-        QPointF c1 = first();
-        QPointF c2 = second();
-        QPointF c3 = third();
-        QPointF cn = center();
-
-        QPointF c1a, c2a, c3a;
-        boost::geometry::strategy::transform::rotate_transformer<boost::geometry::degree, qreal, 2, 2> rotate(angle());
-        boost::geometry::transform(c1 - cn, c1a, rotate);
-        boost::geometry::transform(c2 - cn, c2a, rotate);
-        boost::geometry::transform(c3 - cn, c3a, rotate);
-        c1a += cn;
-        c2a += cn;
-        c3a += cn;
-
-        path.moveTo(c1);
-        path.lineTo(c2);
-        path.lineTo(c3);
-        path.lineTo(c1);
-        path.closeSubpath();
-        return path;
+        return prepared().toPath();
     }
 
     QPainterPath ZQTriF::toPath(const QMatrix3x3 &mat, const QPointF& ref) const noexcept
     {
-        QPainterPath path;
-        QPointF c1 = first();
-        QPointF c2 = second();
-        QPointF c3 = third();
-        QPointF cn = center();
-
-        QPointF c1a, c2a, c3a;
-        boost::geometry::strategy::transform::rotate_transformer<boost::geometry::degree, qreal, 2, 2> rotate(angle());
-        boost::geometry::transform(c1 - cn, c1a, rotate);
-        boost::geometry::transform(c2 - cn, c2a, rotate);
-        boost::geometry::transform(c3 - cn, c3a, rotate);
-        c1a += cn;
-        c2a += cn;
-        c3a += cn;
-
-        QPointF c1r, c2r, c3r;
-        boost::geometry::strategy::transform::matrix_transformer<float, 2, 2>project2D(mat(0,0), mat(0,1), mat(0,2), mat(1,0), mat(1,1), mat(1,2), mat(2,0), mat(2,1), mat(2,2));
-        boost::geometry::transform(c1a - ref, c1r, project2D);
-        boost::geometry::transform(c2a - ref, c2r, project2D);
-        boost::geometry::transform(c3a - ref, c3r, project2D);
-
-        path.moveTo(c1 + ref);
-        path.lineTo(c2 + ref);
-        path.lineTo(c3 + ref);
-        path.lineTo(c1 + ref);
-        path.closeSubpath();
-        return path;
+        return prepared().toPath(mat, ref);
+    }
+
+    /*!
+        \fn ZQPolygonF ZQTriF::toPolygon() const
+
+        Returns the rotated outline as a ZQPolygonF with one contour.
+
+        \sa toPath()
+    */
+
+    ZQPolygonF ZQTriF::toPolygon() const noexcept
+    {
+        return prepared().toPolygon();
+    }
+
+    /*!
+        \fn ZQPreparedTriF ZQTriF::prepared() const
+
+        Returns a prepared form of this triangle with its vertices rotated
+        about center() and its axis aligned bounding rectangle computed
+        once. Keep the result around when the same triangle is queried many
+        times between modifications.
+
+        \sa ZQPreparedTriF
+    */
+
+    ZQPreparedTriF ZQTriF::prepared() const noexcept
+    {
+        return ZQPreparedTriF(first(), second(), third(), center(), angle());
+    }
+
+    /*!
+        \fn QRectF ZQTriF::boundingRect() const
+
+        Returns the axis aligned bounding rectangle of the triangle with its
+        vertices rotated about center(), without building a path.
+
+        \sa prepared()
+    */
+
+    QRectF ZQTriF::boundingRect() const noexcept
+    {
+        qreal c, s;
+        angleCosSin(angle(), &c, &s);
+        const QPointF points[3] = { first(), second(), third() };
+        return rotatedBounds(points, 3, center(), c, s);
+    }
+
+    /*!
+        \fn int ZQTriF::tessellationVertexCount(qreal tolerance) const
+
+        Returns the number of vertices tessellate() writes, which is always
+        3.
+    */
+
+    /*!
+        \fn int ZQTriF::tessellationIndexCount(qreal tolerance) const
+
+        Returns the number of indices tessellate() writes, which is always
+        3.
+    */
+
+    /*!
+        \fn void ZQTriF::tessellate(qreal tolerance, float *vertices, quint32 *indices, quint32 baseVertex) const
+
+        Writes the rotated triangle as one indexed triangle into
+        \a vertices and \a indices.
+
+        \sa ZQPreparedTriF::tessellate()
+    */
+
+    void ZQTriF::tessellate(qreal tolerance, float *vertices, quint32 *indices, quint32 baseVertex) const noexcept
+    {
+        prepared().tessellate(tolerance, vertices, indices, baseVertex);
     }
 
     /*!
@@ -2364,4 +2530,212 @@ namespace z_qtshapes {
     }
     #endif
 
+
+    /*!
+        \class ZQPreparedTriF
+        \inmodule Zgeometry
+        \ingroup painting
+        \reentrant
+
+        \brief The ZQPreparedTriF class holds a rotated triangle in a form
+        that is ready for repeated queries.
+
+        A ZQPreparedTriF is created with ZQTri::prepared() or
+        ZQTriF::prepared(). It stores the rotated vertices, the sine and
+        cosine of the angle and the axis aligned bounding rectangle, so that
+        contains(), intersects() and toPath() do not evaluate any
+        trigonometric functions. The object is immutable; prepare the
+        triangle again after modifying it.
+    */
+
+    /*!
+        \fn ZQPreparedTriF::ZQPreparedTriF(const QPointF &first, const QPointF &second, const QPointF &third, const QPointF &rotationCenter, qreal angle)
+
+        Constructs the prepared form of the triangle with the vertices
+        \a first, \a second and \a third, rotated by \a angle degrees about
+        \a rotationCenter.
+    */
+
+    ZQPreparedTriF::ZQPreparedTriF(const QPointF &first, const QPointF &second, const QPointF &third,
+            const QPointF &rotationCenter, qreal angle) noexcept
+    {
+        qreal c, s;
+        angleCosSin(angle, &c, &s);
+        *this = ZQPreparedTriF(first, second, third, rotationCenter, angle, c, s);
+    }
+
+    /*!
+        \fn ZQPreparedTriF::ZQPreparedTriF(const QPointF &first, const QPointF &second, const QPointF &third, const QPointF &rotationCenter, qreal angle, qreal cosAngle, qreal sinAngle)
+        \overload
+
+        Constructs the prepared triangle with \a cosAngle and \a sinAngle
+        as the cosine and sine of \a angle, for callers that keep them
+        cached already. They are used as given.
+    */
+
+    ZQPreparedTriF::ZQPreparedTriF(const QPointF &first, const QPointF &second, const QPointF &third,
+            const QPointF &rotationCenter, qreal angle, qreal cosAngle, qreal sinAngle) noexcept
+        : ca(cosAngle), sa(sinAngle), a(angle)
+    {
+        const QPointF in[3] = { first - rotationCenter, second - rotationCenter, third - rotationCenter };
+        for (int i = 0; i < 3; ++i)
+            v[i] = QPointF(rotationCenter.x() + ca*in[i].x() + sa*in[i].y(),
+                           rotationCenter.y() - sa*in[i].x() + ca*in[i].y());
+
+        bx1 = qMin(v[0].x(), qMin(v[1].x(), v[2].x()));
+        by1 = qMin(v[0].y(), qMin(v[1].y(), v[2].y()));
+        bx2 = qMax(v[0].x(), qMax(v[1].x(), v[2].x()));
+        by2 = qMax(v[0].y(), qMax(v[1].y(), v[2].y()));
+    }
+
+    /*!
+        \fn bool ZQPreparedTriF::contains(const QPointF &point, bool proper) const
+
+        Returns \c true if the given \a point is inside or on the edge of
+        the triangle, otherwise returns \c false. If \a proper is true, points
+        on the edge are not inside. A triangle whose vertices are collinear
+        only contains the segment they span, and has no inside points.
+    */
+
+    bool ZQPreparedTriF::contains(const QPointF &p, bool proper) const noexcept
+    {
+        if (p.x() < bx1 || p.x() > bx2 || p.y() < by1 || p.y() > by2)
+            return false;
+
+        return triangleContainsPoint(v, p, proper);
+    }
+
+    /*!
+        \fn bool ZQPreparedTriF::contains(const ZQPreparedTriF &triangle, bool proper) const
+
+        Returns \c true if every vertex of the given \a triangle lies inside
+        this triangle, otherwise returns \c false. If \a proper is true, the
+        vertices must not lie on the edge of this triangle.
+    */
+
+    bool ZQPreparedTriF::contains(const ZQPreparedTriF &r, bool proper) const noexcept
+    {
+        if (r.bx1 < bx1 || r.bx2 > bx2 || r.by1 < by1 || r.by2 > by2)
+            return false;
+
+        return triangleContainsTriangle(v, r.v, proper);
+    }
+
+    /*!
+        \fn bool ZQPreparedTriF::intersects(const ZQPreparedTriF &triangle) const
+
+        Returns \c true if this triangle and the given \a triangle touch or
+        overlap, otherwise returns \c false. Like every shape predicate
+        the triangles are closed, so sharing an edge or a vertex is
+        enough. The bounding rectangles are compared before any edge is
+        tested.
+    */
+
+    bool ZQPreparedTriF::intersects(const ZQPreparedTriF &r) const noexcept
+    {
+        if (r.bx1 > bx2 || r.bx2 < bx1 || r.by1 > by2 || r.by2 < by1)
+            return false;
+
+        return trianglesIntersect(v, r.v);
+    }
+
+    /*!
+        \fn QPainterPath ZQPreparedTriF::toPath() const
+
+        Converts the triangle into a QPainterPath using the cached vertices.
+    */
+
+    QPainterPath ZQPreparedTriF::toPath() const noexcept
+    {
+        QPainterPath path;
+        path.moveTo(v[0]);
+        path.lineTo(v[1]);
+        path.lineTo(v[2]);
+        path.lineTo(v[0]);
+        path.closeSubpath();
+        return path;
+    }
+
+    /*!
+        \fn ZQPolygonF ZQPreparedTriF::toPolygon() const
+
+        Returns the cached vertices as a ZQPolygonF with one contour.
+    */
+
+    ZQPolygonF ZQPreparedTriF::toPolygon() const noexcept
+    {
+        return ZQPolygonF(v, 3);
+    }
+
+    /*!
+        \fn QPainterPath ZQPreparedTriF::toPath(const QMatrix3x3 &mat, const QPointF &ref) const
+
+        Transforms the triangle about the point \a ref using the
+        transformation matrix \a mat and then converts it into a
+        QPainterPath.
+    */
+
+    QPainterPath ZQPreparedTriF::toPath(const QMatrix3x3 &mat, const QPointF& ref) const noexcept
+    {
+        QPainterPath path;
+        qreal x[3], y[3];
+        for (int i = 0; i < 3; ++i) {
+            x[i] = v[i].x();
+            y[i] = v[i].y();
+        }
+        transformPoints(ZQPointTransform(mat, ref), x, y, x, y, 3);
+
+        path.moveTo(x[0], y[0]);
+        path.lineTo(x[1], y[1]);
+        path.lineTo(x[2], y[2]);
+        path.lineTo(x[0], y[0]);
+        path.closeSubpath();
+        return path;
+    }
+
+    /*!
+        \fn int ZQPreparedTriF::tessellationVertexCount(qreal tolerance) const
+
+        Returns the number of vertices tessellate() writes, which is always
+        3. \a tolerance is accepted so that every shape has the same
+        interface.
+    */
+
+    /*!
+        \fn int ZQPreparedTriF::tessellationIndexCount(qreal tolerance) const
+
+        Returns the number of indices tessellate() writes, which is always
+        3.
+    */
+
+    /*!
+        \fn void ZQPreparedTriF::tessellate(qreal tolerance, float *vertices, quint32 *indices, quint32 baseVertex) const
+
+        Writes the rotated vertices into \a vertices, as interleaved x and y
+        coordinates, and one triangle into \a indices. \a baseVertex is
+        added to every index; pass the number of vertices already in the
+        buffer. \a tolerance is unused, as the triangle is represented
+        exactly.
+
+        The indices are ordered so that the triangle has a positive signed
+        area whichever order its vertices were given in, the same winding
+        the other shapes use.
+    */
+
+    void ZQPreparedTriF::tessellate(qreal tolerance, float *vertices, quint32 *indices,
+            quint32 baseVertex) const noexcept
+    {
+        Q_UNUSED(tolerance);
+        for (int i = 0; i < 3; ++i) {
+            vertices[2*i] = float(v[i].x());
+            vertices[2*i + 1] = float(v[i].y());
+        }
+
+        const qreal cross = (v[1].x() - v[0].x()) * (v[2].y() - v[0].y())
+                - (v[1].y() - v[0].y()) * (v[2].x() - v[0].x());
+        indices[0] = baseVertex;
+        indices[1] = baseVertex + (cross < 0 ? 2 : 1);
+        indices[2] = baseVertex + (cross < 0 ? 1 : 2);
+    }
+
 }
@@ -0,0 +1,578 @@
+// Copyright (c) 2020 Ali Sherief. All rights reserved.
+
+#include "z_qvertexbatch.h"
+#include "z_aligned.h"
+#include "z_qpointkernels.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+
+namespace z_qtshapes {
+
+    namespace {
+
+        static_assert(sizeof(ZQVertexBatch::Vertex) == 12, "ZQVertexBatch::Vertex must be tightly packed");
+
+        // The part of the vertex and index buffers owned by one shape. A
+        // shape that needs fewer elements than its slot holds pads the rest
+        // with degenerate triangles, so it can be re-emitted in place.
+        struct Slot {
+            int firstVertex;
+            int vertexCapacity;
+            int firstIndex;
+            int indexCapacity;
+        };
+
+        void tessellationCounts(const ZQPreparedShape &s, qreal tolerance, int *vertexCount, int *indexCount) noexcept
+        {
+            switch (s.type()) {
+            case ZQPreparedShape::RectShape:
+                *vertexCount = s.rect().tessellationVertexCount(tolerance);
+                *indexCount = s.rect().tessellationIndexCount(tolerance);
+                break;
+            case ZQPreparedShape::TriShape:
+                *vertexCount = s.tri().tessellationVertexCount(tolerance);
+                *indexCount = s.tri().tessellationIndexCount(tolerance);
+                break;
+            case ZQPreparedShape::EllipseShape:
+                *vertexCount = s.ellipse().tessellationVertexCount(tolerance);
+                *indexCount = s.ellipse().tessellationIndexCount(tolerance);
+                break;
+            case ZQPreparedShape::LineShape:
+                *vertexCount = ZQLineF().strokeVertexCount();
+                *indexCount = ZQLineF().strokeIndexCount();
+                break;
+            default:
+                *vertexCount = 0;
+                *indexCount = 0;
+                break;
+            }
+        }
+
+        // Appends [first, first + count) to ranges, merging it with the last
+        // range when they are adjacent.
+        void appendRange(QVector<ZQVertexBatch::Range> &ranges, int first, int count)
+        {
+            if (count <= 0)
+                return;
+            if (!ranges.isEmpty() && ranges.last().first + ranges.last().count == first)
+                ranges.last().count += count;
+            else
+                ranges.append(ZQVertexBatch::Range{ first, count });
+        }
+
+        const ZQPreparedShape nullShape;
+
+    }
+
+    class ZQVertexBatch::Private {
+    public:
+        Private() : count(0), layoutValid(true), tolerance(0.25), shapeTolerance(0.25), lineWidth(1) {}
+
+        bool valid(Id id) const noexcept
+        {
+            return id >= 0 && id < Id(shapes.size()) && !shapes[id].isNull();
+        }
+
+        void markDirty(Id id)
+        {
+            if (!dirty[id]) {
+                dirty[id] = true;
+                dirtyIds.push_back(id);
+            }
+        }
+
+        void markAllDirty()
+        {
+            dirtyIds.clear();
+            for (Id id = 0; id < Id(shapes.size()); ++id) {
+                dirty[id] = true;
+                dirtyIds.push_back(id);
+            }
+        }
+
+        // The tolerance in shape coordinates: the view tolerance divided by
+        // the largest stretch of the view's linear part.
+        void updateShapeTolerance()
+        {
+            const qreal a = view(0, 0), b = view(0, 1), c = view(1, 0), e = view(1, 1);
+            const qreal sum = a*a + b*b + c*c + e*e;
+            const qreal det = a*e - b*c;
+            const qreal w = qAbs(view(2, 2)) > 0 ? qAbs(view(2, 2)) : 1;
+            const qreal scale = qSqrt((sum + qSqrt(qMax(qreal(0), sum*sum - 4*det*det))) / 2) / w;
+            shapeTolerance = scale > 0 ? tolerance / scale : tolerance;
+        }
+
+        void layout();
+        void emitShape(Id id);
+
+        std::vector<ZQPreparedShape> shapes;
+        std::vector<Slot> slots;
+        std::vector<bool> dirty;
+        std::vector<Id> dirtyIds;
+        std::vector<Id> freeIds;
+        std::vector<float> scratch;
+        ZQAlignedBuffer<Vertex> vertices;
+        ZQAlignedBuffer<quint32> indices;
+        QVector<Range> updatedVertices;
+        QVector<Range> updatedIndices;
+        QMatrix3x3 view;
+        int count;
+        bool layoutValid;
+        qreal tolerance;
+        qreal shapeTolerance;
+        qreal lineWidth;
+    };
+
+    /*
+     * Counting pass: gives every shape a slot of exactly the size it needs
+     * now and sizes both buffers in one step, so that each is allocated at
+     * most once.
+     */
+    void ZQVertexBatch::Private::layout()
+    {
+        int nv = 0, ni = 0;
+        for (Id id = 0; id < Id(shapes.size()); ++id) {
+            int shapeVertices, shapeIndices;
+            tessellationCounts(shapes[id], shapeTolerance, &shapeVertices, &shapeIndices);
+            slots[id] = Slot{ nv, shapeVertices, ni, shapeIndices };
+            nv += shapeVertices;
+            ni += shapeIndices;
+        }
+        vertices.resize(nv);
+        indices.resize(ni);
+        layoutValid = true;
+    }
+
+    /*
+     * Tessellates the shape into scratch, transforms the vertices by the
+     * view and writes them into the slot of the shape, then pads the rest
+     * of the slot with degenerate triangles.
+     */
+    void ZQVertexBatch::Private::emitShape(Id id)
+    {
+        const Slot &s = slots[id];
+        const ZQPreparedShape &shape = shapes[id];
+        int nv, ni;
+        tessellationCounts(shape, shapeTolerance, &nv, &ni);
+
+        if (scratch.size() < std::size_t(4 * nv))
+            scratch.resize(4 * nv);
+        float *xy = scratch.data();
+        float *x = xy + 2 * nv;
+        float *y = x + nv;
+        quint32 *idx = indices.data() + s.firstIndex;
+
+        switch (shape.type()) {
+        case ZQPreparedShape::RectShape:
+            shape.rect().tessellate(shapeTolerance, xy, idx, quint32(s.firstVertex));
+            break;
+        case ZQPreparedShape::TriShape:
+            shape.tri().tessellate(shapeTolerance, xy, idx, quint32(s.firstVertex));
+            break;
+        case ZQPreparedShape::EllipseShape:
+            shape.ellipse().tessellate(shapeTolerance, xy, idx, quint32(s.firstVertex));
+            break;
+        case ZQPreparedShape::LineShape:
+            ZQLineF(shape.line().p1(), shape.line().p2()).tessellateStroke(lineWidth, xy, idx,
+                    quint32(s.firstVertex));
+            break;
+        default:
+            break;
+        }
+
+        for (int i = 0; i < nv; ++i) {
+            x[i] = xy[2*i];
+            y[i] = xy[2*i + 1];
+        }
+        transformPoints(ZQPointTransform(view), x, y, x, y, nv);
+        Vertex *out = vertices.data() + s.firstVertex;
+        for (int i = 0; i < nv; ++i)
+            out[i] = Vertex{ x[i], y[i], quint32(id) };
+
+        const Vertex pad = nv > 0 ? out[0] : Vertex{ 0, 0, quint32(id) };
+        for (int i = nv; i < s.vertexCapacity; ++i)
+            out[i] = pad;
+        for (int i = ni; i < s.indexCapacity; ++i)
+            idx[i] = quint32(s.firstVertex);
+    }
+
+
+    /*!
+        \class ZQVertexBatch
+        \inmodule Zgeometry
+        \ingroup painting
+
+        \brief The ZQVertexBatch class turns a collection of mixed shapes
+        into one vertex buffer and one index buffer for drawing.
+
+        Every shape is tessellated with its prepared form's tessellate(),
+        transformed by the view matrix and written as interleaved Vertex
+        elements carrying the shape's Id, so that a single
+        glDrawElements(GL_TRIANGLES) call draws the whole collection and a
+        shader can still tell the shapes apart. Lines are stroked with
+        lineWidth().
+
+        build() first counts the vertices and indices of every shape and
+        sizes both buffers once. Afterwards each shape owns a fixed slot of
+        the buffers. Shapes changed with update() or remove() since the
+        last build are re-emitted into their slots, and the touched ranges
+        are reported by updatedVertices() and updatedIndices() so that only
+        those are uploaded again. A shape that no longer fits its slot, an
+        insert() of a new Id, or a change of the view that changes the
+        ellipse segment counts lays the buffers out again.
+    */
+
+    /*!
+        \fn ZQVertexBatch::ZQVertexBatch()
+
+        Constructs an empty batch with the identity view matrix, a
+        tolerance of 0.25 and a line width of 1.
+    */
+
+    ZQVertexBatch::ZQVertexBatch() : d(new Private)
+    {
+    }
+
+    ZQVertexBatch::~ZQVertexBatch() = default;
+
+    /*!
+        \fn ZQVertexBatch::ZQVertexBatch(ZQVertexBatch &&other)
+
+        Move-constructs a batch from \a other, taking over its shapes and
+        its vertex and index buffers. Unlike clear(), \a other does not
+        keep its view matrix, tolerance or line width; it gets the defaults
+        of a new batch. Setting those up allocates, so this constructor may
+        throw std::bad_alloc.
+    */
+
+    ZQVertexBatch::ZQVertexBatch(ZQVertexBatch &&other) : d(std::move(other.d))
+    {
+        other.d.reset(new Private);
+    }
+
+    ZQVertexBatch &ZQVertexBatch::operator=(ZQVertexBatch &&other) noexcept
+    {
+        std::swap(d, other.d);
+        return *this;
+    }
+
+    /*!
+        \fn ZQVertexBatch::Id ZQVertexBatch::insert(const ZQPreparedShape &shape)
+
+        Adds the \a shape and returns its Id, which is also the id attribute
+        of its vertices. Any ZQ shape converts to a ZQPreparedShape
+        implicitly. Ids of removed shapes are reused, together with their
+        slots.
+    */
+
+    ZQVertexBatch::Id ZQVertexBatch::insert(const ZQPreparedShape &shape)
+    {
+        Id id;
+        if (!d->freeIds.empty()) {
+            id = d->freeIds.back();
+            d->freeIds.pop_back();
+            d->shapes[id] = shape;
+        } else {
+            id = Id(d->shapes.size());
+            d->shapes.push_back(shape);
+            d->slots.push_back(Slot{ 0, 0, 0, 0 });
+            d->dirty.push_back(false);
+            d->layoutValid = false;
+        }
+        d->markDirty(id);
+        ++d->count;
+        return id;
+    }
+
+    /*!
+        \fn bool ZQVertexBatch::update(Id id, const ZQPreparedShape &shape)
+
+        Replaces the shape stored under \a id with \a shape and marks it
+        for re-emission by the next build(). Returns \c false if \a id does
+        not refer to a stored shape.
+    */
+
+    bool ZQVertexBatch::update(Id id, const ZQPreparedShape &shape)
+    {
+        if (!d->valid(id))
+            return false;
+
+        d->shapes[id] = shape;
+        d->markDirty(id);
+        return true;
+    }
+
+    /*!
+        \fn bool ZQVertexBatch::remove(Id id)
+
+        Removes the shape stored under \a id. The next build() fills its
+        slot with degenerate triangles. Returns \c false if \a id does not
+        refer to a stored shape.
+    */
+
+    bool ZQVertexBatch::remove(Id id)
+    {
+        if (!d->valid(id))
+            return false;
+
+        d->shapes[id] = ZQPreparedShape();
+        d->markDirty(id);
+        d->freeIds.push_back(id);
+        --d->count;
+        return true;
+    }
+
+    /*!
+        \fn void ZQVertexBatch::clear()
+
+        Removes all shapes. Ids start from zero again. The view matrix, the
+        tolerance and the line width are kept.
+    */
+
+    void ZQVertexBatch::clear()
+    {
+        std::unique_ptr<Private> p(new Private);
+        p->view = d->view;
+        p->tolerance = d->tolerance;
+        p->shapeTolerance = d->shapeTolerance;
+        p->lineWidth = d->lineWidth;
+        d = std::move(p);
+    }
+
+    /*!
+        \fn bool ZQVertexBatch::contains(Id id) const
+
+        Returns \c true if \a id refers to a stored shape.
+    */
+
+    bool ZQVertexBatch::contains(Id id) const noexcept
+    {
+        return d->valid(id);
+    }
+
+    /*!
+        \fn const ZQPreparedShape &ZQVertexBatch::shape(Id id) const
+
+        Returns the shape stored under \a id, or a null shape.
+    */
+
+    const ZQPreparedShape &ZQVertexBatch::shape(Id id) const noexcept
+    {
+        return d->valid(id) ? d->shapes[id] : nullShape;
+    }
+
+    /*!
+        \fn int ZQVertexBatch::size() const
+
+        Returns the number of stored shapes.
+    */
+
+    int ZQVertexBatch::size() const noexcept
+    {
+        return d->count;
+    }
+
+    /*!
+        \fn void ZQVertexBatch::setViewMatrix(const QMatrix3x3 &view)
+
+        Sets the matrix that maps shape coordinates to view coordinates.
+        Vertices are transformed as the column vector (x, y, 1) and divided
+        by the resulting w. All shapes are re-emitted by the next build().
+    */
+
+    void ZQVertexBatch::setViewMatrix(const QMatrix3x3 &view)
+    {
+        d->view = view;
+        d->updateShapeTolerance();
+        d->markAllDirty();
+    }
+
+    /*!
+        \fn QMatrix3x3 ZQVertexBatch::viewMatrix() const
+
+        Returns the view matrix.
+    */
+
+    QMatrix3x3 ZQVertexBatch::viewMatrix() const noexcept
+    {
+        return d->view;
+    }
+
+    /*!
+        \fn void ZQVertexBatch::setTolerance(qreal tolerance)
+
+        Sets the largest distance, in view coordinates, between a
+        tessellated ellipse and the true outline. It is divided by the
+        largest stretch of the view matrix before it is passed to
+        tessellate(), so ellipses get more segments as the view zooms in.
+    */
+
+    void ZQVertexBatch::setTolerance(qreal tolerance)
+    {
+        d->tolerance = tolerance;
+        d->updateShapeTolerance();
+        d->markAllDirty();
+    }
+
+    /*!
+        \fn qreal ZQVertexBatch::tolerance() const
+
+        Returns the tolerance in view coordinates.
+    */
+
+    qreal ZQVertexBatch::tolerance() const noexcept
+    {
+        return d->tolerance;
+    }
+
+    /*!
+        \fn void ZQVertexBatch::setLineWidth(qreal width)
+
+        Sets the width, in shape coordinates, that lines are stroked with.
+    */
+
+    void ZQVertexBatch::setLineWidth(qreal width)
+    {
+        d->lineWidth = width;
+        for (Id id = 0; id < Id(d->shapes.size()); ++id)
+            if (d->shapes[id].type() == ZQPreparedShape::LineShape)
+                d->markDirty(id);
+    }
+
+    /*!
+        \fn qreal ZQVertexBatch::lineWidth() const
+
+        Returns the width lines are stroked with.
+    */
+
+    qreal ZQVertexBatch::lineWidth() const noexcept
+    {
+        return d->lineWidth;
+    }
+
+    /*!
+        \fn ZQVertexBatch::BuildResult ZQVertexBatch::build()
+
+        Brings the buffers up to date with the shapes.
+
+        Returns \c Rebuilt if the buffers were laid out again, in which case
+        both have to be uploaded in full; \c Updated if only the shapes
+        changed since the last build were re-emitted into their slots, in
+        which case only updatedVertices() and updatedIndices() have to be
+        uploaded; or \c Unchanged.
+    */
+
+    ZQVertexBatch::BuildResult ZQVertexBatch::build()
+    {
+        d->updatedVertices.clear();
+        d->updatedIndices.clear();
+        if (d->dirtyIds.empty() && d->layoutValid)
+            return Unchanged;
+
+        bool fits = d->layoutValid;
+        for (std::size_t i = 0; fits && i < d->dirtyIds.size(); ++i) {
+            const Id id = d->dirtyIds[i];
+            int nv, ni;
+            tessellationCounts(d->shapes[id], d->shapeTolerance, &nv, &ni);
+            fits = nv <= d->slots[id].vertexCapacity && ni <= d->slots[id].indexCapacity;
+        }
+
+        BuildResult result;
+        if (fits) {
+            for (Id id : d->dirtyIds) {
+                d->emitShape(id);
+                d->dirty[id] = false;
+            }
+            // Ranges are reported in buffer order, which is Id order.
+            std::sort(d->dirtyIds.begin(), d->dirtyIds.end());
+            for (Id id : d->dirtyIds) {
+                const Slot &s = d->slots[id];
+                appendRange(d->updatedVertices, s.firstVertex, s.vertexCapacity);
+                appendRange(d->updatedIndices, s.firstIndex, s.indexCapacity);
+            }
+            result = Updated;
+        } else {
+            d->layout();
+            for (Id id = 0; id < Id(d->shapes.size()); ++id) {
+                d->emitShape(id);
+                d->dirty[id] = false;
+            }
+            appendRange(d->updatedVertices, 0, d->vertices.size());
+            appendRange(d->updatedIndices, 0, d->indices.size());
+            result = Rebuilt;
+        }
+        d->dirtyIds.clear();
+        return result;
+    }
+
+    /*!
+        \fn const ZQVertexBatch::Vertex *ZQVertexBatch::vertexData() const
+
+        Returns the interleaved vertices written by the last build().
+    */
+
+    const ZQVertexBatch::Vertex *ZQVertexBatch::vertexData() const noexcept
+    {
+        return d->vertices.data();
+    }
+
+    /*!
+        \fn int ZQVertexBatch::vertexCount() const
+
+        Returns the number of vertices in vertexData().
+    */
+
+    int ZQVertexBatch::vertexCount() const noexcept
+    {
+        return d->vertices.size();
+    }
+
+    /*!
+        \fn const quint32 *ZQVertexBatch::indexData() const
+
+        Returns the triangle list indices written by the last build().
+    */
+
+    const quint32 *ZQVertexBatch::indexData() const noexcept
+    {
+        return d->indices.data();
+    }
+
+    /*!
+        \fn int ZQVertexBatch::indexCount() const
+
+        Returns the number of indices in indexData().
+    */
+
+    int ZQVertexBatch::indexCount() const noexcept
+    {
+        return d->indices.size();
+    }
+
+    /*!
+        \fn const QVector<ZQVertexBatch::Range> &ZQVertexBatch::updatedVertices() const
+
+        Returns the ranges of vertexData() written by the last build(), in
+        ascending order. Adjacent ranges are merged.
+    */
+
+    const QVector<ZQVertexBatch::Range> &ZQVertexBatch::updatedVertices() const noexcept
+    {
+        return d->updatedVertices;
+    }
+
+    /*!
+        \fn const QVector<ZQVertexBatch::Range> &ZQVertexBatch::updatedIndices() const
+
+        Returns the ranges of indexData() written by the last build(), in
+        ascending order. Adjacent ranges are merged.
+    */
+
+    const QVector<ZQVertexBatch::Range> &ZQVertexBatch::updatedIndices() const noexcept
+    {
+        return d->updatedIndices;
+    }
+
+}
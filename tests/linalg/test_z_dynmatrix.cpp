@@ -0,0 +1,177 @@
+#define BOOST_TEST_MODULE Z_QTShapes_DynMatrix
+#include <boost/test/included/unit_test.hpp>
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "z_linalg.h"
+
+using namespace z_linalg;
+
+namespace {
+
+    // Largest absolute difference between two vectors of the same size.
+    qreal maxDifference(const ZQDynMatrix<qreal> &a, const ZQDynMatrix<qreal> &b)
+    {
+        qreal d = 0;
+        for (int i = 0; i < a.rows(); ++i)
+            d = qMax(d, qAbs(a(a.min_row()+i, a.min_column()) - b(b.min_row()+i, b.min_column())));
+        return d;
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(Z_DynMatrix)
+{
+    // Storage: every column starts on a 64-byte boundary.
+    ZQDynMatrix<qreal> E(13, 5);
+    BOOST_TEST(E.stride() == 16);
+    for (int col = 0; col < E.columns(); ++col)
+        BOOST_TEST(reinterpret_cast<std::uintptr_t>(E.columnData(col)) % 64 == 0);
+    BOOST_TEST(E(12, 4) == 0);
+    ZQDynMatrix<qreal> I(5, 5);
+    I.setToIdentity();
+    BOOST_TEST(I.isIdentity());
+
+    // Arithmetic agrees with ZQMatrix.
+    const std::array<qreal, 6> av = {1, 2, 3, 4, 5, 6};
+    const std::array<qreal, 6> bv = {7, 8, 9, 10, 11, 12};
+    const ZQDynMatrix<qreal> A23(2, 3, av.data()), B32(3, 2, bv.data());
+    const ZQMatrix<2, 3, qreal> FA(av.data());
+    const ZQMatrix<3, 2, qreal> FB(bv.data());
+    const ZQDynMatrix<qreal> P = A23 * B32;
+    const ZQMatrix<2, 2, qreal> FP = FA * FB;
+    for (int row = 0; row < 2; ++row)
+        for (int col = 0; col < 2; ++col)
+            BOOST_TEST(P(row, col) == FP(row, col));
+    BOOST_TEST((A23.transposed().transposed() == A23));
+    BOOST_TEST(((A23 + A23 - A23 * qreal(2))(1, 2) == 0));
+    BOOST_TEST(((-A23 / qreal(2))(1, 2) == -3));
+
+    // A diagonally dominant symmetric system far too large for the stack
+    // as a fixed size matrix, numbered from 0 like ZQMatrix.
+    const int n = 300;
+    ZQDynMatrix<qreal> A(n, n), x(n, 1), b(n, 1);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j <= i; ++j) {
+            const qreal v = qSin(0.37 * i + 1.3 * j) + qCos(0.11 * i * j);
+            A(i, j) = A(j, i) = v;
+        }
+        A(i, i) += 2 * n;
+        x(i, 0) = qCos(0.05 * i) * (i % 7 - 3);
+    }
+    b = A * x;
+
+    std::string error;
+    ZQDynMatrix<qreal> LU(n, n), X;
+    ZQDynMatrix<int> indx(n, 1);
+    qreal d;
+    BOOST_TEST(lu_decomp(A, LU, indx, d, error));
+    BOOST_TEST(lu_backsub(LU, indx, b, X, error));
+    BOOST_TEST(maxDifference(X, x) < 1e-10);
+
+    ZQDynMatrix<qreal> L = A, p(n, 1);
+    BOOST_TEST(chol_decomp(L, p, error));
+    BOOST_TEST(chol_solve(L, p, b, X, error));
+    BOOST_TEST(maxDifference(X, x) < 1e-10);
+
+    ZQDynMatrix<qreal> QR(n, n), c(n, 1), dd(n, 1);
+    int sing;
+    BOOST_TEST(qr_decomp(A, QR, c, dd, sing, error));
+    BOOST_TEST(sing == 0);
+    BOOST_TEST(qr_solve(QR, c, dd, b, X, error));
+    BOOST_TEST(maxDifference(X, x) < 1e-10);
+
+    // SVD of a tall matrix: U * diag(W) * V' gives it back, and the
+    // least squares solution of a consistent system is exact.
+    const int m = 120, k = 80;
+    ZQDynMatrix<qreal> R(m, k), U(m, k), W, V, y(k, 1);
+    for (int i = 0; i < m; ++i)
+        for (int j = 0; j < k; ++j)
+            R(i, j) = qSin(0.7 * i + 0.3 * j * j) + (i == j ? 3 : 0);
+    for (int j = 0; j < k; ++j)
+        y(j, 0) = 1 + 0.01 * j;
+    BOOST_TEST(svd_decomp(R, U, W, V, error));
+    BOOST_TEST(W.rows() == k);
+    ZQDynMatrix<qreal> US = U;
+    for (int j = 0; j < k; ++j)
+        for (int i = 0; i < m; ++i)
+            US(i, j) *= W(j, 0);
+    const ZQDynMatrix<qreal> RR = US * V.transposed();
+    qreal worst = 0;
+    for (int i = 0; i < m; ++i)
+        for (int j = 0; j < k; ++j)
+            worst = qMax(worst, qAbs(RR(i, j) - R(i, j)));
+    BOOST_TEST(worst < 1e-10);
+    const ZQDynMatrix<qreal> Ry = R * y;
+    ZQDynMatrix<qreal> Y;
+    BOOST_TEST(svd_backsub(U, W, V, Ry, Y, qreal(1e-12), error));
+    BOOST_TEST(maxDifference(Y, y) < 1e-10);
+
+    // Inverse and determinant.
+    ZQDynMatrix<qreal> Ainv(n, n);
+    BOOST_TEST(inverse(A, Ainv, error));
+    BOOST_TEST(maxDifference(Ainv * b, x) < 1e-10);
+    const std::array<qreal, 9> sv = {2, -1, 0, -1, 2, -1, 0, -1, 2};
+    const ZQDynMatrix<qreal> S(3, 3, sv.data());
+    qreal det;
+    BOOST_TEST(determinant(S, det, error));
+    BOOST_TEST(det == 4, boost::test_tools::tolerance(1e-12));
+
+    // Gauss-Jordan returns the inverse in Y and the solutions in X.
+    ZQDynMatrix<qreal> GY, GX;
+    BOOST_TEST(gauss_jordan(A, b, GY, GX, error));
+    BOOST_TEST(maxDifference(GX, x) < 1e-10);
+    BOOST_TEST(maxDifference(GY * b, x) < 1e-10);
+
+    // Transpose of a non-square matrix.
+    ZQDynMatrix<qreal> T32(3, 2);
+    BOOST_TEST(transpose(A23, T32, error));
+    for (int row = 0; row < 2; ++row)
+        for (int col = 0; col < 3; ++col)
+            BOOST_TEST(T32(col, row) == A23(row, col));
+    ZQDynMatrix<qreal> T22(2, 2);
+    BOOST_TEST(!transpose(A23, T22, error));
+
+    // Ascending index of a vector.
+    const std::array<qreal, 10> uv = {5, -2, 9, 0.5, 7, 3, -8, 1, 6, 4};
+    const ZQDynMatrix<qreal> u(10, 1, uv.data());
+    ZQDynMatrix<int> order(10, 1);
+    BOOST_TEST(index_ascend(u, order, error));
+    for (int i = 1; i < 10; ++i)
+        BOOST_TEST(u(order(i-1, 0)-1, 0) <= u(order(i, 0)-1, 0));
+    BOOST_TEST(order(0, 0) == 7);
+    BOOST_TEST(order(9, 0) == 3);
+
+    // Tridiagonal system with the 2, -1 stencil.
+    ZQDynMatrix<qreal> ta(n, 1), tb(n, 1), tc(n, 1), tr(n, 1), tx(n, 1);
+    for (int i = 0; i < n; ++i) {
+        ta(i, 0) = i > 0 ? -1 : 0;
+        tb(i, 0) = 2;
+        tc(i, 0) = i < n-1 ? -1 : 0;
+    }
+    for (int i = 0; i < n; ++i)
+        tr(i, 0) = 2 * x(i, 0) - (i > 0 ? x(i-1, 0) : 0) - (i < n-1 ? x(i+1, 0) : 0);
+    BOOST_TEST(tridiag_solve(ta, tb, tc, tr, tx, error));
+    BOOST_TEST(maxDifference(tx, x) < 1e-8);
+
+    // A 1-based ZQDynMatrix goes straight into the _zq routines, and the
+    // fixed size matrices still work with them.
+    ZQDynMatrix<qreal> A1 = A, b1(n, 1, 1, 0);
+    A1.setMinimum(1, 1);
+    ZQDynMatrix<int> indx1(n, 1, 1, 0);
+    for (int i = 1; i <= n; ++i)
+        b1(i, 0) = b(i-1, 0);
+    BOOST_TEST(lu_decomp_zq(A1, indx1, d, error));
+    BOOST_TEST(lu_backsub_zq(A1, indx1, b1, error));
+    BOOST_TEST(maxDifference(b1, x) < 1e-10);
+
+    ZQOffsetMatrix<1, 3, 1, 3, qreal> F(sv.data());
+    ZQOffsetMatrix<1, 3, 0, 0, qreal> fp;
+    ZQOffsetMatrix<1, 3, 0, 0, qreal> fb(&std::array<qreal, 3>({1, 0, 1})[0]);
+    BOOST_TEST(chol_decomp_zq(F, fp, error));
+    BOOST_TEST(chol_solve_zq(F, fp, fb, fb, error));
+    BOOST_TEST(fb(1, 0) == 1, boost::test_tools::tolerance(1e-12));
+    BOOST_TEST(fb(2, 0) == 1, boost::test_tools::tolerance(1e-12));
+    BOOST_TEST(fb(3, 0) == 1, boost::test_tools::tolerance(1e-12));
+}
@@ -0,0 +1,115 @@
+#define BOOST_TEST_MODULE Z_QTShapes_Gemm
+#include <boost/test/included/unit_test.hpp>
+#include <vector>
+
+#include "z_linalg.h"
+#include "z_gemm.h"
+
+using namespace z_linalg;
+
+namespace {
+
+    // Largest difference between gemm() at the given level and a plain
+    // double precision loop, on operands with padded columns. The padding
+    // of C must come back untouched.
+    template <typename T>
+    double gemmError(int m, int n, int k, z_qtshapes::ZQSimdLevel level)
+    {
+        const int lda = m + 3, ldb = k + 1, ldc = m + 2;
+        std::vector<T> a(lda * k + 1), b(ldb * n + 1), c(ldc * n + 1, T(7));
+        for (int i = 0; i < int(a.size()); ++i)
+            a[i] = T((i * 37 % 201) - 100) / 64;
+        for (int i = 0; i < int(b.size()); ++i)
+            b[i] = T((i * 53 % 199) - 99) / 64;
+        gemm(m, n, k, a.data(), lda, b.data(), ldb, c.data(), ldc, level);
+
+        double worst = 0;
+        for (int col = 0; col < n; ++col) {
+            for (int row = 0; row < m; ++row) {
+                double sum = 0;
+                for (int j = 0; j < k; ++j)
+                    sum += double(a[j*lda + row]) * double(b[col*ldb + j]);
+                worst = qMax(worst, qAbs(double(c[col*ldc + row]) - sum));
+            }
+            for (int row = m; row < ldc; ++row)
+                if (c[col*ldc + row] != T(7))
+                    return 1e30;
+        }
+        return worst;
+    }
+
+    template <int n>
+    double fixedError()
+    {
+        ZQMatrix<n, n, qreal> a, b;
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < n; ++j) {
+                a(i, j) = i + 2 * j - 1;
+                b(i, j) = i * j - 3;
+            }
+        const ZQMatrix<n, n, qreal> c = a * b;
+        double worst = 0;
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < n; ++j) {
+                qreal sum = 0;
+                for (int p = 0; p < n; ++p)
+                    sum += a(i, p) * b(p, j);
+                worst = qMax(worst, double(qAbs(c(i, j) - sum)));
+            }
+        return worst;
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(Z_Gemm)
+{
+    // Sizes around the tile and block edges, and empty products. The
+    // operands are multiples of 1/64, so double products are exact.
+    const int sizes[][3] = {
+        {1, 1, 1}, {8, 6, 1}, {9, 7, 3}, {17, 13, 300}, {100, 3100, 5},
+        {200, 50, 513}, {97, 101, 257}, {0, 5, 5}, {5, 5, 0}
+    };
+    const z_qtshapes::ZQSimdLevel levels[] = { z_qtshapes::ZQScalarLevel, z_qtshapes::ZQAVX512Level };
+    for (const auto &s : sizes) {
+        for (z_qtshapes::ZQSimdLevel level : levels) {
+            BOOST_TEST(gemmError<double>(s[0], s[1], s[2], level) == 0);
+            BOOST_TEST(gemmError<float>(s[0], s[1], s[2], level) < 1e-4 * qMax(1, s[2]));
+        }
+    }
+
+    // The unrolled sizes and the general fixed size product.
+    BOOST_TEST(fixedError<2>() == 0);
+    BOOST_TEST(fixedError<3>() == 0);
+    BOOST_TEST(fixedError<4>() == 0);
+    BOOST_TEST(fixedError<7>() == 0);
+
+    ZQOffsetMatrix<1, 2, 1, 3, qreal> o;
+    ZQOffsetMatrix<1, 3, 0, 0, qreal> v;
+    for (int i = 1; i <= 3; ++i) {
+        o(1, i) = i;
+        o(2, i) = -i;
+        v(i, 0) = 10 * i;
+    }
+    const ZQOffsetMatrix<1, 2, 0, 0, qreal> ov = o * v;
+    BOOST_TEST(ov(1, 0) == 140);
+    BOOST_TEST(ov(2, 0) == -140);
+
+    // Large enough for the blocked product, through operator*.
+    ZQDynMatrix<qreal> A(70, 40), B(40, 90);
+    for (int i = 0; i < 70; ++i)
+        for (int j = 0; j < 40; ++j)
+            A(i, j) = (i - j) / 8.;
+    for (int i = 0; i < 40; ++i)
+        for (int j = 0; j < 90; ++j)
+            B(i, j) = (i + 2 * j) / 16.;
+    const ZQDynMatrix<qreal> C = A * B;
+    qreal worst = 0;
+    for (int i = 0; i < 70; ++i)
+        for (int j = 0; j < 90; ++j) {
+            qreal sum = 0;
+            for (int p = 0; p < 40; ++p)
+                sum += A(i, p) * B(p, j);
+            worst = qMax(worst, qAbs(C(i, j) - sum));
+        }
+    BOOST_TEST(worst == 0);
+}
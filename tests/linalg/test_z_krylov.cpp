@@ -0,0 +1,295 @@
+#define BOOST_TEST_MODULE Z_QTShapes_Krylov
+#include <boost/test/included/unit_test.hpp>
+#include <vector>
+
+#include "z_linalg.h"
+#include "z_krylov.h"
+
+using namespace z_linalg;
+
+namespace {
+
+    /*
+     * Five point discretization of -laplacian(u) + c du/dx on an n x n
+     * grid. c = 0 gives the symmetric positive definite Poisson matrix.
+     */
+    ZQSparseMatrix<qreal> gridMatrix(int n, qreal c)
+    {
+        std::vector<ZQTriplet<qreal>> triplets;
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                const int row = i * n + j;
+                triplets.push_back(ZQTriplet<qreal>(row, row, 4));
+                if (i > 0)
+                    triplets.push_back(ZQTriplet<qreal>(row, row - n, -1));
+                if (i < n - 1)
+                    triplets.push_back(ZQTriplet<qreal>(row, row + n, -1));
+                if (j > 0)
+                    triplets.push_back(ZQTriplet<qreal>(row, row - 1, -1 - c));
+                if (j < n - 1)
+                    triplets.push_back(ZQTriplet<qreal>(row, row + 1, -1 + c));
+            }
+        }
+        ZQSparseMatrix<qreal> A(n * n, n * n);
+        A.setFromTriplets(triplets.begin(), triplets.end());
+        return A;
+    }
+
+    qreal relativeResidual(const ZQSparseMatrix<qreal> &A, const std::vector<qreal> &b, const std::vector<qreal> &x)
+    {
+        std::vector<qreal> r(b.size());
+        A.multiply(x.data(), r.data());
+        qreal rr = 0, bb = 0;
+        for (size_t i = 0; i < b.size(); ++i) {
+            rr += (b[i] - r[i]) * (b[i] - r[i]);
+            bb += b[i] * b[i];
+        }
+        return std::sqrt(rr / bb);
+    }
+
+    std::vector<qreal> rightHandSide(int size)
+    {
+        std::vector<qreal> b(size);
+        for (int i = 0; i < size; ++i)
+            b[i] = ((i * 37) % 11) - 5;
+        return b;
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(Z_Krylov_CG)
+{
+    const ZQSparseMatrix<qreal> A = gridMatrix(40, 0);
+    const int size = A.rows();
+    const std::vector<qreal> b = rightHandSide(size);
+    const qreal tol = 1e-10;
+    int iter;
+    qreal err;
+    std::string error;
+
+    std::vector<qreal> x(size, 0);
+    BOOST_TEST(linear_cg(A, ZQIdentityPreconditioner<qreal>(size), b.data(), x.data(), tol, 1000, iter, err, error));
+    BOOST_TEST(relativeResidual(A, b, x) < 10 * tol);
+    const int plain = iter;
+
+    ZQJacobiPreconditioner<qreal> jacobi;
+    BOOST_TEST(jacobi.compute(A, error));
+    std::fill(x.begin(), x.end(), 0);
+    BOOST_TEST(linear_cg(A, jacobi, b.data(), x.data(), tol, 1000, iter, err, error));
+    BOOST_TEST(relativeResidual(A, b, x) < 10 * tol);
+
+    // Incomplete Cholesky needs far fewer iterations on this matrix.
+    ZQIncompleteCholeskyPreconditioner<qreal> ic;
+    BOOST_TEST(ic.compute(A, error));
+    std::fill(x.begin(), x.end(), 0);
+    BOOST_TEST(linear_cg(A, ic, b.data(), x.data(), tol, 1000, iter, err, error));
+    BOOST_TEST(relativeResidual(A, b, x) < 10 * tol);
+    BOOST_TEST(iter < plain * 2 / 3);
+
+    // Too few iterations.
+    std::fill(x.begin(), x.end(), 0);
+    BOOST_TEST(!linear_cg(A, jacobi, b.data(), x.data(), tol, 5, iter, err, error));
+    BOOST_TEST(iter == 5);
+    BOOST_TEST(!error.empty());
+
+    // The progress callback sees every iteration and can stop early.
+    std::vector<qreal> seen;
+    std::fill(x.begin(), x.end(), 0);
+    BOOST_TEST(linear_cg(A, ic, b.data(), x.data(), tol, 1000, iter, err, error,
+                         [&](int i, qreal residual) { seen.push_back(residual); return i < 7; }));
+    BOOST_TEST(iter == 7);
+    BOOST_TEST(seen.size() == 7u);
+    BOOST_TEST(seen.back() == err);
+    BOOST_TEST(relativeResidual(A, b, x) == err, boost::test_tools::tolerance(1e-6));
+}
+
+BOOST_AUTO_TEST_CASE(Z_Krylov_Nonsymmetric)
+{
+    const ZQSparseMatrix<qreal> A = gridMatrix(40, 0.6);
+    const int size = A.rows();
+    const std::vector<qreal> b = rightHandSide(size);
+    const qreal tol = 1e-9;
+    int iter;
+    qreal err;
+    std::string error;
+
+    ZQILU0Preconditioner<qreal> ilu;
+    BOOST_TEST(ilu.compute(A, error));
+    const ZQIdentityPreconditioner<qreal> none(size);
+
+    std::vector<qreal> x(size, 0);
+    BOOST_TEST(linear_bicgstab(A, none, b.data(), x.data(), tol, 2000, iter, err, error));
+    BOOST_TEST(relativeResidual(A, b, x) < 10 * tol);
+    const int plainBicgstab = iter;
+    std::fill(x.begin(), x.end(), 0);
+    BOOST_TEST(linear_bicgstab(A, ilu, b.data(), x.data(), tol, 2000, iter, err, error));
+    BOOST_TEST(relativeResidual(A, b, x) < 10 * tol);
+    BOOST_TEST(iter < plainBicgstab);
+
+    std::fill(x.begin(), x.end(), 0);
+    BOOST_TEST(linear_gmres(A, none, b.data(), x.data(), tol, 5000, 30, iter, err, error));
+    BOOST_TEST(relativeResidual(A, b, x) < 10 * tol);
+    const int plainGmres = iter;
+    std::fill(x.begin(), x.end(), 0);
+    BOOST_TEST(linear_gmres(A, ilu, b.data(), x.data(), tol, 5000, 30, iter, err, error));
+    BOOST_TEST(relativeResidual(A, b, x) < 10 * tol);
+    BOOST_TEST(iter < plainGmres);
+
+    // GMRES residuals never increase.
+    qreal last = 1;
+    bool monotone = true;
+    std::fill(x.begin(), x.end(), 0);
+    BOOST_TEST(linear_gmres(A, ilu, b.data(), x.data(), tol, 5000, 10, iter, err, error,
+                            [&](int, qreal residual) { monotone = monotone && residual <= last * (1 + 1e-12); last = residual; return true; }));
+    BOOST_TEST(monotone);
+
+    // A restart cut short by itmax, and ILU(0) of a matrix without a
+    // diagonal element.
+    std::fill(x.begin(), x.end(), 0);
+    BOOST_TEST(!linear_gmres(A, none, b.data(), x.data(), tol, 45, 30, iter, err, error));
+    BOOST_TEST(iter == 45);
+    ZQSparseMatrix<qreal> offDiagonal(2, 2);
+    const ZQTriplet<qreal> swap[] = { ZQTriplet<qreal>(0, 1, 1), ZQTriplet<qreal>(1, 0, 1) };
+    offDiagonal.setFromTriplets(swap, swap + 2);
+    error.clear();
+    BOOST_TEST(!ZQILU0Preconditioner<qreal>().compute(offDiagonal, error));
+    BOOST_TEST(!error.empty());
+}
+
+BOOST_AUTO_TEST_CASE(Z_Krylov_Exact)
+{
+    // On a matrix with every entry present the incomplete factorizations
+    // are exact, so one iteration solves the system.
+    const int n = 6;
+    std::vector<ZQTriplet<qreal>> triplets;
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+            triplets.push_back(ZQTriplet<qreal>(i, j, i == j ? n + 1 : 1.0 / (1 + i + j)));
+    ZQSparseMatrix<qreal> A(n, n, ZQSparseMatrix<qreal>::CompressedColumns);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    const std::vector<qreal> b = rightHandSide(n);
+    int iter;
+    qreal err;
+    std::string error;
+
+    ZQIncompleteCholeskyPreconditioner<qreal> ic;
+    BOOST_TEST(ic.compute(A, error));
+    std::vector<qreal> x(n, 0);
+    BOOST_TEST(linear_cg(A, ic, b.data(), x.data(), qreal(1e-12), 10, iter, err, error));
+    BOOST_TEST(iter == 1);
+
+    ZQILU0Preconditioner<qreal> ilu;
+    BOOST_TEST(ilu.compute(A, error));
+    std::fill(x.begin(), x.end(), 0);
+    BOOST_TEST(linear_gmres(A, ilu, b.data(), x.data(), qreal(1e-12), 10, 5, iter, err, error));
+    BOOST_TEST(iter == 1);
+    std::fill(x.begin(), x.end(), 0);
+    BOOST_TEST(linear_bicgstab(A, ilu, b.data(), x.data(), qreal(1e-12), 10, iter, err, error));
+    BOOST_TEST(iter == 1);
+
+    // A zero right hand side gives a zero solution straight away.
+    const std::vector<qreal> zero(n, 0);
+    BOOST_TEST(linear_bicgstab(A, ilu, zero.data(), x.data(), qreal(1e-12), 10, iter, err, error));
+    BOOST_TEST(iter == 0);
+    BOOST_TEST(x[3] == 0);
+}
+
+BOOST_AUTO_TEST_CASE(Z_Krylov_MatrixFree)
+{
+    // The 1D Poisson matrix, never stored.
+    const int n = 200;
+    auto product = [n](const qreal *x, qreal *y) {
+        for (int i = 0; i < n; ++i)
+            y[i] = 2 * x[i] - (i > 0 ? x[i-1] : 0) - (i < n - 1 ? x[i+1] : 0);
+    };
+    const auto A = linearOperator<qreal>(n, product);
+    std::vector<qreal> b(n, 1), x(n, 0), y(n);
+    int iter;
+    qreal err;
+    std::string error;
+    BOOST_TEST(linear_cg(A, ZQIdentityPreconditioner<qreal>(n), b.data(), x.data(), qreal(1e-10), 1000, iter, err, error));
+    BOOST_TEST(iter <= n);
+    product(x.data(), y.data());
+    qreal worst = 0;
+    for (int i = 0; i < n; ++i)
+        worst = qMax(worst, qAbs(y[i] - 1));
+    BOOST_TEST(worst < 1e-6);
+
+    std::fill(x.begin(), x.end(), 0);
+    BOOST_TEST(linear_gmres(A, ZQIdentityPreconditioner<qreal>(n), b.data(), x.data(), qreal(1e-10), 1000, n, iter, err, error));
+    product(x.data(), y.data());
+    BOOST_TEST(qAbs(y[n / 2] - 1) < 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(Z_Krylov_RowIndexed)
+{
+    // One nonsymmetric system through linear_bcg_zq and linear_bcg on the
+    // row-indexed arrays, and through the new solvers on the same matrix.
+    const int n = 30, nmax = 3 * n;
+    ZQOffsetMatrix<1, n, 1, n, qreal> dense;
+    ZQOffsetMatrix<1, n, 0, 0, qreal> b, x;
+    for (int i = 1; i <= n; ++i) {
+        dense(i, i) = 3;
+        if (i > 1)
+            dense(i, i-1) = -1.5;
+        if (i < n)
+            dense(i, i+1) = -0.5;
+        b(i, 0) = (i % 4) - 1.5;
+        x(i, 0) = 0;
+    }
+    ZQOffsetMatrix<1, nmax, 0, 0, qreal> sa;
+    ZQOffsetMatrix<1, nmax, 0, 0, int> ija;
+    std::string error;
+    BOOST_TEST(sparse_in_zq(dense, qreal(1e-12), sa, ija, error));
+
+    const qreal tol = 1e-12;
+    int iter, bcgIter;
+    qreal err;
+    BOOST_TEST(linear_bcg_zq(sa, ija, b, x, 1, tol, 200, bcgIter, err, false, error));
+    BOOST_TEST(err < tol);
+    BOOST_TEST(!linear_bcg_zq(sa, ija, b, x, 5, tol, 200, iter, err, false, error));
+    BOOST_TEST(!linear_bcg_zq(sa, ija, b, x, 3, tol, 200, iter, err, false, error));
+    BOOST_TEST(!linear_bcg_zq(sa, ija, b, x, 1, tol, 200, iter, err, true, error));
+
+    // itol 2 measures the residual scaled by the diagonal, 3 here.
+    ZQOffsetMatrix<1, n, 0, 0, qreal> x0, x2;
+    for (int i = 1; i <= n; ++i)
+        x0(i, 0) = 0;
+    BOOST_TEST(linear_bcg_zq(sa, ija, b, x0, x2, 2, tol, 200, iter, err, false, error));
+    BOOST_TEST(err < tol);
+    qreal rnorm = 0, bnorm = 0;
+    for (int i = 1; i <= n; ++i) {
+        qreal r = b(i, 0);
+        for (int j = qMax(i-1, 1); j <= qMin(i+1, n); ++j)
+            r -= dense(i, j) * x2(j, 0);
+        rnorm += r * r / 9;
+        bnorm += b(i, 0) * b(i, 0) / 9;
+    }
+    BOOST_TEST(qSqrt(rnorm / bnorm) < 10 * tol);
+
+    ZQDynMatrix<qreal> db(n, 1, 1, 0), dx0(n, 1, 1, 0), dx(n, 1, 1, 0);
+    for (int i = 1; i <= n; ++i)
+        db(i, 0) = b(i, 0);
+    BOOST_TEST(linear_bcg(sa, ija, db, dx0, dx, 1, tol, 200, iter, err, false, error));
+    BOOST_TEST(iter == bcgIter);
+
+    const ZQSparseMatrix<qreal> A = ZQSparseMatrix<qreal>::fromRowIndexed(sa, ija);
+    std::vector<qreal> rhs(n), y(n, 0), z(n, 0);
+    for (int i = 0; i < n; ++i)
+        rhs[i] = b(i+1, 0);
+    ZQJacobiPreconditioner<qreal> jacobi;
+    BOOST_TEST(jacobi.compute(A, error));
+    BOOST_TEST(linear_bicgstab(A, jacobi, rhs.data(), y.data(), tol, 200, iter, err, error));
+    BOOST_TEST(iter == bcgIter);
+    ZQILU0Preconditioner<qreal> ilu;
+    BOOST_TEST(ilu.compute(A, error));
+    BOOST_TEST(linear_gmres(A, ilu, rhs.data(), z.data(), tol, 200, 10, iter, err, error));
+
+    qreal worst = 0;
+    for (int i = 0; i < n; ++i) {
+        worst = qMax(worst, qAbs(x(i+1, 0) - y[i]));
+        worst = qMax(worst, qAbs(dx(i+1, 0) - y[i]));
+        worst = qMax(worst, qAbs(z[i] - y[i]));
+    }
+    BOOST_TEST(worst < 1e-10);
+}
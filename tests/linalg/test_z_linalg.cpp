@@ -58,3 +58,62 @@ BOOST_AUTO_TEST_CASE(Z_LinAlg)
         -2, 0, -3, 22})[0]);
     BOOST_TEST(z_linalg::rank(C) == 2);
 }
+
+BOOST_AUTO_TEST_CASE(Z_LinAlg_QRUpdate)
+{
+    // With Q = I the update gives the QR decomposition of R + u⊗v.
+    const int n = 4;
+    z_linalg::ZQOffsetMatrix<1, n, 1, n, qreal> r, qt, expected;
+    z_linalg::ZQOffsetMatrix<1, n, 0, 0, qreal> u, v;
+    for (int i = 1; i <= n; ++i) {
+        for (int j = 1; j <= n; ++j) {
+            r(i, j) = j >= i ? i + 2 * j : 0;
+            qt(i, j) = i == j ? 1 : 0;
+        }
+        u(i, 0) = i % 2 ? i : -i;
+        v(i, 0) = 3 - i;
+    }
+    for (int i = 1; i <= n; ++i)
+        for (int j = 1; j <= n; ++j)
+            expected(i, j) = r(i, j) + u(i, 0) * v(j, 0);
+
+    std::string error;
+    BOOST_TEST(z_linalg::qr_update_zq(r, qt, u, v, error));
+    qreal worst = 0;
+    for (int i = 1; i <= n; ++i) {
+        for (int j = 1; j <= n; ++j) {
+            qreal qr = 0, qqt = 0;
+            for (int k = 1; k <= n; ++k) {
+                qr += qt(k, i) * r(k, j);
+                qqt += qt(i, k) * qt(j, k);
+            }
+            worst = qMax(worst, qAbs(qr - expected(i, j)));
+            worst = qMax(worst, qAbs(qqt - (i == j ? 1 : 0)));
+            if (i > j)
+                worst = qMax(worst, qAbs(r(i, j)));
+        }
+    }
+    BOOST_TEST(worst < 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(Z_LinAlg_SparsePatmul)
+{
+    // A·A' on the pattern of A, in row-indexed storage.
+    z_linalg::ZQOffsetMatrix<1, 5, 1, 5, qreal> A;
+    for (int i = 1; i <= 5; ++i)
+        A(i, i) = i + 1;
+    A(1, 3) = 1;
+    A(3, 2) = 7;
+    z_linalg::ZQOffsetMatrix<1, 8, 0, 0, qreal> sa, sc;
+    z_linalg::ZQOffsetMatrix<1, 8, 0, 0, int> ija, ijc;
+    std::string error;
+    BOOST_TEST(z_linalg::sparse_in_zq(A, qreal(0.5), sa, ija, error));
+    BOOST_TEST(z_linalg::sparse_in_zq(A, qreal(0.5), sc, ijc, error));
+    BOOST_TEST(z_linalg::sparse_patmul_zq(sa, ija, sa, ija, sc, ijc, error));
+    for (int i = 1; i <= 5; ++i)
+        BOOST_TEST(sc(i, 0) == (i == 1 ? 5 : i == 3 ? 65 : (i + 1) * (i + 1)));
+    BOOST_TEST(ijc(ijc(1, 0), 0) == 3);
+    BOOST_TEST(sc(ijc(1, 0), 0) == 4);
+    BOOST_TEST(ijc(ijc(3, 0), 0) == 2);
+    BOOST_TEST(sc(ijc(3, 0), 0) == 21);
+}
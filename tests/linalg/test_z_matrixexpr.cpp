@@ -0,0 +1,82 @@
+#define BOOST_TEST_MODULE Z_QTShapes_MatrixExpr
+#include <boost/test/included/unit_test.hpp>
+#include <array>
+#include <type_traits>
+
+#include "z_matrix.h"
+#include "z_offsetmatrix.h"
+
+using namespace z_linalg;
+
+BOOST_AUTO_TEST_CASE(Z_MatrixExpr)
+{
+    // The expression base adds nothing to the size of a matrix.
+    BOOST_TEST(sizeof(ZQMatrix<3, 4, qreal>) == 12 * sizeof(qreal));
+    BOOST_TEST(sizeof(ZQOffsetMatrix<1, 3, 2, 5, float>) == 12 * sizeof(float));
+
+    const std::array<qreal, 6> av = {1, 2, 3, 4, 5, 6};
+    const std::array<qreal, 6> bv = {6, 5, 4, 3, 2, 1};
+    const std::array<qreal, 6> cv = {1, -1, 1, -1, 1, -1};
+    const ZQMatrix<2, 3, qreal> A(av.data()), B(bv.data()), C(cv.data());
+
+    // Operators return lazy expressions, evaluated on assignment.
+    BOOST_TEST((!std::is_same<decltype(A + B), ZQMatrix<2, 3, qreal> >::value));
+    ZQMatrix<2, 3, qreal> R = A + B - C * qreal(2);
+    for (int row = 0; row < 2; ++row)
+        for (int col = 0; col < 3; ++col)
+            BOOST_TEST(R(row, col) == A(row, col) + B(row, col) - 2 * C(row, col));
+
+    // Every element-wise operator, ints as factors, and elements of an
+    // expression read without evaluating it.
+    R = -(A / 2) + 3 * B - C;
+    BOOST_TEST(R(1, 2) == -3 + 3 - -1);
+    BOOST_TEST(((A - B)(0, 1) == -3));
+    R += A * 2 - B;
+    BOOST_TEST(R(1, 2) == 1 + 12 - 1);
+    R -= A + A;
+    BOOST_TEST(R(1, 2) == 12 - 12);
+
+    // The result may be one of the operands.
+    R = A;
+    R = B - R * qreal(2);
+    BOOST_TEST(R(0, 0) == 4);
+    BOOST_TEST(R(1, 2) == -11);
+
+    // Comparisons and products accept expressions on either side.
+    BOOST_TEST((A + B == B + A));
+    BOOST_TEST((A + A != A));
+    BOOST_TEST((A * qreal(2) == A + A));
+    const ZQMatrix<3, 2, qreal> T(bv.data());
+    const ZQMatrix<2, 2, qreal> P = (A + C) * T;
+    const ZQMatrix<2, 2, qreal> Q = A * T + C * T;
+    BOOST_TEST((P == Q));
+    BOOST_TEST(((A + C) * (T - T) == ZQMatrix<2, 2, qreal>(&std::array<qreal, 4>({0, 0, 0, 0})[0])));
+    BOOST_TEST(((A + B).eval()(1, 1) == 7));
+
+    // The read-only members of the matrix work on expressions too.
+    const std::array<qreal, 4> sv = {1, 2, 3, 4};
+    const ZQMatrix<2, 2, qreal> S(sv.data()), I;
+    BOOST_TEST(((S + S).transposed() == (S * qreal(2)).eval().transposed()));
+    BOOST_TEST(((S + S).transposed()(0, 1) == 6));
+    BOOST_TEST((I + S - S).isIdentity());
+    BOOST_TEST(!(I * qreal(2)).isIdentity());
+    qreal values[6];
+    (A + B).copyDataTo(values);
+    BOOST_TEST(values[4] == 7);
+
+    // The same for ZQOffsetMatrix, keeping its index ranges.
+    const ZQOffsetMatrix<1, 2, 5, 7, qreal> OA(av.data()), OB(bv.data());
+    ZQOffsetMatrix<1, 2, 5, 7, qreal> OR = OA * 2 - OB / qreal(2);
+    BOOST_TEST(OR(1, 5) == 2 - 3);
+    BOOST_TEST(OR(2, 7) == 12 - 0.5);
+    BOOST_TEST(((OA + OB)(2, 6) == 7));
+    OR = OR + OA;
+    BOOST_TEST(OR(2, 7) == 17.5);
+    const ZQOffsetMatrix<5, 7, 0, 0, qreal> ov(&std::array<qreal, 3>({1, 1, 1})[0]);
+    const ZQOffsetMatrix<1, 2, 0, 0, qreal> sums = (OA - OB) * ov;
+    BOOST_TEST(sums(1, 0) == -9);
+    BOOST_TEST(sums(2, 0) == 9);
+    const ZQOffsetMatrix<1, 2, 1, 2, qreal> OS(sv.data());
+    BOOST_TEST(((OS - OS * 3).transposed()(1, 2) == -6));
+    BOOST_TEST((OS - OS + ZQOffsetMatrix<1, 2, 1, 2, qreal>()).isIdentity());
+}
@@ -0,0 +1,152 @@
+#define BOOST_TEST_MODULE Z_QTShapes_SparseMatrix
+#include <boost/test/included/unit_test.hpp>
+#include <vector>
+
+#include "z_linalg.h"
+#include "z_sparsematrix.h"
+
+using namespace z_linalg;
+
+namespace {
+
+    // Random triplets in an m x n matrix, some of them repeated, and the
+    // dense matrix they add up to.
+    std::vector<ZQTriplet<qreal>> randomTriplets(int m, int n, int count, ZQDynMatrix<qreal> &dense)
+    {
+        std::vector<ZQTriplet<qreal>> triplets;
+        unsigned int seed = 12345;
+        for (int i = 0; i < count; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            const int row = int((seed >> 8) % unsigned(m));
+            seed = seed * 1664525u + 1013904223u;
+            const int col = int((seed >> 8) % unsigned(n));
+            const qreal value = int(seed % 17u) - 8;
+            triplets.push_back(ZQTriplet<qreal>(row, col, value));
+            if (i % 5 == 0)
+                triplets.push_back(ZQTriplet<qreal>(row, col, 1));
+        }
+        dense = ZQDynMatrix<qreal>(m, n);
+        for (const ZQTriplet<qreal> &t : triplets)
+            dense(t.row, t.column) += t.value;
+        return triplets;
+    }
+
+    // Largest difference between A x, A' x and the dense products.
+    qreal productError(const ZQSparseMatrix<qreal> &A, const ZQDynMatrix<qreal> &dense, QThreadPool *pool)
+    {
+        std::vector<qreal> x(A.columns()), xt(A.rows()), y(A.rows()), yt(A.columns());
+        for (int i = 0; i < A.columns(); ++i)
+            x[i] = (i % 7) - 3;
+        for (int i = 0; i < A.rows(); ++i)
+            xt[i] = (i % 5) - 2;
+        A.multiply(x.data(), y.data(), pool);
+        A.multiplyTransposed(xt.data(), yt.data(), pool);
+
+        qreal worst = 0;
+        for (int row = 0; row < A.rows(); ++row) {
+            qreal sum = 0;
+            for (int col = 0; col < A.columns(); ++col)
+                sum += dense(row, col) * x[col];
+            worst = qMax(worst, qAbs(y[row] - sum));
+        }
+        for (int col = 0; col < A.columns(); ++col) {
+            qreal sum = 0;
+            for (int row = 0; row < A.rows(); ++row)
+                sum += dense(row, col) * xt[row];
+            worst = qMax(worst, qAbs(yt[col] - sum));
+        }
+        return worst;
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(Z_SparseMatrix)
+{
+    ZQDynMatrix<qreal> dense;
+    const std::vector<ZQTriplet<qreal>> triplets = randomTriplets(37, 23, 300, dense);
+
+    // Both storages hold the dense matrix, with duplicates added up and
+    // the indices sorted within every row or column.
+    ZQSparseMatrix<qreal> csr(37, 23), csc(37, 23, ZQSparseMatrix<qreal>::CompressedColumns);
+    csr.setFromTriplets(triplets.begin(), triplets.end());
+    csc.setFromTriplets(triplets.begin(), triplets.end());
+    BOOST_TEST(csr.nonZeros() == csc.nonZeros());
+    BOOST_TEST(csr.nonZeros() < int(triplets.size()));
+    BOOST_TEST(csr.offsets().size() == 38);
+    BOOST_TEST(csc.offsets().size() == 24);
+    bool sorted = true;
+    for (int o = 0; o < 37; ++o)
+        for (int q = csr.offsets()[o] + 1; q < csr.offsets()[o+1]; ++q)
+            sorted = sorted && csr.indices()[q-1] < csr.indices()[q];
+    BOOST_TEST(sorted);
+
+    bool same = true;
+    for (int row = 0; row < 37; ++row)
+        for (int col = 0; col < 23; ++col)
+            same = same && csr.value(row, col) == dense(row, col) && csc.value(row, col) == dense(row, col);
+    BOOST_TEST(same);
+    BOOST_TEST(productError(csr, dense, nullptr) == 0);
+    BOOST_TEST(productError(csc, dense, nullptr) == 0);
+
+    // Transposes and conversions between the storages.
+    const ZQSparseMatrix<qreal> t = csr.transposed();
+    BOOST_TEST(t.rows() == 23);
+    BOOST_TEST(t.storage() == ZQSparseMatrix<qreal>::CompressedColumns);
+    BOOST_TEST(t.value(5, 11) == dense(11, 5));
+    const ZQSparseMatrix<qreal> converted = csr.converted(ZQSparseMatrix<qreal>::CompressedColumns);
+    BOOST_TEST((converted.offsets() == csc.offsets()));
+    BOOST_TEST((converted.indices() == csc.indices()));
+    BOOST_TEST((converted.values() == csc.values()));
+    const ZQDynMatrix<qreal> back = csc.toDense();
+    BOOST_TEST(back(36, 22) == dense(36, 22));
+    BOOST_TEST(back(17, 3) == dense(17, 3));
+
+    ZQDynMatrix<qreal> X(23, 2);
+    for (int i = 0; i < 23; ++i) {
+        X(i, 0) = i;
+        X(i, 1) = -1;
+    }
+    const ZQDynMatrix<qreal> AX = csc * X;
+    qreal sum = 0;
+    for (int col = 0; col < 23; ++col)
+        sum += dense(4, col) * col;
+    BOOST_TEST(AX(4, 0) == sum);
+
+    // Large enough to be split between threads. The results must match
+    // the serial products exactly.
+    ZQDynMatrix<qreal> bigDense;
+    const std::vector<ZQTriplet<qreal>> big = randomTriplets(600, 500, 120000, bigDense);
+    QThreadPool pool;
+    pool.setMaxThreadCount(4);
+    for (int s = 0; s < 2; ++s) {
+        ZQSparseMatrix<qreal> A(600, 500, s ? ZQSparseMatrix<qreal>::CompressedColumns : ZQSparseMatrix<qreal>::CompressedRows);
+        A.setFromTriplets(big.begin(), big.end());
+        BOOST_TEST(productError(A, bigDense, nullptr) == 0);
+        BOOST_TEST(productError(A, bigDense, &pool) == 0);
+    }
+
+    // The example of sparse_in_zq, converted from its sa/ija arrays.
+    const qreal example[25] = {
+        3, 0, 1, 0, 0,
+        0, 4, 0, 0, 0,
+        0, 7, 5, 9, 0,
+        0, 0, 0, 0, 2,
+        0, 0, 0, 6, 5
+    };
+    ZQOffsetMatrix<1, 5, 1, 5, qreal> A5;
+    for (int i = 1; i <= 5; ++i)
+        for (int j = 1; j <= 5; ++j)
+            A5(i, j) = example[(i-1)*5 + (j-1)];
+    ZQOffsetMatrix<1, 11, 0, 0, qreal> sa;
+    ZQOffsetMatrix<1, 11, 0, 0, int> ija;
+    std::string error;
+    BOOST_TEST(sparse_in_zq(A5, qreal(0.5), sa, ija, error));
+    const ZQSparseMatrix<qreal> legacy = ZQSparseMatrix<qreal>::fromRowIndexed(sa, ija);
+    BOOST_TEST(legacy.rows() == 5);
+    BOOST_TEST(legacy.nonZeros() == 9);
+    bool matches = true;
+    for (int i = 0; i < 5; ++i)
+        for (int j = 0; j < 5; ++j)
+            matches = matches && legacy.value(i, j) == example[i*5 + j];
+    BOOST_TEST(matches);
+}
@@ -0,0 +1,49 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QBroadPhase_1
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+#include "z_qbroadphase.h"
+
+
+BOOST_AUTO_TEST_CASE(Z_QBroadPhase_1)
+{
+    typedef z_qtshapes::ZQBroadPhase::Pair Pair;
+
+    z_qtshapes::ZQBroadPhase broadPhase;
+    const z_qtshapes::ZQBroadPhase::Id r = broadPhase.insert(z_qtshapes::ZQRectF(0, 0, 10, 10, 45));
+    const z_qtshapes::ZQBroadPhase::Id t = broadPhase.insert(z_qtshapes::ZQTriF(QPointF(11, 4), QPointF(20, 4), QPointF(11, 12)));
+    const z_qtshapes::ZQBroadPhase::Id e = broadPhase.insert(z_qtshapes::ZQEllipseF(-10, -10, 8, 8));
+    const z_qtshapes::ZQBroadPhase::Id l = broadPhase.insert(z_qtshapes::ZQLineF(QPointF(-20, 20), QPointF(30, 20)));
+    BOOST_TEST(broadPhase.size() == 4);
+
+    // The corner of the rotated square reaches into the triangle. The
+    // bounding rectangle of the square also touches the ellipse's, but the
+    // shapes themselves are apart.
+    BOOST_TEST(broadPhase.candidatePairs().contains(Pair(r, e)));
+    BOOST_TEST(broadPhase.intersectingPairs() == QVector<Pair>({ Pair(r, t) }));
+
+    // Move the ellipse onto the line and the triangle away from the square.
+    broadPhase.update(e, z_qtshapes::ZQEllipseF(-10, 15, 8, 10));
+    broadPhase.update(t, z_qtshapes::ZQTriF(QPointF(40, 4), QPointF(50, 4), QPointF(40, 12)));
+    BOOST_TEST(broadPhase.intersectingPairs() == QVector<Pair>({ Pair(e, l) }));
+
+    BOOST_TEST(broadPhase.remove(l));
+    BOOST_TEST(broadPhase.intersectingPairs().isEmpty());
+    const z_qtshapes::ZQBroadPhase::Id c = broadPhase.insert(z_qtshapes::ZQRectF(4, 4, 2, 2));
+    BOOST_TEST(c == l);
+    BOOST_TEST(broadPhase.intersectingPairs() == QVector<Pair>({ Pair(r, c) }));
+
+    // Null shapes are never stored; updating to one removes the shape.
+    BOOST_TEST(broadPhase.insert(z_qtshapes::ZQPreparedShape()) == -1);
+    BOOST_TEST(broadPhase.size() == 4);
+    BOOST_TEST(broadPhase.update(c, z_qtshapes::ZQPreparedShape()));
+    BOOST_TEST(!broadPhase.contains(c));
+    BOOST_TEST(broadPhase.size() == 3);
+    BOOST_TEST(broadPhase.intersectingPairs().isEmpty());
+    BOOST_TEST(!broadPhase.update(c, z_qtshapes::ZQPreparedShape()));
+    BOOST_TEST(broadPhase.insert(z_qtshapes::ZQRectF(4, 4, 2, 2)) == c);
+}
@@ -0,0 +1,70 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QBroadPhase_2
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+#include "z_qbroadphase.h"
+
+
+BOOST_AUTO_TEST_CASE(Z_QBroadPhase_2)
+{
+    typedef z_qtshapes::ZQBroadPhase::Pair Pair;
+
+    QVector<z_qtshapes::ZQPreparedShape> shapes;
+    quint32 seed = 12345;
+    auto next = [&seed]() { seed = seed * 1664525u + 1013904223u; return (seed >> 8) / qreal(1 << 24); };
+    QVector<z_qtshapes::ZQRectF> rects;
+    QVector<z_qtshapes::ZQEllipseF> ellipses;
+    QVector<z_qtshapes::ZQTriF> tris;
+    for (int i = 0; i < 150; ++i) {
+        rects.append(z_qtshapes::ZQRectF(next() * 200, next() * 200, 2 + next() * 10, 2 + next() * 10, next() * 90));
+        ellipses.append(z_qtshapes::ZQEllipseF(next() * 200, next() * 200, 2 + next() * 10, 2 + next() * 10, next() * 90));
+        const QPointF p(next() * 200, next() * 200);
+        tris.append(z_qtshapes::ZQTriF(p, p + QPointF(next() * 10, 0), p + QPointF(0, next() * 10), next() * 90));
+    }
+
+    z_qtshapes::ZQBroadPhase broadPhase;
+    for (int frame = 0; frame < 3; ++frame) {
+        shapes.clear();
+        for (int i = 0; i < rects.size(); ++i) {
+            shapes.append(rects[i]);
+            shapes.append(ellipses[i]);
+            shapes.append(tris[i]);
+        }
+        if (frame == 0) {
+            for (const z_qtshapes::ZQPreparedShape &s : shapes)
+                broadPhase.insert(s);
+        } else {
+            for (int i = 0; i < shapes.size(); ++i)
+                broadPhase.update(i, shapes[i]);
+        }
+
+        QVector<Pair> expected;
+        for (int i = 0; i < shapes.size(); ++i)
+            for (int j = i + 1; j < shapes.size(); ++j)
+                if (shapes[i].intersects(shapes[j]))
+                    expected.append(Pair(i, j));
+        BOOST_TEST(!expected.isEmpty());
+        BOOST_TEST(broadPhase.intersectingPairs() == expected);
+
+        // Same-type pairs agree with the predicates of the shape classes,
+        // which differ only for shapes in exact contact.
+        for (const Pair &p : expected) {
+            if (p.first % 3 == 0 && p.second % 3 == 0)
+                BOOST_TEST(rects[p.first / 3].intersects(rects[p.second / 3]));
+            if (p.first % 3 == 2 && p.second % 3 == 2)
+                BOOST_TEST(tris[p.first / 3].intersects(tris[p.second / 3]));
+        }
+
+        for (int i = 0; i < rects.size(); ++i) {
+            rects[i].translate(next() * 4 - 2, next() * 4 - 2);
+            tris[i].translate(next() * 4 - 2, next() * 4 - 2);
+            ellipses[i].translate(next() * 4 - 2, next() * 4 - 2);
+        }
+    }
+
+    BOOST_TEST(z_qtshapes::ZQBroadPhase::intersectingPairs(shapes.begin(), shapes.end()) == broadPhase.intersectingPairs());
+}
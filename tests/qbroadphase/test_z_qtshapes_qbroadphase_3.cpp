@@ -0,0 +1,86 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QBroadPhase_3
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+#include "z_qbroadphase.h"
+#include "z_qspatialindex.h"
+
+
+namespace {
+
+    // Both orders of the pair, and the broad phase, must report a contact.
+    bool touches(const z_qtshapes::ZQPreparedShape &a, const z_qtshapes::ZQPreparedShape &b)
+    {
+        const QVector<z_qtshapes::ZQPreparedShape> pair = { a, b };
+        const QVector<z_qtshapes::ZQBroadPhase::Pair> pairs =
+                z_qtshapes::ZQBroadPhase::intersectingPairs(pair.begin(), pair.end());
+        return a.intersects(b) && b.intersects(a) && pairs.size() == 1;
+    }
+
+    bool apart(const z_qtshapes::ZQPreparedShape &a, const z_qtshapes::ZQPreparedShape &b)
+    {
+        const QVector<z_qtshapes::ZQPreparedShape> pair = { a, b };
+        return !a.intersects(b) && !b.intersects(a)
+                && z_qtshapes::ZQBroadPhase::intersectingPairs(pair.begin(), pair.end()).isEmpty();
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(Z_QBroadPhase_3)
+{
+    using namespace z_qtshapes;
+
+    // Every pair of types, touching at a single point or along an edge
+    // and then moved half a unit apart.
+    const ZQRectF rect(0, 0, 10, 10);
+    const ZQTriF tri(QPointF(0, 0), QPointF(10, 0), QPointF(0, 10));
+    const ZQEllipseF circle(0, 0, 10, 10);
+    const ZQLineF line(0, 0, 10, 0);
+
+    BOOST_TEST(touches(rect, ZQRectF(10, 0, 10, 10)));
+    BOOST_TEST(touches(rect, ZQRectF(10, 10, 5, 5)));
+    BOOST_TEST(apart(rect, ZQRectF(10.5, 0, 10, 10)));
+
+    BOOST_TEST(touches(rect, ZQTriF(QPointF(10, 5), QPointF(20, 0), QPointF(20, 10))));
+    BOOST_TEST(apart(rect, ZQTriF(QPointF(10.5, 5), QPointF(20, 0), QPointF(20, 10))));
+
+    BOOST_TEST(touches(rect, ZQEllipseF(10, 0, 10, 10)));
+    BOOST_TEST(apart(rect, ZQEllipseF(10.5, 0, 10, 10)));
+
+    BOOST_TEST(touches(rect, ZQLineF(10, 5, 20, 5)));
+    BOOST_TEST(apart(rect, ZQLineF(10.5, 5, 20, 5)));
+
+    BOOST_TEST(touches(tri, ZQTriF(QPointF(10, 0), QPointF(20, 0), QPointF(10, 10))));
+    BOOST_TEST(touches(tri, ZQTriF(QPointF(0, 0), QPointF(10, 0), QPointF(5, -5))));
+    BOOST_TEST(apart(tri, ZQTriF(QPointF(10.5, 0), QPointF(20, 0), QPointF(10.5, 10))));
+
+    BOOST_TEST(touches(tri, ZQEllipseF(0, -10, 10, 10)));
+    BOOST_TEST(apart(tri, ZQEllipseF(0, -10.5, 10, 10)));
+
+    BOOST_TEST(touches(tri, ZQLineF(10, 0, 20, 5)));
+    BOOST_TEST(apart(tri, ZQLineF(10.5, 0, 20, 5)));
+
+    BOOST_TEST(touches(circle, ZQEllipseF(10, 0, 10, 10)));
+    BOOST_TEST(touches(ZQEllipseF(0, 0, 20, 10), ZQEllipseF(20, 0, 20, 10)));
+    BOOST_TEST(apart(circle, ZQEllipseF(10.5, 0, 10, 10)));
+
+    BOOST_TEST(touches(circle, ZQLineF(10, 0, 10, 10)));
+    BOOST_TEST(apart(circle, ZQLineF(10.5, 0, 10.5, 10)));
+
+    BOOST_TEST(touches(line, ZQLineF(10, 0, 10, 10)));
+    BOOST_TEST(touches(line, ZQLineF(10, 0, 20, 0)));
+    BOOST_TEST(apart(line, ZQLineF(10.5, 0, 10.5, 10)));
+
+    // The region queries of the spatial index follow the same rule.
+    ZQSpatialIndex index;
+    index.insert(rect);
+    index.insert(tri);
+    index.insert(circle);
+    index.insert(line);
+    BOOST_TEST(index.intersecting(QRectF(10, 0, 5, 5)).size() == 4);
+    BOOST_TEST(index.intersecting(QRectF(10.5, 0, 5, 5)).isEmpty());
+}
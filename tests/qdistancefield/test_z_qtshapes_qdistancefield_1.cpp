@@ -0,0 +1,148 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QDistanceField_1
+#include <boost/test/included/unit_test.hpp>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+#include "z_qdistancefield.h"
+
+namespace {
+
+    qreal segmentDistance(const QPointF &p, const QPointF &a, const QPointF &b)
+    {
+        const QPointF ab = b - a, ap = p - a;
+        const qreal len2 = QPointF::dotProduct(ab, ab);
+        const qreal t = len2 > 0 ? qBound(qreal(0), QPointF::dotProduct(ap, ab) / len2, qreal(1)) : 0;
+        const QPointF d = ap - ab * t;
+        return qSqrt(QPointF::dotProduct(d, d));
+    }
+
+    // Signed distance from dense samples of the outline.
+    qreal referenceDistance(const z_qtshapes::ZQPreparedShape &s, const QPointF &p)
+    {
+        qreal d = std::numeric_limits<qreal>::infinity();
+        switch (s.type()) {
+        case z_qtshapes::ZQPreparedShape::RectShape: {
+            const auto &r = s.rect();
+            const QPointF v[4] = { r.topRight(), r.bottomRight(), r.bottomLeft(), r.topLeft() };
+            for (int i = 0; i < 4; ++i)
+                d = qMin(d, segmentDistance(p, v[i], v[(i + 1) % 4]));
+            break;
+        }
+        case z_qtshapes::ZQPreparedShape::TriShape: {
+            const auto &t = s.tri();
+            const QPointF v[3] = { t.first(), t.second(), t.third() };
+            for (int i = 0; i < 3; ++i)
+                d = qMin(d, segmentDistance(p, v[i], v[(i + 1) % 3]));
+            break;
+        }
+        case z_qtshapes::ZQPreparedShape::EllipseShape: {
+            const auto &e = s.ellipse();
+            for (int i = 0; i < 20000; ++i) {
+                const qreal a = 2 * M_PI * i / 20000;
+                const qreal u = e.radiusX() * qCos(a), v = e.radiusY() * qSin(a);
+                const QPointF q(e.center().x() + e.cosAngle() * u + e.sinAngle() * v,
+                                e.center().y() - e.sinAngle() * u + e.cosAngle() * v);
+                d = qMin(d, qSqrt(QPointF::dotProduct(p - q, p - q)));
+            }
+            break;
+        }
+        case z_qtshapes::ZQPreparedShape::LineShape:
+            return segmentDistance(p, s.line().p1(), s.line().p2());
+        default:
+            break;
+        }
+        return s.contains(p) ? -d : d;
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(Z_QDistanceField_1)
+{
+    QVector<z_qtshapes::ZQPreparedShape> shapes;
+    shapes.append(z_qtshapes::ZQRectF(10, 12, 30, 16, 25));
+    shapes.append(z_qtshapes::ZQTriF(QPointF(50, 5), QPointF(75, 20), QPointF(55, 40)));
+    shapes.append(z_qtshapes::ZQEllipseF(20, 40, 50, 14, 40));
+    shapes.append(z_qtshapes::ZQLineF(QPointF(60, 50), QPointF(78, 60)));
+    shapes.append(z_qtshapes::ZQEllipseF(60, 5, 8, 8));
+
+    // Every instruction set gives the same row, tails included.
+    const int n = 37;
+    for (const auto &s : shapes) {
+        std::vector<float> scalar(n, 40.f);
+        z_qtshapes::distanceRow(s, QPointF(3.5, 27.25), QPointF(2.125, 0.5), scalar.data(), n, z_qtshapes::ZQScalarLevel);
+        for (int level = z_qtshapes::ZQSSE2Level; level <= z_qtshapes::ZQAVX512Level; ++level) {
+            std::vector<float> row(n, 40.f);
+            z_qtshapes::distanceRow(s, QPointF(3.5, 27.25), QPointF(2.125, 0.5), row.data(), n,
+                                    z_qtshapes::ZQSimdLevel(level));
+            BOOST_TEST(row == scalar);
+        }
+    }
+
+    // Each shape alone matches the distance to its sampled outline.
+    const int width = 84, height = 66;
+    z_qtshapes::ZQDistanceField sdf;
+    sdf.setTransform(z_qtshapes::ZQDistanceField::gridTransform(QRectF(-1, -1, 84, 66), width, height));
+    std::vector<float> field(width * height);
+    for (const auto &s : shapes) {
+        sdf.generate(s, field.data(), width, height, width);
+        qreal worst = 0;
+        for (int y = 0; y < height; y += 3)
+            for (int x = 0; x < width; x += 3)
+                worst = qMax(worst, qAbs(field[y * width + x] - referenceDistance(s, QPointF(x - 0.5, y - 0.5))));
+        BOOST_TEST(worst < 0.01);
+    }
+
+    // The union is the minimum over the shapes, with or without threads.
+    sdf.generate(shapes.constData(), shapes.size(), field.data(), width, height, width);
+    std::vector<float> single(width * height);
+    std::vector<float> minimum(width * height, std::numeric_limits<float>::infinity());
+    for (const auto &s : shapes) {
+        sdf.generate(s, single.data(), width, height, width);
+        for (int i = 0; i < width * height; ++i)
+            minimum[i] = qMin(minimum[i], single[i]);
+    }
+    qreal worst = 0;
+    for (int i = 0; i < width * height; ++i)
+        worst = qMax(worst, qAbs(qreal(field[i] - minimum[i])));
+    BOOST_TEST(worst < 1e-4);
+
+    std::vector<float> serial(width * height);
+    sdf.setThreadPool(nullptr);
+    sdf.generate(shapes.constData(), shapes.size(), serial.data(), width, height, width);
+    BOOST_TEST(serial == field);
+
+    // A scaled, rotated grid with padded rows; the padding is untouched.
+    QMatrix3x3 rotated;
+    rotated(0, 0) = 0.5f;
+    rotated(0, 1) = -0.25f;
+    rotated(0, 2) = 30;
+    rotated(1, 0) = 0.25f;
+    rotated(1, 1) = 0.5f;
+    rotated(1, 2) = 10;
+    sdf.setTransform(rotated);
+    std::vector<float> padded(20 * 32, 7.f);
+    sdf.generate(shapes[1], padded.data(), 30, 20, 32);
+    worst = 0;
+    for (int y = 0; y < 20; ++y) {
+        for (int x = 0; x < 30; ++x) {
+            const QPointF p(30 + 0.5 * (x + 0.5) - 0.25 * (y + 0.5), 10 + 0.25 * (x + 0.5) + 0.5 * (y + 0.5));
+            worst = qMax(worst, qAbs(padded[y * 32 + x] - referenceDistance(shapes[1], p)));
+        }
+        BOOST_TEST(padded[y * 32 + 30] == 7.f);
+    }
+    BOOST_TEST(worst < 1e-3);
+
+    // Degenerate ellipses are segments and null shapes are infinitely far.
+    sdf.setTransform(QMatrix3x3());
+    const z_qtshapes::ZQPreparedShape flat(z_qtshapes::ZQEllipseF(10, 10, 20, 0));
+    sdf.generate(flat, field.data(), 40, 20, width);
+    BOOST_TEST(field[10 * width + 20] == 0.5f, boost::test_tools::tolerance(1e-5f));
+    BOOST_TEST(field[10 * width + 35] == qSqrt(5.5 * 5.5 + 0.25), boost::test_tools::tolerance(1e-5));
+    sdf.generate(z_qtshapes::ZQPreparedShape(), field.data(), 4, 4, width);
+    BOOST_TEST(std::isinf(field[0]));
+}
@@ -0,0 +1,31 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QEllipse_10
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+
+
+BOOST_AUTO_TEST_CASE(Z_QEllipse_10)
+{
+    z_qtshapes::ZQEllipse l(0, 0, 8, 4);
+    BOOST_TEST(l.contains(QPoint(4, 2)));
+    BOOST_TEST(l.contains(QPoint(7, 2)));
+    BOOST_TEST(l.contains(QPoint(8, 2)));
+    BOOST_TEST(l.contains(QPoint(4, 4)));
+    BOOST_TEST(!l.contains(QPoint(4, 5)));
+    BOOST_TEST(!l.contains(QPoint(0, 0)));
+    BOOST_TEST(!l.contains(QPoint(7, 4)));
+
+    z_qtshapes::ZQEllipse r(0, 0, 8, 4, 90);
+    BOOST_TEST(r.contains(QPoint(4, 2)));
+    BOOST_TEST(r.contains(QPoint(4, 5)));
+    BOOST_TEST(r.contains(QPoint(4, -1)));
+    BOOST_TEST(!r.contains(QPoint(7, 2)));
+    BOOST_TEST(!r.contains(QPoint(1, 2)));
+
+    z_qtshapes::ZQEllipse e;
+    BOOST_TEST(!e.contains(QPoint(0, 0)));
+}
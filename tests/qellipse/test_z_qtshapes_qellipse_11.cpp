@@ -0,0 +1,26 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QEllipse_11
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+
+BOOST_AUTO_TEST_CASE(Z_QEllipse_11)
+{
+    z_qtshapes::ZQEllipse a(0, 0, 4, 2, 90);
+    BOOST_CHECK(a.boundingRectF() == QRectF(1, -1, 2, 4));
+    BOOST_CHECK(a.boundingRect() == QRect(1, -1, 2, 4));
+
+    a = z_qtshapes::ZQEllipse(0, 0, 4, 4, 30);
+    BOOST_CHECK(a.boundingRectF() == QRectF(0, 0, 4, 4));
+
+    // sqrt(4*cos^2(45) + 1*sin^2(45)) = sqrt(2.5) on both axes.
+    a = z_qtshapes::ZQEllipse(0, 0, 4, 2, 45);
+    const QRectF b = a.boundingRectF();
+    BOOST_TEST(qAbs(b.left() - (2 - qSqrt(2.5))) < 1e-9);
+    BOOST_TEST(qAbs(b.top() - (1 - qSqrt(2.5))) < 1e-9);
+    BOOST_TEST(qAbs(b.height() - 2 * qSqrt(2.5)) < 1e-9);
+    BOOST_CHECK(a.boundingRect() == QRect(0, -1, 4, 4));
+}
@@ -0,0 +1,34 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QEllipseF_10
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+
+
+BOOST_AUTO_TEST_CASE(Z_QEllipseF_10)
+{
+    z_qtshapes::ZQEllipseF l(0, 0, 4, 2);
+    BOOST_TEST(l.contains(QPointF(2, 1)));
+    BOOST_TEST(l.contains(QPointF(3.9, 1)));
+    BOOST_TEST(l.contains(QPointF(2, 1.9)));
+    BOOST_TEST(!l.contains(QPointF(2, 2.5)));
+    BOOST_TEST(!l.contains(QPointF(0.1, 0.1)));
+    BOOST_TEST(!l.contains(QPointF(3.9, 1.9)));
+
+    z_qtshapes::ZQEllipseF r(0, 0, 4, 2, 90);
+    BOOST_TEST(r.contains(QPointF(2, 1)));
+    BOOST_TEST(r.contains(QPointF(2, 2.9)));
+    BOOST_TEST(r.contains(QPointF(2, -0.9)));
+    BOOST_TEST(!r.contains(QPointF(3.9, 1)));
+    BOOST_TEST(!r.contains(QPointF(0.1, 1)));
+
+    z_qtshapes::ZQEllipseF n(4, 2, -4, -2, 45);
+    BOOST_TEST(n.contains(QPointF(2.5, 1.5)));
+    BOOST_TEST(!n.contains(QPointF(3.5, 1.9)));
+
+    z_qtshapes::ZQEllipseF e;
+    BOOST_TEST(!e.contains(QPointF(0, 0)));
+}
@@ -0,0 +1,26 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QEllipseF_11
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+
+
+BOOST_AUTO_TEST_CASE(Z_QEllipseF_11)
+{
+    z_qtshapes::ZQEllipseF e(0, 0, 20, 10, 90);
+    z_qtshapes::ZQPreparedEllipseF p = e.prepared();
+    BOOST_TEST(p.radiusX() == 10);
+    BOOST_TEST(p.radiusY() == 5);
+    BOOST_TEST(qAbs(p.boundingRect().width() - 10) < 1e-9);
+    BOOST_TEST(qAbs(p.boundingRect().height() - 20) < 1e-9);
+
+    const QPointF points[] = { QPointF(10, 5), QPointF(10, -4), QPointF(10, 15), QPointF(0, 5), QPointF(14, 5), QPointF(16, 5) };
+    for (const QPointF &q : points)
+        BOOST_TEST(p.contains(q) == e.contains(q));
+
+    BOOST_TEST(!e.intersects(z_qtshapes::ZQEllipseF(100, 100, 4, 4).prepared()));
+    BOOST_TEST(!e.contains(z_qtshapes::ZQEllipseF(-20, -20, 60, 60).prepared()));
+}
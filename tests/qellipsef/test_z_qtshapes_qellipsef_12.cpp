@@ -0,0 +1,39 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QEllipseF_12
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+
+BOOST_AUTO_TEST_CASE(Z_QEllipseF_12)
+{
+    z_qtshapes::ZQEllipseF a(0, 0, 4, 2);
+    BOOST_CHECK(a.boundingRect() == QRectF(0, 0, 4, 2));
+    a = z_qtshapes::ZQEllipseF(0, 0, 4, 2, 90);
+    BOOST_CHECK(a.boundingRect() == QRectF(1, -1, 2, 4));
+
+    // The box is tight: every boundary point is inside and the extremes touch it.
+    for (int angle = 0; angle < 360; angle += 11) {
+        a = z_qtshapes::ZQEllipseF(2, -1, 12, 5, angle + 0.25);
+        const QRectF b = a.boundingRect();
+        const qreal rad = M_PI/180 * a.angle();
+        const qreal c = qCos(rad), s = qSin(rad);
+        qreal l = 1e9, t = 1e9, r = -1e9, bt = -1e9;
+        for (int i = 0; i < 3600; ++i) {
+            const qreal u = 6 * qCos(2*M_PI * i / 3600), v = 2.5 * qSin(2*M_PI * i / 3600);
+            const qreal x = a.center().x() + c*u + s*v;
+            const qreal y = a.center().y() - s*u + c*v;
+            l = qMin(l, x); t = qMin(t, y); r = qMax(r, x); bt = qMax(bt, y);
+        }
+        BOOST_TEST(b.left() <= l + 1e-9);
+        BOOST_TEST(b.top() <= t + 1e-9);
+        BOOST_TEST(b.right() >= r - 1e-9);
+        BOOST_TEST(b.bottom() >= bt - 1e-9);
+        BOOST_TEST(l - b.left() < 1e-4);
+        BOOST_TEST(t - b.top() < 1e-4);
+        BOOST_TEST(b.right() - r < 1e-4);
+        BOOST_TEST(b.bottom() - bt < 1e-4);
+    }
+}
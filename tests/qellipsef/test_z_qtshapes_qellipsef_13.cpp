@@ -0,0 +1,69 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QEllipseF_13
+#include <boost/test/included/unit_test.hpp>
+
+#include <vector>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+
+namespace {
+
+    // Signed area of every indexed triangle, summed; fails on a negative one.
+    double triangleArea(const std::vector<float> &v, const std::vector<quint32> &idx, quint32 base)
+    {
+        double total = 0;
+        for (std::size_t i = 0; i < idx.size(); i += 3) {
+            const quint32 a = idx[i] - base, b = idx[i + 1] - base, c = idx[i + 2] - base;
+            const double area = 0.5 * ((v[2*b] - v[2*a]) * (v[2*c + 1] - v[2*a + 1])
+                    - (v[2*b + 1] - v[2*a + 1]) * (v[2*c] - v[2*a]));
+            BOOST_TEST(area >= 0);
+            total += area;
+        }
+        return total;
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(Z_QEllipseF_13)
+{
+    z_qtshapes::ZQEllipseF a(0, 0, 100, 40, 30);
+
+    // The segment count grows with the size and shrinks with the tolerance.
+    BOOST_TEST(a.segmentCount(0.5) % 4 == 0);
+    BOOST_TEST(a.segmentCount(0.1) > a.segmentCount(0.5));
+    BOOST_TEST(z_qtshapes::ZQEllipseF(0, 0, 1000, 400, 30).segmentCount(0.5) > a.segmentCount(0.5));
+    BOOST_TEST(a.segmentCount(100) == 4);
+    BOOST_TEST(a.segmentCount(0) == 4096);
+    BOOST_TEST(a.segmentCount(0.5) == a.prepared().segmentCount(0.5));
+    BOOST_TEST(a.tessellationVertexCount(0.5) == a.segmentCount(0.5) + 1);
+    BOOST_TEST(a.tessellationIndexCount(0.5) == 3 * a.segmentCount(0.5));
+
+    for (qreal tolerance : { 2.0, 0.5, 0.05 }) {
+        std::vector<float> v(2 * a.tessellationVertexCount(tolerance));
+        std::vector<quint32> idx(a.tessellationIndexCount(tolerance));
+        a.tessellate(tolerance, v.data(), idx.data(), 7);
+
+        BOOST_TEST(v[0] == 50);
+        BOOST_TEST(v[1] == 20);
+        for (quint32 i : idx)
+            BOOST_TEST((i >= 7 && i < 7 + v.size() / 2));
+
+        // Rim vertices lie on the ellipse.
+        const qreal rad = M_PI/180 * 30;
+        for (std::size_t i = 1; i < v.size() / 2; ++i) {
+            const qreal dx = v[2*i] - 50, dy = v[2*i + 1] - 20;
+            const qreal lx = (qCos(rad) * dx - qSin(rad) * dy) / 50;
+            const qreal ly = (qSin(rad) * dx + qCos(rad) * dy) / 20;
+            BOOST_TEST(qAbs(lx * lx + ly * ly - 1) < 1e-5);
+        }
+
+        // The polygon is inscribed, so it misses at most a band of width
+        // tolerance along the perimeter.
+        const double area = triangleArea(v, idx, 7);
+        BOOST_TEST(area <= M_PI * 50 * 20 + 1e-3);
+        BOOST_TEST(M_PI * 50 * 20 - area <= 2 * M_PI * 50 * tolerance);
+    }
+}
@@ -0,0 +1,103 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QEllipseF_14
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+
+namespace {
+
+    // The implicit function of the ellipse: negative inside, zero on the outline.
+    qreal outline(const z_qtshapes::ZQPreparedEllipseF &e, const QPointF &p)
+    {
+        const qreal dx = p.x() - e.center().x(), dy = p.y() - e.center().y();
+        const qreal lx = (e.cosAngle() * dx - e.sinAngle() * dy) / e.radiusX();
+        const qreal ly = (e.sinAngle() * dx + e.cosAngle() * dy) / e.radiusY();
+        return lx * lx + ly * ly - 1;
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(Z_QEllipseF_14)
+{
+    // Circles of radius 5 whose centers are 6 apart meet at (3, +-4).
+    const z_qtshapes::ZQEllipseF a(-5, -5, 10, 10);
+    const z_qtshapes::ZQEllipseF b(1, -5, 10, 10);
+    BOOST_TEST(a.intersects(b));
+    const QVector<QPointF> ab = a.intersectionPoints(b);
+    BOOST_TEST(ab.size() == 2);
+    for (const QPointF &p : ab) {
+        BOOST_TEST(qAbs(p.x() - 3) < 1e-9);
+        BOOST_TEST(qAbs(qAbs(p.y()) - 4) < 1e-9);
+    }
+
+    // Just apart, touching and just overlapping.
+    BOOST_TEST(!a.intersects(z_qtshapes::ZQEllipseF(5.001, -5, 10, 10)));
+    BOOST_TEST(a.intersectionPoints(z_qtshapes::ZQEllipseF(5.001, -5, 10, 10)).isEmpty());
+    BOOST_TEST(a.intersects(z_qtshapes::ZQEllipseF(5, -5, 10, 10)));
+    BOOST_TEST(z_qtshapes::ZQEllipseF(5, -5, 10, 10).intersects(a));
+    BOOST_TEST(a.intersects(z_qtshapes::ZQEllipseF(4.999, -5, 10, 10)));
+    const QVector<QPointF> touching = a.intersectionPoints(z_qtshapes::ZQEllipseF(5, -5, 10, 10));
+    BOOST_TEST(touching.size() == 1);
+    BOOST_TEST(qAbs(touching[0].x() - 5) < 1e-6);
+    BOOST_TEST(qAbs(touching[0].y()) < 1e-3);
+
+    // A long ellipse and its quarter turn cross in four points.
+    const z_qtshapes::ZQEllipseF h(-10, -2, 20, 4);
+    const z_qtshapes::ZQEllipseF v(-10, -2, 20, 4, 90);
+    const QVector<QPointF> hv = h.intersectionPoints(v);
+    BOOST_TEST(hv.size() == 4);
+    for (const QPointF &p : hv) {
+        BOOST_TEST(qAbs(outline(h.prepared(), p)) < 1e-9);
+        BOOST_TEST(qAbs(outline(v.prepared(), p)) < 1e-9);
+    }
+
+    // Nested ellipses overlap without meeting, and the integer class agrees.
+    BOOST_TEST(h.intersects(z_qtshapes::ZQEllipseF(-1, -1, 2, 2, 30)));
+    BOOST_TEST(h.intersectionPoints(z_qtshapes::ZQEllipseF(-1, -1, 2, 2, 30)).isEmpty());
+    BOOST_TEST(z_qtshapes::ZQEllipse(0, 0, 10, 10).intersects(z_qtshapes::ZQEllipse(6, 0, 10, 10)));
+    BOOST_TEST(z_qtshapes::ZQEllipse(0, 0, 10, 10).intersectionPoints(z_qtshapes::ZQEllipse(6, 0, 10, 10)).size() == 2);
+
+    // Random pairs against a dense sampling of the outlines.
+    quint32 seed = 11;
+    auto next = [&seed]() { seed = seed * 1664525u + 1013904223u; return (seed >> 8) / qreal(1 << 24); };
+    int decided = 0;
+    for (int k = 0; k < 300; ++k) {
+        const z_qtshapes::ZQPreparedEllipseF p = z_qtshapes::ZQEllipseF(next() * 10, next() * 10,
+                1 + next() * 10, 1 + next() * 10, next() * 360).prepared();
+        const z_qtshapes::ZQPreparedEllipseF q = z_qtshapes::ZQEllipseF(next() * 10, next() * 10,
+                1 + next() * 10, 1 + next() * 10, next() * 360).prepared();
+
+        qreal lowest = outline(q, p.center()) < 0 || outline(p, q.center()) < 0 ? -1 : 1e9;
+        int crossings = 0;
+        const int samples = 20000;
+        qreal previous = 0;
+        for (int i = 0; i <= samples; ++i) {
+            const qreal theta = 2 * M_PI * i / samples;
+            const qreal u = p.radiusX() * qCos(theta), w = p.radiusY() * qSin(theta);
+            const QPointF x(p.center().x() + p.cosAngle() * u + p.sinAngle() * w,
+                            p.center().y() - p.sinAngle() * u + p.cosAngle() * w);
+            const qreal f = outline(q, x);
+            lowest = qMin(lowest, f);
+            if (i > 0 && (f < 0) != (previous < 0))
+                ++crossings;
+            previous = f;
+        }
+
+        QPointF points[4];
+        const int n = p.intersectionPoints(q, points);
+        for (int i = 0; i < n; ++i) {
+            BOOST_TEST(qAbs(outline(p, points[i])) < 1e-8);
+            BOOST_TEST(qAbs(outline(q, points[i])) < 1e-8);
+        }
+        if (qAbs(lowest) > 1e-3) {
+            ++decided;
+            BOOST_TEST(p.intersects(q) == (lowest < 0));
+            BOOST_TEST(q.intersects(p) == (lowest < 0));
+            BOOST_TEST(n == crossings);
+        }
+    }
+    BOOST_TEST(decided > 250);
+}
@@ -0,0 +1,162 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QGjk_1
+#include <boost/test/included/unit_test.hpp>
+
+#include <limits>
+#include <vector>
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+#include "z_qgjk.h"
+
+namespace {
+
+    // Dense outline of a prepared shape, closed for polygons.
+    std::vector<QPointF> outline(const z_qtshapes::ZQPreparedShape &s)
+    {
+        std::vector<QPointF> v;
+        switch (s.type()) {
+        case z_qtshapes::ZQPreparedShape::RectShape:
+            v = { s.rect().topRight(), s.rect().bottomRight(), s.rect().bottomLeft(), s.rect().topLeft() };
+            break;
+        case z_qtshapes::ZQPreparedShape::TriShape:
+            v = { s.tri().first(), s.tri().second(), s.tri().third() };
+            break;
+        case z_qtshapes::ZQPreparedShape::EllipseShape:
+            for (int i = 0; i < 4096; ++i) {
+                const qreal a = 2 * M_PI * i / 4096;
+                v.push_back(z_qtshapes::supportPoint(s.ellipse(), QPointF(qCos(a), qSin(a))));
+            }
+            break;
+        case z_qtshapes::ZQPreparedShape::LineShape:
+            return { s.line().p1(), s.line().p2() };
+        default:
+            break;
+        }
+        v.push_back(v.front());
+        return v;
+    }
+
+    qreal segmentDistance(const QPointF &p, const QPointF &a, const QPointF &b)
+    {
+        const QPointF ab = b - a, ap = p - a;
+        const qreal len2 = QPointF::dotProduct(ab, ab);
+        const qreal t = len2 > 0 ? qBound(qreal(0), QPointF::dotProduct(ap, ab) / len2, qreal(1)) : 0;
+        const QPointF d = ap - ab * t;
+        return qSqrt(QPointF::dotProduct(d, d));
+    }
+
+    // Distance between separate shapes: the closest pair always has one
+    // point on a vertex of one outline.
+    qreal referenceDistance(const z_qtshapes::ZQPreparedShape &a, const z_qtshapes::ZQPreparedShape &b)
+    {
+        const std::vector<QPointF> va = outline(a), vb = outline(b);
+        qreal d = std::numeric_limits<qreal>::infinity();
+        for (std::size_t i = 0; i + 1 < vb.size(); ++i)
+            for (const QPointF &p : va)
+                d = qMin(d, segmentDistance(p, vb[i], vb[i + 1]));
+        for (std::size_t i = 0; i + 1 < va.size(); ++i)
+            for (const QPointF &p : vb)
+                d = qMin(d, segmentDistance(p, va[i], va[i + 1]));
+        return d;
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(Z_QGjk_1)
+{
+    QVector<z_qtshapes::ZQPreparedShape> shapes;
+    shapes.append(z_qtshapes::ZQRectF(0, 0, 30, 16, 25));
+    shapes.append(z_qtshapes::ZQTriF(QPointF(60, 5), QPointF(85, 20), QPointF(65, 40)));
+    shapes.append(z_qtshapes::ZQEllipseF(10, 50, 50, 14, 40));
+    shapes.append(z_qtshapes::ZQLineF(QPointF(72, 62), QPointF(110, 65)));
+    shapes.append(z_qtshapes::ZQEllipseF(70, 60, 12, 12));
+    shapes.append(z_qtshapes::ZQTriF(QPointF(20, 10), QPointF(50, 30), QPointF(15, 35)));
+    shapes.append(z_qtshapes::ZQTriF(QPointF(30, 45), QPointF(45, 50), QPointF(35, 62)));
+
+    // Points: the same distance as ZQPreparedShape::distance().
+    for (const auto &s : shapes) {
+        for (int i = 0; i < 40; ++i) {
+            const QPointF p(-10 + 3.1 * i, 70 - 2.3 * i);
+            BOOST_TEST(z_qtshapes::distance(s, p) == s.distance(p), boost::test_tools::tolerance(1e-6));
+        }
+    }
+
+    // Pairs: distances match the outlines, the witness points are that far
+    // apart and lie on their shapes, and overlaps give a common point.
+    int separate = 0, overlapping = 0;
+    for (int i = 0; i < shapes.size(); ++i) {
+        for (int j = 0; j < shapes.size(); ++j) {
+            const z_qtshapes::ZQClosestPoints c = z_qtshapes::closestPoints(shapes[i], shapes[j]);
+            BOOST_TEST(c.iterations < 64);
+            BOOST_TEST(shapes[i].distance(c.pointA) < 1e-6);
+            BOOST_TEST(shapes[j].distance(c.pointB) < 1e-6);
+            if (shapes[i].intersects(shapes[j])) {
+                BOOST_TEST(c.overlapping());
+                BOOST_TEST((c.pointA == c.pointB));
+                ++overlapping;
+            } else {
+                BOOST_TEST(c.distance == referenceDistance(shapes[i], shapes[j]), boost::test_tools::tolerance(1e-4));
+                BOOST_TEST(qSqrt(QPointF::dotProduct(c.pointA - c.pointB, c.pointA - c.pointB)) == c.distance,
+                           boost::test_tools::tolerance(1e-9));
+                ++separate;
+            }
+        }
+    }
+    BOOST_TEST(separate > 10);
+    BOOST_TEST(overlapping > 12);
+    BOOST_TEST(shapes[0].distance(shapes[3]) == z_qtshapes::distance(shapes[0], shapes[3]));
+    BOOST_TEST(std::isinf(shapes[0].distance(z_qtshapes::ZQPreparedShape())));
+
+    // Plain and integer shape classes are prepared on the way in.
+    BOOST_TEST(z_qtshapes::distance(z_qtshapes::ZQRect(0, 0, 10, 10), z_qtshapes::ZQRectF(20, 0, 10, 10)) == 10,
+               boost::test_tools::tolerance(1e-9));
+    BOOST_TEST(z_qtshapes::distance(z_qtshapes::ZQLine(QPoint(0, 0), QPoint(0, 10)), QPoint(3, 4)) == 3,
+               boost::test_tools::tolerance(1e-9));
+    BOOST_TEST(z_qtshapes::distance(z_qtshapes::ZQEllipseF(-5, -5, 10, 10), z_qtshapes::ZQTriF(QPointF(8, -1), QPointF(12, 0), QPointF(8, 1)))
+               == 3, boost::test_tools::tolerance(1e-7));
+
+    // Penetration: the smallest push apart, pointing from a to b.
+    z_qtshapes::ZQPenetration pen = z_qtshapes::penetration(z_qtshapes::ZQRectF(0, 0, 10, 10), z_qtshapes::ZQRectF(8, 2, 10, 4));
+    BOOST_TEST(pen.overlapping);
+    BOOST_TEST(pen.depth == 2, boost::test_tools::tolerance(1e-9));
+    BOOST_TEST(pen.normal.x() == 1, boost::test_tools::tolerance(1e-9));
+    BOOST_TEST(qAbs(pen.normal.y()) < 1e-9);
+
+    pen = z_qtshapes::penetration(z_qtshapes::ZQEllipseF(-5, -5, 10, 10), z_qtshapes::ZQEllipseF(1, -3, 6, 6));
+    BOOST_TEST(pen.depth == 4, boost::test_tools::tolerance(1e-6));
+    BOOST_TEST(pen.normal.x() == 1, boost::test_tools::tolerance(1e-6));
+    BOOST_TEST(pen.pointA.x() == 5, boost::test_tools::tolerance(1e-6));
+    BOOST_TEST(pen.pointB.x() == 1, boost::test_tools::tolerance(1e-6));
+
+    // Moving the second shape by the penetration vector leaves them touching.
+    int pushed = 0;
+    for (int i = 0; i < shapes.size(); ++i) {
+        for (int j = 0; j < shapes.size(); ++j) {
+            if (i == j || !shapes[i].intersects(shapes[j]))
+                continue;
+            pen = z_qtshapes::penetration(shapes[i], shapes[j]);
+            BOOST_TEST(pen.overlapping);
+            BOOST_TEST(pen.depth > 0);
+            const QPointF push = pen.normal * pen.depth;
+            BOOST_TEST(qSqrt(QPointF::dotProduct(pen.pointA - pen.pointB - push, pen.pointA - pen.pointB - push)) < 1e-9);
+            z_qtshapes::ZQPreparedShape moved;
+            if (shapes[j].type() == z_qtshapes::ZQPreparedShape::TriShape)
+                moved = z_qtshapes::ZQTriF(shapes[j].tri().first() + push, shapes[j].tri().second() + push,
+                                           shapes[j].tri().third() + push);
+            else if (shapes[j].type() == z_qtshapes::ZQPreparedShape::LineShape)
+                moved = z_qtshapes::ZQLineF(shapes[j].line().p1() + push, shapes[j].line().p2() + push);
+            else
+                continue;
+            BOOST_TEST(z_qtshapes::distance(shapes[i], moved) < 1e-6);
+            BOOST_TEST(z_qtshapes::penetration(shapes[i], moved).depth < 1e-6);
+            ++pushed;
+        }
+    }
+    BOOST_TEST(pushed >= 3);
+
+    // Separate shapes report minus their distance.
+    pen = z_qtshapes::penetration(shapes[0], shapes[1]);
+    BOOST_TEST(!pen.overlapping);
+    BOOST_TEST(pen.depth == -z_qtshapes::distance(shapes[0], shapes[1]));
+}
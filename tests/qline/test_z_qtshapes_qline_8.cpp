@@ -0,0 +1,53 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QLine_8
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+
+
+BOOST_AUTO_TEST_CASE(Z_QLine_8)
+{
+    z_qtshapes::ZQLine l(0, 0, 10, 10);
+    BOOST_TEST(l.contains(QPoint(5, 5)));
+    BOOST_TEST(l.contains(QPoint(10, 10)));
+    BOOST_TEST(!l.contains(QPoint(5, 6)));
+    BOOST_TEST(l.contains(QPoint(5, 6), 1));
+    BOOST_TEST(!l.contains(QPoint(11, 11)));
+
+    qreal t = -1, u = -1;
+    z_qtshapes::ZQLine m(0, 10, 10, 0);
+    BOOST_TEST(l.intersects(m));
+    BOOST_TEST(l.intersectionPoint(m, &t, &u) == z_qtshapes::ZQLine::BoundedIntersection);
+    BOOST_TEST(t == 0.5);
+    BOOST_TEST(u == 0.5);
+    BOOST_TEST(l.intersects(z_qtshapes::ZQLine(10, 10, 20, 0)));
+
+    z_qtshapes::ZQLine n(20, 0, 30, -10);
+    BOOST_TEST(!l.intersects(n));
+    BOOST_TEST(l.intersectionPoint(n, &t, &u) == z_qtshapes::ZQLine::UnboundedIntersection);
+    BOOST_TEST(t == 1);
+    BOOST_TEST(u == -1);
+
+    z_qtshapes::ZQLine o(0, 1, 10, 11);
+    BOOST_TEST(!l.intersects(o));
+    BOOST_TEST(l.intersectionPoint(o, &t, &u) == z_qtshapes::ZQLine::NoIntersection);
+    BOOST_TEST(l.intersects(o, 1));
+
+    z_qtshapes::ZQLine c(5, 5, 15, 15);
+    BOOST_TEST(l.intersects(c));
+    BOOST_TEST(l.intersectionPoint(c, &t, &u) == z_qtshapes::ZQLine::BoundedIntersection);
+    BOOST_TEST(t == 0.5);
+    BOOST_TEST(u == 0);
+    BOOST_TEST(!l.contains(c));
+    BOOST_TEST(l.contains(z_qtshapes::ZQLine(2, 2, 4, 4)));
+    BOOST_TEST(!l.intersects(z_qtshapes::ZQLine(11, 11, 12, 12)));
+    BOOST_TEST(l.intersectionPoint(z_qtshapes::ZQLine(11, 11, 12, 12), nullptr, nullptr) == z_qtshapes::ZQLine::NoIntersection);
+
+    z_qtshapes::ZQLine r(0, 0, 10, 10, 90);
+    BOOST_TEST(r.contains(QPoint(2, 8), 1e-9));
+    BOOST_TEST(!l.contains(QPoint(2, 8)));
+    BOOST_TEST(r.contains(m, 1e-9));
+}
@@ -0,0 +1,20 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QLine_9
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+
+BOOST_AUTO_TEST_CASE(Z_QLine_9)
+{
+    z_qtshapes::ZQLine a(QPoint(0, 0), QPoint(4, 0), 90);
+    BOOST_CHECK(a.boundingRectF() == QRectF(2, -2, 0, 4));
+    BOOST_CHECK(a.boundingRect() == QRect(2, -2, 0, 4));
+
+    // The center (1, 0) is truncated from (1.5, 0).
+    a = z_qtshapes::ZQLine(QPoint(0, 0), QPoint(3, 0), 180);
+    BOOST_CHECK(a.boundingRectF() == QRectF(-1, 0, 3, 0));
+    BOOST_CHECK(a.boundingRect() == QRect(-1, 0, 3, 0));
+}
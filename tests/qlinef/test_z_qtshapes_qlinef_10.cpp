@@ -0,0 +1,55 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QLineF_10
+#include <boost/test/included/unit_test.hpp>
+
+#include <vector>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+
+namespace {
+
+    // Signed area of every indexed triangle, summed; fails on a negative one.
+    double triangleArea(const std::vector<float> &v, const std::vector<quint32> &idx, quint32 base)
+    {
+        double total = 0;
+        for (std::size_t i = 0; i < idx.size(); i += 3) {
+            const quint32 a = idx[i] - base, b = idx[i + 1] - base, c = idx[i + 2] - base;
+            const double area = 0.5 * ((v[2*b] - v[2*a]) * (v[2*c + 1] - v[2*a + 1])
+                    - (v[2*b + 1] - v[2*a + 1]) * (v[2*c] - v[2*a]));
+            BOOST_TEST(area >= 0);
+            total += area;
+        }
+        return total;
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(Z_QLineF_10)
+{
+    std::vector<float> v(8);
+    std::vector<quint32> idx(6);
+
+    z_qtshapes::ZQLineF a(QPointF(0, 0), QPointF(4, 0));
+    BOOST_TEST(a.strokeVertexCount() == 4);
+    BOOST_TEST(a.strokeIndexCount() == 6);
+    a.tessellateStroke(2, v.data(), idx.data());
+    const float expected[8] = { 0, -1, 4, -1, 4, 1, 0, 1 };
+    for (int i = 0; i < 8; ++i)
+        BOOST_TEST(v[i] == expected[i]);
+    BOOST_TEST(qAbs(triangleArea(v, idx, 0) - 8) < 1e-5);
+
+    // Rotated a quarter turn about its center (2, 0).
+    a = z_qtshapes::ZQLineF(QPointF(0, 0), QPointF(4, 0), 90);
+    a.tessellateStroke(1, v.data(), idx.data(), 4);
+    BOOST_TEST(qAbs(triangleArea(v, idx, 4) - 4) < 1e-5);
+    for (int i = 0; i < 4; ++i)
+        BOOST_TEST(qAbs(v[2*i] - 2) <= 0.5 + 1e-6);
+
+    // A zero length line has no area.
+    a = z_qtshapes::ZQLineF(QPointF(1, 1), QPointF(1, 1));
+    a.tessellateStroke(3, v.data(), idx.data());
+    BOOST_TEST(triangleArea(v, idx, 0) == 0);
+}
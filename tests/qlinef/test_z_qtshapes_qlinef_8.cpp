@@ -0,0 +1,53 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QLineF_8
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+
+
+BOOST_AUTO_TEST_CASE(Z_QLineF_8)
+{
+    z_qtshapes::ZQLineF l(0, 0, 10, 10);
+    BOOST_TEST(l.contains(QPointF(5, 5)));
+    BOOST_TEST(l.contains(QPointF(10, 10)));
+    BOOST_TEST(!l.contains(QPointF(5, 6)));
+    BOOST_TEST(l.contains(QPointF(5, 6), 1));
+    BOOST_TEST(!l.contains(QPointF(11, 11)));
+
+    qreal t = -1, u = -1;
+    z_qtshapes::ZQLineF m(0, 10, 10, 0);
+    BOOST_TEST(l.intersects(m));
+    BOOST_TEST(l.intersectionPoint(m, &t, &u) == z_qtshapes::ZQLineF::BoundedIntersection);
+    BOOST_TEST(t == 0.5);
+    BOOST_TEST(u == 0.5);
+    BOOST_TEST(l.intersects(z_qtshapes::ZQLineF(10, 10, 20, 0)));
+
+    z_qtshapes::ZQLineF n(20, 0, 30, -10);
+    BOOST_TEST(!l.intersects(n));
+    BOOST_TEST(l.intersectionPoint(n, &t, &u) == z_qtshapes::ZQLineF::UnboundedIntersection);
+    BOOST_TEST(t == 1);
+    BOOST_TEST(u == -1);
+
+    z_qtshapes::ZQLineF o(0, 1, 10, 11);
+    BOOST_TEST(!l.intersects(o));
+    BOOST_TEST(l.intersectionPoint(o, &t, &u) == z_qtshapes::ZQLineF::NoIntersection);
+    BOOST_TEST(l.intersects(o, 1));
+
+    z_qtshapes::ZQLineF c(5, 5, 15, 15);
+    BOOST_TEST(l.intersects(c));
+    BOOST_TEST(l.intersectionPoint(c, &t, &u) == z_qtshapes::ZQLineF::BoundedIntersection);
+    BOOST_TEST(t == 0.5);
+    BOOST_TEST(u == 0);
+    BOOST_TEST(!l.contains(c));
+    BOOST_TEST(l.contains(z_qtshapes::ZQLineF(2, 2, 4, 4)));
+    BOOST_TEST(!l.intersects(z_qtshapes::ZQLineF(11, 11, 12, 12)));
+    BOOST_TEST(l.intersectionPoint(z_qtshapes::ZQLineF(11, 11, 12, 12), nullptr, nullptr) == z_qtshapes::ZQLineF::NoIntersection);
+
+    z_qtshapes::ZQLineF r(0, 0, 10, 10, 90);
+    BOOST_TEST(r.contains(QPointF(2, 8), 1e-9));
+    BOOST_TEST(!l.contains(QPointF(2, 8)));
+    BOOST_TEST(r.contains(m, 1e-9));
+}
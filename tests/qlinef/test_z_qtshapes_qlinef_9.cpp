@@ -0,0 +1,25 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QLineF_9
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+
+BOOST_AUTO_TEST_CASE(Z_QLineF_9)
+{
+    z_qtshapes::ZQLineF a(QPointF(0, 0), QPointF(4, 2));
+    BOOST_CHECK(a.boundingRect() == QRectF(0, 0, 4, 2));
+
+    // Rotated clockwise about its center (2, 0).
+    a = z_qtshapes::ZQLineF(QPointF(0, 0), QPointF(4, 0), 90);
+    BOOST_CHECK(a.boundingRect() == QRectF(2, -2, 0, 4));
+
+    a = z_qtshapes::ZQLineF(QPointF(0, 0), QPointF(4, 0), 45);
+    const QRectF b = a.boundingRect();
+    BOOST_TEST(qAbs(b.left() - (2 - qSqrt(2.))) < 1e-9);
+    BOOST_TEST(qAbs(b.top() - -qSqrt(2.)) < 1e-9);
+    BOOST_TEST(qAbs(b.width() - 2 * qSqrt(2.)) < 1e-9);
+    BOOST_TEST(qAbs(b.height() - 2 * qSqrt(2.)) < 1e-9);
+}
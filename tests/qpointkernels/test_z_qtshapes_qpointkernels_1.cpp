@@ -0,0 +1,52 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QPointKernels_1
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+#include "z_qpointkernels.h"
+
+
+BOOST_AUTO_TEST_CASE(Z_QPointKernels_1)
+{
+    quint32 seed = 777;
+    auto next = [&seed]() { seed = seed * 1664525u + 1013904223u; return (seed >> 8) / qreal(1 << 24); };
+
+    const int n = 1003;
+    QVector<qreal> x(n), y(n);
+    for (int i = 0; i < n; ++i) {
+        x[i] = next() * 40 - 5;
+        y[i] = next() * 40 - 5;
+    }
+
+    const z_qtshapes::ZQRectF rect(5, 8, 20, 10, 33);
+    const z_qtshapes::ZQEllipseF ellipse(4, 6, 22, 12, 250);
+    const z_qtshapes::ZQTriF tri(QPointF(2, 3), QPointF(28, 9), QPointF(12, 27), 71);
+
+    QVector<quint8> mask((n + 7) / 8 + 1, 0xff);
+    int inside = 0;
+
+    z_qtshapes::containsPoints(rect, x.data(), y.data(), n, mask.data());
+    for (int i = 0; i < n; ++i) {
+        const bool bit = (mask[i / 8] >> (i % 8)) & 1;
+        BOOST_TEST(bit == rect.prepared().contains(QPointF(x[i], y[i])));
+        inside += bit;
+    }
+    BOOST_TEST((mask[n / 8] >> (n % 8)) == 0);
+    BOOST_TEST(mask[(n + 7) / 8] == 0xff);
+    BOOST_TEST(inside > 0);
+
+    z_qtshapes::containsPoints(ellipse, x.data(), y.data(), n, mask.data());
+    for (int i = 0; i < n; ++i)
+        BOOST_TEST(bool((mask[i / 8] >> (i % 8)) & 1) == ellipse.contains(QPointF(x[i], y[i])));
+
+    z_qtshapes::containsPoints(tri, x.data(), y.data(), n, mask.data());
+    for (int i = 0; i < n; ++i)
+        BOOST_TEST(bool((mask[i / 8] >> (i % 8)) & 1) == tri.prepared().contains(QPointF(x[i], y[i])));
+
+    z_qtshapes::containsPoints(z_qtshapes::ZQEllipseF(1, 1, 0, 5), x.data(), y.data(), n, mask.data());
+    for (int i = 0; i < (n + 7) / 8; ++i)
+        BOOST_TEST(mask[i] == 0);
+}
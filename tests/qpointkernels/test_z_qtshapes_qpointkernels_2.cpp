@@ -0,0 +1,62 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QPointKernels_2
+#include <boost/test/included/unit_test.hpp>
+
+#include <limits>
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+#include "z_qpointkernels.h"
+
+
+BOOST_AUTO_TEST_CASE(Z_QPointKernels_2)
+{
+    // Every instruction set must produce the scalar mask bit for bit,
+    // also for points on the edges, unaligned arrays and NaN.
+    quint32 seed = 99;
+    auto next = [&seed]() { seed = seed * 1664525u + 1013904223u; return (seed >> 8) / qreal(1 << 24); };
+
+    const z_qtshapes::ZQPreparedRectF rect = z_qtshapes::ZQRectF(0, 0, 16, 8, 90).prepared();
+    const z_qtshapes::ZQPreparedEllipseF ellipse = z_qtshapes::ZQEllipseF(0, 0, 16, 8, 45).prepared();
+    const z_qtshapes::ZQPreparedTriF tri = z_qtshapes::ZQTriF(QPointF(0, 0), QPointF(16, 0), QPointF(0, 16)).prepared();
+
+    const int n = 515;
+    QVector<qreal> x(n + 1), y(n + 1);
+    for (int i = 0; i <= n; ++i) {
+        x[i] = i % 3 == 0 ? qRound(next() * 20) - 2 : next() * 20 - 2;
+        y[i] = i % 5 == 0 ? qRound(next() * 20) - 2 : next() * 20 - 2;
+    }
+    x[7] = std::numeric_limits<qreal>::quiet_NaN();
+    y[12] = std::numeric_limits<qreal>::infinity();
+
+    const z_qtshapes::ZQSimdLevel levels[] = {
+        z_qtshapes::ZQSSE2Level, z_qtshapes::ZQAVX2Level, z_qtshapes::ZQAVX512Level
+    };
+    for (int offset = 0; offset < 2; ++offset) {
+        const qreal *px = x.data() + offset;
+        const qreal *py = y.data() + offset;
+        QVector<quint8> scalar((n + 7) / 8), vector((n + 7) / 8);
+
+        z_qtshapes::containsPoints(rect, px, py, n, scalar.data(), z_qtshapes::ZQScalarLevel);
+        for (z_qtshapes::ZQSimdLevel level : levels) {
+            z_qtshapes::containsPoints(rect, px, py, n, vector.data(), level);
+            BOOST_TEST(vector == scalar);
+        }
+
+        z_qtshapes::containsPoints(ellipse, px, py, n, scalar.data(), z_qtshapes::ZQScalarLevel);
+        for (z_qtshapes::ZQSimdLevel level : levels) {
+            z_qtshapes::containsPoints(ellipse, px, py, n, vector.data(), level);
+            BOOST_TEST(vector == scalar);
+        }
+
+        z_qtshapes::containsPoints(tri, px, py, n, scalar.data(), z_qtshapes::ZQScalarLevel);
+        for (z_qtshapes::ZQSimdLevel level : levels) {
+            z_qtshapes::containsPoints(tri, px, py, n, vector.data(), level);
+            BOOST_TEST(vector == scalar);
+        }
+    }
+
+    BOOST_TEST(z_qtshapes::supportedSimdLevel() >= z_qtshapes::ZQScalarLevel);
+    BOOST_TEST(z_qtshapes::supportedSimdLevel() <= z_qtshapes::ZQAVX512Level);
+}
@@ -0,0 +1,106 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QPointKernels_3
+#include <boost/test/included/unit_test.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+#include "z_qpointkernels.h"
+
+
+BOOST_AUTO_TEST_CASE(Z_QPointKernels_3)
+{
+    // Affine: scale by 2 and move by (3, -1) about (10, 10).
+    const float affine[] = { 2, 0, 3,
+                             0, 2, -1,
+                             0, 0, 1 };
+    const z_qtshapes::ZQPointTransform a(QMatrix3x3(affine), QPointF(10, 10));
+    BOOST_TEST(a.isAffine());
+    BOOST_CHECK(a.map(QPointF(12, 9)) == QPointF(17, 7));
+    BOOST_CHECK(a.map(QPointF(10, 10)) == QPointF(13, 9));
+
+    // Projective: w = x / 4 + 1, and w = 0 at x = -4 leaves the point undivided.
+    const float projective[] = { 1, 0, 0,
+                                 0, 1, 0,
+                                 0.25f, 0, 1 };
+    const z_qtshapes::ZQPointTransform p{ QMatrix3x3(projective) };
+    BOOST_TEST(!p.isAffine());
+    BOOST_CHECK(p.map(QPointF(4, 6)) == QPointF(2, 3));
+    BOOST_CHECK(p.map(QPointF(-4, 6)) == QPointF(-4, 6));
+
+    // Any matrix type with operator()(row, column) converts.
+    struct Rows {
+        double r[3][3];
+        double operator()(int i, int j) const { return r[i][j]; }
+    };
+    const Rows rows = { { { 0.1, 0, 0 }, { 0, 0.1, 0 }, { 0, 0, 1 } } };
+    const z_qtshapes::ZQPointTransform t(rows);
+    BOOST_TEST(t.m[0][0] == 0.1);
+    BOOST_TEST(t.map(QPointF(30, 0)).x() == 0.1 * 30);
+
+    // Every instruction set must match the scalar results bit for bit, in
+    // double and float, in place and on unaligned arrays.
+    quint32 seed = 7;
+    auto next = [&seed]() { seed = seed * 1664525u + 1013904223u; return (seed >> 8) / qreal(1 << 24); };
+    const float general[] = { 0.9f, -0.3f, 12,
+                              0.2f, 1.1f, -7,
+                              0.0009765625f, -0.000244140625f, 1 };
+    const z_qtshapes::ZQPointTransform g(QMatrix3x3(general), QPointF(50, 40));
+
+    const int n = 515;
+    QVector<double> x(n + 1), y(n + 1);
+    QVector<float> xf(n + 1), yf(n + 1);
+    for (int i = 0; i <= n; ++i) {
+        x[i] = next() * 1000 - 500;
+        y[i] = next() * 1000 - 500;
+        xf[i] = float(x[i]);
+        yf[i] = float(y[i]);
+    }
+    x[9] = std::numeric_limits<double>::quiet_NaN();
+    // w is exactly zero here.
+    x[20] = 50 - 1024;
+    y[20] = 40;
+    xf[20] = float(x[20]);
+    yf[20] = float(y[20]);
+
+    const z_qtshapes::ZQSimdLevel levels[] = {
+        z_qtshapes::ZQSSE2Level, z_qtshapes::ZQAVX2Level, z_qtshapes::ZQAVX512Level
+    };
+    for (int offset = 0; offset < 2; ++offset) {
+        const double *px = x.data() + offset;
+        const double *py = y.data() + offset;
+        QVector<double> sx(n), sy(n);
+        z_qtshapes::transformPoints(g, px, py, sx.data(), sy.data(), n, z_qtshapes::ZQScalarLevel);
+        for (int i = 0; i < n; i += 37) {
+            const QPointF q = g.map(QPointF(px[i], py[i]));
+            const double qx = q.x(), qy = q.y();
+            BOOST_TEST(std::memcmp(&sx[i], &qx, sizeof(double)) == 0);
+            BOOST_TEST(std::memcmp(&sy[i], &qy, sizeof(double)) == 0);
+        }
+        for (z_qtshapes::ZQSimdLevel level : levels) {
+            QVector<double> vx(n), vy(n);
+            std::memcpy(vx.data(), px, n * sizeof(double));
+            std::memcpy(vy.data(), py, n * sizeof(double));
+            z_qtshapes::transformPoints(g, vx.data(), vy.data(), vx.data(), vy.data(), n, level);
+            BOOST_TEST(std::memcmp(vx.data(), sx.data(), n * sizeof(double)) == 0);
+            BOOST_TEST(std::memcmp(vy.data(), sy.data(), n * sizeof(double)) == 0);
+        }
+
+        const float *pxf = xf.data() + offset;
+        const float *pyf = yf.data() + offset;
+        QVector<float> sxf(n), syf(n);
+        z_qtshapes::transformPoints(g, pxf, pyf, sxf.data(), syf.data(), n, z_qtshapes::ZQScalarLevel);
+        for (int i = 0; i < n; ++i)
+            BOOST_TEST((qAbs(sxf[i] - sx[i]) <= 0.01 * (1 + qAbs(sx[i])) || std::isnan(px[i])));
+        for (z_qtshapes::ZQSimdLevel level : levels) {
+            QVector<float> vx(n), vy(n);
+            z_qtshapes::transformPoints(g, pxf, pyf, vx.data(), vy.data(), n, level);
+            BOOST_TEST(std::memcmp(vx.data(), sxf.data(), n * sizeof(float)) == 0);
+            BOOST_TEST(std::memcmp(vy.data(), syf.data(), n * sizeof(float)) == 0);
+        }
+    }
+}
@@ -0,0 +1,85 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QPolygonF_1
+#include <boost/test/included/unit_test.hpp>
+
+#include <cmath>
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+#include "z_qpolygon.h"
+
+
+BOOST_AUTO_TEST_CASE(Z_QPolygonF_1)
+{
+    const qreal eps = 1e-9;
+
+    // Overlapping, disjoint and nested axis aligned rectangles.
+    const z_qtshapes::ZQRectF a(0, 0, 4, 4);
+    const z_qtshapes::ZQRectF b(2, 2, 4, 4);
+    const z_qtshapes::ZQRectF c(10, 10, 4, 4);
+    const z_qtshapes::ZQRectF d(1, 1, 2, 2);
+
+    const z_qtshapes::ZQPolygonF ab = a & b;
+    BOOST_TEST(ab.contourCount() == 1);
+    BOOST_TEST(ab.isConvex());
+    BOOST_TEST(qAbs(ab.area() - 4) < eps);
+    BOOST_CHECK(ab.boundingRect() == QRectF(2, 2, 2, 2));
+    BOOST_CHECK(a.intersected(b) == ab);
+
+    const z_qtshapes::ZQPolygonF aub = a | b;
+    BOOST_TEST(aub.contourCount() == 1);
+    BOOST_TEST(!aub.isConvex());
+    BOOST_TEST(aub.pointCount() == 8);
+    BOOST_TEST(qAbs(aub.area() - 28) < eps);
+    BOOST_TEST(aub.contains(QPointF(1, 1)));
+    BOOST_TEST(aub.contains(QPointF(5, 5)));
+    BOOST_TEST(!aub.contains(QPointF(5, 1)));
+    BOOST_CHECK(a.united(b) == aub);
+
+    BOOST_TEST((a & c).isEmpty());
+    BOOST_TEST((a | c).contourCount() == 2);
+    BOOST_TEST(qAbs((a | c).area() - 32) < eps);
+
+    BOOST_TEST(qAbs((a & d).area() - 4) < eps);
+    BOOST_TEST((a | d).contourCount() == 1);
+    BOOST_TEST(qAbs((a | d).area() - 16) < eps);
+
+    // A square and its 45 degree rotation meet in a regular octagon.
+    const z_qtshapes::ZQRectF r(0, 0, 4, 4, 45);
+    const qreal octagon = 8 * 4 * std::tan(M_PI / 8);
+    BOOST_TEST(qAbs((a & r).area() - octagon) < eps);
+    BOOST_TEST((a & r).pointCount() == 8);
+    BOOST_TEST(qAbs((a | r).area() - (32 - octagon)) < eps);
+    BOOST_TEST((a | r).pointCount() == 16);
+
+    // Triangles, and the integer classes.
+    const z_qtshapes::ZQTriF t1(QPointF(0, 0), QPointF(4, 0), QPointF(0, 4));
+    const z_qtshapes::ZQTriF t2(QPointF(0, 0), QPointF(4, 0), QPointF(4, 4));
+    BOOST_TEST(qAbs((t1 & t2).area() - 4) < eps);
+    BOOST_TEST(qAbs((t1 | t2).area() - 12) < eps);
+    BOOST_TEST(qAbs((z_qtshapes::ZQRect(0, 0, 4, 4) & z_qtshapes::ZQRect(2, 2, 4, 4)).area() - 4) < eps);
+    BOOST_TEST(qAbs((z_qtshapes::ZQTri(0, 0, 4, 0, 0, 4) | z_qtshapes::ZQTri(0, 0, 4, 0, 4, 4)).area() - 12) < eps);
+
+    // Results agree with the shapes point by point, and the areas add up.
+    quint32 seed = 3;
+    auto next = [&seed]() { seed = seed * 1664525u + 1013904223u; return (seed >> 8) / qreal(1 << 24); };
+    for (int k = 0; k < 200; ++k) {
+        const z_qtshapes::ZQRectF p(next() * 10, next() * 10, 1 + next() * 8, 1 + next() * 8, next() * 360);
+        const z_qtshapes::ZQTriF q(QPointF(next() * 16, next() * 16), QPointF(next() * 16, next() * 16),
+                                   QPointF(next() * 16, next() * 16), next() * 360);
+        const z_qtshapes::ZQPolygonF i = p.toPolygon().convexIntersected(q.toPolygon());
+        const z_qtshapes::ZQPolygonF u = p.toPolygon().convexUnited(q.toPolygon());
+        const qreal areaP = p.toPolygon().area(), areaQ = q.toPolygon().area();
+        BOOST_TEST(qAbs(u.area() + i.area() - areaP - areaQ) < 1e-6);
+        BOOST_TEST(i.area() <= qMin(areaP, areaQ) + 1e-9);
+        BOOST_TEST((i.isEmpty() || i.isConvex()));
+
+        for (int m = 0; m < 20; ++m) {
+            const QPointF x(next() * 20 - 2, next() * 20 - 2);
+            const bool inP = p.prepared().contains(x), inQ = q.prepared().contains(x);
+            BOOST_TEST(i.contains(x) == (inP && inQ));
+            BOOST_TEST(u.contains(x) == (inP || inQ));
+        }
+    }
+}
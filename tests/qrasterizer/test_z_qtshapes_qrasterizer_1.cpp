@@ -0,0 +1,106 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QRasterizer_1
+#include <boost/test/included/unit_test.hpp>
+
+#include <vector>
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+#include "z_qrasterizer.h"
+
+BOOST_AUTO_TEST_CASE(Z_QRasterizer_1)
+{
+    const int width = 150, height = 110, stride = 160;
+    QVector<z_qtshapes::ZQPreparedShape> shapes;
+    shapes.append(z_qtshapes::ZQRectF(10, 10, 60, 30, 30));
+    shapes.append(z_qtshapes::ZQTriF(QPointF(70, 5), QPointF(140, 40), QPointF(80, 100)));
+    shapes.append(z_qtshapes::ZQEllipseF(20, 50, 90, 50, 20));
+    shapes.append(z_qtshapes::ZQLineF(QPointF(5, 100), QPointF(145, 60)));
+    shapes.append(z_qtshapes::ZQRectF(-20, -20, 30, 30));
+
+    z_qtshapes::ZQRasterizer raster;
+    BOOST_TEST(raster.tileSize() == 64);
+    BOOST_TEST(raster.samples() == 4);
+    raster.setTileSize(16);
+    raster.setLineWidth(3);
+
+    // Ids: the topmost shape containing each pixel center.
+    std::vector<quint32> ids(height * stride, 0xdeadbeef);
+    raster.rasterizeIds(shapes.constData(), shapes.size(), ids.data(), width, height, stride * 4);
+    int mismatches = 0;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const QPointF p(x + 0.5, y + 0.5);
+            quint32 expected = 0;
+            for (int i = 0; i < shapes.size(); ++i) {
+                if (shapes[i].type() == z_qtshapes::ZQPreparedShape::LineShape) {
+                    const QLineF &l = shapes[i].line();
+                    const QPointF d = l.p2() - l.p1();
+                    const qreal len = qSqrt(d.x() * d.x() + d.y() * d.y());
+                    const qreal u = ((p.x() - l.p1().x()) * d.x() + (p.y() - l.p1().y()) * d.y()) / len;
+                    const qreal v = ((p.x() - l.p1().x()) * -d.y() + (p.y() - l.p1().y()) * d.x()) / len;
+                    if (u >= 0 && u <= len && qAbs(v) <= 1.5)
+                        expected = i + 1;
+                } else if (shapes[i].contains(p)) {
+                    expected = i + 1;
+                }
+            }
+            if (ids[y * stride + x] != expected)
+                ++mismatches;
+        }
+        BOOST_TEST(ids[y * stride + width] == 0xdeadbeef);
+    }
+    BOOST_TEST(mismatches == 0);
+
+    // One thread and any tile size give the same ids.
+    std::vector<quint32> serial(height * stride);
+    raster.setThreadPool(nullptr);
+    raster.setTileSize(200);
+    raster.rasterizeIds(shapes.constData(), shapes.size(), serial.data(), width, height, stride * 4);
+    bool same = true;
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
+            same = same && serial[y * stride + x] == ids[y * stride + x];
+    BOOST_TEST(same);
+    raster.setThreadPool(QThreadPool::globalInstance());
+    raster.setTileSize(16);
+
+    // Coverage of a single shape approaches its area.
+    const z_qtshapes::ZQPreparedShape ellipse(z_qtshapes::ZQEllipseF(20.3, 10.7, 100, 60, 35));
+    std::vector<quint8> coverage(height * stride, 7);
+    raster.rasterizeCoverage(&ellipse, 1, coverage.data(), width, height, stride);
+    double sum = 0;
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
+            sum += coverage[y * stride + x] / 255.0;
+    BOOST_TEST(qAbs(sum - M_PI * 50 * 30) < 15);
+    BOOST_TEST(coverage[60 * stride + 70] == 255);
+    BOOST_TEST(coverage[0] == 0);
+    BOOST_TEST(coverage[width] == 7);
+
+    // Overlapping shapes are not counted twice, and a pixel half inside an
+    // axis aligned rectangle gets half coverage.
+    QVector<z_qtshapes::ZQPreparedShape> twice;
+    twice.append(z_qtshapes::ZQRectF(10, 10.5, 20, 20));
+    twice.append(z_qtshapes::ZQRectF(10, 10.5, 20, 20));
+    raster.rasterizeCoverage(twice.constData(), twice.size(), coverage.data(), width, height, stride);
+    BOOST_TEST(int(coverage[20 * stride + 20]) == 255);
+    BOOST_TEST(int(coverage[10 * stride + 20]) == 128);
+    BOOST_TEST(int(coverage[30 * stride + 20]) == 128);
+    BOOST_TEST(int(coverage[20 * stride + 9]) == 0);
+
+    raster.setSamples(1);
+    raster.rasterizeCoverage(twice.constData(), twice.size(), coverage.data(), width, height, stride);
+    BOOST_TEST(int(coverage[20 * stride + 29]) == 255);
+    BOOST_TEST(int(coverage[20 * stride + 30]) == 0);
+
+    // QImage output picks the buffer by format.
+    QImage grey(width, height, QImage::Format_Grayscale8);
+    BOOST_TEST(raster.rasterize(twice, grey));
+    BOOST_TEST(int(grey.scanLine(20)[20]) == 255);
+    QImage argb(width, height, QImage::Format_ARGB32);
+    BOOST_TEST(raster.rasterize(shapes, argb));
+    BOOST_TEST(reinterpret_cast<const quint32 *>(argb.scanLine(5))[5] == 5u);
+    QImage none;
+    BOOST_TEST(!raster.rasterize(shapes, none));
+}
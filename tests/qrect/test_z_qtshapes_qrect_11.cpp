@@ -0,0 +1,34 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QRect_11
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+
+BOOST_AUTO_TEST_CASE(Z_QRect_11)
+{
+    z_qtshapes::ZQRect a(0, 0, 4, 2, 90);
+    BOOST_CHECK(a.boundingRectF() == QRectF(1, -1, 2, 4));
+    BOOST_CHECK(a.boundingRect() == QRect(1, -1, 2, 4));
+
+    // The midpoint (1.5, 1.5) is rotated about the integer center (1, 1).
+    a = z_qtshapes::ZQRect(0, 0, 3, 3, 45);
+    const QRectF b = a.boundingRectF();
+    BOOST_TEST(qAbs(b.left() - (1 + M_SQRT1_2 - 3 * M_SQRT1_2)) < 1e-9);
+    BOOST_TEST(qAbs(b.top() - (1 - 3 * M_SQRT1_2)) < 1e-9);
+    BOOST_TEST(qAbs(b.width() - 6 * M_SQRT1_2) < 1e-9);
+    BOOST_CHECK(a.boundingRect() == QRect(-1, -2, 5, 6));
+
+    // The closed form and the prepared rectangle agree to the last bit.
+    const qreal angles[] = { 0, 30, 90, 135, 180, 270, 333.3 };
+    for (qreal angle : angles) {
+        a = z_qtshapes::ZQRect(-3, 7, 11, 5, angle);
+        const QRectF c = a.boundingRectF(), p = a.prepared().boundingRect();
+        BOOST_TEST(c.x() == p.x());
+        BOOST_TEST(c.y() == p.y());
+        BOOST_TEST(c.width() == p.width());
+        BOOST_TEST(c.height() == p.height());
+    }
+}
@@ -0,0 +1,36 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QRectF_10
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+
+
+BOOST_AUTO_TEST_CASE(Z_QRectF_10)
+{
+    z_qtshapes::ZQRectF l(0, 0, 10, 10);
+    BOOST_TEST(l.intersects(z_qtshapes::ZQRectF(5, 5, 10, 10)));
+    BOOST_TEST(l.intersects(z_qtshapes::ZQRectF(10, 0, 10, 10)));
+    BOOST_TEST(l.intersects(z_qtshapes::ZQRectF(10, 10, 5, 5)));
+    BOOST_TEST(!l.intersects(z_qtshapes::ZQRectF(10.001, 0, 10, 10)));
+    BOOST_TEST(!l.intersects(z_qtshapes::ZQRectF(20, 20, 2, 2)));
+    BOOST_TEST(!l.intersects(z_qtshapes::ZQRectF(11, 4, 2, 2)));
+
+    z_qtshapes::ZQRectF r(0, 0, 10, 10, 45);
+    BOOST_TEST(r.intersects(z_qtshapes::ZQRectF(11, 4, 2, 2)));
+    BOOST_TEST(z_qtshapes::ZQRectF(11, 4, 2, 2).intersects(r));
+    BOOST_TEST(!r.intersects(z_qtshapes::ZQRectF(11, 11, 4, 4, 45)));
+
+    BOOST_TEST(l.contains(z_qtshapes::ZQRectF(2, 2, 3, 3)));
+    BOOST_TEST(l.contains(z_qtshapes::ZQRectF(2, 2, 3, 3), true));
+    BOOST_TEST(l.contains(l));
+    BOOST_TEST(!l.contains(l, true));
+    BOOST_TEST(l.contains(z_qtshapes::ZQRectF(0, 0, 5, 5)));
+    BOOST_TEST(!l.contains(z_qtshapes::ZQRectF(0, 0, 5, 5), true));
+    BOOST_TEST(!l.contains(z_qtshapes::ZQRectF(8, 8, 5, 5)));
+    BOOST_TEST(r.contains(z_qtshapes::ZQRectF(4, 4, 2, 2)));
+    BOOST_TEST(!r.contains(z_qtshapes::ZQRectF(0, 0, 2, 2)));
+    BOOST_TEST(!l.contains(r));
+}
@@ -0,0 +1,35 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QRectF_11
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+
+
+BOOST_AUTO_TEST_CASE(Z_QRectF_11)
+{
+    z_qtshapes::ZQRectF r(0, 0, 10, 10, 45);
+    z_qtshapes::ZQPreparedRectF p = r.prepared();
+    BOOST_TEST(p.angle() == 45);
+    BOOST_TEST(qAbs(p.center().x() - 5) < 1e-9);
+    BOOST_TEST(qAbs(p.center().y() - 5) < 1e-9);
+    BOOST_TEST(qAbs(p.boundingRect().width() - 10 * qSqrt(2)) < 1e-9);
+    BOOST_TEST(qAbs(p.boundingRect().height() - 10 * qSqrt(2)) < 1e-9);
+
+    const QPointF points[] = { QPointF(5, 5), QPointF(0, 0), QPointF(5, -1.5), QPointF(12, 5), QPointF(-2, 5), QPointF(9, 9) };
+    for (const QPointF &q : points)
+        BOOST_TEST(p.contains(q) == r.contains(q));
+
+    const z_qtshapes::ZQRectF others[] = { z_qtshapes::ZQRectF(11, 4, 2, 2), z_qtshapes::ZQRectF(4, 4, 2, 2),
+            z_qtshapes::ZQRectF(11, 11, 4, 4, 45), z_qtshapes::ZQRectF(0, 0, 2, 2) };
+    for (const z_qtshapes::ZQRectF &o : others) {
+        BOOST_TEST(r.intersects(o.prepared()) == r.intersects(o));
+        BOOST_TEST(r.contains(o.prepared()) == r.contains(o));
+    }
+
+    z_qtshapes::ZQRect ir(0, 0, 10, 10);
+    BOOST_TEST(ir.prepared().contains(QPointF(5, 5)));
+    BOOST_TEST(ir.intersects(z_qtshapes::ZQRect(5, 5, 10, 10).prepared()));
+}
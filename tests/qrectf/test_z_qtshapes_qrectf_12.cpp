@@ -0,0 +1,30 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QRectF_12
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+
+BOOST_AUTO_TEST_CASE(Z_QRectF_12)
+{
+    z_qtshapes::ZQRectF a(0, 0, 4, 2);
+    BOOST_CHECK(a.boundingRect() == QRectF(0, 0, 4, 2));
+
+    // A quarter turn swaps the extents about the center.
+    a = z_qtshapes::ZQRectF(0, 0, 4, 2, 90);
+    BOOST_CHECK(a.boundingRect() == QRectF(1, -1, 2, 4));
+    a = z_qtshapes::ZQRectF(0, 0, 4, 2, 180);
+    BOOST_CHECK(a.boundingRect() == QRectF(0, 0, 4, 2));
+
+    for (int angle = 0; angle < 360; angle += 7) {
+        a = z_qtshapes::ZQRectF(-3, 5, 10, 4, angle + 0.5);
+        const QRectF b = a.boundingRect();
+        const QRectF p = a.prepared().boundingRect();
+        BOOST_TEST(qAbs(b.left() - p.left()) < 1e-9);
+        BOOST_TEST(qAbs(b.top() - p.top()) < 1e-9);
+        BOOST_TEST(qAbs(b.right() - p.right()) < 1e-9);
+        BOOST_TEST(qAbs(b.bottom() - p.bottom()) < 1e-9);
+    }
+}
@@ -0,0 +1,49 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QRectF_13
+#include <boost/test/included/unit_test.hpp>
+
+#include <vector>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+
+namespace {
+
+    // Signed area of every indexed triangle, summed; fails on a negative one.
+    double triangleArea(const std::vector<float> &v, const std::vector<quint32> &idx, quint32 base)
+    {
+        double total = 0;
+        for (std::size_t i = 0; i < idx.size(); i += 3) {
+            const quint32 a = idx[i] - base, b = idx[i + 1] - base, c = idx[i + 2] - base;
+            const double area = 0.5 * ((v[2*b] - v[2*a]) * (v[2*c + 1] - v[2*a + 1])
+                    - (v[2*b + 1] - v[2*a + 1]) * (v[2*c] - v[2*a]));
+            BOOST_TEST(area >= 0);
+            total += area;
+        }
+        return total;
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(Z_QRectF_13)
+{
+    z_qtshapes::ZQRectF a(2, 3, 10, 4, 35);
+    BOOST_TEST(a.tessellationVertexCount() == 4);
+    BOOST_TEST(a.tessellationIndexCount() == 6);
+
+    std::vector<float> v(8);
+    std::vector<quint32> idx(6);
+    a.tessellate(0.5, v.data(), idx.data(), 100);
+
+    const z_qtshapes::ZQPreparedRectF p = a.prepared();
+    const QPointF corners[4] = { p.topRight(), p.bottomRight(), p.bottomLeft(), p.topLeft() };
+    for (int i = 0; i < 4; ++i) {
+        BOOST_TEST(v[2*i] == float(corners[i].x()));
+        BOOST_TEST(v[2*i + 1] == float(corners[i].y()));
+    }
+    for (quint32 i : idx)
+        BOOST_TEST((i >= 100 && i < 104));
+    BOOST_TEST(qAbs(triangleArea(v, idx, 100) - 40) < 1e-4);
+}
@@ -0,0 +1,92 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QShapeArray_1
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+#include "z_qshapearray.h"
+
+
+BOOST_AUTO_TEST_CASE(Z_QShapeArray_1)
+{
+    QVector<z_qtshapes::ZQRectF> rects;
+    rects.append(z_qtshapes::ZQRectF(0, 0, 10, 4, 30));
+    rects.append(z_qtshapes::ZQRectF(-5, 7, 2, 8, 350));
+    rects.append(z_qtshapes::ZQRectF(3, -2, 6, 6));
+
+    z_qtshapes::ZQRectFArray rectArray(rects);
+    BOOST_CHECK(rectArray.size() == 3);
+    BOOST_CHECK(rectArray.toVector() == rects);
+    BOOST_CHECK(reinterpret_cast<quintptr>(rectArray.xData()) % 64 == 0);
+    BOOST_CHECK(reinterpret_cast<quintptr>(rectArray.angleData()) % 64 == 0);
+
+    rectArray.translate(2, -3);
+    rectArray.rotate(20);
+    for (int i = 0; i < rects.size(); ++i) {
+        const z_qtshapes::ZQRectF expected = rects[i].translated(2, -3).rotated(20);
+        BOOST_CHECK(rectArray.at(i) == expected);
+        const QRectF b = expected.prepared().boundingRect();
+        qreal l, t, r, bottom;
+        z_qtshapes::ZQRectFArray single;
+        single.append(rectArray.at(i));
+        single.boundingRects(&l, &t, &r, &bottom);
+        BOOST_TEST(qAbs(l - b.left()) < 1e-9);
+        BOOST_TEST(qAbs(t - b.top()) < 1e-9);
+        BOOST_TEST(qAbs(r - b.right()) < 1e-9);
+        BOOST_TEST(qAbs(bottom - b.bottom()) < 1e-9);
+    }
+
+    QRectF all;
+    for (int i = 0; i < rectArray.size(); ++i)
+        all = all.united(rectArray.at(i).prepared().boundingRect());
+    const QRectF b = rectArray.boundingRect();
+    BOOST_TEST(qAbs(b.left() - all.left()) < 1e-9);
+    BOOST_TEST(qAbs(b.top() - all.top()) < 1e-9);
+    BOOST_TEST(qAbs(b.right() - all.right()) < 1e-9);
+    BOOST_TEST(qAbs(b.bottom() - all.bottom()) < 1e-9);
+
+    rectArray.replace(1, z_qtshapes::ZQRectF(1, 1, 1, 1, 45));
+    BOOST_CHECK(rectArray.at(1) == z_qtshapes::ZQRectF(1, 1, 1, 1, 45));
+    rectArray.clear();
+    BOOST_TEST(rectArray.isEmpty());
+    BOOST_TEST(rectArray.boundingRect().isNull());
+
+    QVector<z_qtshapes::ZQEllipseF> ellipses;
+    ellipses.append(z_qtshapes::ZQEllipseF(0, 0, 10, 4, 30));
+    ellipses.append(z_qtshapes::ZQEllipseF(20, 5, 6, 2, 90));
+    z_qtshapes::ZQEllipseFArray ellipseArray(ellipses);
+    BOOST_CHECK(ellipseArray.toVector() == ellipses);
+    ellipseArray.translate(QPointF(-1, 1));
+    ellipseArray.rotate(-45);
+    for (int i = 0; i < ellipses.size(); ++i) {
+        z_qtshapes::ZQEllipseF e = ellipses[i];
+        e.translate(-1, 1);
+        BOOST_CHECK(ellipseArray.at(i) == z_qtshapes::ZQEllipseF(e.x(), e.y(), e.width(), e.height(), e.angle() - 45));
+    }
+
+    QVector<z_qtshapes::ZQTriF> tris;
+    tris.append(z_qtshapes::ZQTriF(0, 0, 4, 0, 0, 3, 10));
+    tris.append(z_qtshapes::ZQTriF(QPointF(5, 5), QPointF(9, 6), QPointF(6, 10)));
+    z_qtshapes::ZQTriFArray triArray(tris);
+    BOOST_CHECK(triArray.toVector() == tris);
+    triArray.translate(1, 2);
+    triArray.rotate(400);
+    for (int i = 0; i < tris.size(); ++i) {
+        z_qtshapes::ZQTriF t = tris[i];
+        t.translate(1, 2);
+        BOOST_CHECK(triArray.at(i) == t.rotated(400));
+    }
+
+    const QRectF tb = triArray.boundingRect();
+    for (int i = 0; i < triArray.size(); ++i) {
+        const z_qtshapes::ZQPreparedTriF t = triArray.at(i).prepared();
+        for (const QPointF &v : { t.first(), t.second(), t.third() }) {
+            BOOST_TEST(v.x() >= tb.left() - 1e-9);
+            BOOST_TEST(v.x() <= tb.right() + 1e-9);
+            BOOST_TEST(v.y() >= tb.top() - 1e-9);
+            BOOST_TEST(v.y() <= tb.bottom() + 1e-9);
+        }
+    }
+}
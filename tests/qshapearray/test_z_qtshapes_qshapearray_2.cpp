@@ -0,0 +1,79 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QShapeArray_2
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+#include "z_qshapearray.h"
+
+
+BOOST_AUTO_TEST_CASE(Z_QShapeArray_2)
+{
+    quint32 seed = 4242;
+    auto next = [&seed]() { seed = seed * 1664525u + 1013904223u; return (seed >> 8) / qreal(1 << 24); };
+
+    z_qtshapes::ZQRectFArray rects;
+    z_qtshapes::ZQEllipseFArray ellipses;
+    z_qtshapes::ZQTriFArray tris;
+    for (int i = 0; i < 200; ++i) {
+        rects.append(z_qtshapes::ZQRectF(next() * 100, next() * 100, 2 + next() * 20, 2 + next() * 20, next() * 360));
+        ellipses.append(z_qtshapes::ZQEllipseF(next() * 100, next() * 100, 2 + next() * 20, 2 + next() * 20, next() * 360));
+        const QPointF p(next() * 100, next() * 100);
+        tris.append(z_qtshapes::ZQTriF(p, p + QPointF(next() * 20, next() * 5), p + QPointF(next() * 5, next() * 20), next() * 360));
+    }
+    rects.append(z_qtshapes::ZQRectF());
+    ellipses.append(z_qtshapes::ZQEllipseF(10, 10, 0, 5));
+    tris.append(z_qtshapes::ZQTriF());
+
+    bool result[201];
+    int hits = 0;
+    for (int k = 0; k < 200; ++k) {
+        const QPointF p = k == 0 ? QPointF() : QPointF(next() * 120, next() * 120);
+
+        rects.contains(p, result);
+        for (int i = 0; i < rects.size(); ++i) {
+            BOOST_TEST(result[i] == rects.at(i).contains(p));
+            hits += result[i];
+        }
+        ellipses.contains(p, result);
+        for (int i = 0; i < ellipses.size(); ++i)
+            BOOST_TEST(result[i] == ellipses.at(i).contains(p));
+        tris.contains(p, result);
+        for (int i = 0; i < tris.size(); ++i)
+            BOOST_TEST(result[i] == tris.at(i).contains(p));
+    }
+    BOOST_TEST(hits > 0);
+
+    // Preparing from the cached sine and cosine gives the same shapes as
+    // preparing from the angle.
+    for (int i = 0; i < 200; ++i) {
+        const z_qtshapes::ZQPreparedShape r(rects.at(i), rects.cosData()[i], rects.sinData()[i]);
+        BOOST_TEST((r.boundingRect() == rects.at(i).prepared().boundingRect()));
+        BOOST_TEST((r.rect().topLeft() == rects.at(i).prepared().topLeft()));
+        const z_qtshapes::ZQPreparedShape e(ellipses.at(i), ellipses.cosData()[i], ellipses.sinData()[i]);
+        BOOST_TEST((e.boundingRect() == ellipses.at(i).prepared().boundingRect()));
+        const z_qtshapes::ZQPreparedShape t(tris.at(i), tris.cosData()[i], tris.sinData()[i]);
+        BOOST_TEST((t.tri().first() == tris.at(i).prepared().first()));
+        BOOST_TEST((t.tri().third() == tris.at(i).prepared().third()));
+    }
+
+    QVector<z_qtshapes::ZQPreparedShape> queries;
+    queries.append(z_qtshapes::ZQRectF(40, 40, 15, 10, 30));
+    queries.append(z_qtshapes::ZQEllipseF(10, 60, 30, 12, 75));
+    queries.append(z_qtshapes::ZQTriF(QPointF(70, 20), QPointF(90, 30), QPointF(75, 45), 10));
+    queries.append(z_qtshapes::ZQLineF(0, 0, 100, 100));
+    queries.append(z_qtshapes::ZQPreparedShape());
+    for (const z_qtshapes::ZQPreparedShape &q : queries) {
+        rects.intersects(q, result);
+        for (int i = 0; i < rects.size(); ++i)
+            BOOST_TEST(result[i] == z_qtshapes::ZQPreparedShape(rects.at(i)).intersects(q));
+        ellipses.intersects(q, result);
+        for (int i = 0; i < ellipses.size(); ++i)
+            BOOST_TEST(result[i] == z_qtshapes::ZQPreparedShape(ellipses.at(i)).intersects(q));
+        tris.intersects(q, result);
+        for (int i = 0; i < tris.size(); ++i)
+            BOOST_TEST(result[i] == z_qtshapes::ZQPreparedShape(tris.at(i)).intersects(q));
+    }
+}
@@ -0,0 +1,83 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QSpatialIndex_1
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+#include "z_qspatialindex.h"
+
+
+BOOST_AUTO_TEST_CASE(Z_QSpatialIndex_1)
+{
+    z_qtshapes::ZQSpatialIndex index;
+    BOOST_TEST(index.isEmpty());
+
+    const z_qtshapes::ZQSpatialIndex::Id r = index.insert(z_qtshapes::ZQRectF(0, 0, 10, 10, 45));
+    const z_qtshapes::ZQSpatialIndex::Id t = index.insert(z_qtshapes::ZQTriF(QPointF(20, 0), QPointF(30, 0), QPointF(20, 10)));
+    const z_qtshapes::ZQSpatialIndex::Id e = index.insert(z_qtshapes::ZQEllipseF(40, 0, 20, 10, 90));
+    const z_qtshapes::ZQSpatialIndex::Id l = index.insert(z_qtshapes::ZQLineF(QPointF(0, 30), QPointF(10, 40)));
+    BOOST_TEST(index.size() == 4);
+    BOOST_TEST(index.shapeType(r) == z_qtshapes::ZQPreparedShape::RectShape);
+    BOOST_TEST(index.shapeType(t) == z_qtshapes::ZQPreparedShape::TriShape);
+    BOOST_TEST(index.shapeType(e) == z_qtshapes::ZQPreparedShape::EllipseShape);
+    BOOST_TEST(index.shapeType(l) == z_qtshapes::ZQPreparedShape::LineShape);
+
+    // The corner of the bounding rectangle of the rotated square is empty.
+    BOOST_TEST(index.intersecting(QRectF(-2, -2, 1, 1)).isEmpty());
+    BOOST_TEST(index.intersecting(QRectF(4, 4, 2, 2)) == QVector<z_qtshapes::ZQSpatialIndex::Id>({ r }));
+    // Only the bounding rectangle of the triangle reaches (29, 9).
+    BOOST_TEST(index.intersecting(QRectF(28, 8, 2, 2)).isEmpty());
+    BOOST_TEST(index.intersecting(QRectF(24, 3, 1, 1)) == QVector<z_qtshapes::ZQSpatialIndex::Id>({ t }));
+    // The rotated ellipse spans x in [45, 55] and y in [-5, 15].
+    BOOST_TEST(index.intersecting(QRectF(41, -4, 2, 2)).isEmpty());
+    BOOST_TEST(index.intersecting(QRectF(49, 12, 2, 2)) == QVector<z_qtshapes::ZQSpatialIndex::Id>({ e }));
+    BOOST_TEST(index.intersecting(QRectF(7, 31, 2, 2)).isEmpty());
+    BOOST_TEST(index.intersecting(QRectF(4, 34, 2, 2)) == QVector<z_qtshapes::ZQSpatialIndex::Id>({ l }));
+    BOOST_TEST(index.intersecting(QRectF(-100, -100, 200, 200)).size() == 4);
+
+    // The overload that fills a caller's vector replaces its contents.
+    QVector<z_qtshapes::ZQSpatialIndex::Id> found;
+    index.intersecting(QRectF(-100, -100, 200, 200), found);
+    BOOST_TEST(found.size() == 4);
+    index.intersecting(QRectF(24, 3, 1, 1), found);
+    BOOST_TEST(found == QVector<z_qtshapes::ZQSpatialIndex::Id>({ t }));
+    index.intersecting(QRectF(-2, -2, 1, 1), found);
+    BOOST_TEST(found.isEmpty());
+
+    BOOST_TEST(index.containing(QPointF(5, 5)) == QVector<z_qtshapes::ZQSpatialIndex::Id>({ r }));
+    BOOST_TEST(index.containing(QPointF(0, 0)).isEmpty());
+    BOOST_TEST(index.containing(QPointF(50, 14)) == QVector<z_qtshapes::ZQSpatialIndex::Id>({ e }));
+    BOOST_TEST(index.containing(QPointF(5, 35)) == QVector<z_qtshapes::ZQSpatialIndex::Id>({ l }));
+
+    BOOST_TEST(index.within(QRectF(15, -5, 20, 20)) == QVector<z_qtshapes::ZQSpatialIndex::Id>({ t }));
+    BOOST_TEST(index.within(QRectF(0, 0, 10, 10)).isEmpty());
+
+    BOOST_TEST(index.remove(t));
+    BOOST_TEST(!index.remove(t));
+    BOOST_TEST(!index.contains(t));
+    BOOST_TEST(index.intersecting(QRectF(24, 3, 1, 1)).isEmpty());
+    BOOST_TEST(index.update(r, z_qtshapes::ZQTriF(QPointF(20, 0), QPointF(30, 0), QPointF(20, 10))));
+    BOOST_TEST(index.shapeType(r) == z_qtshapes::ZQPreparedShape::TriShape);
+    BOOST_TEST(index.intersecting(QRectF(24, 3, 1, 1)) == QVector<z_qtshapes::ZQSpatialIndex::Id>({ r }));
+    BOOST_TEST(index.containing(QPointF(5, 5)).isEmpty());
+    BOOST_TEST(index.size() == 3);
+
+    // Null shapes are never stored; updating to one takes the shape out
+    // of the tree as well.
+    BOOST_TEST(index.insert(z_qtshapes::ZQPreparedShape()) == -1);
+    BOOST_TEST(index.update(r, z_qtshapes::ZQPreparedShape()));
+    BOOST_TEST(!index.contains(r));
+    BOOST_TEST(index.size() == 2);
+    BOOST_TEST(index.intersecting(QRectF(24, 3, 1, 1)).isEmpty());
+    BOOST_TEST(index.intersecting(QRectF(-100, -100, 200, 200)).size() == 2);
+    const z_qtshapes::ZQPreparedShape batch[3] = { z_qtshapes::ZQRectF(0, 0, 1, 1), z_qtshapes::ZQPreparedShape(),
+                                                   z_qtshapes::ZQRectF(2, 2, 1, 1) };
+    QVector<z_qtshapes::ZQSpatialIndex::Id> ids;
+    index.bulkLoad(batch, batch + 3, &ids);
+    BOOST_TEST(ids.size() == 3);
+    BOOST_TEST(ids[1] == -1);
+    BOOST_TEST(index.size() == 4);
+    BOOST_TEST(index.intersecting(QRectF(-100, -100, 200, 200)).size() == 4);
+}
@@ -0,0 +1,70 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QSpatialIndex_2
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+#include "z_qspatialindex.h"
+
+
+BOOST_AUTO_TEST_CASE(Z_QSpatialIndex_2)
+{
+    QVector<z_qtshapes::ZQRectF> rects;
+    QVector<z_qtshapes::ZQEllipseF> ellipses;
+    for (int i = 0; i < 40; ++i) {
+        for (int j = 0; j < 40; ++j) {
+            if ((i + j) % 2)
+                rects.append(z_qtshapes::ZQRectF(i * 10, j * 10, 6, 4, (i * 7 + j * 13) % 90));
+            else
+                ellipses.append(z_qtshapes::ZQEllipseF(i * 10, j * 10, 6, 4, (i * 11 + j * 3) % 90));
+        }
+    }
+
+    z_qtshapes::ZQSpatialIndex index;
+    QVector<z_qtshapes::ZQSpatialIndex::Id> ids;
+    index.bulkLoad(rects.begin(), rects.end(), &ids);
+    index.bulkLoad(ellipses.begin(), ellipses.end(), &ids);
+    BOOST_TEST(index.size() == 1600);
+    BOOST_TEST(ids.size() == 1600);
+
+    // Region and point queries agree with a linear scan of the exact shapes.
+    const QRectF region(93, 41, 57, 38);
+    QVector<z_qtshapes::ZQSpatialIndex::Id> found = index.intersecting(region);
+    const QPointF q(123.5, 221.5);
+    QVector<z_qtshapes::ZQSpatialIndex::Id> hits = index.containing(q);
+    int expected = 0;
+    int expectedHits = 0;
+    const z_qtshapes::ZQRectF regionShape(region.x(), region.y(), region.width(), region.height());
+    for (int i = 0; i < rects.size(); ++i) {
+        if (rects[i].intersects(regionShape) != found.contains(ids[i]))
+            BOOST_TEST(false);
+        expected += rects[i].intersects(regionShape);
+        expectedHits += rects[i].contains(q);
+        BOOST_TEST(hits.contains(ids[i]) == rects[i].contains(q));
+    }
+    for (int i = 0; i < ellipses.size(); ++i) {
+        expectedHits += ellipses[i].contains(q);
+        BOOST_TEST(hits.contains(ids[rects.size() + i]) == ellipses[i].contains(q));
+    }
+    BOOST_TEST(expected > 0);
+    BOOST_TEST(hits.size() == expectedHits);
+
+    // k nearest neighbours come back sorted by exact distance.
+    const QPointF p(201, 199);
+    QVector<z_qtshapes::ZQSpatialIndex::Id> nearest = index.nearest(p, 8);
+    BOOST_TEST(nearest.size() == 8);
+    for (int i = 1; i < nearest.size(); ++i)
+        BOOST_TEST(index.distance(nearest[i - 1], p) <= index.distance(nearest[i], p));
+    qreal worst = index.distance(nearest.last(), p);
+    int closer = 0;
+    for (z_qtshapes::ZQSpatialIndex::Id id : ids)
+        closer += index.distance(id, p) < worst;
+    BOOST_TEST(closer <= 7);
+
+    z_qtshapes::ZQSpatialIndex::Id far = index.insert(z_qtshapes::ZQEllipseF(1000, 1000, 10, 10));
+    BOOST_TEST(qAbs(index.distance(far, QPointF(1005, 1020)) - 10) < 1e-9);
+    BOOST_TEST(index.nearest(QPointF(1005, 1020), 1) == QVector<z_qtshapes::ZQSpatialIndex::Id>({ far }));
+    BOOST_TEST(index.boundingRect().right() == 1010);
+}
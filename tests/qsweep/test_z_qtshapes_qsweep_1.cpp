@@ -0,0 +1,132 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QSweep_1
+#include <boost/test/included/unit_test.hpp>
+
+#include <vector>
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+#include "z_qsweep.h"
+
+BOOST_AUTO_TEST_CASE(Z_QSweep_1)
+{
+    // A fast box does not tunnel through a thin wall it never overlaps at
+    // either end of the step.
+    const z_qtshapes::ZQRectF box(0, 0, 10, 10);
+    const z_qtshapes::ZQRectF wall(50, -20, 1, 50);
+    const z_qtshapes::ZQMotion fast(QPointF(100, 0));
+    z_qtshapes::ZQRectF end = box;
+    end.translate(100, 0);
+    BOOST_TEST(!box.intersects(wall));
+    BOOST_TEST(!end.intersects(wall));
+    z_qtshapes::ZQTimeOfImpact toi = z_qtshapes::timeOfImpact(box, fast, wall);
+    BOOST_TEST(toi.hit);
+    BOOST_TEST(toi.time == 0.4, boost::test_tools::tolerance(1e-7));
+    BOOST_TEST(toi.pointA.x() == 50, boost::test_tools::tolerance(1e-6));
+    BOOST_TEST(toi.normal.x() == 1, boost::test_tools::tolerance(1e-9));
+
+    // Two movers close the gap together.
+    toi = z_qtshapes::timeOfImpact(z_qtshapes::ZQEllipseF(-5, -5, 10, 10), z_qtshapes::ZQMotion(QPointF(20, 0)),
+                                   z_qtshapes::ZQEllipseF(25, -5, 10, 10), z_qtshapes::ZQMotion(QPointF(-20, 0)));
+    BOOST_TEST(toi.hit);
+    BOOST_TEST(toi.time == 0.5, boost::test_tools::tolerance(1e-6));
+
+    // A turning stick sweeps over a point; compare with small steps of the
+    // rotated rectangle itself.
+    const z_qtshapes::ZQRectF stick(-20, -1, 40, 2);
+    const QPointF point(-3, 15);
+    toi = z_qtshapes::timeOfImpact(stick, z_qtshapes::ZQMotion(QPointF(), 90), point);
+    BOOST_TEST(toi.hit);
+    qreal first = 1;
+    for (int i = 0; i <= 10000; ++i) {
+        z_qtshapes::ZQRectF turned = stick;
+        turned.rotate(90 * i / 10000.);
+        if (z_qtshapes::distance(turned, point) <= 0) {
+            first = i / 10000.;
+            break;
+        }
+    }
+    BOOST_TEST(first < 1);
+    BOOST_TEST(toi.time <= first);
+    BOOST_TEST(toi.time > first - 1e-4);
+    z_qtshapes::ZQRectF atImpact = stick;
+    atImpact.rotate(90 * toi.time);
+    BOOST_TEST(z_qtshapes::distance(atImpact, point) < 1e-6);
+
+    // Turning and moving at once, with the same answer whichever shape
+    // is called the mover.
+    const z_qtshapes::ZQTriF tri(QPointF(60, 0), QPointF(70, 5), QPointF(62, 12));
+    const z_qtshapes::ZQMotion spin(QPointF(60, 5), -120);
+    const z_qtshapes::ZQTimeOfImpact ab = z_qtshapes::timeOfImpact(stick, spin, tri, z_qtshapes::ZQMotion(QPointF(-10, 0)));
+    const z_qtshapes::ZQTimeOfImpact ba = z_qtshapes::timeOfImpact(tri, z_qtshapes::ZQMotion(QPointF(-10, 0)), stick, spin);
+    BOOST_TEST(ab.hit);
+    BOOST_TEST(ba.hit);
+    BOOST_TEST(ab.time == ba.time, boost::test_tools::tolerance(1e-5));
+    BOOST_TEST(ab.normal.x() == -ba.normal.x(), boost::test_tools::tolerance(1e-3));
+
+    // Moving apart, and overlapping from the start.
+    toi = z_qtshapes::timeOfImpact(box, z_qtshapes::ZQMotion(QPointF(-100, 0)), wall);
+    BOOST_TEST(!toi.hit);
+    BOOST_TEST(toi.time == 1);
+    toi = z_qtshapes::timeOfImpact(box, fast, z_qtshapes::ZQRectF(5, 5, 10, 10));
+    BOOST_TEST(toi.hit);
+    BOOST_TEST(toi.time == 0);
+    BOOST_TEST(toi.normal.x() == 1, boost::test_tools::tolerance(1e-9));
+
+    // Batches: the earliest obstacle for each mover, the same on any
+    // number of threads.
+    z_qtshapes::ZQSpatialIndex obstacles;
+    QVector<z_qtshapes::ZQPreparedShape> walls;
+    for (int i = 0; i < 12; ++i) {
+        walls.append(z_qtshapes::ZQRectF(30 + 25 * i, -50 + 7 * (i % 3), 1.5, 100, 5 * (i % 4)));
+        walls.append(z_qtshapes::ZQEllipseF(40 + 25 * i, 80 + 3 * i, 6, 6));
+    }
+    obstacles.bulkLoad(walls.begin(), walls.end());
+
+    QVector<z_qtshapes::ZQPreparedShape> movers;
+    QVector<z_qtshapes::ZQMotion> motions;
+    for (int i = 0; i < 60; ++i) {
+        if (i % 3 == 0)
+            movers.append(z_qtshapes::ZQRectF(-10 + i, -30 + 2 * i, 6, 4, 7 * i));
+        else if (i % 3 == 1)
+            movers.append(z_qtshapes::ZQEllipseF(-10 + i, -30 + 2 * i, 5, 3, 11 * i));
+        else
+            movers.append(z_qtshapes::ZQLineF(QPointF(-10 + i, -30 + 2 * i), QPointF(-5 + i, -25 + 2 * i)));
+        motions.append(z_qtshapes::ZQMotion(QPointF(3 * i + 5, 2 - i % 5), i % 4 == 0 ? 0 : 13 * i));
+    }
+    movers.append(z_qtshapes::ZQPreparedShape());
+    motions.append(z_qtshapes::ZQMotion(QPointF(1000, 0)));
+
+    std::vector<z_qtshapes::ZQTimeOfImpact> results(movers.size()), serial(movers.size());
+    std::vector<z_qtshapes::ZQSpatialIndex::Id> hits(movers.size()), serialHits(movers.size());
+    z_qtshapes::timesOfImpact(movers.constData(), motions.constData(), movers.size(), obstacles, results.data(), hits.data());
+    z_qtshapes::timesOfImpact(movers.constData(), motions.constData(), movers.size(), obstacles, serial.data(),
+                              serialHits.data(), nullptr);
+    int hitCount = 0;
+    for (int i = 0; i < movers.size(); ++i) {
+        BOOST_TEST(hits[i] == serialHits[i]);
+        BOOST_TEST(results[i].time == serial[i].time);
+
+        bool hit = false;
+        qreal earliest = 1;
+        for (int j = 0; j < walls.size(); ++j) {
+            if (movers[i].isNull())
+                break;
+            const z_qtshapes::ZQTimeOfImpact r = z_qtshapes::timeOfImpact(movers[i], motions[i], walls[j]);
+            if (r.hit && r.time < earliest) {
+                hit = true;
+                earliest = r.time;
+            }
+        }
+        BOOST_TEST(results[i].hit == hit);
+        BOOST_TEST(results[i].time == earliest, boost::test_tools::tolerance(1e-6));
+        if (hit) {
+            BOOST_TEST(hits[i] >= 0);
+            ++hitCount;
+        } else {
+            BOOST_TEST(hits[i] == -1);
+        }
+    }
+    BOOST_TEST(hitCount > 20);
+    BOOST_TEST(hitCount < movers.size() - 1);
+}
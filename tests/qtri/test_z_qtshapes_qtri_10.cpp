@@ -0,0 +1,42 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QTri_10
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+
+
+BOOST_AUTO_TEST_CASE(Z_QTri_10)
+{
+    z_qtshapes::ZQTri l(0, 0, 9, 0, 0, 9);
+    BOOST_TEST(l.contains(QPoint(1, 1)));
+    BOOST_TEST(l.contains(QPoint(4, 4)));
+    BOOST_TEST(l.contains(QPoint(9, 0)));
+    BOOST_TEST(!l.contains(QPoint(5, 5)));
+    BOOST_TEST(!l.contains(QPoint(-1, 2)));
+
+    z_qtshapes::ZQTri r(0, 0, 9, 0, 0, 9, 180);
+    BOOST_TEST(r.contains(QPoint(5, 5)));
+    BOOST_TEST(!r.contains(QPoint(1, 1)));
+
+    BOOST_TEST(!l.intersects(z_qtshapes::ZQTri(8, 8, 12, 8, 8, 12)));
+    BOOST_TEST(l.intersects(z_qtshapes::ZQTri(4, 4, 10, 4, 4, 10)));
+    BOOST_TEST(l.intersects(z_qtshapes::ZQTri(9, 0, 12, 0, 9, 3)));
+    BOOST_TEST(l.intersects(z_qtshapes::ZQTri(1, 1, 2, 1, 1, 2)));
+    BOOST_TEST(!r.intersects(z_qtshapes::ZQTri(8, 8, 12, 8, 8, 12)));
+    BOOST_TEST(r.intersects(z_qtshapes::ZQTri(-2, 5, -1, 5, -2, 6)));
+    BOOST_TEST(!l.intersects(z_qtshapes::ZQTri(-2, 5, -1, 5, -2, 6)));
+
+    z_qtshapes::ZQTri big(-10, -10, 30, -10, -10, 30);
+    BOOST_TEST(l.intersects(big));
+    BOOST_TEST(big.intersects(l));
+    BOOST_TEST(big.contains(l));
+    BOOST_TEST(big.contains(l, true));
+    BOOST_TEST(!l.contains(big));
+    BOOST_TEST(l.contains(z_qtshapes::ZQTri(1, 1, 2, 1, 1, 2), true));
+    BOOST_TEST(l.contains(l));
+    BOOST_TEST(!l.contains(l, true));
+    BOOST_TEST(!l.contains(z_qtshapes::ZQTri(4, 4, 10, 4, 4, 10)));
+}
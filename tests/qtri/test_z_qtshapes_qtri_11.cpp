@@ -0,0 +1,25 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QTri_11
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+
+BOOST_AUTO_TEST_CASE(Z_QTri_11)
+{
+    z_qtshapes::ZQTri a(QPoint(0, 0), QPoint(3, 0), QPoint(0, 3), 90);
+    BOOST_CHECK(a.boundingRectF() == QRectF(0, -1, 3, 3));
+    BOOST_CHECK(a.boundingRect() == QRect(0, -1, 3, 3));
+
+    a = z_qtshapes::ZQTri(QPoint(0, 0), QPoint(4, 0), QPoint(0, 4), 45);
+    const QRectF b = a.boundingRectF();
+    const QRectF p = a.prepared().boundingRect();
+    BOOST_TEST(qAbs(b.left() - p.left()) < 1e-9);
+    BOOST_TEST(qAbs(b.top() - p.top()) < 1e-9);
+    BOOST_TEST(qAbs(b.right() - p.right()) < 1e-9);
+    BOOST_TEST(qAbs(b.bottom() - p.bottom()) < 1e-9);
+    BOOST_TEST(a.boundingRect().left() <= b.left());
+    BOOST_TEST(a.boundingRect().x() + a.boundingRect().width() >= b.right());
+}
@@ -0,0 +1,55 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QTriF_10
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+
+
+BOOST_AUTO_TEST_CASE(Z_QTriF_10)
+{
+    z_qtshapes::ZQTriF l(0, 0, 9, 0, 0, 9);
+    BOOST_TEST(l.contains(QPointF(1, 1)));
+    BOOST_TEST(l.contains(QPointF(4, 4)));
+    BOOST_TEST(l.contains(QPointF(9, 0)));
+    BOOST_TEST(!l.contains(QPointF(5, 5)));
+    BOOST_TEST(!l.contains(QPointF(-1, 2)));
+
+    z_qtshapes::ZQTriF r(0, 0, 9, 0, 0, 9, 180);
+    BOOST_TEST(r.contains(QPointF(5, 5)));
+    BOOST_TEST(!r.contains(QPointF(1, 1)));
+
+    BOOST_TEST(!l.intersects(z_qtshapes::ZQTriF(8, 8, 12, 8, 8, 12)));
+    BOOST_TEST(l.intersects(z_qtshapes::ZQTriF(4, 4, 10, 4, 4, 10)));
+    BOOST_TEST(l.intersects(z_qtshapes::ZQTriF(9, 0, 12, 0, 9, 3)));
+    BOOST_TEST(l.intersects(z_qtshapes::ZQTriF(9, 0, 0, 9, 9, 9)));
+    BOOST_TEST(z_qtshapes::ZQTriF(9, 0, 0, 9, 9, 9).intersects(l));
+    BOOST_TEST(!l.intersects(z_qtshapes::ZQTriF(9.001, 0.001, 0.001, 9.001, 9, 9)));
+    BOOST_TEST(l.intersects(z_qtshapes::ZQTriF(1, 1, 2, 1, 1, 2)));
+    BOOST_TEST(!r.intersects(z_qtshapes::ZQTriF(8, 8, 12, 8, 8, 12)));
+    BOOST_TEST(r.intersects(z_qtshapes::ZQTriF(-2, 5, -1, 5, -2, 6)));
+    BOOST_TEST(!l.intersects(z_qtshapes::ZQTriF(-2, 5, -1, 5, -2, 6)));
+
+    z_qtshapes::ZQTriF big(-10, -10, 30, -10, -10, 30);
+    BOOST_TEST(l.intersects(big));
+    BOOST_TEST(big.intersects(l));
+    BOOST_TEST(big.contains(l));
+    BOOST_TEST(big.contains(l, true));
+    BOOST_TEST(!l.contains(big));
+    BOOST_TEST(l.contains(z_qtshapes::ZQTriF(1, 1, 2, 1, 1, 2), true));
+    BOOST_TEST(l.contains(l));
+    BOOST_TEST(!l.contains(l, true));
+    BOOST_TEST(!l.contains(z_qtshapes::ZQTriF(4, 4, 10, 4, 4, 10)));
+
+    // A triangle with collinear vertices is the segment they span.
+    z_qtshapes::ZQTriF flat(0, 0, 4, 4, 8, 8);
+    BOOST_TEST(flat.contains(QPointF(2, 2)));
+    BOOST_TEST(flat.contains(QPointF(8, 8)));
+    BOOST_TEST(!flat.prepared().contains(QPointF(2, 2), true));
+    BOOST_TEST(!flat.contains(QPointF(-4, -4)));
+    BOOST_TEST(!flat.contains(QPointF(12, 12)));
+    BOOST_TEST(!flat.intersects(z_qtshapes::ZQTriF(12, 12, 16, 16, 20, 20)));
+    BOOST_TEST(flat.intersects(z_qtshapes::ZQTriF(8, 8, 16, 16, 20, 20)));
+}
@@ -0,0 +1,37 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QTriF_11
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+
+
+BOOST_AUTO_TEST_CASE(Z_QTriF_11)
+{
+    z_qtshapes::ZQTriF t(QPointF(0, 0), QPointF(10, 0), QPointF(0, 10), 30);
+    z_qtshapes::ZQPreparedTriF p = t.prepared();
+    BOOST_TEST(p.angle() == 30);
+    const QRectF box = p.boundingRect();
+    for (const QPointF &v : { p.first(), p.second(), p.third() }) {
+        BOOST_TEST(v.x() >= box.left() - 1e-9);
+        BOOST_TEST(v.x() <= box.right() + 1e-9);
+        BOOST_TEST(v.y() >= box.top() - 1e-9);
+        BOOST_TEST(v.y() <= box.bottom() + 1e-9);
+    }
+
+    const QPointF points[] = { QPointF(3, 3), QPointF(0, 0), QPointF(8, 8), QPointF(-1, 5), QPointF(2, 9) };
+    for (const QPointF &q : points)
+        BOOST_TEST(p.contains(q) == t.contains(q));
+
+    const z_qtshapes::ZQTriF others[] = {
+        z_qtshapes::ZQTriF(QPointF(2, 2), QPointF(3, 2), QPointF(2, 3)),
+        z_qtshapes::ZQTriF(QPointF(20, 20), QPointF(30, 20), QPointF(20, 30)),
+        z_qtshapes::ZQTriF(QPointF(5, 5), QPointF(15, 5), QPointF(5, 15), 90)
+    };
+    for (const z_qtshapes::ZQTriF &o : others) {
+        BOOST_TEST(t.intersects(o.prepared()) == t.intersects(o));
+        BOOST_TEST(t.contains(o.prepared()) == t.contains(o));
+    }
+}
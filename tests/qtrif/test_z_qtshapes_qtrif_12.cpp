@@ -0,0 +1,29 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QTriF_12
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+
+BOOST_AUTO_TEST_CASE(Z_QTriF_12)
+{
+    z_qtshapes::ZQTriF a(QPointF(0, 0), QPointF(3, 0), QPointF(0, 3));
+    BOOST_CHECK(a.boundingRect() == QRectF(0, 0, 3, 3));
+
+    // Rotated clockwise about the centroid (1, 1) the vertices move to
+    // (0, 2), (0, -1) and (3, 2).
+    a = z_qtshapes::ZQTriF(QPointF(0, 0), QPointF(3, 0), QPointF(0, 3), 90);
+    BOOST_CHECK(a.boundingRect() == QRectF(0, -1, 3, 3));
+
+    for (int angle = 0; angle < 360; angle += 13) {
+        a = z_qtshapes::ZQTriF(QPointF(-2, 1), QPointF(5, 3), QPointF(1, 7), angle + 0.75);
+        const QRectF b = a.boundingRect();
+        const QRectF p = a.prepared().boundingRect();
+        BOOST_TEST(qAbs(b.left() - p.left()) < 1e-9);
+        BOOST_TEST(qAbs(b.top() - p.top()) < 1e-9);
+        BOOST_TEST(qAbs(b.right() - p.right()) < 1e-9);
+        BOOST_TEST(qAbs(b.bottom() - p.bottom()) < 1e-9);
+    }
+}
@@ -0,0 +1,50 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QTriF_13
+#include <boost/test/included/unit_test.hpp>
+
+#include <vector>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+
+namespace {
+
+    // Signed area of every indexed triangle, summed; fails on a negative one.
+    double triangleArea(const std::vector<float> &v, const std::vector<quint32> &idx, quint32 base)
+    {
+        double total = 0;
+        for (std::size_t i = 0; i < idx.size(); i += 3) {
+            const quint32 a = idx[i] - base, b = idx[i + 1] - base, c = idx[i + 2] - base;
+            const double area = 0.5 * ((v[2*b] - v[2*a]) * (v[2*c + 1] - v[2*a + 1])
+                    - (v[2*b + 1] - v[2*a + 1]) * (v[2*c] - v[2*a]));
+            BOOST_TEST(area >= 0);
+            total += area;
+        }
+        return total;
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(Z_QTriF_13)
+{
+    std::vector<float> v(6);
+    std::vector<quint32> idx(3);
+
+    // Both vertex orders give a triangle with positive area.
+    z_qtshapes::ZQTriF a(QPointF(0, 0), QPointF(4, 0), QPointF(0, 3), 20);
+    BOOST_TEST(a.tessellationVertexCount() == 3);
+    BOOST_TEST(a.tessellationIndexCount() == 3);
+    a.tessellate(0.5, v.data(), idx.data());
+    BOOST_TEST(qAbs(triangleArea(v, idx, 0) - 6) < 1e-4);
+
+    a = z_qtshapes::ZQTriF(QPointF(0, 0), QPointF(0, 3), QPointF(4, 0), 20);
+    a.tessellate(0.5, v.data(), idx.data(), 3);
+    BOOST_TEST(qAbs(triangleArea(v, idx, 3) - 6) < 1e-4);
+
+    const z_qtshapes::ZQPreparedTriF p = a.prepared();
+    BOOST_TEST(v[0] == float(p.first().x()));
+    BOOST_TEST(v[3] == float(p.second().y()));
+    BOOST_TEST(v[4] == float(p.third().x()));
+}
@@ -0,0 +1,90 @@
+#define BOOST_TEST_MODULE Z_QTShapes_QVertexBatch_1
+#include <boost/test/included/unit_test.hpp>
+
+#include "z_qpoint.h"
+#include "z_qline.h"
+#include "z_qtri.h"
+#include "z_qrect.h"
+#include "z_qellipse.h"
+#include "z_qvertexbatch.h"
+
+namespace {
+
+    // Sum of the signed areas of the triangles whose vertices carry id.
+    double area(const z_qtshapes::ZQVertexBatch &batch, quint32 id)
+    {
+        const z_qtshapes::ZQVertexBatch::Vertex *v = batch.vertexData();
+        const quint32 *idx = batch.indexData();
+        double total = 0;
+        for (int i = 0; i < batch.indexCount(); i += 3) {
+            const auto &a = v[idx[i]], &b = v[idx[i + 1]], &c = v[idx[i + 2]];
+            if (a.id != id)
+                continue;
+            BOOST_TEST((b.id == id && c.id == id));
+            total += 0.5 * ((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x));
+        }
+        return total;
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(Z_QVertexBatch_1)
+{
+    z_qtshapes::ZQVertexBatch batch;
+    BOOST_TEST(batch.build() == z_qtshapes::ZQVertexBatch::Unchanged);
+
+    const z_qtshapes::ZQEllipseF ellipse(0, 0, 20, 10, 15);
+    const int rect = batch.insert(z_qtshapes::ZQRectF(0, 0, 10, 4, 30));
+    const int tri = batch.insert(z_qtshapes::ZQTriF(QPointF(0, 0), QPointF(4, 0), QPointF(0, 3)));
+    const int ell = batch.insert(ellipse);
+    const int line = batch.insert(z_qtshapes::ZQLineF(QPointF(0, 0), QPointF(5, 0)));
+    BOOST_TEST(batch.size() == 4);
+
+    BOOST_TEST(batch.build() == z_qtshapes::ZQVertexBatch::Rebuilt);
+    const int n = ellipse.segmentCount(0.25);
+    BOOST_TEST(batch.vertexCount() == 4 + 3 + n + 1 + 4);
+    BOOST_TEST(batch.indexCount() == 6 + 3 + 3 * n + 6);
+    BOOST_TEST(batch.updatedVertices().size() == 1);
+    BOOST_TEST(qAbs(area(batch, rect) - 40) < 1e-3);
+    BOOST_TEST(qAbs(area(batch, tri) - 6) < 1e-3);
+    BOOST_TEST(qAbs(area(batch, ell) - M_PI * 50) < 2 * M_PI * 10 * 0.25);
+    BOOST_TEST(qAbs(area(batch, line) - 5) < 1e-3);
+    BOOST_TEST(batch.build() == z_qtshapes::ZQVertexBatch::Unchanged);
+
+    // Only the moved rectangle is re-emitted.
+    batch.update(rect, z_qtshapes::ZQRectF(100, 0, 10, 4, 30));
+    BOOST_TEST(batch.build() == z_qtshapes::ZQVertexBatch::Updated);
+    BOOST_TEST(batch.updatedVertices().size() == 1);
+    BOOST_TEST(batch.updatedVertices()[0].first == 0);
+    BOOST_TEST(batch.updatedVertices()[0].count == 4);
+    BOOST_TEST(batch.updatedIndices()[0].count == 6);
+    BOOST_TEST(batch.vertexData()[0].x > 90);
+
+    // A removed shape leaves degenerate triangles behind.
+    BOOST_TEST(batch.remove(tri));
+    BOOST_TEST(!batch.contains(tri));
+    BOOST_TEST(batch.build() == z_qtshapes::ZQVertexBatch::Updated);
+    BOOST_TEST(area(batch, tri) == 0);
+    BOOST_TEST(batch.vertexCount() == 4 + 3 + n + 1 + 4);
+
+    // The reused Id needs a bigger slot, so the buffers are laid out again.
+    BOOST_TEST(batch.insert(z_qtshapes::ZQRectF(0, 0, 2, 2)) == tri);
+    BOOST_TEST(batch.build() == z_qtshapes::ZQVertexBatch::Rebuilt);
+    BOOST_TEST(qAbs(area(batch, tri) - 4) < 1e-3);
+
+    // Panning keeps every slot; zooming in adds ellipse segments.
+    QMatrix3x3 view;
+    view(0, 2) = 50;
+    view(1, 2) = -20;
+    batch.setViewMatrix(view);
+    BOOST_TEST(batch.build() == z_qtshapes::ZQVertexBatch::Updated);
+    BOOST_TEST(qAbs(area(batch, rect) - 40) < 1e-3);
+    BOOST_TEST(batch.vertexData()[0].x > 140);
+
+    view(0, 0) = 4;
+    view(1, 1) = 4;
+    batch.setViewMatrix(view);
+    BOOST_TEST(batch.build() == z_qtshapes::ZQVertexBatch::Rebuilt);
+    BOOST_TEST(batch.vertexCount() > 4 + 4 + n + 1 + 4);
+    BOOST_TEST(qAbs(area(batch, rect) - 16 * 40) < 1e-2);
+}
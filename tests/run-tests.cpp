@@ -23,6 +23,8 @@ int main() {
     system((std::string("tests/qline/test_z_qtshapes_qline_5") + boost_options).c_str());
     system((std::string("tests/qline/test_z_qtshapes_qline_6") + boost_options).c_str());
     system((std::string("tests/qline/test_z_qtshapes_qline_7") + boost_options).c_str());
+    system((std::string("tests/qline/test_z_qtshapes_qline_8") + boost_options).c_str());
+    system((std::string("tests/qline/test_z_qtshapes_qline_9") + boost_options).c_str());
 #endif
 #if TEST_QLINEF
     system((std::string("tests/qlinef/test_z_qtshapes_qlinef_1") + boost_options).c_str());
@@ -32,6 +34,9 @@ int main() {
     system((std::string("tests/qlinef/test_z_qtshapes_qlinef_5") + boost_options).c_str());
     system((std::string("tests/qlinef/test_z_qtshapes_qlinef_6") + boost_options).c_str());
     system((std::string("tests/qlinef/test_z_qtshapes_qlinef_7") + boost_options).c_str());
+    system((std::string("tests/qlinef/test_z_qtshapes_qlinef_8") + boost_options).c_str());
+    system((std::string("tests/qlinef/test_z_qtshapes_qlinef_9") + boost_options).c_str());
+    system((std::string("tests/qlinef/test_z_qtshapes_qlinef_10") + boost_options).c_str());
 #endif
 #if TEST_QTRI
     system((std::string("tests/qtri/test_z_qtshapes_qtri_1") + boost_options).c_str());
@@ -43,6 +48,8 @@ int main() {
     system((std::string("tests/qtri/test_z_qtshapes_qtri_7") + boost_options).c_str());
     system((std::string("tests/qtri/test_z_qtshapes_qtri_8") + boost_options).c_str());
     system((std::string("tests/qtri/test_z_qtshapes_qtri_9") + boost_options).c_str());
+    system((std::string("tests/qtri/test_z_qtshapes_qtri_10") + boost_options).c_str());
+    system((std::string("tests/qtri/test_z_qtshapes_qtri_11") + boost_options).c_str());
 #endif
 #if TEST_QTRIF
     system((std::string("tests/qtrif/test_z_qtshapes_qtrif_1") + boost_options).c_str());
@@ -54,6 +61,10 @@ int main() {
     system((std::string("tests/qtrif/test_z_qtshapes_qtrif_7") + boost_options).c_str());
     system((std::string("tests/qtrif/test_z_qtshapes_qtrif_8") + boost_options).c_str());
     system((std::string("tests/qtrif/test_z_qtshapes_qtrif_9") + boost_options).c_str());
+    system((std::string("tests/qtrif/test_z_qtshapes_qtrif_10") + boost_options).c_str());
+    system((std::string("tests/qtrif/test_z_qtshapes_qtrif_11") + boost_options).c_str());
+    system((std::string("tests/qtrif/test_z_qtshapes_qtrif_12") + boost_options).c_str());
+    system((std::string("tests/qtrif/test_z_qtshapes_qtrif_13") + boost_options).c_str());
 #endif
 #if TEST_QRECT
     system((std::string("tests/qrect/test_z_qtshapes_qrect_1") + boost_options).c_str());
@@ -65,6 +76,8 @@ int main() {
     system((std::string("tests/qrect/test_z_qtshapes_qrect_7") + boost_options).c_str());
     system((std::string("tests/qrect/test_z_qtshapes_qrect_8") + boost_options).c_str());
     system((std::string("tests/qrect/test_z_qtshapes_qrect_9") + boost_options).c_str());
+    system((std::string("tests/qrect/test_z_qtshapes_qrect_10") + boost_options).c_str());
+    system((std::string("tests/qrect/test_z_qtshapes_qrect_11") + boost_options).c_str());
 #endif
 #if TEST_QRECTF
     system((std::string("tests/qrectf/test_z_qtshapes_qrectf_1") + boost_options).c_str());
@@ -76,6 +89,10 @@ int main() {
     system((std::string("tests/qrectf/test_z_qtshapes_qrectf_7") + boost_options).c_str());
     system((std::string("tests/qrectf/test_z_qtshapes_qrectf_8") + boost_options).c_str());
     system((std::string("tests/qrectf/test_z_qtshapes_qrectf_9") + boost_options).c_str());
+    system((std::string("tests/qrectf/test_z_qtshapes_qrectf_10") + boost_options).c_str());
+    system((std::string("tests/qrectf/test_z_qtshapes_qrectf_11") + boost_options).c_str());
+    system((std::string("tests/qrectf/test_z_qtshapes_qrectf_12") + boost_options).c_str());
+    system((std::string("tests/qrectf/test_z_qtshapes_qrectf_13") + boost_options).c_str());
 #endif
 #if TEST_QELLIPSE
     system((std::string("tests/qellipse/test_z_qtshapes_qellipse_1") + boost_options).c_str());
@@ -87,6 +104,8 @@ int main() {
     system((std::string("tests/qellipse/test_z_qtshapes_qellipse_7") + boost_options).c_str());
     system((std::string("tests/qellipse/test_z_qtshapes_qellipse_8") + boost_options).c_str());
     system((std::string("tests/qellipse/test_z_qtshapes_qellipse_9") + boost_options).c_str());
+    system((std::string("tests/qellipse/test_z_qtshapes_qellipse_10") + boost_options).c_str());
+    system((std::string("tests/qellipse/test_z_qtshapes_qellipse_11") + boost_options).c_str());
 #endif
 #if TEST_QELLIPSEF
     system((std::string("tests/qellipsef/test_z_qtshapes_qellipsef_1") + boost_options).c_str());
@@ -98,12 +117,58 @@ int main() {
     system((std::string("tests/qellipsef/test_z_qtshapes_qellipsef_7") + boost_options).c_str());
     system((std::string("tests/qellipsef/test_z_qtshapes_qellipsef_8") + boost_options).c_str());
     system((std::string("tests/qellipsef/test_z_qtshapes_qellipsef_9") + boost_options).c_str());
+    system((std::string("tests/qellipsef/test_z_qtshapes_qellipsef_10") + boost_options).c_str());
+    system((std::string("tests/qellipsef/test_z_qtshapes_qellipsef_11") + boost_options).c_str());
+    system((std::string("tests/qellipsef/test_z_qtshapes_qellipsef_12") + boost_options).c_str());
+    system((std::string("tests/qellipsef/test_z_qtshapes_qellipsef_13") + boost_options).c_str());
+    system((std::string("tests/qellipsef/test_z_qtshapes_qellipsef_14") + boost_options).c_str());
+#endif
+#if TEST_QSPATIALINDEX
+    system((std::string("tests/qspatialindex/test_z_qtshapes_qspatialindex_1") + boost_options).c_str());
+    system((std::string("tests/qspatialindex/test_z_qtshapes_qspatialindex_2") + boost_options).c_str());
+#endif
+#if TEST_QBROADPHASE
+    system((std::string("tests/qbroadphase/test_z_qtshapes_qbroadphase_1") + boost_options).c_str());
+    system((std::string("tests/qbroadphase/test_z_qtshapes_qbroadphase_2") + boost_options).c_str());
+    system((std::string("tests/qbroadphase/test_z_qtshapes_qbroadphase_3") + boost_options).c_str());
+#endif
+#if TEST_QSHAPEARRAY
+    system((std::string("tests/qshapearray/test_z_qtshapes_qshapearray_1") + boost_options).c_str());
+    system((std::string("tests/qshapearray/test_z_qtshapes_qshapearray_2") + boost_options).c_str());
+#endif
+#if TEST_QPOINTKERNELS
+    system((std::string("tests/qpointkernels/test_z_qtshapes_qpointkernels_1") + boost_options).c_str());
+    system((std::string("tests/qpointkernels/test_z_qtshapes_qpointkernels_2") + boost_options).c_str());
+    system((std::string("tests/qpointkernels/test_z_qtshapes_qpointkernels_3") + boost_options).c_str());
+#endif
+#if TEST_QVERTEXBATCH
+    system((std::string("tests/qvertexbatch/test_z_qtshapes_qvertexbatch_1") + boost_options).c_str());
+#endif
+#if TEST_QPOLYGONF
+    system((std::string("tests/qpolygonf/test_z_qtshapes_qpolygonf_1") + boost_options).c_str());
+#endif
+#if TEST_QRASTERIZER
+    system((std::string("tests/qrasterizer/test_z_qtshapes_qrasterizer_1") + boost_options).c_str());
+#endif
+#if TEST_QDISTANCEFIELD
+    system((std::string("tests/qdistancefield/test_z_qtshapes_qdistancefield_1") + boost_options).c_str());
+#endif
+#if TEST_QGJK
+    system((std::string("tests/qgjk/test_z_qtshapes_qgjk_1") + boost_options).c_str());
+#endif
+#if TEST_QSWEEP
+    system((std::string("tests/qsweep/test_z_qtshapes_qsweep_1") + boost_options).c_str());
 #endif
 #if TEST_LINALG
     system((std::string("tests/linalg/test_z_linalg") + boost_options).c_str());
     system((std::string("tests/linalg/test_z_matrix") + boost_options).c_str());
     system((std::string("tests/linalg/test_z_offsetmatrix") + boost_options).c_str());
     system((std::string("tests/linalg/test_z_matrixtraits") + boost_options).c_str());
+    system((std::string("tests/linalg/test_z_dynmatrix") + boost_options).c_str());
+    system((std::string("tests/linalg/test_z_gemm") + boost_options).c_str());
+    system((std::string("tests/linalg/test_z_matrixexpr") + boost_options).c_str());
+    system((std::string("tests/linalg/test_z_sparsematrix") + boost_options).c_str());
+    system((std::string("tests/linalg/test_z_krylov") + boost_options).c_str());
 #endif
 
     return 0;